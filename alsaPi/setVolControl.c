@@ -23,11 +23,11 @@
 // ****************************************************************************
 // ****************************************************************************
 
-#define Version "Version 0.2"
+#define Version "Version 0.3"
 
 //  Compilation:
 //
-//  Compile with gcc setVolControl.c -Wall -o setVolControl -lasound
+//  Compile with gcc setVolControl.c volClient.c -Wall -o setVolControl -lasound
 //  Also use the following flags for Raspberry Pi optimisation:
 //         -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
 //         -ffast-math -pipe -O3
@@ -39,12 +39,18 @@
 //
 //    v0.1 Initial version.
 //    v0.2 Added command line parameters.
+//    v0.3 Sends values to volServer if it is running on the same card,
+//         otherwise writes the control directly.
 //
 
 #include <stdio.h>
 #include <string.h>
 #include <alsa/asoundlib.h>
 #include <argp.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "volClient.h"
 
 // ----------------------------------------------------------------------------
 //  argp documentation.
@@ -66,6 +72,7 @@ struct structArgs
     char deviceID[8];
     int value1;
     int value2;
+    bool direct;
 };
 
 // ----------------------------------------------------------------------------
@@ -78,6 +85,7 @@ static struct argp_option options[] =
     { "control", 'd', "<n>", 0, "Control ID number." },
     { 0, 0, 0, 0, "Control parameters:" },
     { "val", 'v', "<%>/<%,%>", 0, "Set control value(s)." },
+    { "direct", 'x', 0, 0, "Write control directly, not via volServer." },
     { 0 }
 };
 
@@ -99,6 +107,9 @@ static int parse_opt( int param, char *arg, struct argp_state *state )
         case 'd' :
             cmdArgs->control = atoi( arg );
             break;
+        case 'x' :
+            cmdArgs->direct = true;
+            break;
         case 'v' :
             str = arg;
             token = strtok( str, delimiter );
@@ -123,7 +134,17 @@ static struct argp argp = { options, parse_opt, args_doc, doc };
 // ============================================================================
 int main( int argc, char *argv[] )
 {
-    struct structArgs cmdArgs;
+    struct structArgs cmdArgs =
+    {
+        .card = 0,
+        .control = 0,
+        .value1 = 0,
+        .value2 = 0,
+        .direct = false
+    };
+    char request[VOL_LINE];
+    char reply[VOL_LINE];
+    int sock;
 
     // ------------------------------------------------------------------------
     //  ALSA control elements.
@@ -150,6 +171,25 @@ int main( int argc, char *argv[] )
     sprintf( cmdArgs.deviceID, "hw:%i", cmdArgs.card );
     printf( "Device ID = %s.\n", cmdArgs.deviceID );
 
+    // Use server if it is running, it refuses cards other than its own.
+    if ( !cmdArgs.direct )
+    {
+        sock = volConnect( VOL_SOCKET );
+        if ( sock >= 0 )
+        {
+            snprintf( request, sizeof( request ), "control %s %i %i,%i",
+                      cmdArgs.deviceID, cmdArgs.control,
+                      cmdArgs.value1, cmdArgs.value2 );
+            if ( volRequestLine( sock, request, reply, sizeof( reply )) == 0 )
+            {
+                printf( "Set via volServer: %s.\n", reply );
+                volClose( sock );
+                return 0;
+            }
+            volClose( sock );
+        }
+    }
+
     if ( snd_ctl_open( &ctl, cmdArgs.deviceID, 1 ) < 0 )
     {
         printf( "Error opening control.\n" );
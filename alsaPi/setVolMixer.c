@@ -23,11 +23,11 @@
 // ****************************************************************************
 // ****************************************************************************
 
-#define Version "Version 0.3"
+#define Version "Version 0.4"
 
 //  Compilation:
 //
-//  Compile with gcc setVolMixer.c -Wall -o setVolMixer -lasound -lm
+//  Compile with gcc setVolMixer.c volClient.c -Wall -o setVolMixer -lasound -lm
 //  Also use the following flags for Raspberry Pi optimisation:
 //         -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
 //         -ffast-math -pipe -O3
@@ -40,6 +40,9 @@
 //  v0.1 Initial version.
 //  v0.2 Added command line parameters.
 //  v0.3 Added volume shaping.
+//  v0.4 Sends volume to volServer if it is running, otherwise sets the
+//       mixer directly. Server uses its own card, mixer and factor, so
+//       giving any of these sets the mixer directly.
 //
 
 #include <stdio.h>
@@ -48,6 +51,10 @@
 #include <alsa/mixer.h>
 #include <argp.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "volClient.h"
 
 // ----------------------------------------------------------------------------
 //  argp documentation.
@@ -68,6 +75,8 @@ struct volumeStruct
     float factor;
     unsigned int left;
     unsigned int right;
+    bool direct;
+    bool chosen;    // Card, mixer or factor given.
 };
 
 // ----------------------------------------------------------------------------
@@ -81,6 +90,7 @@ static struct argp_option options[] =
     { 0, 0, 0, 0, "Mixer parameters:" },
     { "val", 'v', "<%>/<%,%>", 0, "Set mixer value(s)." },
     { "fac", 'f', "<int>", 0, "Volume shaping factor" },
+    { "direct", 'x', 0, 0, "Set mixer directly, not via volServer." },
     { 0 }
 };
 
@@ -98,12 +108,18 @@ static int parse_opt( int param, char *arg, struct argp_state *state )
     {
         case 'c' :
             volume->card = arg;
+            volume->chosen = true;
             break;
         case 'm' :
             volume->mixer = arg;
+            volume->chosen = true;
             break;
         case 'f' :
             volume->factor = atof( arg );
+            volume->chosen = true;
+            break;
+        case 'x' :
+            volume->direct = true;
             break;
         case 'v' :
             str = arg;
@@ -222,14 +238,41 @@ int main( int argc, char *argv[] )
         .mixer = "PCM",
         .factor = 0.01,
         .left = 0,
-        .right = 0
+        .right = 0,
+        .direct = false,
+        .chosen = false
     };
+    struct volState state;
+    int sock;
 
     // ------------------------------------------------------------------------
     //  Get command line parameters.
     // ------------------------------------------------------------------------
     argp_parse( &argp, argc, argv, 0, 0, &volume );
 
+    // ------------------------------------------------------------------------
+    //  Use server if it is running, saves opening the mixer every time.
+    //  The server has its own card, mixer and factor, so if any of these
+    //  are given the mixer is set directly instead.
+    // ------------------------------------------------------------------------
+    if ( !volume.direct && !volume.chosen )
+    {
+        if ( volume.left > 100 ) volume.left = 100;
+        if ( volume.right > 100 ) volume.right = 100;
+
+        sock = volConnect( VOL_SOCKET );
+        if ( sock >= 0 )
+        {
+            if ( volRequest( sock, VOL_SET, volume.left, volume.right,
+                             &state ) == 0 )
+            {
+                volClose( sock );
+                return 0;
+            }
+            volClose( sock );
+        }
+    }
+
     setVolume( volume );
 
     return 0;
@@ -0,0 +1,214 @@
+// ****************************************************************************
+/*
+    volClient:
+
+    Client side of the volServer volume control protocol.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+// ****************************************************************************
+
+//  Compilation:
+//
+//  Compile with gcc -c -fpic volClient.c
+//  Also use the following flags for Raspberry Pi optimisation:
+//         -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+//         -ffast-math -pipe -O3
+
+//  Authors:        agent       18/10/2026
+//
+//  Contributors:
+//
+//  Changelog:
+//
+//  v0.1 Original version.
+//
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "volClient.h"
+
+
+//  Functions. ----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+//  Calculates left and right volumes from volume and balance.
+// ----------------------------------------------------------------------------
+void volBalance( struct volState *state )
+{
+    int balance = state->balance;
+
+    state->left  = state->volume * ( balance > 0 ? 100 - balance : 100 ) / 100;
+    state->right = state->volume * ( balance < 0 ? 100 + balance : 100 ) / 100;
+
+    return;
+};
+
+// ----------------------------------------------------------------------------
+//  Calculates volume and balance from left and right volumes.
+// ----------------------------------------------------------------------------
+void volFromChannels( struct volState *state, uint8_t left, uint8_t right )
+{
+    if ( left > 100 ) left = 100;
+    if ( right > 100 ) right = 100;
+
+    // Volume is the louder channel, balance attenuates the quieter one.
+    if ( left == right )
+    {
+        state->volume = left;
+        state->balance = 0;
+    }
+    else if ( left > right )
+    {
+        state->volume = left;
+        state->balance = -( 100 - 100 * right / left );
+    }
+    else
+    {
+        state->volume = right;
+        state->balance = 100 - 100 * left / right;
+    }
+    state->left = left;
+    state->right = right;
+
+    return;
+};
+
+// ----------------------------------------------------------------------------
+//  Connects to server. Returns socket or -1 if the server is not running.
+// ----------------------------------------------------------------------------
+int volConnect( const char *path )
+{
+    struct sockaddr_un address;
+    int sock;
+
+    if ( strlen( path ) >= sizeof( address.sun_path )) return -1;
+
+    sock = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( sock < 0 ) return -1;
+
+    memset( &address, 0, sizeof( address ));
+    address.sun_family = AF_UNIX;
+    strcpy( address.sun_path, path );
+
+    if ( connect( sock, (struct sockaddr *)&address, sizeof( address )) < 0 )
+    {
+        close( sock );
+        return -1;
+    }
+
+    return sock;
+};
+
+// ----------------------------------------------------------------------------
+//  Reads exactly size bytes, waiting at most timeout ms for each read.
+// ----------------------------------------------------------------------------
+static int volRead( int sock, void *buffer, size_t size, int timeout )
+{
+    struct pollfd pfd = { .fd = sock, .events = POLLIN };
+    uint8_t *data = buffer;
+    ssize_t count;
+
+    while ( size > 0 )
+    {
+        if ( poll( &pfd, 1, timeout ) <= 0 ) return -1;
+        count = read( sock, data, size );
+        if ( count <= 0 ) return -1;
+        data += count;
+        size -= count;
+    }
+
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Waits for the next state frame.
+// ----------------------------------------------------------------------------
+int volReceive( int sock, struct volState *state, int timeout )
+{
+    struct volFrame frame;
+
+    if ( volRead( sock, &frame, sizeof( frame ), timeout ) < 0 ) return -1;
+    if ( frame.magic != VOL_MAGIC ) return -1;
+    if (( frame.op & ~VOL_MUTED ) != VOL_STATE ) return -1;
+
+    state->volume = frame.arg1;
+    state->balance = frame.arg2;
+    state->mute = ( frame.op & VOL_MUTED ) != 0;
+    volBalance( state );
+
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Sends a binary request and waits for the state reply.
+// ----------------------------------------------------------------------------
+int volRequest( int sock, uint8_t op, int8_t arg1, int8_t arg2,
+                struct volState *state )
+{
+    struct volFrame frame = { VOL_MAGIC, op, arg1, arg2 };
+
+    if ( write( sock, &frame, sizeof( frame )) != sizeof( frame )) return -1;
+
+    return volReceive( sock, state, VOL_TIMEOUT );
+};
+
+// ----------------------------------------------------------------------------
+//  Sends a line request and copies the reply line into reply.
+// ----------------------------------------------------------------------------
+int volRequestLine( int sock, const char *line, char *reply, size_t size )
+{
+    char request[VOL_LINE];
+    size_t length;
+    size_t i;
+
+    length = snprintf( request, sizeof( request ), "%s\n", line );
+    if ( length >= sizeof( request )) return -1;
+    if ( write( sock, request, length ) != (ssize_t)length ) return -1;
+
+    // Read a character at a time so nothing after the newline is consumed.
+    for ( i = 0; i < size - 1; i++ )
+    {
+        if ( volRead( sock, &reply[i], 1, VOL_TIMEOUT ) < 0 ) return -1;
+        if ( reply[i] == '\n' ) break;
+    }
+    reply[i] = '\0';
+
+    if ( strncmp( reply, "error", 5 ) == 0 ) return -1;
+
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Closes connection to server.
+// ----------------------------------------------------------------------------
+void volClose( int sock )
+{
+    close( sock );
+
+    return;
+};
@@ -0,0 +1,161 @@
+// ****************************************************************************
+/*
+    volClient:
+
+    Client side of the volServer volume control protocol.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+// ****************************************************************************
+
+//  Authors:        agent       18/10/2026
+//
+//  Contributors:
+//
+//  Changelog:
+//
+//  v0.1 Original version.
+//
+
+#ifndef VOLCLIENT_H
+#define VOLCLIENT_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    volServer keeps one mixer handle open and accepts requests on a Unix
+    stream socket. Requests can be sent in either of two forms, which can be
+    mixed on the same connection.
+
+    Line protocol, one request per line (for shell scripts and socat):
+
+        set <%>[,<%>]       Set volume, or left and right volumes.
+        step <+/-%>         Change volume.
+        balance <-100..100> Set balance (-100 = left only, 100 = right only).
+        mute on|off|toggle  Set mute.
+        query               Request current state.
+        subscribe           Receive state after every change.
+        control hw:<n> <numid> <n>[,<n>]
+                            Write raw values to a control element.
+
+    Requests are answered with one line of state, or "error":
+
+        volume <%> balance <n> mute on|off left <%> right <%>
+
+    Binary protocol, 4 byte frames starting with VOL_MAGIC, which can never
+    start a line:
+
+        { VOL_MAGIC, op, arg1, arg2 }
+
+    Requests are answered with a VOL_STATE frame, or VOL_ERROR:
+
+        { VOL_MAGIC, VOL_STATE [| VOL_MUTED], volume, balance }
+
+    Requests that arrive together are applied together and answered once,
+    after the mixer has been written, so a burst of steps from a rotary
+    encoder becomes a single mixer write. Subscribers are sent the state
+    after every change, including changes made by other mixer programs.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define VOL_SOCKET  "/tmp/volServer.sock" // Default socket path.
+#define VOL_MAGIC   0xa5                  // First byte of a binary frame.
+#define VOL_MUTED   0x80                  // Mute flag in VOL_STATE op.
+#define VOL_LINE    128                   // Maximum line length.
+#define VOL_TIMEOUT 500                   // Client reply timeout (ms).
+
+
+//  Data structures. ----------------------------------------------------------
+
+enum volOp
+{
+    VOL_SET = 1,    // arg1 = left %, arg2 = right %.
+    VOL_STEP,       // arg1 = signed change in %.
+    VOL_BALANCE,    // arg1 = balance -100 to 100.
+    VOL_MUTE,       // arg1 = VOL_MUTE_OFF, VOL_MUTE_ON or VOL_MUTE_TOGGLE.
+    VOL_QUERY,      // No arguments.
+    VOL_SUBSCRIBE,  // No arguments.
+    VOL_STATE,      // Reply, arg1 = volume %, arg2 = balance.
+    VOL_ERROR       // Reply to an invalid request.
+};
+
+enum volMute
+{
+    VOL_MUTE_OFF = 0,
+    VOL_MUTE_ON,
+    VOL_MUTE_TOGGLE
+};
+
+struct volFrame
+{
+    uint8_t magic;  // VOL_MAGIC.
+    uint8_t op;     // enum volOp.
+    int8_t  arg1;
+    int8_t  arg2;
+};
+
+struct volState
+{
+    uint8_t volume; // Volume 0 to 100 (%).
+    int8_t  balance;// Balance -100 to 100.
+    bool    mute;   // Mute switch.
+    uint8_t left;   // Left volume after balance (%).
+    uint8_t right;  // Right volume after balance (%).
+};
+
+
+//  Functions. ----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+//  Calculates left and right volumes from volume and balance.
+// ----------------------------------------------------------------------------
+void volBalance( struct volState *state );
+
+// ----------------------------------------------------------------------------
+//  Calculates volume and balance from left and right volumes.
+// ----------------------------------------------------------------------------
+void volFromChannels( struct volState *state, uint8_t left, uint8_t right );
+
+// ----------------------------------------------------------------------------
+//  Connects to server. Returns socket or -1 if the server is not running.
+// ----------------------------------------------------------------------------
+int volConnect( const char *path );
+
+// ----------------------------------------------------------------------------
+//  Sends a binary request and waits for the state reply.
+//  Returns 0 on success, -1 on error or timeout.
+// ----------------------------------------------------------------------------
+int volRequest( int sock, uint8_t op, int8_t arg1, int8_t arg2,
+                struct volState *state );
+
+// ----------------------------------------------------------------------------
+//  Waits for the next state frame (after VOL_SUBSCRIBE).
+//  timeout is in ms, -1 to wait forever. Returns 0 on success, -1 on error.
+// ----------------------------------------------------------------------------
+int volReceive( int sock, struct volState *state, int timeout );
+
+// ----------------------------------------------------------------------------
+//  Sends a line request and copies the reply line into reply.
+//  Returns 0 on success, -1 on error, timeout or "error" reply.
+// ----------------------------------------------------------------------------
+int volRequestLine( int sock, const char *line, char *reply, size_t size );
+
+// ----------------------------------------------------------------------------
+//  Closes connection to server.
+// ----------------------------------------------------------------------------
+void volClose( int sock );
+
+#endif
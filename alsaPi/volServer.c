@@ -0,0 +1,765 @@
+// ****************************************************************************
+// ****************************************************************************
+/*
+    volServer:
+
+    Resident volume control server using ALSA mixer controls.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+// ****************************************************************************
+// ****************************************************************************
+
+#define Version "Version 0.1"
+
+//  Compilation:
+//
+//  Compile with gcc volServer.c volClient.c -Wall -o volServer -lasound -lm
+//  Also use the following flags for Raspberry Pi optimisation:
+//         -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+//         -ffast-math -pipe -O3
+
+//  Authors:        agent       18/10/2026
+//  Contributors:
+//
+//  Changelog:
+//
+//  v0.1 Initial version.
+//
+
+//  Info:
+//
+//  Opening, loading and registering a mixer takes 30-80ms on a Pi 1, which
+//  is most of the cost of running setVolMixer. volServer does it once and
+//  keeps the mixer element for its lifetime. See volClient.h for protocol.
+//
+//  Each pass of the poll loop reads everything that is waiting on every
+//  connection into a pending state, writes the mixer once if the pending
+//  state differs, then replies to the clients that sent requests and
+//  notifies subscribers. The mixer's own poll descriptors are in the same
+//  loop, so changes made by alsamixer etc. are also passed to subscribers.
+//
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <alsa/asoundlib.h>
+#include <alsa/mixer.h>
+#include <argp.h>
+#include <math.h>
+
+#include "volClient.h"
+
+#define VOL_CLIENTS 16 // Maximum simultaneous connections.
+#define VOL_MIXER_FDS 8  // Maximum mixer poll descriptors.
+
+// ----------------------------------------------------------------------------
+//  argp documentation.
+// ----------------------------------------------------------------------------
+const char *argp_program_version = Version;
+const char *argp_program_bug_address = "darren@alidaf.co.uk";
+static char doc[] = "A resident volume control server for ALSA mixers.";
+static char args_doc[] = "volServer <options>";
+
+// ----------------------------------------------------------------------------
+//  Data definitions.
+// ----------------------------------------------------------------------------
+// Data structure to hold command line arguments.
+struct serverStruct
+{
+    char *card;
+    char *mixer;
+    char *socket;
+    float factor;
+    bool print;
+};
+
+// Data structure for each client connection.
+struct clientStruct
+{
+    int fd;                 // Socket, -1 if slot is free.
+    bool subscribed;        // Send state after every change.
+    bool reply;             // Requests waiting for a reply.
+    bool binary;            // Reply with a binary frame.
+    bool error;             // At least one request was invalid.
+    char buffer[VOL_LINE];  // Partial request.
+    size_t length;          // Bytes in buffer.
+};
+
+// Data structure for mixer handles, kept for the lifetime of the server.
+struct mixerStruct
+{
+    snd_mixer_t *handle;    // Mixer handle.
+    snd_mixer_elem_t *elem; // Mixer element handle.
+    snd_ctl_t *ctl;         // Control handle, opened on first use.
+    long minimum;           // Hardware volume limits.
+    long maximum;
+    bool hasSwitch;         // Element has a playback switch.
+    long left;              // Last values written or read.
+    long right;
+    bool on;
+};
+
+static struct clientStruct client[VOL_CLIENTS];
+static struct mixerStruct mixer;
+static volatile bool quit = false;
+
+// ----------------------------------------------------------------------------
+//  Command line argument definitions.
+// ----------------------------------------------------------------------------
+static struct argp_option options[] =
+{
+    { 0, 0, 0, 0, "Card information:" },
+    { "card", 'c', "<card>", 0, "Card name or hw:<num>." },
+    { "mixer", 'm', "<mixer>", 0, "Mixer name." },
+    { 0, 0, 0, 0, "Mixer parameters:" },
+    { "fac", 'f', "<int>", 0, "Volume shaping factor" },
+    { 0, 0, 0, 0, "Server parameters:" },
+    { "socket", 's', "<path>", 0, "Socket path." },
+    { "print", 'p', 0, 0, "Print changes." },
+    { 0 }
+};
+
+// ----------------------------------------------------------------------------
+//  Command line argument parser.
+// ----------------------------------------------------------------------------
+static int parse_opt( int param, char *arg, struct argp_state *state )
+{
+    struct serverStruct *server = state->input;
+
+    switch( param )
+    {
+        case 'c' :
+            server->card = arg;
+            break;
+        case 'm' :
+            server->mixer = arg;
+            break;
+        case 'f' :
+            server->factor = atof( arg );
+            break;
+        case 's' :
+            server->socket = arg;
+            break;
+        case 'p' :
+            server->print = true;
+            break;
+    }
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  argp parser parameter structure.
+// ----------------------------------------------------------------------------
+static struct argp argp = { options, parse_opt, args_doc, doc };
+
+// ----------------------------------------------------------------------------
+//  Returns mapped volume based on shaping factor (as setVolMixer).
+// ----------------------------------------------------------------------------
+static long getVolume( float volume, float factor,
+                       float minimum, float maximum )
+{
+    long mappedVolume;
+    float range = maximum - minimum;
+
+    if ( factor == 1 )
+         mappedVolume = lroundf(( volume / 100 * range ) + minimum );
+    else mappedVolume = lroundf((( pow( factor, volume / 100 ) - 1 ) /
+                                ( factor - 1 ) * range + minimum ));
+    return mappedVolume;
+};
+
+// ----------------------------------------------------------------------------
+//  Returns volume (%) from mapped volume. Inverse of getVolume.
+// ----------------------------------------------------------------------------
+static uint8_t getPercent( long mappedVolume, float factor,
+                           float minimum, float maximum )
+{
+    float fraction;
+    long volume;
+
+    if ( maximum <= minimum ) return 0;
+    fraction = ( mappedVolume - minimum ) / ( maximum - minimum );
+
+    if ( factor == 1 )
+         volume = lroundf( fraction * 100 );
+    else volume = lroundf( log( fraction * ( factor - 1 ) + 1 ) /
+                           log( factor ) * 100 );
+
+    if ( volume < 0 ) volume = 0;
+    if ( volume > 100 ) volume = 100;
+    return volume;
+};
+
+// ----------------------------------------------------------------------------
+//  Signal handler to close down cleanly.
+// ----------------------------------------------------------------------------
+static void signalQuit( int signal )
+{
+    quit = true;
+};
+
+// ----------------------------------------------------------------------------
+//  Opens mixer and finds element. Returns 0 or ALSA error.
+// ----------------------------------------------------------------------------
+static int mixerOpen( struct serverStruct *server )
+{
+    snd_mixer_selem_id_t *mixerId;
+    int err;
+
+    err = snd_mixer_open( &mixer.handle, 0 );
+    if ( err < 0 ) return err;
+    err = snd_mixer_attach( mixer.handle, server->card );
+    if ( err < 0 ) return err;
+    err = snd_mixer_selem_register( mixer.handle, NULL, NULL );
+    if ( err < 0 ) return err;
+    err = snd_mixer_load( mixer.handle );
+    if ( err < 0 ) return err;
+
+    snd_mixer_selem_id_alloca( &mixerId );
+    snd_mixer_selem_id_set_name( mixerId, server->mixer );
+    mixer.elem = snd_mixer_find_selem( mixer.handle, mixerId );
+    if ( mixer.elem == NULL ) return -ENOENT;
+
+    err = snd_mixer_selem_get_playback_volume_range( mixer.elem,
+                                                     &mixer.minimum,
+                                                     &mixer.maximum );
+    if ( err < 0 ) return err;
+    mixer.hasSwitch = snd_mixer_selem_has_playback_switch( mixer.elem );
+
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Reads mixer element into state.
+//  Returns true if it differs from the values last written.
+// ----------------------------------------------------------------------------
+static bool mixerRead( struct serverStruct *server, struct volState *state )
+{
+    long left, right;
+    int on = 1;
+
+    snd_mixer_selem_get_playback_volume( mixer.elem,
+                SND_MIXER_SCHN_FRONT_LEFT, &left );
+    if ( snd_mixer_selem_is_playback_mono( mixer.elem )) right = left;
+    else snd_mixer_selem_get_playback_volume( mixer.elem,
+                SND_MIXER_SCHN_FRONT_RIGHT, &right );
+    if ( mixer.hasSwitch )
+        snd_mixer_selem_get_playback_switch( mixer.elem,
+                SND_MIXER_SCHN_FRONT_LEFT, &on );
+
+    if (( left == mixer.left ) && ( right == mixer.right ) &&
+        ( on == mixer.on )) return false;
+
+    mixer.left = left;
+    mixer.right = right;
+    mixer.on = on;
+
+    // Without a switch, mute is setting volume to minimum, so leave the
+    // volume alone and let the state show muted until it is changed.
+    if ( !mixer.hasSwitch && state->mute &&
+         ( left == mixer.minimum ) && ( right == mixer.minimum ))
+        return false;
+
+    volFromChannels( state,
+        getPercent( left, server->factor, mixer.minimum, mixer.maximum ),
+        getPercent( right, server->factor, mixer.minimum, mixer.maximum ));
+    if ( mixer.hasSwitch ) state->mute = !on;
+
+    return true;
+};
+
+// ----------------------------------------------------------------------------
+//  Writes state to mixer element.
+// ----------------------------------------------------------------------------
+static void mixerWrite( struct serverStruct *server, struct volState *state )
+{
+    long left, right;
+
+    left = getVolume( state->left, server->factor,
+                      mixer.minimum, mixer.maximum );
+    right = getVolume( state->right, server->factor,
+                       mixer.minimum, mixer.maximum );
+    if ( state->mute && !mixer.hasSwitch )
+        left = right = mixer.minimum;
+
+    // If control is mono then FL will set volume.
+    if ( left != mixer.left )
+        snd_mixer_selem_set_playback_volume( mixer.elem,
+                SND_MIXER_SCHN_FRONT_LEFT, left );
+    if ( right != mixer.right )
+        snd_mixer_selem_set_playback_volume( mixer.elem,
+                SND_MIXER_SCHN_FRONT_RIGHT, right );
+    if ( mixer.hasSwitch && ( state->mute == mixer.on ))
+        snd_mixer_selem_set_playback_switch_all( mixer.elem, !state->mute );
+
+    // Remember what was written so the resulting mixer events are not
+    // mistaken for changes made elsewhere.
+    mixer.left = left;
+    mixer.right = right;
+    mixer.on = !state->mute;
+
+    if ( server->print )
+        printf( "Volume %3u, balance %4d, L %3u, R %3u, mute %s.\n",
+                state->volume, state->balance, state->left, state->right,
+                state->mute ? "on" : "off" );
+
+    return;
+};
+
+// ----------------------------------------------------------------------------
+//  Writes raw values to a control element. Returns 0 or -1.
+// ----------------------------------------------------------------------------
+static int controlWrite( struct serverStruct *server, const char *card,
+                         unsigned int numid, long value1, long value2 )
+{
+    snd_ctl_elem_value_t *control;
+    snd_ctl_elem_info_t *info;
+
+    // Only the server's own card is handled, anything else is left to the
+    // client to do directly.
+    if ( strcmp( card, server->card ) != 0 ) return -1;
+
+    if (( mixer.ctl == NULL ) &&
+        ( snd_ctl_open( &mixer.ctl, server->card, 0 ) < 0 ))
+    {
+        mixer.ctl = NULL;
+        return -1;
+    }
+
+    snd_ctl_elem_info_alloca( &info );
+    snd_ctl_elem_info_set_numid( info, numid );
+    if ( snd_ctl_elem_info( mixer.ctl, info ) < 0 ) return -1;
+    if ( snd_ctl_elem_info_get_type( info ) != SND_CTL_ELEM_TYPE_INTEGER )
+        return -1;
+
+    snd_ctl_elem_value_alloca( &control );
+    snd_ctl_elem_value_set_numid( control, numid );
+    snd_ctl_elem_value_set_integer( control, 0, value1 );
+    if ( snd_ctl_elem_info_get_count( info ) > 1 )
+        snd_ctl_elem_value_set_integer( control, 1, value2 );
+    if ( snd_ctl_elem_write( mixer.ctl, control ) < 0 ) return -1;
+
+    // Any change to the mixer element arrives as a mixer event.
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Limits value to range.
+// ----------------------------------------------------------------------------
+static int clamp( int value, int minimum, int maximum )
+{
+    if ( value < minimum ) return minimum;
+    if ( value > maximum ) return maximum;
+    return value;
+};
+
+// ----------------------------------------------------------------------------
+//  Applies a request to pending state. Returns 0 or -1 if invalid.
+// ----------------------------------------------------------------------------
+static int applyRequest( struct clientStruct *client, struct volState *state,
+                         uint8_t op, int arg1, int arg2 )
+{
+    switch( op )
+    {
+        case VOL_SET :
+            volFromChannels( state, clamp( arg1, 0, 100 ),
+                                    clamp( arg2, 0, 100 ));
+            break;
+        case VOL_STEP :
+            state->volume = clamp( state->volume + arg1, 0, 100 );
+            volBalance( state );
+            break;
+        case VOL_BALANCE :
+            state->balance = clamp( arg1, -100, 100 );
+            volBalance( state );
+            break;
+        case VOL_MUTE :
+            if ( arg1 == VOL_MUTE_TOGGLE ) state->mute = !state->mute;
+            else if ( arg1 == VOL_MUTE_ON ) state->mute = true;
+            else if ( arg1 == VOL_MUTE_OFF ) state->mute = false;
+            else return -1;
+            break;
+        case VOL_QUERY :
+            break;
+        case VOL_SUBSCRIBE :
+            client->subscribed = true;
+            break;
+        default :
+            return -1;
+    }
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Parses a line request and applies it to pending state.
+// ----------------------------------------------------------------------------
+static int parseLine( struct serverStruct *server,
+                      struct clientStruct *client, struct volState *state,
+                      char *line )
+{
+    char command[16];
+    char arg[VOL_LINE];
+    char card[16];
+    unsigned int numid;
+    long value1, value2;
+    int left, right;
+    int count;
+
+    count = sscanf( line, "%15s %127[^\n]", command, arg );
+    if ( count < 1 ) return -1;
+
+    if ( strcmp( command, "set" ) == 0 )
+    {
+        count = sscanf( arg, "%d,%d", &left, &right );
+        if ( count < 1 ) return -1;
+        if ( count == 1 ) right = left;
+        return applyRequest( client, state, VOL_SET, left, right );
+    }
+    if ( strcmp( command, "step" ) == 0 )
+    {
+        if ( sscanf( arg, "%d", &left ) != 1 ) return -1;
+        return applyRequest( client, state, VOL_STEP, left, 0 );
+    }
+    if ( strcmp( command, "balance" ) == 0 )
+    {
+        if ( sscanf( arg, "%d", &left ) != 1 ) return -1;
+        return applyRequest( client, state, VOL_BALANCE, left, 0 );
+    }
+    if ( strcmp( command, "mute" ) == 0 )
+    {
+        if ( strcmp( arg, "on" ) == 0 ) left = VOL_MUTE_ON;
+        else if ( strcmp( arg, "off" ) == 0 ) left = VOL_MUTE_OFF;
+        else if ( strcmp( arg, "toggle" ) == 0 ) left = VOL_MUTE_TOGGLE;
+        else return -1;
+        return applyRequest( client, state, VOL_MUTE, left, 0 );
+    }
+    if ( strcmp( command, "query" ) == 0 )
+        return applyRequest( client, state, VOL_QUERY, 0, 0 );
+    if ( strcmp( command, "subscribe" ) == 0 )
+        return applyRequest( client, state, VOL_SUBSCRIBE, 0, 0 );
+    if ( strcmp( command, "control" ) == 0 )
+    {
+        count = sscanf( arg, "%15s %u %ld,%ld", card, &numid,
+                        &value1, &value2 );
+        if ( count < 3 ) return -1;
+        if ( count == 3 ) value2 = value1;
+        return controlWrite( server, card, numid, value1, value2 );
+    }
+
+    return -1;
+};
+
+// ----------------------------------------------------------------------------
+//  Reads all waiting requests from a client. Returns -1 if disconnected.
+// ----------------------------------------------------------------------------
+static int readClient( struct serverStruct *server,
+                       struct clientStruct *client, struct volState *state )
+{
+    struct volFrame frame;
+    ssize_t count;
+    size_t used;
+    char *end;
+    int err;
+
+    count = recv( client->fd, client->buffer + client->length,
+                  sizeof( client->buffer ) - client->length, MSG_DONTWAIT );
+    if ( count == 0 ) return -1;
+    if ( count < 0 ) return ( errno == EAGAIN ) ? 0 : -1;
+    client->length += count;
+
+    // Buffer may hold several requests of either type.
+    while ( client->length > 0 )
+    {
+        if ((uint8_t)client->buffer[0] == VOL_MAGIC )
+        {
+            if ( client->length < sizeof( frame )) break;
+            memcpy( &frame, client->buffer, sizeof( frame ));
+            err = applyRequest( client, state, frame.op,
+                                frame.arg1, frame.arg2 );
+            client->binary = true;
+            used = sizeof( frame );
+        }
+        else
+        {
+            end = memchr( client->buffer, '\n', client->length );
+            if ( end == NULL )
+            {
+                // Line too long to ever complete, so discard it.
+                if ( client->length < sizeof( client->buffer )) break;
+                err = -1;
+                used = client->length;
+            }
+            else
+            {
+                *end = '\0';
+                if (( end > client->buffer ) && ( end[-1] == '\r' ))
+                    end[-1] = '\0';
+                err = parseLine( server, client, state, client->buffer );
+                used = end - client->buffer + 1;
+            }
+            client->binary = false;
+        }
+        if ( err < 0 ) client->error = true;
+        client->reply = true;
+
+        client->length -= used;
+        memmove( client->buffer, client->buffer + used, client->length );
+    }
+
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Sends state, or an error, to a client. Returns -1 if disconnected.
+// ----------------------------------------------------------------------------
+static int sendState( struct clientStruct *client, struct volState *state,
+                      bool error )
+{
+    struct volFrame frame = { VOL_MAGIC, VOL_STATE,
+                              state->volume, state->balance };
+    char line[VOL_LINE];
+    size_t length;
+
+    if ( client->binary )
+    {
+        if ( error ) frame.op = VOL_ERROR;
+        else if ( state->mute ) frame.op |= VOL_MUTED;
+        length = sizeof( frame );
+        memcpy( line, &frame, length );
+    }
+    else if ( error ) length = sprintf( line, "error\n" );
+    else length = sprintf( line,
+                    "volume %u balance %d mute %s left %u right %u\n",
+                    state->volume, state->balance,
+                    state->mute ? "on" : "off",
+                    state->left, state->right );
+
+    // Never block on a slow client.
+    if ( send( client->fd, line, length,
+               MSG_DONTWAIT | MSG_NOSIGNAL ) != (ssize_t)length ) return -1;
+
+    return 0;
+};
+
+// ----------------------------------------------------------------------------
+//  Closes a client connection and frees its slot.
+// ----------------------------------------------------------------------------
+static void closeClient( struct clientStruct *client )
+{
+    close( client->fd );
+    memset( client, 0, sizeof( struct clientStruct ));
+    client->fd = -1;
+
+    return;
+};
+
+// ----------------------------------------------------------------------------
+//  Creates listening socket. Returns socket or -1.
+// ----------------------------------------------------------------------------
+static int openSocket( const char *path )
+{
+    struct sockaddr_un address;
+    int sock;
+
+    // Refuse to replace the socket of a server that is still running.
+    sock = volConnect( path );
+    if ( sock >= 0 )
+    {
+        volClose( sock );
+        printf( "Server already running on %s.\n", path );
+        return -1;
+    }
+    if ( strlen( path ) >= sizeof( address.sun_path )) return -1;
+    unlink( path );
+
+    sock = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( sock < 0 ) return -1;
+
+    memset( &address, 0, sizeof( address ));
+    address.sun_family = AF_UNIX;
+    strcpy( address.sun_path, path );
+
+    if (( bind( sock, (struct sockaddr *)&address, sizeof( address )) < 0 ) ||
+        ( listen( sock, VOL_CLIENTS ) < 0 ))
+    {
+        printf( "Couldn't open socket %s.\n", path );
+        close( sock );
+        return -1;
+    }
+    fcntl( sock, F_SETFL, O_NONBLOCK );
+
+    return sock;
+};
+
+// ============================================================================
+//  Main routine.
+// ============================================================================
+int main( int argc, char *argv[] )
+{
+    struct serverStruct server =
+    {
+        .card = "hw:0",
+        .mixer = "PCM",
+        .socket = VOL_SOCKET,
+        .factor = 0.01,
+        .print = false
+    };
+    struct pollfd pfd[1 + VOL_CLIENTS + VOL_MIXER_FDS];
+    struct volState current, pending;
+    unsigned short revents;
+    int listener, fd;
+    int mixerFds, nfds;
+    bool changed;
+    int err;
+    int i;
+
+    // ------------------------------------------------------------------------
+    //  Get command line parameters.
+    // ------------------------------------------------------------------------
+    argp_parse( &argp, argc, argv, 0, 0, &server );
+
+    // ------------------------------------------------------------------------
+    //  Set up ALSA mixer and socket.
+    // ------------------------------------------------------------------------
+    err = mixerOpen( &server );
+    if ( err < 0 )
+    {
+        printf( "Couldn't open mixer %s on %s: %s.\n",
+                server.mixer, server.card, snd_strerror( err ));
+        return -1;
+    }
+    memset( &current, 0, sizeof( current ));
+    mixer.left = mixer.right = mixer.minimum - 1; // Force first read.
+    mixerRead( &server, &current );
+    pending = current;
+
+    mixerFds = snd_mixer_poll_descriptors_count( mixer.handle );
+    if ( mixerFds > VOL_MIXER_FDS ) mixerFds = VOL_MIXER_FDS;
+
+    listener = openSocket( server.socket );
+    if ( listener < 0 ) return -1;
+
+    for ( i = 0; i < VOL_CLIENTS; i++ ) client[i].fd = -1;
+
+    signal( SIGINT, signalQuit );
+    signal( SIGTERM, signalQuit );
+    signal( SIGPIPE, SIG_IGN );
+
+    // ------------------------------------------------------------------------
+    //  Serve requests.
+    // ------------------------------------------------------------------------
+    while ( !quit )
+    {
+        // Listener, then clients, then mixer descriptors.
+        nfds = 0;
+        pfd[nfds].fd = listener;
+        pfd[nfds++].events = POLLIN;
+        for ( i = 0; i < VOL_CLIENTS; i++ )
+        {
+            pfd[nfds].fd = client[i].fd; // Negative fds are ignored.
+            pfd[nfds++].events = POLLIN;
+        }
+        snd_mixer_poll_descriptors( mixer.handle, &pfd[nfds], mixerFds );
+
+        if ( poll( pfd, nfds + mixerFds, -1 ) < 0 ) continue;
+
+        // Changes made elsewhere. These replace pending state, any requests
+        // in this pass are applied on top.
+        changed = false;
+        snd_mixer_poll_descriptors_revents( mixer.handle, &pfd[nfds],
+                                            mixerFds, &revents );
+        if ( revents & POLLIN )
+        {
+            snd_mixer_handle_events( mixer.handle );
+            if ( mixerRead( &server, &pending ))
+            {
+                current = pending;
+                changed = true;
+            }
+        }
+
+        // New connections.
+        if ( pfd[0].revents & POLLIN )
+        {
+            while (( fd = accept( listener, NULL, NULL )) >= 0 )
+            {
+                for ( i = 0; i < VOL_CLIENTS; i++ )
+                    if ( client[i].fd < 0 ) break;
+                if ( i == VOL_CLIENTS ) close( fd );
+                else client[i].fd = fd;
+            }
+        }
+
+        // Drain all requests into pending state.
+        for ( i = 0; i < VOL_CLIENTS; i++ )
+        {
+            if ( client[i].fd < 0 ) continue;
+            if ( pfd[1 + i].fd != client[i].fd ) continue; // New this pass.
+            if ( pfd[1 + i].revents & ( POLLIN | POLLHUP | POLLERR ))
+                if ( readClient( &server, &client[i], &pending ) < 0 )
+                    closeClient( &client[i] );
+        }
+
+        // Apply once.
+        if (( pending.left != current.left ) ||
+            ( pending.right != current.right ) ||
+            ( pending.mute != current.mute ) ||
+            ( pending.volume != current.volume ) ||
+            ( pending.balance != current.balance ))
+        {
+            mixerWrite( &server, &pending );
+            current = pending;
+            changed = true;
+        }
+
+        // Reply to requests and notify subscribers.
+        for ( i = 0; i < VOL_CLIENTS; i++ )
+        {
+            if ( client[i].fd < 0 ) continue;
+            if ( !client[i].reply && !( changed && client[i].subscribed ))
+                continue;
+            err = sendState( &client[i], &current,
+                             client[i].reply && client[i].error );
+            client[i].reply = false;
+            client[i].error = false;
+            if ( err < 0 ) closeClient( &client[i] );
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    //  Clean up.
+    // ------------------------------------------------------------------------
+    for ( i = 0; i < VOL_CLIENTS; i++ )
+        if ( client[i].fd >= 0 ) closeClient( &client[i] );
+    close( listener );
+    unlink( server.socket );
+
+    if ( mixer.ctl != NULL ) snd_ctl_close( mixer.ctl );
+    snd_mixer_detach( mixer.handle, server.card );
+    snd_mixer_close( mixer.handle );
+
+    return 0;
+}
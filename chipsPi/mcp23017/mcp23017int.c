@@ -0,0 +1,434 @@
+/*
+//  ===========================================================================
+
+    mcp23017int:
+
+    Interrupt driven encoder and button inputs for the MCP23017.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        MCP23017 data sheet.
+        - see http://ww1.microchip.com/downloads/en/DeviceDoc/21952b.pdf
+        State transition tables from rotencPi.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic mcp23017int.c mcp23017.c
+        gcc -shared -o libmcp23017int.so mcp23017int.o mcp23017.o
+
+    For Raspberry Pi optimisation use the following flags:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026.
+
+    Contributors:
+
+    Changelog:
+
+        v0.1    Original version.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+
+#include "mcp23017.h"
+#include "mcp23017int.h"
+#include "../../rotencPi/rotencPi.h"
+
+//  Data structures. ----------------------------------------------------------
+
+// State tables from rotencPi. Simple is indexed by old and new AB, half
+// and full by state and BA.
+static const int8_t simpleTable[SIMPLE_TABLE_COLS] = SIMPLE_TABLE;
+static const uint8_t halfTable[HALF_TABLE_ROWS][HALF_TABLE_COLS] = HALF_TABLE;
+static const uint8_t fullTable[FULL_TABLE_ROWS][FULL_TABLE_COLS] = FULL_TABLE;
+
+//  Pi GPIO functions. --------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Writes string to sysfs gpio file. Returns 0 or -1 on error.
+//  ---------------------------------------------------------------------------
+static int8_t gpioWrite( const char *path, const char *value )
+{
+    int fd;
+    int len = strlen( value );
+
+    fd = open( path, O_WRONLY );
+    if ( fd < 0 ) return -1;
+
+    if ( write( fd, value, len ) != len ) len = -1;
+    close( fd );
+
+    return ( len < 0 ) ? -1 : 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Exports Pi gpio as input with falling edge interrupt.
+//  ---------------------------------------------------------------------------
+/*
+    Returns file descriptor of value file for poll() or -1 on error.
+*/
+static int gpioOpen( uint8_t gpio )
+{
+    char path[48];
+    char value[4];
+    int  fd;
+
+    // Fails harmlessly if already exported.
+    snprintf( value, sizeof( value ), "%u", gpio );
+    gpioWrite( "/sys/class/gpio/export", value );
+
+    snprintf( path, sizeof( path ), "/sys/class/gpio/gpio%u/direction", gpio );
+    if ( gpioWrite( path, "in" ) < 0 ) return -1;
+    snprintf( path, sizeof( path ), "/sys/class/gpio/gpio%u/edge", gpio );
+    if ( gpioWrite( path, "falling" ) < 0 ) return -1;
+
+    snprintf( path, sizeof( path ), "/sys/class/gpio/gpio%u/value", gpio );
+    fd = open( path, O_RDONLY );
+    if ( fd < 0 ) return -1;
+
+    // Clear any pending event.
+    read( fd, value, sizeof( value ));
+
+    return fd;
+}
+
+//  ---------------------------------------------------------------------------
+//  Closes and unexports Pi gpio.
+//  ---------------------------------------------------------------------------
+static void gpioClose( uint8_t gpio, int fd )
+{
+    char value[4];
+
+    if ( fd >= 0 ) close( fd );
+
+    snprintf( value, sizeof( value ), "%u", gpio );
+    gpioWrite( "/sys/class/gpio/unexport", value );
+}
+
+//  MCP23017 input functions. -------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises inputs for MCP23017 with INTA connected to Pi gpio.
+//  ---------------------------------------------------------------------------
+void mcp23017IntInit( struct mcp23017Inputs *inputs,
+                      struct mcp23017 *mcp23017, uint8_t gpio )
+{
+    memset( inputs, 0, sizeof( struct mcp23017Inputs ));
+    inputs->mcp23017 = mcp23017;
+    inputs->gpio = gpio;
+    inputs->fd = -1;
+    inputs->last = 0xffff;  // Pulled up.
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds an encoder. Returns encoder index, or -1 if invalid.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntAddEncoder( struct mcp23017Inputs *inputs,
+                              uint8_t pinA, uint8_t pinB,
+                              enum mcp23017Decode mode )
+{
+    struct mcp23017Encoder *encoder;
+    uint16_t mask;
+
+    if ( inputs->encoders >= MCP23017_ENCODERS_MAX ) return -1;
+    if (( pinA >= MCP23017_PINS ) || ( pinB >= MCP23017_PINS )) return -1;
+    if ( pinA == pinB ) return -1;
+
+    mask = ( 1 << pinA ) | ( 1 << pinB );
+    if ( inputs->pins & mask ) return -1;   // Pin already used.
+
+    encoder = &inputs->encoder[inputs->encoders];
+    encoder->pinA  = pinA;
+    encoder->pinB  = pinB;
+    encoder->mode  = mode;
+    encoder->state = ( mode == DECODE_SIMPLE ) ? 0x3 : 0; // Pulled up.
+    encoder->delta = 0;
+    encoder->count = 0;
+
+    inputs->pins |= mask;
+
+    return inputs->encoders++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds a button. Returns button index, or -1 if invalid.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntAddButton( struct mcp23017Inputs *inputs, uint8_t pin )
+{
+    struct mcp23017Button *button;
+
+    if ( inputs->buttons >= MCP23017_BUTTONS_MAX ) return -1;
+    if ( pin >= MCP23017_PINS ) return -1;
+    if ( inputs->pins & ( 1 << pin )) return -1;
+
+    button = &inputs->button[inputs->buttons];
+    button->pin     = pin;
+    button->pressed = false;
+    button->presses = 0;
+
+    inputs->pins |= 1 << pin;
+
+    return inputs->buttons++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Decodes a pin snapshot into encoder and button states.
+//  ---------------------------------------------------------------------------
+void mcp23017IntDecode( struct mcp23017Inputs *inputs, uint16_t pins,
+                        bool accumulate )
+{
+    struct mcp23017Encoder *encoder;
+    uint16_t changed = ( pins ^ inputs->last ) & inputs->pins;
+    uint8_t  direction;
+    uint8_t  code;
+    int8_t   step;
+    uint8_t  i;
+
+    if ( !accumulate )
+    {
+        for ( i = 0; i < inputs->encoders; i++ )
+            inputs->encoder[i].delta = 0;
+        inputs->changed = 0;
+    }
+
+    inputs->last = pins;
+    if ( !changed ) return;
+    inputs->changed |= changed;
+
+    // Step every encoder with a changed pin.
+    for ( i = 0; i < inputs->encoders; i++ )
+    {
+        encoder = &inputs->encoder[i];
+        if ( !( changed & (( 1 << encoder->pinA ) | ( 1 << encoder->pinB ))))
+            continue;
+
+        bool a = ( pins >> encoder->pinA ) & 1;
+        bool b = ( pins >> encoder->pinB ) & 1;
+
+        switch ( encoder->mode )
+        {
+            case DECODE_SIMPLE:
+                // Shift old AB into higher bits and new AB into lower bits.
+                encoder->state = (( encoder->state << 2 ) |
+                                  ( a << 1 ) | b ) & 0xf;
+                step = simpleTable[encoder->state];
+                break;
+            case DECODE_HALF:
+                code = ( b << 1 ) | a;
+                encoder->state = halfTable[encoder->state & 0xf][code];
+                direction = encoder->state & 0x30;
+                step = direction ? ( direction == 0x10 ? -1 : 1 ) : 0;
+                break;
+            default:
+                code = ( b << 1 ) | a;
+                encoder->state = fullTable[encoder->state & 0xf][code];
+                direction = encoder->state & 0x30;
+                step = direction ? ( direction == 0x10 ? -1 : 1 ) : 0;
+                break;
+        }
+
+        encoder->delta += step;
+        encoder->count += step;
+    }
+
+    // Buttons switch to GND so pressed = low.
+    for ( i = 0; i < inputs->buttons; i++ )
+    {
+        if ( !( changed & ( 1 << inputs->button[i].pin ))) continue;
+        inputs->button[i].pressed = !(( pins >> inputs->button[i].pin ) & 1 );
+        if ( inputs->button[i].pressed ) inputs->button[i].presses++;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads INTFA to GPIOB in a single I2C transaction. Returns 0 or -1.
+//  ---------------------------------------------------------------------------
+static int8_t mcp23017IntRead( struct mcp23017Inputs *inputs,
+                               uint16_t *flags, uint16_t *capture,
+                               uint16_t *port )
+{
+    uint8_t snapshot[MCP23017_SNAPSHOT];
+    uint8_t handle = inputs->mcp23017->id;
+
+    // I2C handle is shared, so select device. No bus traffic.
+    if ( ioctl( handle, I2C_SLAVE, inputs->mcp23017->addr ) < 0 ) return -1;
+
+    if ( i2c_smbus_read_i2c_block_data( handle, BANK0_INTFA,
+                                        MCP23017_SNAPSHOT, snapshot )
+                                        != MCP23017_SNAPSHOT ) return -1;
+    inputs->reads++;
+
+    *flags   = snapshot[0] | ( snapshot[1] << 8 );
+    *capture = snapshot[2] | ( snapshot[3] << 8 );
+    *port    = snapshot[4] | ( snapshot[5] << 8 );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Configures MCP23017 interrupts and Pi gpio. Returns 0 or -1 on error.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntStart( struct mcp23017Inputs *inputs )
+{
+    struct mcp23017 *mcp23017 = inputs->mcp23017;
+    uint8_t  pinsA = inputs->pins & 0xff;
+    uint8_t  pinsB = inputs->pins >> 8;
+    uint16_t flags, capture, port;
+    uint8_t  i;
+
+    if ( inputs->pins == 0 ) return -1;
+
+    /*
+        BANK = 0 and SEQOP = 0 for the block read, MIRROR = 1 so INTA
+        serves both ports. INTA is an active low driver (ODR = INTPOL = 0)
+        so no pull-up is needed on the Pi gpio.
+    */
+    mcp23017->bank = BANK_0;
+    if ( mcp23017WriteByte( mcp23017, IOCONA, IOCON_MIRROR ) < 0 ) return -1;
+
+    // Inputs with pull-ups.
+    mcp23017SetBitsByte( mcp23017, IODIRA, pinsA );
+    mcp23017SetBitsByte( mcp23017, IODIRB, pinsB );
+    mcp23017ClearBitsByte( mcp23017, IPOLA, pinsA );
+    mcp23017ClearBitsByte( mcp23017, IPOLB, pinsB );
+    mcp23017SetBitsByte( mcp23017, GPPUA, pinsA );
+    mcp23017SetBitsByte( mcp23017, GPPUB, pinsB );
+
+    // Interrupt on change from previous value. DEFVAL = idle state.
+    mcp23017SetBitsByte( mcp23017, DEFVALA, pinsA );
+    mcp23017SetBitsByte( mcp23017, DEFVALB, pinsB );
+    mcp23017ClearBitsByte( mcp23017, INTCONA, pinsA );
+    mcp23017ClearBitsByte( mcp23017, INTCONB, pinsB );
+    mcp23017SetBitsByte( mcp23017, GPINTENA, pinsA );
+    mcp23017SetBitsByte( mcp23017, GPINTENB, pinsB );
+
+    inputs->fd = gpioOpen( inputs->gpio );
+    if ( inputs->fd < 0 )
+    {
+        printf( "Couldn't open gpio %u.\n", inputs->gpio );
+        printf( "Error code = %d.\n", errno );
+        return -1;
+    }
+
+    // Clear any pending interrupt and take initial state without events.
+    if ( mcp23017IntRead( inputs, &flags, &capture, &port ) < 0 ) return -1;
+    inputs->last = port;
+    for ( i = 0; i < inputs->encoders; i++ )
+        if ( inputs->encoder[i].mode == DECODE_SIMPLE )
+            inputs->encoder[i].state =
+                ((( port >> inputs->encoder[i].pinA ) & 1 ) << 1 ) |
+                  (( port >> inputs->encoder[i].pinB ) & 1 );
+    for ( i = 0; i < inputs->buttons; i++ )
+        inputs->button[i].pressed =
+            !(( port >> inputs->button[i].pin ) & 1 );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads snapshot and decodes inputs. Returns 0 or -1 on I2C error.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntService( struct mcp23017Inputs *inputs )
+{
+    uint16_t flags, capture, port;
+
+    if ( mcp23017IntRead( inputs, &flags, &capture, &port ) < 0 ) return -1;
+    inputs->interrupts++;
+
+    // Pins at interrupt, then any changes since.
+    if ( flags )
+    {
+        mcp23017IntDecode( inputs, capture, false );
+        mcp23017IntDecode( inputs, port, true );
+    }
+    else
+        mcp23017IntDecode( inputs, port, false );
+
+    if ( inputs->changed && ( inputs->callback != NULL ))
+        inputs->callback( inputs );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Waits for interrupts on several MCP23017s and services them.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntWait( struct mcp23017Inputs *inputs[], uint8_t count,
+                        int timeout )
+{
+    struct pollfd fds[MCP23017_MAX];
+    char    value[4];
+    int     ready;
+    int8_t  serviced = 0;
+    uint8_t i;
+
+    if (( count == 0 ) || ( count > MCP23017_MAX )) return -1;
+
+    for ( i = 0; i < count; i++ )
+    {
+        fds[i].fd = inputs[i]->fd;
+        fds[i].events = POLLPRI | POLLERR;
+        fds[i].revents = 0;
+    }
+
+    ready = poll( fds, count, timeout );
+    if ( ready < 0 ) return ( errno == EINTR ) ? 0 : -1;
+
+    for ( i = 0; i < count; i++ )
+    {
+        if ( !( fds[i].revents & POLLPRI )) continue;
+
+        // Re-arm sysfs edge detection.
+        lseek( fds[i].fd, 0, SEEK_SET );
+        read( fds[i].fd, value, sizeof( value ));
+
+        if ( mcp23017IntService( inputs[i] ) < 0 ) return -1;
+        serviced++;
+    }
+
+    return serviced;
+}
+
+//  ---------------------------------------------------------------------------
+//  Disables interrupts and releases Pi gpio.
+//  ---------------------------------------------------------------------------
+void mcp23017IntClose( struct mcp23017Inputs *inputs )
+{
+    mcp23017ClearBitsByte( inputs->mcp23017, GPINTENA, inputs->pins & 0xff );
+    mcp23017ClearBitsByte( inputs->mcp23017, GPINTENB, inputs->pins >> 8 );
+
+    gpioClose( inputs->gpio, inputs->fd );
+    inputs->fd = -1;
+}
@@ -0,0 +1,194 @@
+/*
+//  ===========================================================================
+
+    mcp23017int:
+
+    Interrupt driven encoder and button inputs for the MCP23017.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        MCP23017 data sheet.
+        - see http://ww1.microchip.com/downloads/en/DeviceDoc/21952b.pdf
+        State transition tables from rotencPi.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Authors:        agent       18/10/2026  This program.
+
+    Contributors:
+
+//  Information. --------------------------------------------------------------
+
+    Up to 8 encoders or 16 buttons (or a mixture) can be connected to each
+    MCP23017 instead of to the Pi's GPIOs. Only a single Pi GPIO is needed
+    per MCP23017:
+
+                        +-----------( )-----------+
+                        |  Fn  | pin | pin |  Fn  |
+                        |------+-----+-----+------|
+           Encoder 4A --| GPB0 |  01 | 28  | GPA7 |-- Encoder 3B
+           Encoder 4B --| GPB1 |  02 | 27  | GPA6 |-- Encoder 3A
+                 ...  --|  ... | ... | ... |  ... |--  ...
+                        |  VDD |  09 | 20  | INTA |---> Pi GPIO (eg. 4).
+                        |  VSS |  10 | 19  | INTB |-x
+                        +-------------------------+
+
+    Pins are numbered 0 to 15, where 0 to 7 are GPA0 to GPA7 and 8 to 15
+    are GPB0 to GPB7. Inputs are pulled up internally and should switch
+    to GND.
+
+    IOCON is set with MIRROR = 1 so INTA is asserted for changes on
+    either port, and ODR = INTPOL = 0 so INTA is driven and active low
+    (INTPOL = 0 is active low in the data sheet), needing no pull-up.
+    The Pi GPIO is watched for a falling edge with poll() on its sysfs
+    value file.
+
+    All inputs use interrupt-on-change (INTCON = 0), comparing with the
+    previous pin state. DEFVAL is set to the idle state of the pins but is
+    not used for comparison since a held button would keep INTA asserted.
+
+    When INTA falls, INTFA to GPIOB are read in a single sequential block
+    read (IOCON.BANK = 0, SEQOP = 0):
+
+        +-----------------------------------------------+
+        | INTFA | INTFB | INTCAPA | INTCAPB | GPIOA | GPIOB |
+        +-----------------------------------------------+
+
+    INTCAP holds the pins at the time of the interrupt and GPIO holds the
+    pins now, which catches any changes between the interrupt and the
+    read. Reading clears the interrupt. Both snapshots are passed through
+    the decoder, which steps every encoder with changed pins in one pass,
+    so there is exactly one I2C read per interrupt regardless of how many
+    inputs changed.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#ifndef MCP23017INT_H
+#define MCP23017INT_H
+
+//  Macros. -------------------------------------------------------------------
+
+#define MCP23017_PINS          16 // Pins per MCP23017.
+#define MCP23017_ENCODERS_MAX   8 // Max encoders per MCP23017.
+#define MCP23017_BUTTONS_MAX   16 // Max buttons per MCP23017.
+#define MCP23017_SNAPSHOT       6 // INTFA to GPIOB.
+
+// IOCON bits.
+#define IOCON_BANK   0x80
+#define IOCON_MIRROR 0x40
+#define IOCON_SEQOP  0x20
+#define IOCON_DISSLW 0x10
+#define IOCON_HAEN   0x08
+#define IOCON_ODR    0x04
+#define IOCON_INTPOL 0x02
+
+//  Data structures. ----------------------------------------------------------
+
+// Decoder methods, as rotencPi.
+enum mcp23017Decode { DECODE_SIMPLE, DECODE_HALF, DECODE_FULL };
+
+struct mcp23017Encoder
+{
+    uint8_t             pinA;   // Pin for encoder A (0-15).
+    uint8_t             pinB;   // Pin for encoder B (0-15).
+    enum mcp23017Decode mode;   // Decoder method.
+    uint8_t             state;  // Transition table state or old AB.
+    int8_t              delta;  // Steps in last interrupt.
+    int32_t             count;  // Running count.
+};
+
+struct mcp23017Button
+{
+    uint8_t  pin;               // Pin for button (0-15).
+    bool     pressed;           // Button state.
+    uint32_t presses;           // Running count.
+};
+
+struct mcp23017Inputs
+{
+    struct mcp23017       *mcp23017;    // MCP23017 with inputs.
+    uint8_t                gpio;        // Pi GPIO connected to INTA.
+    int                    fd;          // Sysfs value file for gpio.
+    uint16_t               pins;        // Pins used as inputs.
+    uint16_t               last;        // Last pin snapshot.
+    uint16_t               changed;     // Pins changed in last interrupt.
+    struct mcp23017Encoder encoder[MCP23017_ENCODERS_MAX];
+    uint8_t                encoders;
+    struct mcp23017Button  button[MCP23017_BUTTONS_MAX];
+    uint8_t                buttons;
+    void                 (*callback)( struct mcp23017Inputs *inputs );
+    uint32_t               interrupts;  // Interrupts serviced.
+    uint32_t               reads;       // I2C reads.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises inputs for MCP23017 with INTA connected to Pi gpio.
+//  ---------------------------------------------------------------------------
+void mcp23017IntInit( struct mcp23017Inputs *inputs,
+                      struct mcp23017 *mcp23017, uint8_t gpio );
+
+//  ---------------------------------------------------------------------------
+//  Adds an encoder. Returns encoder index, or -1 if invalid.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntAddEncoder( struct mcp23017Inputs *inputs,
+                              uint8_t pinA, uint8_t pinB,
+                              enum mcp23017Decode mode );
+
+//  ---------------------------------------------------------------------------
+//  Adds a button. Returns button index, or -1 if invalid.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntAddButton( struct mcp23017Inputs *inputs, uint8_t pin );
+
+//  ---------------------------------------------------------------------------
+//  Decodes a pin snapshot into encoder and button states.
+//  ---------------------------------------------------------------------------
+/*
+    pins holds GPA0-7 in bits 0-7 and GPB0-7 in bits 8-15. Sets changed and
+    encoder deltas, which are zeroed first unless accumulate is true.
+*/
+void mcp23017IntDecode( struct mcp23017Inputs *inputs, uint16_t pins,
+                        bool accumulate );
+
+//  ---------------------------------------------------------------------------
+//  Configures MCP23017 interrupts and Pi gpio. Returns 0 or -1 on error.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntStart( struct mcp23017Inputs *inputs );
+
+//  ---------------------------------------------------------------------------
+//  Reads snapshot and decodes inputs. Returns 0 or -1 on I2C error.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017IntService( struct mcp23017Inputs *inputs );
+
+//  ---------------------------------------------------------------------------
+//  Waits for interrupts on several MCP23017s and services them.
+//  ---------------------------------------------------------------------------
+/*
+    timeout is in ms, -1 to wait forever. Returns number of MCP23017s
+    serviced, 0 on timeout or -1 on error.
+*/
+int8_t mcp23017IntWait( struct mcp23017Inputs *inputs[], uint8_t count,
+                        int timeout );
+
+//  ---------------------------------------------------------------------------
+//  Disables interrupts and releases Pi gpio.
+//  ---------------------------------------------------------------------------
+void mcp23017IntClose( struct mcp23017Inputs *inputs );
+
+#endif
@@ -0,0 +1,165 @@
+/*
+//  ===========================================================================
+
+    testmcp23017int:
+
+    Tests MCP23017 interrupt driven inputs for the Raspberry Pi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+*/
+
+#define Version "Version 0.1"
+
+/*
+//  ---------------------------------------------------------------------------
+
+    Compile with:
+
+    gcc testmcp23017int.c mcp23017int.c mcp23017.c -Wall -o testmcp23017int
+
+    Also use the following flags for Raspberry Pi optimisation:
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026  This program.
+
+    Contributors:
+
+    Changelog:
+
+        v0.1    Original version.
+
+//  Information. --------------------------------------------------------------
+
+    For testing, 4 encoders with push switches were connected as follows:
+
+                        +-----------( )-----------+
+                        |  Fn  | pin | pin |  Fn  |
+                        |------+-----+-----+------|
+         Encoder 2 A ---| GPB0 |  01 | 28  | GPA7 |--- Encoder 1 SW
+         Encoder 2 B ---| GPB1 |  02 | 27  | GPA6 |--- Encoder 1 B
+         Encoder 2 SW --| GPB2 |  03 | 26  | GPA5 |--- Encoder 1 A
+         Encoder 3 A ---| GPB3 |  04 | 25  | GPA4 |--- Encoder 0 SW
+         Encoder 3 B ---| GPB4 |  05 | 24  | GPA3 |--- Encoder 0 B
+         Encoder 3 SW --| GPB5 |  06 | 23  | GPA2 |--- Encoder 0 A
+                        | GPB6 |  07 | 22  | GPA1 |
+                        | GPB7 |  08 | 21  | GPA0 |
+              +3.3V <---|  VDD |  09 | 20  | INTA |---> GPIO 4.
+                GND <---|  VSS |  10 | 19  | INTB |
+                        |   NC |  11 | 18  | RST  |---> +3.3V.
+            I2C CLK <---|  SCL |  12 | 17  | A2   |---> GND }
+            I2C I/O <---|  SDA |  13 | 16  | A1   |---> GND } Address = 0x20.
+                        |   NC |  14 | 15  | A0   |---> GND }
+                        +-------------------------+
+
+    Encoder and switch commons are connected to GND.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <signal.h>
+
+#include "mcp23017.h"
+#include "mcp23017int.h"
+
+#define TEST_ENCODERS 4
+#define TEST_GPIO     4
+
+static volatile bool stop = false;
+
+//  ---------------------------------------------------------------------------
+//  Stops test on Ctrl-C.
+//  ---------------------------------------------------------------------------
+static void testStop( int signal )
+{
+    (void)signal;
+    stop = true;
+}
+
+//  ---------------------------------------------------------------------------
+//  Prints changed inputs. Called once per interrupt.
+//  ---------------------------------------------------------------------------
+static void testChanged( struct mcp23017Inputs *inputs )
+{
+    uint8_t i;
+
+    for ( i = 0; i < inputs->encoders; i++ )
+        if ( inputs->encoder[i].delta )
+            printf( "Encoder %u: %+d, count = %d.\n", i,
+                    inputs->encoder[i].delta, inputs->encoder[i].count );
+
+    for ( i = 0; i < inputs->buttons; i++ )
+        if ( inputs->changed & ( 1 << inputs->button[i].pin ))
+            printf( "Button %u: %s, presses = %u.\n", i,
+                    inputs->button[i].pressed ? "pressed" : "released",
+                    inputs->button[i].presses );
+}
+
+int main()
+{
+    struct mcp23017Inputs  inputs;
+    struct mcp23017Inputs *wait[1] = { &inputs };
+
+    // Pins for encoder A, B and switch.
+    const uint8_t pins[TEST_ENCODERS][3] =
+        {{ 2, 3, 4 }, { 5, 6, 7 }, { 8, 9, 10 }, { 11, 12, 13 }};
+
+    int8_t  err;
+    uint8_t i;
+
+    err = mcp23017Init( 0x20 );
+    if ( err < 0 )
+    {
+        printf( "Couldn't init.\n" );
+        return -1;
+    }
+
+    mcp23017IntInit( &inputs, mcp23017[0], TEST_GPIO );
+    for ( i = 0; i < TEST_ENCODERS; i++ )
+    {
+        mcp23017IntAddEncoder( &inputs, pins[i][0], pins[i][1], DECODE_HALF );
+        mcp23017IntAddButton( &inputs, pins[i][2] );
+    }
+    inputs.callback = testChanged;
+
+    if ( mcp23017IntStart( &inputs ) < 0 )
+    {
+        printf( "Couldn't start interrupts.\n" );
+        return -1;
+    }
+
+    signal( SIGINT, testStop );
+    printf( "Turn encoders and press buttons, Ctrl-C to stop.\n" );
+
+    while ( !stop )
+        if ( mcp23017IntWait( wait, 1, 1000 ) < 0 ) break;
+
+    mcp23017IntClose( &inputs );
+
+    printf( "\nInterrupts = %u, I2C reads = %u.\n",
+            inputs.interrupts, inputs.reads );
+
+    return 0;
+}
@@ -49,6 +49,7 @@
 
         v0.1    Original version.
         v0.2    Rewrote to use 8-bit interface.
+        v0.3    Added simultaneous writes to multiple displays.
 
 //  ---------------------------------------------------------------------------
 
@@ -169,6 +170,257 @@ int8_t hd44780Goto( struct mcp23017 *mcp23017, struct hd44780 *hd44780,
     return 0;
 };
 
+//  Multiple display functions. -----------------------------------------------
+
+#define TEXT_MULTI_MAX ( HD44780_MAX * DISPLAY_ROWS_MAX ) // Max text structs.
+
+//  ---------------------------------------------------------------------------
+//  Combines RS and R/W bits of count displays.
+//  ---------------------------------------------------------------------------
+static void hd44780Masks( struct hd44780 *hd44780[], uint8_t count,
+                          uint8_t *rs, uint8_t *rw )
+{
+    uint8_t i;
+
+    *rs = 0;
+    *rw = 0;
+    for ( i = 0; i < count; i++ )
+    {
+        *rs |= hd44780[i]->rs;
+        *rw |= hd44780[i]->rw;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Puts a byte on OLATB and pulses the E bits in en. olata is the current
+//  value of OLATA, which is updated.
+//  ---------------------------------------------------------------------------
+static int8_t hd44780Pulse( struct mcp23017 *mcp23017, uint8_t *olata,
+                            uint8_t rs, uint8_t rw, uint8_t en,
+                            uint8_t data, bool mode )
+{
+    uint8_t base;
+    int8_t  err = 0;
+
+    // RS must settle before E rises, so change it in a separate write.
+    base = ( *olata & ~( rs | rw | en )) | ( mode ? rs : 0 );
+    if ( base != *olata )
+        err |= mcp23017WriteByte( mcp23017, OLATA, base );
+
+    err |= mcp23017WriteByte( mcp23017, OLATB, data );
+    err |= mcp23017WriteByte( mcp23017, OLATA, base | en );
+    err |= mcp23017WriteByte( mcp23017, OLATA, base );
+    *olata = base;
+
+    return ( err < 0 ) ? -1 : 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes one round of bytes, one per active display, sharing a pulse
+//  between displays that need the same byte.
+//  ---------------------------------------------------------------------------
+static int8_t hd44780PulseRound( struct mcp23017 *mcp23017, uint8_t *olata,
+                                 uint8_t rs, uint8_t rw,
+                                 const uint8_t en[], const uint8_t data[],
+                                 const bool active[], uint8_t count,
+                                 bool mode )
+{
+    bool    done[TEXT_MULTI_MAX] = { false };
+    uint8_t i, j, mask;
+
+    for ( i = 0; i < count; i++ )
+    {
+        if (( !active[i] ) || ( done[i] )) continue;
+
+        mask = en[i];
+        for ( j = i + 1; j < count; j++ )
+        {
+            if (( active[j] ) && ( !done[j] ) && ( data[j] == data[i] ))
+            {
+                mask |= en[j];
+                done[j] = true;
+            }
+        }
+
+        if ( hd44780Pulse( mcp23017, olata, rs, rw, mask,
+                           data[i], mode ) < 0 ) return -1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes a command or data byte (according to mode) to count displays.
+//  ---------------------------------------------------------------------------
+int8_t hd44780WriteByteMulti( struct mcp23017 *mcp23017,
+                              struct hd44780 *hd44780[], uint8_t count,
+                              uint8_t data, bool mode )
+{
+    uint8_t olata, rs, rw, en = 0;
+    uint8_t i;
+
+    if (( count == 0 ) || ( count > HD44780_MAX )) return -1;
+
+    hd44780Masks( hd44780, count, &rs, &rw );
+    for ( i = 0; i < count; i++ ) en |= hd44780[i]->en;
+
+    olata = mcp23017ReadByte( mcp23017, OLATA );
+
+    return hd44780Pulse( mcp23017, &olata, rs, rw, en, data, mode );
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes text to its row and column on each of count displays.
+//  ---------------------------------------------------------------------------
+int8_t hd44780WriteTextMulti( struct text *text[], uint8_t count )
+{
+    struct mcp23017 *mcp23017;
+    struct hd44780  *hd44780[TEXT_MULTI_MAX];
+
+    uint8_t  rows[DISPLAY_ROWS_MAX] = { ADDRESS_ROW_0, ADDRESS_ROW_1,
+                                        ADDRESS_ROW_2, ADDRESS_ROW_3 };
+    uint8_t  phase[TEXT_MULTI_MAX];  // Order of text on the same display.
+    size_t   length[TEXT_MULTI_MAX]; // Text lengths.
+    uint8_t  en[TEXT_MULTI_MAX];     // E bit for each text.
+    uint8_t  data[TEXT_MULTI_MAX];   // Byte for each text this round.
+    bool     active[TEXT_MULTI_MAX]; // Text takes part in this round.
+    uint8_t  olata, rs, rw;
+    uint8_t  i, j, current, phases = 0;
+    size_t   pos, longest;
+    bool     more;
+
+    if (( count == 0 ) || ( count > TEXT_MULTI_MAX )) return -1;
+
+    mcp23017 = text[0]->mcp23017;
+    for ( i = 0; i < count; i++ )
+    {
+        if (( text[i]->mcp23017 != mcp23017 ) ||
+            ( text[i]->row > DISPLAY_ROWS - 1 ) ||
+            ( text[i]->col > DISPLAY_COLUMNS - 1 )) return -1;
+
+        hd44780[i] = text[i]->hd44780;
+        en[i]      = hd44780[i]->en;
+        length[i]  = strlen( text[i]->buffer );
+
+        // Text for the same display is written in separate phases since it
+        // shares the display's address counter.
+        phase[i] = 0;
+        for ( j = 0; j < i; j++ )
+            if ( hd44780[j] == hd44780[i] ) phase[i]++;
+        if ( phase[i] + 1 > phases ) phases = phase[i] + 1;
+    }
+
+    hd44780Masks( hd44780, count, &rs, &rw );
+    olata = mcp23017ReadByte( mcp23017, OLATA );
+
+    for ( current = 0; current < phases; current++ )
+    {
+        // Set DDRAM addresses.
+        longest = 0;
+        for ( i = 0; i < count; i++ )
+        {
+            active[i] = ( phase[i] == current );
+            data[i]   = ( ADDRESS_DDRAM | rows[text[i]->row] ) + text[i]->col;
+            if (( active[i] ) && ( length[i] > longest )) longest = length[i];
+        }
+        if ( hd44780PulseRound( mcp23017, &olata, rs, rw, en, data,
+                                active, count, MODE_COMMAND ) < 0 )
+            return -1;
+
+        // Write characters, one round per column.
+        for ( pos = 0; pos < longest; pos++ )
+        {
+            more = false;
+            for ( i = 0; i < count; i++ )
+            {
+                active[i] = ( phase[i] == current ) && ( pos < length[i] );
+                if ( active[i] ) data[i] = text[i]->buffer[pos];
+                more |= active[i];
+            }
+            if ( !more ) break;
+
+            if ( hd44780PulseRound( mcp23017, &olata, rs, rw, en, data,
+                                    active, count, MODE_DATA ) < 0 )
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Clears count displays.
+//  ---------------------------------------------------------------------------
+int8_t hd44780ClearMulti( struct mcp23017 *mcp23017,
+                          struct hd44780 *hd44780[], uint8_t count )
+{
+    if ( hd44780WriteByteMulti( mcp23017, hd44780, count,
+                                DISPLAY_CLEAR, MODE_COMMAND ) < 0 ) return -1;
+    usleep( 1600 ); // Data sheet doesn't give execution time!
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises count displays together.
+//  ---------------------------------------------------------------------------
+int8_t hd44780InitMulti( struct mcp23017 *mcp23017,
+                         struct hd44780 *hd44780[], uint8_t count,
+                         bool data,    bool lines,  bool font,
+                         bool display, bool cursor, bool blink,
+                         bool counter, bool shift,
+                         bool mode,    bool direction )
+{
+    if (( count == 0 ) || ( count > HD44780_MAX )) return -1;
+
+    // Allow a start-up delay.
+    usleep( 40000 );    // >40mS@3V.
+
+    // Function set (8 bit) three times. It's a command, so RS is low.
+    hd44780WriteByteMulti( mcp23017, hd44780, count, 0x30, MODE_COMMAND );
+    usleep( 4100 );     // >4.1mS.
+    hd44780WriteByteMulti( mcp23017, hd44780, count, 0x30, MODE_COMMAND );
+    usleep( 100 );      // >100uS.
+    hd44780WriteByteMulti( mcp23017, hd44780, count, 0x30, MODE_COMMAND );
+    usleep( 100 );      // >100uS.
+
+    // Set function mode.
+    hd44780WriteByteMulti( mcp23017, hd44780, count,
+                           FUNCTION_BASE | ( data  * FUNCTION_DATA  )
+                                         | ( lines * FUNCTION_LINES )
+                                         | ( font  * FUNCTION_FONT  ),
+                           MODE_COMMAND );
+
+    // Display off.
+    hd44780WriteByteMulti( mcp23017, hd44780, count,
+                           DISPLAY_BASE, MODE_COMMAND );
+
+    // Set entry mode.
+    hd44780WriteByteMulti( mcp23017, hd44780, count,
+                           ENTRY_BASE | ( counter * ENTRY_COUNTER )
+                                      | ( shift   * ENTRY_SHIFT   ),
+                           MODE_COMMAND );
+
+    // Set display properties.
+    hd44780WriteByteMulti( mcp23017, hd44780, count,
+                           DISPLAY_BASE | ( display * DISPLAY_ON     )
+                                        | ( cursor  * DISPLAY_CURSOR )
+                                        | ( blink   * DISPLAY_BLINK  ),
+                           MODE_COMMAND );
+
+    // Set initial display/cursor movement mode.
+    hd44780WriteByteMulti( mcp23017, hd44780, count,
+                           MOVE_BASE | ( mode      * MOVE_DISPLAY   )
+                                     | ( direction * MOVE_DIRECTION ),
+                           MODE_COMMAND );
+
+    // Goto start of DDRAM.
+    hd44780WriteByteMulti( mcp23017, hd44780, count,
+                           ADDRESS_DDRAM, MODE_COMMAND );
+
+    // Wipe any previous display.
+    return hd44780ClearMulti( mcp23017, hd44780, count );
+}
+
 //  Display init and mode functions. ------------------------------------------
 
 //  ---------------------------------------------------------------------------
@@ -331,6 +331,56 @@ int8_t hd44780WriteString( struct mcp23017 *mcp23017, struct hd44780 *hd44780,
 int8_t hd44780Goto( struct mcp23017 *mcp23017, struct hd44780 *hd44780,
                     uint8_t row, uint8_t pos );
 
+//  Multiple display functions. -----------------------------------------------
+/*
+    Displays on the same MCP23017 share RS, R/W and DB0-DB7 and differ only
+    in their E pin. A byte can therefore be written to any set of displays at
+    once by putting it on OLATB and pulsing the OR of their E bits.
+
+    The multiple display functions read OLATA once and then only write whole
+    bytes, so each write costs at most 4 I2C transactions instead of 8 reads
+    and writes plus 10mS of delays. Each I2C transaction takes longer than
+    the 37uS a display needs to execute a command or data write, so no
+    further delay is needed except after clear and home.
+
+    Writes of different text to different displays are interleaved a
+    character at a time so that one display executes while the next is being
+    written. Displays that need the same byte in the same round share a
+    pulse.
+*/
+
+//  ---------------------------------------------------------------------------
+//  Writes a command or data byte (according to mode) to count displays.
+//  ---------------------------------------------------------------------------
+int8_t hd44780WriteByteMulti( struct mcp23017 *mcp23017,
+                              struct hd44780 *hd44780[], uint8_t count,
+                              uint8_t data, bool mode );
+
+//  ---------------------------------------------------------------------------
+//  Writes text to its row and column on each of count displays.
+//  ---------------------------------------------------------------------------
+/*
+    All text structs must use the same MCP23017. Displays may appear more
+    than once, e.g. for text on different rows.
+*/
+int8_t hd44780WriteTextMulti( struct text *text[], uint8_t count );
+
+//  ---------------------------------------------------------------------------
+//  Clears count displays.
+//  ---------------------------------------------------------------------------
+int8_t hd44780ClearMulti( struct mcp23017 *mcp23017,
+                          struct hd44780 *hd44780[], uint8_t count );
+
+//  ---------------------------------------------------------------------------
+//  Initialises count displays together. See hd44780Init for parameters.
+//  ---------------------------------------------------------------------------
+int8_t hd44780InitMulti( struct mcp23017 *mcp23017,
+                         struct hd44780 *hd44780[], uint8_t count,
+                         bool data,    bool lines,  bool font,
+                         bool display, bool cursor, bool blink,
+                         bool counter, bool shift,
+                         bool mode,    bool direction );
+
 //  Display init and mode functions. ------------------------------------------
 
 //  ---------------------------------------------------------------------------
@@ -0,0 +1,817 @@
+/*
+//  ===========================================================================
+
+    hd44780task:
+
+    Cooperative task scheduler for animated HD44780 displays (I2C version).
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compile with:
+
+        gcc -c -fpic -Wall hd44780task.c hd44780i2c.c mcp23017.c -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v0.1    Original version.
+        v0.2    Added bus backends, cost accounting and governor.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include "hd44780i2c.h"
+#include "mcp23017.h"
+#include "hd44780task.h"
+
+#define TASK_TEXT_MAX ( HD44780_MAX * DISPLAY_ROWS ) // One run per row.
+
+
+//  Scheduler functions. ------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns monotonic time in microseconds.
+//  ---------------------------------------------------------------------------
+static uint64_t hd44780BusTimeReal( void *data )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sleeps until monotonic time until (uS).
+//  ---------------------------------------------------------------------------
+static void hd44780BusSleepReal( uint64_t until, void *data )
+{
+    struct timespec wake;
+
+    wake.tv_sec  = until / 1000000;
+    wake.tv_nsec = ( until % 1000000 ) * 1000;
+    clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL );
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes text to displays.
+//  ---------------------------------------------------------------------------
+static int8_t hd44780BusWriteReal( struct text *text[], uint8_t count,
+                                   void *data )
+{
+    return hd44780WriteTextMulti( text, count );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns virtual time.
+//  ---------------------------------------------------------------------------
+static uint64_t hd44780BusTimeSim( void *data )
+{
+    struct hd44780BusSim *sim = data;
+
+    return sim->now;
+}
+
+//  ---------------------------------------------------------------------------
+//  Moves virtual time forward to until.
+//  ---------------------------------------------------------------------------
+static void hd44780BusSleepSim( uint64_t until, void *data )
+{
+    struct hd44780BusSim *sim = data;
+
+    if ( until > sim->now ) sim->now = until;
+}
+
+//  ---------------------------------------------------------------------------
+//  Charges the I2C time for writing text to virtual time.
+//  ---------------------------------------------------------------------------
+static int8_t hd44780BusWriteSim( struct text *text[], uint8_t count,
+                                  void *data )
+{
+    struct hd44780BusSim *sim = data;
+    uint32_t pulses = 0;
+    uint8_t  i;
+
+    // One DDRAM address and one byte per character for each text.
+    for ( i = 0; i < count; i++ )
+        pulses += 1 + strlen( text[i]->buffer );
+
+    sim->pulses += pulses;
+    sim->now += (uint64_t)pulses * I2C_WRITES_PULSE * I2C_BITS_WRITE *
+                1000 / sim->khz;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills bus with the simulated backend.
+//  ---------------------------------------------------------------------------
+void hd44780BusSimInit( struct hd44780Bus *bus, struct hd44780BusSim *sim,
+                        uint32_t khz )
+{
+    sim->now    = 0;
+    sim->khz    = ( khz > 0 ) ? khz : 100;
+    sim->pulses = 0;
+
+    bus->write = hd44780BusWriteSim;
+    bus->time  = hd44780BusTimeSim;
+    bus->sleep = hd44780BusSleepSim;
+    bus->data  = sim;
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds a task to the heap.
+//  ---------------------------------------------------------------------------
+static void hd44780HeapPush( struct hd44780Scheduler *scheduler,
+                             struct hd44780Task *task )
+{
+    struct hd44780Task **heap = scheduler->heap;
+    uint8_t i, parent;
+
+    i = scheduler->tasks++;
+    while ( i > 0 )
+    {
+        parent = ( i - 1 ) / 2;
+        if ( heap[parent]->due <= task->due ) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = task;
+}
+
+//  ---------------------------------------------------------------------------
+//  Removes and returns the task that is due first.
+//  ---------------------------------------------------------------------------
+static struct hd44780Task *hd44780HeapPop( struct hd44780Scheduler *scheduler )
+{
+    struct hd44780Task **heap = scheduler->heap;
+    struct hd44780Task *first = heap[0];
+    struct hd44780Task *last;
+    uint8_t i = 0, child;
+
+    last = heap[--scheduler->tasks];
+    while (( child = 2 * i + 1 ) < scheduler->tasks )
+    {
+        if (( child + 1 < scheduler->tasks ) &&
+            ( heap[child + 1]->due < heap[child]->due )) child++;
+        if ( last->due <= heap[child]->due ) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+
+    return first;
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises an empty scheduler.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerInit( struct hd44780Scheduler *scheduler )
+{
+    uint8_t i;
+
+    memset( scheduler, 0, sizeof( struct hd44780Scheduler ));
+    scheduler->bus.write = hd44780BusWriteReal;
+    scheduler->bus.time  = hd44780BusTimeReal;
+    scheduler->bus.sleep = hd44780BusSleepReal;
+    scheduler->load      = HD44780_BUS_LOAD;
+    for ( i = 0; i < PRIORITY_LEVELS; i++ ) scheduler->cap[i] = 1000000;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets the bus backend.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerSetBus( struct hd44780Scheduler *scheduler,
+                             const struct hd44780Bus *bus )
+{
+    scheduler->bus = *bus;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns shadow RAM for a display, adding it if necessary.
+//  ---------------------------------------------------------------------------
+struct hd44780Shadow *hd44780ShadowGet( struct hd44780Scheduler *scheduler,
+                                        struct mcp23017 *mcp23017,
+                                        struct hd44780 *hd44780 )
+{
+    struct hd44780Shadow *shadow;
+    uint8_t i;
+
+    for ( i = 0; i < scheduler->shadows; i++ )
+        if (( scheduler->shadow[i].mcp23017 == mcp23017 ) &&
+            ( scheduler->shadow[i].hd44780 == hd44780 ))
+            return &scheduler->shadow[i];
+
+    if ( scheduler->shadows >= HD44780_MAX ) return NULL;
+
+    shadow = &scheduler->shadow[scheduler->shadows++];
+    shadow->mcp23017 = mcp23017;
+    shadow->hd44780  = hd44780;
+    memset( shadow->ram, ' ', sizeof( shadow->ram ));
+    memset( shadow->shown, ' ', sizeof( shadow->shown ));
+    memset( shadow->owner, 0, sizeof( shadow->owner ));
+    shadow->writer = NULL;
+
+    return shadow;
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes a single character into shadow RAM.
+//  ---------------------------------------------------------------------------
+void hd44780ShadowPut( struct hd44780Shadow *shadow, uint8_t row,
+                       uint8_t col, char c )
+{
+    if (( row > DISPLAY_ROWS - 1 ) || ( col > DISPLAY_COLUMNS - 1 )) return;
+
+    // Character 0 would end the text when flushed, so use its mirror.
+    if ( c == 0 ) c = CUSTOM_MIRROR;
+    shadow->ram[row][col]   = c;
+    shadow->owner[row][col] = shadow->writer;
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes text into shadow RAM at row, col. Text is clipped to the row.
+//  ---------------------------------------------------------------------------
+void hd44780ShadowWrite( struct hd44780Shadow *shadow, uint8_t row,
+                         uint8_t col, const char *text )
+{
+    if ( row > DISPLAY_ROWS - 1 ) return;
+
+    while (( *text != '\0' ) && ( col < DISPLAY_COLUMNS ))
+    {
+        shadow->owner[row][col] = shadow->writer;
+        shadow->ram[row][col++] = *text++;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds a task to run after delay uS.
+//  ---------------------------------------------------------------------------
+int8_t hd44780TaskAdd( struct hd44780Scheduler *scheduler,
+                       struct hd44780Task *task, hd44780TaskFunction run,
+                       void *data, struct mcp23017 *mcp23017,
+                       struct hd44780 *hd44780, uint8_t priority,
+                       uint32_t delay )
+{
+    if (( scheduler->tasks >= TASKS_MAX ) || ( run == NULL )) return -1;
+
+    memset( task, 0, sizeof( struct hd44780Task ));
+    task->shadow = hd44780ShadowGet( scheduler, mcp23017, hd44780 );
+    if ( task->shadow == NULL ) return -1;
+
+    task->run      = run;
+    task->data     = data;
+    task->priority = ( priority < PRIORITY_LEVELS ) ?
+                     priority : PRIORITY_LEVELS - 1;
+    task->delay    = delay;
+    task->due      = scheduler->bus.time( scheduler->bus.data ) + delay;
+    task->stats.fpsRequested = ( delay > 0 ) ? 1000000.0 / delay
+                                             : TASK_FPS_MAX;
+    task->stats.fpsAllowed   = task->stats.fpsRequested;
+    hd44780HeapPush( scheduler, task );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds pulses to the cost of the task that owns a cell.
+//  ---------------------------------------------------------------------------
+static void hd44780Charge( struct hd44780Task *task, uint32_t pulses,
+                           struct hd44780Task *charged[], uint8_t *count )
+{
+    if ( task == NULL ) return;
+    if ( task->pulses == 0 )
+    {
+        if ( *count >= TASKS_MAX ) return;
+        charged[( *count )++] = task;
+    }
+    task->pulses += pulses;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sends all changed cells of all displays.
+//  ---------------------------------------------------------------------------
+/*
+    Each row that has changed is sent as one run from its first to its last
+    changed cell. Runs for all displays on the same MCP23017 go in a single
+    bus write so that the displays are written together. The time taken by
+    each write is shared between the tasks that own the cells sent, in
+    proportion to the number of bytes each one needed.
+*/
+int8_t hd44780SchedulerFlush( struct hd44780Scheduler *scheduler )
+{
+    static char      buffer[TASK_TEXT_MAX][DISPLAY_COLUMNS + 1];
+    struct text      run[TASK_TEXT_MAX];
+    struct text      *text[TASK_TEXT_MAX];
+    struct hd44780Task *charged[TASKS_MAX];
+    struct hd44780Task *owner;
+    struct hd44780Shadow *shadow;
+    struct hd44780Bus *bus = &scheduler->bus;
+    struct mcp23017  *mcp23017;
+    bool             done[HD44780_MAX] = { false };
+    uint8_t          i, j, row, col, first, last, count, tasks;
+    uint32_t         pulses;
+    uint64_t         start, elapsed, share;
+    int8_t           err = 0;
+
+    pthread_mutex_lock( &displayBusy );
+
+    for ( i = 0; i < scheduler->shadows; i++ )
+    {
+        if ( done[i] ) continue;
+        mcp23017 = scheduler->shadow[i].mcp23017;
+
+        // Collect changed runs from every display on this MCP23017.
+        count  = 0;
+        tasks  = 0;
+        pulses = 0;
+        for ( j = i; j < scheduler->shadows; j++ )
+        {
+            shadow = &scheduler->shadow[j];
+            if ( shadow->mcp23017 != mcp23017 ) continue;
+            done[j] = true;
+
+            for ( row = 0; row < DISPLAY_ROWS; row++ )
+            {
+                for ( first = 0; first < DISPLAY_COLUMNS; first++ )
+                    if ( shadow->ram[row][first] != shadow->shown[row][first] )
+                        break;
+                if ( first == DISPLAY_COLUMNS ) continue;
+                for ( last = DISPLAY_COLUMNS - 1; last > first; last-- )
+                    if ( shadow->ram[row][last] != shadow->shown[row][last] )
+                        break;
+
+                memcpy( buffer[count], &shadow->ram[row][first],
+                        last - first + 1 );
+                buffer[count][last - first + 1] = '\0';
+                memcpy( &shadow->shown[row][first], &shadow->ram[row][first],
+                        last - first + 1 );
+
+                // The address goes to the owner of the first cell.
+                hd44780Charge( shadow->owner[row][first], 1,
+                               charged, &tasks );
+                for ( col = first; col <= last; col++ )
+                {
+                    owner = shadow->owner[row][col];
+                    hd44780Charge( owner, 1, charged, &tasks );
+                    if ( owner != NULL ) owner->stats.bytes++;
+                }
+                pulses += last - first + 2;
+
+                run[count].mcp23017 = mcp23017;
+                run[count].hd44780  = shadow->hd44780;
+                run[count].row      = row;
+                run[count].col      = first;
+                run[count].buffer   = buffer[count];
+                text[count] = &run[count];
+                scheduler->bytes += last - first + 1;
+                count++;
+            }
+        }
+
+        if ( count == 0 ) continue;
+
+        start = bus->time( bus->data );
+        err |= bus->write( text, count, bus->data );
+        elapsed = bus->time( bus->data ) - start;
+
+        scheduler->flushes++;
+        scheduler->busTime += elapsed;
+        scheduler->windowBusTime += elapsed;
+        for ( j = 0; j < tasks; j++ )
+        {
+            share = elapsed * charged[j]->pulses / pulses;
+            charged[j]->windowBusTime += share;
+            charged[j]->stats.busTime += share;
+            charged[j]->pulses = 0;
+        }
+    }
+
+    pthread_mutex_unlock( &displayBusy );
+
+    return ( err < 0 ) ? -1 : 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Shares bus time between tasks.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerGovern( struct hd44780Scheduler *scheduler,
+                             uint64_t now )
+{
+    struct hd44780Task *task;
+    uint64_t elapsed = now - scheduler->window;
+    float    decay = 1 - 1.0 / GOVERNOR_SMOOTH;
+    float    total, budget, demand, scale, fps, allowed, change, lost, lower, cap;
+    uint8_t  i, priority;
+    bool     full;
+
+    if ( elapsed == 0 ) return;
+
+    scheduler->busLoad = 100.0 * scheduler->windowBusTime / elapsed;
+    scheduler->avgTime = scheduler->avgTime * decay + elapsed;
+
+    // Measure each task, averaged over the last few periods.
+    for ( i = 0; i < scheduler->tasks; i++ )
+    {
+        task = scheduler->heap[i];
+        task->avgRuns    = task->avgRuns * decay + task->windowRuns;
+        task->avgBusTime = task->avgBusTime * decay + task->windowBusTime;
+        if ( task->avgRuns > 0 )
+            task->stats.cost = task->avgBusTime / task->avgRuns;
+        task->stats.fpsAchieved  = task->avgRuns * 1000000.0 /
+                                   scheduler->avgTime;
+        task->stats.fpsRequested = ( task->delay > 0 ) ?
+                                   1000000.0 / task->delay : TASK_FPS_MAX;
+    }
+
+    // Hand out bus time per second, highest priority first.
+    total  = 1000000.0 * scheduler->load / 100;
+    budget = total;
+    for ( priority = 0; priority < PRIORITY_LEVELS; priority++ )
+    {
+        demand = 0;
+        for ( i = 0; i < scheduler->tasks; i++ )
+        {
+            task = scheduler->heap[i];
+            if ( task->priority == priority )
+                demand += task->stats.cost * task->stats.fpsRequested;
+        }
+        scale = ( demand <= budget ) ? 1 : budget / demand;
+
+        for ( i = 0; i < scheduler->tasks; i++ )
+        {
+            task = scheduler->heap[i];
+            if ( task->priority != priority ) continue;
+
+            fps = task->stats.fpsRequested;
+            if ( task->stats.cost > 0 )
+            {
+                fps *= scale;
+                if ( fps < TASK_FPS_MIN ) fps = TASK_FPS_MIN;
+                if ( fps > task->stats.fpsRequested )
+                    fps = task->stats.fpsRequested;
+
+                // Small changes are noise, so keep the rate unless it
+                // moves by more than GOVERNOR_MARGIN of the bus and, if the
+                // bus has room for this priority, GOVERNOR_HYSTERESIS of
+                // itself. The task gets its full rate if there is room to
+                // spare.
+                allowed = task->stats.fpsAllowed;
+                if ( allowed > task->stats.fpsRequested )
+                    allowed = task->stats.fpsRequested;
+                full    = ( fps >= task->stats.fpsRequested ) &&
+                          ( demand * ( 100 + GOVERNOR_HYSTERESIS ) <=
+                            budget * 100 );
+                change  = ( fps > allowed ) ? fps - allowed : allowed - fps;
+                if ( !full &&
+                     ((( scale >= 1 ) &&
+                       ( change <= allowed * GOVERNOR_HYSTERESIS / 100 )) ||
+                      ( change * task->stats.cost <=
+                        total * GOVERNOR_MARGIN / 100 )))
+                    fps = allowed;
+                budget -= task->stats.cost * fps;
+            }
+            task->stats.fpsAllowed = fps;
+            task->period = ( fps < task->stats.fpsRequested ) ?
+                           1000000.0 / fps : 0;
+        }
+        // Time kept back by hysteresis belongs to tasks that were cut.
+        if (( budget < 0 ) || ( scale < 1 )) budget = 0;
+
+        // A long flush for a lower priority task can make these tasks late
+        // even though the bus has room. If they have lost more than
+        // GOVERNOR_SLACK of their runs, cap the bus time left for lower
+        // priorities in proportion, aiming for half the slack. The cap is
+        // only relaxed once they lose less than a quarter of the slack.
+        allowed = lost = lower = 0;
+        for ( i = 0; i < scheduler->tasks; i++ )
+        {
+            task = scheduler->heap[i];
+            if ( task->priority == priority )
+            {
+                allowed += task->stats.fpsAllowed;
+                if ( task->stats.fpsAchieved < task->stats.fpsAllowed )
+                    lost += task->stats.fpsAllowed - task->stats.fpsAchieved;
+            }
+            else if ( task->priority > priority )
+                lower += task->stats.cost * task->stats.fpsAchieved;
+        }
+
+        if ( scheduler->hold[priority] > 0 ) scheduler->hold[priority]--;
+        else if (( lost * 100 > allowed * GOVERNOR_SLACK ) && ( lower > 0 ))
+        {
+            cap = lower * allowed * GOVERNOR_SLACK / 200 / lost;
+            if ( cap < scheduler->cap[priority] )
+                scheduler->cap[priority] = cap;
+            scheduler->hold[priority] = GOVERNOR_SMOOTH;
+        }
+        else if ( lost * 400 < allowed * GOVERNOR_SLACK )
+        {
+            scheduler->cap[priority] *= 1 + GOVERNOR_RELAX / 100.0;
+            if ( scheduler->cap[priority] > 1000000 )
+                scheduler->cap[priority] = 1000000;
+        }
+        if ( budget > scheduler->cap[priority] )
+            budget = scheduler->cap[priority];
+    }
+
+    // Start a new period.
+    for ( i = 0; i < scheduler->tasks; i++ )
+    {
+        scheduler->heap[i]->windowRuns    = 0;
+        scheduler->heap[i]->windowBusTime = 0;
+    }
+    scheduler->window        = now;
+    scheduler->windowBusTime = 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs tasks until all have finished, kill is set or duration has passed.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerRun( struct hd44780Scheduler *scheduler,
+                          uint64_t duration )
+{
+    struct hd44780Bus  *bus = &scheduler->bus;
+    struct hd44780Task *task;
+    uint64_t           start, end, now, period, wake;
+    int8_t             result;
+
+    start = bus->time( bus->data );
+    end   = start + duration;
+    scheduler->window = start;
+
+    while (( !scheduler->kill ) && ( scheduler->tasks > 0 ))
+    {
+        now = bus->time( bus->data );
+        if (( duration > 0 ) && ( now >= end )) break;
+
+        // Run everything that is due, then flush once.
+        if ( scheduler->heap[0]->due <= now )
+        {
+            while (( scheduler->tasks > 0 ) &&
+                   ( scheduler->heap[0]->due <= now ))
+            {
+                task = hd44780HeapPop( scheduler );
+
+                task->shadow->writer = task;
+                result = task->run( task );
+                task->shadow->writer = NULL;
+                task->stats.runs++;
+                task->windowRuns++;
+                if ( result != TASK_WAITING ) continue;
+
+                // Keep to the task's own timebase unless it has fallen
+                // behind, in which case don't try to catch up. The governor
+                // may have stretched the period.
+                period = ( task->delay > task->period ) ?
+                         task->delay : task->period;
+                task->due += period;
+                if ( task->due <= now )
+                    task->due = now + (( period > 0 ) ? period : 1 );
+                hd44780HeapPush( scheduler, task );
+            }
+            scheduler->ticks++;
+            hd44780SchedulerFlush( scheduler );
+        }
+
+        now = bus->time( bus->data );
+        if ( now - scheduler->window >= GOVERNOR_PERIOD )
+            hd44780SchedulerGovern( scheduler, now );
+
+        // Sleep until the next task is due.
+        if ( scheduler->tasks > 0 )
+        {
+            wake = scheduler->heap[0]->due;
+            if (( duration > 0 ) && ( wake > end )) wake = end;
+            bus->sleep( wake, bus->data );
+        }
+    }
+}
+
+
+//  Tasks. --------------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Displays text on display row as a tickertape.
+//  ---------------------------------------------------------------------------
+/*
+    count[0] is the offset of the first displayed character.
+*/
+int8_t hd44780TaskTicker( struct hd44780Task *task )
+{
+    struct ticker *ticker = task->data;
+    char   buffer[DISPLAY_COLUMNS + 1];
+    size_t i;
+
+    TASK_BEGIN( task );
+
+    if (( ticker->length == 0 ) ||
+        ( ticker->length + ticker->padding >= TEXT_MAX_LENGTH ))
+        return TASK_DONE;
+
+    // Add some padding so rotated text looks better.
+    for ( i = ticker->length; i < ticker->length + ticker->padding; i++ )
+        ticker->text[i] = ' ';
+    ticker->text[i] = '\0';
+    ticker->length = strlen( ticker->text );
+    task->count[0] = 0;
+
+    while ( 1 )
+    {
+        for ( i = 0; i < DISPLAY_COLUMNS; i++ )
+            buffer[i] = ticker->text[( task->count[0] + i ) % ticker->length];
+        buffer[i] = '\0';
+        hd44780ShadowWrite( task->shadow, ticker->row, 0, buffer );
+
+        // Rotate by increment in either direction.
+        task->count[0] = ( task->count[0] + ticker->increment ) %
+                         (int32_t)ticker->length;
+        if ( task->count[0] < 0 ) task->count[0] += ticker->length;
+
+        TASK_YIELD( task, ticker->delay.tv_sec * 1000000 +
+                          ticker->delay.tv_usec );
+    }
+
+    TASK_END( task );
+}
+
+//  ---------------------------------------------------------------------------
+//  Displays formatted date/time strings.
+//  ---------------------------------------------------------------------------
+/*
+    count[0] is the animation frame.
+*/
+int8_t hd44780TaskCalendar( struct hd44780Task *task )
+{
+    struct calendar *calendar = task->data;
+    struct tm *timePtr;
+    time_t timeVar;
+    char   buffer[DISPLAY_COLUMNS + 1];
+
+    TASK_BEGIN( task );
+
+    task->count[0] = 0;
+
+    while ( 1 )
+    {
+        // Cycle through frames.
+        if ( task->count[0] >= calendar->frames ) task->count[0] = 0;
+
+        timeVar = time( NULL );
+        timePtr = localtime( &timeVar );
+        buffer[0] = '\0';
+        strftime( buffer, ( calendar->length < sizeof( buffer )) ?
+                          calendar->length : sizeof( buffer ),
+                  calendar->format[task->count[0]], timePtr );
+        task->count[0]++;
+
+        hd44780ShadowWrite( task->shadow, calendar->row, calendar->col,
+                            buffer );
+
+        TASK_YIELD( task, calendar->delay.tv_sec * 1000000 +
+                          calendar->delay.tv_usec );
+    }
+
+    TASK_END( task );
+}
+
+//  ---------------------------------------------------------------------------
+//  Displays a level as a bar of full blocks.
+//  ---------------------------------------------------------------------------
+int8_t hd44780TaskBar( struct hd44780Task *task )
+{
+    struct bar *bar = task->data;
+    char    buffer[DISPLAY_COLUMNS + 1];
+    uint8_t i, width, blocks;
+
+    TASK_BEGIN( task );
+
+    while ( 1 )
+    {
+        width = ( bar->col + bar->width > DISPLAY_COLUMNS ) ?
+                DISPLAY_COLUMNS - bar->col : bar->width;
+        blocks = ( bar->level( bar->data ) * width + 50 ) / 100;
+        if ( blocks > width ) blocks = width;
+
+        // 0xff is a full block in the HD44780 character ROM.
+        for ( i = 0; i < width; i++ )
+            buffer[i] = ( i < blocks ) ? 0xff : ' ';
+        buffer[i] = '\0';
+        hd44780ShadowWrite( task->shadow, bar->row, bar->col, buffer );
+
+        TASK_YIELD( task, bar->delay.tv_sec * 1000000 +
+                          bar->delay.tv_usec );
+    }
+
+    TASK_END( task );
+}
+
+//  ---------------------------------------------------------------------------
+//  Pac-Man chased along a row by ghosts.
+//  ---------------------------------------------------------------------------
+/*
+    PacMan 1        PacMan 2        Ghost 1         Ghost 2
+    00000 = 0x00,   00000 = 0x00,   00000 = 0x00,   00000 = 0x00
+    00000 = 0x00,   00000 = 0x00,   01110 = 0x0e,   01110 = 0x0e
+    01110 = 0x0e,   01111 = 0x0f,   11001 = 0x19,   11001 = 0x13
+    11011 = 0x1b,   10110 = 0x16,   11101 = 0x1d,   11011 = 0x17
+    11111 = 0x1f,   11100 = 0x1c,   11111 = 0x1f,   11111 = 0x1f
+    11111 = 0x1f,   11110 = 0x1e,   11111 = 0x1f,   11111 = 0x1f
+    01110 = 0x0e,   01111 = 0x0f,   10101 = 0x15,   01010 = 0x1b
+    00000 = 0x00,   00000 = 0x00,   00000 = 0x00,   00000 = 0x00
+
+    Heart 1         Heart 2         Pac Man 3
+    00000 = 0x00,   00000 = 0x00,   00000 = 0x00
+    01010 = 0x0a,   00000 = 0x00,   00000 = 0x00
+    11111 = 0x1f,   01010 = 0x0a,   11110 = 0x1e
+    11111 = 0x1f,   01110 = 0x0e,   01101 = 0x0d
+    11111 = 0x1f,   01110 = 0x0e,   00111 = 0x07
+    01110 = 0x0e,   00100 = 0x04,   01111 = 0x0f
+    00100 = 0x04,   00000 = 0x00,   11110 = 0x1e
+    00000 = 0x00,   00000 = 0x00,   00000 = 0x00
+
+    count[0] is Pac-Man's column, count[1] the animation frame.
+*/
+static const uint8_t pacManChars[CUSTOM_MAX][CUSTOM_SIZE] =
+{
+    { 0x00, 0x00, 0x0e, 0x1b, 0x1f, 0x1f, 0x0e, 0x00 },
+    { 0x00, 0x00, 0x0f, 0x16, 0x1c, 0x1e, 0x0f, 0x00 },
+    { 0x00, 0x0e, 0x19, 0x1d, 0x1f, 0x1f, 0x15, 0x00 },
+    { 0x00, 0x0e, 0x13, 0x17, 0x1f, 0x1f, 0x1b, 0x00 },
+    { 0x00, 0x0a, 0x1f, 0x1f, 0x1f, 0x0e, 0x04, 0x00 },
+    { 0x00, 0x00, 0x0a, 0x0e, 0x0e, 0x04, 0x00, 0x00 },
+    { 0x00, 0x00, 0x1e, 0x0d, 0x07, 0x0f, 0x1e, 0x00 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }
+};
+
+int8_t hd44780TaskPacMan( struct hd44780Task *task )
+{
+    struct pacMan *pacMan = task->data;
+    const char pacManRight[2] = { CUSTOM_MIRROR + 1, CUSTOM_MIRROR + 0 };
+    const char ghost[2]       = { CUSTOM_MIRROR + 2, CUSTOM_MIRROR + 3 };
+    int8_t i;
+
+    TASK_BEGIN( task );
+
+    // CGRAM is not shadowed, so load it directly.
+    pthread_mutex_lock( &displayBusy );
+    hd44780LoadCustom( pacMan->mcp23017, pacMan->hd44780, pacManChars );
+    pthread_mutex_unlock( &displayBusy );
+
+    while ( 1 )
+    {
+        for ( task->count[0] = 0; task->count[0] < DISPLAY_COLUMNS;
+              task->count[0]++ )
+        {
+            for ( task->count[1] = 0; task->count[1] < 2; task->count[1]++ )
+            {
+                hd44780ShadowWrite( task->shadow, pacMan->row, 0,
+                                    "                " );
+                hd44780ShadowPut( task->shadow, pacMan->row, task->count[0],
+                                  pacManRight[task->count[1]] );
+                for ( i = task->count[0] - 2; i > task->count[0] - 6; i-- )
+                    if ( i > 0 )
+                        hd44780ShadowPut( task->shadow, pacMan->row, i,
+                                          ghost[task->count[1]] );
+
+                TASK_YIELD( task, pacMan->delay.tv_sec * 1000000 +
+                                  pacMan->delay.tv_usec );
+            }
+        }
+    }
+
+    TASK_END( task );
+}
@@ -0,0 +1,380 @@
+/*
+//  ===========================================================================
+
+    hd44780task:
+
+    Cooperative task scheduler for animated HD44780 displays (I2C version).
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compile with:
+
+        gcc -c -fpic -Wall hd44780task.c hd44780i2c.c mcp23017.c -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Contributors:
+
+//  Information. --------------------------------------------------------------
+
+    displayTicker and displayCalendar each need a thread, which sleeps on its
+    own and takes displayBusy for every write. With several widgets on
+    several displays the threads wake at different times and the bus is
+    locked and unlocked once per widget per frame.
+
+    The scheduler runs all widgets as tasks in a single thread. A task is a
+    function that draws into a shadow copy of display RAM and then yields
+    with the delay until it next wants to run. Tasks are kept in a heap
+    ordered by the time they are due. On each tick, every task that is due
+    is run and then all the cells that have changed are sent in a single
+    flush, holding displayBusy once:
+
+        tick:  run due tasks --> shadow RAM --> compare with display
+                                                    |
+                                    hd44780WriteTextMulti (one per MCP23017)
+
+    Tasks are written in the style of protothreads. Local variables do not
+    survive a yield, so anything a task needs to keep goes in its task
+    struct or its data:
+
+        int8_t myTask( struct hd44780Task *task )
+        {
+            TASK_BEGIN( task );
+            while ( 1 )
+            {
+                ...draw...
+                TASK_YIELD( task, 500000 ); // Run again in 0.5s.
+            }
+            TASK_END( task );
+        }
+
+    Custom characters 0-7 are mirrored at 8-15 in the HD44780 character
+    table. Shadow RAM is written as text, so use 8-15 for custom characters.
+
+    The ticker, calendar and Pac-Man threads are provided as tasks, along
+    with hd44780TaskBar for level meters. meterPi's testmeterPi-lcd runs
+    its peak meter as a task in the same way.
+
+//  Governor. -----------------------------------------------------------------
+
+    An HD44780 on an MCP23017 at 100kHz takes roughly 1mS per character, so
+    a meter, a clock and a ticker can easily ask for more than the bus can
+    carry. Updates then queue up behind each other and arrive late and
+    unevenly.
+
+    Each shadow cell remembers the task that last wrote it, so each flush
+    can charge its bytes and bus time to the tasks whose cells were sent.
+    Once every GOVERNOR_PERIOD the governor works out each task's cost per
+    run, averaged over about GOVERNOR_SMOOTH periods, and shares
+    HD44780_BUS_LOAD percent of the bus between tasks in priority order:
+
+        budget = bus time per second * HD44780_BUS_LOAD / 100
+        for each priority, highest first:
+            demand = sum of ( cost per run * requested fps )
+            demand <= budget: fps = requested fps
+            otherwise:        fps = requested fps * budget / demand
+            budget -= bus time used at those rates
+
+    Tasks that are cut back have their period stretched, so their yields
+    take longer to come round again. Tasks that use no bus time are never
+    limited. A task's allowed rate is only changed when the new rate
+    differs by more than GOVERNOR_HYSTERESIS percent and the bus time it
+    would save or use is more than GOVERNOR_MARGIN percent of the load, so
+    noise in the costs doesn't make it swing from period to period.
+
+    A flush can't be interrupted, so a lower priority task whose cells take
+    longer to send than a meter's period makes the meter late even when
+    the bus has room. If tasks of one priority lose more than
+    GOVERNOR_SLACK percent of their runs, the bus time left for lower
+    priorities is capped in proportion to the runs lost. The cap is held
+    for GOVERNOR_SMOOTH periods to see its effect, and then relaxes by
+    GOVERNOR_RELAX percent per period once the higher tasks lose less than
+    a quarter of GOVERNOR_SLACK.
+
+    Requested, allowed and achieved fps are kept in each task's stats.
+
+    The bus is reached through a struct hd44780Bus, which also supplies the
+    time and sleep functions. hd44780BusSimInit gives a simulated bus that
+    charges the I2C time a flush would take to a virtual clock, so the
+    governor can be tested without hardware and without waiting.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#ifndef HD44780TASK_H
+#define HD44780TASK_H
+
+//  Macros. -------------------------------------------------------------------
+
+#define TASKS_MAX     16 // Maximum number of tasks per scheduler.
+#define TASK_WAITING   0 // Task has yielded.
+#define TASK_DONE      1 // Task has finished.
+#define CUSTOM_MIRROR  8 // Offset of mirrored custom characters.
+
+#define GOVERNOR_PERIOD 1000000 // Governor update interval (uS).
+#define HD44780_BUS_LOAD     80 // Target bus utilisation (%).
+#define GOVERNOR_SMOOTH       4 // Periods that costs are averaged over.
+#define GOVERNOR_HYSTERESIS  20 // Change in a task's rate ignored (%).
+#define GOVERNOR_MARGIN       2 // Change in bus time ignored (% of load).
+#define GOVERNOR_SLACK       10 // Runs a priority may lose to others (%).
+#define GOVERNOR_RELAX        2 // Growth of the lower priority cap (%).
+#define TASK_FPS_MIN          1 // Lowest rate the governor will set.
+#define TASK_FPS_MAX        100 // Rate assumed for tasks yielding with 0.
+
+#define I2C_BITS_WRITE       29 // Bits in an MCP23017 register write.
+#define I2C_WRITES_PULSE      3 // Register writes per HD44780 byte.
+
+enum hd44780Priority
+{
+    PRIORITY_HIGH = 0, // e.g. meters.
+    PRIORITY_NORMAL,   // e.g. clocks.
+    PRIORITY_LOW,      // e.g. tickers.
+    PRIORITY_LEVELS
+};
+
+#define TASK_BEGIN( task ) switch (( task )->line ) { case 0:
+
+#define TASK_YIELD( task, us )                                                \
+    do {                                                                      \
+        ( task )->line  = __LINE__;                                           \
+        ( task )->delay = ( us );                                             \
+        return TASK_WAITING;                                                  \
+        case __LINE__:;                                                       \
+    } while ( 0 )
+
+#define TASK_END( task ) } ( task )->line = 0; return TASK_DONE;
+
+
+//  Data structures. ----------------------------------------------------------
+
+struct hd44780Task;
+typedef int8_t ( *hd44780TaskFunction )( struct hd44780Task *task );
+
+struct hd44780Bus
+{
+    int8_t   ( *write )( struct text *text[], uint8_t count, void *data );
+    uint64_t ( *time )( void *data );                  // Monotonic time (uS).
+    void     ( *sleep )( uint64_t until, void *data ); // Sleep until time.
+    void     *data;                                    // Backend data.
+};
+
+struct hd44780BusSim
+{
+    uint64_t now;       // Virtual time (uS).
+    uint32_t khz;       // I2C clock (kHz).
+    uint32_t pulses;    // HD44780 bytes written.
+};
+
+struct hd44780Shadow
+{
+    struct  mcp23017 *mcp23017;                  // MCP23017 instance.
+    struct  hd44780  *hd44780;                   // HD44780 instance.
+    char    ram[DISPLAY_ROWS][DISPLAY_COLUMNS];  // Wanted display contents.
+    char    shown[DISPLAY_ROWS][DISPLAY_COLUMNS];// Actual display contents.
+    struct  hd44780Task *owner[DISPLAY_ROWS][DISPLAY_COLUMNS]; // Last writer.
+    struct  hd44780Task *writer;                 // Task now running.
+};
+
+struct hd44780TaskStats
+{
+    uint32_t runs;          // Times run.
+    uint32_t bytes;         // Characters sent.
+    uint64_t busTime;       // Bus time used (uS).
+    uint32_t cost;          // Average bus time per run (uS).
+    float    fpsRequested;  // Rate asked for by the task's yields.
+    float    fpsAllowed;    // Rate allowed by the governor.
+    float    fpsAchieved;   // Rate achieved over the last few periods.
+};
+
+struct hd44780Task
+{
+    hd44780TaskFunction  run;    // Task function.
+    void                 *data;  // Task parameters.
+    struct hd44780Shadow *shadow;// Shadow RAM for the task's display.
+    uint8_t              priority; // enum hd44780Priority.
+    uint16_t             line;   // Resume point.
+    uint32_t             delay;  // Delay requested by last yield (uS).
+    uint32_t             period; // Minimum period set by governor (uS).
+    uint64_t             due;    // Next run time (uS).
+    int32_t              count[2]; // Saved counters for the task.
+    uint32_t             pulses; // Bytes charged in current flush.
+    uint32_t             windowRuns;    // Runs this governor period.
+    uint64_t             windowBusTime; // Bus time this governor period.
+    float                avgRuns;       // Runs, decaying average.
+    float                avgBusTime;    // Bus time, decaying average.
+    struct hd44780TaskStats stats;      // Statistics.
+};
+
+struct hd44780Scheduler
+{
+    struct hd44780Task   *heap[TASKS_MAX];     // Tasks ordered by due time.
+    uint8_t              tasks;                // Number of tasks.
+    struct hd44780Shadow shadow[HD44780_MAX];  // Shadow RAM per display.
+    uint8_t              shadows;              // Number of displays.
+    struct hd44780Bus    bus;                  // Bus backend.
+    uint32_t             ticks;                // Ticks that ran tasks.
+    uint32_t             flushes;              // Ticks that wrote to the bus.
+    uint32_t             bytes;                // Characters written.
+    uint64_t             busTime;              // Total bus time (uS).
+    uint64_t             window;               // Start of governor period.
+    uint64_t             windowBusTime;        // Bus time this period.
+    float                avgTime;              // Period, decaying average.
+    float                cap[PRIORITY_LEVELS]; // Bus time per second left
+                                               // below each priority (uS).
+    uint8_t              hold[PRIORITY_LEVELS];// Periods to keep the cap.
+    float                busLoad;              // Bus load last period (%).
+    uint8_t              load;                 // Target bus load (%).
+    volatile bool        kill;                 // Stops the scheduler.
+};
+
+struct bar
+{
+    struct  mcp23017 *mcp23017; // MCP23017 instance.
+    struct  hd44780  *hd44780;  // HD44780 instance.
+    struct  timeval  delay;     // Delay between updates.
+    uint8_t row;                // Display row.
+    uint8_t col;                // Display column.
+    uint8_t width;              // Bar width (characters).
+    uint8_t ( *level )( void *data ); // Returns level, 0-100 (%).
+    void    *data;              // Passed to level.
+};
+
+struct pacMan
+{
+    struct  mcp23017 *mcp23017; // MCP23017 instance.
+    struct  hd44780  *hd44780;  // HD44780 instance.
+    struct  timeval  delay;     // Delay between frames.
+    uint8_t row;                // Display row.
+};
+
+
+//  Scheduler functions. ------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises an empty scheduler using the real bus.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerInit( struct hd44780Scheduler *scheduler );
+
+//  ---------------------------------------------------------------------------
+//  Sets the bus backend. Call before adding tasks.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerSetBus( struct hd44780Scheduler *scheduler,
+                             const struct hd44780Bus *bus );
+
+//  ---------------------------------------------------------------------------
+//  Fills bus with the simulated backend, using sim for its state.
+//  ---------------------------------------------------------------------------
+/*
+    Each HD44780 byte costs I2C_WRITES_PULSE register writes of
+    I2C_BITS_WRITE bits at khz. Sleeping moves the virtual clock forward.
+*/
+void hd44780BusSimInit( struct hd44780Bus *bus, struct hd44780BusSim *sim,
+                        uint32_t khz );
+
+//  ---------------------------------------------------------------------------
+//  Returns shadow RAM for a display, adding it if necessary.
+//  ---------------------------------------------------------------------------
+/*
+    Shadow RAM starts as all spaces, i.e. it assumes that the display has
+    just been cleared. Returns NULL if there are already HD44780_MAX
+    displays.
+*/
+struct hd44780Shadow *hd44780ShadowGet( struct hd44780Scheduler *scheduler,
+                                        struct mcp23017 *mcp23017,
+                                        struct hd44780 *hd44780 );
+
+//  ---------------------------------------------------------------------------
+//  Writes text into shadow RAM at row, col. Text is clipped to the row.
+//  ---------------------------------------------------------------------------
+void hd44780ShadowWrite( struct hd44780Shadow *shadow, uint8_t row,
+                         uint8_t col, const char *text );
+
+//  ---------------------------------------------------------------------------
+//  Writes a single character into shadow RAM.
+//  ---------------------------------------------------------------------------
+void hd44780ShadowPut( struct hd44780Shadow *shadow, uint8_t row,
+                       uint8_t col, char c );
+
+//  ---------------------------------------------------------------------------
+//  Adds a task to run after delay uS. Returns 0, or -1 if full or invalid.
+//  ---------------------------------------------------------------------------
+/*
+    task must stay in scope while the scheduler runs. data is passed to the
+    task function and, for the tasks below, is the widget's parameters. The
+    task's shadow is taken from the mcp23017 and hd44780 given. priority is
+    an enum hd44780Priority.
+*/
+int8_t hd44780TaskAdd( struct hd44780Scheduler *scheduler,
+                       struct hd44780Task *task, hd44780TaskFunction run,
+                       void *data, struct mcp23017 *mcp23017,
+                       struct hd44780 *hd44780, uint8_t priority,
+                       uint32_t delay );
+
+//  ---------------------------------------------------------------------------
+//  Sends all changed cells of all displays. Returns 0 or -1 on bus error.
+//  ---------------------------------------------------------------------------
+int8_t hd44780SchedulerFlush( struct hd44780Scheduler *scheduler );
+
+//  ---------------------------------------------------------------------------
+//  Shares bus time between tasks. Called by hd44780SchedulerRun.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerGovern( struct hd44780Scheduler *scheduler,
+                             uint64_t now );
+
+//  ---------------------------------------------------------------------------
+//  Runs tasks until all have finished, kill is set or duration (uS) has
+//  passed. A duration of 0 runs forever.
+//  ---------------------------------------------------------------------------
+void hd44780SchedulerRun( struct hd44780Scheduler *scheduler,
+                          uint64_t duration );
+
+
+//  Tasks. --------------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Displays text on display row as a tickertape. data is a struct ticker.
+//  ---------------------------------------------------------------------------
+int8_t hd44780TaskTicker( struct hd44780Task *task );
+
+//  ---------------------------------------------------------------------------
+//  Displays formatted date/time strings. data is a struct calendar.
+//  ---------------------------------------------------------------------------
+int8_t hd44780TaskCalendar( struct hd44780Task *task );
+
+//  ---------------------------------------------------------------------------
+//  Displays a level as a bar of full blocks. data is a struct bar.
+//  ---------------------------------------------------------------------------
+int8_t hd44780TaskBar( struct hd44780Task *task );
+
+//  ---------------------------------------------------------------------------
+//  Pac-Man chased along a row by ghosts. data is a struct pacMan.
+//  ---------------------------------------------------------------------------
+/*
+    Loads its own custom characters, so don't use with other custom
+    characters on the same display.
+*/
+int8_t hd44780TaskPacMan( struct hd44780Task *task );
+
+#endif
@@ -23,15 +23,15 @@
 //  ===========================================================================
 */
 
-#define Version "Version 0.1"
+#define Version "Version 0.2"
 
 /*
 //  ---------------------------------------------------------------------------
 
     Compile with:
 
-    gcc testhd44780i2c.c hd44780i2c.c mcp23017.c -Wall -o testhd44780i2c
-                     -lpthread
+    gcc testhd44780i2c.c hd44780i2c.c hd44780task.c mcp23017.c -Wall
+                     -o testhd44780i2c -lpthread
 
     Also use the following flags for Raspberry Pi optimisation:
         -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
@@ -46,6 +46,7 @@
     Changelog:
 
         v0.1    Original version.
+        v0.2    Runs animations as scheduler tasks instead of threads.
 
 //  Information. --------------------------------------------------------------
 
@@ -111,6 +112,10 @@
 
 #include "hd44780i2c.h"
 #include "mcp23017.h"
+#include "hd44780task.h"
+
+#define DEMO_TURNS    3 // Widgets taking turns on row 1.
+#define DEMO_SECONDS 20 // Time each widget is shown.
 
 int main()
 {
@@ -217,29 +222,56 @@ int main()
         .increment = 1
     };
 
-    // Create threads and mutex for animated display functions.
+    // Set Pac-Man properties.
+    struct pacMan pacMan =
+    {
+        .mcp23017      = mcp23017[0],  // Initialised MCP23017.
+        .hd44780       = hd44780[0],   // Initialised HD44780.
+        .delay.tv_sec  = 0,            // Seconds.
+        .delay.tv_usec = 300000,       // Microseconds.
+        .row = 1
+    };
+
+    // Mutex still guards the display for anything outside the scheduler.
     pthread_mutex_init( &displayBusy, NULL );
-    pthread_t threads[2];
 
     /*
-        The HD44780 has a slow response so animation times should be as
-        large as possible and not mixed with other routines that have high
-        animation duty, e.g. ticker and time display with animation.
+        All animations run as tasks in this thread. Changes made by tasks
+        that are due at the same time are sent to the display together.
+        The date stays on row 0 while row 1 takes turns to show the time,
+        Pac-Man and the ticker for DEMO_SECONDS each.
     */
-    pthread_create( &threads[0], NULL, displayCalendar, (void *) &date );
-    pthread_create( &threads[1], NULL, displayCalendar, (void *) &time );
-//    pthread_create( &threads[1], NULL, displayPacMan, (void *) pacManRow );
-//    pthread_create( &threads[1], NULL, displayTicker, (void *) &ticker );
+    struct hd44780Scheduler scheduler;
+    struct hd44780Task tasks[2];
+
+    hd44780TaskFunction turn[DEMO_TURNS] =
+        { hd44780TaskCalendar, hd44780TaskPacMan, hd44780TaskTicker };
+    void    *turnData[DEMO_TURNS]     = { &time, &pacMan, &ticker };
+    uint8_t turnPriority[DEMO_TURNS] =
+        { PRIORITY_NORMAL, PRIORITY_NORMAL, PRIORITY_LOW };
+    uint8_t i;
 
-    while (1)
+    while ( 1 )
     {
-    };
+        for ( i = 0; i < DEMO_TURNS; i++ )
+        {
+            // Shadow RAM of a new scheduler assumes a cleared display.
+            hd44780Clear( mcp23017[0], hd44780[0] );
+            hd44780SchedulerInit( &scheduler );
+            hd44780TaskAdd( &scheduler, &tasks[0], hd44780TaskCalendar,
+                            &date, mcp23017[0], hd44780[0],
+                            PRIORITY_NORMAL, 0 );
+            hd44780TaskAdd( &scheduler, &tasks[1], turn[i], turnData[i],
+                            mcp23017[0], hd44780[0], turnPriority[i], 0 );
+
+            hd44780SchedulerRun( &scheduler, DEMO_SECONDS * 1000000ULL );
+        }
+    }
 
     hd44780Clear( mcp23017[0], hd44780[0] );
     hd44780Home( mcp23017[0], hd44780[0] );
 
-    // Clean up threads.
     pthread_mutex_destroy( &displayBusy );
-    pthread_exit( NULL );
 
+    return 0;
 }
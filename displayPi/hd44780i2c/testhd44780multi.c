@@ -0,0 +1,273 @@
+/*
+//  ===========================================================================
+
+    testhd44780multi:
+
+    Tests writes to several HD44780s sharing an MCP23017 against a mock
+    MCP23017.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+*/
+
+#define Version "Version 0.1"
+
+/*
+//  ---------------------------------------------------------------------------
+
+    Compile with:
+
+    gcc testhd44780multi.c hd44780i2c.c -Wall -o testhd44780multi -lpthread
+
+    mcp23017.c is not linked; this file provides the MCP23017 functions.
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v0.1    Original version.
+
+//  Information. --------------------------------------------------------------
+
+    The mock MCP23017 keeps OLATA and OLATB and counts every register read
+    and write. TEST_DISPLAYS displays hang off it, sharing RS, R/W and the
+    data bus, each with its own E bit. A display latches OLATB and RS on the
+    falling edge of its E bit, as the HD44780 does, so the test sees exactly
+    which bytes each display received.
+
+    The checks are that a multi write puts the byte on OLATB once and
+    raises E once for all targets together, that displays not addressed
+    receive nothing, and that initialising or clearing N displays costs the
+    same I2C transfers as one display.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include "hd44780i2c.h"
+#include "mcp23017.h"
+
+#define TEST_DISPLAYS 4
+#define TEST_LOG     32 // Bytes kept per display.
+#define TEST_RS    0x80 // Shared GPIOA pins.
+#define TEST_RW    0x40
+
+struct testLcd
+{
+    struct hd44780 hd44780;
+    uint8_t        data[TEST_LOG]; // Bytes latched.
+    bool           rs[TEST_LOG];   // RS when latched.
+    uint8_t        count;
+};
+
+static struct testLcd lcd[TEST_DISPLAYS];
+
+static uint8_t  mockOlata, mockOlatb;
+static uint32_t mockReads, mockWrites;
+static uint32_t mockOlatbWrites; // Bytes put on the data bus.
+static uint32_t mockPulses;      // OLATA writes that raise any E bit.
+static bool     mockGlitch;      // OLATB changed while an E bit was high.
+
+static uint8_t failed = 0;
+
+//  Mock MCP23017. ------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Writes OLATA or OLATB, latching OLATB into displays whose E falls.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017WriteByte( struct mcp23017 *mcp23017,
+                          uint8_t reg, uint8_t data )
+{
+    struct testLcd *this;
+    uint8_t en, i;
+
+    mockWrites++;
+
+    if ( reg == OLATB )
+    {
+        if ( mockOlata & ( lcd[0].hd44780.en | lcd[1].hd44780.en |
+                           lcd[2].hd44780.en | lcd[3].hd44780.en ))
+            mockGlitch = true;
+        mockOlatb = data;
+        mockOlatbWrites++;
+        return 0;
+    }
+    if ( reg != OLATA ) return 0;
+
+    en = 0;
+    for ( i = 0; i < TEST_DISPLAYS; i++ )
+    {
+        this = &lcd[i];
+        if (( data & this->hd44780.en ) && !( mockOlata & this->hd44780.en ))
+            en |= this->hd44780.en;
+        if (( mockOlata & this->hd44780.en ) && !( data & this->hd44780.en )
+            && ( this->count < TEST_LOG ))
+        {
+            this->data[this->count] = mockOlatb;
+            this->rs[this->count]   = mockOlata & TEST_RS;
+            this->count++;
+        }
+    }
+    if ( en ) mockPulses++;
+    mockOlata = data;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads OLATA or OLATB.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017ReadByte( struct mcp23017 *mcp23017, uint8_t reg )
+{
+    mockReads++;
+    return ( reg == OLATB ) ? mockOlatb : mockOlata;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets and clears bits, as used by the single display functions.
+//  ---------------------------------------------------------------------------
+int8_t mcp23017SetBitsByte( struct mcp23017 *mcp23017,
+                            uint8_t reg, uint8_t data )
+{
+    uint8_t read = mcp23017ReadByte( mcp23017, reg );
+    return mcp23017WriteByte( mcp23017, reg, read | data );
+}
+
+int8_t mcp23017ClearBitsByte( struct mcp23017 *mcp23017,
+                              uint8_t reg, uint8_t data )
+{
+    uint8_t read = mcp23017ReadByte( mcp23017, reg );
+    return mcp23017WriteByte( mcp23017, reg, read & ~data );
+}
+
+//  Tests. --------------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Prints result of a test.
+//  ---------------------------------------------------------------------------
+static void testCheck( const char *name, bool pass )
+{
+    printf( "%-48s %s\n", name, pass ? "pass" : "FAIL" );
+    if ( !pass ) failed++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Clears the mock's latches and counters and the displays' logs.
+//  ---------------------------------------------------------------------------
+static void testReset( void )
+{
+    uint8_t i;
+
+    mockOlata       = 0;
+    mockOlatb       = 0;
+    mockReads       = 0;
+    mockWrites      = 0;
+    mockOlatbWrites = 0;
+    mockPulses      = 0;
+    mockGlitch      = false;
+    for ( i = 0; i < TEST_DISPLAYS; i++ ) lcd[i].count = 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns true if display i received exactly the bytes display 0 did.
+//  ---------------------------------------------------------------------------
+static bool testSame( uint8_t i )
+{
+    return ( lcd[i].count == lcd[0].count ) &&
+           !memcmp( lcd[i].data, lcd[0].data, lcd[0].count ) &&
+           !memcmp( lcd[i].rs, lcd[0].rs, lcd[0].count * sizeof( bool ));
+}
+
+int main( void )
+{
+    struct mcp23017 mcp = { 0 };
+    struct hd44780  *list[TEST_DISPLAYS];
+    uint32_t oneCost, oneBytes, allCost;
+    bool     ok;
+    uint8_t  i;
+
+    for ( i = 0; i < TEST_DISPLAYS; i++ )
+    {
+        lcd[i].hd44780.rs = TEST_RS;
+        lcd[i].hd44780.rw = TEST_RW;
+        lcd[i].hd44780.en = 1 << i;
+        list[i] = &lcd[i].hd44780;
+    }
+
+    // One data byte to three of the four displays.
+    testReset();
+    hd44780WriteByteMulti( &mcp, list, 3, 'A', MODE_DATA );
+    testCheck( "One OLATB write for three displays.",
+               ( mockOlatbWrites == 1 ) && !mockGlitch );
+    testCheck( "One E pulse masked to the three displays.",
+               ( mockPulses == 1 ) && ( mockOlata == TEST_RS ));
+    ok = true;
+    for ( i = 0; i < 3; i++ )
+        ok &= ( lcd[i].count == 1 ) && ( lcd[i].data[0] == 'A' ) &&
+              lcd[i].rs[0];
+    testCheck( "Each target latched the byte once as data.", ok );
+    testCheck( "Display not addressed latched nothing.", lcd[3].count == 0 );
+    printf( "\t%u reads and %u writes for one byte.\n",
+            mockReads, mockWrites );
+    testCheck( "One read and at most 4 writes per byte.",
+               ( mockReads == 1 ) && ( mockWrites <= 4 ));
+
+    // Init and clear, one display then all of them.
+    testReset();
+    hd44780InitMulti( &mcp, list, 1, true, true, false,
+                      true, false, false, true, false, false, true );
+    oneCost  = mockReads + mockWrites;
+    oneBytes = lcd[0].count;
+    testCheck( "Init sends one OLATB write per byte.",
+               ( mockOlatbWrites == oneBytes ) && ( mockPulses == oneBytes ));
+
+    testReset();
+    hd44780InitMulti( &mcp, list, TEST_DISPLAYS, true, true, false,
+                      true, false, false, true, false, false, true );
+    allCost = mockReads + mockWrites;
+    printf( "\tInit: %u bytes, %u transfers for 1 display, %u for %u.\n",
+            oneBytes, oneCost, allCost, TEST_DISPLAYS );
+    testCheck( "Init of 4 displays costs the same as 1.",
+               ( allCost == oneCost ) && ( mockOlatbWrites == oneBytes ));
+    ok = ( lcd[0].count == oneBytes ) && !lcd[0].rs[0];
+    for ( i = 1; i < TEST_DISPLAYS; i++ ) ok &= testSame( i );
+    testCheck( "Every display received the same commands.", ok );
+
+    testReset();
+    hd44780ClearMulti( &mcp, list, TEST_DISPLAYS );
+    ok = ( mockOlatbWrites == 1 ) && ( mockPulses == 1 );
+    for ( i = 0; i < TEST_DISPLAYS; i++ )
+        ok &= ( lcd[i].count == 1 ) && ( lcd[i].data[0] == DISPLAY_CLEAR ) &&
+              !lcd[i].rs[0];
+    testCheck( "Clear of 4 displays is one byte and one pulse.", ok );
+
+    printf( "\n%s\n", failed ? "Some tests FAILED." : "All tests passed." );
+
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,224 @@
+/*
+//  ===========================================================================
+
+    testhd44780task:
+
+    Tests HD44780 task scheduler and governor using the simulated bus.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+*/
+
+#define Version "Version 0.1"
+
+/*
+//  ---------------------------------------------------------------------------
+
+    Compile with:
+
+    gcc testhd44780task.c hd44780task.c hd44780i2c.c mcp23017.c -Wall
+        -o testhd44780task -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v0.1    Original version.
+
+//  Information. --------------------------------------------------------------
+
+    Runs a stereo meter, a clock and a ticker on two displays sharing an
+    MCP23017 for TEST_SECONDS of simulated time at several I2C clock rates,
+    then prints the requested, allowed and achieved frame rates of each
+    widget. No hardware is needed and the test runs faster than real time.
+
+    At 50kHz the widgets ask for more than HD44780_BUS_LOAD of the bus, so
+    the ticker is cut back first and the meters keep their frame rate. At
+    100kHz the ticker's flushes would make the meters late, so it is cut
+    back too. At 25kHz the meters alone are too much, so the clock and
+    ticker are cut to TASK_FPS_MIN. Each run checks which widgets are cut
+    by more than TEST_TOLERANCE, so that meters keep their rate when they
+    fit, and that every widget achieves its allowed rate to within
+    TEST_TOLERANCE.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include "hd44780i2c.h"
+#include "mcp23017.h"
+#include "hd44780task.h"
+
+#define TEST_SECONDS   20
+#define TEST_WIDGETS    4
+#define TEST_TOLERANCE 10 // Slack in checked frame rates (%).
+
+//  ---------------------------------------------------------------------------
+//  Returns a random walk level for a meter channel.
+//  ---------------------------------------------------------------------------
+static uint8_t testLevel( void *data )
+{
+    int16_t *level = data;
+
+    *level += ( rand() % 41 ) - 20;
+    if ( *level < 0 ) *level = 0;
+    if ( *level > 100 ) *level = 100;
+
+    return *level;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs widgets on the simulated bus at khz, prints results and returns
+//  true if they are as expected. cut has a flag for each widget that
+//  should be running slower than it asked for.
+//  ---------------------------------------------------------------------------
+static bool testRun( uint32_t khz, const bool cut[TEST_WIDGETS] )
+{
+    static struct mcp23017 mcp;     // Not used by simulated bus.
+    static struct hd44780  lcd[2] = {{ 0x80, 0x40, 0x20 },
+                                     { 0x80, 0x40, 0x10 }};
+    static int16_t level[2] = { 50, 50 };
+
+    struct hd44780Scheduler scheduler;
+    struct hd44780Task      tasks[TEST_WIDGETS];
+    struct hd44780BusSim    sim;
+    struct hd44780Bus       bus;
+    struct hd44780TaskStats *stats;
+    bool    pass = true, ok;
+    uint8_t i;
+
+    const char *name[TEST_WIDGETS] =
+        { "Meter L", "Meter R", "Clock", "Ticker" };
+
+    struct bar meter[2] =
+    {
+        { &mcp, &lcd[0], { 0, 10000 }, 0, 0, 16, testLevel, &level[0] },
+        { &mcp, &lcd[0], { 0, 10000 }, 1, 0, 16, testLevel, &level[1] }
+    };
+
+    struct calendar clock =
+    {
+        .mcp23017      = &mcp,
+        .hd44780       = &lcd[1],
+        .delay.tv_sec  = 0,
+        .delay.tv_usec = 500000,
+        .row = 0,
+        .col = 4,
+        .length = 16,
+        .frames = FRAMES_MAX,
+        .format[0] = "%H:%M:%S",
+        .format[1] = "%H %M %S"
+    };
+
+    struct ticker ticker =
+    {
+        .mcp23017      = &mcp,
+        .hd44780       = &lcd[1],
+        .delay.tv_sec  = 0,
+        .delay.tv_usec = 50000,
+        .text = "This text is really long and used to demonstrate the ticker!",
+        .length = strlen( ticker.text ),
+        .padding = 6,
+        .row = 1,
+        .increment = 1
+    };
+
+    hd44780BusSimInit( &bus, &sim, khz );
+    hd44780SchedulerInit( &scheduler );
+    hd44780SchedulerSetBus( &scheduler, &bus );
+
+    hd44780TaskAdd( &scheduler, &tasks[0], hd44780TaskBar, &meter[0],
+                    &mcp, &lcd[0], PRIORITY_HIGH, 0 );
+    hd44780TaskAdd( &scheduler, &tasks[1], hd44780TaskBar, &meter[1],
+                    &mcp, &lcd[0], PRIORITY_HIGH, 0 );
+    hd44780TaskAdd( &scheduler, &tasks[2], hd44780TaskCalendar, &clock,
+                    &mcp, &lcd[1], PRIORITY_NORMAL, 0 );
+    hd44780TaskAdd( &scheduler, &tasks[3], hd44780TaskTicker, &ticker,
+                    &mcp, &lcd[1], PRIORITY_LOW, 0 );
+
+    hd44780SchedulerRun( &scheduler, TEST_SECONDS * 1000000ULL );
+
+    printf( "\nI2C clock %ukHz, %us simulated, bus load %.1f%%.\n",
+            khz, TEST_SECONDS, scheduler.busLoad );
+    printf( "+---------+-----------+---------+----------+---------+"
+            "--------+------+\n" );
+    printf( "| Widget  | Requested | Allowed | Achieved | Cost uS |"
+            " Bytes  | Test |\n" );
+    printf( "+---------+-----------+---------+----------+---------+"
+            "--------+------+\n" );
+    for ( i = 0; i < TEST_WIDGETS; i++ )
+    {
+        stats = &tasks[i].stats;
+
+        // Cut or not as expected, achieving what is allowed.
+        ok = ( stats->fpsAllowed * 100 <
+               stats->fpsRequested * ( 100 - TEST_TOLERANCE )) == cut[i];
+        ok &= ( stats->fpsAchieved * 100 >=
+                stats->fpsAllowed * ( 100 - TEST_TOLERANCE )) &&
+              ( stats->fpsAchieved * 100 <=
+                stats->fpsAllowed * ( 100 + TEST_TOLERANCE ));
+        pass &= ok;
+
+        printf( "| %-7s | %9.1f | %7.1f | %8.1f | %7u | %6u | %-4s |\n",
+                name[i], stats->fpsRequested, stats->fpsAllowed,
+                stats->fpsAchieved, stats->cost, stats->bytes,
+                ok ? "pass" : "FAIL" );
+    }
+    printf( "+---------+-----------+---------+----------+---------+"
+            "--------+------+\n" );
+
+    return pass;
+}
+
+int main( void )
+{
+    //                                 Meter L Meter R Clock  Ticker
+    const bool saturated[TEST_WIDGETS] = { true,  true,  true,  true  };
+    const bool busy[TEST_WIDGETS]      = { false, false, false, true  };
+    const bool idle[TEST_WIDGETS]      = { false, false, false, false };
+    bool pass = true;
+
+    // Governor only changes flushes, not display contents.
+    pthread_mutex_init( &displayBusy, NULL );
+    srand( 1 );
+
+    pass &= testRun( 25, saturated );
+    pass &= testRun( 50, busy );
+    pass &= testRun( 100, busy );
+    pass &= testRun( 400, idle );
+
+    pthread_mutex_destroy( &displayBusy );
+    printf( "\n%s\n", pass ? "All tests passed." : "Some tests FAILED." );
+
+    return pass ? 0 : -1;
+}
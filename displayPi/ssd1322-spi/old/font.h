@@ -0,0 +1,214 @@
+//  ===========================================================================
+/*
+    8x20 bitmap font for SSD1322 OLED displays, ASCII 32 to 126.
+
+    Generated from tools/unpacked.txt, one byte per row with the leftmost
+    pixel in the top bit. Glyphs are drawn on every other row, with the
+    baseline below row FONT_BASELINE and descenders beneath it.
+*/
+//  ===========================================================================
+
+#ifndef FONT_H
+#define FONT_H
+
+#define FONT_FIRST    32 // First character.
+#define FONT_LAST    126 // Last character.
+#define FONT_WIDTH     8 // Pixels per glyph row.
+#define FONT_HEIGHT   20 // Rows per glyph.
+#define FONT_BASELINE 12 // Last row above the baseline.
+
+static const uint8_t font_8x20[FONT_LAST - FONT_FIRST + 1][FONT_HEIGHT] =
+{
+	{ 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // ' '
+	{ 0xc0,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,
+	  0x00,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '!'
+	{ 0xcc,0x00,0xcc,0x00,0xcc,0x00,0x00,0x00,0x00,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '"'
+	{ 0x66,0x00,0x66,0x00,0xff,0x00,0x66,0x00,0xff,0x00,
+	  0x66,0x00,0x66,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '#'
+	{ 0x18,0x00,0x7e,0x00,0xd8,0x00,0x3c,0x00,0x1b,0x00,
+	  0x7e,0x00,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '$'
+	{ 0x63,0x00,0xf6,0x00,0x6c,0x00,0x18,0x00,0x36,0x00,
+	  0x6f,0x00,0xc6,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '%'
+	{ 0x7c,0x00,0xc6,0x00,0xc6,0x00,0x78,0x00,0xcf,0x00,
+	  0xc6,0x00,0x7f,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '&'
+	{ 0x70,0x00,0x60,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '''
+	{ 0x30,0x00,0x60,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,
+	  0x60,0x00,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '('
+	{ 0xc0,0x00,0x60,0x00,0x30,0x00,0x30,0x00,0x30,0x00,
+	  0x60,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // ')'
+	{ 0x00,0x00,0x66,0x00,0x3c,0x00,0xff,0x00,0x3c,0x00,
+	  0x66,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '*'
+	{ 0x00,0x00,0x18,0x00,0x18,0x00,0xff,0x00,0x18,0x00,
+	  0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '+'
+	{ 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	  0x70,0x00,0x60,0x00,0xc0,0x00,0x00,0x00,0x00,0x00 }, // ','
+	{ 0x00,0x00,0x00,0x00,0x00,0x00,0xff,0x00,0x00,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '-'
+	{ 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xc0,0x00,
+	  0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '.'
+	{ 0x03,0x00,0x06,0x00,0x0c,0x00,0x18,0x00,0x30,0x00,
+	  0x60,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '/'
+	{ 0x3c,0x00,0xc3,0x00,0xc7,0x00,0xdb,0x00,0xe3,0x00,
+	  0xc3,0x00,0x3c,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '0'
+	{ 0x30,0x00,0x70,0x00,0xf0,0x00,0x30,0x00,0x30,0x00,
+	  0x30,0x00,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '1'
+	{ 0x7c,0x00,0xc6,0x00,0x06,0x00,0x38,0x00,0x60,0x00,
+	  0xc0,0x00,0xfe,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '2'
+	{ 0xff,0x00,0x06,0x00,0x0c,0x00,0x1e,0x00,0x03,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '3'
+	{ 0x0e,0x00,0x1e,0x00,0x36,0x00,0x66,0x00,0xff,0x00,
+	  0x06,0x00,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '4'
+	{ 0xff,0x00,0x60,0x00,0xfe,0x00,0xc3,0x00,0x03,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '5'
+	{ 0x7e,0x00,0xc0,0x00,0xc0,0x00,0xde,0x00,0xc3,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '6'
+	{ 0xff,0x00,0x03,0x00,0x66,0x00,0x1c,0x00,0x1b,0x00,
+	  0x30,0x00,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '7'
+	{ 0x3c,0x00,0xc3,0x00,0xc3,0x00,0x7f,0x00,0xc3,0x00,
+	  0xc3,0x00,0x3c,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '8'
+	{ 0x7e,0x00,0xc3,0x00,0xc3,0x00,0x7b,0x00,0x03,0x00,
+	  0x03,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '9'
+	{ 0x00,0x00,0xc0,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,
+	  0xc0,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // ':'
+	{ 0x00,0x00,0x00,0x00,0x60,0x00,0x60,0x00,0x00,0x00,
+	  0x70,0x00,0x60,0x00,0xc0,0x00,0x00,0x00,0x00,0x00 }, // ';'
+	{ 0x03,0x00,0x0c,0x00,0x30,0x00,0xc0,0x00,0x30,0x00,
+	  0x0c,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '<'
+	{ 0x00,0x00,0x00,0x00,0xff,0x00,0x00,0x00,0xff,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '='
+	{ 0xc0,0x00,0x30,0x00,0x0c,0x00,0x03,0x00,0x0c,0x00,
+	  0x30,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '>'
+	{ 0x7e,0x00,0xc3,0x00,0x1e,0x00,0x18,0x00,0x18,0x00,
+	  0x00,0x00,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '?'
+	{ 0x7e,0x00,0xc3,0x00,0xdf,0x00,0xf7,0x00,0xdf,0x00,
+	  0xc0,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '@'
+	{ 0x18,0x00,0x3c,0x00,0x66,0x00,0xc3,0x00,0xff,0x00,
+	  0xc3,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'A'
+	{ 0xfe,0x00,0x63,0x00,0x63,0x00,0x7e,0x00,0x63,0x00,
+	  0x63,0x00,0xfe,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'B'
+	{ 0x3e,0x00,0x60,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,
+	  0x60,0x00,0x3e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'C'
+	{ 0xfc,0x00,0x66,0x00,0x63,0x00,0x63,0x00,0x63,0x00,
+	  0x66,0x00,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'D'
+	{ 0xfc,0x00,0xc0,0x00,0xc0,0x00,0xf0,0x00,0xc0,0x00,
+	  0xc0,0x00,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'E'
+	{ 0xfc,0x00,0xc0,0x00,0xc0,0x00,0xf0,0x00,0xc0,0x00,
+	  0xc0,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'F'
+	{ 0x3e,0x00,0x63,0x00,0xc0,0x00,0xc7,0x00,0xc3,0x00,
+	  0x63,0x00,0x3e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'G'
+	{ 0xc3,0x00,0xc3,0x00,0xc3,0x00,0xff,0x00,0xc3,0x00,
+	  0xc3,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'H'
+	{ 0xf0,0x00,0x60,0x00,0x60,0x00,0x60,0x00,0x60,0x00,
+	  0x60,0x00,0xf0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'I'
+	{ 0x1e,0x00,0x0c,0x00,0x0c,0x00,0x0c,0x00,0x0c,0x00,
+	  0xcc,0x00,0x78,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'J'
+	{ 0xc3,0x00,0xc6,0x00,0xcc,0x00,0xf8,0x00,0xcc,0x00,
+	  0xc6,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'K'
+	{ 0xc0,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,
+	  0xc0,0x00,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'L'
+	{ 0xc3,0x00,0xe7,0x00,0xff,0x00,0xdb,0x00,0xc3,0x00,
+	  0xc3,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'M'
+	{ 0xc3,0x00,0xe3,0x00,0xf3,0x00,0xdb,0x00,0xcf,0x00,
+	  0xc7,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'N'
+	{ 0x7e,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'O'
+	{ 0xfe,0x00,0xc3,0x00,0xc3,0x00,0xfe,0x00,0xc0,0x00,
+	  0xc0,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'P'
+	{ 0x7c,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,0xcf,0x00,
+	  0xc3,0x00,0x7f,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'Q'
+	{ 0xfe,0x00,0xc3,0x00,0xc3,0x00,0xfe,0x00,0xcc,0x00,
+	  0xc6,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'R'
+	{ 0x7c,0x00,0xc3,0x00,0xc0,0x00,0x7e,0x00,0x03,0x00,
+	  0xc3,0x00,0x7c,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'S'
+	{ 0xff,0x00,0x18,0x00,0x18,0x00,0x18,0x00,0x18,0x00,
+	  0x18,0x00,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'T'
+	{ 0xc3,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'U'
+	{ 0xc3,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,
+	  0x66,0x00,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'V'
+	{ 0xc3,0x00,0xc3,0x00,0xc3,0x00,0xdb,0x00,0xdb,0x00,
+	  0x7e,0x00,0x66,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'W'
+	{ 0xc3,0x00,0x66,0x00,0x3c,0x00,0x18,0x00,0x3c,0x00,
+	  0x66,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'X'
+	{ 0xc3,0x00,0x66,0x00,0x3c,0x00,0x18,0x00,0x18,0x00,
+	  0x18,0x00,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'Y'
+	{ 0xff,0x00,0x06,0x00,0x0c,0x00,0x18,0x00,0x30,0x00,
+	  0x60,0x00,0xff,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'Z'
+	{ 0xf8,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,
+	  0xc0,0x00,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '['
+	{ 0xc0,0x00,0x60,0x00,0x30,0x00,0x18,0x00,0x0c,0x00,
+	  0x06,0x00,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '\\'
+	{ 0xf8,0x00,0x18,0x00,0x18,0x00,0x18,0x00,0x18,0x00,
+	  0x18,0x00,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // ']'
+	{ 0x18,0x00,0x3c,0x00,0x66,0x00,0xc3,0x00,0x00,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '^'
+	{ 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	  0x00,0x00,0xff,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '_'
+	{ 0xe0,0x00,0x60,0x00,0x30,0x00,0x00,0x00,0x00,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '`'
+	{ 0x00,0x00,0x00,0x00,0x7e,0x00,0x03,0x00,0x7f,0x00,
+	  0xc3,0x00,0x7f,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'a'
+	{ 0xc0,0x00,0xc0,0x00,0xfe,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0xfe,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'b'
+	{ 0x00,0x00,0x00,0x00,0x7e,0x00,0xc3,0x00,0xc0,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'c'
+	{ 0x03,0x00,0x03,0x00,0x7f,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0x7f,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'd'
+	{ 0x00,0x00,0x00,0x00,0x7e,0x00,0xc3,0x00,0xff,0x00,
+	  0xc0,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'e'
+	{ 0x1e,0x00,0x33,0x00,0x30,0x00,0x7c,0x00,0x30,0x00,
+	  0x30,0x00,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'f'
+	{ 0x00,0x00,0x00,0x00,0x7e,0x00,0xc3,0x00,0xc3,0x00,
+	  0x7f,0x00,0x03,0x00,0xc3,0x00,0x7e,0x00,0x00,0x00 }, // 'g'
+	{ 0xc0,0x00,0xc0,0x00,0xfe,0x00,0xe7,0x00,0xc3,0x00,
+	  0xc3,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'h'
+	{ 0x18,0x00,0x00,0x00,0x38,0x00,0x18,0x00,0x18,0x00,
+	  0x18,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'i'
+	{ 0x03,0x00,0x00,0x00,0x07,0x00,0x03,0x00,0x03,0x00,
+	  0x03,0x00,0xc3,0x00,0xc3,0x00,0x7e,0x00,0x00,0x00 }, // 'j'
+	{ 0xc0,0x00,0xc0,0x00,0xc3,0x00,0xcc,0x00,0xf0,0x00,
+	  0xcc,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'k'
+	{ 0x38,0x00,0x18,0x00,0x18,0x00,0x18,0x00,0x18,0x00,
+	  0x18,0x00,0x3c,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'l'
+	{ 0x00,0x00,0x00,0x00,0x66,0x00,0xff,0x00,0xdb,0x00,
+	  0xdb,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'm'
+	{ 0x00,0x00,0x00,0x00,0x7e,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'n'
+	{ 0x00,0x00,0x00,0x00,0x7e,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'o'
+	{ 0x00,0x00,0x00,0x00,0xfe,0x00,0xc3,0x00,0xc3,0x00,
+	  0xfe,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,0x00,0x00 }, // 'p'
+	{ 0x00,0x00,0x00,0x00,0x7f,0x00,0xc3,0x00,0xc3,0x00,
+	  0x7f,0x00,0x03,0x00,0x03,0x00,0x03,0x00,0x00,0x00 }, // 'q'
+	{ 0x00,0x00,0x00,0x00,0x3e,0x00,0x63,0x00,0x60,0x00,
+	  0x60,0x00,0x60,0x00,0x60,0x00,0x60,0x00,0x00,0x00 }, // 'r'
+	{ 0x00,0x00,0x00,0x00,0x7e,0x00,0xc0,0x00,0x7e,0x00,
+	  0x03,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 's'
+	{ 0x30,0x00,0x30,0x00,0xfc,0x00,0x30,0x00,0x30,0x00,
+	  0x33,0x00,0x1e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 't'
+	{ 0x00,0x00,0x00,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0x7e,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'u'
+	{ 0x00,0x00,0x00,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,
+	  0x66,0x00,0x3c,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'v'
+	{ 0x00,0x00,0x00,0x00,0xc3,0x00,0xc3,0x00,0xdb,0x00,
+	  0xff,0x00,0x66,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'w'
+	{ 0x00,0x00,0x00,0x00,0xc3,0x00,0x66,0x00,0x3c,0x00,
+	  0x66,0x00,0xc3,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // 'x'
+	{ 0x00,0x00,0x00,0x00,0xc3,0x00,0xc3,0x00,0xc3,0x00,
+	  0xc3,0x00,0x7f,0x00,0x03,0x00,0xc3,0x00,0x7e,0x00 }, // 'y'
+	{ 0x00,0x00,0x00,0x00,0xff,0x00,0x0e,0x00,0x30,0x00,
+	  0xc0,0x00,0x1c,0x00,0x03,0x00,0xc3,0x00,0x7e,0x00 }, // 'z'
+	{ 0x1c,0x00,0x60,0x00,0x30,0x00,0xc0,0x00,0x30,0x00,
+	  0x60,0x00,0x1c,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '{'
+	{ 0xe0,0x00,0x18,0x00,0x30,0x00,0x0c,0x00,0x30,0x00,
+	  0x18,0x00,0xe0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '|'
+	{ 0xc0,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,0xc0,0x00,
+	  0xc0,0x00,0xc0,0x00,0x00,0x00,0x00,0x00,0x00,0x00 }, // '}'
+	{ 0x73,0x00,0xdb,0x00,0xce,0x00,0x00,0x00,0x00,0x00,
+	  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 } // '~'
+};
+
+#endif
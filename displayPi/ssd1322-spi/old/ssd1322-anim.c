@@ -0,0 +1,408 @@
+//  ===========================================================================
+/*
+    ssd1322-anim:
+
+    Delta coded animations for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-anim.h"
+
+// ----------------------------------------------------------------------------
+/*
+    Returns monotonic time in microseconds.
+*/
+// ----------------------------------------------------------------------------
+static uint64_t ssd1322_anim_time( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( uint64_t )now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Writes the spans where row differs from last and widens the box.
+    Returns the bytes written.
+*/
+// ----------------------------------------------------------------------------
+static uint32_t ssd1322_anim_spans( const uint8_t *row, const uint8_t *last,
+                                    uint8_t stride, uint8_t y, uint8_t *out,
+                                    struct ssd1322_anim_frame_t *frame )
+{
+    uint8_t *start = out;
+    uint16_t x = 0, end, gap;
+
+    while ( x < stride )
+    {
+        if ( row[x] == last[x] )
+        {
+            x++;
+            continue;
+        }
+
+        // Extend over changes, and over gaps too short to be worth a span.
+        for ( end = x + 1; end < stride; end++ )
+        {
+            if ( row[end] != last[end] ) continue;
+            for ( gap = end; ( gap < stride ) && ( row[gap] == last[gap] );
+                  gap++ );
+            if (( gap == stride ) || ( gap - end > SSD1322_ANIM_SPAN )) break;
+            end = gap;
+        }
+
+        *out++ = y;
+        *out++ = x;
+        *out++ = end - x;
+        memcpy( out, &row[x], end - x );
+        out += end - x;
+
+        if ( frame->spans == 0 )
+        {
+            frame->left = x;
+            frame->right = end - 1;
+            frame->top = y;
+        }
+        if ( x < frame->left ) frame->left = x;
+        if ( end - 1 > frame->right ) frame->right = end - 1;
+        frame->bottom = y;
+        frame->spans++;
+        frame->bytes += end - x;
+        x = end;
+    }
+
+    return out - start;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Encodes an animation.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_encode( const uint8_t *frames, uint16_t width,
+                            uint8_t height, uint8_t count, uint8_t fps,
+                            uint8_t interval, uint8_t **data, size_t *size )
+{
+    struct ssd1322_anim_header_t *header;
+    struct ssd1322_anim_frame_t  *frame;
+    uint8_t  *packed, *out, *shrunk, *row, *last;
+    uint8_t   stride = width / 2;
+    uint32_t  image = stride * height, pixels = width * height;
+    size_t    bound, used;
+    uint16_t  i, x, y;
+
+    *data = NULL;
+    if (( width == 0 ) || ( width > SSD1322_COLS ) || ( width & 1 ) ||
+        ( height == 0 ) || ( height > SSD1322_ROWS ) || ( count == 0 ) ||
+        ( fps == 0 ) || ( interval == 0 )) return -1;
+
+    packed = calloc( count, image );
+    if ( packed == NULL ) return -2;
+    for ( i = 0; i < count; i++ )
+        for ( x = 0; x < pixels; x += 2 )
+            packed[i * image + x / 2] = ( frames[i * pixels + x] & 0x0f ) << 4 |
+                                        ( frames[i * pixels + x + 1] & 0x0f );
+
+    // A row can have at most one span per SSD1322_ANIM_SPAN + 1 bytes.
+    bound = sizeof( struct ssd1322_anim_header_t ) +
+            count * sizeof( struct ssd1322_anim_frame_t ) +
+            (( count + interval - 1 ) / interval ) * image +
+            count * height * ( stride + SSD1322_ANIM_SPAN *
+                               ( stride / ( SSD1322_ANIM_SPAN + 1 ) + 1 ));
+    out = calloc( 1, bound );
+    if ( out == NULL )
+    {
+        free( packed );
+        return -2;
+    }
+
+    header = ( struct ssd1322_anim_header_t * )out;
+    memcpy( header->magic, SSD1322_ANIM_MAGIC, 4 );
+    header->width    = width;
+    header->height   = height;
+    header->frames   = count;
+    header->fps      = fps;
+    header->interval = interval;
+
+    frame = ( struct ssd1322_anim_frame_t * )( header + 1 );
+    used  = ( uint8_t * )&frame[count] - out;
+    for ( i = 0; i < count; i++ )
+    {
+        if ( i % interval == 0 )
+        {
+            frame[i].key = used;
+            memcpy( &out[used], &packed[i * image], image );
+            used += image;
+        }
+
+        frame[i].delta = used;
+        for ( y = 0; y < height; y++ )
+        {
+            row  = &packed[i * image + y * stride];
+            last = &packed[(( i + count - 1 ) % count ) * image + y * stride];
+            used += ssd1322_anim_spans( row, last, stride, y, &out[used],
+                                        &frame[i] );
+        }
+    }
+    free( packed );
+
+    shrunk = realloc( out, used );
+    *data  = ( shrunk != NULL ) ? shrunk : out;
+    *size  = used;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a player for an encoded animation in memory. Every offset and
+    span is checked, so a damaged file can't make the player write outside
+    the animation's box.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_init( struct ssd1322_anim_t *anim, const uint8_t *data,
+                          size_t size )
+{
+    const struct ssd1322_anim_header_t *header;
+    const struct ssd1322_anim_frame_t  *frame;
+    const uint8_t *span;
+    uint32_t image;
+    size_t   pos;
+    uint16_t i, j;
+    uint8_t  stride;
+
+    memset( anim, 0, sizeof( struct ssd1322_anim_t ));
+    header = ( const struct ssd1322_anim_header_t * )data;
+    if (( size < sizeof( *header )) ||
+        ( memcmp( header->magic, SSD1322_ANIM_MAGIC, 4 ) != 0 ) ||
+        ( header->width == 0 ) || ( header->width > SSD1322_COLS ) ||
+        ( header->width & 1 ) || ( header->height == 0 ) ||
+        ( header->height > SSD1322_ROWS ) || ( header->frames == 0 ) ||
+        ( header->fps == 0 ) || ( header->interval == 0 ) ||
+        ( size < sizeof( *header ) + header->frames * sizeof( *frame )))
+        return -1;
+
+    stride = header->width / 2;
+    image  = stride * header->height;
+    frame  = ( const struct ssd1322_anim_frame_t * )( header + 1 );
+    for ( i = 0; i < header->frames; i++ )
+    {
+        if ((( i % header->interval == 0 ) &&
+             (( frame[i].key == 0 ) || ( frame[i].key + image > size ))) ||
+            ( frame[i].delta > size ))
+            return -1;
+
+        for ( pos = frame[i].delta, j = 0; j < frame[i].spans; j++ )
+        {
+            span = &data[pos];
+            if (( pos + SSD1322_ANIM_SPAN > size ) ||
+                ( span[0] >= header->height ) ||
+                ( span[1] + span[2] > stride ) ||
+                ( pos + SSD1322_ANIM_SPAN + span[2] > size )) return -1;
+            pos += SSD1322_ANIM_SPAN + span[2];
+        }
+    }
+
+    anim->data   = data;
+    anim->size   = size;
+    anim->header = header;
+    anim->frames = frame;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Writes an encoded animation to a file.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_save( const char *path, const uint8_t *data, size_t size )
+{
+    FILE  *file;
+    size_t done;
+
+    file = fopen( path, "wb" );
+    if ( file == NULL ) return -1;
+    done = fwrite( data, 1, size, file );
+    if (( fclose( file ) != 0 ) || ( done != size )) return -1;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Maps an animation file and sets up a player for it.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_open( struct ssd1322_anim_t *anim, const char *path )
+{
+    struct stat st;
+    uint8_t *data;
+    int      fd;
+
+    fd = open( path, O_RDONLY );
+    if ( fd < 0 ) return -1;
+    if (( fstat( fd, &st ) < 0 ) || ( st.st_size == 0 ))
+    {
+        close( fd );
+        return -1;
+    }
+    data = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( data == MAP_FAILED ) return -1;
+
+    if ( ssd1322_anim_init( anim, data, st.st_size ) < 0 )
+    {
+        munmap( data, st.st_size );
+        return -1;
+    }
+    anim->mapped = true;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Copies the spans of a frame into the framebuffer and marks their box.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_anim_apply( struct ssd1322_anim_t *anim, uint8_t index )
+{
+    const struct ssd1322_anim_frame_t *frame = &anim->frames[index];
+    struct ssd1322_fb_t *fb = ssd1322_fb[anim->id];
+    const uint8_t *span = &anim->data[frame->delta];
+    uint16_t i;
+
+    if ( frame->spans == 0 ) return;
+
+    pthread_mutex_lock( &fb->lock );
+    for ( i = 0; i < frame->spans; i++ )
+    {
+        ssd1322_fb_copy_packed(
+            &fb->buffer[( anim->y + span[0] ) * SSD1322_FB_ROW_BYTES],
+            anim->x + span[1] * 2, &span[SSD1322_ANIM_SPAN], 0, span[2] * 2 );
+        span += SSD1322_ANIM_SPAN + span[2];
+    }
+    ssd1322_fb_mark_dirty_locked( fb, anim->x + frame->left * 2,
+                                  anim->y + frame->top,
+                                  ( frame->right - frame->left + 1 ) * 2,
+                                  frame->bottom - frame->top + 1 );
+    pthread_mutex_unlock( &fb->lock );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws the first frame at x, y on display id and starts the clock.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_start( struct ssd1322_anim_t *anim, uint8_t id,
+                           uint16_t x, uint8_t y )
+{
+    if (( x + anim->header->width > SSD1322_COLS ) ||
+        ( y + anim->header->height > SSD1322_ROWS )) return -1;
+
+    anim->id = id;
+    anim->x  = x;
+    anim->y  = y;
+    ssd1322_anim_seek( anim, 0 );
+    anim->next = ssd1322_anim_time() + 1000000 / anim->header->fps;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws frame, from the keyframe before it and the deltas after that.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_anim_seek( struct ssd1322_anim_t *anim, uint8_t frame )
+{
+    uint8_t key;
+
+    frame %= anim->header->frames;
+    key    = frame - frame % anim->header->interval;
+
+    ssd1322_fb_draw_packed( anim->id, anim->x, anim->y, anim->header->width,
+                            anim->header->height,
+                            &anim->data[anim->frames[key].key] );
+    for ( anim->frame = key; anim->frame != frame; )
+        ssd1322_anim_apply( anim, ++anim->frame );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Copies the delta of the next frame into the framebuffer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_anim_step( struct ssd1322_anim_t *anim )
+{
+    anim->frame = ( anim->frame + 1 ) % anim->header->frames;
+    ssd1322_anim_apply( anim, anim->frame );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Steps to the frame due now at the animation's frame rate.
+*/
+// ----------------------------------------------------------------------------
+uint8_t ssd1322_anim_play( struct ssd1322_anim_t *anim )
+{
+    uint64_t now = ssd1322_anim_time();
+    uint32_t period = 1000000 / anim->header->fps;
+    uint8_t  steps = 0;
+
+    // After a long stall, carry on from now rather than racing to catch up.
+    if ( now > anim->next + period * anim->header->frames )
+        anim->next = now;
+
+    while ( now >= anim->next )
+    {
+        ssd1322_anim_step( anim );
+        anim->next += period;
+        steps++;
+    }
+
+    return steps;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Unmaps an animation opened from a file.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_anim_close( struct ssd1322_anim_t *anim )
+{
+    if ( anim->mapped ) munmap(( void * )anim->data, anim->size );
+    memset( anim, 0, sizeof( struct ssd1322_anim_t ));
+}
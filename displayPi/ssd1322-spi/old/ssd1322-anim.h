@@ -0,0 +1,184 @@
+//  ===========================================================================
+/*
+    ssd1322-anim:
+
+    Delta coded animations for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef SSD1322ANIM_H
+#define SSD1322ANIM_H
+
+// Info -----------------------------------------------------------------------
+/*
+    Consecutive frames of an animation usually differ in a small part of
+    the picture, so instead of redrawing every frame, only the bytes that
+    change are stored and copied into the framebuffer.
+
+    An animation is a header, a table with an entry per frame, then the
+    data. Everything is packed 4 bits per pixel as in the framebuffer.
+
+        header | frame 0 .. frame n-1 | keyframes and deltas
+
+    Every frame has a delta from the frame before, frame 0's being from the
+    last frame so that a loop never needs a keyframe. A delta is a list of
+    spans, each a row, a byte offset, a length and that many bytes. Runs of
+    changed bytes separated by fewer unchanged bytes than a span header
+    are joined into one span. Every interval frames, starting with frame 0,
+    there is also a keyframe holding the whole picture, for starting and
+    seeking.
+
+    Each frame entry also holds the box around its spans, which is marked
+    dirty in the framebuffer after the spans are copied in, so the flush
+    thread only sends that window of the panel.
+
+    Animations are encoded once from frames with one byte per pixel, as in
+    graphics.h, and can be saved to a file and mapped back.
+*/
+
+// Macros. --------------------------------------------------------------------
+
+#define SSD1322_ANIM_MAGIC "S4AN" // File signature.
+#define SSD1322_ANIM_SPAN  3      // Bytes of span header: row, x, length.
+
+// Data structures. -----------------------------------------------------------
+
+struct ssd1322_anim_header_t
+{
+    char     magic[4];
+    uint16_t width;      // Pixels, even.
+    uint8_t  height;
+    uint8_t  frames;
+    uint8_t  fps;
+    uint8_t  interval;   // Frames between keyframes.
+    uint16_t spare;
+};
+
+struct ssd1322_anim_frame_t
+{
+    uint32_t key;        // Offset of keyframe, 0 if none.
+    uint32_t delta;      // Offset of spans from the previous frame.
+    uint16_t spans;
+    uint16_t bytes;      // Pixel bytes in spans.
+    uint8_t  left;       // Box around the spans, in bytes and rows,
+    uint8_t  right;      // inclusive.
+    uint8_t  top;
+    uint8_t  bottom;
+};
+
+struct ssd1322_anim_t
+{
+    const uint8_t *data;
+    size_t         size;
+    bool           mapped;  // data was mapped by ssd1322_anim_open.
+    const struct ssd1322_anim_header_t *header;
+    const struct ssd1322_anim_frame_t  *frames;
+    uint8_t        id;      // Display.
+    uint16_t       x;       // Position on display.
+    uint8_t        y;
+    uint8_t        frame;   // Frame shown.
+    uint64_t       next;    // Time of next frame (us).
+};
+
+// Functions. -----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*
+    Encodes an animation.
+
+    frames holds count frames of width x height greyscales, one byte per
+    pixel. interval is the number of frames between keyframes. data is
+    allocated and must be freed by the caller.
+    Returns 0 on success, -1 for an invalid size, -2 if out of memory.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_encode( const uint8_t *frames, uint16_t width,
+                            uint8_t height, uint8_t count, uint8_t fps,
+                            uint8_t interval, uint8_t **data, size_t *size );
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a player for an encoded animation in memory.
+
+    Returns 0 on success, -1 if data isn't a whole animation.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_init( struct ssd1322_anim_t *anim, const uint8_t *data,
+                          size_t size );
+
+// ----------------------------------------------------------------------------
+/*
+    Writes an encoded animation to a file.
+
+    Returns 0 on success, -1 if the file can't be written.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_save( const char *path, const uint8_t *data, size_t size );
+
+// ----------------------------------------------------------------------------
+/*
+    Maps an animation file and sets up a player for it.
+
+    Returns 0 on success, -1 if the file can't be read or isn't valid.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_open( struct ssd1322_anim_t *anim, const char *path );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws the first frame at x, y on display id and starts the clock.
+
+    Returns 0 on success, -1 if it doesn't fit.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_anim_start( struct ssd1322_anim_t *anim, uint8_t id,
+                           uint16_t x, uint8_t y );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws frame, from the keyframe before it and the deltas after that.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_anim_seek( struct ssd1322_anim_t *anim, uint8_t frame );
+
+// ----------------------------------------------------------------------------
+/*
+    Copies the delta of the next frame into the framebuffer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_anim_step( struct ssd1322_anim_t *anim );
+
+// ----------------------------------------------------------------------------
+/*
+    Steps to the frame due now at the animation's frame rate.
+
+    Call as often as convenient, e.g. from a display loop. Frames missed
+    are still applied, as each delta builds on the one before.
+    Returns the number of frames stepped.
+*/
+// ----------------------------------------------------------------------------
+uint8_t ssd1322_anim_play( struct ssd1322_anim_t *anim );
+
+// ----------------------------------------------------------------------------
+/*
+    Unmaps an animation opened from a file.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_anim_close( struct ssd1322_anim_t *anim );
+
+#endif
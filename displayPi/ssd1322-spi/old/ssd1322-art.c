@@ -0,0 +1,660 @@
+//  ===========================================================================
+/*
+    ssd1322-art:
+
+    Album art decode, scale, dither and cache for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-art.h"
+
+// ----------------------------------------------------------------------------
+/*
+    Returns true if data starts with a PGM or PPM signature.
+*/
+// ----------------------------------------------------------------------------
+static bool ssd1322_art_pnm_probe( const uint8_t *data, size_t size )
+{
+    return ( size > 2 ) && ( data[0] == 'P' ) &&
+           (( data[1] == '2' ) || ( data[1] == '3' ) ||
+            ( data[1] == '5' ) || ( data[1] == '6' ));
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Reads a decimal number from a PNM header or ASCII raster, skipping
+    white space and comments.
+*/
+// ----------------------------------------------------------------------------
+static bool ssd1322_art_pnm_number( const uint8_t *data, size_t size,
+                                    size_t *pos, uint32_t *value )
+{
+    size_t i = *pos;
+
+    while ( i < size )
+    {
+        if ( data[i] == '#' )
+            while (( i < size ) && ( data[i] != '\n' )) i++;
+        else if (( data[i] == ' ' ) || ( data[i] == '\t' ) ||
+                 ( data[i] == '\r' ) || ( data[i] == '\n' )) i++;
+        else break;
+    }
+    if (( i >= size ) || ( data[i] < '0' ) || ( data[i] > '9' )) return false;
+
+    for ( *value = 0; ( i < size ) && ( data[i] >= '0' ) && ( data[i] <= '9' );
+          i++ )
+    {
+        *value = *value * 10 + data[i] - '0';
+        if ( *value > 65535 ) return false;
+    }
+    *pos = i;
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Decodes P2, P3, P5 and P6 with any maximum value. Colour is converted
+    to luma with the Rec. 601 weights.
+*/
+// ----------------------------------------------------------------------------
+static int8_t ssd1322_art_pnm_decode( const uint8_t *data, size_t size,
+                                      struct ssd1322_art_image_t *image )
+{
+    uint32_t width, height, max, sample[3];
+    uint32_t luma, n, pixels;
+    uint8_t  channels, depth, c;
+    bool     ascii;
+    size_t   pos = 2;
+
+    if ( !ssd1322_art_pnm_probe( data, size )) return -1;
+    channels = (( data[1] == '3' ) || ( data[1] == '6' )) ? 3 : 1;
+    ascii    = ( data[1] == '2' ) || ( data[1] == '3' );
+
+    if ( !ssd1322_art_pnm_number( data, size, &pos, &width ) ||
+         !ssd1322_art_pnm_number( data, size, &pos, &height ) ||
+         !ssd1322_art_pnm_number( data, size, &pos, &max )) return -1;
+    if (( width == 0 ) || ( width > SSD1322_ART_SIZE_MAX ) ||
+        ( height == 0 ) || ( height > SSD1322_ART_SIZE_MAX ) ||
+        ( max == 0 )) return -1;
+
+    // A single white space character separates the header from binary data.
+    pixels = width * height;
+    depth  = ( max > 255 ) ? 2 : 1;
+    pos++;
+    if ( !ascii && ( size < pos + ( size_t )pixels * channels * depth ))
+        return -1;
+
+    image->grey = malloc( pixels );
+    if ( image->grey == NULL ) return -2;
+    image->width  = width;
+    image->height = height;
+
+    for ( n = 0; n < pixels; n++ )
+    {
+        for ( c = 0; c < channels; c++ )
+        {
+            if ( ascii )
+            {
+                if ( !ssd1322_art_pnm_number( data, size, &pos, &sample[c] ))
+                {
+                    free( image->grey );
+                    image->grey = NULL;
+                    return -1;
+                }
+                if ( sample[c] > max ) sample[c] = max;
+            }
+            else if ( depth == 2 )
+            {
+                sample[c] = data[pos] << 8 | data[pos + 1];
+                pos += 2;
+            }
+            else sample[c] = data[pos++];
+        }
+
+        luma = ( channels == 3 ) ?
+               77 * sample[0] + 150 * sample[1] + 29 * sample[2] :
+               256 * sample[0];
+        image->grey[n] = (( uint64_t )luma * 255 + max * 128 ) / ( max * 256 );
+    }
+
+    return 0;
+}
+
+static const struct ssd1322_art_decoder_t ssd1322_art_pnm =
+{
+    "pnm", ssd1322_art_pnm_probe, ssd1322_art_pnm_decode
+};
+
+// Registered decoders, most recent first.
+static const struct ssd1322_art_decoder_t *decoders[SSD1322_ART_DECODERS] =
+{
+    &ssd1322_art_pnm
+};
+static uint8_t decoder_count = 1;
+
+// ----------------------------------------------------------------------------
+/*
+    Adds a decoder, tried before those already registered.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_register( const struct ssd1322_art_decoder_t *decoder )
+{
+    if ( decoder_count >= SSD1322_ART_DECODERS ) return -1;
+
+    memmove( &decoders[1], &decoders[0],
+             decoder_count * sizeof( decoders[0] ));
+    decoders[0] = decoder;
+    decoder_count++;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Decodes a picture in memory to 8 bit greyscale.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_decode( const uint8_t *data, size_t size,
+                           struct ssd1322_art_image_t *image )
+{
+    uint8_t i;
+
+    image->grey = NULL;
+    for ( i = 0; i < decoder_count; i++ )
+        if ( decoders[i]->probe( data, size ))
+            return decoders[i]->decode( data, size, image );
+
+    return -1;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Scales a picture to fit width x height by area averaging.
+
+    Output pixel x spans [x * in, ( x + 1 ) * in) and input pixel i spans
+    [i * out, ( i + 1 ) * out) in the same units, so each input pixel is
+    weighted by the overlap and the weights of an output pixel sum to in.
+    Rows are scaled first into 12 bit intermediates, then columns.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_scale( const struct ssd1322_art_image_t *image,
+                          uint16_t width, uint16_t height, uint8_t *out )
+{
+    uint32_t iw = image->width, ih = image->height;
+    uint32_t fw, fh, ox, oy, x, y, i, start, end, lo, hi, sum;
+    uint16_t *rows;
+
+    // Fit to the box, keeping the aspect ratio.
+    if ( iw * height > ih * width )
+    {
+        fw = width;
+        fh = ( ih * width + iw / 2 ) / iw;
+    }
+    else
+    {
+        fh = height;
+        fw = ( iw * height + ih / 2 ) / ih;
+    }
+    if ( fw == 0 ) fw = 1;
+    if ( fh == 0 ) fh = 1;
+    ox = ( width - fw ) / 2;
+    oy = ( height - fh ) / 2;
+
+    rows = malloc( ih * fw * sizeof( uint16_t ));
+    if ( rows == NULL ) return -2;
+
+    for ( y = 0; y < ih; y++ )
+    {
+        const uint8_t *in = &image->grey[y * iw];
+
+        for ( x = 0; x < fw; x++ )
+        {
+            start = x * iw;
+            end   = start + iw;
+            for ( sum = 0, i = start / fw; i * fw < end; i++ )
+            {
+                lo = ( i * fw > start ) ? i * fw : start;
+                hi = (( i + 1 ) * fw < end ) ? ( i + 1 ) * fw : end;
+                sum += ( hi - lo ) * in[i];
+            }
+            rows[y * fw + x] = ( sum * 16 + iw / 2 ) / iw;
+        }
+    }
+
+    memset( out, 0, width * height );
+    for ( y = 0; y < fh; y++ )
+    {
+        start = y * ih;
+        end   = start + ih;
+        for ( x = 0; x < fw; x++ )
+        {
+            for ( sum = 0, i = start / fh; i * fh < end; i++ )
+            {
+                lo = ( i * fh > start ) ? i * fh : start;
+                hi = (( i + 1 ) * fh < end ) ? ( i + 1 ) * fh : end;
+                sum += ( hi - lo ) * rows[i * fw + x];
+            }
+            out[( oy + y ) * width + ox + x] = ( sum + ih * 8 ) / ( ih * 16 );
+        }
+    }
+    free( rows );
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Dithers 8 bit greys to 16 greys with Floyd-Steinberg error diffusion.
+
+    Rows are scanned in alternate directions so that the error doesn't
+    build up into diagonal streaks. Errors are kept in 1/16ths.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_dither( const uint8_t *grey, uint16_t width,
+                           uint16_t height, uint8_t *packed )
+{
+    uint16_t stride = ( width + 1 ) / 2;
+    int32_t *error, *this, *next, *swap;
+    int32_t  value, level, e;
+    int32_t  x, dir;
+    uint16_t y, n;
+    uint8_t *byte;
+
+    error = calloc( 2 * ( width + 2 ), sizeof( int32_t ));
+    if ( error == NULL ) return -2;
+    this = &error[1];
+    next = &error[width + 3];
+
+    memset( packed, 0, stride * height );
+    for ( y = 0; y < height; y++ )
+    {
+        dir = ( y & 1 ) ? -1 : 1;
+        for ( n = 0; n < width; n++ )
+        {
+            x = ( dir > 0 ) ? n : width - 1 - n;
+
+            value = ( grey[y * width + x] * 16 + this[x] + 8 ) >> 4;
+            if ( value < 0 ) value = 0;
+            if ( value > 255 ) value = 255;
+            level = ( value * 15 + 127 ) / 255;
+            e = value - level * 17;
+
+            this[x + dir] += e * 7;
+            next[x - dir] += e * 3;
+            next[x]       += e * 5;
+            next[x + dir] += e;
+
+            byte = &packed[y * stride + x / 2];
+            *byte |= ( x & 1 ) ? level : level << 4;
+        }
+
+        swap = this;
+        this = next;
+        next = swap;
+        memset( next - 1, 0, ( width + 2 ) * sizeof( int32_t ));
+    }
+    free( error );
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the 64 bit FNV-1a hash of data.
+*/
+// ----------------------------------------------------------------------------
+uint64_t ssd1322_art_hash( const uint8_t *data, size_t size )
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    size_t   i;
+
+    for ( i = 0; i < size; i++ )
+    {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a cache in directory dir, which is made if it doesn't exist.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_cache_init( struct ssd1322_art_cache_t *cache,
+                               const char *dir, uint64_t limit )
+{
+    struct stat st;
+
+    memset( cache, 0, sizeof( struct ssd1322_art_cache_t ));
+    if ( strlen( dir ) >= SSD1322_ART_PATH ) return -1;
+    strcpy( cache->dir, dir );
+    cache->limit = ( limit > 0 ) ? limit : SSD1322_ART_LIMIT;
+
+    if (( mkdir( dir, 0755 ) < 0 ) && ( errno != EEXIST )) return -1;
+    if (( stat( dir, &st ) < 0 ) || !S_ISDIR( st.st_mode )) return -1;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Maps a cached picture, checking that it is whole and the right size.
+*/
+// ----------------------------------------------------------------------------
+static int8_t ssd1322_art_map( const char *path, uint16_t width,
+                               uint16_t height, struct ssd1322_art_t *art )
+{
+    const struct ssd1322_art_header_t *header;
+    struct stat st;
+    size_t size = sizeof( struct ssd1322_art_header_t ) +
+                  ( width + 1 ) / 2 * height;
+    void  *map;
+    int    fd;
+
+    fd = open( path, O_RDONLY );
+    if ( fd < 0 ) return -1;
+    if (( fstat( fd, &st ) < 0 ) || ( st.st_size != ( off_t )size ))
+    {
+        close( fd );
+        return -1;
+    }
+    map = mmap( NULL, size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( map == MAP_FAILED ) return -1;
+
+    header = map;
+    if (( memcmp( header->magic, SSD1322_ART_MAGIC, 4 ) != 0 ) ||
+        ( header->width != width ) || ( header->height != height ))
+    {
+        munmap( map, size );
+        return -1;
+    }
+
+    art->width  = width;
+    art->height = height;
+    art->packed = ( const uint8_t * )( header + 1 );
+    art->base   = map;
+    art->size   = size;
+    art->mapped = true;
+
+    return 0;
+}
+
+// Cache file paths, directory, file name and a temporary suffix.
+#define SSD1322_ART_FILE ( SSD1322_ART_PATH + SSD1322_ART_NAME + 16 )
+
+// Cache file, for eviction.
+struct ssd1322_art_entry_t
+{
+    char   name[SSD1322_ART_NAME];
+    time_t mtime;
+    off_t  size;
+};
+
+// ----------------------------------------------------------------------------
+/*
+    Orders cache files oldest first.
+*/
+// ----------------------------------------------------------------------------
+static int ssd1322_art_older( const void *a, const void *b )
+{
+    const struct ssd1322_art_entry_t *ea = a, *eb = b;
+
+    return ( ea->mtime > eb->mtime ) - ( ea->mtime < eb->mtime );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Removes the least recently used pictures until the cache fits its
+    limit, never removing keep.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_art_evict( struct ssd1322_art_cache_t *cache,
+                               const char *keep )
+{
+    struct ssd1322_art_entry_t *entries = NULL, *more;
+    struct dirent *file;
+    struct stat    st;
+    char     path[SSD1322_ART_FILE];
+    uint32_t count = 0, space = 0, i;
+    uint64_t total = 0;
+    size_t   length;
+    DIR     *dir;
+
+    dir = opendir( cache->dir );
+    if ( dir == NULL ) return;
+
+    while (( file = readdir( dir )) != NULL )
+    {
+        length = strlen( file->d_name );
+        if (( length < 4 ) || ( length >= sizeof( entries->name )) ||
+            ( strcmp( &file->d_name[length - 4], ".art" ) != 0 )) continue;
+        snprintf( path, sizeof( path ), "%s/%s", cache->dir, file->d_name );
+        if ( stat( path, &st ) < 0 ) continue;
+
+        if ( count == space )
+        {
+            space = ( space > 0 ) ? space * 2 : 64;
+            more  = realloc( entries, space * sizeof( *entries ));
+            if ( more == NULL ) break;
+            entries = more;
+        }
+        strcpy( entries[count].name, file->d_name );
+        entries[count].mtime = st.st_mtime;
+        entries[count].size  = st.st_size;
+        total += st.st_size;
+        count++;
+    }
+    closedir( dir );
+
+    if ( total > cache->limit )
+    {
+        qsort( entries, count, sizeof( *entries ), ssd1322_art_older );
+        for ( i = 0; ( i < count ) && ( total > cache->limit ); i++ )
+        {
+            if ( strcmp( entries[i].name, keep ) == 0 ) continue;
+            snprintf( path, sizeof( path ), "%s/%s",
+                      cache->dir, entries[i].name );
+            if ( unlink( path ) < 0 ) continue;
+            total -= entries[i].size;
+            cache->evicted++;
+        }
+    }
+    free( entries );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Writes a new picture to the cache. It is written under a temporary
+    name and renamed, so a reader never maps half a picture.
+*/
+// ----------------------------------------------------------------------------
+static int8_t ssd1322_art_store( struct ssd1322_art_cache_t *cache,
+                                 const char *name, const void *base,
+                                 size_t size )
+{
+    char    path[SSD1322_ART_FILE], temp[SSD1322_ART_FILE];
+    ssize_t done;
+    int     fd;
+
+    snprintf( path, sizeof( path ), "%s/%s", cache->dir, name );
+    snprintf( temp, sizeof( temp ), "%s/.%s.%d", cache->dir, name,
+              ( int )getpid());
+
+    fd = open( temp, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if ( fd < 0 ) return -1;
+    done = write( fd, base, size );
+    close( fd );
+    if (( done != ( ssize_t )size ) || ( rename( temp, path ) < 0 ))
+    {
+        unlink( temp );
+        return -1;
+    }
+
+    ssd1322_art_evict( cache, name );
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Loads the picture in file path fitted to width x height.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_load( struct ssd1322_art_cache_t *cache, const char *path,
+                         uint16_t width, uint16_t height,
+                         struct ssd1322_art_t *art )
+{
+    struct ssd1322_art_image_t  image;
+    struct ssd1322_art_header_t *header;
+    struct stat st;
+    char     name[SSD1322_ART_NAME], file[SSD1322_ART_FILE];
+    uint8_t *data, *grey, *base;
+    size_t   size;
+    int8_t   err;
+    int      fd;
+
+    memset( art, 0, sizeof( struct ssd1322_art_t ));
+    if (( width == 0 ) || ( height == 0 )) return -1;
+
+    fd = open( path, O_RDONLY );
+    if ( fd < 0 ) return -1;
+    if (( fstat( fd, &st ) < 0 ) || ( st.st_size == 0 ))
+    {
+        close( fd );
+        return -1;
+    }
+    data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( data == MAP_FAILED ) return -1;
+
+    snprintf( name, sizeof( name ), "%016llx-%ux%u.art",
+              ( unsigned long long )ssd1322_art_hash( data, st.st_size ),
+              width, height );
+
+    if ( cache != NULL )
+    {
+        snprintf( file, sizeof( file ), "%s/%s", cache->dir, name );
+        if ( ssd1322_art_map( file, width, height, art ) == 0 )
+        {
+            munmap( data, st.st_size );
+            utimensat( AT_FDCWD, file, NULL, 0 );
+            cache->hits++;
+            return 0;
+        }
+        cache->misses++;
+    }
+
+    err = ssd1322_art_decode( data, st.st_size, &image );
+    munmap( data, st.st_size );
+    if ( err < 0 ) return err;
+
+    size = sizeof( struct ssd1322_art_header_t ) + ( width + 1 ) / 2 * height;
+    grey = malloc( width * height );
+    base = malloc( size );
+    if (( grey == NULL ) || ( base == NULL ))
+    {
+        free( image.grey );
+        free( grey );
+        free( base );
+        return -2;
+    }
+
+    header = ( struct ssd1322_art_header_t * )base;
+    memcpy( header->magic, SSD1322_ART_MAGIC, 4 );
+    header->width  = width;
+    header->height = height;
+
+    err = ssd1322_art_scale( &image, width, height, grey );
+    if ( err == 0 ) err = ssd1322_art_dither( grey, width, height,
+                                              ( uint8_t * )( header + 1 ));
+    free( image.grey );
+    free( grey );
+    if ( err < 0 )
+    {
+        free( base );
+        return err;
+    }
+
+    // Map the cached copy so the picture costs no heap, or keep the
+    // allocation if the cache can't be written.
+    if (( cache != NULL ) &&
+        ( ssd1322_art_store( cache, name, base, size ) == 0 ) &&
+        ( ssd1322_art_map( file, width, height, art ) == 0 ))
+    {
+        free( base );
+        return 0;
+    }
+
+    art->width  = width;
+    art->height = height;
+    art->packed = ( const uint8_t * )( header + 1 );
+    art->base   = base;
+    art->size   = size;
+    art->mapped = false;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws a loaded picture in the framebuffer of display id.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_draw( uint8_t id, uint16_t x, uint8_t y,
+                         const struct ssd1322_art_t *art )
+{
+    if (( art->packed == NULL ) || ( art->height > SSD1322_ROWS )) return -1;
+
+    return ssd1322_fb_draw_packed( id, x, y, art->width, art->height,
+                                   art->packed );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Unmaps or frees a loaded picture.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_art_close( struct ssd1322_art_t *art )
+{
+    if ( art->base != NULL )
+    {
+        if ( art->mapped ) munmap( art->base, art->size );
+        else free( art->base );
+    }
+    memset( art, 0, sizeof( struct ssd1322_art_t ));
+}
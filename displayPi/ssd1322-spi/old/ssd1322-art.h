@@ -0,0 +1,207 @@
+//  ===========================================================================
+/*
+    ssd1322-art:
+
+    Album art decode, scale, dither and cache for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef SSD1322ART_H
+#define SSD1322ART_H
+
+// Info -----------------------------------------------------------------------
+/*
+    Decoding and scaling cover art is far slower on a Pi Zero than drawing
+    it, so each picture is only converted once. The pipeline is
+
+        file --> decode --> area average --> Floyd-Steinberg --> 4bpp
+                 (grey)     (fit to box)     (16 greys)          (cache)
+
+    and the packed result is kept in a cache directory, named after a hash
+    of the file contents and the size of the box. Playing the same album
+    again only hashes the file, maps the cached picture and copies it into
+    the framebuffer.
+
+    Decoders are found by probing the first bytes of a file, so formats can
+    be added with ssd1322_art_register without changing the pipeline. A
+    PNM decoder (PGM and PPM, ASCII and binary) is built in, so anything
+    else can be converted beforehand, e.g. with djpeg -pnm.
+
+    The area average weights every source pixel by how much of it lies in
+    each output pixel, so no detail is skipped when shrinking a 500 pixel
+    cover to 64 pixels. Pictures keep their aspect ratio and are centred in
+    the box on black.
+
+    Each cached picture is a small header followed by packed rows, ready to
+    copy. A hit touches the file's modification time, and after each new
+    picture the oldest files are removed until the directory fits its size
+    limit, so the cache is least recently used.
+*/
+
+// Macros. --------------------------------------------------------------------
+
+#define SSD1322_ART_DECODERS  4       // Decoders that can be registered.
+#define SSD1322_ART_SIZE_MAX  8192    // Largest width or height decoded.
+#define SSD1322_ART_PATH      256     // Longest cache directory.
+#define SSD1322_ART_NAME      40      // Longest cache file name.
+#define SSD1322_ART_LIMIT     1048576 // Default cache size (bytes).
+#define SSD1322_ART_MAGIC     "S4BP"  // Cache file signature.
+
+// Data structures. -----------------------------------------------------------
+
+// 8 bit greyscale picture, one byte per pixel.
+struct ssd1322_art_image_t
+{
+    uint16_t width;
+    uint16_t height;
+    uint8_t *grey;
+};
+
+struct ssd1322_art_decoder_t
+{
+    const char *name;
+    bool      ( *probe )( const uint8_t *data, size_t size );
+    int8_t    ( *decode )( const uint8_t *data, size_t size,
+                           struct ssd1322_art_image_t *image );
+};
+
+struct ssd1322_art_header_t
+{
+    char     magic[4];
+    uint16_t width;
+    uint16_t height;
+};
+
+// Packed picture, mapped from the cache or allocated if it couldn't be
+// written there.
+struct ssd1322_art_t
+{
+    uint16_t       width;
+    uint16_t       height;
+    const uint8_t *packed;   // ( width + 1 ) / 2 bytes per row.
+    void          *base;     // Header and packed rows.
+    size_t         size;     // Bytes at base.
+    bool           mapped;   // base is mapped rather than allocated.
+};
+
+struct ssd1322_art_cache_t
+{
+    char     dir[SSD1322_ART_PATH];
+    uint64_t limit;          // Bytes of pictures kept.
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evicted;
+};
+
+// Functions. -----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*
+    Adds a decoder, tried before those already registered.
+
+    Returns 0 on success, -1 if there is no room.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_register( const struct ssd1322_art_decoder_t *decoder );
+
+// ----------------------------------------------------------------------------
+/*
+    Decodes a picture in memory to 8 bit greyscale.
+
+    image->grey is allocated and must be freed by the caller.
+    Returns 0 on success, -1 if no decoder accepts the data, -2 if out of
+    memory.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_decode( const uint8_t *data, size_t size,
+                           struct ssd1322_art_image_t *image );
+
+// ----------------------------------------------------------------------------
+/*
+    Scales a picture to fit width x height by area averaging.
+
+    out holds width x height bytes. The picture keeps its aspect ratio and
+    is centred, with the rest of out set to black.
+    Returns 0 on success, -2 if out of memory.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_scale( const struct ssd1322_art_image_t *image,
+                          uint16_t width, uint16_t height, uint8_t *out );
+
+// ----------------------------------------------------------------------------
+/*
+    Dithers 8 bit greys to 16 greys with Floyd-Steinberg error diffusion.
+
+    packed holds ( width + 1 ) / 2 bytes per row.
+    Returns 0 on success, -2 if out of memory.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_dither( const uint8_t *grey, uint16_t width,
+                           uint16_t height, uint8_t *packed );
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the 64 bit FNV-1a hash of data.
+*/
+// ----------------------------------------------------------------------------
+uint64_t ssd1322_art_hash( const uint8_t *data, size_t size );
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a cache in directory dir, which is made if it doesn't exist.
+
+    limit is the size of the cache in bytes, 0 for SSD1322_ART_LIMIT.
+    Returns 0 on success, -1 if the directory can't be made.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_cache_init( struct ssd1322_art_cache_t *cache,
+                               const char *dir, uint64_t limit );
+
+// ----------------------------------------------------------------------------
+/*
+    Loads the picture in file path fitted to width x height.
+
+    The cached copy is used if there is one, otherwise the file is decoded,
+    scaled, dithered and added to the cache. cache may be NULL to convert
+    without caching.
+    Returns 0 on success, -1 if the file can't be read or decoded, -2 if
+    out of memory.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_load( struct ssd1322_art_cache_t *cache, const char *path,
+                         uint16_t width, uint16_t height,
+                         struct ssd1322_art_t *art );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws a loaded picture in the framebuffer of display id.
+
+    Returns 0 on success, -1 if it doesn't fit.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_art_draw( uint8_t id, uint16_t x, uint8_t y,
+                         const struct ssd1322_art_t *art );
+
+// ----------------------------------------------------------------------------
+/*
+    Unmaps or frees a loaded picture.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_art_close( struct ssd1322_art_t *art );
+
+#endif
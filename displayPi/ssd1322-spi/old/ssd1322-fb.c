@@ -20,276 +20,525 @@
     along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 //  ===========================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+
+// Framebuffers.
+struct ssd1322_fb_t *ssd1322_fb[SSD1322_DISPLAYS_MAX];
+
+// Ticket lock for the shared SPI bus.
+static struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t  turn;
+    uint32_t        next;    // Next ticket to hand out.
+    uint32_t        serving; // Ticket that owns the bus.
+} ssd1322_bus =
+{
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0
+};
+
+// ----------------------------------------------------------------------------
 /*
-    Compile with:
+    Returns monotonic time in microseconds.
+*/
+// ----------------------------------------------------------------------------
+static uint64_t ssd1322_fb_time( void )
+{
+    struct timespec now;
 
-    gcc ssd1322-fb.c ssd1322-spi.c -Wall -o test-ssd1322 -lpigpio
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( uint64_t )now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
 
-    Also use the following flags for Raspberry Pi optimisation:
-        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
-        -ffast-math -pipe -O3
+// ----------------------------------------------------------------------------
+/*
+    Waits for and takes ownership of the SPI bus (ticket lock).
 */
-// Info -----------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+void ssd1322_bus_acquire( void )
+{
+    uint32_t ticket;
+
+    pthread_mutex_lock( &ssd1322_bus.lock );
+    ticket = ssd1322_bus.next++;
+    while ( ticket != ssd1322_bus.serving )
+        pthread_cond_wait( &ssd1322_bus.turn, &ssd1322_bus.lock );
+    pthread_mutex_unlock( &ssd1322_bus.lock );
+}
+
+// ----------------------------------------------------------------------------
 /*
-        Configuration used.
-
-    ---------------------------------------------------------------------GND
-                                            |                   |
-                 RPi                        |                   |
-                 1 2                        |                   |
-                [o o]                       |                   |
-                [o o]                       |      SSD1322      |
-                [o o]                       |        1 2        |
-                [o o]                       |----GND[o o]+5V----(-----------,
-                [o o]                       |       [o o]SCLK---(-------,   |
-                [o o]                   ,---(---SDIN[o o]       |       |   |
-                [o o]                   |   |-------[o o]-------|       |   |
-                [o o]GPIO23-----,       |   |-------[o o]-------|       |   |
-                [o o]GPIO24-----(---,   |   |-------[o o]-------'       |   |
-    ,-------MOSI[o o]           |   |   |   '--- WR#[o o]DC#--------,   |   |
-    |           [o o]           |   '---(-----RESET#[o o]CS#----,   |   |   |
-    |   ,---SCLK[o o]CE0----,   |       |            2 1        |   |   |   |
-    |   |       [o o]       |   |       |                       |   |   |   |
-    |   |       25 26       '---(-------|-----------------------'   |   |   |
-    |   |                       |       |                           |   |   |
-    |   |                       '-------(---------------------------'   |   |
-    |   |                               |                               |   |
-    |   '-------------------------------(-------------------------------'   |
-    |                                   |                                   |
-    '-----------------------------------'               ,-------------------'
-                                                        |
-    ---------------------------------------------------------------------+5V
+    Releases the SPI bus to the next waiting thread.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_bus_release( void )
+{
+    pthread_mutex_lock( &ssd1322_bus.lock );
+    ssd1322_bus.serving++;
+    pthread_cond_broadcast( &ssd1322_bus.turn );
+    pthread_mutex_unlock( &ssd1322_bus.lock );
+}
 
+// ----------------------------------------------------------------------------
+/*
+    Sends dirty rectangles of the copy to the display in bands. Full width
+    rectangles are sent straight from the copy, narrower ones are gathered
+    into one run per band for the column window. Returns bytes sent.
 */
+// ----------------------------------------------------------------------------
+static uint32_t ssd1322_fb_flush( struct ssd1322_fb_t *fb,
+                                  const struct ssd1322_fb_rect_t *rects,
+                                  uint8_t count )
+{
+    uint8_t   run[SSD1322_FB_BAND_ROWS * SSD1322_FB_ROW_BYTES];
+    const struct ssd1322_fb_rect_t *rect;
+    uint8_t  *data;
+    uint16_t  bytes, row, rows, j;
+    uint32_t  bands = 0, sent = 0;
+    uint64_t  start, wait = 0;
+    uint8_t   i;
+
+    for ( i = 0; i < count; i++ )
+    {
+        rect  = &rects[i];
+        bytes = ( rect->x1 - rect->x0 + 1 ) / 2;
 
-#include <stdio.h>
-#include <stdint.h>
-#include <pigpio.h>
-#include <pthread.h>
-#include <stdlib.h>
+        for ( row = rect->y0; row <= rect->y1; row += rows )
+        {
+            rows = rect->y1 - row + 1;
+            if ( rows > SSD1322_FB_BAND_ROWS ) rows = SSD1322_FB_BAND_ROWS;
+
+            data = &fb->frame[row * SSD1322_FB_ROW_BYTES + rect->x0 / 2];
+            if ( bytes < SSD1322_FB_ROW_BYTES )
+            {
+                for ( j = 0; j < rows; j++ )
+                    memcpy( &run[j * bytes],
+                            &data[j * SSD1322_FB_ROW_BYTES], bytes );
+                data = run;
+            }
+
+            start = ssd1322_fb_time();
+            ssd1322_bus_acquire();
+            wait += ssd1322_fb_time() - start;
+
+            ssd1322_set_cols( fb->id, rect->x0, rect->x1 );
+            ssd1322_set_rows( fb->id, row, row + rows - 1 );
+            ssd1322_write_stream( fb->id, data, rows * bytes );
+
+            ssd1322_bus_release();
+            bands++;
+            sent += rows * bytes;
+        }
+    }
 
-#include "ssd1322-spi.h"
-#include "graphics.h"
+    pthread_mutex_lock( &fb->lock );
+    if ( bands > 0 ) fb->stats.bus_wait = wait / bands;
+    pthread_mutex_unlock( &fb->lock );
+
+    return sent;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Writes framebuffer to display via SPI interface at the target frame rate.
+*/
+// ----------------------------------------------------------------------------
+static void *ssd1322_fb_write( void *params )
+{
+    struct ssd1322_fb_t *fb = params;
+    struct ssd1322_fb_rect_t rects[SSD1322_FB_RECTS];
+    struct timespec deadline;
+    uint64_t start, now, window;
+    uint32_t frames = 0;
+    uint32_t period, sent = 0;
+    uint16_t row;
+    uint8_t  count = 0, i;
+    bool     send;
+
+    clock_gettime( CLOCK_MONOTONIC, &deadline );
+    window = ssd1322_fb_time();
+
+    while ( !fb->kill )
+    {
+        // Take a consistent copy of the dirty rectangles so drawing can
+        // continue during the flush.
+        pthread_mutex_lock( &fb->lock );
+        send = fb->dirty;
+        if ( send )
+        {
+            count = fb->rect_count;
+            memcpy( rects, fb->rects, count * sizeof( rects[0] ));
+            for ( i = 0; i < count; i++ )
+                for ( row = rects[i].y0; row <= rects[i].y1; row++ )
+                    memcpy( &fb->frame[row * SSD1322_FB_ROW_BYTES +
+                                       rects[i].x0 / 2],
+                            &fb->buffer[row * SSD1322_FB_ROW_BYTES +
+                                        rects[i].x0 / 2],
+                            ( rects[i].x1 - rects[i].x0 + 1 ) / 2 );
+        }
+        fb->dirty      = false;
+        fb->rect_count = 0;
+        period = 1000000 / fb->fps;
+        pthread_mutex_unlock( &fb->lock );
+
+        if ( send )
+        {
+            start = ssd1322_fb_time();
+            sent = ssd1322_fb_flush( fb, rects, count );
+            now = ssd1322_fb_time();
+            frames++;
+        }
 
-// SSD1322 supports 480x128 but display is 256x64.
-#define COLS_VIS_MIN 0x00 // Visible cols - start.
-#define COLS_VIS_MAX 0x3f // Visible cols - end.
-#define ROWS_VIS_MIN 0x00 // Visible rows - start.
-#define ROWS_VIS_MAX 0x3f // Visible rows - end.
+        pthread_mutex_lock( &fb->lock );
+        if ( send )
+        {
+            fb->stats.flush_last = now - start;
+            if ( fb->stats.flush_last > fb->stats.flush_max )
+                fb->stats.flush_max = fb->stats.flush_last;
+            if ( fb->stats.frames == 0 )
+                fb->stats.flush_avg = fb->stats.flush_last;
+            else fb->stats.flush_avg = ( fb->stats.flush_avg * 7 +
+                                         fb->stats.flush_last ) / 8;
+            fb->stats.frames++;
+            fb->stats.bytes += sent;
+        }
+        else fb->stats.skipped++;
 
-// Display buffer.
-uint8_t *ssd1322_fb[SSD1322_DISPLAYS_MAX];
+        // Achieved frame rate, updated once a second.
+        now = ssd1322_fb_time();
+        if ( now - window >= 1000000 )
+        {
+            fb->stats.fps = frames * 1000000.0 / ( now - window );
+            frames = 0;
+            window = now;
+        }
+        pthread_mutex_unlock( &fb->lock );
 
-// Mutex for locking updates to FB while buffer is being written to display.
-pthread_mutex_t ssd1322_display_busy;
+        // Sleep until the next absolute deadline. If it has already passed,
+        // count it and start again from now rather than trying to catch up.
+        deadline.tv_nsec += period * 1000;
+        while ( deadline.tv_nsec >= 1000000000 )
+        {
+            deadline.tv_nsec -= 1000000000;
+            deadline.tv_sec++;
+        }
+        if ( ssd1322_fb_time() >
+             ( uint64_t )deadline.tv_sec * 1000000 + deadline.tv_nsec / 1000 )
+        {
+            pthread_mutex_lock( &fb->lock );
+            fb->stats.late++;
+            pthread_mutex_unlock( &fb->lock );
+            clock_gettime( CLOCK_MONOTONIC, &deadline );
+        }
+        else clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL );
+    }
 
-uint8_t ssd1322_fb_kill = 0;
+    pthread_exit( NULL );
+}
 
-// Structure for passing parameters through pthread void function.
-struct ssd1322_display_struct
+// ----------------------------------------------------------------------------
+/*
+    Initialises framebuffer for display id and starts its flush thread.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_fb_init( uint8_t id, uint16_t fps )
 {
-    uint8_t id;
-};
+    struct ssd1322_fb_t *fb;
+
+    if (( id >= SSD1322_DISPLAYS_MAX ) || ( ssd1322[id] == NULL ) ||
+        ( ssd1322_fb[id] != NULL )) return -1;
+
+    fb = calloc( 1, sizeof( struct ssd1322_fb_t ));
+    if ( fb == NULL ) return -2;
+
+    fb->id = id;
+    pthread_mutex_init( &fb->lock, NULL );
+    ssd1322_fb_mark_dirty_locked( fb, 0, 0, SSD1322_COLS, SSD1322_ROWS );
+    ssd1322_fb[id] = fb;
+    ssd1322_fb_set_fps( id, fps );
+
+    if ( pthread_create( &fb->thread, NULL, ssd1322_fb_write, fb ) != 0 )
+    {
+        pthread_mutex_destroy( &fb->lock );
+        ssd1322_fb[id] = NULL;
+        free( fb );
+        return -2;
+    }
+
+    return 0;
+}
 
 // ----------------------------------------------------------------------------
 /*
-    Initialises framebuffer.
+    Sets the frame rate target for display id.
 */
 // ----------------------------------------------------------------------------
-int8_t ssd1322_fb_init( uint8_t id )
+void ssd1322_fb_set_fps( uint8_t id, uint16_t fps )
 {
-    ssd1322_fb[id] = malloc ( sizeof( uint8_t) * SSD1322_COLS * SSD1322_ROWS );
-    if ( ssd1322_fb == NULL ) return -1;
-    else return 0;
+    if ( fps < 1 ) fps = 1;
+    if ( fps > SSD1322_FB_FPS_MAX ) fps = SSD1322_FB_FPS_MAX;
+
+    pthread_mutex_lock( &ssd1322_fb[id]->lock );
+    ssd1322_fb[id]->fps = fps;
+    pthread_mutex_unlock( &ssd1322_fb[id]->lock );
 }
 
 // ----------------------------------------------------------------------------
 /*
-    Writes framebuffer to display via SPI interface.
+    Copies flush statistics for display id.
 */
 // ----------------------------------------------------------------------------
-void *ssd1322_fb_write( void *params )
+void ssd1322_fb_get_stats( uint8_t id, struct ssd1322_fb_stats_t *stats )
 {
-    // Get parameters through void.
-    struct ssd1322_display_struct *display = params;
+    pthread_mutex_lock( &ssd1322_fb[id]->lock );
+    *stats = ssd1322_fb[id]->stats;
+    pthread_mutex_unlock( &ssd1322_fb[id]->lock );
+}
 
-    uint16_t i;
-    uint8_t  data;
-    uint8_t id;
+// ----------------------------------------------------------------------------
+/*
+    Marks a rectangle of the framebuffer for sending, with fb->lock held.
 
-    id = display->id;
-    ssd1322_set_cols( id, 0, 255);
-    ssd1322_set_rows( id, 0, 63 );
-    ssd1322_set_write_continuous( id );
+    The new rectangle absorbs any it overlaps or touches, repeating until
+    it is clear of the rest. If the list is full, everything is merged
+    into a single bounding rectangle.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_mark_dirty_locked( struct ssd1322_fb_t *fb, uint16_t x,
+                                   uint8_t y, uint16_t dx, uint8_t dy )
+{
+    struct ssd1322_fb_rect_t rect, *other;
+    uint8_t i;
 
-    while ( !ssd1322_fb_kill )
+    if (( dx == 0 ) || ( dy == 0 ) ||
+        ( x >= SSD1322_COLS ) || ( y >= SSD1322_ROWS )) return;
+    if ( x + dx > SSD1322_COLS ) dx = SSD1322_COLS - x;
+    if ( y + dy > SSD1322_ROWS ) dy = SSD1322_ROWS - y;
+
+    rect.x0 = x & ~3;
+    rect.x1 = ( x + dx - 1 ) | 3;
+    rect.y0 = y;
+    rect.y1 = y + dy - 1;
+
+    i = 0;
+    while ( i < fb->rect_count )
     {
-        pthread_mutex_lock( &ssd1322_display_busy );
-        for ( i = 0; i < SSD1322_COLS * SSD1322_ROWS / 2; i++ )
+        other = &fb->rects[i];
+        if (( rect.x0 <= other->x1 + 1 ) && ( other->x0 <= rect.x1 + 1 ) &&
+            ( rect.y0 <= other->y1 + 1 ) && ( other->y0 <= rect.y1 + 1 ))
         {
-            data = ssd1322_fb[id][i*2] << 4 | ssd1322_fb[id][i*2+1];
-            ssd1322_write_data( id, data );
-//            gpioDelay( 1000 );
+            if ( other->x0 < rect.x0 ) rect.x0 = other->x0;
+            if ( other->x1 > rect.x1 ) rect.x1 = other->x1;
+            if ( other->y0 < rect.y0 ) rect.y0 = other->y0;
+            if ( other->y1 > rect.y1 ) rect.y1 = other->y1;
+            *other = fb->rects[--fb->rect_count];
+            i = 0;
         }
-        pthread_mutex_unlock( &ssd1322_display_busy );
-//        gpioDelay( 10000 );
+        else i++;
     }
 
-    printf( "Thread kill!\n" );
-//    gpioDelay( 1000000 );
-    pthread_exit( NULL );
+    if ( fb->rect_count == SSD1322_FB_RECTS )
+    {
+        for ( i = 0; i < fb->rect_count; i++ )
+        {
+            other = &fb->rects[i];
+            if ( other->x0 < rect.x0 ) rect.x0 = other->x0;
+            if ( other->x1 > rect.x1 ) rect.x1 = other->x1;
+            if ( other->y0 < rect.y0 ) rect.y0 = other->y0;
+            if ( other->y1 > rect.y1 ) rect.y1 = other->y1;
+        }
+        fb->rect_count = 0;
+    }
 
+    fb->rects[fb->rect_count++] = rect;
+    fb->dirty = true;
 }
 
 // ----------------------------------------------------------------------------
 /*
-    Fill the framebuffer.
+    Marks a rectangle of the framebuffer for sending.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_mark_dirty( uint8_t id, uint16_t x, uint8_t y,
+                            uint16_t dx, uint8_t dy )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+
+    pthread_mutex_lock( &fb->lock );
+    ssd1322_fb_mark_dirty_locked( fb, x, y, dx, dy );
+    pthread_mutex_unlock( &fb->lock );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Fills the framebuffer.
 */
 // ----------------------------------------------------------------------------
 void ssd1322_fb_fill_display( uint8_t id, uint8_t grey )
 {
-    uint16_t i;
-//    pthread_mutex_lock( &ssd1322_display_busy );
-    for ( i = 0; i < SSD1322_COLS * SSD1322_ROWS; i++ )
-        ssd1322_fb[ id ][ i ] = grey;
-//    pthread_mutex_unlock( &ssd1322_display_busy );
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+
+    grey &= 0x0f;
+    pthread_mutex_lock( &fb->lock );
+    memset( fb->buffer, grey << 4 | grey, SSD1322_FB_BYTES );
+    ssd1322_fb_mark_dirty_locked( fb, 0, 0, SSD1322_COLS, SSD1322_ROWS );
+    pthread_mutex_unlock( &fb->lock );
 }
 
 // ----------------------------------------------------------------------------
 /*
-    Draw a pixel in the framebuffer.
+    Sets a pixel in a packed buffer. Left pixel of each pair is the high
+    nibble.
+*/
+// ----------------------------------------------------------------------------
+static inline void ssd1322_fb_set_pixel( uint8_t *buffer, uint16_t x,
+                                         uint8_t y, uint8_t grey )
+{
+    uint8_t *byte = &buffer[y * SSD1322_FB_ROW_BYTES + x / 2];
+
+    if ( x & 1 ) *byte = ( *byte & 0xf0 ) | ( grey & 0x0f );
+    else         *byte = ( *byte & 0x0f ) | ( grey << 4 );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws a pixel in the framebuffer.
 */
 // ----------------------------------------------------------------------------
 void ssd1322_fb_draw_pixel( uint8_t id, uint8_t x, uint8_t y, uint8_t grey )
 {
-    printf( "\tx = %u, y = %u, i = %u.\n", x, y, y * SSD1322_COLS + x );
-//    pthread_mutex_lock( &ssd1322_display_busy );
-    ssd1322_fb[id][ y * SSD1322_COLS + x ] = grey;
-//    pthread_mutex_unlock( &ssd1322_display_busy );
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+
+    if ( y >= SSD1322_ROWS ) return;
+
+    pthread_mutex_lock( &fb->lock );
+    ssd1322_fb_set_pixel( fb->buffer, x, y, grey );
+    ssd1322_fb_mark_dirty_locked( fb, x, y, 1, 1 );
+    pthread_mutex_unlock( &fb->lock );
 }
 
 // ----------------------------------------------------------------------------
 /*
-    Draw a graphic in the framebuffer.
+    Draws a graphic in the framebuffer.
 */
 // ----------------------------------------------------------------------------
 int8_t ssd1322_fb_draw_image( uint8_t id, uint8_t x, uint8_t y,
                               uint16_t dx, uint8_t dy, uint8_t image[] )
 {
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
     uint16_t i, j, k;
 
     if ( x + dx > SSD1322_COLS ) return -1;
     if ( y + dy > SSD1322_ROWS ) return -1;
 
-    printf( "Drawing %ux%u graphic at %u,%u.\n", dx, dy, x, y );
-
     k = 0;
-//    pthread_mutex_lock( &ssd1322_display_busy );
+    pthread_mutex_lock( &fb->lock );
     for ( j = y; j < y + dy; j++ )
-    {
         for ( i = x; i < x + dx; i++ )
-        {
-            ssd1322_fb[id][ j * SSD1322_COLS + i ] = image[k];
-            k++;
-        }
-//    printf( "\n" );
-    }
-//    pthread_mutex_unlock( &ssd1322_display_busy );
+            ssd1322_fb_set_pixel( fb->buffer, i, j, image[k++] );
+    ssd1322_fb_mark_dirty_locked( fb, x, y, dx, dy );
+    pthread_mutex_unlock( &fb->lock );
 
-    printf( "i = %u, j = %u, k = %u.\n", i, j, k );
     return 0;
 }
 
 // ----------------------------------------------------------------------------
 /*
-    Main
+    Copies count packed pixels from pixel sx of src to pixel dx of dst.
+
+    When both offsets have the same parity, whole bytes are copied between
+    any odd pixels at the ends. Otherwise each byte is made from the low
+    nibble of one source byte and the high nibble of the next.
 */
 // ----------------------------------------------------------------------------
-int main()
+void ssd1322_fb_copy_packed( uint8_t *dst, uint16_t dx, const uint8_t *src,
+                             uint32_t sx, uint16_t count )
 {
-    uint8_t id;
-    int8_t err;
-    uint8_t i, j;
+    uint8_t  *out;
+    const uint8_t *in;
+    uint8_t   grey;
+    uint16_t  i, bytes;
 
-    err = ssd1322_init( GPIO_DC, GPIO_RESET, SPI_CHANNEL, SPI_BAUD, SPI_FLAGS );
+    if ( count == 0 ) return;
 
-    if ( err < 0 )
+    // Leading odd pixel, leaving dx even.
+    if ( dx & 1 )
     {
-        printf( "Init failed!\n" );
-        return -1;
-    }
-    else
-    {
-        id = err;
-        printf( "Init successful.\n" );
-        printf( "\tID   :%d\n", id );
-        printf( "\tSPI  :%d\n", ssd1322[id]->spi_handle );
-        printf( "\tDC   :%d\n", ssd1322[id]->gpio_dc );
-        printf( "\tRESET:%d\n", ssd1322[id]->gpio_reset );
+        grey = ( sx & 1 ) ? src[sx / 2] & 0x0f : src[sx / 2] >> 4;
+        dst[dx / 2] = ( dst[dx / 2] & 0xf0 ) | grey;
+        dx++;
+        sx++;
+        count--;
     }
 
-    ssd1322_clear_display( id );
+    out   = &dst[dx / 2];
+    in    = &src[sx / 2];
+    bytes = count / 2;
 
-    struct ssd1322_display_struct ssd1322_display =
+    if ( sx & 1 )
     {
-        .id = id
-    };
-
-    err = ssd1322_fb_init( id );
-    if ( err < 0 )
-    {
-        printf( "Couldn't allocate memory for framebuffer!\n" );
-        return -1;
+        for ( i = 0; i < bytes; i++ ) out[i] = in[i] << 4 | in[i + 1] >> 4;
+        if ( count & 1 ) out[i] = ( out[i] & 0x0f ) | in[i] << 4;
     }
     else
     {
-        printf( "Memory successfully allocated for framebuffer.\n" );
-    }
-
-    // Create thread for writing framebuffer to display.
-    pthread_mutex_init( &ssd1322_display_busy, NULL );
-    pthread_t threads[1];
-    pthread_create( &threads[0], NULL, ssd1322_fb_write, (void *) &ssd1322_display );
-
-    printf( "Drawing pixels - individuals.\n" );
-    ssd1322_fb_draw_pixel( id, 0, 0, 0x4 );
-    ssd1322_fb_draw_pixel( id, 255, 0, 0x4 );
-    ssd1322_fb_draw_pixel( id, 0, 63, 0x4 );
-    ssd1322_fb_draw_pixel( id, 255, 63, 0x4 );
-
-    printf( "Drawing graphic - fallout animation loop.\n" );
-    for ( i = 0; i < 5; i++ )
-    {
-        for ( j = 0; j < 7; j++ )
-        {
-            ssd1322_fb_draw_image( id, 20, 0, 64, 64, graphics_falloutOK[j] );
-            gpioDelay( 200000 );
-        }
+        memcpy( out, in, bytes );
+        if ( count & 1 ) out[bytes] = ( out[bytes] & 0x0f ) |
+                                      ( in[bytes] & 0xf0 );
     }
+}
 
-    printf( "Drawing graphic - Vault-Tec symbols.\n" );
-    ssd1322_fb_draw_image( id, 0, 0, 128, 64, graphics_vaultteclogo64 );
-    ssd1322_fb_draw_image( id, 192, 16, 64, 32, graphics_vaultteclogo32 );
-    gpioDelay( 200000 );
+// ----------------------------------------------------------------------------
+/*
+    Draws a packed graphic in the framebuffer.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_fb_draw_packed( uint8_t id, uint16_t x, uint8_t y,
+                               uint16_t dx, uint8_t dy,
+                               const uint8_t image[] )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+    uint16_t stride = ( dx + 1 ) / 2;
+    uint8_t  j;
 
-//    printf( "Drawing graphic - beach.\n" );
-//    ssd1322_fb_fill_display( id, 0 );
-//    gpioDelay( 100000 );
-//    ssd1322_fb_draw_image( id, 0, 0, 256, 64, graphics_beach );
-//    gpioDelay( 100000 );
+    if ( x + dx > SSD1322_COLS ) return -1;
+    if ( y + dy > SSD1322_ROWS ) return -1;
 
-    // Tell framebuffer thread to stop.
-    ssd1322_fb_kill = 1;
-    gpioDelay( 5000000 );
+    pthread_mutex_lock( &fb->lock );
+    for ( j = 0; j < dy; j++ )
+        ssd1322_fb_copy_packed( &fb->buffer[( y + j ) * SSD1322_FB_ROW_BYTES],
+                                x, &image[j * stride], 0, dx );
+    ssd1322_fb_mark_dirty_locked( fb, x, y, dx, dy );
+    pthread_mutex_unlock( &fb->lock );
 
-    // Gracefully stop framebuffer thread.
-    pthread_join( threads[0], NULL );
+    return 0;
+}
 
-    // Clean up threads.
-    pthread_mutex_destroy( &ssd1322_display_busy );
-//    pthread_exit( NULL );
+// ----------------------------------------------------------------------------
+/*
+    Stops the flush thread and frees the framebuffer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_close( uint8_t id )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
 
-    gpioTerminate();
+    if ( fb == NULL ) return;
 
-    return 0;
+    fb->kill = true;
+    pthread_join( fb->thread, NULL );
+    pthread_mutex_destroy( &fb->lock );
+    ssd1322_fb[id] = NULL;
+    free( fb );
 }
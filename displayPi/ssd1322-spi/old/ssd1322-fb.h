@@ -0,0 +1,219 @@
+//  ===========================================================================
+/*
+    ssd1322-fb:
+
+    Basic SSD1322 OLED display framebuffer driver for the Raspberry Pi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef SSD1322FB_H
+#define SSD1322FB_H
+
+// Info -----------------------------------------------------------------------
+/*
+    Each panel has its own framebuffer, lock and flush thread, so drawing on
+    one panel never waits for a flush of the other.
+
+    Panels on CE0 and CE1 share the SPI bus and usually the DC# line, so a
+    flush thread must own the bus from setting DC# until its transfer ends.
+    The bus is handed out with a ticket lock, which serves waiting threads
+    in arrival order. Frames are sent in bands of SSD1322_FB_BAND_ROWS rows,
+    taking a new ticket for each band, so two panels interleave band by band
+    and neither can hold the bus for a whole frame.
+
+        CE0  [band 0]        [band 1]        [band 2]        ...
+        CE1          [band 0]        [band 1]        [band 2] ...
+
+    Each flush thread wakes on an absolute deadline (fps target), copies the
+    framebuffer if it has changed and sends the copy. Unchanged frames are
+    not sent, so the fps target is an upper limit. Drawing only holds the
+    panel lock, never the bus.
+
+    Drawing marks the rectangles it touches as dirty, and only those are
+    copied and sent, each through its own column and row window. Column
+    addresses cover 4 pixels, so rectangles are widened to multiples of 4.
+    Rectangles that overlap or touch are merged as they are added, and if
+    there are more than SSD1322_FB_RECTS they are merged into one, so a
+    frame is never sent as many tiny windows.
+
+    Framebuffers are packed 4 bits per pixel as sent to the display, two
+    pixels per byte with the left pixel in the high nibble.
+*/
+
+// Macros. --------------------------------------------------------------------
+
+#define SSD1322_FB_BYTES     ( SSD1322_COLS * SSD1322_ROWS / 2 ) // 8192.
+#define SSD1322_FB_ROW_BYTES ( SSD1322_COLS / 2 )  // Bytes per row.
+#define SSD1322_FB_BAND_ROWS 8  // Rows sent per bus ticket.
+#define SSD1322_FB_FPS       25 // Default frame rate target.
+#define SSD1322_FB_FPS_MAX   60 // Maximum frame rate target.
+#define SSD1322_FB_RECTS     8  // Dirty rectangles kept per frame.
+
+// Data structures. -----------------------------------------------------------
+
+struct ssd1322_fb_stats_t
+{
+    uint32_t frames;     // Frames sent.
+    uint32_t skipped;    // Ticks with nothing to send.
+    uint32_t late;       // Ticks that missed their deadline.
+    uint64_t bytes;      // Bytes sent.
+    uint32_t flush_last; // Duration of last flush (us).
+    uint32_t flush_max;  // Longest flush (us).
+    uint32_t flush_avg;  // Average flush (us).
+    uint32_t bus_wait;   // Average wait for the bus per band (us).
+    float    fps;        // Frames sent per second over the last second.
+};
+
+// Dirty rectangle, inclusive. x0 is a multiple of 4 and x1 + 1 is too.
+struct ssd1322_fb_rect_t
+{
+    uint16_t x0;
+    uint16_t x1;
+    uint8_t  y0;
+    uint8_t  y1;
+};
+
+struct ssd1322_fb_t
+{
+    uint8_t         id;       // Display ID.
+    uint8_t         buffer[SSD1322_FB_BYTES]; // Framebuffer.
+    uint8_t         frame[SSD1322_FB_BYTES];  // Copy being sent.
+    pthread_mutex_t lock;     // Framebuffer lock.
+    pthread_t       thread;   // Flush thread.
+    volatile bool   kill;     // Stops flush thread.
+    bool            dirty;    // Framebuffer changed since last flush.
+    uint8_t         rect_count; // Dirty rectangles.
+    struct ssd1322_fb_rect_t rects[SSD1322_FB_RECTS];
+    uint16_t        fps;      // Frame rate target.
+    struct ssd1322_fb_stats_t stats; // Flush statistics.
+};
+
+extern struct ssd1322_fb_t *ssd1322_fb[SSD1322_DISPLAYS_MAX];
+
+// Functions. -----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*
+    Waits for and takes ownership of the SPI bus (ticket lock).
+
+    Anything else that writes to a display while flush threads are running
+    should hold the bus for the duration of each command or transfer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_bus_acquire( void );
+
+// ----------------------------------------------------------------------------
+/*
+    Releases the SPI bus to the next waiting thread.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_bus_release( void );
+
+// ----------------------------------------------------------------------------
+/*
+    Initialises framebuffer for display id and starts its flush thread.
+
+    fps is the frame rate target, 1 to SSD1322_FB_FPS_MAX.
+    Returns 0 on success, -1 if id is invalid, -2 if out of memory.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_fb_init( uint8_t id, uint16_t fps );
+
+// ----------------------------------------------------------------------------
+/*
+    Sets the frame rate target for display id.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_set_fps( uint8_t id, uint16_t fps );
+
+// ----------------------------------------------------------------------------
+/*
+    Copies flush statistics for display id.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_get_stats( uint8_t id, struct ssd1322_fb_stats_t *stats );
+
+// ----------------------------------------------------------------------------
+/*
+    Marks a rectangle of the framebuffer for sending.
+
+    For drawing directly into fb->buffer, which must be done holding
+    fb->lock. The _locked version is for callers already holding it.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_mark_dirty( uint8_t id, uint16_t x, uint8_t y,
+                            uint16_t dx, uint8_t dy );
+
+void ssd1322_fb_mark_dirty_locked( struct ssd1322_fb_t *fb, uint16_t x,
+                                   uint8_t y, uint16_t dx, uint8_t dy );
+
+// ----------------------------------------------------------------------------
+/*
+    Fills the framebuffer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_fill_display( uint8_t id, uint8_t grey );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws a pixel in the framebuffer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_draw_pixel( uint8_t id, uint8_t x, uint8_t y, uint8_t grey );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws a graphic in the framebuffer.
+
+    image is dx x dy greyscales, one byte per pixel (as in graphics.h).
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_fb_draw_image( uint8_t id, uint8_t x, uint8_t y,
+                              uint16_t dx, uint8_t dy, uint8_t image[] );
+
+// ----------------------------------------------------------------------------
+/*
+    Copies count packed pixels from pixel sx of src to pixel dx of dst.
+
+    Both are packed as the framebuffer. Pixels either side of the copy in
+    dst are kept, and odd offsets are shifted by a nibble.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_copy_packed( uint8_t *dst, uint16_t dx, const uint8_t *src,
+                             uint32_t sx, uint16_t count );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws a packed graphic in the framebuffer.
+
+    image is dx x dy greyscales packed as the framebuffer, each row
+    starting on a byte, i.e. ( dx + 1 ) / 2 bytes per row.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_fb_draw_packed( uint8_t id, uint16_t x, uint8_t y,
+                               uint16_t dx, uint8_t dy,
+                               const uint8_t image[] );
+
+// ----------------------------------------------------------------------------
+/*
+    Stops the flush thread and frees the framebuffer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_fb_close( uint8_t id );
+
+#endif
@@ -0,0 +1,110 @@
+//  ===========================================================================
+/*
+    ssd1322-font:
+
+    Proportional bitmap text for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "ssd1322-font.h"
+#include "font.h"
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the glyph for c and sets left to its first column and advance
+    to its width plus a column of space.
+*/
+// ----------------------------------------------------------------------------
+const uint8_t *ssd1322_font_glyph( char c, uint8_t *left, uint8_t *advance )
+{
+    const uint8_t *glyph;
+    uint8_t cols = 0, row;
+
+    *left    = 0;
+    *advance = SSD1322_FONT_SPACE;
+    if ( c == ' ' ) return NULL;
+    if (( c < FONT_FIRST ) || ( c > FONT_LAST )) c = '?';
+
+    glyph = font_8x20[c - FONT_FIRST];
+    for ( row = 0; row < FONT_HEIGHT; row++ ) cols |= glyph[row];
+    if ( cols == 0 ) return NULL;
+
+    *left    = __builtin_clz( cols << 24 );
+    *advance = FONT_WIDTH - __builtin_ctz( cols ) - *left + 1;
+
+    return glyph;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the width of text in pixels.
+*/
+// ----------------------------------------------------------------------------
+uint32_t ssd1322_font_measure( const char *text )
+{
+    uint32_t width = 0;
+    uint8_t  left, advance;
+
+    for ( ; *text; text++ )
+    {
+        ssd1322_font_glyph( *text, &left, &advance );
+        width += advance;
+    }
+
+    return width;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws text into a packed buffer with stride bytes per row.
+*/
+// ----------------------------------------------------------------------------
+uint32_t ssd1322_font_draw( uint8_t *buffer, uint16_t stride, uint32_t x,
+                            uint8_t y, uint32_t clip, const char *text,
+                            uint8_t grey )
+{
+    const uint8_t *glyph;
+    uint32_t px;
+    uint8_t *byte;
+    uint8_t  left, advance, row, col;
+
+    grey &= 0x0f;
+    for ( ; *text && ( x < clip ); text++, x += advance )
+    {
+        glyph = ssd1322_font_glyph( *text, &left, &advance );
+        if ( glyph == NULL ) continue;
+
+        for ( row = 0; row < FONT_HEIGHT; row++ )
+        {
+            if ( glyph[row] == 0 ) continue;
+            for ( col = left; col < FONT_WIDTH; col++ )
+            {
+                px = x + col - left;
+                if (( px >= clip ) || !( glyph[row] & ( 0x80 >> col )))
+                    continue;
+                byte = &buffer[( y + row ) * stride + px / 2];
+                *byte |= ( px & 1 ) ? grey : grey << 4;
+            }
+        }
+    }
+
+    return x;
+}
@@ -0,0 +1,75 @@
+//  ===========================================================================
+/*
+    ssd1322-font:
+
+    Proportional bitmap text for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef SSD1322FONT_H
+#define SSD1322FONT_H
+
+// Info -----------------------------------------------------------------------
+/*
+    Draws text with the 8x20 font in font.h into any buffer packed as the
+    framebuffer, e.g. the framebuffer itself or an off screen strip.
+
+    Glyphs are spaced by the columns they use plus one, so narrow letters
+    such as i and l don't leave gaps. Characters outside the font are
+    drawn as '?'.
+*/
+
+// Macros. --------------------------------------------------------------------
+
+#define SSD1322_FONT_HEIGHT 20 // Rows, as FONT_HEIGHT in font.h.
+#define SSD1322_FONT_SPACE  4  // Advance of a space.
+
+// Functions. -----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the glyph for c and sets left to its first column and advance
+    to its width plus a column of space.
+
+    Returns NULL for a space or an empty glyph.
+*/
+// ----------------------------------------------------------------------------
+const uint8_t *ssd1322_font_glyph( char c, uint8_t *left, uint8_t *advance );
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the width of text in pixels.
+*/
+// ----------------------------------------------------------------------------
+uint32_t ssd1322_font_measure( const char *text );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws text into a packed buffer with stride bytes per row, from pixel
+    x of row y. Pixels from clip onwards are not drawn. Only set pixels are
+    written, so clear the area first.
+
+    Returns the pixel after the text, or after the last glyph started if
+    it was clipped.
+*/
+// ----------------------------------------------------------------------------
+uint32_t ssd1322_font_draw( uint8_t *buffer, uint16_t stride, uint32_t x,
+                            uint8_t y, uint32_t clip, const char *text,
+                            uint8_t grey );
+
+#endif
@@ -65,9 +65,45 @@ void ssd1322_write_data( uint8_t id, uint8_t data )
 // ----------------------------------------------------------------------------
 void ssd1322_write_stream( uint8_t id, uint8_t *buf, unsigned count )
 {
+    unsigned chunk;
+
     ssd1322_write_command( id, SSD1322_CMD_SET_WRITE );
     gpioWrite( ssd1322[id]->gpio_dc, SSD1322_INPUT_DATA );
-    spiWrite( ssd1322[id]->spi_handle, (char*)buf, count );
+
+    // spidev rejects transfers larger than its buffer.
+    while ( count > 0 )
+    {
+        chunk = ( count > SPI_BUF_MAX ) ? SPI_BUF_MAX : count;
+        spiWrite( ssd1322[id]->spi_handle, (char*)buf, chunk );
+        buf   += chunk;
+        count -= chunk;
+    }
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Writes a sequence of commands with their parameters.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_write_sequence( uint8_t id, const uint8_t *seq, unsigned count )
+{
+    unsigned i = 0;
+    uint8_t  params;
+
+    while ( i + 1 < count )
+    {
+        gpioWrite( ssd1322[id]->gpio_dc, SSD1322_INPUT_COMMAND );
+        spiWrite( ssd1322[id]->spi_handle, (char*)&seq[i], 1 );
+        params = seq[i + 1];
+        i += 2;
+
+        if ( params == 0 ) continue;
+        if ( i + params > count ) return;
+
+        gpioWrite( ssd1322[id]->gpio_dc, SSD1322_INPUT_DATA );
+        spiWrite( ssd1322[id]->spi_handle, (char*)&seq[i], params );
+        i += params;
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -87,6 +123,19 @@ void ssd1322_reset( uint8_t id )
     gpioDelay( 1000000 );
 }
 
+// ----------------------------------------------------------------------------
+/*
+    Triggers a hardware reset using the datasheet minimum timings.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_reset_fast( uint8_t id )
+{
+    gpioWrite( ssd1322[id]->gpio_reset, SSD1322_RESET_ON );
+    gpioDelay( SSD1322_RESET_LOW_US );
+    gpioWrite( ssd1322[id]->gpio_reset, SSD1322_RESET_OFF );
+    gpioDelay( SSD1322_RESET_WAIT_US );
+}
+
 // ----------------------------------------------------------------------------
 /*
     Enables grey scale lookup table.
@@ -735,17 +784,11 @@ void ssd1322_set_command_unlock( uint8_t id )
 // ----------------------------------------------------------------------------
 void ssd1322_clear_display( uint8_t id )
 {
+    static uint8_t blank[SSD1322_RAM_BYTES];
+
     ssd1322_set_cols_default( id );
     ssd1322_set_rows_default( id );
-    ssd1322_set_write_continuous( id );
-    uint8_t col, row;
-    for ( row = SSD1322_ROWS_MIN; row <= SSD1322_ROWS_MAX; row++ )
-    {
-        for ( col = SSD1322_COLS_MIN; col <= SSD1322_COLS_MAX; col++ )
-        {
-            ssd1322_write_data( id, 0x00 );
-        }
-    }
+    ssd1322_write_stream( id, blank, SSD1322_RAM_BYTES );
 }
 
 // ----------------------------------------------------------------------------
@@ -786,7 +829,7 @@ void ssd1322_set_typical( uint8_t id )
 {
     ssd1322_set_command_unlock( id );
     ssd1322_set_display_off( id );
-    ssd1322_set_cols( id, 0x1c, 0x5b );
+    ssd1322_set_cols( id, 0, SSD1322_COLS - 1 );
     ssd1322_set_rows( id, 0x00, 0x3f );
     ssd1322_set_clock( id, 0x91 );
     ssd1322_set_mux( id, 0x3f );
@@ -812,11 +855,46 @@ void ssd1322_set_typical( uint8_t id )
 
 // ----------------------------------------------------------------------------
 /*
-    Initialises display.
+    Typical display operation settings as a command sequence. Same values as
+    ssd1322_set_typical but the display is left off until RAM is cleared.
+    Column addresses are raw here, i.e. already divided by 4 and offset as
+    ssd1322_set_cols does, giving the panel window 0x1c to 0x5b.
 */
 // ----------------------------------------------------------------------------
-int8_t ssd1322_init( uint8_t  dc,   uint8_t  reset, uint8_t channel,
-                     uint32_t baud, uint32_t flags )
+static const uint8_t ssd1322_typical_sequence[] =
+{
+    SSD1322_CMD_SET_LOCK,       1, SSD1322_COMMAND_UNLOCK,
+    SSD1322_CMD_SET_DISP_OFF,   0,
+    SSD1322_CMD_SET_COLS,       2, SSD1322_COL_OFFSET,
+                                   SSD1322_COL_OFFSET + SSD1322_COLS / 4 - 1,
+    SSD1322_CMD_SET_ROWS,       2, 0x00, 0x3f,
+    SSD1322_CMD_SET_CLOCK,      1, 0x91,
+    SSD1322_CMD_SET_MUX,        1, 0x3f,
+    SSD1322_CMD_SET_OFFSET,     1, 0x00,
+    SSD1322_CMD_SET_START,      1, 0x00,
+    SSD1322_CMD_SET_REMAP,      2, 0x14, 0x11,
+    SSD1322_CMD_SET_GPIOS,      1, 0x00,
+    SSD1322_CMD_SET_VDD,        1, SSD1322_VDD_INTERNAL,
+    SSD1322_CMD_SET_ENHANCE_A,  2, 0xa0, 0xfd,
+    SSD1322_CMD_SET_CONTRAST,   1, 0x9f,
+    SSD1322_CMD_SET_BRIGHTNESS, 1, 0x04,
+    SSD1322_CMD_SET_GREYS_DEF,  0,
+    SSD1322_CMD_SET_PHASE,      1, 0xe2,
+    SSD1322_CMD_SET_ENHANCE_B,  2, 0x00, 0x20,
+    SSD1322_CMD_SET_PRE_VOLT,   1, 0x1f,
+    SSD1322_CMD_SET_PERIOD,     1, 0x08,
+    SSD1322_CMD_SET_COM_VOLT,   1, 0x07,
+    SSD1322_CMD_SET_PIX_NORM,   0,
+    SSD1322_CMD_SET_PART_OFF,   0
+};
+
+// ----------------------------------------------------------------------------
+/*
+    Allocates a display struct and sets up GPIOs. Returns display ID.
+*/
+// ----------------------------------------------------------------------------
+static int8_t ssd1322_open( uint8_t  dc,   uint8_t  reset, uint8_t channel,
+                            uint32_t baud, uint32_t flags )
 {
     struct ssd1322_t *ssd1322_this; // Display instance.
     static bool init = false;       // 1st Call to init.
@@ -856,6 +934,7 @@ int8_t ssd1322_init( uint8_t  dc,   uint8_t  reset, uint8_t channel,
     ssd1322_this->spi_handle = handle;
     ssd1322_this->gpio_dc    = dc;
     ssd1322_this->gpio_reset = reset;
+    ssd1322_this->init_time  = 0;
     ssd1322[id] = ssd1322_this;
 
     init = true;
@@ -865,9 +944,54 @@ int8_t ssd1322_init( uint8_t  dc,   uint8_t  reset, uint8_t channel,
     gpioSetPullUpDown( dc, PI_PUD_UP );
     gpioSetPullUpDown( reset, PI_PUD_UP );
 
+    return id;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Initialises display.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_init( uint8_t  dc,   uint8_t  reset, uint8_t channel,
+                     uint32_t baud, uint32_t flags )
+{
+    int8_t   id;
+    uint32_t start;
+
+    id = ssd1322_open( dc, reset, channel, baud, flags );
+    if ( id < 0 ) return id;
+
+    start = gpioTick();
     ssd1322_reset( id );
     ssd1322_set_typical( id );
     ssd1322_clear_display( id );
+    ssd1322[id]->init_time = gpioTick() - start;
+
+    return id;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Initialises display using minimum reset timings, a batched command
+    sequence and a bulk clear.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_init_fast( uint8_t  dc,   uint8_t  reset, uint8_t channel,
+                          uint32_t baud, uint32_t flags )
+{
+    int8_t   id;
+    uint32_t start;
+
+    id = ssd1322_open( dc, reset, channel, baud, flags );
+    if ( id < 0 ) return id;
+
+    start = gpioTick();
+    ssd1322_reset_fast( id );
+    ssd1322_write_sequence( id, ssd1322_typical_sequence,
+                            sizeof( ssd1322_typical_sequence ));
+    ssd1322_clear_display( id );
+    ssd1322_set_display_on( id );
+    ssd1322[id]->init_time = gpioTick() - start;
 
     return id;
 }
@@ -21,7 +21,7 @@
 */
 //  ===========================================================================
 
-#define SSD1322_SPI_VERSION 1.01
+#define SSD1322_SPI_VERSION 1.02
 
 //  Macros. -------------------------------------------------------------------
 
@@ -42,6 +42,7 @@
 #define SPI_CHANNEL    0 // Channel.
 #define SPI_BAUD 5000000 // Baud rate (5 MHz).
 #define SPI_FLAGS   0x03 // Mode flags for pigpio.
+#define SPI_BUF_MAX 4096 // Largest single transfer (spidev bufsiz).
 /*
     Setting the SPI flags:
 
@@ -162,13 +163,22 @@
 // Column offset
 #define SSD1322_COL_OFFSET       0x1c // Based on example code.
 
+// Display RAM size (120 column addresses of 2 bytes x 128 rows).
+#define SSD1322_RAM_BYTES (( SSD1322_COLS_MAX + 1 ) * 2 * \
+                           ( SSD1322_ROWS_MAX + 1 ))
+
+// Datasheet minimum reset timings (us).
+#define SSD1322_RESET_LOW_US    100 // RES# low pulse width.
+#define SSD1322_RESET_WAIT_US   200 // RES# high to first command.
+
 // Data structures. -----------------------------------------------------------
 
 struct ssd1322_t
 {
-    uint8_t spi_handle; // SPI handle.
-    uint8_t gpio_dc;    // GPIO for DC#.
-    uint8_t gpio_reset; // GPIO for hardware reset.
+    uint8_t  spi_handle; // SPI handle.
+    uint8_t  gpio_dc;    // GPIO for DC#.
+    uint8_t  gpio_reset; // GPIO for hardware reset.
+    uint32_t init_time;  // Time from init to first frame (us).
 };
 
 struct ssd1322_t *ssd1322[SSD1322_DISPLAYS_MAX];
@@ -200,6 +210,19 @@ void ssd1322_write_data( uint8_t id, uint8_t data );
 // ----------------------------------------------------------------------------
 void ssd1322_write_stream( uint8_t id, uint8_t *buf, unsigned count );
 
+// ----------------------------------------------------------------------------
+/*
+    Writes a sequence of commands with their parameters.
+
+    Each entry in seq is a command, the number of parameter bytes and then
+    the parameter bytes. DC# has to be valid when the last bit of each byte
+    is clocked in, so a single transfer cannot mix commands and data. Each
+    command and each block of parameters is therefore one transfer, rather
+    than one transfer per byte.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_write_sequence( uint8_t id, const uint8_t *seq, unsigned count );
+
 // ----------------------------------------------------------------------------
 /*
     Triggers a hardware reset:
@@ -211,6 +234,13 @@ void ssd1322_write_stream( uint8_t id, uint8_t *buf, unsigned count );
 // ----------------------------------------------------------------------------
 void ssd1322_reset( uint8_t id );
 
+// ----------------------------------------------------------------------------
+/*
+    Triggers a hardware reset using the datasheet minimum timings.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_reset_fast( uint8_t id );
+
 // ----------------------------------------------------------------------------
 /*
     Enables grey scale lookup table.
@@ -637,7 +667,7 @@ void ssd1322_command_unlock( uint8_t id );
 
 // ----------------------------------------------------------------------------
 /*
-    Clears display RAM.
+    Clears all of display RAM with a bulk transfer of a zeroed buffer.
 */
 // ----------------------------------------------------------------------------
 void ssd1322_clear_display( uint8_t id );
@@ -664,4 +694,15 @@ void ssd1322_set_typical( uint8_t id );
 int8_t ssd1322_init( uint8_t  dc,   uint8_t  reset, uint8_t channel,
                      uint32_t baud, uint32_t flags );
 
+// ----------------------------------------------------------------------------
+/*
+    Initialises display using minimum reset timings, a batched command
+    sequence and a bulk clear. The display is switched on after the clear so
+    that the first frame shown is blank. The time taken is stored in
+    ssd1322[id]->init_time.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_init_fast( uint8_t  dc,   uint8_t  reset, uint8_t channel,
+                          uint32_t baud, uint32_t flags );
+
 #endif
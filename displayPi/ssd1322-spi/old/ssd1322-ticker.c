@@ -0,0 +1,213 @@
+//  ===========================================================================
+/*
+    ssd1322-ticker:
+
+    Pixel smooth scrolling text for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-font.h"
+#include "ssd1322-ticker.h"
+
+// ----------------------------------------------------------------------------
+/*
+    Returns monotonic time in microseconds.
+*/
+// ----------------------------------------------------------------------------
+static uint64_t ssd1322_ticker_time( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( uint64_t )now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a ticker on display id with its top row at y.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_ticker_init( struct ssd1322_ticker_t *ticker, uint8_t id,
+                            uint8_t y, uint8_t grey, uint16_t speed )
+{
+    memset( ticker, 0, sizeof( struct ssd1322_ticker_t ));
+    if ( y + SSD1322_FONT_HEIGHT > SSD1322_ROWS ) return -1;
+
+    ticker->id    = id;
+    ticker->y     = y;
+    ticker->grey  = grey & 0x0f;
+    ticker->speed = ( speed > 0 ) ? speed : SSD1322_TICKER_SPEED;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Copies the window at the current offset into the framebuffer and marks
+    the ticker's rows dirty.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_ticker_draw( struct ssd1322_ticker_t *ticker )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[ticker->id];
+    uint8_t row;
+
+    pthread_mutex_lock( &fb->lock );
+    for ( row = 0; row < SSD1322_FONT_HEIGHT; row++ )
+        ssd1322_fb_copy_packed(
+            &fb->buffer[( ticker->y + row ) * SSD1322_FB_ROW_BYTES], 0,
+            &ticker->strip[row * ticker->stride], ticker->offset,
+            SSD1322_COLS );
+    ssd1322_fb_mark_dirty_locked( fb, 0, ticker->y, SSD1322_COLS,
+                                  SSD1322_FONT_HEIGHT );
+    pthread_mutex_unlock( &fb->lock );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Renders the text into the strip, followed by a gap and the first
+    panel width again if it scrolls.
+*/
+// ----------------------------------------------------------------------------
+static int8_t ssd1322_ticker_render( struct ssd1322_ticker_t *ticker )
+{
+    uint32_t pixels, size;
+    uint8_t *strip;
+    uint8_t  row;
+
+    ticker->width  = ssd1322_font_measure( ticker->text );
+    ticker->scroll = ( ticker->width > SSD1322_COLS );
+    ticker->length = ticker->scroll ? ticker->width + SSD1322_TICKER_GAP :
+                                      SSD1322_COLS;
+    pixels = ticker->scroll ? ticker->length + SSD1322_COLS : SSD1322_COLS;
+    size   = ( pixels + 1 ) / 2 * SSD1322_FONT_HEIGHT;
+
+    if ( size > ticker->size )
+    {
+        strip = realloc( ticker->strip, size );
+        if ( strip == NULL ) return -2;
+        ticker->strip = strip;
+        ticker->size  = size;
+    }
+    ticker->stride = ( pixels + 1 ) / 2;
+    memset( ticker->strip, 0, size );
+
+    ssd1322_font_draw( ticker->strip, ticker->stride, 0, 0, ticker->width,
+                       ticker->text, ticker->grey );
+
+    if ( ticker->scroll )
+        for ( row = 0; row < SSD1322_FONT_HEIGHT; row++ )
+            ssd1322_fb_copy_packed( &ticker->strip[row * ticker->stride],
+                                    ticker->length,
+                                    &ticker->strip[row * ticker->stride], 0,
+                                    SSD1322_COLS );
+    ticker->renders++;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets the text, rendering the strip and drawing it from the start if it
+    has changed.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_ticker_set_text( struct ssd1322_ticker_t *ticker,
+                                const char *text )
+{
+    int8_t err;
+
+    if (( ticker->strip != NULL ) &&
+        ( strncmp( ticker->text, text, SSD1322_TICKER_TEXT - 1 ) == 0 ))
+        return 0;
+
+    strncpy( ticker->text, text, SSD1322_TICKER_TEXT - 1 );
+    ticker->text[SSD1322_TICKER_TEXT - 1] = '\0';
+
+    err = ssd1322_ticker_render( ticker );
+    if ( err < 0 )
+    {
+        ticker->text[0] = '\0';
+        return err;
+    }
+
+    ticker->offset = 0;
+    ticker->part   = 0;
+    ticker->last   = ssd1322_ticker_time();
+    ssd1322_ticker_draw( ticker );
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Scrolls by pixels and draws the window.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ticker_step( struct ssd1322_ticker_t *ticker, uint32_t pixels )
+{
+    if (( ticker->strip == NULL ) || !ticker->scroll || ( pixels == 0 ))
+        return;
+
+    ticker->offset = ( ticker->offset + pixels ) % ticker->length;
+    ssd1322_ticker_draw( ticker );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Scrolls by the pixels due since the last call at the ticker's speed.
+*/
+// ----------------------------------------------------------------------------
+uint32_t ssd1322_ticker_play( struct ssd1322_ticker_t *ticker )
+{
+    uint64_t now = ssd1322_ticker_time();
+    uint64_t due;
+
+    due = ( now - ticker->last ) * ticker->speed + ticker->part;
+    ticker->last = now;
+    ticker->part = due % 1000000;
+    due /= 1000000;
+    if (( ticker->strip == NULL ) || !ticker->scroll ) return 0;
+
+    ssd1322_ticker_step( ticker, due % ticker->length );
+
+    return due;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Frees the strip.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ticker_close( struct ssd1322_ticker_t *ticker )
+{
+    free( ticker->strip );
+    ticker->strip = NULL;
+    ticker->size  = 0;
+}
@@ -0,0 +1,124 @@
+//  ===========================================================================
+/*
+    ssd1322-ticker:
+
+    Pixel smooth scrolling text for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef SSD1322TICKER_H
+#define SSD1322TICKER_H
+
+// Info -----------------------------------------------------------------------
+/*
+    Scrolling a character at a time jumps by a whole glyph, which looks
+    crude on a panel that can show 16 greys. Instead the text is rendered
+    once, with the proportional 8x20 font (ssd1322-font), into a packed
+    strip off screen, and each frame copies a 256 pixel window of the strip
+    into the framebuffer at the current offset.
+
+        strip   |T i t l e - A r t i s t     |T i t l e - A r t ...
+                |<---------- length -------->|<----- 256 ------>|
+                       |<---- window ---->|
+                       offset
+
+    The text is followed by a gap and then repeated for the width of the
+    panel, so every window from an offset less than length is one
+    contiguous copy and the text wraps round seamlessly. A window at an
+    odd offset starts half way into a byte, so its rows are shifted by a
+    nibble as they are copied.
+
+    Each frame marks only the ticker's rows dirty, so the flush thread
+    sends just that band. Setting the same text again does nothing, and
+    text that fits the panel is drawn once and not scrolled.
+*/
+
+// Macros. --------------------------------------------------------------------
+
+#define SSD1322_TICKER_TEXT   256 // Longest text, bytes.
+#define SSD1322_TICKER_GAP    32  // Pixels between repeats of the text.
+#define SSD1322_TICKER_SPEED  40  // Default pixels per second.
+
+// Data structures. -----------------------------------------------------------
+
+struct ssd1322_ticker_t
+{
+    uint8_t   id;        // Display.
+    uint8_t   y;         // Top row.
+    uint8_t   grey;      // Text greyscale.
+    uint16_t  speed;     // Pixels per second.
+    char      text[SSD1322_TICKER_TEXT];
+    uint8_t  *strip;     // Rendered text, packed.
+    uint32_t  size;      // Bytes allocated for strip.
+    uint16_t  stride;    // Bytes per strip row.
+    uint32_t  width;     // Width of the rendered text (pixels).
+    uint32_t  length;    // Scroll period, text and gap (pixels).
+    uint32_t  offset;    // Window start (pixels).
+    bool      scroll;    // Text is wider than the panel.
+    uint64_t  last;      // Time of last frame (us).
+    uint32_t  part;      // Fraction of a pixel carried (us x speed).
+    uint32_t  renders;   // Times the strip has been rendered.
+};
+
+// Functions. -----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a ticker on display id with its top row at y.
+
+    Returns 0 on success, -1 if it doesn't fit on the panel.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_ticker_init( struct ssd1322_ticker_t *ticker, uint8_t id,
+                            uint8_t y, uint8_t grey, uint16_t speed );
+
+// ----------------------------------------------------------------------------
+/*
+    Sets the text, rendering the strip and drawing it from the start if it
+    has changed.
+
+    Returns 0 on success, -2 if out of memory.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_ticker_set_text( struct ssd1322_ticker_t *ticker,
+                                const char *text );
+
+// ----------------------------------------------------------------------------
+/*
+    Scrolls by pixels and draws the window.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ticker_step( struct ssd1322_ticker_t *ticker, uint32_t pixels );
+
+// ----------------------------------------------------------------------------
+/*
+    Scrolls by the pixels due since the last call at the ticker's speed.
+
+    Returns the number of pixels scrolled.
+*/
+// ----------------------------------------------------------------------------
+uint32_t ssd1322_ticker_play( struct ssd1322_ticker_t *ticker );
+
+// ----------------------------------------------------------------------------
+/*
+    Frees the strip.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ticker_close( struct ssd1322_ticker_t *ticker );
+
+#endif
@@ -0,0 +1,597 @@
+//  ===========================================================================
+/*
+    ssd1322-ui:
+
+    Retained widget tree for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-font.h"
+#include "ssd1322-ui.h"
+
+// ----------------------------------------------------------------------------
+/*
+    Returns want, or room if want is 0 or doesn't fit.
+*/
+// ----------------------------------------------------------------------------
+static uint16_t ssd1322_ui_fit( uint16_t want, uint16_t room )
+{
+    return (( want == 0 ) || ( want > room )) ? room : want;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns value between min and max as a fraction, 0 to 1.
+*/
+// ----------------------------------------------------------------------------
+static float ssd1322_ui_fraction( float value, float min, float max )
+{
+    float fraction;
+
+    if ( max <= min ) return 0;
+    fraction = ( value - min ) / ( max - min );
+    if ( !( fraction > 0 )) return 0;
+    if ( fraction > 1 ) return 1;
+
+    return fraction;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the 32 bit FNV-1a hash of size bytes of data, or of a string
+    if size is 0.
+*/
+// ----------------------------------------------------------------------------
+static uint32_t ssd1322_ui_hash( const uint8_t *data, uint16_t size )
+{
+    uint32_t hash = 0x811c9dc5;
+    uint16_t i;
+
+    for ( i = 0; ( size > 0 ) ? ( i < size ) : ( data[i] != 0 ); i++ )
+    {
+        hash ^= data[i];
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Fills a rectangle of the framebuffer, keeping the pixels either side
+    when it starts or ends half way into a byte.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_ui_fill( uint8_t *buffer, uint16_t x, uint16_t y,
+                             uint16_t dx, uint16_t dy, uint8_t grey )
+{
+    uint16_t end = x + dx, i, j, n;
+    uint8_t *row;
+
+    grey &= 0x0f;
+    for ( j = y; j < y + dy; j++ )
+    {
+        row = &buffer[j * SSD1322_FB_ROW_BYTES];
+        i   = x;
+        if (( i & 1 ) && ( i < end ))
+        {
+            row[i / 2] = ( row[i / 2] & 0xf0 ) | grey;
+            i++;
+        }
+        n = ( end - i ) / 2;
+        memset( &row[i / 2], grey << 4 | grey, n );
+        i += n * 2;
+        if ( i < end ) row[i / 2] = ( row[i / 2] & 0x0f ) | grey << 4;
+    }
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Works out the absolute position and size of widget and its children.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_ui_layout( struct ssd1322_widget_t *widget, uint16_t x,
+                               uint16_t y, uint16_t width, uint16_t height )
+{
+    struct ssd1322_widget_t *child;
+    uint16_t space, fixed = 0, flex = 0, share = 0, extra = 0;
+    uint16_t pos = 0, size, other;
+    bool     row;
+
+    widget->ax    = x;
+    widget->ay    = y;
+    widget->aw    = width;
+    widget->ah    = height;
+    widget->valid = false;
+    if ( widget->type != SSD1322_UI_BOX ) return;
+
+    if ( widget->box.layout == SSD1322_UI_FREE )
+    {
+        for ( child = widget->child; child; child = child->next )
+        {
+            pos   = ( child->x < width ) ? child->x : width;
+            other = ( child->y < height ) ? child->y : height;
+            ssd1322_ui_layout( child, x + pos, y + other,
+                               ssd1322_ui_fit( child->width, width - pos ),
+                               ssd1322_ui_fit( child->height,
+                                               height - other ));
+        }
+        return;
+    }
+
+    // Children of a row or column with no size share what the rest leave.
+    row   = ( widget->box.layout == SSD1322_UI_ROW );
+    space = row ? width : height;
+    for ( child = widget->child; child; child = child->next )
+    {
+        size = row ? child->width : child->height;
+        if ( size == 0 ) flex++;
+        fixed += size + (( child->next ) ? widget->box.gap : 0 );
+    }
+    if (( flex > 0 ) && ( fixed < space ))
+    {
+        share = ( space - fixed ) / flex;
+        extra = ( space - fixed ) % flex;
+    }
+
+    for ( child = widget->child; child; child = child->next )
+    {
+        size = row ? child->width : child->height;
+        if ( size == 0 )
+        {
+            size = share;
+            if ( extra > 0 )
+            {
+                size++;
+                extra--;
+            }
+        }
+        size  = ( size < space - pos ) ? size : space - pos;
+        other = row ? ssd1322_ui_fit( child->height, height ) :
+                      ssd1322_ui_fit( child->width, width );
+        if ( row ) ssd1322_ui_layout( child, x + pos, y, size, other );
+        else       ssd1322_ui_layout( child, x, y + pos, other, size );
+
+        pos += size;
+        pos  = ( widget->box.gap < space - pos ) ? pos + widget->box.gap :
+                                                   space;
+    }
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Reduces a widget's bound value to what it would draw, e.g. lit
+    segments or pixels of progress, so that values that look the same
+    aren't drawn again.
+*/
+// ----------------------------------------------------------------------------
+static uint32_t ssd1322_ui_sign( struct ssd1322_widget_t *widget )
+{
+    float    fraction, room;
+    uint16_t inner;
+    uint8_t  i;
+
+    switch ( widget->type )
+    {
+    case SSD1322_UI_LABEL:
+        if (( widget->label.text == NULL ) || ( *widget->label.text == NULL ))
+            return 0;
+        return ssd1322_ui_hash(( const uint8_t * )*widget->label.text, 0 );
+
+    case SSD1322_UI_METER:
+        fraction = ssd1322_ui_fraction( *widget->meter.value,
+                                        widget->meter.min, widget->meter.max );
+        return fraction * ( widget->aw / SSD1322_UI_SEGMENT ) + 0.5f;
+
+    case SSD1322_UI_PROGRESS:
+        inner    = ( widget->aw > 4 ) ? widget->aw - 4 : 0;
+        fraction = ssd1322_ui_fraction( *widget->progress.value, 0, 1 );
+        return fraction * inner + 0.5f;
+
+    case SSD1322_UI_ICON:
+        return ( *widget->icon.state < widget->icon.count ) ?
+               *widget->icon.state : widget->icon.count;
+
+    case SSD1322_UI_CLOCK:
+        if ( widget->clock.seconds == NULL ) return time( NULL ) / 60;
+        if ( !( *widget->clock.seconds > 0 )) return 0;
+        return ( *widget->clock.seconds < 360000 ) ?
+               *widget->clock.seconds : 359999;
+
+    case SSD1322_UI_SPECTRUM:
+        room = widget->ah;
+        for ( i = 0; i < widget->spectrum.count; i++ )
+            widget->spectrum.heights[i] = room * ssd1322_ui_fraction(
+                widget->spectrum.bands[i], widget->spectrum.floor,
+                widget->spectrum.ceiling ) + 0.5f;
+        return ssd1322_ui_hash( widget->spectrum.heights,
+                                widget->spectrum.count );
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws text aligned in widget and vertically centred, clipped to it.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_ui_text( uint8_t *buffer,
+                             const struct ssd1322_widget_t *widget,
+                             const char *text, uint8_t align )
+{
+    uint32_t width, x = widget->ax;
+
+    if (( text == NULL ) || ( widget->ah < SSD1322_FONT_HEIGHT )) return;
+
+    width = ssd1322_font_measure( text );
+    if ( width < widget->aw )
+    {
+        if ( align == SSD1322_UI_CENTRE ) x += ( widget->aw - width ) / 2;
+        if ( align == SSD1322_UI_RIGHT )  x += widget->aw - width;
+    }
+    ssd1322_font_draw( buffer, SSD1322_FB_ROW_BYTES, x,
+                       widget->ay + ( widget->ah - SSD1322_FONT_HEIGHT ) / 2,
+                       widget->ax + widget->aw, text, widget->grey );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws a widget over its cleared rectangle. sign is its reduced value.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_ui_draw( uint8_t *buffer, struct ssd1322_widget_t *widget,
+                             uint32_t sign )
+{
+    const uint8_t *image;
+    struct tm tm;
+    time_t   now;
+    uint16_t x = widget->ax, y = widget->ay, w = widget->aw, h = widget->ah;
+    uint16_t stride, pitch, bar, i;
+
+    switch ( widget->type )
+    {
+    case SSD1322_UI_LABEL:
+        ssd1322_ui_text( buffer, widget, *widget->label.text,
+                         widget->label.align );
+        break;
+
+    case SSD1322_UI_METER:
+        for ( i = 0; i < w / SSD1322_UI_SEGMENT; i++ )
+            ssd1322_ui_fill( buffer, x + i * SSD1322_UI_SEGMENT, y,
+                             SSD1322_UI_SEGMENT - 1, h,
+                             ( i < sign ) ? widget->grey : SSD1322_UI_DIM );
+        break;
+
+    case SSD1322_UI_PROGRESS:
+        if (( w < 4 ) || ( h < 4 ))
+        {
+            ssd1322_ui_fill( buffer, x, y, w, h, widget->grey );
+            break;
+        }
+        ssd1322_ui_fill( buffer, x, y, w, 1, widget->grey );
+        ssd1322_ui_fill( buffer, x, y + h - 1, w, 1, widget->grey );
+        ssd1322_ui_fill( buffer, x, y, 1, h, widget->grey );
+        ssd1322_ui_fill( buffer, x + w - 1, y, 1, h, widget->grey );
+        ssd1322_ui_fill( buffer, x + 2, y + 2, sign, h - 4, widget->grey );
+        break;
+
+    case SSD1322_UI_ICON:
+        if ( sign >= widget->icon.count ) break;
+        stride = ( widget->icon.width + 1 ) / 2;
+        image  = widget->icon.icons + sign * stride * widget->icon.height;
+        if ( w > widget->icon.width )
+        {
+            x += ( w - widget->icon.width ) / 2;
+            w  = widget->icon.width;
+        }
+        if ( h > widget->icon.height )
+        {
+            y += ( h - widget->icon.height ) / 2;
+            h  = widget->icon.height;
+        }
+        for ( i = 0; i < h; i++ )
+            ssd1322_fb_copy_packed( &buffer[( y + i ) * SSD1322_FB_ROW_BYTES],
+                                    x, &image[i * stride], 0, w );
+        break;
+
+    case SSD1322_UI_CLOCK:
+        if ( widget->clock.seconds == NULL )
+        {
+            now = ( time_t )sign * 60;
+            localtime_r( &now, &tm );
+            snprintf( widget->clock.text, SSD1322_UI_TIME, "%02d:%02d",
+                      tm.tm_hour, tm.tm_min );
+        }
+        else if ( sign >= 3600 )
+            snprintf( widget->clock.text, SSD1322_UI_TIME, "%u:%02u:%02u",
+                      sign / 3600, sign / 60 % 60, sign % 60 );
+        else
+            snprintf( widget->clock.text, SSD1322_UI_TIME, "%u:%02u",
+                      sign / 60, sign % 60 );
+        ssd1322_ui_text( buffer, widget, widget->clock.text,
+                         SSD1322_UI_CENTRE );
+        break;
+
+    case SSD1322_UI_SPECTRUM:
+        if ( widget->spectrum.count == 0 ) break;
+        pitch = w / widget->spectrum.count;
+        if ( pitch == 0 ) break;
+        bar = ( pitch > 2 ) ? pitch - 1 : pitch;
+        x  += ( w - pitch * widget->spectrum.count ) / 2;
+        for ( i = 0; i < widget->spectrum.count; i++ )
+            ssd1322_ui_fill( buffer, x + i * pitch,
+                             y + h - widget->spectrum.heights[i], bar,
+                             widget->spectrum.heights[i], widget->grey );
+        break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws widget, or the children of a box, if what it would show has
+    changed, marking each rectangle drawn dirty.
+
+    Returns the number of widgets drawn.
+*/
+// ----------------------------------------------------------------------------
+static uint16_t ssd1322_ui_walk( struct ssd1322_fb_t *fb,
+                                 struct ssd1322_widget_t *widget,
+                                 uint8_t background )
+{
+    struct ssd1322_widget_t *child;
+    uint16_t drawn = 0;
+    uint32_t sign;
+
+    if ( widget->type == SSD1322_UI_BOX )
+    {
+        for ( child = widget->child; child; child = child->next )
+            drawn += ssd1322_ui_walk( fb, child, background );
+        return drawn;
+    }
+
+    sign = ssd1322_ui_sign( widget );
+    if ( widget->valid && ( sign == widget->seen )) return 0;
+    widget->seen  = sign;
+    widget->valid = true;
+    if (( widget->aw == 0 ) || ( widget->ah == 0 )) return 0;
+
+    ssd1322_ui_fill( fb->buffer, widget->ax, widget->ay, widget->aw,
+                     widget->ah, background );
+    ssd1322_ui_draw( fb->buffer, widget, sign );
+    ssd1322_fb_mark_dirty_locked( fb, widget->ax, widget->ay, widget->aw,
+                                  widget->ah );
+
+    return 1;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a screen on display id.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ui_init( struct ssd1322_ui_t *ui, uint8_t id,
+                     struct ssd1322_widget_t *root, uint8_t background )
+{
+    memset( ui, 0, sizeof( struct ssd1322_ui_t ));
+    ui->id         = id;
+    ui->root       = root;
+    ui->background = background & 0x0f;
+    ui->relayout   = true;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Makes the next update lay out and draw the whole tree again.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ui_invalidate( struct ssd1322_ui_t *ui )
+{
+    ui->relayout = true;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Draws the widgets whose bound values have changed.
+*/
+// ----------------------------------------------------------------------------
+uint16_t ssd1322_ui_update( struct ssd1322_ui_t *ui )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[ui->id];
+    uint16_t drawn;
+
+    if (( fb == NULL ) || ( ui->root == NULL )) return 0;
+
+    pthread_mutex_lock( &fb->lock );
+    if ( ui->relayout )
+    {
+        ssd1322_ui_layout( ui->root, 0, 0, SSD1322_COLS, SSD1322_ROWS );
+        memset( fb->buffer, ui->background << 4 | ui->background,
+                SSD1322_FB_BYTES );
+        ssd1322_fb_mark_dirty_locked( fb, 0, 0, SSD1322_COLS, SSD1322_ROWS );
+        ui->relayout = false;
+    }
+    drawn = ssd1322_ui_walk( fb, ui->root, ui->background );
+    pthread_mutex_unlock( &fb->lock );
+
+    ui->updates++;
+    ui->drawn += drawn;
+
+    return drawn;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Makes the next update draw widget again.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_invalidate( struct ssd1322_widget_t *widget )
+{
+    widget->valid = false;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Adds child as the last child of parent.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_widget_add( struct ssd1322_widget_t *parent,
+                           struct ssd1322_widget_t *child, uint16_t x,
+                           uint16_t y, uint16_t width, uint16_t height )
+{
+    struct ssd1322_widget_t **last;
+
+    if (( parent->type != SSD1322_UI_BOX ) || ( child->parent != NULL ) ||
+        ( child == parent )) return -1;
+
+    child->x      = x;
+    child->y      = y;
+    child->width  = width;
+    child->height = height;
+    child->parent = parent;
+    child->next   = NULL;
+
+    for ( last = &parent->child; *last; last = &( *last )->next );
+    *last = child;
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Clears widget and sets its type and grey.
+*/
+// ----------------------------------------------------------------------------
+static void ssd1322_widget_init( struct ssd1322_widget_t *widget,
+                                 uint8_t type, uint8_t grey )
+{
+    memset( widget, 0, sizeof( struct ssd1322_widget_t ));
+    widget->type = type;
+    widget->grey = grey & 0x0f;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a box that lays out its children.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_box( struct ssd1322_widget_t *widget, uint8_t layout,
+                         uint8_t gap )
+{
+    ssd1322_widget_init( widget, SSD1322_UI_BOX, 0 );
+    widget->box.layout = layout;
+    widget->box.gap    = gap;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a label bound to the caller's string pointer.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_label( struct ssd1322_widget_t *widget,
+                           const char *const *text, uint8_t align,
+                           uint8_t grey )
+{
+    ssd1322_widget_init( widget, SSD1322_UI_LABEL, grey );
+    widget->label.text  = text;
+    widget->label.align = align;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a segmented meter bound to a level between min and max.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_meter( struct ssd1322_widget_t *widget,
+                           const float *value, float min, float max,
+                           uint8_t grey )
+{
+    ssd1322_widget_init( widget, SSD1322_UI_METER, grey );
+    widget->meter.value = value;
+    widget->meter.min   = min;
+    widget->meter.max   = max;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a progress bar bound to a fraction.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_progress( struct ssd1322_widget_t *widget,
+                              const float *value, uint8_t grey )
+{
+    ssd1322_widget_init( widget, SSD1322_UI_PROGRESS, grey );
+    widget->progress.value = value;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up an icon showing one of count packed images.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_icon( struct ssd1322_widget_t *widget,
+                          const uint8_t *icons, uint16_t width,
+                          uint8_t height, uint8_t count,
+                          const uint8_t *state )
+{
+    ssd1322_widget_init( widget, SSD1322_UI_ICON, 0 );
+    widget->icon.icons  = icons;
+    widget->icon.width  = width;
+    widget->icon.height = height;
+    widget->icon.count  = count;
+    widget->icon.state  = state;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a clock bound to a count of seconds, or the time of day.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_clock( struct ssd1322_widget_t *widget,
+                           const double *seconds, uint8_t grey )
+{
+    ssd1322_widget_init( widget, SSD1322_UI_CLOCK, grey );
+    widget->clock.seconds = seconds;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a spectrum bound to count band levels.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_spectrum( struct ssd1322_widget_t *widget,
+                              const float *bands, uint8_t count, float floor,
+                              float ceiling, uint8_t grey )
+{
+    ssd1322_widget_init( widget, SSD1322_UI_SPECTRUM, grey );
+    widget->spectrum.bands   = bands;
+    widget->spectrum.count   = ( count < SSD1322_UI_BANDS ) ? count :
+                                                             SSD1322_UI_BANDS;
+    widget->spectrum.floor   = floor;
+    widget->spectrum.ceiling = ceiling;
+}
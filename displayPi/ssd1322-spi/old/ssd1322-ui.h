@@ -0,0 +1,258 @@
+//  ===========================================================================
+/*
+    ssd1322-ui:
+
+    Retained widget tree for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef SSD1322UI_H
+#define SSD1322UI_H
+
+// Info -----------------------------------------------------------------------
+/*
+    A screen is built once as a tree of widgets and then updated every
+    frame. Boxes arrange their children in a row, a column or at fixed
+    offsets; the rest draw something:
+
+        label     text, left, centred or right aligned.
+        meter     a bar of segments, e.g. volume.
+        progress  an outlined bar, e.g. track position.
+        icon      one of a set of packed images, e.g. play/pause.
+        clock     m:ss from a count of seconds, or the time of day.
+        spectrum  vertical bars from band levels (dB).
+
+    Widgets don't hold copies of what they show. Each is bound to the
+    caller's variable (a string, float, state etc.), which the caller
+    changes as it likes. An update reduces each bound value to what would
+    actually be drawn, e.g. the number of lit segments or the pixels of
+    progress, and redraws only widgets where that has changed. Each redraw
+    marks just the widget's rectangle dirty, so the flush thread sends only
+    those. An update with nothing changed draws nothing and sends nothing.
+
+    Layout is worked out once and kept until ssd1322_ui_invalidate, which
+    must be called after changing the tree or a widget's size. A width or
+    height of 0 fills the space left; in a row or column the space is
+    shared between such children.
+
+        +-- column ----------------------+-- spectrum --+
+        | label (title)                  |              |
+        | label (artist)                 |  | |  |      |
+        | icon | progress | clock | meter| || || ||  |  |
+        +--------------------------------+--------------+
+
+    Widgets and their bound values are owned by the caller and must stay
+    in place while the tree is in use. Nothing is allocated.
+*/
+
+// Macros. --------------------------------------------------------------------
+
+#define SSD1322_UI_BANDS    64 // Most spectrum bands.
+#define SSD1322_UI_SEGMENT  4  // Meter segment pitch (pixels).
+#define SSD1322_UI_DIM      2  // Greyscale of unlit meter segments.
+#define SSD1322_UI_TIME     16 // Longest clock text, bytes.
+
+// Data structures. -----------------------------------------------------------
+
+enum ssd1322UiType
+{
+    SSD1322_UI_BOX,
+    SSD1322_UI_LABEL,
+    SSD1322_UI_METER,
+    SSD1322_UI_PROGRESS,
+    SSD1322_UI_ICON,
+    SSD1322_UI_CLOCK,
+    SSD1322_UI_SPECTRUM
+};
+
+enum ssd1322UiLayout { SSD1322_UI_FREE, SSD1322_UI_ROW, SSD1322_UI_COLUMN };
+
+enum ssd1322UiAlign { SSD1322_UI_LEFT, SSD1322_UI_CENTRE, SSD1322_UI_RIGHT };
+
+struct ssd1322_widget_t
+{
+    uint8_t   type;      // enum ssd1322UiType.
+    uint8_t   grey;      // Foreground greyscale.
+    uint16_t  x;         // Offset in a free box (pixels).
+    uint16_t  y;
+    uint16_t  width;     // Requested size, 0 to fill (pixels).
+    uint16_t  height;
+    uint16_t  ax;        // Layout, absolute (pixels).
+    uint16_t  ay;
+    uint16_t  aw;
+    uint16_t  ah;
+    struct ssd1322_widget_t *parent;
+    struct ssd1322_widget_t *child;  // First child.
+    struct ssd1322_widget_t *next;   // Next sibling.
+    bool      valid;     // Drawn since the last layout.
+    uint32_t  seen;      // What was drawn, reduced to a number.
+    union
+    {
+        struct
+        {
+            uint8_t layout;         // enum ssd1322UiLayout.
+            uint8_t gap;            // Pixels between children.
+        } box;
+        struct
+        {
+            const char *const *text; // Bound string.
+            uint8_t align;          // enum ssd1322UiAlign.
+        } label;
+        struct
+        {
+            const float *value;     // Bound level.
+            float min;              // Level with no segments lit.
+            float max;              // Level with all segments lit.
+        } meter;
+        struct
+        {
+            const float *value;     // Bound fraction, 0 to 1.
+        } progress;
+        struct
+        {
+            const uint8_t *icons;   // Packed images, one after another.
+            const uint8_t *state;   // Bound index of image shown.
+            uint16_t width;         // Image size (pixels).
+            uint8_t  height;
+            uint8_t  count;         // Images.
+        } icon;
+        struct
+        {
+            const double *seconds;  // Bound count, NULL for time of day.
+            char text[SSD1322_UI_TIME];
+        } clock;
+        struct
+        {
+            const float *bands;     // Bound levels (dB).
+            uint8_t count;          // Bands.
+            float floor;            // Level with no bar (dB).
+            float ceiling;          // Level with a full bar (dB).
+            uint8_t heights[SSD1322_UI_BANDS];
+        } spectrum;
+    };
+};
+
+struct ssd1322_ui_t
+{
+    uint8_t   id;         // Display.
+    uint8_t   background; // Greyscale behind widgets.
+    bool      relayout;   // Layout to be worked out on next update.
+    struct ssd1322_widget_t *root;
+    uint32_t  updates;    // Updates.
+    uint32_t  drawn;      // Widgets drawn over all updates.
+};
+
+// Functions. -----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*
+    Sets up a screen on display id. root is laid out over the whole panel.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ui_init( struct ssd1322_ui_t *ui, uint8_t id,
+                     struct ssd1322_widget_t *root, uint8_t background );
+
+// ----------------------------------------------------------------------------
+/*
+    Makes the next update lay out and draw the whole tree again.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_ui_invalidate( struct ssd1322_ui_t *ui );
+
+// ----------------------------------------------------------------------------
+/*
+    Draws the widgets whose bound values have changed since they were last
+    drawn, holding the framebuffer lock once.
+
+    Returns the number of widgets drawn.
+*/
+// ----------------------------------------------------------------------------
+uint16_t ssd1322_ui_update( struct ssd1322_ui_t *ui );
+
+// ----------------------------------------------------------------------------
+/*
+    Makes the next update draw widget again, e.g. after changing its grey.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_invalidate( struct ssd1322_widget_t *widget );
+
+// ----------------------------------------------------------------------------
+/*
+    Adds child as the last child of parent at x, y with width x height,
+    0 to fill. x and y only apply to free boxes.
+
+    Returns 0 on success, -1 if parent isn't a box or child has a parent.
+*/
+// ----------------------------------------------------------------------------
+int8_t ssd1322_widget_add( struct ssd1322_widget_t *parent,
+                           struct ssd1322_widget_t *child, uint16_t x,
+                           uint16_t y, uint16_t width, uint16_t height );
+
+// ----------------------------------------------------------------------------
+/*
+    The following set up a widget of each type and must be called before
+    it is added to the tree.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_box( struct ssd1322_widget_t *widget, uint8_t layout,
+                         uint8_t gap );
+
+// ----------------------------------------------------------------------------
+/*
+    text points to the caller's string pointer, so the string can be
+    changed in place or swapped for another. The text is vertically
+    centred and clipped to the widget, which must be at least
+    SSD1322_FONT_HEIGHT high.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_label( struct ssd1322_widget_t *widget,
+                           const char *const *text, uint8_t align,
+                           uint8_t grey );
+
+void ssd1322_widget_meter( struct ssd1322_widget_t *widget,
+                           const float *value, float min, float max,
+                           uint8_t grey );
+
+void ssd1322_widget_progress( struct ssd1322_widget_t *widget,
+                              const float *value, uint8_t grey );
+
+// ----------------------------------------------------------------------------
+/*
+    icons is count images of width x height packed as the framebuffer, each
+    row starting on a byte. The image at state is drawn centred, or none if
+    state is count or more.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_icon( struct ssd1322_widget_t *widget,
+                          const uint8_t *icons, uint16_t width,
+                          uint8_t height, uint8_t count,
+                          const uint8_t *state );
+
+void ssd1322_widget_clock( struct ssd1322_widget_t *widget,
+                           const double *seconds, uint8_t grey );
+
+// ----------------------------------------------------------------------------
+/*
+    count bands, up to SSD1322_UI_BANDS, are spread across the widget.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_widget_spectrum( struct ssd1322_widget_t *widget,
+                              const float *bands, uint8_t count, float floor,
+                              float ceiling, uint8_t grey );
+
+#endif
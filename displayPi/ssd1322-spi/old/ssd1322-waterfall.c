@@ -0,0 +1,122 @@
+// ============================================================================
+/*
+    ssd1322-waterfall:
+
+    Scrolling spectrogram (waterfall) for SSD1322 OLED displays using the
+    display start line for hardware scrolling.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+// ============================================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-waterfall.h"
+
+// ----------------------------------------------------------------------------
+/*
+    Clears all 128 rows of display RAM and resets the start line.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_init( uint8_t id, struct ssd1322_waterfall_t *wf,
+                             float floor, float ceiling )
+{
+    static uint8_t blank[SSD1322_WATERFALL_RAM_ROWS *
+                         SSD1322_WATERFALL_ROW_BYTES];
+
+    wf->start   = 0;
+    wf->floor   = floor;
+    wf->ceiling = ( ceiling > floor ) ? ceiling : floor + 1;
+
+    // Rows outside the visible window are scrolled into view later, so
+    // clear all of them, not just the visible 64.
+    ssd1322_set_cols( id, 0, SSD1322_COLS - 1 );
+    ssd1322_set_rows( id, 0, SSD1322_WATERFALL_RAM_ROWS - 1 );
+    ssd1322_write_stream( id, blank, sizeof( blank ));
+    ssd1322_set_start( id, wf->start );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Converts band levels (dB) to a packed line of greyscales.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_line( struct ssd1322_waterfall_t *wf,
+                             const float *bands, uint16_t count )
+{
+    uint16_t x;
+    uint8_t  grey[2];
+    uint8_t  i;
+    float    level;
+    float    scale = ( SSD1322_GREYSCALES - 1 ) / ( wf->ceiling - wf->floor );
+
+    for ( x = 0; x < SSD1322_COLS; x += 2 )
+    {
+        for ( i = 0; i < 2; i++ )
+        {
+            level = ( bands[( x + i ) * count / SSD1322_COLS] - wf->floor )
+                    * scale;
+            if ( level < 0 ) level = 0;
+            if ( level > SSD1322_GREYSCALES - 1 )
+                level = SSD1322_GREYSCALES - 1;
+            grey[i] = ( uint8_t )( level + 0.5 );
+        }
+        wf->row[x / 2] = grey[0] << 4 | grey[1];
+    }
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Adds a line of band levels (dB) to the bottom of the waterfall and
+    scrolls the display up by one line.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_push( uint8_t id, struct ssd1322_waterfall_t *wf,
+                             const float *bands, uint16_t count )
+{
+    uint8_t start, row;
+
+    ssd1322_waterfall_line( wf, bands, count );
+
+    // The new line goes in the RAM row just below the visible window, which
+    // becomes the bottom row once the start line moves down by one. Writing
+    // it before moving the start line means it is never seen half drawn.
+    start = ( wf->start + 1 ) % SSD1322_WATERFALL_RAM_ROWS;
+    row   = ( start + SSD1322_ROWS - 1 ) % SSD1322_WATERFALL_RAM_ROWS;
+
+    ssd1322_set_cols( id, 0, SSD1322_COLS - 1 );
+    ssd1322_set_rows( id, row, row );
+    ssd1322_write_stream( id, wf->row, SSD1322_WATERFALL_ROW_BYTES );
+    ssd1322_set_start( id, start );
+
+    wf->start = start;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Restores the default start line so that normal drawing is unaffected.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_close( uint8_t id, struct ssd1322_waterfall_t *wf )
+{
+    wf->start = 0;
+    ssd1322_set_start_default( id );
+    ssd1322_set_rows( id, 0, SSD1322_ROWS - 1 );
+}
@@ -0,0 +1,110 @@
+// ============================================================================
+/*
+    ssd1322-waterfall:
+
+    Scrolling spectrogram (waterfall) for SSD1322 OLED displays using the
+    display start line for hardware scrolling.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef SSD1322WATERFALL_H
+#define SSD1322WATERFALL_H
+
+// Info -----------------------------------------------------------------------
+/*
+    The SSD1322 has 128 rows of display RAM but the panel only shows 64 of
+    them, starting at the display start line (command 0xa1). Moving the start
+    line scrolls the whole picture without rewriting it.
+
+    Each new line of the waterfall is written to the RAM row just below the
+    visible window and the start line is then advanced by one. The oldest
+    line drops off the top and the RAM row it occupied is reused 64 lines
+    later. A frame therefore costs a single 128 byte row write (256 pixels at
+    4 bits per pixel) plus a handful of command bytes, instead of the 8192
+    bytes needed to redraw the panel.
+
+        RAM row   0 +------------+
+                    |            |
+          start --> +------------+ <-- top of panel (oldest line)
+                    |  visible   |
+                    |  64 rows   |
+                    +------------+ <-- bottom of panel (newest line)
+          next  --> +------------+ <-- written next frame
+                    |            |
+              127   +------------+
+
+    Band levels (dB) are mapped linearly onto the 16 greyscales between
+    floor and ceiling.
+*/
+
+// Macros. --------------------------------------------------------------------
+
+#define SSD1322_WATERFALL_RAM_ROWS  128 // Rows of display RAM.
+#define SSD1322_WATERFALL_ROW_BYTES ( SSD1322_COLS / 2 ) // Bytes per line.
+
+// Data structures. -----------------------------------------------------------
+
+struct ssd1322_waterfall_t
+{
+    uint8_t start;      // Current display start line.
+    float   floor;      // Level mapped to grey 0 (dB).
+    float   ceiling;    // Level mapped to grey 15 (dB).
+    uint8_t row[SSD1322_WATERFALL_ROW_BYTES]; // Packed 4bpp line buffer.
+};
+
+// Functions. -----------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/*
+    Clears all 128 rows of display RAM and resets the start line.
+
+    floor and ceiling set the range of levels (dB) mapped onto the
+    greyscales.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_init( uint8_t id, struct ssd1322_waterfall_t *wf,
+                             float floor, float ceiling );
+
+// ----------------------------------------------------------------------------
+/*
+    Converts band levels (dB) to a packed line of greyscales.
+
+    The bands are spread evenly across the display width, so count should
+    divide 256 for bands of equal width.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_line( struct ssd1322_waterfall_t *wf,
+                             const float *bands, uint16_t count );
+
+// ----------------------------------------------------------------------------
+/*
+    Adds a line of band levels (dB) to the bottom of the waterfall and
+    scrolls the display up by one line.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_push( uint8_t id, struct ssd1322_waterfall_t *wf,
+                             const float *bands, uint16_t count );
+
+// ----------------------------------------------------------------------------
+/*
+    Restores the default start line so that normal drawing is unaffected.
+*/
+// ----------------------------------------------------------------------------
+void ssd1322_waterfall_close( uint8_t id, struct ssd1322_waterfall_t *wf );
+
+#endif
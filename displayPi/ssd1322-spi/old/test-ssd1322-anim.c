@@ -0,0 +1,177 @@
+//  ===========================================================================
+/*
+    test-ssd1322-anim:
+
+    Tests delta coded animations for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Compile with:
+
+    gcc test-ssd1322-anim.c ssd1322-anim.c ssd1322-fb.c ssd1322-spi.c -Wall
+        -o test-ssd1322-anim -lpigpio -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+*/
+// Info -----------------------------------------------------------------------
+/*
+    Encodes the Fallout animation from graphics.h, checks that playing it
+    gives every frame exactly, then plays it at 30fps and reports the
+    bytes sent per frame and the time spent applying each delta.
+
+    The panel is wired as in test-ssd1322-fb.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-anim.h"
+#include "graphics.h"
+#include "test-ssd1322.h"
+
+#define ANIM_X     20
+#define ANIM_FPS   30
+#define ANIM_FILE  "/tmp/falloutOK.s4an"
+
+// ----------------------------------------------------------------------------
+/*
+    Returns true if the framebuffer shows frame at x, y.
+*/
+// ----------------------------------------------------------------------------
+static bool shows( uint8_t id, const uint8_t *frame, uint16_t x, uint8_t y,
+                   uint16_t width, uint8_t height )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+    uint16_t i, j;
+    uint8_t  byte, grey;
+    bool     same = true;
+
+    pthread_mutex_lock( &fb->lock );
+    for ( j = 0; j < height; j++ )
+        for ( i = 0; i < width; i++ )
+        {
+            byte = fb->buffer[( y + j ) * SSD1322_FB_ROW_BYTES + ( x + i ) / 2];
+            grey = (( x + i ) & 1 ) ? byte & 0x0f : byte >> 4;
+            if ( grey != ( frame[j * width + i] & 0x0f )) same = false;
+        }
+    pthread_mutex_unlock( &fb->lock );
+
+    return same;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Main
+*/
+// ----------------------------------------------------------------------------
+int main()
+{
+    struct ssd1322_anim_t anim;
+    struct ssd1322_fb_stats_t before, after;
+    uint8_t *data;
+    size_t   size;
+    uint64_t start, busy = 0, end;
+    uint32_t steps = 0, spans = 0, bytes = 0;
+    int8_t   id;
+    bool     pass = true, same = true;
+    uint8_t  i;
+
+    id = ssd1322_init_fast( GPIO_DC, GPIO_RESET, 0, SPI_BAUD, SPI_FLAGS );
+    if (( id < 0 ) || ( ssd1322_fb_init( id, ANIM_FPS ) < 0 ))
+    {
+        printf( "Init failed!\n" );
+        return -1;
+    }
+
+    pass &= check( "Encode falloutOK.",
+                   ssd1322_anim_encode( &graphics_falloutOK[0][0], 64, 64, 7,
+                                        ANIM_FPS, 4, &data, &size ) == 0 );
+    pass &= check( "Save and map.",
+                   ( ssd1322_anim_save( ANIM_FILE, data, size ) == 0 ) &&
+                   ( ssd1322_anim_open( &anim, ANIM_FILE ) == 0 ));
+    for ( i = 0; i < 7; i++ )
+    {
+        spans += anim.frames[i].spans;
+        bytes += anim.frames[i].bytes;
+    }
+    printf( "\t%zu bytes for 7 frames of 2048, %u spans, %u bytes per "
+            "delta.\n", size, spans / 7, bytes / 7 );
+
+    // Damaged files are refused rather than drawn.
+    data[sizeof( struct ssd1322_anim_header_t ) +
+         offsetof( struct ssd1322_anim_frame_t, delta ) + 3] = 0xff;
+    pass &= check( "Damaged animation refused.",
+                   ssd1322_anim_init( &anim, data, size ) < 0 );
+    free( data );
+    ssd1322_anim_open( &anim, ANIM_FILE );
+
+    ssd1322_anim_start( &anim, id, ANIM_X, 0 );
+    same = shows( id, graphics_falloutOK[0], ANIM_X, 0, 64, 64 );
+    for ( i = 1; i < 3 * 7; i++ )
+    {
+        start = time_us();
+        ssd1322_anim_step( &anim );
+        busy += time_us() - start;
+        same &= shows( id, graphics_falloutOK[i % 7], ANIM_X, 0, 64, 64 );
+    }
+    pass &= check( "Deltas rebuild every frame over 3 loops.", same );
+    printf( "\t%.1fus per delta.\n", busy / ( 3.0 * 7 - 1 ));
+
+    ssd1322_anim_seek( &anim, 5 );
+    pass &= check( "Seek from keyframe.",
+                   shows( id, graphics_falloutOK[5], ANIM_X, 0, 64, 64 ));
+
+    // Play for 3 seconds, letting the flush thread catch up first.
+    gpioDelay( 200000 );
+    ssd1322_fb_get_stats( id, &before );
+    end = time_us() + 3000000;
+    while ( time_us() < end )
+    {
+        steps += ssd1322_anim_play( &anim );
+        gpioDelay( 5000 );
+    }
+    gpioDelay( 100000 );
+    ssd1322_fb_get_stats( id, &after );
+
+    printf( "\t%u frames in 3s, %u flushed, %llu bytes per flush of %u.\n",
+            steps, after.frames - before.frames,
+            ( unsigned long long )( after.bytes - before.bytes ) /
+            ( after.frames - before.frames + ( after.frames == before.frames )),
+            SSD1322_FB_BYTES );
+    pass &= check( "Only changed window sent.",
+                   after.bytes - before.bytes <
+                   ( uint64_t )( after.frames - before.frames ) * 64 * 32 );
+
+    ssd1322_anim_close( &anim );
+    ssd1322_fb_close( id );
+    gpioTerminate();
+    printf( "%s\n", pass ? "All tests passed." : "Some tests FAILED." );
+
+    return pass ? 0 : -1;
+}
@@ -0,0 +1,304 @@
+//  ===========================================================================
+/*
+    test-ssd1322-art:
+
+    Tests album art decode, scale, dither and cache for SSD1322 OLED
+    displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Compile with:
+
+    gcc test-ssd1322-art.c ssd1322-art.c ssd1322-fb.c ssd1322-spi.c -Wall
+        -o test-ssd1322-art -lpigpio -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+*/
+// Info -----------------------------------------------------------------------
+/*
+    Usage:
+
+        test-ssd1322-art [image.pnm]
+
+    Without a picture, runs the pipeline and cache checks on generated
+    pictures and needs no display. With a picture, also loads it twice
+    through the cache and draws it at the left of the panel, wired as in
+    test-ssd1322-fb.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-art.h"
+#include "test-ssd1322.h"
+
+#define CACHE_DIR "/tmp/test-ssd1322-art"
+#define ART_SIZE  64
+
+// ----------------------------------------------------------------------------
+/*
+    Writes a binary PPM of a cover-like picture: a grey ramp with a bright
+    disc in the middle.
+*/
+// ----------------------------------------------------------------------------
+static bool write_ppm( const char *path, uint16_t width, uint16_t height,
+                       uint8_t seed )
+{
+    FILE    *file;
+    uint16_t x, y;
+    int32_t  dx, dy;
+    uint8_t  rgb[3];
+
+    file = fopen( path, "wb" );
+    if ( file == NULL ) return false;
+
+    fprintf( file, "P6\n# test\n%u %u\n255\n", width, height );
+    for ( y = 0; y < height; y++ )
+        for ( x = 0; x < width; x++ )
+        {
+            dx = x - width / 2;
+            dy = y - height / 2;
+            rgb[0] = x * 255 / width;
+            rgb[1] = ( dx * dx + dy * dy < height * height / 9 ) ? 255 : seed;
+            rgb[2] = y * 255 / height;
+            fwrite( rgb, 1, 3, file );
+        }
+    fclose( file );
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the mean of packed 4 bit greys scaled to 8 bits.
+*/
+// ----------------------------------------------------------------------------
+static double packed_mean( const uint8_t *packed, uint16_t width,
+                           uint16_t height )
+{
+    uint32_t sum = 0, x, y;
+    uint8_t  byte;
+
+    for ( y = 0; y < height; y++ )
+        for ( x = 0; x < width; x++ )
+        {
+            byte = packed[y * (( width + 1 ) / 2 ) + x / 2];
+            sum += (( x & 1 ) ? byte & 0x0f : byte >> 4 ) * 17;
+        }
+
+    return ( double )sum / ( width * height );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Checks decode, scale and dither on pictures with known results.
+*/
+// ----------------------------------------------------------------------------
+static bool test_pipeline( void )
+{
+    static const char pgm[] = "P2 4 4 255\n"
+                              "0 255 0 255\n255 0 255 0\n"
+                              "0 255 0 255\n255 0 255 0\n";
+    static const char ppm[] = "P3\n# comment\n1 1\n65535\n65535 65535 0\n";
+    struct ssd1322_art_image_t image;
+    uint8_t  out[ART_SIZE * ART_SIZE], packed[ART_SIZE * ART_SIZE / 2];
+    uint8_t  grey[ART_SIZE * ART_SIZE];
+    bool     pass = true;
+    uint16_t i;
+
+    pass &= check( "Decode ASCII PGM.",
+                   ( ssd1322_art_decode(( const uint8_t * )pgm, sizeof( pgm ),
+                                        &image ) == 0 ) &&
+                   ( image.width == 4 ) && ( image.grey[1] == 255 ));
+
+    // Checkerboard halved averages to mid grey everywhere.
+    ssd1322_art_scale( &image, 2, 2, out );
+    pass &= check( "Area average of checkerboard.",
+                   ( out[0] == 128 ) && ( out[1] == 128 ) &&
+                   ( out[2] == 128 ) && ( out[3] == 128 ));
+
+    // Square picture in a wide box is centred on black.
+    ssd1322_art_scale( &image, 4, 2, out );
+    pass &= check( "Aspect ratio kept and centred.",
+                   ( out[0] == 0 ) && ( out[1] == 128 ) && ( out[2] == 128 ) &&
+                   ( out[3] == 0 ) && ( out[5] == 128 ) && ( out[7] == 0 ));
+    free( image.grey );
+
+    pass &= check( "Decode 16 bit ASCII PPM to luma.",
+                   ( ssd1322_art_decode(( const uint8_t * )ppm, sizeof( ppm ),
+                                        &image ) == 0 ) &&
+                   ( image.grey[0] == 226 ));
+    free( image.grey );
+
+    pass &= check( "Unknown format rejected.",
+                   ssd1322_art_decode(( const uint8_t * )"GIF89a", 6,
+                                      &image ) == -1 );
+
+    // Mid grey between two levels dithers to a mix with the same mean.
+    memset( grey, 0x80, sizeof( grey ));
+    ssd1322_art_dither( grey, ART_SIZE, ART_SIZE, packed );
+    for ( i = 1; ( i < sizeof( packed )) && ( packed[i] == packed[0] ); i++ );
+    pass &= check( "Dither keeps mean grey.",
+                   ( packed_mean( packed, ART_SIZE, ART_SIZE ) > 127.0 ) &&
+                   ( packed_mean( packed, ART_SIZE, ART_SIZE ) < 129.0 ) &&
+                   ( i < sizeof( packed )));
+
+    // Odd widths start each row on a byte.
+    memset( grey, 0xff, sizeof( grey ));
+    memset( packed, 0, sizeof( packed ));
+    ssd1322_art_dither( grey, 3, 2, packed );
+    pass &= check( "Dither odd width.",
+                   ( packed[0] == 0xff ) && ( packed[1] == 0xf0 ) &&
+                   ( packed[2] == 0xff ) && ( packed[3] == 0xf0 ) &&
+                   ( packed[4] == 0x00 ));
+
+    return pass;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Checks cache hits, misses and eviction, and times each path.
+*/
+// ----------------------------------------------------------------------------
+static bool test_cache( void )
+{
+    struct ssd1322_art_cache_t cache;
+    struct ssd1322_art_t art, again;
+    char     path[64];
+    uint64_t start, miss, hit;
+    bool     pass = true;
+    uint8_t  i;
+
+    if ( system( "rm -rf " CACHE_DIR ) != 0 ) return false;
+
+    // Room for two 64x64 pictures.
+    pass &= check( "Cache directory made.",
+                   ssd1322_art_cache_init( &cache, CACHE_DIR,
+                       2 * ( ART_SIZE * ART_SIZE / 2 + 8 )) == 0 );
+
+    for ( i = 0; i < 3; i++ )
+    {
+        snprintf( path, sizeof( path ), CACHE_DIR "/cover%u.ppm", i );
+        write_ppm( path, 500, 500, i * 40 );
+    }
+
+    start = time_us();
+    ssd1322_art_load( &cache, CACHE_DIR "/cover0.ppm", ART_SIZE, ART_SIZE,
+                      &art );
+    miss  = time_us() - start;
+    start = time_us();
+    ssd1322_art_load( &cache, CACHE_DIR "/cover0.ppm", ART_SIZE, ART_SIZE,
+                      &again );
+    hit   = time_us() - start;
+
+    pass &= check( "Miss then hit.",
+                   ( cache.misses == 1 ) && ( cache.hits == 1 ) &&
+                   art.mapped && again.mapped );
+    pass &= check( "Hit matches converted picture.",
+                   memcmp( art.packed, again.packed,
+                           ART_SIZE * ART_SIZE / 2 ) == 0 );
+    printf( "\t500x500 PPM: %lluus converting, %lluus from cache.\n",
+            ( unsigned long long )miss, ( unsigned long long )hit );
+    ssd1322_art_close( &again );
+
+    // Other box sizes are separate entries.
+    ssd1322_art_load( &cache, CACHE_DIR "/cover0.ppm", 32, 32, &again );
+    pass &= check( "Box size is part of key.",
+                   ( cache.misses == 2 ) && ( again.width == 32 ));
+    ssd1322_art_close( &again );
+
+    // Touch cover0 so cover0 at 32x32 is least recently used, then add
+    // two more pictures.
+    sleep( 1 );
+    ssd1322_art_load( &cache, CACHE_DIR "/cover0.ppm", ART_SIZE, ART_SIZE,
+                      &again );
+    ssd1322_art_close( &again );
+    sleep( 1 );
+    ssd1322_art_load( &cache, CACHE_DIR "/cover1.ppm", ART_SIZE, ART_SIZE,
+                      &again );
+    ssd1322_art_close( &again );
+    pass &= check( "Least recently used evicted.",
+                   ( cache.evicted == 1 ));
+
+    ssd1322_art_load( &cache, CACHE_DIR "/cover0.ppm", ART_SIZE, ART_SIZE,
+                      &again );
+    pass &= check( "Recently used kept.",
+                   ( cache.evicted == 1 ) && ( cache.hits == 3 ));
+    ssd1322_art_close( &again );
+
+    // A picture that can't be cached is still returned.
+    pass &= check( "Uncached load.",
+                   ( ssd1322_art_load( NULL, CACHE_DIR "/cover2.ppm",
+                                       ART_SIZE, ART_SIZE, &again ) == 0 ) &&
+                   !again.mapped );
+    ssd1322_art_close( &again );
+    ssd1322_art_close( &art );
+
+    return pass;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Main
+*/
+// ----------------------------------------------------------------------------
+int main( int argc, char *argv[] )
+{
+    struct ssd1322_art_cache_t cache;
+    struct ssd1322_art_t art;
+    int8_t err, id;
+    bool   pass;
+
+    pass  = test_pipeline();
+    pass &= test_cache();
+    printf( "%s\n", pass ? "All tests passed." : "Some tests FAILED." );
+    if ( argc < 2 ) return pass ? 0 : -1;
+
+    id = ssd1322_init_fast( GPIO_DC, GPIO_RESET, 0, SPI_BAUD, SPI_FLAGS );
+    if (( id < 0 ) || ( ssd1322_fb_init( id, SSD1322_FB_FPS ) < 0 ))
+    {
+        printf( "Init failed!\n" );
+        return -1;
+    }
+
+    ssd1322_art_cache_init( &cache, CACHE_DIR, 0 );
+    err = ssd1322_art_load( &cache, argv[1], ART_SIZE, ART_SIZE, &art );
+    if ( err < 0 ) printf( "Couldn't load %s!\n", argv[1] );
+    else
+    {
+        ssd1322_art_draw( id, 0, 0, &art );
+        ssd1322_art_close( &art );
+        gpioDelay( 5000000 );
+    }
+
+    ssd1322_fb_close( id );
+    gpioTerminate();
+
+    return pass ? 0 : -1;
+}
@@ -0,0 +1,180 @@
+//  ===========================================================================
+/*
+    test-ssd1322-fb:
+
+    Tests SSD1322 OLED display framebuffer driver for the Raspberry Pi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Compile with:
+
+    gcc test-ssd1322-fb.c ssd1322-fb.c ssd1322-spi.c -Wall
+        -o test-ssd1322-fb -lpigpio -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+*/
+// Info -----------------------------------------------------------------------
+/*
+        Configuration used.
+
+    ---------------------------------------------------------------------GND
+                                            |                   |
+                 RPi                        |                   |
+                 1 2                        |                   |
+                [o o]                       |                   |
+                [o o]                       |      SSD1322      |
+                [o o]                       |        1 2        |
+                [o o]                       |----GND[o o]+5V----(-----------,
+                [o o]                       |       [o o]SCLK---(-------,   |
+                [o o]                   ,---(---SDIN[o o]       |       |   |
+                [o o]                   |   |-------[o o]-------|       |   |
+                [o o]GPIO23-----,       |   |-------[o o]-------|       |   |
+                [o o]GPIO24-----(---,   |   |-------[o o]-------'       |   |
+    ,-------MOSI[o o]           |   |   |   '--- WR#[o o]DC#--------,   |   |
+    |           [o o]           |   '---(-----RESET#[o o]CS#----,   |   |   |
+    |   ,---SCLK[o o]CE0----,   |       |            2 1        |   |   |   |
+    |   |       [o o]       |   |       |                       |   |   |   |
+    |   |       25 26       '---(-------|-----------------------'   |   |   |
+    |   |                       |       |                           |   |   |
+    |   |                       '-------(---------------------------'   |   |
+    |   |                               |                               |   |
+    |   '-------------------------------(-------------------------------'   |
+    |                                   |                                   |
+    '-----------------------------------'               ,-------------------'
+                                                        |
+    ---------------------------------------------------------------------+5V
+
+    A second panel can be connected in the same way using CE1 for CS# and
+    GPIO25 for RESET#. SCLK, SDIN and DC# are shared with the first panel.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pigpio.h>
+#include <pthread.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "graphics.h"
+
+#define GPIO_RESET_2 25 // RES# for second panel (CS# on CE1).
+
+// ----------------------------------------------------------------------------
+/*
+    Prints flush statistics for a panel.
+*/
+// ----------------------------------------------------------------------------
+void print_stats( uint8_t id )
+{
+    struct ssd1322_fb_stats_t stats;
+
+    ssd1322_fb_get_stats( id, &stats );
+    printf( "Panel %u: target %ufps, achieved %.1ffps.\n",
+            id, ssd1322_fb[id]->fps, stats.fps );
+    printf( "\tFrames  :%u sent, %u skipped, %u late.\n",
+            stats.frames, stats.skipped, stats.late );
+    printf( "\tFlush   :%uus last, %uus avg, %uus max.\n",
+            stats.flush_last, stats.flush_avg, stats.flush_max );
+    printf( "\tBus wait:%uus per band.\n", stats.bus_wait );
+    printf( "\tBytes   :%llu.\n", ( unsigned long long )stats.bytes );
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Main
+*/
+// ----------------------------------------------------------------------------
+int main()
+{
+    int8_t  err;
+    int8_t  id[2] = { -1, -1 };
+    uint8_t panels = 0;
+    uint8_t i, j;
+
+    // Reset both panels before either is in use, as init resets the panel.
+    err = ssd1322_init_fast( GPIO_DC, GPIO_RESET, 0, SPI_BAUD, SPI_FLAGS );
+    if ( err < 0 )
+    {
+        printf( "Init failed!\n" );
+        return -1;
+    }
+    id[panels++] = err;
+
+    err = ssd1322_init_fast( GPIO_DC, GPIO_RESET_2, 1, SPI_BAUD, SPI_FLAGS );
+    if ( err >= 0 ) id[panels++] = err;
+
+    for ( i = 0; i < panels; i++ )
+    {
+        printf( "Init successful.\n" );
+        printf( "\tID   :%d\n", id[i] );
+        printf( "\tSPI  :%d\n", ssd1322[id[i]]->spi_handle );
+        printf( "\tDC   :%d\n", ssd1322[id[i]]->gpio_dc );
+        printf( "\tRESET:%d\n", ssd1322[id[i]]->gpio_reset );
+
+        // Independent frame rates - animation panel faster than the other.
+        err = ssd1322_fb_init( id[i], ( i == 0 ) ? 30 : 10 );
+        if ( err < 0 )
+        {
+            printf( "Couldn't allocate memory for framebuffer!\n" );
+            return -1;
+        }
+    }
+
+    printf( "Drawing pixels - individuals.\n" );
+    ssd1322_fb_draw_pixel( id[0], 0, 0, 0x4 );
+    ssd1322_fb_draw_pixel( id[0], 255, 0, 0x4 );
+    ssd1322_fb_draw_pixel( id[0], 0, 63, 0x4 );
+    ssd1322_fb_draw_pixel( id[0], 255, 63, 0x4 );
+
+    if ( panels > 1 )
+    {
+        printf( "Drawing graphic - Vault-Tec symbols on second panel.\n" );
+        ssd1322_fb_draw_image( id[1], 0, 0, 128, 64, graphics_vaultteclogo64 );
+        ssd1322_fb_draw_image( id[1], 192, 16, 64, 32,
+                               graphics_vaultteclogo32 );
+    }
+
+    printf( "Drawing graphic - fallout animation loop.\n" );
+    for ( i = 0; i < 5; i++ )
+    {
+        for ( j = 0; j < 7; j++ )
+        {
+            ssd1322_fb_draw_image( id[0], 20, 0, 64, 64,
+                                   graphics_falloutOK[j] );
+            gpioDelay( 200000 );
+        }
+    }
+
+    printf( "Drawing graphic - Vault-Tec symbols.\n" );
+    ssd1322_fb_draw_image( id[0], 0, 0, 128, 64, graphics_vaultteclogo64 );
+    ssd1322_fb_draw_image( id[0], 192, 16, 64, 32, graphics_vaultteclogo32 );
+    gpioDelay( 2000000 );
+
+    for ( i = 0; i < panels; i++ )
+    {
+        print_stats( id[i] );
+        ssd1322_fb_close( id[i] );
+    }
+
+    gpioTerminate();
+
+    return 0;
+}
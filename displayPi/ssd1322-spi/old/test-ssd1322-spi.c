@@ -23,7 +23,8 @@
 /*
     Compile with:
 
-    gcc test-ssd1322.c ssd1322-spi.c -Wall -o test-ssd1322 -lpigpio
+    gcc test-ssd1322.c ssd1322-spi.c ssd1322-waterfall.c -Wall
+        -o test-ssd1322 -lpigpio
 
     Also use the following flags for Raspberry Pi optimisation:
         -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
@@ -67,6 +68,7 @@
 #include <pigpio.h>
 
 #include "ssd1322-spi.h"
+#include "ssd1322-waterfall.h"
 #include "graphics.h"
 
 // SSD1322 supports 480x128 but display is 256x64.
@@ -295,6 +297,30 @@ void test_load_image( uint8_t id )
     test_draw_image( id, image );
 }
 
+// ----------------------------------------------------------------------------
+/*
+    Display test - waterfall of a tone sweeping across 64 bands.
+*/
+// ----------------------------------------------------------------------------
+void test_waterfall( uint8_t id )
+{
+    struct ssd1322_waterfall_t wf;
+    float    bands[64];
+    uint16_t line;
+    uint8_t  band, peak;
+
+    ssd1322_waterfall_init( id, &wf, -60, 0 );
+    for ( line = 0; line < 512; line++ )
+    {
+        peak = line % 64;
+        for ( band = 0; band < 64; band++ )
+            bands[band] = -6.0 * (( band > peak ) ? band - peak : peak - band );
+        ssd1322_waterfall_push( id, &wf, bands, 64 );
+        gpioDelay( 20000 );
+    }
+    ssd1322_waterfall_close( id, &wf );
+}
+
 // ----------------------------------------------------------------------------
 /*
     Main
@@ -306,7 +332,8 @@ int main()
     int8_t err;
     uint8_t i;
 
-    err = ssd1322_init( GPIO_DC, GPIO_RESET, SPI_CHANNEL, SPI_BAUD, SPI_FLAGS );
+    err = ssd1322_init_fast( GPIO_DC, GPIO_RESET,
+                             SPI_CHANNEL, SPI_BAUD, SPI_FLAGS );
 
     if ( err < 0 ) printf( "Init failed!\n" );
     else
@@ -317,12 +344,14 @@ int main()
         printf( "\tSPI  :%d\n", ssd1322[id]->spi_handle );
         printf( "\tDC   :%d\n", ssd1322[id]->gpio_dc );
         printf( "\tRESET:%d\n", ssd1322[id]->gpio_reset );
+        printf( "\tINIT :%uus to first frame\n", ssd1322[id]->init_time );
     }
 
     ssd1322_clear_display( id );
 //    test_checkerboard( id );
 //    test_greyscales( id );
 //    test_load_image( id );
+//    test_waterfall( id );
     test_stream_pixel( id );
 //    ssd1322_clear_display( id );
 
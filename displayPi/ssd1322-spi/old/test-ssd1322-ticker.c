@@ -0,0 +1,195 @@
+//  ===========================================================================
+/*
+    test-ssd1322-ticker:
+
+    Tests pixel smooth scrolling text for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Compile with:
+
+    gcc test-ssd1322-ticker.c ssd1322-ticker.c ssd1322-font.c ssd1322-fb.c
+        ssd1322-spi.c -Wall -o test-ssd1322-ticker -lpigpio -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+*/
+// Info -----------------------------------------------------------------------
+/*
+    Checks every window of a scrolling title, odd and even offsets and
+    across the wrap, against the font, then scrolls it for a few seconds
+    and reports the bytes sent per frame and the time spent per frame.
+
+    The panel is wired as in test-ssd1322-fb.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-font.h"
+#include "ssd1322-ticker.h"
+#include "font.h"
+#include "test-ssd1322.h"
+
+#define TICKER_Y     44
+#define TICKER_GREY  0x0c
+#define TICKER_SPEED 60
+#define TICKER_TEXT  "Fallout 4 - Atom Bomb Baby - The Five Stars - " \
+                     "Diamond City Radio (1957)"
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the grey the text should have at pixel x of row, looked up in
+    the font rather than the strip.
+*/
+// ----------------------------------------------------------------------------
+static uint8_t expected( const char *text, uint32_t x, uint8_t row )
+{
+    const uint8_t *glyph;
+    uint32_t start = 0, width;
+    uint8_t  cols, left, i;
+    char     one[2] = { 0, 0 };
+
+    for ( ; *text; text++, start += width )
+    {
+        one[0] = *text;
+        width  = ssd1322_font_measure( one );
+        if ( x >= start + width ) continue;
+        if ( *text == ' ' ) return 0;
+
+        glyph = font_8x20[*text - FONT_FIRST];
+        for ( cols = 0, i = 0; i < FONT_HEIGHT; i++ ) cols |= glyph[i];
+        for ( left = 0; !( cols & ( 0x80 >> left )); left++ );
+        i = x - start + left;
+        return (( i < FONT_WIDTH ) && ( glyph[row] & ( 0x80 >> i ))) ?
+               TICKER_GREY : 0;
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns true if the ticker's rows show the text from offset.
+*/
+// ----------------------------------------------------------------------------
+static bool shows( uint8_t id, const struct ssd1322_ticker_t *ticker )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+    uint32_t x, p;
+    uint8_t  row, byte, grey;
+    bool     same = true;
+
+    pthread_mutex_lock( &fb->lock );
+    for ( row = 0; row < FONT_HEIGHT; row++ )
+        for ( x = 0; x < SSD1322_COLS; x++ )
+        {
+            byte = fb->buffer[( TICKER_Y + row ) * SSD1322_FB_ROW_BYTES +
+                              x / 2];
+            grey = ( x & 1 ) ? byte & 0x0f : byte >> 4;
+            p    = ( ticker->offset + x ) % ticker->length;
+            if ( grey != expected( ticker->text, p, row )) same = false;
+        }
+    pthread_mutex_unlock( &fb->lock );
+
+    return same;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Main
+*/
+// ----------------------------------------------------------------------------
+int main()
+{
+    struct ssd1322_ticker_t ticker;
+    struct ssd1322_fb_stats_t before, after;
+    uint64_t start, busy = 0, end;
+    uint32_t i, frames = 0, flushed;
+    int8_t   id;
+    bool     pass = true, same = true;
+
+    id = ssd1322_init_fast( GPIO_DC, GPIO_RESET, 0, SPI_BAUD, SPI_FLAGS );
+    if (( id < 0 ) || ( ssd1322_fb_init( id, 30 ) < 0 ))
+    {
+        printf( "Init failed!\n" );
+        return -1;
+    }
+
+    ssd1322_ticker_init( &ticker, id, TICKER_Y, TICKER_GREY, TICKER_SPEED );
+    ssd1322_ticker_set_text( &ticker, "Nuka-Cola" );
+    ssd1322_ticker_step( &ticker, 5 );
+    pass &= check( "Short text drawn once and still.",
+                   !ticker.scroll && ( ticker.offset == 0 ) &&
+                   shows( id, &ticker ));
+
+    ssd1322_ticker_set_text( &ticker, TICKER_TEXT );
+    ssd1322_ticker_set_text( &ticker, TICKER_TEXT );
+    pass &= check( "Same text not rendered again.",
+                   ticker.scroll && ( ticker.renders == 2 ));
+    printf( "\t%u pixels of text, %u pixel loop.\n",
+            ticker.width, ticker.length );
+
+    same = shows( id, &ticker );
+    for ( i = 0; i < ticker.length + 8; i++ )
+    {
+        start = time_us();
+        ssd1322_ticker_step( &ticker, 1 );
+        busy += time_us() - start;
+        same &= shows( id, &ticker );
+    }
+    pass &= check( "Every offset, odd, even and wrapped.", same );
+    printf( "\t%.2fus per frame.\n", ( double )busy / i );
+
+    // Scroll for 3 seconds, letting the flush thread catch up first.
+    gpioDelay( 100000 );
+    ssd1322_ticker_play( &ticker );
+    ssd1322_fb_get_stats( id, &before );
+    end = time_us() + 3000000;
+    while ( time_us() < end )
+    {
+        if ( ssd1322_ticker_play( &ticker ) > 0 ) frames++;
+        gpioDelay( 1000000 / 30 );
+    }
+    gpioDelay( 100000 );
+    ssd1322_fb_get_stats( id, &after );
+
+    flushed = after.frames - before.frames;
+    printf( "\t%u frames in 3s, %u flushed, %llu bytes per flush.\n",
+            frames, flushed, ( unsigned long long )( after.bytes -
+            before.bytes ) / ( flushed + ( flushed == 0 )));
+    pass &= check( "Only ticker rows sent.",
+                   ( flushed > 0 ) && ( after.bytes - before.bytes ==
+                   ( uint64_t )flushed * FONT_HEIGHT * SSD1322_FB_ROW_BYTES ));
+
+    ssd1322_ticker_close( &ticker );
+    ssd1322_fb_close( id );
+    gpioTerminate();
+    printf( "%s\n", pass ? "All tests passed." : "Some tests FAILED." );
+
+    return pass ? 0 : -1;
+}
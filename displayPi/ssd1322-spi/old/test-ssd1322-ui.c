@@ -0,0 +1,292 @@
+//  ===========================================================================
+/*
+    test-ssd1322-ui:
+
+    Tests the retained widget tree for SSD1322 OLED displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Compile with:
+
+    gcc test-ssd1322-ui.c ssd1322-ui.c ssd1322-font.c ssd1322-fb.c
+        ssd1322-spi.c -Wall -o test-ssd1322-ui -lpigpio -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+*/
+// Info -----------------------------------------------------------------------
+/*
+    Builds a now playing screen, checks that only widgets whose values
+    visibly change are drawn and sent, then reports the time per update
+    with nothing, one and several widgets changing.
+
+        +-- title ---------------------------------------+-- spectrum --+
+        +-- artist --------------------------------------+              |
+        +-- icon | progress ------------| clock | meter -+--------------+
+
+    The panel is wired as in test-ssd1322-fb.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <pigpio.h>
+
+#include "ssd1322-spi.h"
+#include "ssd1322-fb.h"
+#include "ssd1322-font.h"
+#include "ssd1322-ui.h"
+#include "test-ssd1322.h"
+
+#define UI_BANDS   16
+#define UI_ICON    12    // Icon width and height.
+#define UI_LOOPS   10000 // Updates timed.
+
+// ----------------------------------------------------------------------------
+/*
+    Draws play (a triangle) and pause (two bars) icons, packed.
+*/
+// ----------------------------------------------------------------------------
+static void make_icons( uint8_t icons[2][UI_ICON][UI_ICON / 2] )
+{
+    uint8_t x, y, grey;
+
+    memset( icons, 0, 2 * UI_ICON * UI_ICON / 2 );
+    for ( y = 0; y < UI_ICON; y++ )
+        for ( x = 0; x < UI_ICON; x++ )
+        {
+            grey = ( x * 2 <= ( y < UI_ICON / 2 ? y : UI_ICON - 1 - y ) * 4 ) ?
+                   0x0f : 0;
+            icons[0][y][x / 2] |= ( x & 1 ) ? grey : grey << 4;
+            grey = (( x < 4 ) || ( x >= UI_ICON - 4 )) ? 0x0f : 0;
+            icons[1][y][x / 2] |= ( x & 1 ) ? grey : grey << 4;
+        }
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns the number of dirty rectangles waiting for the flush thread.
+*/
+// ----------------------------------------------------------------------------
+static uint8_t waiting( uint8_t id, struct ssd1322_fb_rect_t *rect )
+{
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+    uint8_t count;
+
+    pthread_mutex_lock( &fb->lock );
+    count = fb->rect_count;
+    if ( count > 0 ) *rect = fb->rects[0];
+    pthread_mutex_unlock( &fb->lock );
+
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Returns true if the framebuffer shows text left aligned in label over
+    the background and is otherwise as it was in before.
+*/
+// ----------------------------------------------------------------------------
+static bool shows( uint8_t id, const struct ssd1322_widget_t *label,
+                   const char *text, const uint8_t *before )
+{
+    static uint8_t expect[SSD1322_FB_BYTES];
+    struct ssd1322_fb_t *fb = ssd1322_fb[id];
+    uint16_t x, y;
+    bool     same;
+
+    memcpy( expect, before, SSD1322_FB_BYTES );
+    for ( y = label->ay; y < label->ay + label->ah; y++ )
+        for ( x = label->ax; x < label->ax + label->aw; x++ )
+            expect[y * SSD1322_FB_ROW_BYTES + x / 2] &= ( x & 1 ) ? 0xf0 :
+                                                                   0x0f;
+    ssd1322_font_draw( expect, SSD1322_FB_ROW_BYTES, label->ax,
+                       label->ay + ( label->ah - SSD1322_FONT_HEIGHT ) / 2,
+                       label->ax + label->aw, text, label->grey );
+
+    pthread_mutex_lock( &fb->lock );
+    same = ( memcmp( expect, fb->buffer, SSD1322_FB_BYTES ) == 0 );
+    pthread_mutex_unlock( &fb->lock );
+
+    return same;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Main
+*/
+// ----------------------------------------------------------------------------
+int main()
+{
+    static uint8_t before[SSD1322_FB_BYTES];
+    uint8_t icons[2][UI_ICON][UI_ICON / 2];
+    struct ssd1322_widget_t root, left, bottom, title, artist, icon;
+    struct ssd1322_widget_t progress, clock, meter, spectrum;
+    struct ssd1322_ui_t ui;
+    struct ssd1322_fb_rect_t rect;
+    struct ssd1322_fb_stats_t stats_before, stats_after;
+    const char *title_text  = "Atom Bomb Baby";
+    const char *artist_text = "The Five Stars";
+    char     copy[32];
+    float    position = 0.3, volume = -20, bands[UI_BANDS];
+    double   elapsed = 0;
+    uint8_t  state = 0, i;
+    uint64_t start, idle, one, many;
+    uint32_t n, sent;
+    int8_t   id;
+    bool     pass = true;
+
+    id = ssd1322_init_fast( GPIO_DC, GPIO_RESET, 0, SPI_BAUD, SPI_FLAGS );
+    if (( id < 0 ) || ( ssd1322_fb_init( id, 30 ) < 0 ))
+    {
+        printf( "Init failed!\n" );
+        return -1;
+    }
+
+    make_icons( icons );
+    for ( i = 0; i < UI_BANDS; i++ ) bands[i] = -60 + i * 3;
+
+    ssd1322_widget_box( &root, SSD1322_UI_ROW, 0 );
+    ssd1322_widget_box( &left, SSD1322_UI_COLUMN, 2 );
+    ssd1322_widget_box( &bottom, SSD1322_UI_ROW, 2 );
+    ssd1322_widget_label( &title, &title_text, SSD1322_UI_LEFT, 0x0f );
+    ssd1322_widget_label( &artist, &artist_text, SSD1322_UI_LEFT, 0x0a );
+    ssd1322_widget_icon( &icon, &icons[0][0][0], UI_ICON, UI_ICON, 2,
+                         &state );
+    ssd1322_widget_progress( &progress, &position, 0x08 );
+    ssd1322_widget_clock( &clock, &elapsed, 0x0a );
+    ssd1322_widget_meter( &meter, &volume, -60, 0, 0x0c );
+    ssd1322_widget_spectrum( &spectrum, bands, UI_BANDS, -60, 0, 0x0f );
+
+    ssd1322_widget_add( &root, &left, 0, 0, 192, 0 );
+    ssd1322_widget_add( &root, &spectrum, 0, 0, 0, 0 );
+    ssd1322_widget_add( &left, &title, 0, 0, 0, SSD1322_FONT_HEIGHT );
+    ssd1322_widget_add( &left, &artist, 0, 0, 0, SSD1322_FONT_HEIGHT );
+    ssd1322_widget_add( &left, &bottom, 0, 0, 0, 0 );
+    ssd1322_widget_add( &bottom, &icon, 0, 0, 16, 0 );
+    ssd1322_widget_add( &bottom, &progress, 0, 0, 0, 0 );
+    ssd1322_widget_add( &bottom, &clock, 0, 0, 40, 0 );
+    ssd1322_widget_add( &bottom, &meter, 0, 0, 32, 0 );
+    pass &= check( "Only boxes take children.",
+                   ( ssd1322_widget_add( &title, &artist, 0, 0, 0, 0 ) < 0 ) &&
+                   ( ssd1322_widget_add( &left, &title, 0, 0, 0, 0 ) < 0 ));
+
+    ssd1322_ui_init( &ui, id, &root, 0 );
+    pass &= check( "First update draws every widget.",
+                   ssd1322_ui_update( &ui ) == 7 );
+    pass &= check( "Layout fills rows and columns.",
+                   ( bottom.ay == 44 ) && ( bottom.ah == 20 ) &&
+                   ( progress.ax == 18 ) && ( progress.aw == 98 ) &&
+                   ( meter.ax + meter.aw == 192 ) &&
+                   ( spectrum.ax == 192 ) && ( spectrum.aw == 64 ) &&
+                   ( spectrum.ah == 64 ));
+
+    // Let the flush thread take the first frame.
+    gpioDelay( 100000 );
+    pass &= check( "Nothing changed, nothing drawn or sent.",
+                   ( ssd1322_ui_update( &ui ) == 0 ) &&
+                   ( waiting( id, &rect ) == 0 ));
+
+    position = 0.303;
+    volume   = -19;
+    elapsed  = 0.6;
+    strcpy( copy, title_text );
+    title_text = copy;
+    pass &= check( "Values that look the same not drawn.",
+                   ssd1322_ui_update( &ui ) == 0 );
+
+    position = 0.5;
+    pass &= check( "Progress drawn alone, only its rect marked.",
+                   ( ssd1322_ui_update( &ui ) == 1 ) &&
+                   ( waiting( id, &rect ) == 1 ) &&
+                   ( rect.x0 == ( progress.ax & ~3 )) &&
+                   ( rect.x1 == (( progress.ax + progress.aw - 1 ) | 3 )) &&
+                   ( rect.y0 == progress.ay ) &&
+                   ( rect.y1 == progress.ay + progress.ah - 1 ));
+
+    gpioDelay( 100000 );
+    ssd1322_fb_get_stats( id, &stats_before );
+    elapsed = 61;
+    ssd1322_ui_update( &ui );
+    gpioDelay( 100000 );
+    ssd1322_fb_get_stats( id, &stats_after );
+    sent = ((( clock.ax + clock.aw - 1 ) | 3 ) - ( clock.ax & ~3 ) + 1 ) / 2 *
+           clock.ah;
+    pass &= check( "Clock change sends only the clock.",
+                   ( stats_after.bytes - stats_before.bytes == sent ) &&
+                   ( strcmp( clock.clock.text, "1:01" ) == 0 ));
+
+    pthread_mutex_lock( &ssd1322_fb[id]->lock );
+    memcpy( before, ssd1322_fb[id]->buffer, SSD1322_FB_BYTES );
+    pthread_mutex_unlock( &ssd1322_fb[id]->lock );
+    title_text = "Diamond City Radio (1957) - Fallout 4";
+    pass &= check( "Title change drawn, clipped to the label.",
+                   ( ssd1322_ui_update( &ui ) == 1 ) &&
+                   shows( id, &title, title_text, before ));
+
+    state    = 1;
+    bands[3] = -3;
+    pass &= check( "Icon and spectrum changes drawn.",
+                   ssd1322_ui_update( &ui ) == 2 );
+
+    ssd1322_ui_invalidate( &ui );
+    pass &= check( "Invalidate lays out and draws all.",
+                   ssd1322_ui_update( &ui ) == 7 );
+
+    // Time updates with nothing, the progress bar, and most things changing.
+    start = time_us();
+    for ( n = 0; n < UI_LOOPS; n++ ) ssd1322_ui_update( &ui );
+    idle = time_us() - start;
+
+    start = time_us();
+    for ( n = 0; n < UI_LOOPS; n++ )
+    {
+        position = ( n & 1 ) ? 0.25 : 0.75;
+        ssd1322_ui_update( &ui );
+    }
+    one = time_us() - start;
+
+    start = time_us();
+    for ( n = 0; n < UI_LOOPS; n++ )
+    {
+        position = ( n & 1 ) ? 0.25 : 0.75;
+        volume   = ( n & 1 ) ? -50 : -10;
+        elapsed  = n;
+        for ( i = 0; i < UI_BANDS; i++ ) bands[i] = -60 + ( n + i ) % 20 * 3;
+        ssd1322_ui_update( &ui );
+    }
+    many = time_us() - start;
+
+    printf( "\t%.2fus idle, %.2fus progress, %.2fus with 4 widgets.\n",
+            ( double )idle / UI_LOOPS, ( double )one / UI_LOOPS,
+            ( double )many / UI_LOOPS );
+    pass &= check( "Idle and single widget updates under 1ms.",
+                   ( idle < UI_LOOPS * 1000ull ) &&
+                   ( one < UI_LOOPS * 1000ull ));
+
+    ssd1322_fb_close( id );
+    gpioTerminate();
+    printf( "%s\n", pass ? "All tests passed." : "Some tests FAILED." );
+
+    return pass ? 0 : -1;
+}
@@ -0,0 +1,56 @@
+//  ===========================================================================
+/*
+    test-ssd1322:
+
+    Helpers shared by the SSD1322 tests.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+
+#ifndef TESTSSD1322_H
+#define TESTSSD1322_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+// ----------------------------------------------------------------------------
+/*
+    Returns monotonic time in microseconds.
+*/
+// ----------------------------------------------------------------------------
+static uint64_t time_us( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( uint64_t )now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// ----------------------------------------------------------------------------
+/*
+    Prints test result.
+*/
+// ----------------------------------------------------------------------------
+static bool check( const char *name, bool pass )
+{
+    printf( "%-48s %s\n", name, pass ? "pass" : "FAIL" );
+    return pass;
+}
+
+#endif
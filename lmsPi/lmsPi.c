@@ -0,0 +1,858 @@
+//  ===========================================================================
+/*
+    lmsPi:
+
+    Now playing information from Logitech Media Server through the CLI.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        LMS CLI documentation, Help > Technical Information > Command Line
+        Interface on any Logitech Media Server.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic lmsPi.c
+        gcc -shared -o liblmsPi.so lmsPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "lmsPi.h"
+
+#define LMS_SUBSCRIBE   "subscribe playlist,mixer,pause,play,stop,client,time"
+#define LMS_TAGS        "tags:adl"      // Artist, duration, album.
+#define LMS_JUMP        1.0             // Position error for a jump (s).
+#define LMS_PLAYER      "00:04:20:12:34:56" // Mock player.
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns time on the monotonic clock in seconds.
+//  ---------------------------------------------------------------------------
+double lms_time( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//  ---------------------------------------------------------------------------
+//  URL encodes a word.
+//  ---------------------------------------------------------------------------
+static void lms_encode( char *out, const char *in, size_t size )
+{
+    static const char hex[] = "0123456789ABCDEF";
+    const uint8_t *p = ( const uint8_t * )in;
+    size_t n = 0;
+
+    for ( ; *p && ( n + 4 < size ); p++ )
+    {
+        if ((( *p >= 'a' ) && ( *p <= 'z' )) ||
+            (( *p >= 'A' ) && ( *p <= 'Z' )) ||
+            (( *p >= '0' ) && ( *p <= '9' )) || strchr( "-_.~", *p ))
+            out[n++] = *p;
+        else
+        {
+            out[n++] = '%';
+            out[n++] = hex[*p >> 4];
+            out[n++] = hex[*p & 15];
+        }
+    }
+    out[n] = '\0';
+}
+
+//  ---------------------------------------------------------------------------
+//  URL decodes a word in place.
+//  ---------------------------------------------------------------------------
+static void lms_decode( char *s )
+{
+    char    *out = s;
+    uint8_t  hi, lo;
+
+    for ( ; *s; s++ )
+    {
+        if (( s[0] == '%' ) && s[1] && s[2] )
+        {
+            hi = ( s[1] <= '9' ) ? s[1] - '0' : ( s[1] | 0x20 ) - 'a' + 10;
+            lo = ( s[2] <= '9' ) ? s[2] - '0' : ( s[2] | 0x20 ) - 'a' + 10;
+            if (( hi < 16 ) && ( lo < 16 ))
+            {
+                *out++ = ( hi << 4 ) | lo;
+                s += 2;
+                continue;
+            }
+        }
+        *out++ = *s;
+    }
+    *out = '\0';
+}
+
+//  ---------------------------------------------------------------------------
+//  Splits a line into decoded words, returns number of words.
+//  ---------------------------------------------------------------------------
+static uint8_t lms_words( char *line, char **word )
+{
+    uint8_t n = 0;
+    char   *end;
+
+    while ( *line && ( n < LMS_WORDS ))
+    {
+        end = strchr( line, ' ' );
+        if ( end != NULL ) *end = '\0';
+        lms_decode( line );
+        word[n++] = line;
+        if ( end == NULL ) break;
+        line = end + 1;
+    }
+
+    return n;
+}
+
+//  ---------------------------------------------------------------------------
+//  Copies UTF-8 text, cut at a whole character.
+//  ---------------------------------------------------------------------------
+static void lms_copy( char *out, const char *in )
+{
+    size_t n = strlen( in );
+
+    if ( n >= LMS_FIELD )
+    {
+        n = LMS_FIELD - 1;
+        while (( n > 0 ) && (( in[n] & 0xc0 ) == 0x80 )) n--;
+    }
+    memcpy( out, in, n );
+    out[n] = '\0';
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets a text field, marking it changed if it differs.
+//  ---------------------------------------------------------------------------
+static void lms_text( struct lms_t *lms, char *field, const char *value,
+                      uint16_t bit )
+{
+    char copy[LMS_FIELD];
+
+    lms_copy( copy, value );
+    if ( strcmp( field, copy ) == 0 ) return;
+    strcpy( field, copy );
+    lms->changed |= bit;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets mode, keeping elapsed time right.
+//  ---------------------------------------------------------------------------
+static void lms_mode( struct lms_t *lms, uint8_t mode )
+{
+    struct lms_now_t *now = &lms->now;
+
+    if ( mode == now->mode ) return;
+    now->position = lms_elapsed( now );
+    now->stamp    = lms_time();
+    now->mode     = mode;
+    lms->changed |= LMS_MODE;
+}
+
+//  ---------------------------------------------------------------------------
+//  Queues a command.
+//  ---------------------------------------------------------------------------
+static int8_t lms_queue( struct lms_t *lms, const char *command )
+{
+    size_t length = strlen( command );
+
+    if ( lms->queued + length + 1 > LMS_OUT ) return -1;
+    memcpy( lms->out + lms->queued, command, length );
+    lms->out[lms->queued + length] = '\n';
+    lms->queued += length + 1;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Requests status, or again when the outstanding request is answered.
+//  ---------------------------------------------------------------------------
+static void lms_request( struct lms_t *lms )
+{
+    char player[LMS_FIELD * 3];
+    char line[LMS_FIELD * 3 + 32];
+
+    if ( lms->player[0] == '\0' ) return;
+    if ( lms->pending )
+    {
+        lms->again = true;
+        return;
+    }
+    lms_encode( player, lms->player, sizeof( player ));
+    snprintf( line, sizeof( line ), "%s status - 1 " LMS_TAGS, player );
+    if ( lms_queue( lms, line ) < 0 ) return;
+    lms->pending = true;
+    lms->requests++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads a status reply.
+//  ---------------------------------------------------------------------------
+/*
+    Fields missing from the reply, e.g. artist for a radio stream, are
+    cleared. Title, artist and album are taken from the track in the
+    playlist loop, after "playlist index".
+*/
+static void lms_status( struct lms_t *lms, char **word, uint8_t words )
+{
+    struct lms_now_t *now = &lms->now;
+    char     title[LMS_FIELD] = "", artist[LMS_FIELD] = "";
+    char     album[LMS_FIELD] = "";
+    double   time = 0, duration = 0, elapsed;
+    uint8_t  mode = LMS_STOP;
+    int16_t  volume = now->volume;
+    int32_t  index = -1;
+    bool     connected = now->connected;
+    bool     track = false;
+    char    *value;
+    uint8_t  i;
+
+    for ( i = 0; i < words; i++ )
+    {
+        value = strchr( word[i], ':' );
+        if ( value == NULL ) continue;
+        *value++ = '\0';
+
+        if ( strcmp( word[i], "playlist index" ) == 0 )
+        {
+            if ( track ) break;
+            track = true;
+        }
+        else if ( strcmp( word[i], "mode" ) == 0 )
+            mode = ( strcmp( value, "play" ) == 0 ) ? LMS_PLAY :
+                   ( strcmp( value, "pause" ) == 0 ) ? LMS_PAUSE : LMS_STOP;
+        else if ( strcmp( word[i], "time" ) == 0 ) time = atof( value );
+        else if ( strcmp( word[i], "duration" ) == 0 ) duration = atof( value );
+        else if ( strcmp( word[i], "mixer volume" ) == 0 )
+            volume = atoi( value );
+        else if ( strcmp( word[i], "playlist_cur_index" ) == 0 )
+            index = atoi( value );
+        else if ( strcmp( word[i], "player_connected" ) == 0 )
+            connected = ( atoi( value ) != 0 );
+        else if ( track && ( strcmp( word[i], "title" ) == 0 ))
+            lms_copy( title, value );
+        else if ( track && ( strcmp( word[i], "artist" ) == 0 ))
+            lms_copy( artist, value );
+        else if ( track && ( strcmp( word[i], "album" ) == 0 ))
+            lms_copy( album, value );
+    }
+
+    lms_text( lms, now->title, title, LMS_TITLE );
+    lms_text( lms, now->artist, artist, LMS_ARTIST );
+    lms_text( lms, now->album, album, LMS_ALBUM );
+    if ( duration != now->duration ) lms->changed |= LMS_DURATION;
+    if ( volume != now->volume ) lms->changed |= LMS_VOLUME;
+    if ( index != now->index ) lms->changed |= LMS_INDEX;
+    if ( connected != now->connected ) lms->changed |= LMS_CONNECTED;
+    if ( mode != now->mode ) lms->changed |= LMS_MODE;
+
+    // Only a jump is news, as displays work out elapsed time themselves.
+    elapsed = lms_elapsed( now );
+    if ( fabs( elapsed - time ) > LMS_JUMP ) lms->changed |= LMS_POSITION;
+
+    now->duration  = duration;
+    now->volume    = volume;
+    now->index     = index;
+    now->connected = connected;
+    now->mode      = mode;
+    now->position  = time;
+    now->stamp     = lms_time();
+
+    lms->pending = false;
+    if ( lms->again )
+    {
+        lms->again = false;
+        lms_request( lms );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Acts on one line from the server.
+//  ---------------------------------------------------------------------------
+static void lms_line( struct lms_t *lms, char *line )
+{
+    struct lms_now_t *now = &lms->now;
+    char    *word[LMS_WORDS];
+    uint8_t  words;
+    int      volume;
+
+    lms->lines++;
+    words = lms_words( line, word );
+    if ( words < 2 ) return;
+
+    // Reply to "player id 0 ?".
+    if (( strcmp( word[0], "player" ) == 0 ) &&
+        ( strcmp( word[1], "id" ) == 0 ))
+    {
+        if (( words == 4 ) && ( lms->player[0] == '\0' ) && word[3][0] )
+        {
+            lms_copy( lms->player, word[3] );
+            lms_request( lms );
+        }
+        return;
+    }
+
+    // Before any player is known, wait for one.
+    if ( lms->player[0] == '\0' )
+    {
+        if (( strcmp( word[1], "client" ) == 0 ) &&
+            ( lms_queue( lms, "player id 0 ?" ) < 0 )) return;
+        return;
+    }
+    if ( strcmp( word[0], lms->player ) != 0 ) return;
+
+    if ( strcmp( word[1], "status" ) == 0 )
+        lms_status( lms, word + 2, words - 2 );
+    else if (( strcmp( word[1], "playlist" ) == 0 ) && ( words > 2 ))
+    {
+        if (( strcmp( word[2], "newsong" ) == 0 ) && ( words > 3 ))
+        {
+            // Title now, the rest from status.
+            lms_text( lms, now->title, word[3], LMS_TITLE );
+            if (( words > 4 ) && ( atoi( word[4] ) != now->index ))
+            {
+                now->index = atoi( word[4] );
+                lms->changed |= LMS_INDEX;
+            }
+            lms_mode( lms, LMS_PLAY );
+            now->position = 0;
+            now->stamp    = lms_time();
+            lms->changed |= LMS_POSITION;
+            lms_request( lms );
+        }
+        else if (( strcmp( word[2], "pause" ) == 0 ) && ( words > 3 ))
+            lms_mode( lms, ( word[3][0] == '1' ) ? LMS_PAUSE : LMS_PLAY );
+        else if ( strcmp( word[2], "stop" ) == 0 ) lms_mode( lms, LMS_STOP );
+    }
+    else if ( strcmp( word[1], "pause" ) == 0 )
+    {
+        if ( words > 2 )
+            lms_mode( lms, ( word[2][0] == '1' ) ? LMS_PAUSE : LMS_PLAY );
+        else lms_request( lms );
+    }
+    else if ( strcmp( word[1], "stop" ) == 0 ) lms_mode( lms, LMS_STOP );
+    else if (( strcmp( word[1], "mixer" ) == 0 ) && ( words > 3 ) &&
+             ( strcmp( word[2], "volume" ) == 0 ))
+    {
+        // Volume may be relative, e.g. +2.
+        volume = atoi( word[3] );
+        if (( word[3][0] == '+' ) || ( word[3][0] == '-' ))
+            volume += now->volume;
+        if ( volume > 100 ) volume = 100;
+        if ( volume < -100 ) volume = -100;
+        if ( volume != now->volume )
+        {
+            now->volume = volume;
+            lms->changed |= LMS_VOLUME;
+        }
+    }
+    else if (( strcmp( word[1], "client" ) == 0 ) && ( words > 2 ))
+    {
+        if (( strcmp( word[2], "disconnect" ) == 0 ) ||
+            ( strcmp( word[2], "forget" ) == 0 ))
+        {
+            if ( now->connected ) lms->changed |= LMS_CONNECTED;
+            now->connected = false;
+        }
+        else lms_request( lms );
+    }
+    else if (( strcmp( word[1], "play" ) == 0 ) ||
+             ( strcmp( word[1], "time" ) == 0 ) ||
+             (( strcmp( word[1], "mixer" ) == 0 ) && ( words > 2 ) &&
+              ( strcmp( word[2], "muting" ) == 0 )))
+        lms_request( lms );
+}
+
+//  ---------------------------------------------------------------------------
+//  Parses bytes from the server, in pieces of any size.
+//  ---------------------------------------------------------------------------
+void lms_parse( struct lms_t *lms, const char *data, size_t length )
+{
+    const char *end;
+    size_t take;
+
+    while ( length > 0 )
+    {
+        end  = memchr( data, '\n', length );
+        take = ( end != NULL ) ? ( size_t )( end - data ) : length;
+
+        if ( !lms->skip )
+        {
+            if ( lms->used + take < LMS_LINE )
+            {
+                memcpy( lms->in + lms->used, data, take );
+                lms->used += take;
+            }
+            else lms->skip = true;
+        }
+        if ( end == NULL ) break;
+
+        if ( !lms->skip )
+        {
+            if (( lms->used > 0 ) && ( lms->in[lms->used - 1] == '\r' ))
+                lms->used--;
+            lms->in[lms->used] = '\0';
+            lms_line( lms, lms->in );
+        }
+        lms->used = 0;
+        lms->skip = false;
+        data   += take + 1;
+        length -= take + 1;
+    }
+
+    if ( lms->changed && ( lms->notify != NULL ))
+        lms->notify( &lms->now, lms->changed, lms->data );
+    lms->changed = 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Starts connecting to a server.
+//  ---------------------------------------------------------------------------
+int8_t lms_open( struct lms_t *lms, const char *host, uint16_t port,
+                 const char *player,
+                 void ( *notify )( const struct lms_now_t *now,
+                                   uint16_t changed, void *data ),
+                 void *data )
+{
+    struct addrinfo hints, *info;
+    char    service[8];
+    int     one = 1;
+
+    memset( lms, 0, sizeof( struct lms_t ));
+    lms->fd            = -1;
+    lms->notify        = notify;
+    lms->data          = data;
+    lms->now.index     = -1;
+    lms->now.connected = true;
+    lms->now.stamp     = lms_time();
+    if ( player != NULL ) lms_copy( lms->player, player );
+
+    memset( &hints, 0, sizeof( hints ));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf( service, sizeof( service ), "%u", port );
+    if ( getaddrinfo( host, service, &hints, &info ) != 0 ) return -1;
+
+    lms->fd = socket( info->ai_family,
+                      SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if (( lms->fd < 0 ) ||
+        (( connect( lms->fd, info->ai_addr, info->ai_addrlen ) < 0 ) &&
+         ( errno != EINPROGRESS )))
+    {
+        freeaddrinfo( info );
+        lms_close( lms );
+        return -1;
+    }
+    freeaddrinfo( info );
+    setsockopt( lms->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ));
+
+    // Sent once connected.
+    lms_queue( lms, LMS_SUBSCRIBE );
+    if ( lms->player[0] ) lms_request( lms );
+    else lms_queue( lms, "player id 0 ?" );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns poll events to wait for on lms->fd.
+//  ---------------------------------------------------------------------------
+short lms_events( const struct lms_t *lms )
+{
+    if ( !lms->ready ) return POLLOUT;
+
+    return POLLIN | ( lms->queued ? POLLOUT : 0 );
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads and writes whatever poll found ready.
+//  ---------------------------------------------------------------------------
+int8_t lms_service( struct lms_t *lms, short revents )
+{
+    char     buffer[4096];
+    ssize_t  n;
+    int      error = 0;
+    socklen_t size = sizeof( error );
+
+    if ( lms->fd < 0 ) return -1;
+    if (( revents & ( POLLERR | POLLHUP )) && !( revents & POLLIN ))
+        return -1;
+
+    if ( !lms->ready && ( revents & POLLOUT ))
+    {
+        if (( getsockopt( lms->fd, SOL_SOCKET, SO_ERROR, &error,
+                          &size ) < 0 ) || error ) return -1;
+        lms->ready = true;
+    }
+
+    if ( lms->ready && lms->queued && ( revents & POLLOUT ))
+    {
+        n = send( lms->fd, lms->out, lms->queued, MSG_NOSIGNAL );
+        if ( n < 0 )
+        {
+            if (( errno != EAGAIN ) && ( errno != EWOULDBLOCK )) return -1;
+        }
+        else
+        {
+            memmove( lms->out, lms->out + n, lms->queued - n );
+            lms->queued -= n;
+        }
+    }
+
+    if ( revents & POLLIN )
+        while ( true )
+        {
+            n = recv( lms->fd, buffer, sizeof( buffer ), 0 );
+            if ( n > 0 ) lms_parse( lms, buffer, n );
+            else if ( n == 0 ) return -1;
+            else if (( errno == EAGAIN ) || ( errno == EWOULDBLOCK )) break;
+            else if ( errno != EINTR ) return -1;
+        }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns elapsed time of the track now.
+//  ---------------------------------------------------------------------------
+double lms_elapsed( const struct lms_now_t *now )
+{
+    double elapsed = now->position;
+
+    if ( now->mode == LMS_PLAY ) elapsed += lms_time() - now->stamp;
+    if (( now->duration > 0 ) && ( elapsed > now->duration ))
+        elapsed = now->duration;
+
+    return elapsed;
+}
+
+//  ---------------------------------------------------------------------------
+//  Closes connection.
+//  ---------------------------------------------------------------------------
+void lms_close( struct lms_t *lms )
+{
+    if ( lms->fd >= 0 ) close( lms->fd );
+    lms->fd    = -1;
+    lms->ready = false;
+}
+
+//  Mock server. --------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Sends a line to the mock's client, with player id first if words.
+//  ---------------------------------------------------------------------------
+/*
+    Lines are short and the client is local, so a blocking send is fine.
+*/
+static void lms_mock_send( struct lms_mock_t *mock, const char *line )
+{
+    char   out[LMS_LINE];
+    size_t length;
+
+    if ( mock->fd < 0 ) return;
+    length = snprintf( out, sizeof( out ) - 1, "%s", line );
+    if ( length > sizeof( out ) - 2 ) length = sizeof( out ) - 2;
+    out[length++] = '\n';
+    send( mock->fd, out, length, MSG_NOSIGNAL );
+}
+
+//  ---------------------------------------------------------------------------
+//  Sends an event for the mock's player.
+//  ---------------------------------------------------------------------------
+static void lms_mock_event( struct lms_mock_t *mock, const char *event )
+{
+    char player[LMS_FIELD * 3];
+    char line[LMS_LINE];
+
+    if ( !mock->subscribed ) return;
+    lms_encode( player, mock->player, sizeof( player ));
+    snprintf( line, sizeof( line ), "%s %s", player, event );
+    lms_mock_send( mock, line );
+}
+
+//  ---------------------------------------------------------------------------
+//  Answers a status request.
+//  ---------------------------------------------------------------------------
+static void lms_mock_status( struct lms_mock_t *mock, const char *request )
+{
+    static const char *modes[] = { "stop", "play", "pause" };
+    struct lms_now_t *now = &mock->now;
+    char    line[LMS_LINE];
+    char    field[LMS_FIELD * 3 + 32], value[LMS_FIELD * 2];
+    size_t  n;
+
+    n = snprintf( line, sizeof( line ), "%s", request );
+
+#define LMS_MOCK_FIELD( ... ) \
+    snprintf( value, sizeof( value ), __VA_ARGS__ ); \
+    lms_encode( field, value, sizeof( field )); \
+    n += snprintf( line + n, sizeof( line ) - n, " %s", field );
+
+    LMS_MOCK_FIELD( "player_name:Mock" );
+    LMS_MOCK_FIELD( "player_connected:%u", now->connected );
+    LMS_MOCK_FIELD( "power:1" );
+    LMS_MOCK_FIELD( "signalstrength:0" );
+    LMS_MOCK_FIELD( "mode:%s", modes[now->mode] );
+    LMS_MOCK_FIELD( "time:%.3f", lms_elapsed( now ));
+    LMS_MOCK_FIELD( "rate:1" );
+    LMS_MOCK_FIELD( "duration:%.3f", now->duration );
+    LMS_MOCK_FIELD( "can_seek:1" );
+    LMS_MOCK_FIELD( "mixer volume:%d", now->volume );
+    LMS_MOCK_FIELD( "playlist repeat:0" );
+    LMS_MOCK_FIELD( "playlist shuffle:0" );
+    LMS_MOCK_FIELD( "playlist mode:off" );
+    if ( now->index >= 0 )
+    {
+        LMS_MOCK_FIELD( "playlist_cur_index:%d", now->index );
+        LMS_MOCK_FIELD( "playlist_tracks:%d", now->index + 1 );
+        LMS_MOCK_FIELD( "playlist index:%d", now->index );
+        LMS_MOCK_FIELD( "id:%d", 1000 + now->index );
+        LMS_MOCK_FIELD( "title:%s", now->title );
+        if ( now->artist[0] ) { LMS_MOCK_FIELD( "artist:%s", now->artist ); }
+        if ( now->album[0] ) { LMS_MOCK_FIELD( "album:%s", now->album ); }
+    }
+    else
+    {
+        LMS_MOCK_FIELD( "playlist_tracks:0" );
+    }
+#undef LMS_MOCK_FIELD
+
+    mock->statuses++;
+    lms_mock_send( mock, line );
+}
+
+//  ---------------------------------------------------------------------------
+//  Answers one command.
+//  ---------------------------------------------------------------------------
+static void lms_mock_line( struct lms_mock_t *mock, char *line )
+{
+    char    echo[LMS_LINE];
+    char    player[LMS_FIELD * 3];
+    char    line_copy[LMS_LINE];
+    char   *word[LMS_WORDS];
+    uint8_t words;
+
+    mock->commands++;
+    snprintf( echo, sizeof( echo ), "%s", line );
+    snprintf( line_copy, sizeof( line_copy ), "%s", line );
+    words = lms_words( line_copy, word );
+    if ( words == 0 ) return;
+
+    if (( words == 4 ) && ( strcmp( word[0], "player" ) == 0 ) &&
+        ( strcmp( word[1], "id" ) == 0 ))
+    {
+        lms_encode( player, mock->player, sizeof( player ));
+        snprintf( echo, sizeof( echo ), "player id %s %s", word[2], player );
+        lms_mock_send( mock, echo );
+    }
+    else if ( strcmp( word[0], "subscribe" ) == 0 )
+    {
+        mock->subscribed = true;
+        lms_mock_send( mock, echo );
+    }
+    else if (( words > 1 ) && ( strcmp( word[0], mock->player ) == 0 ) &&
+             ( strcmp( word[1], "status" ) == 0 ))
+        lms_mock_status( mock, echo );
+    else lms_mock_send( mock, echo );
+}
+
+//  ---------------------------------------------------------------------------
+//  Starts a mock server on localhost.
+//  ---------------------------------------------------------------------------
+int8_t lms_mock_open( struct lms_mock_t *mock, uint16_t port,
+                      const char *player )
+{
+    struct sockaddr_in address;
+    socklen_t size = sizeof( address );
+    int one = 1;
+
+    memset( mock, 0, sizeof( struct lms_mock_t ));
+    mock->fd            = -1;
+    mock->now.index     = -1;
+    mock->now.volume    = 50;
+    mock->now.connected = true;
+    mock->now.stamp     = lms_time();
+    lms_copy( mock->player, ( player != NULL ) ? player : LMS_PLAYER );
+
+    memset( &address, 0, sizeof( address ));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons( port );
+    address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+    mock->listen = socket( AF_INET,
+                           SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+    if ( mock->listen < 0 ) return -1;
+    setsockopt( mock->listen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ));
+    if (( bind( mock->listen, ( struct sockaddr * )&address,
+                sizeof( address )) < 0 ) ||
+        ( listen( mock->listen, 1 ) < 0 ) ||
+        ( getsockname( mock->listen, ( struct sockaddr * )&address,
+                       &size ) < 0 ))
+    {
+        close( mock->listen );
+        return -1;
+    }
+    mock->port = ntohs( address.sin_port );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Accepts a client and answers its commands, without blocking.
+//  ---------------------------------------------------------------------------
+void lms_mock_service( struct lms_mock_t *mock )
+{
+    char     buffer[1024];
+    ssize_t  n, i;
+
+    if ( mock->fd < 0 )
+    {
+        mock->fd = accept4( mock->listen, NULL, NULL, SOCK_CLOEXEC );
+        if ( mock->fd < 0 ) return;
+        mock->used = 0;
+        mock->subscribed = false;
+    }
+
+    while (( n = recv( mock->fd, buffer, sizeof( buffer ),
+                       MSG_DONTWAIT )) > 0 )
+        for ( i = 0; i < n; i++ )
+        {
+            if ( buffer[i] == '\n' )
+            {
+                if (( mock->used > 0 ) && ( mock->in[mock->used - 1] == '\r' ))
+                    mock->used--;
+                mock->in[mock->used] = '\0';
+                lms_mock_line( mock, mock->in );
+                mock->used = 0;
+            }
+            else if ( mock->used < LMS_LINE - 1 )
+                mock->in[mock->used++] = buffer[i];
+        }
+
+    if (( n == 0 ) ||
+        (( n < 0 ) && ( errno != EAGAIN ) && ( errno != EWOULDBLOCK )))
+    {
+        close( mock->fd );
+        mock->fd = -1;
+        mock->subscribed = false;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Starts a new track and sends the event.
+//  ---------------------------------------------------------------------------
+void lms_mock_play( struct lms_mock_t *mock, const char *title,
+                    const char *artist, const char *album,
+                    double duration )
+{
+    struct lms_now_t *now = &mock->now;
+    char   encoded[LMS_FIELD * 3];
+    char   event[LMS_FIELD * 3 + 32];
+
+    lms_copy( now->title, title );
+    lms_copy( now->artist, artist );
+    lms_copy( now->album, album );
+    now->duration = duration;
+    now->index++;
+    now->mode     = LMS_PLAY;
+    now->position = 0;
+    now->stamp    = lms_time();
+
+    lms_encode( encoded, now->title, sizeof( encoded ));
+    snprintf( event, sizeof( event ), "playlist newsong %s %d", encoded,
+              now->index );
+    lms_mock_event( mock, event );
+}
+
+//  ---------------------------------------------------------------------------
+//  Pauses or resumes and sends the event.
+//  ---------------------------------------------------------------------------
+void lms_mock_pause( struct lms_mock_t *mock, bool pause )
+{
+    struct lms_now_t *now = &mock->now;
+
+    if ( now->mode == LMS_STOP ) return;
+    now->position = lms_elapsed( now );
+    now->stamp    = lms_time();
+    now->mode     = pause ? LMS_PAUSE : LMS_PLAY;
+    lms_mock_event( mock, pause ? "playlist pause 1" : "playlist pause 0" );
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets volume and sends the event.
+//  ---------------------------------------------------------------------------
+void lms_mock_volume( struct lms_mock_t *mock, int16_t volume )
+{
+    char event[32];
+
+    mock->now.volume = volume;
+    snprintf( event, sizeof( event ), "mixer volume %d", volume );
+    lms_mock_event( mock, event );
+}
+
+//  ---------------------------------------------------------------------------
+//  Closes mock server.
+//  ---------------------------------------------------------------------------
+void lms_mock_close( struct lms_mock_t *mock )
+{
+    if ( mock->fd >= 0 ) close( mock->fd );
+    close( mock->listen );
+    mock->fd = -1;
+}
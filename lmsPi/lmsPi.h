@@ -0,0 +1,244 @@
+//  ===========================================================================
+/*
+    lmsPi:
+
+    Now playing information from Logitech Media Server through the CLI.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        LMS CLI documentation, Help > Technical Information > Command Line
+        Interface on any Logitech Media Server.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef LMSPI_H
+#define LMSPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    The CLI is a line protocol on TCP port 9090. Commands and replies are
+    words separated by spaces, each URL encoded, and a reply echoes the
+    command before its results, which are key:value words. After
+    "subscribe", the server also sends a line for every command any client
+    runs in the listed groups, e.g.
+
+        00%3A04%3A20%3A12%3A34%3A56 playlist newsong Title 3
+        00%3A04%3A20%3A12%3A34%3A56 mixer volume 45
+
+    so nothing needs to be polled. The client asks for "status" once at
+    start and again only after events that change what status would say,
+    with one request outstanding at a time however many events arrive.
+
+    The client never blocks. lms_open starts connecting, then lms_events
+    gives the poll events to wait for on lms->fd and lms_service reads and
+    writes whatever is ready, so it can share a poll loop with rotencPi or
+    a display. Bytes are split into lines as they arrive, and each line is
+    decoded in place into a cached lms_now_t. A field only counts as
+    changed if its value differs from the cache, and the notify function
+    is called once per batch of lines with a mask of what changed, so a
+    display only redraws what it must. Elapsed time is not sent every
+    second, but worked out from the time and position of the last status
+    by lms_elapsed.
+
+    The mock is a tiny stand in server for testing without LMS. It
+    accepts one client, answers "player id", "subscribe" and "status" for
+    one player and sends events for tracks, pauses and volume changes
+    made with the lms_mock functions.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define LMS_PORT        9090
+#define LMS_FIELD       128     // Bytes for a text field, UTF-8.
+#define LMS_LINE        4096    // Longest line, longer lines are skipped.
+#define LMS_OUT         1024    // Bytes of commands waiting to be sent.
+#define LMS_WORDS       96      // Words parsed per line.
+
+// Modes.
+#define LMS_STOP        0
+#define LMS_PLAY        1
+#define LMS_PAUSE       2
+
+// Changed fields.
+#define LMS_TITLE       0x0001
+#define LMS_ARTIST      0x0002
+#define LMS_ALBUM       0x0004
+#define LMS_DURATION    0x0008
+#define LMS_POSITION    0x0010  // Elapsed time jumped.
+#define LMS_MODE        0x0020
+#define LMS_VOLUME      0x0040
+#define LMS_INDEX       0x0080
+#define LMS_CONNECTED   0x0100  // Player connected to server.
+
+//  Types. --------------------------------------------------------------------
+
+struct lms_now_t
+{
+    char     title[LMS_FIELD];
+    char     artist[LMS_FIELD];
+    char     album[LMS_FIELD];
+    double   duration;              // s, 0 for streams.
+    double   position;              // s, at stamp.
+    double   stamp;                 // Monotonic time of position.
+    uint8_t  mode;
+    int16_t  volume;                // 0 to 100, negative if muted.
+    int32_t  index;                 // Track in playlist.
+    bool     connected;
+};
+
+struct lms_t
+{
+    int      fd;
+    bool     ready;                 // Connected.
+    char     player[LMS_FIELD];     // Player id, empty for first player.
+
+    char     in[LMS_LINE];          // Partial line.
+    uint16_t used;
+    bool     skip;                  // Skipping a long line.
+    char     out[LMS_OUT];          // Commands to send.
+    uint16_t queued;
+    bool     pending;               // Status requested.
+    bool     again;                 // Status needed after reply.
+
+    struct lms_now_t now;
+    uint16_t changed;
+    void   ( *notify )( const struct lms_now_t *now, uint16_t changed,
+                        void *data );
+    void    *data;
+
+    uint32_t lines;
+    uint32_t requests;
+};
+
+struct lms_mock_t
+{
+    int      listen;
+    int      fd;                    // Client, -1 if none.
+    uint16_t port;
+    char     player[LMS_FIELD];
+
+    char     in[LMS_LINE];
+    uint16_t used;
+    bool     subscribed;
+
+    struct lms_now_t now;
+    uint32_t commands;
+    uint32_t statuses;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns time on the monotonic clock in seconds.
+//  ---------------------------------------------------------------------------
+double lms_time( void );
+
+//  ---------------------------------------------------------------------------
+//  Starts connecting to a server.
+//  ---------------------------------------------------------------------------
+/*
+    player is the player id, usually its MAC address, or NULL for the
+    first player the server knows. notify may be NULL. Only resolving the
+    host may block. Returns 0 on success, -1 if the host can't be found or
+    a socket can't be made.
+*/
+int8_t lms_open( struct lms_t *lms, const char *host, uint16_t port,
+                 const char *player,
+                 void ( *notify )( const struct lms_now_t *now,
+                                   uint16_t changed, void *data ),
+                 void *data );
+
+//  ---------------------------------------------------------------------------
+//  Returns poll events to wait for on lms->fd.
+//  ---------------------------------------------------------------------------
+short lms_events( const struct lms_t *lms );
+
+//  ---------------------------------------------------------------------------
+//  Reads and writes whatever poll found ready.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0, or -1 if the connection failed or the server closed it.
+*/
+int8_t lms_service( struct lms_t *lms, short revents );
+
+//  ---------------------------------------------------------------------------
+//  Parses bytes from the server, in pieces of any size.
+//  ---------------------------------------------------------------------------
+/*
+    Called by lms_service, and directly for testing. Calls notify once if
+    any fields changed.
+*/
+void lms_parse( struct lms_t *lms, const char *data, size_t length );
+
+//  ---------------------------------------------------------------------------
+//  Returns elapsed time of the track now.
+//  ---------------------------------------------------------------------------
+double lms_elapsed( const struct lms_now_t *now );
+
+//  ---------------------------------------------------------------------------
+//  Closes connection.
+//  ---------------------------------------------------------------------------
+void lms_close( struct lms_t *lms );
+
+//  ---------------------------------------------------------------------------
+//  Starts a mock server on localhost.
+//  ---------------------------------------------------------------------------
+/*
+    Port 0 takes any free port, which is then in mock->port. Returns 0 on
+    success, -1 if the port can't be had.
+*/
+int8_t lms_mock_open( struct lms_mock_t *mock, uint16_t port,
+                      const char *player );
+
+//  ---------------------------------------------------------------------------
+//  Accepts a client and answers its commands, without blocking.
+//  ---------------------------------------------------------------------------
+void lms_mock_service( struct lms_mock_t *mock );
+
+//  ---------------------------------------------------------------------------
+//  Starts a new track and sends the event.
+//  ---------------------------------------------------------------------------
+void lms_mock_play( struct lms_mock_t *mock, const char *title,
+                    const char *artist, const char *album,
+                    double duration );
+
+//  ---------------------------------------------------------------------------
+//  Pauses or resumes and sends the event.
+//  ---------------------------------------------------------------------------
+void lms_mock_pause( struct lms_mock_t *mock, bool pause );
+
+//  ---------------------------------------------------------------------------
+//  Sets volume and sends the event.
+//  ---------------------------------------------------------------------------
+void lms_mock_volume( struct lms_mock_t *mock, int16_t volume );
+
+//  ---------------------------------------------------------------------------
+//  Closes mock server.
+//  ---------------------------------------------------------------------------
+void lms_mock_close( struct lms_mock_t *mock );
+
+#endif // #ifndef LMSPI_H
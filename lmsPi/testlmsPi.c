@@ -0,0 +1,473 @@
+/*
+//  ===========================================================================
+
+    testlmsPi:
+
+    Tests lmsPi against its mock server and times the parser.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc testlmsPi.c lmsPi.c -Wall -o testlmsPi -lm
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        testlmsPi               Runs tests against the mock server, then
+                                times parsing of status replies and events.
+        testlmsPi -s <host>     Prints changes from a server until Ctrl-C.
+        testlmsPi -m            Runs the mock server, changing track every
+                                10s, for testing displays without LMS.
+
+        -p <port>   Port (default 9090).
+        -i <id>     Player id (default the first player).
+
+    Returns 0 if all mock tests pass.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <math.h>
+
+#include "lmsPi.h"
+
+#define TEST_LINES      100000      // Lines parsed for timing.
+
+static uint8_t  failed = 0;
+static uint32_t notifies;
+static uint16_t changes;
+static volatile bool running = true;
+
+//  ---------------------------------------------------------------------------
+//  Prints result of a test.
+//  ---------------------------------------------------------------------------
+static void testCheck( const char *name, bool pass )
+{
+    printf( "%-48s %s\n", name, pass ? "pass" : "FAIL" );
+    if ( !pass ) failed++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Counts changes, as a display would redraw them.
+//  ---------------------------------------------------------------------------
+static void testNotify( const struct lms_now_t *now, uint16_t changed,
+                        void *data )
+{
+    notifies++;
+    changes |= changed;
+}
+
+//  ---------------------------------------------------------------------------
+//  Prints changes.
+//  ---------------------------------------------------------------------------
+static void testPrint( const struct lms_now_t *now, uint16_t changed,
+                       void *data )
+{
+    static const char *modes[] = { "stop", "play", "pause" };
+
+    if ( changed & ( LMS_TITLE | LMS_ARTIST | LMS_ALBUM ))
+        printf( "%s - %s - %s\n", now->title, now->artist, now->album );
+    if ( changed & ( LMS_MODE | LMS_POSITION | LMS_DURATION ))
+        printf( "  %s %.0f/%.0fs\n", modes[now->mode], lms_elapsed( now ),
+                now->duration );
+    if ( changed & LMS_VOLUME ) printf( "  volume %d\n", now->volume );
+    if ( changed & LMS_CONNECTED )
+        printf( "  player %s\n", now->connected ? "connected" :
+                                                  "disconnected" );
+}
+
+//  ---------------------------------------------------------------------------
+//  Stops on interrupt.
+//  ---------------------------------------------------------------------------
+static void testStop( int signal )
+{
+    running = false;
+}
+
+//  ---------------------------------------------------------------------------
+//  Services client and mock for a time.
+//  ---------------------------------------------------------------------------
+static bool testPump( struct lms_t *lms, struct lms_mock_t *mock,
+                      int ms )
+{
+    struct pollfd fds[3];
+    double end = lms_time() + ms / 1000.0;
+    int    timeout;
+
+    while (( timeout = ( end - lms_time()) * 1000 ) > 0 )
+    {
+        fds[0].fd     = lms->fd;
+        fds[0].events = lms_events( lms );
+        fds[1].fd     = mock->listen;
+        fds[1].events = POLLIN;
+        fds[2].fd     = mock->fd;
+        fds[2].events = POLLIN;
+        if ( poll( fds, 3, timeout ) < 0 ) continue;
+        if ( fds[1].revents || fds[2].revents ) lms_mock_service( mock );
+        if ( fds[0].revents &&
+             ( lms_service( lms, fds[0].revents ) < 0 )) return false;
+    }
+
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//  Tests client against mock server.
+//  ---------------------------------------------------------------------------
+static void testMock( void )
+{
+    struct lms_mock_t mock;
+    struct lms_t lms;
+    const char *title = "Caf\xc3\xa9: \xc2\xabLive\xc2\xbb 100% & more";
+    uint32_t commands, statuses, before;
+    double elapsed;
+
+    if ( lms_mock_open( &mock, 0, NULL ) < 0 )
+    {
+        testCheck( "Mock server starts", false );
+        return;
+    }
+    testCheck( "Client connects",
+               lms_open( &lms, "localhost", mock.port, NULL, testNotify,
+                         NULL ) == 0 );
+    testPump( &lms, &mock, 100 );
+    testCheck( "Finds player and subscribes",
+               ( strcmp( lms.player, mock.player ) == 0 ) &&
+               mock.subscribed && ( mock.statuses == 1 ));
+    testCheck( "Status of stopped player",
+               ( lms.now.mode == LMS_STOP ) && ( lms.now.volume == 50 ) &&
+               ( lms.now.title[0] == '\0' ));
+
+    notifies = changes = 0;
+    lms_mock_play( &mock, "Song One", "Artist One", "Album One", 200 );
+    testPump( &lms, &mock, 100 );
+    testCheck( "New song fills title, artist and album",
+               ( strcmp( lms.now.title, "Song One" ) == 0 ) &&
+               ( strcmp( lms.now.artist, "Artist One" ) == 0 ) &&
+               ( strcmp( lms.now.album, "Album One" ) == 0 ) &&
+               ( lms.now.duration == 200 ) && ( lms.now.mode == LMS_PLAY ) &&
+               ( lms.now.index == 0 ));
+    testCheck( "New song notifies title, then artist and album",
+               ( notifies == 2 ) && ( changes & LMS_TITLE ) &&
+               ( changes & LMS_ARTIST ) && ( changes & LMS_ALBUM ) &&
+               ( changes & LMS_DURATION ) && ( changes & LMS_MODE ));
+
+    notifies = changes = 0;
+    lms_mock_volume( &mock, 65 );
+    testPump( &lms, &mock, 50 );
+    testCheck( "Volume notifies volume only",
+               ( notifies == 1 ) && ( changes == LMS_VOLUME ) &&
+               ( lms.now.volume == 65 ));
+
+    notifies = 0;
+    lms_mock_volume( &mock, 65 );
+    lms_mock_pause( &mock, false );
+    testPump( &lms, &mock, 50 );
+    testCheck( "Events that change nothing don't notify", notifies == 0 );
+
+    notifies = changes = 0;
+    lms_mock_pause( &mock, true );
+    testPump( &lms, &mock, 50 );
+    elapsed = lms_elapsed( &lms.now );
+    testPump( &lms, &mock, 200 );
+    testCheck( "Pause notifies mode and stops elapsed time",
+               ( notifies == 1 ) && ( changes == LMS_MODE ) &&
+               ( lms.now.mode == LMS_PAUSE ) &&
+               ( lms_elapsed( &lms.now ) == elapsed ));
+
+    lms_mock_pause( &mock, false );
+    testPump( &lms, &mock, 300 );
+    elapsed = lms_elapsed( &lms.now ) - lms_elapsed( &mock.now );
+    testCheck( "Elapsed time follows server while playing",
+               fabs( elapsed ) < 0.05 );
+
+    notifies = changes = 0;
+    lms_mock_play( &mock, title, "", "", 0 );
+    testPump( &lms, &mock, 100 );
+    testCheck( "URL encoded UTF-8 title decodes",
+               strcmp( lms.now.title, title ) == 0 );
+    testCheck( "Stream clears artist, album and duration",
+               ( lms.now.artist[0] == '\0' ) && ( lms.now.album[0] == '\0' ) &&
+               ( lms.now.duration == 0 ) && ( changes & LMS_ARTIST ) &&
+               ( changes & LMS_INDEX ));
+
+    // Three events in one go need only one status after the first.
+    statuses = mock.statuses;
+    lms_mock_play( &mock, "A", "B", "C", 10 );
+    lms_mock_play( &mock, "D", "E", "F", 20 );
+    lms_mock_play( &mock, "G", "H", "I", 30 );
+    testPump( &lms, &mock, 100 );
+    testCheck( "Bursts of events are coalesced",
+               ( mock.statuses - statuses <= 2 ) &&
+               ( strcmp( lms.now.artist, "H" ) == 0 ) &&
+               ( lms.now.duration == 30 ));
+
+    commands = mock.commands;
+    before   = notifies;
+    testPump( &lms, &mock, 1500 );
+    testCheck( "Nothing is polled while idle",
+               ( mock.commands == commands ) && ( notifies == before ));
+
+    lms_mock_close( &mock );
+    testCheck( "Server closing is reported",
+               !testPump( &lms, &mock, 100 ));
+    lms_close( &lms );
+}
+
+//  ---------------------------------------------------------------------------
+//  Tests parsing of lines split anywhere.
+//  ---------------------------------------------------------------------------
+static void testSplit( void )
+{
+    static struct lms_t whole, split;
+    static char lines[LMS_LINE * 2];
+    size_t length, i;
+
+    length = snprintf( lines, sizeof( lines ),
+        "aa%%3Abb status - 1 tags%%3Aadl mode%%3Aplay time%%3A12.5 "
+        "duration%%3A300 mixer%%20volume%%3A40 playlist_cur_index%%3A2 "
+        "playlist%%20index%%3A2 title%%3ATitle%%20Two "
+        "artist%%3AN%%C3%%B8rd album%%3AThe%%20Album\r\n"
+        "aa%%3Abb mixer volume +5\n"
+        "cc%%3Add playlist newsong Other%%20player 1\n" );
+    memset( lines + length, 'x', LMS_LINE + 10 );
+    length += LMS_LINE + 10;
+    lines[length++] = '\n';
+    length += snprintf( lines + length, sizeof( lines ) - length,
+                        "aa%%3Abb playlist pause 1\n" );
+
+    memset( &whole, 0, sizeof( whole ));
+    memset( &split, 0, sizeof( split ));
+    strcpy( whole.player, "aa:bb" );
+    strcpy( split.player, "aa:bb" );
+    whole.fd = split.fd = -1;
+
+    lms_parse( &whole, lines, length );
+    for ( i = 0; i < length; i++ ) lms_parse( &split, lines + i, 1 );
+
+    testCheck( "Status reply parses",
+               ( strcmp( whole.now.title, "Title Two" ) == 0 ) &&
+               ( strcmp( whole.now.artist, "N\xc3\xb8rd" ) == 0 ) &&
+               ( strcmp( whole.now.album, "The Album" ) == 0 ) &&
+               ( whole.now.duration == 300 ) && ( whole.now.index == 2 ));
+    testCheck( "Relative volume, other players, long lines",
+               ( whole.now.volume == 45 ) && ( whole.lines == 4 ) &&
+               ( whole.now.mode == LMS_PAUSE ));
+    testCheck( "Lines split byte by byte parse the same",
+               ( strcmp( whole.now.title, split.now.title ) == 0 ) &&
+               ( strcmp( whole.now.artist, split.now.artist ) == 0 ) &&
+               ( strcmp( whole.now.album, split.now.album ) == 0 ) &&
+               ( whole.now.volume == split.now.volume ) &&
+               ( whole.now.mode == split.now.mode ) &&
+               ( whole.lines == split.lines ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Times parsing of typical lines.
+//  ---------------------------------------------------------------------------
+static void testBench( void )
+{
+    static struct lms_t lms;
+    static char status[LMS_LINE];
+    const char *events[] =
+    {
+        "00%3A04%3A20%3A12%3A34%3A56 mixer volume 42\n",
+        "00%3A04%3A20%3A12%3A34%3A56 playlist pause 0\n",
+        "00%3A04%3A20%3A12%3A34%3A56 playlist newsong "
+        "Symphony%20No.%205%20in%20C%20minor%2C%20Op.%2067%3A%20I. 7\n"
+    };
+    struct timespec start, end;
+    size_t  bytes = 0, length[4];
+    double  time;
+    uint32_t i;
+
+    length[3] = snprintf( status, sizeof( status ),
+        "00%%3A04%%3A20%%3A12%%3A34%%3A56 status - 1 tags%%3Aadl "
+        "player_name%%3ALiving%%20Room player_connected%%3A1 "
+        "player_ip%%3A192.168.1.20%%3A41234 power%%3A1 "
+        "signalstrength%%3A0 mode%%3Aplay time%%3A123.456 rate%%3A1 "
+        "duration%%3A452.3 can_seek%%3A1 mixer%%20volume%%3A42 "
+        "playlist%%20repeat%%3A0 playlist%%20shuffle%%3A0 "
+        "playlist%%20mode%%3Aoff seq_no%%3A0 playlist_cur_index%%3A7 "
+        "playlist_timestamp%%3A1476799342.123 playlist_tracks%%3A12 "
+        "playlist%%20index%%3A7 id%%3A12345 "
+        "title%%3ASymphony%%20No.%%205%%20in%%20C%%20minor%%2C%%20Op.%%2067"
+        "%%3A%%20I.%%20Allegro%%20con%%20brio "
+        "artist%%3ALudwig%%20van%%20Beethoven "
+        "album%%3ASymphonies%%205%%20%%26%%207\n" );
+    for ( i = 0; i < 3; i++ ) length[i] = strlen( events[i] );
+
+    memset( &lms, 0, sizeof( lms ));
+    strcpy( lms.player, "00:04:20:12:34:56" );
+    lms.fd = -1;
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    for ( i = 0; i < TEST_LINES; i++ )
+    {
+        lms_parse( &lms, events[i % 3], length[i % 3] );
+        bytes += length[i % 3];
+        lms.queued = 0;
+    }
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    time = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) / 1e9;
+    printf( "\nEvents: %.2fus per line, %.1fMB/s.\n",
+            time * 1e6 / TEST_LINES, bytes / 1e6 / time );
+
+    bytes = 0;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    for ( i = 0; i < TEST_LINES; i++ )
+    {
+        lms_parse( &lms, status, length[3] );
+        bytes += length[3];
+        lms.queued = 0;
+    }
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    time = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) / 1e9;
+    printf( "Status replies (%u bytes): %.2fus per line, %.1fMB/s.\n",
+            ( uint32_t )length[3], time * 1e6 / TEST_LINES,
+            bytes / 1e6 / time );
+}
+
+//  ---------------------------------------------------------------------------
+//  Prints changes from a server.
+//  ---------------------------------------------------------------------------
+static int testServer( const char *host, uint16_t port, const char *player )
+{
+    struct lms_t lms;
+    struct pollfd fd;
+
+    if ( lms_open( &lms, host, port, player, testPrint, NULL ) < 0 )
+    {
+        fprintf( stderr, "Can't find %s.\n", host );
+        return 1;
+    }
+    signal( SIGINT, testStop );
+    while ( running )
+    {
+        fd.fd     = lms.fd;
+        fd.events = lms_events( &lms );
+        if ( poll( &fd, 1, -1 ) < 0 ) continue;
+        if ( lms_service( &lms, fd.revents ) < 0 )
+        {
+            fprintf( stderr, "Connection to %s lost.\n", host );
+            break;
+        }
+    }
+    lms_close( &lms );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs the mock server for displays.
+//  ---------------------------------------------------------------------------
+static int testMockServer( uint16_t port, const char *player )
+{
+    static const char *tracks[][3] =
+    {
+        { "Heroes", "David Bowie", "Heroes" },
+        { "Teardrop", "Massive Attack", "Mezzanine" },
+        { "Hyperballad", "Bj\xc3\xb6rk", "Post" },
+        { "Windowlicker", "Aphex Twin", "Windowlicker" }
+    };
+    struct lms_mock_t mock;
+    struct pollfd fds[2];
+    double next = 0;
+    uint8_t track = 0;
+
+    if ( lms_mock_open( &mock, port, player ) < 0 )
+    {
+        fprintf( stderr, "Can't listen on port %u.\n", port );
+        return 1;
+    }
+    printf( "Mock server for player %s on port %u.\n", mock.player,
+            mock.port );
+    signal( SIGINT, testStop );
+    while ( running )
+    {
+        if ( lms_time() >= next )
+        {
+            lms_mock_play( &mock, tracks[track][0], tracks[track][1],
+                           tracks[track][2], 10 );
+            printf( "Playing %s.\n", tracks[track][0] );
+            track = ( track + 1 ) % 4;
+            next  = lms_time() + 10;
+        }
+        fds[0].fd     = mock.listen;
+        fds[0].events = POLLIN;
+        fds[1].fd     = mock.fd;
+        fds[1].events = POLLIN;
+        if (( poll( fds, 2, 100 ) > 0 )) lms_mock_service( &mock );
+    }
+    lms_mock_close( &mock );
+
+    return 0;
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    char    *host = NULL;
+    char    *player = NULL;
+    uint16_t port = LMS_PORT;
+    bool     mock = false;
+    int      opt;
+
+    while (( opt = getopt( argc, argv, "s:p:i:m" )) != -1 )
+    {
+        switch ( opt )
+        {
+            case 's': host = optarg; break;
+            case 'p': port = atoi( optarg ); break;
+            case 'i': player = optarg; break;
+            case 'm': mock = true; break;
+            default:
+                printf( "Usage: %s [-s host | -m] [-p port] [-i player]\n",
+                        argv[0] );
+                return 1;
+        }
+    }
+
+    if ( host != NULL ) return testServer( host, port, player );
+    if ( mock ) return testMockServer( port, player );
+
+    testMock();
+    testSplit();
+    testBench();
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,251 @@
+//  ===========================================================================
+/*
+    fftPi:
+
+    Spectrum analysis of the meter stream for spectrum and waterfall
+    displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic fftPi.c -lm
+        gcc -shared -o libfftPi.so fftPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "fftPi.h"
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Allocates and initialises tables for a transform of size samples.
+//  ---------------------------------------------------------------------------
+int8_t fft_init( struct fft_t *fft, uint16_t size )
+{
+    uint16_t i, j, bits;
+
+    if (( size < FFT_SIZE_MIN ) || ( size > FFT_SIZE_MAX ) ||
+        ( size & ( size - 1 ))) return -1;
+
+    memset( fft, 0, sizeof( struct fft_t ));
+    fft->size = size;
+    fft->half = size / 2;
+
+    fft->cos     = malloc(( fft->half + 1 ) * sizeof( float ));
+    fft->sin     = malloc(( fft->half + 1 ) * sizeof( float ));
+    fft->reverse = malloc( fft->half * sizeof( uint16_t ));
+    fft->window  = malloc( size * sizeof( float ));
+    fft->re      = malloc( fft->half * sizeof( float ));
+    fft->im      = malloc( fft->half * sizeof( float ));
+    fft->power   = malloc(( fft->half + 1 ) * sizeof( float ));
+
+    if (( fft->cos == NULL ) || ( fft->sin == NULL ) ||
+        ( fft->reverse == NULL ) || ( fft->window == NULL ) ||
+        ( fft->re == NULL ) || ( fft->im == NULL ) || ( fft->power == NULL ))
+    {
+        fft_free( fft );
+        return -2;
+    }
+
+    for ( i = 0; i <= fft->half; i++ )
+    {
+        fft->cos[i] = cosf( 2 * M_PI * i / size );
+        fft->sin[i] = sinf( 2 * M_PI * i / size );
+    }
+
+    // Hann window, scaled so that samples are normalised to +/-1.
+    for ( i = 0; i < size; i++ )
+        fft->window[i] = ( 0.5 - 0.5 * cos( 2 * M_PI * i / size )) / 32768.0;
+
+    for ( bits = 0; ( 1 << bits ) < fft->half; bits++ );
+    for ( i = 0; i < fft->half; i++ )
+    {
+        fft->reverse[i] = 0;
+        for ( j = 0; j < bits; j++ )
+            if ( i & ( 1 << j )) fft->reverse[i] |= 1 << ( bits - 1 - j );
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets logarithmically spaced display bands between fmin and rate / 2.
+//  ---------------------------------------------------------------------------
+int8_t fft_set_bands( struct fft_t *fft, uint16_t bands,
+                      uint32_t rate, float fmin )
+{
+    uint16_t band;
+    float    fmax = rate / 2.0;
+    float    bin;
+
+    if (( bands == 0 ) || ( rate == 0 ) ||
+        ( fmin <= 0 ) || ( fmin >= fmax )) return -1;
+
+    free( fft->edge );
+    fft->edge = malloc(( bands + 1 ) * sizeof( uint16_t ));
+    if ( fft->edge == NULL ) return -2;
+    fft->bands = bands;
+
+    for ( band = 0; band <= bands; band++ )
+    {
+        bin = fmin * powf( fmax / fmin, ( float )band / bands ) *
+              fft->size / rate;
+        fft->edge[band] = ( uint16_t )( bin + 0.5 );
+
+        // Skip DC and make sure every band has at least one bin.
+        if ( fft->edge[band] < 1 ) fft->edge[band] = 1;
+        if (( band > 0 ) && ( fft->edge[band] <= fft->edge[band - 1] ))
+            fft->edge[band] = fft->edge[band - 1] + 1;
+        if ( fft->edge[band] > fft->half + 1 )
+            fft->edge[band] = fft->half + 1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Transforms size samples, storing bin powers in fft->power.
+//  ---------------------------------------------------------------------------
+void fft_power( struct fft_t *fft, const int16_t *samples, uint8_t stride )
+{
+    uint16_t half = fft->half;
+    uint16_t i, j, k, len, step;
+    float    *re = fft->re;
+    float    *im = fft->im;
+    float    tr, ti, wr, wi;
+    float    ar, ai, br, bi, er, ei, odr, odi, xr, xi;
+    float    scale;
+
+    // Pack even samples into real parts and odd into imaginary parts, in
+    // bit reversed order, applying the window.
+    for ( i = 0; i < half; i++ )
+    {
+        j = fft->reverse[i];
+        re[j] = samples[( 2 * i ) * stride] * fft->window[2 * i];
+        im[j] = samples[( 2 * i + 1 ) * stride] * fft->window[2 * i + 1];
+    }
+
+    // Iterative radix-2 butterflies. Twiddle j / len of the half point
+    // transform is entry 2 * j * ( half / len ) of the size point tables.
+    for ( len = 2; len <= half; len <<= 1 )
+    {
+        step = 2 * ( half / len );
+        for ( i = 0; i < half; i += len )
+        {
+            for ( j = 0; j < len / 2; j++ )
+            {
+                wr =  fft->cos[j * step];
+                wi = -fft->sin[j * step];
+                k  = i + j + len / 2;
+                tr = re[k] * wr - im[k] * wi;
+                ti = re[k] * wi + im[k] * wr;
+                re[k] = re[i + j] - tr;
+                im[k] = im[i + j] - ti;
+                re[i + j] += tr;
+                im[i + j] += ti;
+            }
+        }
+    }
+
+    // Split into the spectrum of the real input. Bin k is
+    // E(k) + W(k) O(k) where E and O are the spectra of the even and odd
+    // samples, recovered from Z(k) and conj( Z( half - k )).
+    // Full scale sine with a Hann window peaks at size / 4.
+    scale = 16.0 / (( float )fft->size * fft->size );
+    for ( k = 0; k <= half; k++ )
+    {
+        ar = re[k % half];
+        ai = im[k % half];
+        br = re[( half - k ) % half];
+        bi = im[( half - k ) % half];
+
+        er  = 0.5 * ( ar + br );
+        ei  = 0.5 * ( ai - bi );
+        odr = 0.5 * ( ai + bi );
+        odi = 0.5 * ( br - ar );
+
+        xr = er + fft->cos[k] * odr + fft->sin[k] * odi;
+        xi = ei + fft->cos[k] * odi - fft->sin[k] * odr;
+
+        fft->power[k] = ( xr * xr + xi * xi ) * scale;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Transforms size samples and returns band levels (dBFS) in bands.
+//  ---------------------------------------------------------------------------
+void fft_bands( struct fft_t *fft, const int16_t *samples, uint8_t stride,
+                float *bands )
+{
+    uint16_t band, bin;
+    float    peak;
+    float    floor = powf( 10, FFT_FLOOR_DB / 10.0 );
+
+    fft_power( fft, samples, stride );
+
+    for ( band = 0; band < fft->bands; band++ )
+    {
+        peak = floor;
+        for ( bin = fft->edge[band]; bin < fft->edge[band + 1]; bin++ )
+            if ( fft->power[bin] > peak ) peak = fft->power[bin];
+        bands[band] = 10 * log10f( peak );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Frees tables.
+//  ---------------------------------------------------------------------------
+void fft_free( struct fft_t *fft )
+{
+    free( fft->cos );
+    free( fft->sin );
+    free( fft->reverse );
+    free( fft->window );
+    free( fft->re );
+    free( fft->im );
+    free( fft->power );
+    free( fft->edge );
+    memset( fft, 0, sizeof( struct fft_t ));
+}
@@ -0,0 +1,117 @@
+//  ===========================================================================
+/*
+    fftPi:
+
+    Spectrum analysis of the meter stream for spectrum and waterfall
+    displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef FFTPI_H
+#define FFTPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    A radix-2 FFT with all tables built once by fft_init, so the transform
+    itself does no allocation and no trigonometry.
+
+    Audio is real, so a size N transform is done as an N/2 point complex
+    FFT with even samples in the real part and odd samples in the imaginary
+    part, followed by a split pass that recovers bins 0 to N/2. This halves
+    the work compared with a complex FFT with zero imaginary parts.
+
+    Bins are grouped into logarithmically spaced bands for display. Each band
+    reports the peak bin power in dBFS, where 0dBFS is a full scale sine.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define FFT_SIZE_MIN      64 // Smallest transform size.
+#define FFT_SIZE_MAX    8192 // Largest transform size.
+#define FFT_FLOOR_DB    -120 // Level reported for silence (dBFS).
+
+//  Types. --------------------------------------------------------------------
+
+struct fft_t
+{
+    uint16_t size;      // Transform size (real samples).
+    uint16_t half;      // size / 2 (complex points).
+    float    *cos;      // cos( 2 pi k / size ), k = 0 to half.
+    float    *sin;      // sin( 2 pi k / size ), k = 0 to half.
+    uint16_t *reverse;  // Bit reversed indices for half point FFT.
+    float    *window;   // Hann window.
+    float    *re;       // Work buffer (real parts).
+    float    *im;       // Work buffer (imaginary parts).
+    float    *power;    // Bin powers, 0 to half.
+    uint16_t bands;     // Number of display bands.
+    uint16_t *edge;     // First bin of each band, bands + 1 entries.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Allocates and initialises tables for a transform of size samples.
+//  ---------------------------------------------------------------------------
+/*
+    size must be a power of 2 between FFT_SIZE_MIN and FFT_SIZE_MAX.
+    Returns 0 on success, -1 for an invalid size, -2 if out of memory.
+*/
+int8_t fft_init( struct fft_t *fft, uint16_t size );
+
+//  ---------------------------------------------------------------------------
+//  Sets logarithmically spaced display bands between fmin and rate / 2.
+//  ---------------------------------------------------------------------------
+/*
+    Each band covers at least one bin, so low bands may be wider than
+    requested when the transform is short.
+    Returns 0 on success, -1 for invalid arguments, -2 if out of memory.
+*/
+int8_t fft_set_bands( struct fft_t *fft, uint16_t bands,
+                      uint32_t rate, float fmin );
+
+//  ---------------------------------------------------------------------------
+//  Transforms size samples, storing bin powers in fft->power.
+//  ---------------------------------------------------------------------------
+/*
+    samples are read every stride values, so one channel of an interleaved
+    buffer can be analysed directly.
+*/
+void fft_power( struct fft_t *fft, const int16_t *samples, uint8_t stride );
+
+//  ---------------------------------------------------------------------------
+//  Transforms size samples and returns band levels (dBFS) in bands.
+//  ---------------------------------------------------------------------------
+void fft_bands( struct fft_t *fft, const int16_t *samples, uint8_t stride,
+                float *bands );
+
+//  ---------------------------------------------------------------------------
+//  Frees tables.
+//  ---------------------------------------------------------------------------
+void fft_free( struct fft_t *fft );
+
+#endif // #ifndef FFTPI_H
@@ -93,6 +93,8 @@ static struct vis_t
 }  *vis_mmap = NULL;
 
 
+static struct gain_shm_t *gain_mmap = NULL;
+
 static bool running = false;
 static int  vis_fd = -1;
 static char *mac_address = NULL;
@@ -382,6 +384,68 @@ void get_dBfs( struct peak_meter_t *peak_meter )
 }
 
 
+//  ---------------------------------------------------------------------------
+//  Copies stream samples written since the last call into buffer.
+//  ---------------------------------------------------------------------------
+/*
+    Unlike get_dBfs, which looks back over a fixed window, this only returns
+    samples that have not been seen before so that consumers building
+    incremental structures (e.g. waveform displays) never process a sample
+    twice. If squeezelite has lapped the reader then the oldest samples are
+    lost and only the most recent buffer length is available.
+*/
+uint32_t get_samples( int16_t *buffer, uint32_t frames, uint32_t *index )
+{
+    int16_t  *vis_buffer;
+    uint32_t len, idx, avail, offs, count, i;
+
+    vis_check();
+
+    if ( !vis_get_playing() ) return 0;
+
+    vis_lock();
+
+    vis_buffer = vis_get_buffer();
+    len = vis_get_buffer_len();
+    idx = vis_get_buffer_idx();
+
+    if (( vis_buffer == NULL ) || ( len == 0 ) || ( idx >= len ))
+    {
+        vis_unlock();
+        return 0;
+    }
+
+    // First call, or buffer resized - start from the current position.
+    if (( *index == VIS_INDEX_NONE ) || ( *index >= len ))
+    {
+        *index = idx;
+        vis_unlock();
+        return 0;
+    }
+
+    // Samples written since the last call, in whole frames.
+    avail = ( idx + len - *index ) % len;
+    avail /= METER_CHANNELS;
+    if ( avail > frames ) avail = frames;
+
+    // Start far enough back to return the most recent frames.
+    offs = ( idx + len - avail * METER_CHANNELS ) % len;
+    count = avail * METER_CHANNELS;
+
+    for ( i = 0; i < count; i++ )
+    {
+        buffer[i] = vis_buffer[offs];
+        if ( ++offs >= len ) offs = 0;
+    }
+
+    *index = idx;
+
+    vis_unlock();
+
+    return avail;
+}
+
+
 //  ---------------------------------------------------------------------------
 //  Calculates the indices for string representations of the peak levels.
 //  ---------------------------------------------------------------------------
@@ -464,3 +528,60 @@ void get_dB_indices( struct peak_meter_t *peak_meter )
         }
     }
 }
+
+//  ---------------------------------------------------------------------------
+//  Reads gain reduction published by the streamPi limiter.
+//  ---------------------------------------------------------------------------
+/*
+    The limiter writes from its audio thread without locking, so the
+    values are re-read if the sequence count changes during the read, up to
+    GAIN_READ_TRIES times. The mapping is dropped once the limiter clears
+    running, so a restarted limiter's new object is opened on a later call.
+*/
+bool get_gain_reduction( float *limit, float *comp )
+{
+    static uint32_t periods = 0;
+    uint32_t seq;
+    uint32_t count;
+    uint8_t  tries = 0;
+    int      fd;
+
+    if ( !gain_mmap )
+    {
+        fd = shm_open( GAIN_SHM, O_RDONLY, 0 );
+        if ( fd < 0 ) return false;
+        gain_mmap = mmap( NULL, sizeof( struct gain_shm_t ), PROT_READ,
+                          MAP_SHARED, fd, 0 );
+        close( fd );
+        if ( gain_mmap == MAP_FAILED )
+        {
+            gain_mmap = NULL;
+            return false;
+        }
+    }
+
+    if ( !__atomic_load_n( &gain_mmap->running, __ATOMIC_ACQUIRE ))
+    {
+        munmap( gain_mmap, sizeof( struct gain_shm_t ));
+        gain_mmap = NULL;
+        periods   = 0;
+        return false;
+    }
+
+    do
+    {
+        if ( tries++ == GAIN_READ_TRIES ) return false;
+        seq    = __atomic_load_n( &gain_mmap->seq, __ATOMIC_ACQUIRE );
+        count  = gain_mmap->periods;
+        *limit = gain_mmap->limit;
+        *comp  = gain_mmap->comp;
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    }
+    while (( seq & 1 ) ||
+           ( seq != __atomic_load_n( &gain_mmap->seq, __ATOMIC_RELAXED )));
+
+    if ( count == periods ) return false;
+    periods = count;
+
+    return true;
+}
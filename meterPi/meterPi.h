@@ -32,6 +32,8 @@
         v01.01      Renamed and converted to library.
         v01.02      Added hold and fall timing.
         v01.03      Added overload detection.
+        v01.04      Added incremental sample reader.
+        v01.05      Added gain reduction from streamPi limiter.
 */
 //  ===========================================================================
 
@@ -142,9 +144,21 @@
 #define PEAK_METER_LEVELS_MAX 48 // Number of peak meter intervals / LEDs.
 #define METER_CHANNELS 2 // Number of metered channels.
 #define OVERLOAD_PEAKS 3 // Number of consecutive 0dBFS peaks for overload.
+#define GAIN_SHM "/streamPi-limit" // Gain reduction from streamPi limiter.
+#define GAIN_READ_TRIES 8 // Reads of gain reduction before giving up.
 
 //  Types. --------------------------------------------------------------------
 
+// Must match struct limit_shm_t in streamPi/limitPi.h.
+struct gain_shm_t
+{
+    uint32_t seq;       // Odd while being written.
+    uint32_t periods;   // Periods processed.
+    uint32_t running;   // Cleared when the limiter stops.
+    float    limit;     // Limiter gain reduction (dB).
+    float    comp;      // Compressor gain reduction (dB).
+};
+
 struct peak_meter_t
 {
     uint16_t int_time;   // Integration time (ms).
@@ -185,9 +199,34 @@ uint32_t vis_get_rate( void );
 //  ---------------------------------------------------------------------------
 void get_dBfs( struct peak_meter_t *peak_meter );
 
+//  ---------------------------------------------------------------------------
+//  Copies stream samples written since the last call into buffer.
+//  ---------------------------------------------------------------------------
+/*
+    buffer receives interleaved frames (METER_CHANNELS samples per frame).
+    frames is the capacity of buffer in frames.
+    index holds the shared buffer position between calls. Set it to
+    VIS_INDEX_NONE before the first call to start from the current position.
+    Returns the number of frames copied. If more frames were written than
+    will fit then only the most recent ones are returned.
+*/
+#define VIS_INDEX_NONE 0xffffffff
+uint32_t get_samples( int16_t *buffer, uint32_t frames, uint32_t *index );
+
 //  ---------------------------------------------------------------------------
 //  Calculates the indices for string representations of the peak levels.
 //  ---------------------------------------------------------------------------
 void get_dB_indices( struct peak_meter_t *peak_meter );
 
+//  ---------------------------------------------------------------------------
+//  Reads gain reduction published by the streamPi limiter.
+//  ---------------------------------------------------------------------------
+/*
+    limit and comp receive the limiter and compressor gain reduction (dB)
+    over the last period processed. Returns false if the limiter isn't
+    running, hasn't processed anything since the last call or is writing
+    on every one of GAIN_READ_TRIES attempts.
+*/
+bool get_gain_reduction( float *limit, float *comp );
+
 #endif // #ifndef METERPI_H
@@ -23,8 +23,11 @@
 /*
     Compile with:
 
-        gcc -c -Wall meterPi.c testmeterPi-lcd.c -o testmeterPi-lcd
-               -lm -lpthread -lrt -lncurses
+        gcc -Wall meterPi.c testmeterPi-lcd.c
+            ../displayPi/hd44780i2c/hd44780task.c
+            ../displayPi/hd44780i2c/hd44780i2c.c
+            ../displayPi/hd44780i2c/mcp23017.c
+            -o testmeterPi-lcd -lm -lpthread -lrt
 
     For Raspberry Pi v1 optimisation use the following flags:
 
@@ -59,8 +62,9 @@
 //  Local libraries -------------------------------------------------------
 
 #include "meterPi.h"
-#include "hd44780i2c.h"
-#include "mcp23017.h"
+#include "../displayPi/hd44780i2c/hd44780i2c.h"
+#include "../displayPi/hd44780i2c/mcp23017.h"
+#include "../displayPi/hd44780i2c/hd44780task.h"
 
 //  Information. --------------------------------------------------------------
 /*
@@ -112,7 +116,8 @@
 //  Functions. ----------------------------------------------------------------
 
 #define METER_LEVELS 16 // 16x2 LCD.
-#define METER_DELAY 1
+#define METER_DELAY 1   // Delay between meter updates (uS).
+#define METER_LOOPS 10  // Updates timed to set the peak hold.
 
 pthread_mutex_t displayBusy;
 
@@ -127,7 +132,7 @@ struct peak_meter_t peak_meter =
     .int_time       = 1,
     .samples        = 2,
     .hold_time      = 500,
-    .hold_count     = 3,
+    .hold_incs      = 3,
     .num_levels     = 16,
     .floor          = -80,
     .reference      = 32768,
@@ -194,25 +199,48 @@ void get_peak_strings( struct peak_meter_t peak_meter,
 
 
 //  ---------------------------------------------------------------------------
-//  Updates Meter display.
+//  Reads the meter levels and draws them into shadow RAM.
 //  ---------------------------------------------------------------------------
-void *update_meter()
+/*
+    The custom characters are written as their mirrors at 8-15, since shadow
+    RAM is text and 0 would end it.
+*/
+void draw_meter( struct hd44780Shadow *shadow )
 {
-    while ( 1 )
+    char    text[METER_LEVELS + 1];
+    uint8_t channel, i;
+
+    get_dBfs( &peak_meter );
+    get_dB_indices( &peak_meter );
+    get_peak_strings( peak_meter, lcd_meter );
+
+    for ( channel = 0; channel < METER_CHANNELS; channel++ )
     {
-        get_dBfs( &peak_meter );
-        get_dB_indices( &peak_meter );
-        get_peak_strings( peak_meter, lcd_meter );
+        for ( i = 0; i < METER_LEVELS; i++ )
+            text[i] = lcd_meter[channel][i] + CUSTOM_MIRROR;
+        text[i] = '\0';
+        hd44780ShadowWrite( shadow, channel, 0, text );
+    }
+}
 
-        pthread_mutex_lock( &displayBusy );
-        hd44780Goto( mcp23017[0], hd44780[0], 0, 0 );
-        hd44780WriteString( mcp23017[0], hd44780[0], lcd_meter[0], 16 );
-        hd44780Goto( mcp23017[0], hd44780[0], 1, 0 );
-        hd44780WriteString( mcp23017[0], hd44780[0], lcd_meter[1], 16 );
-        pthread_mutex_unlock( &displayBusy );
+//  ---------------------------------------------------------------------------
+//  Updates Meter display.
+//  ---------------------------------------------------------------------------
+/*
+    Runs as a scheduler task, which sends the changed characters and holds
+    displayBusy for it.
+*/
+int8_t update_meter( struct hd44780Task *task )
+{
+    TASK_BEGIN( task );
 
-        usleep( METER_DELAY );
+    while ( 1 )
+    {
+        draw_meter( task->shadow );
+        TASK_YIELD( task, METER_DELAY );
     }
+
+    TASK_END( task );
 }
 
 
@@ -254,6 +282,9 @@ int main( void )
     };
 
     struct hd44780 *hd44780this;
+    struct hd44780Scheduler scheduler;
+    struct hd44780Task meter;
+    struct hd44780Shadow *shadow;
 
     int8_t err;
 
@@ -327,7 +358,12 @@ int main( void )
     vis_check();
 
     pthread_mutex_init( &displayBusy, NULL );
-    pthread_t threads[1];
+
+    // The display has just been cleared, as shadow RAM assumes.
+    hd44780SchedulerInit( &scheduler );
+    hd44780TaskAdd( &scheduler, &meter, update_meter, NULL,
+                    mcp23017[0], hd44780[0], PRIORITY_HIGH, 0 );
+    shadow = meter.shadow;
 
     // Calculate number of samples for integration time.
 	peak_meter.samples = vis_get_rate() * peak_meter.int_time / 1000;
@@ -337,35 +373,24 @@ int main( void )
 
     // Do some loops to test response time.
     gettimeofday( &start, NULL );
-    for ( i = 0; i < TEST_LOOPS; i++ )
+    for ( i = 0; i < METER_LOOPS; i++ )
     {
-        get_dBfs( &peak_meter );
-        get_dB_indices( &peak_meter );
-        get_peak_strings( peak_meter, lcd_meter );
-
-        // Write to LCD.
-        hd44780Goto( mcp23017[0], hd44780[0], 0, 0 );
-        hd44780WriteString( mcp23017[0], hd44780[0], lcd_meter[0], 16 );
-        hd44780Goto( mcp23017[0], hd44780[0], 1, 0 );
-        hd44780WriteString( mcp23017[0], hd44780[0], lcd_meter[1], 16 );
+        draw_meter( shadow );
+        hd44780SchedulerFlush( &scheduler );
         usleep( METER_DELAY );
-
     }
     gettimeofday( &end, NULL );
 
     elapsed = (( end.tv_sec  - start.tv_sec  ) * 1000 +
-               ( end.tv_usec - start.tv_usec ) / 1000 ) / 10;
+               ( end.tv_usec - start.tv_usec ) / 1000 ) / METER_LOOPS;
 
-    if ( elapsed < peak_meter.hold_time )
-        peak_meter.hold_count = peak_meter.hold_time / elapsed;
-    pthread_create( &threads[0], NULL, update_meter, NULL );
+    if (( elapsed > 0 ) && ( elapsed < peak_meter.hold_time ))
+        peak_meter.hold_incs = peak_meter.hold_time / elapsed;
 
-    while ( 1 )
-    {
-    };
+    // Runs forever.
+    hd44780SchedulerRun( &scheduler, 0 );
 
     pthread_mutex_destroy( &displayBusy );
-    pthread_exit( NULL );
 
     return 0;
 }
@@ -75,6 +75,7 @@
     48000 Hz = 41.7 us.
 */
 #define CALIBRATION_LOOPS 300
+#define GR_TIMEOUT 100 // Loops without a new period before GR is cleared.
 
 //  ---------------------------------------------------------------------------
 //  Produces string representations of the peak meters.
@@ -285,6 +286,8 @@ int main( void )
     mvwprintw( meter_win, 3, 2, "-40  -35  -30  -25  -20  -15  -10  -5    0 dBFS" );
 
     int ch = ERR;
+    float gr_limit, gr_comp;
+    uint16_t gr_age = GR_TIMEOUT;
     while ( ch == ERR )
     {
 
@@ -312,6 +315,16 @@ int main( void )
         mvwchgat( meter_win, 5, 34,  5, A_NORMAL, 2, NULL );
         mvwchgat( meter_win, 5, 39, 10, A_NORMAL, 3, NULL );
 
+        // Gain reduction if streamPi limiter is running, cleared once it
+        // stops publishing.
+        if ( get_gain_reduction( &gr_limit, &gr_comp ))
+        {
+            mvwprintw( meter_win, 6, 3, " GR %5.1fdB ", gr_limit + gr_comp );
+            gr_age = 0;
+        }
+        else if (( gr_age < GR_TIMEOUT ) && ( ++gr_age == GR_TIMEOUT ))
+            mvwprintw( meter_win, 6, 3, "            " );
+
         // Refresh ncurses window to display.
         wrefresh( meter_win );
         ch = wgetch( meter_win );
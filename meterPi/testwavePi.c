@@ -0,0 +1,232 @@
+//  ===========================================================================
+/*
+    testwavePi:
+
+    Tests the wavePi pyramid and scrolling render without a display.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Compile with:
+
+        gcc -Wall testwavePi.c wavePi.c meterPi.c -o testwavePi
+            -lm -lpthread -lrt
+
+    Samples are fed through wave_pyramid_add in uneven blocks and every
+    entry of every level is compared with the min/max of the samples it
+    covers. The render is checked by scrolling a view one step at a time
+    and comparing it with a full redraw into a second framebuffer.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdbool.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "meterPi.h"
+#include "wavePi.h"
+
+//  Macros. -------------------------------------------------------------------
+
+#define TEST_BASE    2      // Level 0 covers 4 samples.
+#define TEST_LEVELS  6
+#define TEST_SAMPLES 40003  // Fills every level's ring, plus a part entry.
+#define TEST_STRIDE  128    // Framebuffer row, as the SSD1322 (bytes).
+#define TEST_ROWS    64
+#define TEST_FILL    0xa5   // Framebuffer outside the view.
+
+static int16_t samples[TEST_SAMPLES];
+static uint8_t failed = 0;
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Prints result of a test.
+//  ---------------------------------------------------------------------------
+static void test_check( const char *name, bool pass )
+{
+    printf( "%-48s %s\n", name, pass ? "pass" : "FAIL" );
+    if ( !pass ) failed++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds count samples from samples[*fed] in uneven blocks.
+//  ---------------------------------------------------------------------------
+/*
+    Samples are interleaved with noise to check the stride.
+*/
+static void test_feed( struct wave_pyramid_t *pyramid, uint32_t *fed,
+                       uint32_t count )
+{
+    static int16_t block[2 * 97];
+    uint32_t n, i;
+
+    while ( count > 0 )
+    {
+        n = 1 + rand() % 97;
+        if ( n > count ) n = count;
+        for ( i = 0; i < n; i++ )
+        {
+            block[2 * i]     = samples[( *fed + i ) % TEST_SAMPLES];
+            block[2 * i + 1] = rand();
+        }
+        wave_pyramid_add( pyramid, block, n, 2 );
+        *fed  += n;
+        count -= n;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Checks every entry kept at each level against the samples it covers.
+//  ---------------------------------------------------------------------------
+static bool test_levels( struct wave_pyramid_t *pyramid, uint32_t fed )
+{
+    struct wave_entry_t entry;
+    uint32_t span, count, n, e, i;
+    int16_t  min, max;
+    uint8_t  k;
+
+    for ( k = 0; k < pyramid->levels; k++ )
+    {
+        span  = 1 << ( pyramid->base + k );
+        count = fed / span;
+        if ( pyramid->level[k].count != count ) return false;
+
+        for ( n = 0; ( n < count ) && ( n < WAVE_ENTRIES ); n++ )
+        {
+            e = count - 1 - n;
+            min = INT16_MAX;
+            max = INT16_MIN;
+            for ( i = e * span; i < ( e + 1 ) * span; i++ )
+            {
+                if ( samples[i] < min ) min = samples[i];
+                if ( samples[i] > max ) max = samples[i];
+            }
+            entry = wave_pyramid_entry( pyramid, k, n );
+            if (( entry.min != min ) || ( entry.max != max )) return false;
+        }
+    }
+
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//  Draws level of pyramid into a fresh framebuffer.
+//  ---------------------------------------------------------------------------
+static void test_redraw( struct wave_pyramid_t *pyramid, uint8_t level,
+                         struct wave_view_t *view, uint8_t *fb )
+{
+    struct wave_view_t full = *view;
+
+    memset( fb, TEST_FILL, TEST_STRIDE * TEST_ROWS );
+    full.fb    = fb;
+    full.valid = false;
+    wave_render( pyramid, level, &full );
+}
+
+//  ---------------------------------------------------------------------------
+//  Main (for testing).
+//  ---------------------------------------------------------------------------
+int main( void )
+{
+    static uint8_t fb[TEST_STRIDE * TEST_ROWS];
+    static uint8_t ref[TEST_STRIDE * TEST_ROWS];
+    static const uint16_t steps[] = { 1, 2, 3, 7, 1, 12, 5 };
+    struct wave_pyramid_t pyramid;
+    struct wave_view_t    view;
+    uint32_t fed = 0, i;
+    uint16_t drawn;
+    bool     counted, scrolled;
+
+    srand( 1 );
+    for ( i = 0; i < TEST_SAMPLES; i++ )
+        samples[i] = ( rand() % 65536 ) - 32768;
+
+    // Pyramid.
+    wave_pyramid_init( &pyramid, TEST_BASE, TEST_LEVELS );
+    test_feed( &pyramid, &fed, TEST_SAMPLES );
+    test_check( "Min/max of every entry at every level.",
+                test_levels( &pyramid, fed ));
+
+    test_check( "Level chosen from samples per column.",
+                ( wave_pyramid_level( &pyramid, 1 ) == 0 ) &&
+                ( wave_pyramid_level( &pyramid, 8 ) == 1 ) &&
+                ( wave_pyramid_level( &pyramid, 100 ) == 4 ) &&
+                ( wave_pyramid_level( &pyramid, 1 << 20 ) ==
+                  TEST_LEVELS - 1 ));
+
+    // Render.
+    memset( &view, 0, sizeof( view ));
+    view.fb     = fb;
+    view.stride = TEST_STRIDE;
+    view.x      = 10;
+    view.y      = 8;
+    view.width  = 200;
+    view.height = 48;
+    view.grey   = 15;
+
+    for ( i = 0; i < TEST_SAMPLES; i++ )
+        samples[i] = 20000 * ((( i / 37 ) % 5 ) - 2 ) / 2 + rand() % 2000;
+    wave_pyramid_init( &pyramid, TEST_BASE, TEST_LEVELS );
+    fed = 0;
+    test_feed( &pyramid, &fed, 300 << ( TEST_BASE + 1 ));
+
+    memset( fb, TEST_FILL, sizeof( fb ));
+    drawn = wave_render( &pyramid, 1, &view );
+    test_redraw( &pyramid, 1, &view, ref );
+    test_check( "First frame draws every column.",
+                ( drawn == view.width ) && !memcmp( fb, ref, sizeof( fb )));
+
+    test_check( "No new entries, nothing drawn.",
+                wave_render( &pyramid, 1, &view ) == 0 );
+
+    counted  = true;
+    scrolled = true;
+    for ( i = 0; i < sizeof( steps ) / sizeof( steps[0] ); i++ )
+    {
+        test_feed( &pyramid, &fed, steps[i] << ( TEST_BASE + 1 ));
+        drawn = wave_render( &pyramid, 1, &view );
+        test_redraw( &pyramid, 1, &view, ref );
+        if ( drawn != steps[i] ) counted = false;
+        if ( memcmp( fb, ref, sizeof( fb ))) scrolled = false;
+    }
+    test_check( "Only new columns drawn.", counted );
+    test_check( "Scrolled view matches a full redraw.", scrolled );
+
+    drawn = wave_render( &pyramid, 2, &view );
+    test_redraw( &pyramid, 2, &view, ref );
+    test_check( "Change of level redraws every column.",
+                ( drawn == view.width ) && !memcmp( fb, ref, sizeof( fb )));
+
+    if ( failed ) printf( "%u test(s) FAILED.\n", failed );
+    else printf( "All tests passed.\n" );
+
+    return failed ? -1 : 0;
+}
@@ -0,0 +1,310 @@
+//  ===========================================================================
+/*
+    wavePi:
+
+    Min/max waveform decimation pyramid for scrolling waveform displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic wavePi.c meterPi.c -lm -lpthread -lrt
+        gcc -shared -o libwavePi.so wavePi.o meterPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdbool.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "meterPi.h"
+#include "wavePi.h"
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns an empty entry, i.e. one that any merge will overwrite.
+//  ---------------------------------------------------------------------------
+static inline struct wave_entry_t wave_entry_empty( void )
+{
+    struct wave_entry_t entry = { .min = INT16_MAX, .max = INT16_MIN };
+    return entry;
+}
+
+//  ---------------------------------------------------------------------------
+//  Stores an entry at level k and carries completed pairs up the pyramid.
+//  ---------------------------------------------------------------------------
+static void wave_push( struct wave_pyramid_t *pyramid, uint8_t k,
+                       struct wave_entry_t entry )
+{
+    struct wave_level_t *level;
+
+    while ( k < pyramid->levels )
+    {
+        level = &pyramid->level[k];
+        level->entry[ level->count % WAVE_ENTRIES ] = entry;
+        level->count++;
+
+        // Hold the first of each pair, merge and carry the second.
+        if ( !level->half )
+        {
+            level->pending = entry;
+            level->half = true;
+            return;
+        }
+
+        if ( level->pending.min < entry.min ) entry.min = level->pending.min;
+        if ( level->pending.max > entry.max ) entry.max = level->pending.max;
+        level->half = false;
+        k++;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises a pyramid. Level 0 entries cover 2^base samples.
+//  ---------------------------------------------------------------------------
+void wave_pyramid_init( struct wave_pyramid_t *pyramid,
+                        uint8_t base, uint8_t levels )
+{
+    if ( levels > WAVE_LEVELS_MAX ) levels = WAVE_LEVELS_MAX;
+    if ( levels < 1 ) levels = 1;
+    if ( base > 16 ) base = 16;
+
+    memset( pyramid, 0, sizeof( struct wave_pyramid_t ));
+    pyramid->base   = base;
+    pyramid->levels = levels;
+    pyramid->acc    = wave_entry_empty();
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds samples to a pyramid. stride is the distance between samples.
+//  ---------------------------------------------------------------------------
+void wave_pyramid_add( struct wave_pyramid_t *pyramid,
+                       const int16_t *samples, uint32_t count,
+                       uint8_t stride )
+{
+    uint32_t i;
+    uint32_t span = 1 << pyramid->base;
+    int16_t  sample;
+
+    for ( i = 0; i < count; i++ )
+    {
+        sample = *samples;
+        samples += stride;
+
+        if ( sample < pyramid->acc.min ) pyramid->acc.min = sample;
+        if ( sample > pyramid->acc.max ) pyramid->acc.max = sample;
+
+        if ( ++pyramid->acc_n >= span )
+        {
+            wave_push( pyramid, 0, pyramid->acc );
+            pyramid->acc   = wave_entry_empty();
+            pyramid->acc_n = 0;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns the level whose entries best match samples per column.
+//  ---------------------------------------------------------------------------
+uint8_t wave_pyramid_level( struct wave_pyramid_t *pyramid,
+                            uint32_t samples_per_col )
+{
+    uint8_t k = 0;
+
+    // floor( log2( samples_per_col )).
+    while (( samples_per_col >>= 1 ) > 0 ) k++;
+
+    if ( k <= pyramid->base ) return 0;
+    k -= pyramid->base;
+    if ( k >= pyramid->levels ) k = pyramid->levels - 1;
+
+    return k;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns entry n of a level, counting back from the most recent (n = 0).
+//  ---------------------------------------------------------------------------
+struct wave_entry_t wave_pyramid_entry( struct wave_pyramid_t *pyramid,
+                                        uint8_t level, uint32_t n )
+{
+    struct wave_entry_t silence = { 0, 0 };
+    struct wave_level_t *this;
+
+    if ( level >= pyramid->levels ) return silence;
+    this = &pyramid->level[level];
+
+    if (( n >= WAVE_ENTRIES ) || ( n >= this->count )) return silence;
+
+    return this->entry[( this->count - 1 - n ) % WAVE_ENTRIES ];
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises pyramids for all channels and starts reading the stream.
+//  ---------------------------------------------------------------------------
+void wave_init( struct wave_t *wave, uint8_t base, uint8_t levels )
+{
+    uint8_t channel;
+
+    for ( channel = 0; channel < METER_CHANNELS; channel++ )
+        wave_pyramid_init( &wave->pyramid[channel], base, levels );
+
+    wave->index = VIS_INDEX_NONE;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads new samples from the stream into the pyramids.
+//  ---------------------------------------------------------------------------
+uint32_t wave_update( struct wave_t *wave )
+{
+    static int16_t buffer[ WAVE_READ_MAX * METER_CHANNELS ];
+    uint32_t frames;
+    uint8_t  channel;
+
+    // The read buffer covers the whole shared buffer so one read drains it.
+    frames = get_samples( buffer, WAVE_READ_MAX, &wave->index );
+    for ( channel = 0; channel < METER_CHANNELS; channel++ )
+        wave_pyramid_add( &wave->pyramid[channel], &buffer[channel],
+                          frames, METER_CHANNELS );
+
+    return frames;
+}
+
+//  ---------------------------------------------------------------------------
+//  Maps a sample value to a view row (0 = top).
+//  ---------------------------------------------------------------------------
+static inline uint8_t wave_row( int16_t value, uint8_t height )
+{
+    return (( int32_t )( INT16_MAX - value ) * ( height - 1 )) / 65535;
+}
+
+//  ---------------------------------------------------------------------------
+//  Draws a single column of the view from an entry.
+//  ---------------------------------------------------------------------------
+static void wave_draw_column( struct wave_view_t *view, uint16_t col,
+                              struct wave_entry_t entry )
+{
+    uint16_t x = view->x + col;
+    uint8_t  *pixel = view->fb + view->y * view->stride + x / 2;
+    uint8_t  mask = ( x & 1 ) ? 0xf0 : 0x0f;  // Nibble kept.
+    uint8_t  on = ( x & 1 ) ? view->grey & 0x0f : view->grey << 4;
+    uint8_t  top, bottom, row;
+
+    if ( entry.min > entry.max ) entry.min = entry.max = 0;
+
+    top    = wave_row( entry.max, view->height );
+    bottom = wave_row( entry.min, view->height );
+
+    for ( row = 0; row < view->height; row++ )
+    {
+        *pixel &= mask;
+        if (( row >= top ) && ( row <= bottom )) *pixel |= on;
+        pixel += view->stride;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Scrolls a packed row of the view left by fresh columns.
+//  ---------------------------------------------------------------------------
+/*
+    The columns uncovered at the right hand edge are left as they were, to
+    be drawn over. An odd shift moves each pixel to the other nibble.
+*/
+static void wave_scroll_row( uint8_t *line, uint16_t width, uint16_t fresh )
+{
+    uint16_t bytes = width / 2;
+    uint16_t shift = fresh / 2;
+    uint16_t i;
+
+    if (( fresh & 1 ) == 0 )
+    {
+        memmove( line, line + shift, bytes - shift );
+        return;
+    }
+
+    for ( i = 0; i + shift + 1 < bytes; i++ )
+        line[i] = ( line[i + shift] << 4 ) | ( line[i + shift + 1] >> 4 );
+    line[i] = line[i + shift] << 4;
+}
+
+//  ---------------------------------------------------------------------------
+//  Draws a scrolling waveform into a framebuffer.
+//  ---------------------------------------------------------------------------
+uint16_t wave_render( struct wave_pyramid_t *pyramid, uint8_t level,
+                      struct wave_view_t *view )
+{
+    uint32_t count, fresh;
+    uint16_t col, width;
+    uint8_t  row;
+    uint8_t  *line;
+
+    if ( level >= pyramid->levels ) level = pyramid->levels - 1;
+
+    width = view->width & ~1;
+    if ( width > WAVE_ENTRIES ) width = WAVE_ENTRIES;
+
+    count = pyramid->level[level].count;
+    fresh = count - view->drawn;
+
+    // Redraw everything if there is no usable previous frame.
+    if (( !view->valid ) || ( view->level != level ) || ( fresh >= width ))
+        fresh = width;
+    else if ( fresh > 0 )
+    {
+        // Scroll the existing columns left to make room for the new ones.
+        for ( row = 0; row < view->height; row++ )
+        {
+            line = view->fb + ( view->y + row ) * view->stride + view->x / 2;
+            wave_scroll_row( line, width, fresh );
+        }
+    }
+
+    // Draw the new columns, newest at the right hand edge.
+    for ( col = width - fresh; col < width; col++ )
+        wave_draw_column( view, col,
+                          wave_pyramid_entry( pyramid, level,
+                                              width - 1 - col ));
+
+    view->level = level;
+    view->drawn = count;
+    view->valid = true;
+
+    return fresh;
+}
@@ -0,0 +1,189 @@
+//  ===========================================================================
+/*
+    wavePi:
+
+    Min/max waveform decimation pyramid for scrolling waveform displays.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef WAVEPI_H
+#define WAVEPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    A scrolling waveform needs the minimum and maximum sample values that
+    fall into each display column. Recomputing these from the raw samples
+    every frame costs (samples per column x columns) per frame, which gets
+    expensive when zoomed out.
+
+    Instead, each channel keeps a pyramid of min/max pairs. Level 0 holds one
+    entry per 2^base samples, level 1 one entry per 2^(base+1) samples and so
+    on, each entry at level k+1 being the merge of two adjacent entries at
+    level k:
+
+        level 2   [     min/max     ][     min/max     ]
+        level 1   [ min/max][min/max][ min/max][min/max]
+        level 0   [mm][mm][mm][mm][mm][mm][mm][mm][mm][mm]
+        samples   ................................................
+
+    Entries are built as samples arrive, so the cost is O(1) amortised per
+    sample regardless of the number of levels. Each level is a ring holding
+    the most recent WAVE_ENTRIES entries, which is one per display column,
+    so memory is fixed at WAVE_LEVELS_MAX x WAVE_ENTRIES x 4 bytes/channel.
+
+    The renderer picks the level whose entry width matches the horizontal
+    zoom (samples per column) and draws one column per entry. Only entries
+    added since the previous frame are drawn; the rest of the view is
+    shifted across, so the work per frame is proportional to the number of
+    new columns.
+
+    The view is drawn straight into an SSD1322 framebuffer, which is packed
+    4 bits per pixel with the left pixel in the high nibble. The view's x
+    and width must be even so each row of the view starts and ends on a
+    byte. To draw on a panel, hold its framebuffer lock around the render
+    and mark the view dirty if anything was drawn:
+
+        struct ssd1322_fb_t *fb = ssd1322_fb[id];
+
+        view.fb     = fb->buffer;
+        view.stride = SSD1322_FB_ROW_BYTES;
+
+        pthread_mutex_lock( &fb->lock );
+        if ( wave_render( pyramid, level, &view ) > 0 )
+            ssd1322_fb_mark_dirty_locked( fb, view.x, view.y,
+                                          view.width, view.height );
+        pthread_mutex_unlock( &fb->lock );
+
+    The whole view is marked because the old columns have moved, but only
+    the new columns are drawn.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define WAVE_LEVELS_MAX  12 // Number of pyramid levels.
+#define WAVE_ENTRIES    256 // Entries per level (one per display column).
+#define WAVE_READ_MAX ( VIS_BUF_SIZE / METER_CHANNELS ) // Frames per read.
+
+//  Types. --------------------------------------------------------------------
+
+struct wave_entry_t
+{
+    int16_t min; // Minimum sample value.
+    int16_t max; // Maximum sample value.
+};
+
+struct wave_level_t
+{
+    struct wave_entry_t entry[WAVE_ENTRIES]; // Ring of entries.
+    uint32_t            count;               // Entries written (ever).
+    struct wave_entry_t pending;             // Half-built entry for level+1.
+    bool                half;                // Pending holds one entry.
+};
+
+struct wave_pyramid_t
+{
+    uint8_t             base;     // Level 0 covers 2^base samples per entry.
+    uint8_t             levels;   // Number of levels in use.
+    uint32_t            acc_n;    // Samples accumulated towards level 0.
+    struct wave_entry_t acc;      // Level 0 accumulator.
+    struct wave_level_t level[WAVE_LEVELS_MAX];
+};
+
+struct wave_t
+{
+    uint32_t              index; // Stream position for get_samples.
+    struct wave_pyramid_t pyramid[METER_CHANNELS];
+};
+
+struct wave_view_t
+{
+    uint8_t  *fb;       // Framebuffer, packed 4 bits per pixel.
+    uint16_t stride;    // Framebuffer row (bytes).
+    uint16_t x;         // View left edge (even).
+    uint8_t  y;         // View top edge.
+    uint16_t width;     // View width (even columns, <= WAVE_ENTRIES).
+    uint8_t  height;    // View height (rows).
+    uint8_t  grey;      // Waveform greyscale (0 to 15).
+    uint8_t  level;     // Level drawn in the previous frame.
+    uint32_t drawn;     // Level count at the previous frame.
+    bool     valid;     // View holds a previous frame.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises a pyramid. Level 0 entries cover 2^base samples.
+//  ---------------------------------------------------------------------------
+void wave_pyramid_init( struct wave_pyramid_t *pyramid,
+                        uint8_t base, uint8_t levels );
+
+//  ---------------------------------------------------------------------------
+//  Adds samples to a pyramid. stride is the distance between samples.
+//  ---------------------------------------------------------------------------
+void wave_pyramid_add( struct wave_pyramid_t *pyramid,
+                       const int16_t *samples, uint32_t count,
+                       uint8_t stride );
+
+//  ---------------------------------------------------------------------------
+//  Returns the level whose entries best match samples per column.
+//  ---------------------------------------------------------------------------
+uint8_t wave_pyramid_level( struct wave_pyramid_t *pyramid,
+                            uint32_t samples_per_col );
+
+//  ---------------------------------------------------------------------------
+//  Returns entry n of a level, counting back from the most recent (n = 0).
+//  ---------------------------------------------------------------------------
+struct wave_entry_t wave_pyramid_entry( struct wave_pyramid_t *pyramid,
+                                        uint8_t level, uint32_t n );
+
+//  ---------------------------------------------------------------------------
+//  Initialises pyramids for all channels and starts reading the stream.
+//  ---------------------------------------------------------------------------
+void wave_init( struct wave_t *wave, uint8_t base, uint8_t levels );
+
+//  ---------------------------------------------------------------------------
+//  Reads new samples from the stream into the pyramids.
+//  ---------------------------------------------------------------------------
+/*
+    Returns the number of new frames.
+*/
+uint32_t wave_update( struct wave_t *wave );
+
+//  ---------------------------------------------------------------------------
+//  Draws a scrolling waveform into a packed framebuffer.
+//  ---------------------------------------------------------------------------
+/*
+    Draws level of pyramid into view. Only columns added since the previous
+    call are drawn unless the level changed or the view has been invalidated
+    (view->valid = false), in which case the whole view is redrawn.
+    Returns the number of columns drawn.
+*/
+uint16_t wave_render( struct wave_pyramid_t *pyramid, uint8_t level,
+                      struct wave_view_t *view );
+
+#endif // #ifndef WAVEPI_H
@@ -0,0 +1,493 @@
+/*
+//  ===========================================================================
+
+    ls7366r:
+
+    LS7366R quadrature counter encoder backend for rotencPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        LS7366R data sheet.
+        - see http://www.lsicsi.com/pdfs/Data_Sheets/LS7366R.pdf
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compile with:
+
+        gcc -c -fpic -Wall ls7366r.c rotencPi.c -lwiringPi -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v0.1    Original version.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include <wiringPi.h>
+#include <wiringPiSPI.h>
+
+#include "rotencPi.h"
+#include "ls7366r.h"
+
+// Mutex lock from rotencPi.
+extern pthread_mutex_t encoderBusy;
+
+// Only one LS7366R can be serviced by a wiringPi interrupt.
+static struct ls7366r *ls7366rInterrupt = NULL;
+
+//  ---------------------------------------------------------------------------
+//  Returns counter width in bytes from MDR1.
+//  ---------------------------------------------------------------------------
+static uint8_t ls7366rBytes( uint8_t mdr1 )
+{
+    return 4 - ( mdr1 & 0x03 );
+}
+
+//  ---------------------------------------------------------------------------
+//  SPI transfer using wiringPi. data points to SPI channel (int).
+//  ---------------------------------------------------------------------------
+int ls7366rSpiXfer( void *data, uint8_t *buffer, uint8_t len )
+{
+    int channel = *(int *)data;
+
+    if ( wiringPiSPIDataRW( channel, buffer, len ) < 0 ) return -1;
+    return len;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sends instruction and len bytes of data. Returns 0 or -1 on error.
+//  ---------------------------------------------------------------------------
+static int8_t ls7366rCommand( struct ls7366r *ls7366r, uint8_t ir,
+                              uint8_t *data, uint8_t len )
+{
+    uint8_t buffer[5] = { ir, 0, 0, 0, 0 };
+
+    if ( len > 4 ) return -1;
+    if ( data != NULL ) memcpy( &buffer[1], data, len );
+
+    if ( ls7366r->xfer( ls7366r->data, buffer, len + 1 ) != len + 1 )
+        return -1;
+
+    if ( data != NULL ) memcpy( data, &buffer[1], len );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises LS7366R with mode registers. Returns 0, -1 on SPI error.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rInit( struct ls7366r *ls7366r, ls7366rXfer xfer, void *data,
+                    uint8_t mdr0, uint8_t mdr1, uint16_t counts )
+{
+    memset( ls7366r, 0, sizeof( struct ls7366r ));
+    ls7366r->xfer   = xfer;
+    ls7366r->data   = data;
+    ls7366r->mdr0   = mdr0;
+    ls7366r->mdr1   = mdr1;
+    ls7366r->bytes  = ls7366rBytes( mdr1 );
+    ls7366r->counts = ( counts == 0 ) ? 1 : counts;
+    ls7366r->gpio   = LS7366R_NO_GPIO;
+
+    if ( ls7366rCommand( ls7366r, LS7366R_WR | LS7366R_MDR0,
+                         &mdr0, 1 ) < 0 ) return -1;
+    if ( ls7366rCommand( ls7366r, LS7366R_WR | LS7366R_MDR1,
+                         &mdr1, 1 ) < 0 ) return -1;
+    if ( ls7366rClear( ls7366r ) < 0 ) return -1;
+    if ( ls7366rCommand( ls7366r, LS7366R_CLR | LS7366R_STR,
+                         NULL, 0 ) < 0 ) return -1;
+
+    // Set event state in the same way as rotencPi.
+    encoderDirection = 0;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads count register (CNTR). Returns 0 or -1 on SPI error.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rReadCount( struct ls7366r *ls7366r, uint32_t *count )
+{
+    uint8_t  data[4];
+    uint8_t  i;
+
+    // Single transaction: RD_CNTR then counter bytes, MSB first.
+    if ( ls7366rCommand( ls7366r, LS7366R_RD | LS7366R_CNTR,
+                         data, ls7366r->bytes ) < 0 ) return -1;
+    ls7366r->reads++;
+
+    *count = 0;
+    for ( i = 0; i < ls7366r->bytes; i++ )
+        *count = ( *count << 8 ) | data[i];
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads and clears status register (STR). Returns 0 or -1 on SPI error.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rReadStatus( struct ls7366r *ls7366r )
+{
+    uint8_t status;
+
+    if ( ls7366rCommand( ls7366r, LS7366R_RD | LS7366R_STR,
+                         &status, 1 ) < 0 ) return -1;
+    ls7366r->status = status;
+
+    return ls7366rCommand( ls7366r, LS7366R_CLR | LS7366R_STR, NULL, 0 );
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes data register (DTR), used for compare and modulo-n.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rWriteData( struct ls7366r *ls7366r, uint32_t value )
+{
+    uint8_t data[4];
+    uint8_t i;
+
+    for ( i = 0; i < ls7366r->bytes; i++ )
+        data[i] = value >> ( 8 * ( ls7366r->bytes - 1 - i ));
+
+    return ls7366rCommand( ls7366r, LS7366R_WR | LS7366R_DTR,
+                           data, ls7366r->bytes );
+}
+
+//  ---------------------------------------------------------------------------
+//  Clears count register.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rClear( struct ls7366r *ls7366r )
+{
+    if ( ls7366rCommand( ls7366r, LS7366R_CLR | LS7366R_CNTR,
+                         NULL, 0 ) < 0 ) return -1;
+    ls7366r->count = 0;
+    ls7366r->remainder = 0;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads count and sets encoderDirection. Returns steps or 0.
+//  ---------------------------------------------------------------------------
+/*
+    The change in count is taken modulo the counter width so position
+    carries on through wraps in free running mode, as long as the counter
+    is read at least once every half range.
+*/
+int32_t ls7366rUpdate( struct ls7366r *ls7366r )
+{
+    uint8_t  shift = 32 - 8 * ls7366r->bytes;
+    uint32_t count;
+    int32_t  delta;
+    int32_t  steps;
+
+    if ( ls7366rReadCount( ls7366r, &count ) < 0 ) return 0;
+
+    // Sign extend difference to counter width.
+    delta = (int32_t)(( count - ls7366r->count ) << shift ) >> shift;
+    ls7366r->count = count;
+    if ( delta == 0 ) return 0;
+
+    ls7366r->position  += delta;
+    ls7366r->remainder += delta;
+
+    steps = ls7366r->remainder / ls7366r->counts;
+    if ( steps == 0 ) return 0;
+    ls7366r->remainder -= steps * ls7366r->counts;
+
+    pthread_mutex_lock( &encoderBusy );
+    encoderDirection = ( steps > 0 ) ? 1 : -1;
+    pthread_mutex_unlock( &encoderBusy );
+
+    return steps;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads count at poll rate until stopped.
+//  ---------------------------------------------------------------------------
+static void *ls7366rPoll( void *arg )
+{
+    struct ls7366r *ls7366r = arg;
+    struct timespec period = { 0, 1000000000L / ls7366r->rate };
+    struct timespec next;
+
+    clock_gettime( CLOCK_MONOTONIC, &next );
+
+    while ( ls7366r->running )
+    {
+        ls7366rUpdate( ls7366r );
+
+        // Absolute deadlines so read time doesn't lower the rate.
+        next.tv_nsec += period.tv_nsec;
+        if ( next.tv_nsec >= 1000000000L )
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+    }
+
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Starts thread to read count at rate (Hz). Returns 0 or -1.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rStartPoll( struct ls7366r *ls7366r, uint16_t rate )
+{
+    if (( rate == 0 ) || ( rate > LS7366R_RATE_MAX )) return -1;
+    if ( ls7366r->running ) return -1;
+
+    ls7366r->rate = rate;
+    ls7366r->running = true;
+    if ( pthread_create( &ls7366r->thread, NULL, ls7366rPoll, ls7366r ) != 0 )
+    {
+        ls7366r->running = false;
+        return -1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Interrupt function for DFLAG/.
+//  ---------------------------------------------------------------------------
+static void ls7366rFlag( void )
+{
+    if ( ls7366rInterrupt == NULL ) return;
+
+    ls7366rReadStatus( ls7366rInterrupt );
+    ls7366rUpdate( ls7366rInterrupt );
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads count when DFLAG/ falls on Pi gpio. Returns 0 or -1.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rStartInterrupt( struct ls7366r *ls7366r, uint8_t gpio )
+{
+    if ( ls7366rInterrupt != NULL ) return -1;
+
+    ls7366r->gpio = gpio;
+    ls7366rInterrupt = ls7366r;
+
+    wiringPiSetupGpio();
+    pinMode( gpio, INPUT );
+    pullUpDnControl( gpio, PUD_UP );    // DFLAG/ is open drain.
+
+    if ( wiringPiISR( gpio, INT_EDGE_FALLING, &ls7366rFlag ) < 0 )
+    {
+        ls7366rInterrupt = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Stops poll thread.
+//  ---------------------------------------------------------------------------
+void ls7366rStop( struct ls7366r *ls7366r )
+{
+    if ( ls7366r->running )
+    {
+        ls7366r->running = false;
+        pthread_join( ls7366r->thread, NULL );
+    }
+
+    // wiringPi can't remove an interrupt function, so just ignore it.
+    if ( ls7366rInterrupt == ls7366r ) ls7366rInterrupt = NULL;
+}
+
+//  Register-level mock. ------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises mock to power on state.
+//  ---------------------------------------------------------------------------
+void ls7366rMockInit( struct ls7366rMock *mock )
+{
+    memset( mock, 0, sizeof( struct ls7366rMock ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns mask for counter width of mock.
+//  ---------------------------------------------------------------------------
+static uint32_t ls7366rMockMask( struct ls7366rMock *mock )
+{
+    uint8_t bytes = ls7366rBytes( mock->mdr1 );
+
+    return ( bytes == 4 ) ? 0xffffffff : ( 1UL << ( 8 * bytes )) - 1;
+}
+
+//  ---------------------------------------------------------------------------
+//  SPI transfer to mock registers. data points to struct ls7366rMock.
+//  ---------------------------------------------------------------------------
+int ls7366rMockXfer( void *data, uint8_t *buffer, uint8_t len )
+{
+    struct ls7366rMock *mock = data;
+    uint8_t  op    = buffer[0] & 0xc0;
+    uint8_t  reg   = buffer[0] & 0x38;
+    uint8_t  bytes = ls7366rBytes( mock->mdr1 );
+    uint32_t value = 0;
+    uint32_t *wide = NULL;
+    uint8_t  *byte = NULL;
+    uint8_t  i;
+
+    if ( len < 1 ) return -1;
+    mock->transactions++;
+
+    switch ( reg )
+    {
+        case LS7366R_MDR0: byte = &mock->mdr0; break;
+        case LS7366R_MDR1: byte = &mock->mdr1; break;
+        case LS7366R_STR:  byte = &mock->str;  break;
+        case LS7366R_DTR:  wide = &mock->dtr;  break;
+        case LS7366R_CNTR: wide = &mock->cntr; break;
+        case LS7366R_OTR:  wide = &mock->otr;  break;
+        default: return -1;
+    }
+
+    switch ( op )
+    {
+        case LS7366R_CLR:
+            if ( byte != NULL ) *byte = 0;
+            else if ( reg == LS7366R_DTR ) return -1;
+            else *wide = 0;
+            break;
+
+        case LS7366R_RD:
+            if ( reg == LS7366R_DTR ) return -1;
+            if ( byte != NULL )
+            {
+                if ( len > 1 ) buffer[1] = *byte;
+                break;
+            }
+            // Reading CNTR transfers it to OTR first.
+            if ( reg == LS7366R_CNTR ) mock->otr = mock->cntr;
+            for ( i = 0; ( i < bytes ) && ( i + 1 < len ); i++ )
+                buffer[i + 1] = mock->otr >> ( 8 * ( bytes - 1 - i ));
+            break;
+
+        case LS7366R_WR:
+            if ( byte != NULL )
+            {
+                if (( reg == LS7366R_STR ) || ( len < 2 )) return -1;
+                *byte = buffer[1];
+                break;
+            }
+            if (( reg != LS7366R_DTR ) || ( len < bytes + 1 )) return -1;
+            for ( i = 0; i < bytes; i++ )
+                value = ( value << 8 ) | buffer[i + 1];
+            mock->dtr = value;
+            break;
+
+        default: // LOAD.
+            if ( reg == LS7366R_CNTR ) mock->cntr = mock->dtr;
+            else if ( reg == LS7366R_OTR ) mock->otr = mock->cntr;
+            else return -1;
+            break;
+    }
+
+    // Reads clock out whatever was in the shift register for other bytes.
+    if ( op != LS7366R_RD )
+        for ( i = 1; i < len; i++ ) buffer[i] = 0;
+
+    return len;
+}
+
+//  ---------------------------------------------------------------------------
+//  Moves mock counter by counts and optionally pulses index.
+//  ---------------------------------------------------------------------------
+void ls7366rMockMove( struct ls7366rMock *mock, int32_t counts, bool index )
+{
+    uint32_t mask = ls7366rMockMask( mock );
+    uint8_t  mode = mock->mdr0 & 0x0c;
+    int8_t   step = ( counts < 0 ) ? -1 : 1;
+
+    if ( !( mock->mdr1 & MDR1_DISABLE ))
+    {
+        mock->str |= STR_CEN;
+        for ( ; counts != 0; counts -= step )
+        {
+            if ( step > 0 )
+            {
+                mock->str |= STR_UP;
+                if ( mode == MDR0_MODULO_N && mock->cntr == mock->dtr )
+                {
+                    mock->cntr = 0;
+                    mock->str |= STR_CY;
+                }
+                else if ( mode == MDR0_RANGE_LIMIT && mock->cntr == mock->dtr )
+                    mock->str |= STR_CY;
+                else if ( mock->cntr == mask )
+                {
+                    mock->str |= STR_CY;
+                    if ( mode == MDR0_SINGLE_CYCLE ) mock->str &= ~STR_CEN;
+                    mock->cntr = 0;
+                }
+                else mock->cntr++;
+            }
+            else
+            {
+                mock->str &= ~STR_UP;
+                if ( mock->cntr == 0 )
+                {
+                    mock->str |= STR_BW;
+                    if ( mode == MDR0_MODULO_N ) mock->cntr = mock->dtr;
+                    else if ( mode != MDR0_RANGE_LIMIT )
+                    {
+                        if ( mode == MDR0_SINGLE_CYCLE )
+                            mock->str &= ~STR_CEN;
+                        mock->cntr = mask;
+                    }
+                }
+                else mock->cntr--;
+            }
+
+            if ( mock->cntr == mock->dtr ) mock->str |= STR_CMP;
+            if ( !( mock->str & STR_CEN )) break;
+        }
+        // Sign follows MSB of counter.
+        mock->str &= ~STR_SIGN;
+        if ( mock->cntr & (( mask >> 1 ) + 1 )) mock->str |= STR_SIGN;
+    }
+
+    if ( !index ) return;
+
+    mock->str |= STR_IDX;
+    switch ( mock->mdr0 & 0x30 )
+    {
+        case MDR0_INDEX_LOAD:  mock->cntr = mock->dtr;  break;
+        case MDR0_INDEX_RESET: mock->cntr = 0;          break;
+        case MDR0_INDEX_OTR:   mock->otr  = mock->cntr; break;
+        default: break;
+    }
+}
@@ -0,0 +1,259 @@
+/*
+//  ===========================================================================
+
+    ls7366r:
+
+    LS7366R quadrature counter encoder backend for rotencPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        LS7366R data sheet.
+        - see http://www.lsicsi.com/pdfs/Data_Sheets/LS7366R.pdf
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Authors:        agent       18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v0.1    Original version.
+
+//  Description of LS7366R. ---------------------------------------------------
+
+    The LS7366R is a 32-bit quadrature counter with an SPI interface. It
+    decodes and counts encoder pulses in hardware at up to 40MHz, so high
+    resolution encoders can be used without the interrupt per edge needed
+    by the GPIO decoders in rotencPi.
+
+                        +-----------( )-----------+
+                        |  Fn  | pin | pin |  Fn  |
+                        |------+-----+-----+------|
+            Crystal <---| fCKO |  01 | 14  | VDD  |---> +3.3V.
+            Crystal <---| fCKi |  02 | 13  | A    |<--- Encoder A.
+                GND <---| VSS  |  03 | 12  | B    |<--- Encoder B.
+            SPI CE0 --->| SS/  |  04 | 11  | INDX/|<--- Encoder index.
+           SPI SCLK --->| SCK  |  05 | 10  | CNTEN|---> +3.3V.
+           SPI MISO <---| MISO |  06 | 09  | LFLG/|-x
+           SPI MOSI --->| MOSI |  07 | 08  | DFLG/|---> Pi GPIO (optional).
+                        +-------------------------+
+
+    Each SPI transaction starts with an instruction byte (IR) followed by
+    up to 4 data bytes, MSB first:
+
+            +-------------------------------------------------------+
+            | BIT7 | BIT6 | BIT5 | BIT4 | BIT3 | BIT2 | BIT1 | BIT0 |
+            |------+------+------+------+------+------+------+------|
+            |    Operation |      Register      |  Don't care       |
+            +-------------------------------------------------------+
+
+                Operation: 00 = CLR, 01 = RD, 10 = WR, 11 = LOAD.
+                Register:  001 = MDR0, 010 = MDR1, 011 = DTR,
+                           100 = CNTR, 101 = OTR,  110 = STR.
+
+    MDR0 sets quadrature mode (x1, x2, x4), count mode (free running,
+    single cycle, range limit, modulo-n) and what the index input does.
+    MDR1 sets the counter width (1 to 4 bytes), count enable, and which
+    events (index, compare with DTR, borrow, carry) drive DFLAG.
+
+    The count is read with a single transaction (RD_CNTR followed by the
+    counter bytes clocked out). It can be read at a fixed poll rate from a
+    thread, or when DFLAG falls on an index or compare event.
+
+    Changes in count set encoderDirection in the same way as the GPIO
+    decoders, once for every counts pulses so that a high resolution
+    encoder can drive the same code as a detented one.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#ifndef LS7366R_H
+#define LS7366R_H
+
+//  Macros. -------------------------------------------------------------------
+
+// Instructions.
+#define LS7366R_CLR       0x00
+#define LS7366R_RD        0x40
+#define LS7366R_WR        0x80
+#define LS7366R_LOAD      0xc0
+
+// Registers.
+#define LS7366R_MDR0      0x08
+#define LS7366R_MDR1      0x10
+#define LS7366R_DTR       0x18
+#define LS7366R_CNTR      0x20
+#define LS7366R_OTR       0x28
+#define LS7366R_STR       0x30
+
+// MDR0 bits.
+#define MDR0_NON_QUAD     0x00
+#define MDR0_QUAD_X1      0x01
+#define MDR0_QUAD_X2      0x02
+#define MDR0_QUAD_X4      0x03
+#define MDR0_FREE_RUN     0x00
+#define MDR0_SINGLE_CYCLE 0x04
+#define MDR0_RANGE_LIMIT  0x08
+#define MDR0_MODULO_N     0x0c
+#define MDR0_INDEX_OFF    0x00
+#define MDR0_INDEX_LOAD   0x10  // Load CNTR from DTR.
+#define MDR0_INDEX_RESET  0x20  // Clear CNTR.
+#define MDR0_INDEX_OTR    0x30  // Load OTR from CNTR.
+#define MDR0_INDEX_SYNC   0x40
+#define MDR0_FILTER_2     0x80  // Filter clock / 2.
+
+// MDR1 bits.
+#define MDR1_BYTES_4      0x00
+#define MDR1_BYTES_3      0x01
+#define MDR1_BYTES_2      0x02
+#define MDR1_BYTES_1      0x03
+#define MDR1_DISABLE      0x04
+#define MDR1_FLAG_IDX     0x10
+#define MDR1_FLAG_CMP     0x20
+#define MDR1_FLAG_BW      0x40
+#define MDR1_FLAG_CY      0x80
+
+// STR bits.
+#define STR_SIGN          0x01
+#define STR_UP            0x02
+#define STR_PLS           0x04
+#define STR_CEN           0x08
+#define STR_IDX           0x10
+#define STR_CMP           0x20
+#define STR_BW            0x40
+#define STR_CY            0x80
+
+#define LS7366R_RATE_MAX  10000 // Max poll rate (Hz).
+#define LS7366R_NO_GPIO   0xff
+
+//  Data structures. ----------------------------------------------------------
+
+/*
+    SPI transfer function. Sends len bytes from buffer with SS/ held low
+    and replaces them with the bytes received. Returns len or -1.
+*/
+typedef int (*ls7366rXfer)( void *data, uint8_t *buffer, uint8_t len );
+
+struct ls7366r
+{
+    ls7366rXfer  xfer;      // SPI transfer function.
+    void        *data;      // Passed to xfer, eg. SPI channel.
+    uint8_t      mdr0;      // Mode register 0.
+    uint8_t      mdr1;      // Mode register 1.
+    uint8_t      bytes;     // Counter width.
+    uint32_t     count;     // Last count read.
+    int32_t      position;  // Count extended across counter wraps.
+    uint16_t     counts;    // Counts per encoderDirection event.
+    int32_t      remainder; // Counts not yet reported.
+    uint8_t      status;    // Last STR read.
+    uint16_t     rate;      // Poll rate (Hz).
+    uint8_t      gpio;      // Pi GPIO for DFLAG/.
+    pthread_t    thread;    // Poll thread.
+    bool         running;   // Poll thread running.
+    uint32_t     reads;     // Count reads.
+};
+
+// Register-level mock of LS7366R for testing without hardware.
+struct ls7366rMock
+{
+    uint8_t  mdr0;
+    uint8_t  mdr1;
+    uint32_t dtr;
+    uint32_t cntr;
+    uint32_t otr;
+    uint8_t  str;
+    uint32_t transactions;  // SPI transactions.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  SPI transfer using wiringPi. data points to SPI channel (int).
+//  ---------------------------------------------------------------------------
+int ls7366rSpiXfer( void *data, uint8_t *buffer, uint8_t len );
+
+//  ---------------------------------------------------------------------------
+//  Initialises LS7366R with mode registers. Returns 0, -1 on SPI error.
+//  ---------------------------------------------------------------------------
+/*
+    counts is the number of counts for each encoderDirection event, eg. 4
+    for a detented encoder in x4 mode.
+*/
+int8_t ls7366rInit( struct ls7366r *ls7366r, ls7366rXfer xfer, void *data,
+                    uint8_t mdr0, uint8_t mdr1, uint16_t counts );
+
+//  ---------------------------------------------------------------------------
+//  Reads count register (CNTR). Returns 0 or -1 on SPI error.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rReadCount( struct ls7366r *ls7366r, uint32_t *count );
+
+//  ---------------------------------------------------------------------------
+//  Reads and clears status register (STR). Returns 0 or -1 on SPI error.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rReadStatus( struct ls7366r *ls7366r );
+
+//  ---------------------------------------------------------------------------
+//  Writes data register (DTR), used for compare and modulo-n.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rWriteData( struct ls7366r *ls7366r, uint32_t data );
+
+//  ---------------------------------------------------------------------------
+//  Clears count register.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rClear( struct ls7366r *ls7366r );
+
+//  ---------------------------------------------------------------------------
+//  Reads count and sets encoderDirection. Returns steps or 0.
+//  ---------------------------------------------------------------------------
+int32_t ls7366rUpdate( struct ls7366r *ls7366r );
+
+//  ---------------------------------------------------------------------------
+//  Starts thread to read count at rate (Hz). Returns 0 or -1.
+//  ---------------------------------------------------------------------------
+int8_t ls7366rStartPoll( struct ls7366r *ls7366r, uint16_t rate );
+
+//  ---------------------------------------------------------------------------
+//  Reads count when DFLAG/ falls on Pi gpio. Returns 0 or -1.
+//  ---------------------------------------------------------------------------
+/*
+    Only one LS7366R can use interrupts since wiringPi interrupt functions
+    don't take parameters. Set MDR1_FLAG_IDX and/or MDR1_FLAG_CMP in mdr1.
+*/
+int8_t ls7366rStartInterrupt( struct ls7366r *ls7366r, uint8_t gpio );
+
+//  ---------------------------------------------------------------------------
+//  Stops poll thread.
+//  ---------------------------------------------------------------------------
+void ls7366rStop( struct ls7366r *ls7366r );
+
+//  ---------------------------------------------------------------------------
+//  Initialises mock to power on state.
+//  ---------------------------------------------------------------------------
+void ls7366rMockInit( struct ls7366rMock *mock );
+
+//  ---------------------------------------------------------------------------
+//  SPI transfer to mock registers. data points to struct ls7366rMock.
+//  ---------------------------------------------------------------------------
+int ls7366rMockXfer( void *data, uint8_t *buffer, uint8_t len );
+
+//  ---------------------------------------------------------------------------
+//  Moves mock counter by counts and optionally pulses index.
+//  ---------------------------------------------------------------------------
+void ls7366rMockMove( struct ls7366rMock *mock, int32_t counts, bool index );
+
+#endif
@@ -0,0 +1,237 @@
+/*
+//  ===========================================================================
+
+    testls7366r:
+
+    Tests LS7366R quadrature counter backend for rotencPi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc testls7366r.c ls7366r.c rotencPi.c -Wall -o testls7366r
+                                               -lwiringPi -lpthread
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        testls7366r         Runs tests against register-level mock.
+        testls7366r -s      Prints encoder directions from LS7366R on SPI
+                            channel 0, polled at 1kHz.
+
+    Returns 0 if all mock tests pass.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <wiringPi.h>
+#include <wiringPiSPI.h>
+
+#include "rotencPi.h"
+#include "ls7366r.h"
+
+static pthread_mutex_t mockBusy = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t failed = 0;
+
+//  ---------------------------------------------------------------------------
+//  Prints result of a test.
+//  ---------------------------------------------------------------------------
+static void testCheck( const char *name, bool pass )
+{
+    printf( "%-44s %s\n", name, pass ? "pass" : "FAIL" );
+    if ( !pass ) failed++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Mock transfer that is safe to call from the poll thread.
+//  ---------------------------------------------------------------------------
+static int testXfer( void *data, uint8_t *buffer, uint8_t len )
+{
+    int ret;
+
+    pthread_mutex_lock( &mockBusy );
+    ret = ls7366rMockXfer( data, buffer, len );
+    pthread_mutex_unlock( &mockBusy );
+
+    return ret;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs tests against mock.
+//  ---------------------------------------------------------------------------
+static void testMock( void )
+{
+    struct ls7366r     ls7366r;
+    struct ls7366rMock mock;
+    uint32_t transactions;
+    uint32_t count;
+    int32_t  steps;
+    int32_t  moved;
+
+    // Initialisation writes mode registers.
+    ls7366rMockInit( &mock );
+    mock.cntr = 1234;
+    ls7366rInit( &ls7366r, testXfer, &mock,
+                 MDR0_QUAD_X4 | MDR0_FREE_RUN, MDR1_BYTES_4, 4 );
+    testCheck( "Init writes MDR0, MDR1 and clears CNTR",
+               ( mock.mdr0 == MDR0_QUAD_X4 ) && ( mock.mdr1 == 0 ) &&
+               ( mock.cntr == 0 ));
+
+    // Count is read in a single transaction.
+    mock.cntr = 0x12345678;
+    transactions = mock.transactions;
+    ls7366rReadCount( &ls7366r, &count );
+    testCheck( "Count read in one SPI transaction",
+               ( mock.transactions - transactions == 1 ) &&
+               ( count == 0x12345678 ));
+    ls7366rClear( &ls7366r );
+
+    // Steps of 4 counts set encoderDirection.
+    encoderDirection = 0;
+    ls7366rMockMove( &mock, 10, false );
+    steps = ls7366rUpdate( &ls7366r );
+    testCheck( "10 counts forward = 2 steps, +ve direction",
+               ( steps == 2 ) && ( encoderDirection == 1 ) &&
+               ( ls7366r.remainder == 2 ));
+
+    ls7366rMockMove( &mock, -7, false );
+    steps = ls7366rUpdate( &ls7366r );
+    testCheck( "7 counts back = 1 step, -ve direction",
+               ( steps == -1 ) && ( encoderDirection == -1 ) &&
+               ( ls7366r.position == 3 ));
+
+    // 2 byte counter wraps below zero.
+    ls7366rMockInit( &mock );
+    ls7366rInit( &ls7366r, testXfer, &mock,
+                 MDR0_QUAD_X1, MDR1_BYTES_2, 1 );
+    ls7366rMockMove( &mock, -3, false );
+    steps = ls7366rUpdate( &ls7366r );
+    testCheck( "2 byte counter wraps to 0xfffd, position -3",
+               ( ls7366r.count == 0xfffd ) && ( ls7366r.position == -3 ) &&
+               ( steps == -3 ) && ( mock.str & STR_BW ));
+
+    // Modulo-n.
+    ls7366rMockInit( &mock );
+    ls7366rInit( &ls7366r, testXfer, &mock,
+                 MDR0_QUAD_X4 | MDR0_MODULO_N, MDR1_BYTES_4, 1 );
+    ls7366rWriteData( &ls7366r, 99 );
+    ls7366rMockMove( &mock, 250, false );
+    ls7366rReadCount( &ls7366r, &count );
+    testCheck( "Modulo-100 counter at 50 after 250 counts",
+               ( count == 50 ) && ( mock.str & STR_CY ));
+
+    // Index clears counter and sets flag, status read clears flag.
+    ls7366rMockInit( &mock );
+    ls7366rInit( &ls7366r, testXfer, &mock,
+                 MDR0_QUAD_X4 | MDR0_INDEX_RESET, MDR1_FLAG_IDX, 1 );
+    ls7366rMockMove( &mock, 5, true );
+    ls7366rReadStatus( &ls7366r );
+    ls7366rReadCount( &ls7366r, &count );
+    testCheck( "Index resets CNTR, STR read and cleared",
+               ( count == 0 ) && ( ls7366r.status & STR_IDX ) &&
+               !( mock.str & STR_IDX ));
+
+    // Count enable.
+    ls7366rMockInit( &mock );
+    ls7366rInit( &ls7366r, testXfer, &mock,
+                 MDR0_QUAD_X4, MDR1_DISABLE, 1 );
+    ls7366rMockMove( &mock, 5, false );
+    testCheck( "Disabled counter doesn't count", mock.cntr == 0 );
+
+    // Poll thread.
+    ls7366rMockInit( &mock );
+    ls7366rInit( &ls7366r, testXfer, &mock,
+                 MDR0_QUAD_X4, MDR1_BYTES_4, 4 );
+    ls7366rStartPoll( &ls7366r, 1000 );
+    for ( moved = 0; moved < 4000; moved += 40 )
+    {
+        pthread_mutex_lock( &mockBusy );
+        ls7366rMockMove( &mock, 40, false );
+        pthread_mutex_unlock( &mockBusy );
+        usleep( 1000 );
+    }
+    usleep( 5000 );
+    ls7366rStop( &ls7366r );
+    printf( "\tPoll thread: %u reads, position %d.\n",
+            ls7366r.reads, ls7366r.position );
+    testCheck( "Poll thread tracks 4000 counts at 1kHz",
+               ( ls7366r.position == 4000 ) && ( ls7366r.reads > 50 ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Prints encoder directions from LS7366R hardware.
+//  ---------------------------------------------------------------------------
+static int testHardware( void )
+{
+    struct ls7366r ls7366r;
+    int channel = 0;
+
+    if ( wiringPiSPISetup( channel, 1000000 ) < 0 )
+    {
+        printf( "Couldn't open SPI channel %d.\n", channel );
+        return -1;
+    }
+
+    if ( ls7366rInit( &ls7366r, ls7366rSpiXfer, &channel,
+                      MDR0_QUAD_X4, MDR1_BYTES_4, 4 ) < 0 )
+    {
+        printf( "Couldn't init LS7366R.\n" );
+        return -1;
+    }
+    ls7366rStartPoll( &ls7366r, 1000 );
+
+    // Same loop as testrotencPi.
+    while ( 1 )
+    {
+        if ( encoderDirection != 0 )
+        {
+            printf( "%s %d\n", ( encoderDirection > 0 ) ? "++++" : "----",
+                    ls7366r.position );
+            encoderDirection = 0;
+        }
+        delay( 10 );
+    }
+
+    return 0;
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    if (( argc > 1 ) && ( strcmp( argv[1], "-s" ) == 0 ))
+        return testHardware();
+
+    testMock();
+
+    return failed ? 1 : 0;
+}
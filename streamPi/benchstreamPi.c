@@ -0,0 +1,816 @@
+/*
+//  ===========================================================================
+
+    benchstreamPi:
+
+    Benchmarks streamPi stages.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc benchstreamPi.c streamPi.c eqPi.c convPi.c contourPi.c limitPi.c
+            ditherPi.c resamplePi.c loudPi.c -Wall -O3 -o benchstreamPi
+            -lm -lrt
+
+    Add -DSTREAM_FIXED to benchmark Q28 fixed point.
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        benchstreamPi [-e eq config] [-c FIR filter] [-l latency]
+
+    Checks a 1kHz +6dB peak filter against a 1kHz sine, then times
+    cascades of biquads on 96kHz stereo with a period of 1024 frames and
+    prints the CPU load. Run on a Pi Zero to find how many biquads per
+    channel fit in 10% of a core. With -e, also times the filters in an
+    eqPi config file.
+
+    Checks convolution against direct convolution, then prints the CPU load
+    and latency of FIR filters from 8k to 64k taps for several partition
+    sizes. With -c, also times a WAV or raw filter file, using the
+    partition size for a latency budget given by -l (ms, default 20).
+
+    Prints the measured loudness compensation against volume index for a
+    linear 60dB mixer, the crossfeed level at low and high frequencies and
+    the CPU load of the contour stage while the volume is changing.
+
+    Drives the limiter with bursts up to +12dBFS and checks that no output
+    sample passes the ceiling, repeats the check with a falling level at the
+    longest look-ahead, checks compressor gain on a steady sine and prints
+    the gain reduction published for meterPi and the CPU load.
+
+    Requantises a -60dBFS sine to 16 bits at 44.1kHz with each noise
+    shaping filter and prints the total noise and the noise below 4kHz,
+    then prints the CPU cost per channel at 96kHz.
+
+    Resamples a 1kHz sine with ratios up to 1000ppm from 1 and prints the
+    error against an exact sine and the CPU load per channel at 96kHz.
+
+    Checks loudness and loudness range against the EBU Tech 3341 and 3342
+    sine cases and prints the CPU load of loudness measurement at 96kHz.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <math.h>
+
+#include "streamPi.h"
+#include "eqPi.h"
+#include "convPi.h"
+#include "contourPi.h"
+#include "limitPi.h"
+#include "ditherPi.h"
+#include "resamplePi.h"
+#include "loudPi.h"
+
+#define BENCH_RATE      96000
+#define BENCH_CHANNELS  2
+#define BENCH_PERIOD    1024
+#define BENCH_SECONDS   10
+#define BENCH_LOAD      10.0 // Target CPU load (%).
+#define BENCH_CONV_SECONDS 2
+
+static struct eq_t eq;
+static struct eq_config_t config;
+static struct conv_t conv;
+static struct conv_filter_t filter[BENCH_CHANNELS];
+static struct contour_t contour;
+static struct limit_t limit;
+static struct dither_t dither;
+static struct resample_t resample;
+static struct loud_t loud;
+static sample_t samples[BENCH_PERIOD * BENCH_CHANNELS];
+
+//  ---------------------------------------------------------------------------
+//  Returns process CPU time in seconds.
+//  ---------------------------------------------------------------------------
+static double benchTime( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills samples with a sine.
+//  ---------------------------------------------------------------------------
+static void benchSine( struct stream_format_t *format, float freq,
+                       uint32_t *phase )
+{
+    uint16_t f;
+    uint8_t  ch;
+    float    s;
+
+    for ( f = 0; f < format->period; f++, ( *phase )++ )
+    {
+        s = 0.25f * sinf( 2 * M_PI * freq * *phase / format->rate );
+        for ( ch = 0; ch < format->channels; ch++ )
+            samples[f * format->channels + ch] = STREAM_FROM_FLOAT( s );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns peak of first channel of samples.
+//  ---------------------------------------------------------------------------
+static float benchPeak( struct stream_format_t *format )
+{
+    uint16_t f;
+    float    peak = 0;
+    float    s;
+
+    for ( f = 0; f < format->period; f++ )
+    {
+        s = fabsf( STREAM_TO_FLOAT( samples[f * format->channels] ));
+        if ( s > peak ) peak = s;
+    }
+
+    return peak;
+}
+
+//  ---------------------------------------------------------------------------
+//  Checks gain of peak filter at its centre frequency.
+//  ---------------------------------------------------------------------------
+static int benchCheck( struct stream_format_t *format )
+{
+    uint8_t  channels = 0xff;
+    uint32_t phase = 0;
+    uint16_t i;
+    float    gain;
+
+    memset( &config, 0, sizeof( config ));
+    eq_parse( &config, "Filter 1: ON PK Fc 1000 Hz Gain 6.0 dB Q 1.0",
+              &channels );
+    if ( eq_init( &eq, format, &config ) < 0 ) return -1;
+
+    for ( i = 0; i < 100; i++ )
+    {
+        benchSine( format, 1000, &phase );
+        eq_process( &eq, samples, format->period );
+    }
+    gain = benchPeak( format ) / 0.25f;
+
+    printf( "1kHz +6dB peak at 1kHz: gain %.3f (expect %.3f).\n",
+            gain, pow( 10, 6.0 / 20 ));
+
+    return ( fabs( gain - pow( 10, 6.0 / 20 )) < 0.01 ) ? 0 : -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Times filters over BENCH_SECONDS of audio, returns CPU load (%).
+//  ---------------------------------------------------------------------------
+static double benchRun( struct stream_format_t *format, bool ramp )
+{
+    uint32_t periods = BENCH_SECONDS * format->rate / format->period;
+    uint32_t phase = 0;
+    uint32_t i;
+    double   start;
+    double   time = 0;
+
+    if ( eq_init( &eq, format, &config ) < 0 ) return -1;
+
+    for ( i = 0; i < periods; i++ )
+    {
+        benchSine( format, 997, &phase );
+        if ( ramp ) eq_set( &eq, &config );
+        start = benchTime();
+        eq_process( &eq, samples, format->period );
+        time += benchTime() - start;
+    }
+
+    return 100.0 * time / BENCH_SECONDS;
+}
+
+//  ---------------------------------------------------------------------------
+//  Checks convolution against direct convolution.
+//  ---------------------------------------------------------------------------
+static int benchConvCheck( struct stream_format_t *format )
+{
+    static float input[8192];
+    uint32_t length = 1000;
+    uint32_t n, i, f;
+    uint8_t  ch;
+    float    expect, error = 0;
+
+    srand( 1 );
+    for ( ch = 0; ch < format->channels; ch++ )
+    {
+        filter[ch].taps   = malloc( length * sizeof( float ));
+        filter[ch].length = length;
+        filter[ch].rate   = 0;
+        for ( i = 0; i < length; i++ )
+            filter[ch].taps[i] = ( rand() / ( float )RAND_MAX - 0.5f ) /
+                                 ( 10 * ( ch + 1 ));
+    }
+    for ( n = 0; n < 8192; n++ )
+        input[n] = rand() / ( float )RAND_MAX - 0.5f;
+
+    if ( conv_init( &conv, format, 64, filter ) < 0 ) return -1;
+
+    // Odd sized chunks to cross block boundaries.
+    for ( n = 0; n < 8192; n += 100 )
+    {
+        uint16_t frames = ( 8192 - n < 100 ) ? 8192 - n : 100;
+
+        for ( f = 0; f < frames; f++ )
+            for ( ch = 0; ch < format->channels; ch++ )
+                samples[f * format->channels + ch] =
+                    STREAM_FROM_FLOAT( input[n + f] );
+        conv_process( &conv, samples, frames );
+
+        for ( f = 0; f < frames; f++ )
+        {
+            int32_t t = n + f - conv_latency( &conv );
+
+            for ( ch = 0; ch < format->channels; ch++ )
+            {
+                for ( expect = 0, i = 0; i < length; i++ )
+                    if (( t - ( int32_t )i >= 0 ) && ( t - i < 8192 ))
+                        expect += filter[ch].taps[i] * input[t - i];
+                expect = fabsf( expect -
+                    STREAM_TO_FLOAT( samples[f * format->channels + ch] ));
+                if ( expect > error ) error = expect;
+            }
+        }
+    }
+    conv_free( &conv );
+    for ( ch = 0; ch < format->channels; ch++ )
+        conv_filter_free( &filter[ch] );
+
+    printf( "1000 tap convolution: max error %.2e.\n", error );
+
+    return ( error < 1e-4 ) ? 0 : -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Times convolution over BENCH_CONV_SECONDS of audio.
+//  ---------------------------------------------------------------------------
+static void benchConvRun( struct stream_format_t *format, uint16_t size )
+{
+    uint32_t periods = BENCH_CONV_SECONDS * format->rate / format->period;
+    uint32_t phase = 0;
+    uint32_t i;
+    double   start;
+    double   time = 0;
+
+    if ( conv_init( &conv, format, size, filter ) < 0 )
+    {
+        printf( "Couldn't init convolution.\n" );
+        return;
+    }
+
+    for ( i = 0; i < periods; i++ )
+    {
+        benchSine( format, 997, &phase );
+        start = benchTime();
+        conv_process( &conv, samples, format->period );
+        time += benchTime() - start;
+    }
+
+    printf( "%7u   %9u   %4u   %11.2f   %8.2f\n",
+            filter[0].length, size, conv.parts,
+            1000.0 * conv_latency( &conv ) / format->rate,
+            100.0 * time / BENCH_CONV_SECONDS );
+    conv_free( &conv );
+}
+
+//  ---------------------------------------------------------------------------
+//  Times synthetic FIR filters.
+//  ---------------------------------------------------------------------------
+static void benchConv( struct stream_format_t *format )
+{
+    uint32_t lengths[] = { 8192, 16384, 32768, 65536 };
+    uint16_t sizes[] = { 128, 512, 1024 };
+    uint32_t i, t;
+    uint8_t  j, ch;
+
+    printf( "\n   Taps   Partition   Parts   Latency (ms)   Load (%%)\n" );
+
+    for ( i = 0; i < sizeof( lengths ) / sizeof( lengths[0] ); i++ )
+    {
+        // Decaying noise, like a room correction filter.
+        for ( ch = 0; ch < format->channels; ch++ )
+        {
+            filter[ch].taps   = malloc( lengths[i] * sizeof( float ));
+            filter[ch].length = lengths[i];
+            filter[ch].rate   = 0;
+            for ( t = 0; t < lengths[i]; t++ )
+                filter[ch].taps[t] = ( rand() / ( float )RAND_MAX - 0.5f ) *
+                                     expf( -8.0f * t / lengths[i] );
+        }
+
+        for ( j = 0; j < sizeof( sizes ) / sizeof( sizes[0] ); j++ )
+            benchConvRun( format, sizes[j] );
+
+        for ( ch = 0; ch < format->channels; ch++ )
+            conv_filter_free( &filter[ch] );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns level (dB) of each channel of a sine after contour stage.
+//  ---------------------------------------------------------------------------
+static void benchContourLevel( struct stream_format_t *format, float freq,
+                               bool left, float *level )
+{
+    uint32_t phase = 0;
+    uint16_t i, f;
+    uint8_t  ch;
+    float    peak, s;
+
+    for ( i = 0; i < 50; i++ )
+    {
+        benchSine( format, freq, &phase );
+        if ( left )
+            for ( f = 0; f < format->period; f++ )
+                samples[f * format->channels + 1] = 0;
+        contour_process( &contour, samples, format->period );
+    }
+
+    for ( ch = 0; ch < format->channels; ch++ )
+    {
+        for ( peak = 0, f = 0; f < format->period; f++ )
+        {
+            s = fabsf( STREAM_TO_FLOAT( samples[f * format->channels + ch] ));
+            if ( s > peak ) peak = s;
+        }
+        level[ch] = 20 * log10f( peak / 0.25f + 1e-9f );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Prints loudness compensation and crossfeed, and times contour stage.
+//  ---------------------------------------------------------------------------
+static void benchContour( struct stream_format_t *format )
+{
+    struct contour_profile_t profile;
+    float    atten[21];
+    float    low[2], mid[2], high[2];
+    uint32_t periods = BENCH_SECONDS * format->rate / format->period;
+    uint32_t phase = 0;
+    uint32_t i;
+    double   start;
+    double   time = 0;
+
+    contour_profile( &profile );
+    contour_atten( atten, 20, 1, 60 );
+
+    printf( "\nIndex   Atten (dB)   50Hz (dB)   1kHz (dB)   15kHz (dB)\n" );
+    for ( i = 0; i <= 20; i += 4 )
+    {
+        contour_init( &contour, format, &profile, atten, 20 );
+        contour_set_index( &contour, i );
+        benchContourLevel( format, 50, false, low );
+        benchContourLevel( format, 1000, false, mid );
+        benchContourLevel( format, 15000, false, high );
+        printf( "%5u   %10.1f   %9.2f   %9.2f   %10.2f\n",
+                i, atten[i], low[0], mid[0], high[0] );
+        contour_free( &contour );
+    }
+
+    contour_init( &contour, format, &profile, atten, 20 );
+    contour_crossfeed( &contour, 700, 4.5 );
+    benchContourLevel( format, 200, true, low );
+    benchContourLevel( format, 5000, true, high );
+    printf( "Crossfeed 700Hz 4.5dB, left only: R - L at 200Hz %.2fdB, "
+            "at 5kHz %.2fdB.\n", low[1] - low[0], high[1] - high[0] );
+
+    for ( i = 0; i < periods; i++ )
+    {
+        benchSine( format, 997, &phase );
+        contour_set_index( &contour, i % 21 );
+        start = benchTime();
+        contour_process( &contour, samples, format->period );
+        time += benchTime() - start;
+    }
+    printf( "Contour with crossfeed, volume changing: %.2f%% load.\n",
+            100.0 * time / BENCH_SECONDS );
+    contour_free( &contour );
+}
+
+//  ---------------------------------------------------------------------------
+//  Checks limiter ceiling and compressor gain, and times limiter.
+//  ---------------------------------------------------------------------------
+static int benchLimit( struct stream_format_t *format )
+{
+    struct limit_config_t config;
+    uint32_t periods = BENCH_SECONDS * format->rate / format->period;
+    uint32_t phase = 0;
+    uint32_t i, n;
+    float    peak = 0;
+    float    level, s;
+    double   start;
+    double   time = 0;
+
+    // Bursts of 1 to 4 times full scale.
+    limit_config( &config );
+    if (( limit_init( &limit, format, &config ) < 0 ) ||
+        ( limit_share( &limit, LIMIT_SHM ) < 0 )) return -1;
+
+    for ( i = 0; i < periods; i++ )
+    {
+        benchSine( format, 997, &phase );
+        level = 4.0f * (( i / 8 ) % 4 + 1 ) * (( i % 8 ) < 3 );
+        for ( n = 0; n < format->period * format->channels; n++ )
+            samples[n] = STREAM_FROM_FLOAT( STREAM_TO_FLOAT( samples[n] ) *
+                                            ( level + 0.5f ));
+
+        start = benchTime();
+        limit_process( &limit, samples, format->period );
+        time += benchTime() - start;
+
+        for ( n = 0; n < format->period * format->channels; n++ )
+        {
+            s = fabsf( STREAM_TO_FLOAT( samples[n] ));
+            if ( s > peak ) peak = s;
+        }
+    }
+
+    printf( "\nLimiter %.1fdBFS, %.1fms look-ahead (%u frames): "
+            "max output %.2fdBFS, %.2f%% load.\n",
+            config.ceiling, config.lookahead, limit_latency( &limit ),
+            20 * log10f( peak ), 100.0 * time / BENCH_SECONDS );
+    printf( "Published for meterPi: %u periods, last GR %.1fdB.\n",
+            limit.shm->periods, limit.shm->limit );
+    limit_free( &limit );
+
+    if ( 20 * log10f( peak ) > config.ceiling + 0.01f ) return -1;
+
+    // Level falling every frame from 4 times full scale, with the longest
+    // look-ahead so the window peak deque is always full, and a fast
+    // release so the gain follows the window peak.
+    config.lookahead = 1000.0f * LIMIT_LOOKAHEAD_MAX / format->rate;
+    config.release   = 1;
+    if ( limit_init( &limit, format, &config ) < 0 ) return -1;
+    peak = 0;
+    for ( i = 0; i < format->rate / 2 / format->period; i++ )
+    {
+        for ( n = 0; n < format->period * format->channels; n++ )
+            samples[n] = STREAM_FROM_FLOAT( 4.0f *
+                expf( -( float )( i * format->period + n / format->channels ) /
+                      ( 0.02f * format->rate )));
+        limit_process( &limit, samples, format->period );
+        s = benchPeak( format );
+        if ( s > peak ) peak = s;
+    }
+    printf( "Limiter %u frame look-ahead, falling level: "
+            "max output %.2fdBFS.\n",
+            limit_latency( &limit ) + 1, 20 * log10f( peak ));
+    if ( 20 * log10f( peak ) > config.ceiling + 0.01f ) return -1;
+
+    // -10dBFS sine, -20dBFS threshold, 4:1.
+    limit_config( &config );
+    config.ratio = 4;
+    limit_init( &limit, format, &config );
+    for ( i = 0; i < 200; i++ )
+    {
+        benchSine( format, 997, &phase );
+        for ( n = 0; n < format->period * format->channels; n++ )
+            samples[n] = STREAM_FROM_FLOAT( STREAM_TO_FLOAT( samples[n] ) *
+                                            1.265f );
+        limit_process( &limit, samples, format->period );
+    }
+    printf( "Compressor 4:1 at -20dBFS, -10dBFS sine: "
+            "output %.2fdBFS (about -17.5).\n",
+            20 * log10f( benchPeak( format )));
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Measures requantiser noise in dB relative to 1 LSB RMS, in total and
+//  below 4kHz, for benchSine scaled by level.
+//  ---------------------------------------------------------------------------
+static void benchDitherNoise( uint8_t bits, uint8_t shape, float level,
+                              double *total, double *low )
+{
+    struct stream_format_t cd = { 44100, BENCH_CHANNELS, BENCH_PERIOD };
+    struct eq_filter_t lp = { EQ_LOW_PASS, 4000, 0, EQ_Q_DEFAULT, 0xff };
+    static float input[BENCH_PERIOD];
+    uint32_t phase = 0;
+    uint32_t i, n;
+    double   c[5];
+    double   error, out, z1 = 0, z2 = 0;
+
+    eq_design( &lp, cd.rate, 1.0, c );
+    dither_init( &dither, &cd, bits, shape, 1 );
+    *total = *low = 0;
+    for ( i = 0; i < 100; i++ )
+    {
+        benchSine( &cd, 997, &phase );
+        for ( n = 0; n < cd.period; n++ )
+        {
+            samples[n * cd.channels] =
+                STREAM_FROM_FLOAT( STREAM_TO_FLOAT(
+                    samples[n * cd.channels] ) * level );
+            input[n] = STREAM_TO_FLOAT( samples[n * cd.channels] );
+        }
+        dither_process( &dither, samples, cd.period );
+
+        for ( n = 0; n < cd.period; n++ )
+        {
+            error = (( double )STREAM_TO_FLOAT( samples[n * cd.channels] ) -
+                     input[n] ) * dither.scale;
+            out = c[0] * error + z1;
+            z1  = c[1] * error - c[3] * out + z2;
+            z2  = c[2] * error - c[4] * out;
+            *total += error * error;
+            *low   += out * out;
+        }
+    }
+    *total = 10 * log10( *total / ( 100 * cd.period ));
+    *low   = 10 * log10( *low / ( 100 * cd.period ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Prints requantiser noise and CPU cost for each noise shaping filter.
+//  ---------------------------------------------------------------------------
+/*
+    16 bits is measured on a quiet sine, where dither matters most, and
+    24 bits on a loud one, where a sample has the fewest bits below the
+    LSB. Both should be about the same.
+*/
+static void benchDither( struct stream_format_t *format )
+{
+    uint32_t periods = BENCH_SECONDS * format->rate / format->period;
+    uint32_t phase;
+    uint32_t i;
+    uint8_t  shape;
+    double   total16, low16, total24, low24;
+    double   start, time;
+
+    printf( "\n              16 bit, -60dBFS        24 bit, -1dBFS\n" );
+    printf( "Shaping       Noise   Below 4kHz     Noise   Below 4kHz   "
+            "ns/sample   Load/channel (%%)\n" );
+    for ( shape = DITHER_FLAT; shape <= DITHER_WANNAMAKER9; shape++ )
+    {
+        benchDitherNoise( 16, shape, 0.004f, &total16, &low16 );
+        benchDitherNoise( 24, shape, 3.564f, &total24, &low24 );
+
+        // CPU at 96kHz.
+        dither_init( &dither, format, 16, shape, 1 );
+        phase = 0;
+        time = 0;
+        for ( i = 0; i < periods; i++ )
+        {
+            benchSine( format, 997, &phase );
+            start = benchTime();
+            dither_process( &dither, samples, format->period );
+            time += benchTime() - start;
+        }
+
+        printf( "%-11s   %5.1f   %10.1f     %5.1f   %10.1f   "
+                "%9.2f   %16.3f\n",
+                dither_name( shape ), total16, low16, total24, low24,
+                1e9 * time / (( double )periods * format->period *
+                              format->channels ),
+                100.0 * time / BENCH_SECONDS / format->channels );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Checks resampler against an exact sine and prints CPU load.
+//  ---------------------------------------------------------------------------
+static void benchResample( struct stream_format_t *format )
+{
+    static float in[RESAMPLE_FRAMES_MAX * BENCH_CHANNELS];
+    static float out[BENCH_PERIOD * BENCH_CHANNELS];
+    const double w = 2 * M_PI * 1000 / format->rate;
+    double   ratios[] = { 1, 1.0001, 0.999, 1.001 };
+    uint32_t periods = BENCH_SECONDS * format->rate / format->period;
+    uint32_t consumed, needed;
+    uint32_t i, f, n;
+    uint8_t  r, ch;
+    double   p, error, signal;
+    double   start, time;
+
+    printf( "\nRatio (ppm)   Error (dB)   Load/channel (%%)\n" );
+    for ( r = 0; r < sizeof( ratios ) / sizeof( ratios[0] ); r++ )
+    {
+        resample_init( &resample, format->channels );
+        resample_set_ratio( &resample, ratios[r] );
+        consumed = 0;
+        error = signal = time = 0;
+
+        for ( i = 0; i < periods; i++ )
+        {
+            needed = resample_needed( &resample, format->period );
+            for ( f = 0; f < needed; f++ )
+                for ( ch = 0; ch < format->channels; ch++ )
+                    in[f * format->channels + ch] =
+                        0.5f * sin( w * ( consumed + f ));
+
+            // Input frame of first output.
+            p = resample.position - RESAMPLE_TAPS + consumed;
+            start = benchTime();
+            resample_process( &resample, in, needed, out, format->period );
+            time += benchTime() - start;
+            consumed += needed;
+
+            // Skip start up, where history is still zero.
+            if ( i < 4 ) continue;
+            for ( n = 0; n < format->period; n++ )
+            {
+                error  += pow( out[n * format->channels] -
+                               0.5 * sin( w * ( p + n * ratios[r] )), 2 );
+                signal += 0.125;
+            }
+        }
+
+        printf( "%11.0f   %10.1f   %16.3f\n", ( ratios[r] - 1 ) * 1e6,
+                10 * log10( error / signal ),
+                100.0 * time / BENCH_SECONDS / format->channels );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds a 1kHz stereo sine to loudness measurement.
+//  ---------------------------------------------------------------------------
+static void benchLoudSine( uint32_t rate, float db, uint32_t seconds )
+{
+    static float in[BENCH_PERIOD * BENCH_CHANNELS];
+    const float amp = powf( 10, db / 20 );
+    uint32_t i, f;
+
+    for ( i = 0; i < seconds * rate / BENCH_PERIOD; i++ )
+    {
+        for ( f = 0; f < BENCH_PERIOD; f++ )
+            in[f * 2] = in[f * 2 + 1] =
+                amp * sin( 2 * M_PI * 1000 * (( double )i * BENCH_PERIOD +
+                                               f ) / rate );
+        loud_add( &loud, in, BENCH_PERIOD );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Checks loudness against EBU test cases and prints CPU load.
+//  ---------------------------------------------------------------------------
+static int benchLoud( struct stream_format_t *format )
+{
+    float    levels[] = { -23, -33 };
+    double   lufs, start, time;
+    uint8_t  i;
+    int      ok = 0;
+
+    printf( "\nSine (dBFS)   Loudness (LUFS)\n" );
+    for ( i = 0; i < sizeof( levels ) / sizeof( levels[0] ); i++ )
+    {
+        loud_init( &loud, 48000, BENCH_CHANNELS );
+        benchLoudSine( 48000, levels[i], 20 );
+        lufs = loud_integrated( &loud );
+        printf( "%11.0f   %15.2f\n", levels[i], lufs );
+        if ( fabs( lufs - levels[i] ) > 0.1 ) ok = -1;
+    }
+
+    // Tech 3342 case 1, 20s at -20dBFS then 20s at -30dBFS.
+    loud_init( &loud, 48000, BENCH_CHANNELS );
+    benchLoudSine( 48000, -20, 20 );
+    benchLoudSine( 48000, -30, 20 );
+    printf( "Loudness range %.2fLU, expected 10LU.\n", loud_range( &loud ));
+    if ( fabs( loud_range( &loud ) - 10 ) > 1 ) ok = -1;
+
+    loud_init( &loud, format->rate, BENCH_CHANNELS );
+    start = benchTime();
+    benchLoudSine( format->rate, -20, BENCH_SECONDS );
+    time = benchTime() - start;
+    printf( "Load including sine generation %.3f%%.\n",
+            100.0 * time / BENCH_SECONDS );
+
+    return ok;
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    struct stream_format_t format =
+        { BENCH_RATE, BENCH_CHANNELS, BENCH_PERIOD };
+    uint8_t biquads[] = { 1, 4, 8, 16, 32 };
+    uint8_t channels = 0xff;
+    uint8_t fit = 0;
+    uint8_t i, j;
+    char    line[64];
+    char   *eqFile = NULL;
+    char   *convFile = NULL;
+    float   latency = 20;
+    double  load;
+    int     opt;
+
+    while (( opt = getopt( argc, argv, "e:c:l:" )) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'e': eqFile = optarg; break;
+            case 'c': convFile = optarg; break;
+            case 'l': latency = atof( optarg ); break;
+            default:
+                printf( "Usage: %s [-e eq config] [-c FIR filter] "
+                        "[-l latency]\n", argv[0] );
+                return 1;
+        }
+    }
+
+#ifdef STREAM_FIXED
+    printf( "Q28 fixed point samples.\n" );
+#else
+    printf( "Float samples.\n" );
+#endif
+    if ( benchCheck( &format ) < 0 )
+    {
+        printf( "Peak filter check failed.\n" );
+        return 1;
+    }
+    if ( benchConvCheck( &format ) < 0 )
+    {
+        printf( "Convolution check failed.\n" );
+        return 1;
+    }
+
+    printf( "%uHz, %u channels, period %u, %us of audio.\n\n",
+            format.rate, format.channels, format.period, BENCH_SECONDS );
+    printf( "Biquads   Load (%%)   Ramping (%%)\n" );
+
+    for ( i = 0; i < sizeof( biquads ); i++ )
+    {
+        memset( &config, 0, sizeof( config ));
+        for ( j = 0; j < biquads[i]; j++ )
+        {
+            snprintf( line, sizeof( line ),
+                      "Filter: ON PK Fc %u Hz Gain -1.0 dB Q 2.0",
+                      40 + 600 * j );
+            eq_parse( &config, line, &channels );
+        }
+
+        load = benchRun( &format, false );
+        printf( "%7u   %8.2f   %11.2f\n", biquads[i], load,
+                benchRun( &format, true ));
+        if ( load <= BENCH_LOAD ) fit = biquads[i];
+    }
+    printf( "\nUp to %u biquads per channel within %.0f%% load.\n",
+            fit, BENCH_LOAD );
+
+    if ( eqFile != NULL )
+    {
+        if ( eq_read( &config, eqFile ) < 0 ) return 1;
+        printf( "%s: %u filters, %.2f%% load.\n", eqFile,
+                config.filters, benchRun( &format, false ));
+    }
+
+    benchConv( &format );
+    benchContour( &format );
+    if ( benchLimit( &format ) < 0 )
+    {
+        printf( "Limiter check failed.\n" );
+        return 1;
+    }
+    benchDither( &format );
+    benchResample( &format );
+    if ( benchLoud( &format ) < 0 )
+    {
+        printf( "Loudness check failed.\n" );
+        return 1;
+    }
+
+    if ( convFile != NULL )
+    {
+        for ( i = 0; i < format.channels; i++ )
+            if ( conv_read( &filter[i], convFile, i ) < 0 ) return 1;
+        benchConvRun( &format, conv_partition( format.rate, latency ));
+        for ( i = 0; i < format.channels; i++ )
+            conv_filter_free( &filter[i] );
+    }
+
+    return 0;
+}
@@ -0,0 +1,718 @@
+/*
+//  ===========================================================================
+
+    bridgePi:
+
+    Bridges an ALSA capture device to a playback device with a different
+    clock, using streamPi and an adaptive resampler.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Using a DLL to filter time, F.Adriaensen, LAC 2005.
+        Controlling adaptive resampling, F.Adriaensen, LAC 2012.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc bridgePi.c resamplePi.c streamPi.c ditherPi.c -Wall -O3
+            -o bridgePi -lasound -lpthread -lm
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        bridgePi [-c capture] [-p playback] [-r rate] [-n channels]
+                 [-f period] [-b bits] [-l latency] [-w bandwidth]
+                 [-t seconds] [-s ppm] [-j jitter]
+
+    Reads from a capture device, e.g. S/PDIF or USB input, and plays to
+    another device, e.g. an I2S DAC, running both at the same nominal rate.
+    The two clocks always differ by some ppm, so without correction the
+    buffer between them slowly fills or empties until there is an xrun.
+
+    Capture runs in its own thread and writes into a lock-free ring. The
+    playback thread measures the total latency from capture to output,
+    filters it and feeds it to a PI controller, which sets the ratio of a
+    resamplePi resampler. The controller locks in a few seconds and then
+    holds the latency to within a fraction of a millisecond, with a ratio
+    that follows the true clock difference.
+
+    Prints the ring fill, latency, ratio in ppm and xruns once a second.
+    -t stops after a number of seconds, 0 to run until interrupted.
+
+    With -s, no sound devices are used. The capture clock runs fast by the
+    given ppm (negative for slow) and both threads are simulated with up to
+    -j ms of scheduling jitter, as fast as the CPU allows, for -t seconds
+    of audio (default one hour). Prints the drift found by the controller,
+    the latency error and xruns, and fails if there were any xruns.
+
+    To test on real devices, load the ALSA loopback driver and skew the
+    rate of one of its cables:
+
+        sudo modprobe snd-aloop pcm_substreams=2
+        amixer -c Loopback cset name='PCM Rate Shift 100000' 100050
+        aplay -D hw:Loopback,0,0 music.wav &
+        arecord -D hw:Loopback,1,1 -f S16_LE -r 48000 -c 2 > /dev/null &
+        bridgePi -c hw:Loopback,1,0 -p hw:Loopback,0,1
+
+    Rate shift is in units of 10ppm of 100000, so 100050 runs the first
+    cable 500ppm fast. The bridge should lock to a ratio about 500ppm from
+    1 and run for hours with no xruns.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <math.h>
+#include <alsa/asoundlib.h>
+
+#include "streamPi.h"
+#include "resamplePi.h"
+#include "ditherPi.h"
+
+#define BRIDGE_RATE       48000
+#define BRIDGE_CHANNELS   2
+#define BRIDGE_PERIOD     256
+#define BRIDGE_PERIODS    4     // Periods per device buffer.
+#define BRIDGE_RING       16384 // Ring size (frames), power of 2.
+#define BRIDGE_BANDWIDTH  0.05  // Control loop bandwidth (Hz).
+#define BRIDGE_SMOOTH     0.5   // Latency filter time constant (s).
+#define BRIDGE_PPM_MAX    1000  // Correction limit (ppm).
+#define BRIDGE_SETTLE     60    // Seconds before simulation checks.
+
+//  Types. --------------------------------------------------------------------
+
+struct bridge_t
+{
+    uint32_t rate;
+    uint8_t  channels;
+    uint16_t period;
+    uint32_t target;            // Ring fill to start playback (frames).
+
+    // Ring written by capture and read by playback.
+    float    ring[BRIDGE_RING * STREAM_CHANNELS_MAX];
+    uint32_t head;              // Frames written.
+    uint32_t tail;              // Frames read.
+
+    // Time of last capture, as a seqlock.
+    uint32_t seq;
+    double   stamp;
+
+    // Control loop.
+    double   kp, ki;            // PI gains.
+    double   smooth;            // Latency filter coefficient.
+    double   latency;           // Filtered latency (frames).
+    double   setpoint;          // Locked latency (frames).
+    double   integral;          // Drift estimate.
+    double   ratio;
+    bool     locked;
+
+    struct resample_t resample;
+    float    in[RESAMPLE_FRAMES_MAX * STREAM_CHANNELS_MAX];
+    float    out[STREAM_PERIOD_MAX * STREAM_CHANNELS_MAX];
+
+    // Counters.
+    uint32_t overruns;          // Capture frames dropped, ring full.
+    uint32_t underruns;         // Playback periods of silence, ring empty.
+    uint32_t xruns;             // Device xruns.
+};
+
+struct device_t
+{
+    snd_pcm_t *pcm;
+    uint8_t    bits;
+    uint32_t   buffer;          // Device buffer (frames).
+    int16_t    s16[STREAM_PERIOD_MAX * STREAM_CHANNELS_MAX];
+    int32_t    s32[STREAM_PERIOD_MAX * STREAM_CHANNELS_MAX];
+};
+
+static struct bridge_t bridge;
+static struct device_t capture, playback;
+static struct stream_t stream;
+static struct dither_t dither;
+static sample_t samples[STREAM_PERIOD_MAX * STREAM_CHANNELS_MAX];
+static volatile bool running = true;
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns monotonic time in seconds.
+//  ---------------------------------------------------------------------------
+static double bridgeTime( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises bridge.
+//  ---------------------------------------------------------------------------
+/*
+    Latency in seconds obeys d/dt e = drift - correction, i.e. a pure
+    integrator, so a PI controller gives a second order loop with
+
+        kp = 2 zeta w,  ki = w^2
+
+    where w = 2 pi bandwidth. zeta = 0.707 gives no overshoot to speak of.
+*/
+static int8_t bridgeInit( struct bridge_t *b, uint32_t rate,
+                          uint8_t channels, uint16_t period,
+                          uint32_t target, double bandwidth )
+{
+    double w = 2 * M_PI * bandwidth;
+    double dt = ( double )period / rate;
+
+    if (( target + 2 * period > BRIDGE_RING ) ||
+        ( period > RESAMPLE_FRAMES_MAX / 2 )) return -1;
+
+    memset( b, 0, sizeof( struct bridge_t ));
+    if ( resample_init( &b->resample, channels ) < 0 ) return -1;
+
+    b->rate     = rate;
+    b->channels = channels;
+    b->period   = period;
+    b->target   = target;
+    b->kp       = sqrt( 2 ) * w;
+    b->ki       = w * w;
+    b->smooth   = 1 - exp( -dt / BRIDGE_SMOOTH );
+    b->ratio    = 1;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns frames in ring.
+//  ---------------------------------------------------------------------------
+static uint32_t bridgeFill( struct bridge_t *b )
+{
+    return __atomic_load_n( &b->head, __ATOMIC_ACQUIRE ) -
+           __atomic_load_n( &b->tail, __ATOMIC_RELAXED );
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes captured frames into ring. Called by capture thread only.
+//  ---------------------------------------------------------------------------
+static void bridgeWrite( struct bridge_t *b, const float *in,
+                         uint32_t frames, double now )
+{
+    uint32_t head = b->head;
+    uint32_t tail = __atomic_load_n( &b->tail, __ATOMIC_ACQUIRE );
+    uint32_t pos = head & ( BRIDGE_RING - 1 );
+    uint32_t first;
+
+    if ( BRIDGE_RING - ( head - tail ) < frames )
+    {
+        b->overruns += frames;
+        return;
+    }
+
+    first = BRIDGE_RING - pos;
+    if ( first > frames ) first = frames;
+    memcpy( b->ring + pos * b->channels, in,
+            first * b->channels * sizeof( float ));
+    memcpy( b->ring, in + first * b->channels,
+            ( frames - first ) * b->channels * sizeof( float ));
+
+    __atomic_store_n( &b->head, head + frames, __ATOMIC_RELEASE );
+
+    __atomic_store_n( &b->seq, b->seq + 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+    b->stamp = now;
+    __atomic_store_n( &b->seq, b->seq + 1, __ATOMIC_RELEASE );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns frames captured but not yet in the ring, estimated from time.
+//  ---------------------------------------------------------------------------
+static double bridgePending( struct bridge_t *b, double now )
+{
+    uint32_t seq;
+    double   stamp, pending;
+
+    do
+    {
+        seq = __atomic_load_n( &b->seq, __ATOMIC_ACQUIRE );
+        stamp = b->stamp;
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    } while (( seq & 1 ) || ( seq != __atomic_load_n( &b->seq,
+                                                     __ATOMIC_RELAXED )));
+
+    pending = ( now - stamp ) * b->rate;
+    if ( pending < 0 ) pending = 0;
+    if ( pending > b->period ) pending = b->period;
+
+    return pending;
+}
+
+//  ---------------------------------------------------------------------------
+//  Updates ratio from latency. Called once per playback period.
+//  ---------------------------------------------------------------------------
+/*
+    delay is the frames queued in the playback device. Latency counts every
+    frame between the capture and playback clocks, so it only changes with
+    drift, not with where each thread is in its period.
+*/
+static void bridgeControl( struct bridge_t *b, double delay, double now )
+{
+    const double dt = ( double )b->period / b->rate;
+    const double limit = BRIDGE_PPM_MAX * 1e-6;
+    double latency, error, correction;
+
+    latency = bridgeFill( b ) + bridgePending( b, now ) +
+              resample_delay( &b->resample ) + delay * b->ratio;
+
+    if ( !b->locked )
+    {
+        b->latency  = latency;
+        b->setpoint = latency;
+        b->locked   = true;
+    }
+    b->latency += b->smooth * ( latency - b->latency );
+
+    // Error in seconds, positive when too full, so read faster.
+    error = ( b->latency - b->setpoint ) / b->rate;
+    b->integral += b->ki * error * dt;
+    if ( b->integral > limit ) b->integral = limit;
+    if ( b->integral < -limit ) b->integral = -limit;
+
+    correction = b->integral + b->kp * error;
+    if ( correction > limit ) correction = limit;
+    if ( correction < -limit ) correction = -limit;
+
+    b->ratio = 1 + correction;
+    resample_set_ratio( &b->resample, b->ratio );
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads one period of resampled output. Called by playback thread only.
+//  ---------------------------------------------------------------------------
+static void bridgeRead( struct bridge_t *b, float *out, double delay,
+                        double now )
+{
+    uint32_t tail = b->tail;
+    uint32_t pos = tail & ( BRIDGE_RING - 1 );
+    uint32_t needed, first;
+
+    bridgeControl( b, delay, now );
+
+    needed = resample_needed( &b->resample, b->period );
+    if ( bridgeFill( b ) < needed )
+    {
+        memset( out, 0, b->period * b->channels * sizeof( float ));
+        b->underruns++;
+        return;
+    }
+
+    first = BRIDGE_RING - pos;
+    if ( first > needed ) first = needed;
+    memcpy( b->in, b->ring + pos * b->channels,
+            first * b->channels * sizeof( float ));
+    memcpy( b->in + first * b->channels, b->ring,
+            ( needed - first ) * b->channels * sizeof( float ));
+    __atomic_store_n( &b->tail, tail + needed, __ATOMIC_RELEASE );
+
+    resample_process( &b->resample, b->in, needed, out, b->period );
+}
+
+//  ---------------------------------------------------------------------------
+//  Simulates capture and playback with skewed clocks.
+//  ---------------------------------------------------------------------------
+/*
+    Capture hardware position is t * rate * ( 1 + ppm ) and playback is
+    t * rate. Each thread wakes when a period is ready, plus a random
+    scheduling delay, and xruns if its device buffer overflows or runs dry.
+*/
+static int bridgeSimulate( struct bridge_t *b, double ppm, double jitter,
+                           double seconds )
+{
+    const uint32_t period = b->period;
+    const uint32_t buffer = period * BRIDGE_PERIODS;
+    const double   in_rate = b->rate * ( 1 + ppm * 1e-6 );
+    const double   out_rate = b->rate;
+    static float   in[STREAM_PERIOD_MAX * STREAM_CHANNELS_MAX];
+    double   t_in = 0, t_out = 0;       // Next wake times.
+    double   start = -1;                // Playback start time.
+    double   read = 0, written = 0;     // Device frames moved.
+    double   next = 60;                 // Next report.
+    double   error, error_max = 0;
+    double   cpu;
+    uint32_t fill_min = BRIDGE_RING;
+    uint32_t phase = 0;
+    uint32_t f;
+    uint8_t  ch;
+
+    printf( "Simulating %.0fs at %uHz, capture %+.1fppm, "
+            "jitter %.1fms.\n", seconds, b->rate, ppm, jitter * 1000 );
+    srand48( 1 );
+    cpu = clock();
+
+    t_in = period / in_rate + drand48() * jitter;
+    while ( t_in < seconds || t_out < seconds )
+    {
+        if (( start < 0 ) || ( t_in <= t_out ))
+        {
+            // Capture wakes, overruns if its buffer has filled.
+            if ( t_in * in_rate - read > buffer )
+            {
+                b->xruns++;
+                read = floor( t_in * in_rate ) - period;
+            }
+            for ( f = 0; f < period; f++, phase++ )
+                for ( ch = 0; ch < b->channels; ch++ )
+                    in[f * b->channels + ch] =
+                        0.5f * sinf( 2 * M_PI * 1000 * phase / in_rate );
+            bridgeWrite( b, in, period, t_in );
+            read += period;
+
+            if (( start < 0 ) && ( bridgeFill( b ) >= b->target ))
+            {
+                // Playback starts with its buffer full of silence.
+                start = t_out = t_in;
+                written = buffer;
+            }
+
+            // Next period, or at once if already available.
+            if (( read + period ) / in_rate > t_in )
+                t_in = ( read + period ) / in_rate + drand48() * jitter;
+            continue;
+        }
+
+        // Playback wakes, xruns if its buffer has run dry.
+        if (( t_out - start ) * out_rate > written )
+        {
+            b->xruns++;
+            written = ceil(( t_out - start ) * out_rate );
+        }
+        bridgeRead( b, b->out, written - ( t_out - start ) * out_rate,
+                    t_out );
+        written += period;
+
+        if ( t_out - start > BRIDGE_SETTLE )
+        {
+            error = fabs( b->latency - b->setpoint ) / b->rate;
+            if ( error > error_max ) error_max = error;
+            if ( bridgeFill( b ) < fill_min ) fill_min = bridgeFill( b );
+        }
+        if ( t_out >= next )
+        {
+            printf( "%6.0fs   ratio %+8.2fppm   latency %6.2fms   "
+                    "xruns %u\n", t_out, ( b->ratio - 1 ) * 1e6,
+                    b->latency * 1000 / b->rate, b->xruns );
+            next += ( seconds > 600 ) ? 600 : 60;
+        }
+
+        if (( written - buffer + period ) / out_rate > t_out - start )
+            t_out = start + ( written - buffer + period ) / out_rate +
+                    drand48() * jitter;
+    }
+
+    printf( "\nDrift %+.2fppm, found %+.2fppm.\n", ppm, b->integral * 1e6 );
+    printf( "Latency %.2fms, error after %us up to %.3fms.\n",
+            b->setpoint * 1000 / b->rate, BRIDGE_SETTLE, error_max * 1000 );
+    printf( "Ring fill at least %u frames, %u underruns, %u overruns, "
+            "%u xruns.\n", fill_min, b->underruns, b->overruns, b->xruns );
+    printf( "CPU %.1fs for %.0fs of audio.\n",
+            ( clock() - cpu ) / CLOCKS_PER_SEC, seconds );
+
+    return ( b->xruns || b->underruns || b->overruns ) ? 1 : 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Opens a PCM device.
+//  ---------------------------------------------------------------------------
+static int8_t bridgeOpen( struct device_t *device, const char *name,
+                          snd_pcm_stream_t direction, struct bridge_t *b,
+                          uint8_t bits )
+{
+    snd_pcm_uframes_t buffer, period;
+    int err;
+
+    err = snd_pcm_open( &device->pcm, name, direction, 0 );
+    if ( err < 0 )
+    {
+        fprintf( stderr, "Can't open %s: %s\n", name, snd_strerror( err ));
+        return -1;
+    }
+
+    // No ALSA resampling, the whole point is to do it here.
+    err = snd_pcm_set_params( device->pcm,
+                              ( bits == 16 ) ? SND_PCM_FORMAT_S16_LE
+                                             : SND_PCM_FORMAT_S24_LE,
+                              SND_PCM_ACCESS_RW_INTERLEAVED, b->channels,
+                              b->rate, 0, 1000000ull * b->period *
+                              BRIDGE_PERIODS / b->rate );
+    if ( err < 0 )
+    {
+        fprintf( stderr, "Can't set %s: %s\n", name, snd_strerror( err ));
+        snd_pcm_close( device->pcm );
+        return -1;
+    }
+
+    snd_pcm_get_params( device->pcm, &buffer, &period );
+    if ( period != b->period )
+        fprintf( stderr, "Warning: %s period is %lu frames.\n", name,
+                 ( unsigned long )period );
+    device->bits   = bits;
+    device->buffer = buffer;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Capture thread.
+//  ---------------------------------------------------------------------------
+static void *bridgeCapture( void *data )
+{
+    struct bridge_t *b = data;
+    static float in[STREAM_PERIOD_MAX * STREAM_CHANNELS_MAX];
+    const uint32_t count = b->period * b->channels;
+    snd_pcm_sframes_t frames;
+    uint32_t i;
+
+    while ( running )
+    {
+        if ( capture.bits == 16 )
+            frames = snd_pcm_readi( capture.pcm, capture.s16, b->period );
+        else
+            frames = snd_pcm_readi( capture.pcm, capture.s32, b->period );
+
+        if ( frames < 0 )
+        {
+            b->xruns++;
+            if ( snd_pcm_recover( capture.pcm, frames, 1 ) < 0 ) break;
+            continue;
+        }
+
+        if ( capture.bits == 16 )
+            for ( i = 0; i < count; i++ )
+                in[i] = capture.s16[i] * ( 1.0f / 32768 );
+        else
+            for ( i = 0; i < count; i++ )
+                in[i] = (( int32_t )( capture.s32[i] << 8 ) >> 8 ) *
+                        ( 1.0f / 8388608 );
+
+        bridgeWrite( b, in, frames, bridgeTime());
+    }
+    running = false;
+
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes one period to the playback device.
+//  ---------------------------------------------------------------------------
+static int8_t bridgePlay( struct bridge_t *b, const float *out )
+{
+    const uint32_t count = b->period * b->channels;
+    snd_pcm_sframes_t frames;
+    uint32_t i;
+
+    for ( i = 0; i < count; i++ ) samples[i] = STREAM_FROM_FLOAT( out[i] );
+    stream_process( &stream, samples, b->period );
+
+    if ( playback.bits == 16 )
+    {
+        stream_to_s16( playback.s16, samples, count );
+        frames = snd_pcm_writei( playback.pcm, playback.s16, b->period );
+    }
+    else
+    {
+        stream_to_s24( playback.s32, samples, count );
+        frames = snd_pcm_writei( playback.pcm, playback.s32, b->period );
+    }
+
+    if ( frames < 0 )
+    {
+        b->xruns++;
+        if ( snd_pcm_recover( playback.pcm, frames, 1 ) < 0 ) return -1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs the bridge between two devices.
+//  ---------------------------------------------------------------------------
+static int bridgeRun( struct bridge_t *b, double seconds )
+{
+    struct sched_param param = { .sched_priority = 50 };
+    pthread_t thread;
+    snd_pcm_sframes_t delay;
+    double   start, now, next;
+    uint32_t i;
+
+    // Real time priority for both threads if allowed.
+    pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+    if ( pthread_create( &thread, NULL, bridgeCapture, b ) != 0 ) return 1;
+    param.sched_priority = 49;
+    pthread_setschedparam( thread, SCHED_FIFO, &param );
+
+    // Wait for capture to reach target, then fill playback with silence.
+    while ( running && ( bridgeFill( b ) < b->target )) usleep( 1000 );
+    memset( b->out, 0, sizeof( b->out ));
+    for ( i = 0; i < playback.buffer / b->period; i++ )
+        bridgePlay( b, b->out );
+
+    start = next = bridgeTime();
+    while ( running )
+    {
+        now = bridgeTime();
+        if ( snd_pcm_delay( playback.pcm, &delay ) < 0 ) delay = 0;
+        bridgeRead( b, b->out, delay, now );
+        if ( bridgePlay( b, b->out ) < 0 ) break;
+
+        if ( now >= next )
+        {
+            printf( "Fill %6.2fms   latency %6.2fms   ratio %+8.2fppm   "
+                    "xruns %u   underruns %u\n",
+                    bridgeFill( b ) * 1000.0 / b->rate,
+                    b->latency * 1000 / b->rate, ( b->ratio - 1 ) * 1e6,
+                    b->xruns, b->underruns );
+            fflush( stdout );
+            next += 1;
+        }
+        if (( seconds > 0 ) && ( now - start >= seconds )) break;
+    }
+
+    running = false;
+    snd_pcm_drop( capture.pcm );
+    pthread_join( thread, NULL );
+
+    return ( b->xruns || b->underruns ) ? 1 : 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Stops bridge on interrupt.
+//  ---------------------------------------------------------------------------
+static void bridgeStop( int signal )
+{
+    running = false;
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    struct stream_stage_t stage;
+    char    *captureName = "hw:1,0";
+    char    *playbackName = "hw:0,0";
+    uint32_t rate = BRIDGE_RATE;
+    uint8_t  channels = BRIDGE_CHANNELS;
+    uint16_t period = BRIDGE_PERIOD;
+    uint8_t  bits = 16;
+    float    latency = 0;
+    float    bandwidth = BRIDGE_BANDWIDTH;
+    float    seconds = -1;
+    float    jitter = 1;
+    float    ppm = 0;
+    bool     simulate = false;
+    uint32_t target;
+    int      result;
+    int      opt;
+
+    while (( opt = getopt( argc, argv, "c:p:r:n:f:b:l:w:t:s:j:" )) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'c': captureName = optarg; break;
+            case 'p': playbackName = optarg; break;
+            case 'r': rate = atoi( optarg ); break;
+            case 'n': channels = atoi( optarg ); break;
+            case 'f': period = atoi( optarg ); break;
+            case 'b': bits = atoi( optarg ); break;
+            case 'l': latency = atof( optarg ); break;
+            case 'w': bandwidth = atof( optarg ); break;
+            case 't': seconds = atof( optarg ); break;
+            case 's': ppm = atof( optarg ); simulate = true; break;
+            case 'j': jitter = atof( optarg ); break;
+            default:
+                printf( "Usage: %s [-c capture] [-p playback] [-r rate] "
+                        "[-n channels]\n       [-f period] [-b bits] "
+                        "[-l latency] [-w bandwidth]\n       [-t seconds] "
+                        "[-s ppm] [-j jitter]\n", argv[0] );
+                return 1;
+        }
+    }
+
+    // Ring latency defaults to 3 periods, room for jitter of one period.
+    target = ( latency > 0 ) ? lroundf( latency * rate / 1000 )
+                             : 3 * period;
+    if (( bits != 16 ) && ( bits != 24 ))
+    {
+        fprintf( stderr, "Bits must be 16 or 24.\n" );
+        return 1;
+    }
+    if (( stream_init( &stream, rate, channels, period ) < 0 ) ||
+        ( bridgeInit( &bridge, rate, channels, period, target,
+                      bandwidth ) < 0 ))
+    {
+        fprintf( stderr, "Invalid rate, channels, period or latency.\n" );
+        return 1;
+    }
+
+    if ( simulate )
+        return bridgeSimulate( &bridge, ppm, jitter / 1000,
+                               ( seconds < 0 ) ? 3600 : seconds );
+
+    // Requantise resampled output to the DAC word length.
+    dither_init( &dither, &stream.format, bits,
+                 ( bits == 16 ) ? DITHER_SIMPLE : DITHER_FLAT, 0 );
+    dither_stage( &dither, &stage );
+    stream_add( &stream, &stage );
+
+    if ( bridgeOpen( &capture, captureName, SND_PCM_STREAM_CAPTURE,
+                     &bridge, bits ) < 0 ) return 1;
+    if ( bridgeOpen( &playback, playbackName, SND_PCM_STREAM_PLAYBACK,
+                     &bridge, bits ) < 0 )
+    {
+        snd_pcm_close( capture.pcm );
+        return 1;
+    }
+
+    signal( SIGINT, bridgeStop );
+    signal( SIGTERM, bridgeStop );
+    printf( "%s -> %s, %uHz, %u channels, %u bits, period %u, "
+            "ring %.1fms.\n", captureName, playbackName, rate, channels,
+            bits, period, target * 1000.0 / rate );
+
+    result = bridgeRun( &bridge, ( seconds < 0 ) ? 0 : seconds );
+
+    snd_pcm_close( capture.pcm );
+    snd_pcm_close( playback.pcm );
+    stream_free( &stream );
+
+    return result;
+}
@@ -0,0 +1,348 @@
+//  ===========================================================================
+/*
+    contourPi:
+
+    Loudness compensation and headphone crossfeed stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Bauer stereophonic-to-binaural DSP (bs2b) by Boris Mikhaylov.
+        - see http://bs2b.sourceforge.net
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic contourPi.c eqPi.c streamPi.c -lm
+        gcc -shared -o libcontourPi.so contourPi.o eqPi.o streamPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "eqPi.h"
+#include "contourPi.h"
+
+//  Loudness. -----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Sets profile to defaults.
+//  ---------------------------------------------------------------------------
+void contour_profile( struct contour_profile_t *profile )
+{
+    profile->bass_freq    = CONTOUR_BASS_FREQ;
+    profile->bass_slope   = CONTOUR_BASS_SLOPE;
+    profile->bass_max     = CONTOUR_BASS_MAX;
+    profile->treble_freq  = CONTOUR_TREBLE_FREQ;
+    profile->treble_slope = CONTOUR_TREBLE_SLOPE;
+    profile->treble_max   = CONTOUR_TREBLE_MAX;
+    profile->threshold    = CONTOUR_THRESHOLD;
+    profile->headroom     = true;
+}
+
+//  ---------------------------------------------------------------------------
+//  Calculates attenuation of each volume index for an alsaPi profile.
+//  ---------------------------------------------------------------------------
+/*
+    Same mapping as calcVol, giving the position of the volume between
+    sound.min (0) and sound.max (1).
+*/
+void contour_atten( float *atten, uint8_t incs, float factor, float range )
+{
+    float    ratio;
+    uint16_t i;
+
+    for ( i = 0; i <= incs; i++ )
+    {
+        ratio = ( incs == 0 ) ? 1 : ( float )i / incs;
+        if ( factor != 1 )
+            ratio = ( powf( factor, ratio ) - 1 ) / ( factor - 1 );
+        atten[i] = ( 1 - ratio ) * range;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns shelf gain (dB) for an attenuation.
+//  ---------------------------------------------------------------------------
+static float contour_gain( float atten, float threshold, float slope,
+                           float max )
+{
+    float gain = slope * ( atten - threshold );
+
+    if ( gain < 0 ) gain = 0;
+    if ( gain > max ) gain = max;
+
+    return gain;
+}
+
+//  ---------------------------------------------------------------------------
+//  Calculates coefficient sets for every volume index.
+//  ---------------------------------------------------------------------------
+int8_t contour_init( struct contour_t *contour,
+                     struct stream_format_t *format,
+                     struct contour_profile_t *profile,
+                     const float *atten, uint8_t incs )
+{
+    struct eq_filter_t bass = { EQ_LOW_SHELF, 0, 0, EQ_Q_DEFAULT, 0xff };
+    struct eq_filter_t treble = { EQ_HIGH_SHELF, 0, 0, EQ_Q_DEFAULT, 0xff };
+    double   c[5];
+    double   gain;
+    uint16_t i;
+    uint8_t  k;
+
+    if (( incs == 0 ) ||
+        ( profile->bass_freq <= 0 ) ||
+        ( profile->treble_freq >= format->rate / 2 ) ||
+        ( profile->bass_freq >= profile->treble_freq )) return -1;
+
+    memset( contour, 0, sizeof( struct contour_t ));
+    contour->format = *format;
+    contour->incs   = incs;
+    contour->table  = malloc(( incs + 1 ) * sizeof( struct contour_set_t ));
+    if ( contour->table == NULL ) return -2;
+
+    bass.freq   = profile->bass_freq;
+    treble.freq = profile->treble_freq;
+
+    for ( i = 0; i <= incs; i++ )
+    {
+        bass.gain   = contour_gain( atten[i], profile->threshold,
+                                    profile->bass_slope, profile->bass_max );
+        treble.gain = contour_gain( atten[i], profile->threshold,
+                                    profile->treble_slope,
+                                    profile->treble_max );
+
+        gain = 1.0;
+        if ( profile->headroom )
+            gain = pow( 10.0, -fmax( bass.gain, treble.gain ) / 20.0 );
+
+        eq_design( &bass, format->rate, gain, c );
+        for ( k = 0; k < 5; k++ ) contour->table[i].c[0][k] = c[k];
+        eq_design( &treble, format->rate, 1.0, c );
+        for ( k = 0; k < 5; k++ ) contour->table[i].c[1][k] = c[k];
+    }
+
+    contour->own   = incs;
+    contour->index = &contour->own;
+    contour->last  = incs;
+    memcpy( contour->c, contour->table[incs].c, sizeof( contour->c ));
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads volume index from a variable, e.g. &sound.index.
+//  ---------------------------------------------------------------------------
+void contour_link( struct contour_t *contour,
+                   volatile unsigned char *index )
+{
+    contour->index = ( index == NULL ) ? &contour->own : index;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets volume index.
+//  ---------------------------------------------------------------------------
+void contour_set_index( struct contour_t *contour, uint8_t index )
+{
+    contour->own = index;
+}
+
+//  Crossfeed. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Sets crossfeed. A feed of 0 turns crossfeed off.
+//  ---------------------------------------------------------------------------
+/*
+    Filters as bs2b. The low pass has gain G_lo and the high boost has gain
+    1 - G_hi at low frequencies, with the high boost corner placed so that
+    the sum of direct and crossfed signals is flat.
+*/
+int8_t contour_crossfeed( struct contour_t *contour, uint16_t freq,
+                          float feed )
+{
+    struct crossfeed_t *cf = &contour->crossfeed;
+    double gb_lo, gb_hi, g_lo, g_hi, fc_hi, x;
+
+    if ( feed == 0 )
+    {
+        cf->enabled = false;
+        return 0;
+    }
+    if (( contour->format.channels != 2 ) ||
+        ( freq < CROSSFEED_FREQ_MIN ) || ( freq > CROSSFEED_FREQ_MAX ) ||
+        ( feed < CROSSFEED_FEED_MIN ) || ( feed > CROSSFEED_FEED_MAX ))
+        return -1;
+
+    gb_lo = feed * -5.0 / 6.0 - 3.0;
+    gb_hi = feed / 6.0 - 3.0;
+    g_lo  = pow( 10.0, gb_lo / 20.0 );
+    g_hi  = 1.0 - pow( 10.0, gb_hi / 20.0 );
+    fc_hi = freq * pow( 2.0, ( gb_lo - 20.0 * log10( g_hi )) / 12.0 );
+
+    x = exp( -2.0 * M_PI * freq / contour->format.rate );
+    cf->a0_lo = g_lo * ( 1.0 - x );
+    cf->b1_lo = x;
+
+    x = exp( -2.0 * M_PI * fc_hi / contour->format.rate );
+    cf->a0_hi = 1.0 - g_hi * ( 1.0 - x );
+    cf->a1_hi = -x;
+    cf->b1_hi = x;
+
+    cf->gain = 1.0 / ( 1.0 - g_hi + g_lo );
+    memset( cf->lo, 0, sizeof( cf->lo ));
+    memset( cf->hi, 0, sizeof( cf->hi ));
+    memset( cf->in, 0, sizeof( cf->in ));
+    cf->enabled = true;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Applies crossfeed to one stereo frame.
+//  ---------------------------------------------------------------------------
+static inline void contour_crossfeed_frame( struct crossfeed_t *cf,
+                                            float *l, float *r )
+{
+    cf->lo[0] = cf->a0_lo * *l + cf->b1_lo * cf->lo[0];
+    cf->lo[1] = cf->a0_lo * *r + cf->b1_lo * cf->lo[1];
+    cf->hi[0] = cf->a0_hi * *l + cf->a1_hi * cf->in[0] +
+                cf->b1_hi * cf->hi[0];
+    cf->hi[1] = cf->a0_hi * *r + cf->a1_hi * cf->in[1] +
+                cf->b1_hi * cf->hi[1];
+    cf->in[0] = *l;
+    cf->in[1] = *r;
+
+    *l = ( cf->hi[0] + cf->lo[1] ) * cf->gain;
+    *r = ( cf->hi[1] + cf->lo[0] ) * cf->gain;
+}
+
+//  Contour stage. ------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void contour_process( void *data, sample_t *samples, uint16_t frames )
+{
+    struct contour_t *contour = data;
+    const uint8_t     channels = contour->format.channels;
+    uint8_t           index = *contour->index;
+    uint16_t          f;
+    uint8_t           i, k, ch;
+    float             x[STREAM_CHANNELS_MAX];
+    float             in, out;
+
+    // Move to new set over one period.
+    if ( index > contour->incs ) index = contour->incs;
+    if ( index != contour->last )
+    {
+        for ( i = 0; i < 2; i++ )
+            for ( k = 0; k < 5; k++ )
+                contour->step[i][k] = ( contour->table[index].c[i][k] -
+                                        contour->c[i][k] ) /
+                                      contour->format.period;
+        contour->ramp = contour->format.period;
+        contour->last = index;
+    }
+
+    for ( f = 0; f < frames; f++, samples += channels )
+    {
+        if ( contour->ramp > 0 )
+        {
+            if ( --contour->ramp == 0 )
+                memcpy( contour->c, contour->table[index].c,
+                        sizeof( contour->c ));
+            else
+                for ( i = 0; i < 2; i++ )
+                    for ( k = 0; k < 5; k++ )
+                        contour->c[i][k] += contour->step[i][k];
+        }
+
+        for ( ch = 0; ch < channels; ch++ )
+            x[ch] = STREAM_TO_FLOAT( samples[ch] );
+
+        // Low shelf then high shelf, transposed direct form II.
+        for ( i = 0; i < 2; i++ )
+        {
+            float *c  = contour->c[i];
+            float *z1 = contour->z[i][0];
+            float *z2 = contour->z[i][1];
+
+            for ( ch = 0; ch < channels; ch++ )
+            {
+                in     = x[ch];
+                out    = c[0] * in + z1[ch];
+                z1[ch] = c[1] * in - c[3] * out + z2[ch];
+                z2[ch] = c[2] * in - c[4] * out;
+                x[ch]  = out;
+            }
+        }
+
+        if ( contour->crossfeed.enabled )
+            contour_crossfeed_frame( &contour->crossfeed, &x[0], &x[1] );
+
+        for ( ch = 0; ch < channels; ch++ )
+            samples[ch] = STREAM_FROM_FLOAT( x[ch] );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Frees coefficient sets.
+//  ---------------------------------------------------------------------------
+void contour_free( void *data )
+{
+    struct contour_t *contour = data;
+
+    free( contour->table );
+    contour->table = NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for loudness and crossfeed.
+//  ---------------------------------------------------------------------------
+void contour_stage( struct contour_t *contour, struct stream_stage_t *stage )
+{
+    stage->name    = "contour";
+    stage->data    = contour;
+    stage->process = contour_process;
+    stage->free    = contour_free;
+}
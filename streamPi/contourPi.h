@@ -0,0 +1,211 @@
+//  ===========================================================================
+/*
+    contourPi:
+
+    Loudness compensation and headphone crossfeed stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Bauer stereophonic-to-binaural DSP (bs2b) by Boris Mikhaylov.
+        - see http://bs2b.sourceforge.net
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef CONTOURPI_H
+#define CONTOURPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    Hearing is less sensitive to bass, and to a lesser extent treble, at
+    low levels, so music sounds thin when the volume is turned down. This
+    stage adds a low shelf and a high shelf whose gains follow the volume
+    index used by alsaPi (sound.index, 0 to sound.incs).
+
+    The attenuation of each index is worked out with the same mapping as
+    calcVol in alsaPi, and the shelf gains are
+
+        gain = slope * ( attenuation - threshold ), 0 to max (dB)
+
+    Coefficients for every index are calculated by contour_init, so a turn
+    of the encoder only selects another set. The audio thread reads the
+    index once per period and moves linearly to the new set over that
+    period. With headroom set, the largest shelf gain is taken off all
+    frequencies so that the boost can't clip before the mixer attenuates.
+
+    The index is read from contour->index, which can point at sound.index
+    when alsaPi runs in the same process:
+
+        contour_link( &contour, &sound.index );
+
+    or set with contour_set_index, e.g. from volServer state updates.
+
+    Crossfeed mixes a low passed copy of each channel into the other, as
+    happens with speakers, which makes hard panned recordings less
+    tiring on headphones. It uses the bs2b filters: a first order low pass
+    on the crossfed signal and a matching high boost on the direct signal,
+    with feed being the difference in low frequency level between them.
+
+        Default     700Hz, 4.5dB.
+        C.Moy       700Hz, 6.0dB.
+        J.Meier     650Hz, 9.5dB.
+
+    Processing is in float. Q28 samples are converted at the edges of the
+    stage.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define CONTOUR_INCS_MAX        255 // Max volume increments (sound.incs).
+
+#define CONTOUR_BASS_FREQ     100.0 // Low shelf corner (Hz).
+#define CONTOUR_BASS_SLOPE      0.3 // Bass gain per dB attenuation.
+#define CONTOUR_BASS_MAX       12.0 // Max bass gain (dB).
+#define CONTOUR_TREBLE_FREQ 10000.0 // High shelf corner (Hz).
+#define CONTOUR_TREBLE_SLOPE    0.1 // Treble gain per dB attenuation.
+#define CONTOUR_TREBLE_MAX      4.0 // Max treble gain (dB).
+#define CONTOUR_THRESHOLD      10.0 // Attenuation before any gain (dB).
+
+#define CROSSFEED_FREQ_MIN      300 // Crossfeed low pass limits (Hz).
+#define CROSSFEED_FREQ_MAX     2000
+#define CROSSFEED_FEED_MIN      1.0 // Crossfeed level limits (dB).
+#define CROSSFEED_FEED_MAX     15.0
+
+//  Types. --------------------------------------------------------------------
+
+struct contour_profile_t
+{
+    float bass_freq;    // Low shelf corner (Hz).
+    float bass_slope;   // Bass gain per dB attenuation.
+    float bass_max;     // Max bass gain (dB).
+    float treble_freq;  // High shelf corner (Hz).
+    float treble_slope; // Treble gain per dB attenuation.
+    float treble_max;   // Max treble gain (dB).
+    float threshold;    // Attenuation before any gain (dB).
+    bool  headroom;     // Take largest gain off all frequencies.
+};
+
+// Coefficients b0, b1, b2, a1, a2 for low and high shelf.
+struct contour_set_t
+{
+    float c[2][5];
+};
+
+struct crossfeed_t
+{
+    bool  enabled;
+    float a0_lo, b1_lo;         // Low pass for crossfed signal.
+    float a0_hi, a1_hi, b1_hi;  // High boost for direct signal.
+    float gain;                 // Overall gain to keep level.
+    float lo[2], hi[2], in[2];  // Filter state.
+};
+
+struct contour_t
+{
+    struct stream_format_t  format;
+    struct contour_set_t   *table;      // Sets for index 0 to incs.
+    uint8_t                 incs;
+
+    volatile unsigned char  own;        // Index set by contour_set_index.
+    volatile unsigned char *index;      // Index read by audio thread.
+    uint8_t                 last;       // Index of target set.
+
+    float                   c[2][5];    // Current coefficients.
+    float                   step[2][5]; // Change per frame while ramping.
+    uint16_t                ramp;       // Frames left in ramp.
+    float                   z[2][2][STREAM_CHANNELS_MAX];
+
+    struct crossfeed_t      crossfeed;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Sets profile to defaults.
+//  ---------------------------------------------------------------------------
+void contour_profile( struct contour_profile_t *profile );
+
+//  ---------------------------------------------------------------------------
+//  Calculates attenuation of each volume index for an alsaPi profile.
+//  ---------------------------------------------------------------------------
+/*
+    atten holds incs + 1 values (dB, positive). factor is sound.factor and
+    range is the dB range of the mixer between sound.min and sound.max,
+    assuming mixer steps are evenly spaced in dB, as most hardware mixers
+    are (see snd_mixer_selem_get_playback_dB_range).
+*/
+void contour_atten( float *atten, uint8_t incs, float factor, float range );
+
+//  ---------------------------------------------------------------------------
+//  Calculates coefficient sets for every volume index.
+//  ---------------------------------------------------------------------------
+/*
+    atten holds incs + 1 attenuations from contour_atten. Starts at index
+    incs (no compensation) until linked or set.
+    Returns 0 on success, -1 for invalid arguments, -2 if out of memory.
+*/
+int8_t contour_init( struct contour_t *contour,
+                     struct stream_format_t *format,
+                     struct contour_profile_t *profile,
+                     const float *atten, uint8_t incs );
+
+//  ---------------------------------------------------------------------------
+//  Reads volume index from a variable, e.g. &sound.index.
+//  ---------------------------------------------------------------------------
+void contour_link( struct contour_t *contour,
+                   volatile unsigned char *index );
+
+//  ---------------------------------------------------------------------------
+//  Sets volume index.
+//  ---------------------------------------------------------------------------
+void contour_set_index( struct contour_t *contour, uint8_t index );
+
+//  ---------------------------------------------------------------------------
+//  Sets crossfeed. A feed of 0 turns crossfeed off.
+//  ---------------------------------------------------------------------------
+/*
+    Call before the stage is added to a stream. Only for stereo streams.
+    Returns 0 on success, -1 for invalid arguments.
+*/
+int8_t contour_crossfeed( struct contour_t *contour, uint16_t freq,
+                          float feed );
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void contour_process( void *data, sample_t *samples, uint16_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Frees coefficient sets.
+//  ---------------------------------------------------------------------------
+void contour_free( void *data );
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for loudness and crossfeed.
+//  ---------------------------------------------------------------------------
+void contour_stage( struct contour_t *contour, struct stream_stage_t *stage );
+
+#endif // #ifndef CONTOURPI_H
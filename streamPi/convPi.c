@@ -0,0 +1,594 @@
+//  ===========================================================================
+/*
+    convPi:
+
+    FIR convolution stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic convPi.c streamPi.c -lm
+        gcc -shared -o libconvPi.so convPi.o streamPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "convPi.h"
+
+//  Filter files. -------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns little endian value of len bytes.
+//  ---------------------------------------------------------------------------
+static uint32_t conv_le( const uint8_t *bytes, uint8_t len )
+{
+    uint32_t value = 0;
+
+    while ( len-- ) value = ( value << 8 ) | bytes[len];
+
+    return value;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads taps from a raw float file.
+//  ---------------------------------------------------------------------------
+static int8_t conv_read_raw( struct conv_filter_t *filter, FILE *fp )
+{
+    long size;
+
+    fseek( fp, 0, SEEK_END );
+    size = ftell( fp );
+    fseek( fp, 0, SEEK_SET );
+
+    if (( size < ( long )sizeof( float )) ||
+        ( size / sizeof( float ) > CONV_TAPS_MAX )) return -1;
+
+    filter->length = size / sizeof( float );
+    filter->taps   = malloc( filter->length * sizeof( float ));
+    if ( filter->taps == NULL ) return -2;
+
+    if ( fread( filter->taps, sizeof( float ), filter->length, fp ) !=
+         filter->length ) return -1;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads taps for one channel from a WAV file.
+//  ---------------------------------------------------------------------------
+static int8_t conv_read_wav( struct conv_filter_t *filter, FILE *fp,
+                             uint8_t channel )
+{
+    uint8_t  header[40];
+    uint8_t *data;
+    uint32_t size;
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    uint16_t bytes;
+    uint32_t i;
+    int32_t  value;
+    float    f;
+
+    // Find format and data chunks.
+    fseek( fp, 12, SEEK_SET );
+    while ( 1 )
+    {
+        if ( fread( header, 1, 8, fp ) != 8 ) return -1;
+        size = conv_le( header + 4, 4 );
+
+        if ( memcmp( header, "fmt ", 4 ) == 0 )
+        {
+            if (( size < 16 ) || ( size > sizeof( header ))) return -1;
+            if ( fread( header, 1, size, fp ) != size ) return -1;
+            format   = conv_le( header, 2 );
+            channels = conv_le( header + 2, 2 );
+            filter->rate = conv_le( header + 4, 4 );
+            bits     = conv_le( header + 14, 2 );
+
+            // WAVE_FORMAT_EXTENSIBLE holds format in sub format GUID.
+            if (( format == 0xfffe ) && ( size >= 26 ))
+                format = conv_le( header + 24, 2 );
+        }
+        else if ( memcmp( header, "data", 4 ) == 0 ) break;
+        else fseek( fp, size + ( size & 1 ), SEEK_CUR );
+    }
+
+    if (( channels == 0 ) ||
+        !((( format == 1 ) && (( bits == 16 ) || ( bits == 24 ) ||
+                               ( bits == 32 ))) ||
+          (( format == 3 ) && ( bits == 32 )))) return -1;
+    if ( channels == 1 ) channel = 0;
+    if ( channel >= channels ) return -1;
+
+    bytes = bits / 8;
+    filter->length = size / ( bytes * channels );
+    if (( filter->length == 0 ) || ( filter->length > CONV_TAPS_MAX ))
+        return -1;
+
+    data = malloc( size );
+    filter->taps = malloc( filter->length * sizeof( float ));
+    if (( data == NULL ) || ( filter->taps == NULL ))
+    {
+        free( data );
+        return -2;
+    }
+    if ( fread( data, 1, size, fp ) != size )
+    {
+        free( data );
+        return -1;
+    }
+
+    for ( i = 0; i < filter->length; i++ )
+    {
+        uint8_t *sample = data + ( i * channels + channel ) * bytes;
+
+        value = conv_le( sample, bytes ) << ( 32 - bits );
+        if ( format == 3 )
+        {
+            memcpy( &f, &value, sizeof( float ));
+            filter->taps[i] = f;
+        }
+        else filter->taps[i] = value / 2147483648.0f;
+    }
+
+    free( data );
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads a filter from a WAV or raw float file.
+//  ---------------------------------------------------------------------------
+int8_t conv_read( struct conv_filter_t *filter, const char *file,
+                  uint8_t channel )
+{
+    FILE   *fp;
+    uint8_t header[12];
+    int8_t  ret;
+
+    memset( filter, 0, sizeof( struct conv_filter_t ));
+
+    fp = fopen( file, "rb" );
+    if ( fp == NULL )
+    {
+        printf( "Couldn't open %s.\n", file );
+        return -1;
+    }
+
+    if (( fread( header, 1, 12, fp ) == 12 ) &&
+        ( memcmp( header, "RIFF", 4 ) == 0 ) &&
+        ( memcmp( header + 8, "WAVE", 4 ) == 0 ))
+        ret = conv_read_wav( filter, fp, channel );
+    else
+        ret = conv_read_raw( filter, fp );
+
+    fclose( fp );
+    if ( ret < 0 )
+    {
+        printf( "%s: unsupported or invalid filter.\n", file );
+        conv_filter_free( filter );
+    }
+
+    return ret;
+}
+
+//  ---------------------------------------------------------------------------
+//  Frees filter taps.
+//  ---------------------------------------------------------------------------
+void conv_filter_free( struct conv_filter_t *filter )
+{
+    free( filter->taps );
+    filter->taps   = NULL;
+    filter->length = 0;
+}
+
+//  FFT. ----------------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Complex FFT of size B on bit reversed data in conv->re, conv->im.
+//  ---------------------------------------------------------------------------
+/*
+    Twiddle j / len of the size B transform is entry 2 * j * ( B / len ) of
+    the size 2B tables. Inverse transforms are not scaled.
+*/
+static void conv_fft( struct conv_t *conv, bool inverse )
+{
+    uint16_t size = conv->size;
+    float   *re = conv->re;
+    float   *im = conv->im;
+    uint16_t i, j, k, len, step;
+    float    tr, ti, wr, wi;
+
+    for ( len = 2; len <= size; len <<= 1 )
+    {
+        step = 2 * ( size / len );
+        for ( i = 0; i < size; i += len )
+        {
+            for ( j = 0; j < len / 2; j++ )
+            {
+                wr = conv->cos[j * step];
+                wi = inverse ? conv->sin[j * step] : -conv->sin[j * step];
+                k  = i + j + len / 2;
+                tr = re[k] * wr - im[k] * wi;
+                ti = re[k] * wi + im[k] * wr;
+                re[k] = re[i + j] - tr;
+                im[k] = im[i + j] - ti;
+                re[i + j] += tr;
+                im[i + j] += ti;
+            }
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Transforms 2B real samples into B + 1 bins.
+//  ---------------------------------------------------------------------------
+/*
+    Even samples go in the real parts and odd samples in the imaginary
+    parts of a size B transform Z. Bin k is E(k) + W^k O(k), where
+    E(k) = ( Z(k) + conj Z(B - k)) / 2 and O(k) = ( Z(k) - conj Z(B - k)) / 2i
+    are the spectra of the even and odd samples.
+*/
+static void conv_forward( struct conv_t *conv, const float *x,
+                          float *xre, float *xim )
+{
+    uint16_t size = conv->size;
+    uint16_t n, k;
+    float    zr, zi, cr, ci, er, ei, odr, odi, c, s;
+
+    for ( n = 0; n < size; n++ )
+    {
+        conv->re[conv->reverse[n]] = x[2 * n];
+        conv->im[conv->reverse[n]] = x[2 * n + 1];
+    }
+    conv_fft( conv, false );
+
+    for ( k = 0; k <= size; k++ )
+    {
+        zr =  conv->re[k & ( size - 1 )];
+        zi =  conv->im[k & ( size - 1 )];
+        cr =  conv->re[( size - k ) & ( size - 1 )];
+        ci = -conv->im[( size - k ) & ( size - 1 )];
+        er = 0.5f * ( zr + cr );
+        ei = 0.5f * ( zi + ci );
+        odr = 0.5f * ( zi - ci );
+        odi = 0.5f * ( cr - zr );
+        c  = conv->cos[k];
+        s  = conv->sin[k];
+        xre[k] = er + c * odr + s * odi;
+        xim[k] = ei + c * odi - s * odr;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Transforms B + 1 bins into the last B of 2B real samples.
+//  ---------------------------------------------------------------------------
+/*
+    Reverses conv_forward: E(k) = ( Y(k) + conj Y(B - k)) / 2 and
+    O(k) = ( Y(k) - conj Y(B - k)) W^-k / 2, then Z(k) = E(k) + i O(k).
+    Output is scaled by B.
+*/
+static void conv_inverse( struct conv_t *conv, const float *yre,
+                          const float *yim, float *y )
+{
+    uint16_t size = conv->size;
+    uint16_t n, k;
+    float    er, ei, gr, gi, odr, odi, c, s;
+
+    for ( k = 0; k < size; k++ )
+    {
+        er = 0.5f * ( yre[k] + yre[size - k] );
+        ei = 0.5f * ( yim[k] - yim[size - k] );
+        gr = 0.5f * ( yre[k] - yre[size - k] );
+        gi = 0.5f * ( yim[k] + yim[size - k] );
+        c  = conv->cos[k];
+        s  = conv->sin[k];
+        odr = gr * c - gi * s;
+        odi = gr * s + gi * c;
+        conv->re[conv->reverse[k]] = er - odi;
+        conv->im[conv->reverse[k]] = ei + odr;
+    }
+    conv_fft( conv, true );
+
+    for ( n = size / 2; n < size; n++ )
+    {
+        y[2 * n - size]     = conv->re[n];
+        y[2 * n - size + 1] = conv->im[n];
+    }
+}
+
+//  Convolution stage. --------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns largest partition size with latency within budget.
+//  ---------------------------------------------------------------------------
+uint16_t conv_partition( uint32_t rate, float latency )
+{
+    uint32_t size = CONV_PARTITION_MIN;
+
+    while (( size * 2 <= CONV_PARTITION_MAX ) &&
+           ( size * 2 * 1000.0f / rate <= latency )) size *= 2;
+
+    return size;
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises convolution with one filter per channel.
+//  ---------------------------------------------------------------------------
+int8_t conv_init( struct conv_t *conv, struct stream_format_t *format,
+                  uint16_t size, struct conv_filter_t *filter )
+{
+    uint32_t length = 0;
+    uint32_t start;
+    uint16_t i, j, bits, p;
+    uint8_t  ch;
+    float   *x;
+    bool     fail;
+
+    if (( size < CONV_PARTITION_MIN ) || ( size > CONV_PARTITION_MAX ) ||
+        ( size & ( size - 1 ))) return -1;
+
+    for ( ch = 0; ch < format->channels; ch++ )
+    {
+        if (( filter[ch].length == 0 ) || ( filter[ch].taps == NULL ) ||
+            (( filter[ch].rate != 0 ) &&
+             ( filter[ch].rate != format->rate ))) return -1;
+        if ( filter[ch].length > length ) length = filter[ch].length;
+    }
+
+    memset( conv, 0, sizeof( struct conv_t ));
+    conv->format = *format;
+    conv->size   = size;
+    conv->parts  = ( length + size - 1 ) / size;
+    conv->bins   = size + 1;
+
+    conv->cos     = malloc(( size + 1 ) * sizeof( float ));
+    conv->sin     = malloc(( size + 1 ) * sizeof( float ));
+    conv->reverse = malloc( size * sizeof( uint16_t ));
+    conv->re      = malloc( size * sizeof( float ));
+    conv->im      = malloc( size * sizeof( float ));
+    conv->yre     = malloc( conv->bins * sizeof( float ));
+    conv->yim     = malloc( conv->bins * sizeof( float ));
+    x             = malloc( 2 * size * sizeof( float ));
+    fail = ( conv->cos == NULL ) || ( conv->sin == NULL ) ||
+           ( conv->reverse == NULL ) || ( conv->re == NULL ) ||
+           ( conv->im == NULL ) || ( conv->yre == NULL ) ||
+           ( conv->yim == NULL ) || ( x == NULL );
+
+    for ( ch = 0; ch < format->channels; ch++ )
+    {
+        size_t spectra = ( size_t )conv->parts * conv->bins * sizeof( float );
+
+        conv->input[ch]  = calloc( 2 * size, sizeof( float ));
+        conv->output[ch] = calloc( size, sizeof( float ));
+        conv->hre[ch]    = malloc( spectra );
+        conv->him[ch]    = malloc( spectra );
+        conv->xre[ch]    = calloc( 1, spectra );
+        conv->xim[ch]    = calloc( 1, spectra );
+        fail |= ( conv->input[ch] == NULL ) || ( conv->output[ch] == NULL ) ||
+                ( conv->hre[ch] == NULL ) || ( conv->him[ch] == NULL ) ||
+                ( conv->xre[ch] == NULL ) || ( conv->xim[ch] == NULL );
+    }
+
+    if ( fail )
+    {
+        free( x );
+        conv_free( conv );
+        return -2;
+    }
+
+    for ( i = 0; i <= size; i++ )
+    {
+        conv->cos[i] = cos( M_PI * i / size );
+        conv->sin[i] = sin( M_PI * i / size );
+    }
+
+    for ( bits = 0; ( 1 << bits ) < size; bits++ );
+    for ( i = 0; i < size; i++ )
+    {
+        conv->reverse[i] = 0;
+        for ( j = 0; j < bits; j++ )
+            if ( i & ( 1 << j )) conv->reverse[i] |= 1 << ( bits - 1 - j );
+    }
+
+    // Transform each partition, zero padded to 2B and scaled by 1 / B to
+    // cancel the unscaled inverse transform.
+    for ( ch = 0; ch < format->channels; ch++ )
+    {
+        for ( p = 0; p < conv->parts; p++ )
+        {
+            memset( x, 0, 2 * size * sizeof( float ));
+            start = ( uint32_t )p * size;
+            for ( i = 0; ( i < size ) && ( start + i < filter[ch].length );
+                  i++ )
+                x[i] = filter[ch].taps[start + i] / size;
+
+            conv_forward( conv, x, conv->hre[ch] + p * conv->bins,
+                                   conv->him[ch] + p * conv->bins );
+        }
+    }
+
+    free( x );
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns latency in frames.
+//  ---------------------------------------------------------------------------
+uint16_t conv_latency( struct conv_t *conv )
+{
+    return conv->size;
+}
+
+//  ---------------------------------------------------------------------------
+//  Convolves the completed block of each channel.
+//  ---------------------------------------------------------------------------
+static void conv_block( struct conv_t *conv )
+{
+    uint16_t size = conv->size;
+    uint16_t bins = conv->bins;
+    uint16_t p, k, slot;
+    uint8_t  ch;
+
+    conv->slot = ( conv->slot + 1 ) % conv->parts;
+
+    for ( ch = 0; ch < conv->format.channels; ch++ )
+    {
+        float *yre = conv->yre;
+        float *yim = conv->yim;
+
+        conv_forward( conv, conv->input[ch],
+                      conv->xre[ch] + conv->slot * bins,
+                      conv->xim[ch] + conv->slot * bins );
+
+        // Multiply and accumulate the FDL against the filter spectra.
+        memset( yre, 0, bins * sizeof( float ));
+        memset( yim, 0, bins * sizeof( float ));
+        for ( p = 0, slot = conv->slot; p < conv->parts; p++ )
+        {
+            const float *xr = conv->xre[ch] + slot * bins;
+            const float *xi = conv->xim[ch] + slot * bins;
+            const float *hr = conv->hre[ch] + p * bins;
+            const float *hi = conv->him[ch] + p * bins;
+
+            for ( k = 0; k < bins; k++ )
+            {
+                yre[k] += xr[k] * hr[k] - xi[k] * hi[k];
+                yim[k] += xr[k] * hi[k] + xi[k] * hr[k];
+            }
+            slot = ( slot == 0 ) ? conv->parts - 1 : slot - 1;
+        }
+
+        conv_inverse( conv, yre, yim, conv->output[ch] );
+
+        // Newest block becomes the overlap for the next.
+        memcpy( conv->input[ch], conv->input[ch] + size,
+                size * sizeof( float ));
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+/*
+    Each input sample is stored in the current block and replaced by the
+    output sample at the same position from the previous block.
+*/
+void conv_process( void *data, sample_t *samples, uint16_t frames )
+{
+    struct conv_t *conv = data;
+    const uint8_t  channels = conv->format.channels;
+    uint16_t       count, f;
+    uint8_t        ch;
+
+    while ( frames > 0 )
+    {
+        count = conv->size - conv->fill;
+        if ( count > frames ) count = frames;
+
+        for ( ch = 0; ch < channels; ch++ )
+        {
+            float *in  = conv->input[ch] + conv->size + conv->fill;
+            float *out = conv->output[ch] + conv->fill;
+
+            for ( f = 0; f < count; f++ )
+            {
+                in[f] = STREAM_TO_FLOAT( samples[f * channels + ch] );
+                samples[f * channels + ch] = STREAM_FROM_FLOAT( out[f] );
+            }
+        }
+
+        samples    += count * channels;
+        frames     -= count;
+        conv->fill += count;
+
+        if ( conv->fill == conv->size )
+        {
+            conv_block( conv );
+            conv->fill = 0;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Frees buffers.
+//  ---------------------------------------------------------------------------
+void conv_free( void *data )
+{
+    struct conv_t *conv = data;
+    uint8_t ch;
+
+    free( conv->cos );
+    free( conv->sin );
+    free( conv->reverse );
+    free( conv->re );
+    free( conv->im );
+    free( conv->yre );
+    free( conv->yim );
+
+    for ( ch = 0; ch < STREAM_CHANNELS_MAX; ch++ )
+    {
+        free( conv->input[ch] );
+        free( conv->output[ch] );
+        free( conv->hre[ch] );
+        free( conv->him[ch] );
+        free( conv->xre[ch] );
+        free( conv->xim[ch] );
+    }
+
+    memset( conv, 0, sizeof( struct conv_t ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for convolution.
+//  ---------------------------------------------------------------------------
+void conv_stage( struct conv_t *conv, struct stream_stage_t *stage )
+{
+    stage->name    = "conv";
+    stage->data    = conv;
+    stage->process = conv_process;
+    stage->free    = conv_free;
+}
@@ -0,0 +1,176 @@
+//  ===========================================================================
+/*
+    convPi:
+
+    FIR convolution stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef CONVPI_H
+#define CONVPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    Runs long FIR filters, such as room correction filters from REW or DRC
+    with 8k to 64k taps, using uniformly partitioned overlap-save
+    convolution.
+
+    Each filter is cut into P partitions of B taps, and each partition is
+    transformed once at start up into a spectrum of B + 1 bins using a
+    real FFT of size 2B. Every B frames the last 2B input samples are
+    transformed and the spectrum is stored in a frequency domain delay line
+    (FDL) holding the last P input spectra. The output spectrum is
+
+        Y = X[0] H[0] + X[1] H[1] + ... + X[P - 1] H[P - 1]
+
+    where X[p] is the input spectrum from p blocks ago, and the last B
+    samples of its inverse transform are the next B output samples.
+
+    The cost per frame is roughly 2 FFTs of size 2B spread over B frames,
+    plus P complex multiplies per bin, so larger partitions use less CPU
+    but add latency. Latency is always B frames, and conv_partition picks
+    the largest B that fits a latency budget.
+
+    All work for a block is done in the process call that completes it, so
+    B should not be larger than the stream period or the load will be
+    uneven between periods.
+
+    FFT tables, spectra, the FDL and work buffers are allocated by
+    conv_init, so nothing is allocated while processing. Processing is
+    always in float; Q28 samples are converted at the edges of the stage.
+
+    Filters are read from WAV files (16, 24 or 32 bit PCM, or 32 bit float,
+    mono or one channel per stream channel) or from raw files of 32 bit
+    float taps.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define CONV_PARTITION_MIN    32 // Smallest partition (frames).
+#define CONV_PARTITION_MAX  8192 // Largest partition (frames).
+#define CONV_TAPS_MAX    1048576 // Longest filter.
+
+//  Types. --------------------------------------------------------------------
+
+struct conv_filter_t
+{
+    float    *taps;     // Impulse response.
+    uint32_t  length;   // Number of taps.
+    uint32_t  rate;     // Sample rate from file, 0 if unknown.
+};
+
+struct conv_t
+{
+    struct stream_format_t format;
+    uint16_t  size;             // Partition size B (frames).
+    uint16_t  parts;            // Partitions P.
+    uint16_t  bins;             // Bins per spectrum, B + 1.
+    uint16_t  fill;             // Frames collected in current block.
+    uint16_t  slot;             // FDL slot of newest input spectrum.
+
+    // Real FFT of size 2B as a complex FFT of size B.
+    float    *cos;              // cos( pi k / B ), k = 0 to B.
+    float    *sin;              // sin( pi k / B ), k = 0 to B.
+    uint16_t *reverse;          // Bit reversed indices for size B.
+
+    // Per channel buffers.
+    float    *input[STREAM_CHANNELS_MAX];   // Last 2B input samples.
+    float    *output[STREAM_CHANNELS_MAX];  // B output samples.
+    float    *hre[STREAM_CHANNELS_MAX];     // Filter spectra [P][bins].
+    float    *him[STREAM_CHANNELS_MAX];
+    float    *xre[STREAM_CHANNELS_MAX];     // FDL [P][bins].
+    float    *xim[STREAM_CHANNELS_MAX];
+
+    // Work buffers.
+    float    *re;               // FFT (B).
+    float    *im;
+    float    *yre;              // Output spectrum (bins).
+    float    *yim;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Reads a filter from a WAV or raw float file.
+//  ---------------------------------------------------------------------------
+/*
+    channel selects the channel of a multichannel WAV file. Mono files are
+    used for any channel. Files not starting with a RIFF header are read
+    as raw 32 bit float taps in host byte order.
+    Returns 0 on success, -1 for an unreadable or unsupported file, -2 if
+    out of memory.
+*/
+int8_t conv_read( struct conv_filter_t *filter, const char *file,
+                  uint8_t channel );
+
+//  ---------------------------------------------------------------------------
+//  Frees filter taps.
+//  ---------------------------------------------------------------------------
+void conv_filter_free( struct conv_filter_t *filter );
+
+//  ---------------------------------------------------------------------------
+//  Returns largest partition size with latency within budget.
+//  ---------------------------------------------------------------------------
+/*
+    latency is in ms. Returns CONV_PARTITION_MIN if the budget is too small.
+*/
+uint16_t conv_partition( uint32_t rate, float latency );
+
+//  ---------------------------------------------------------------------------
+//  Initialises convolution with one filter per channel.
+//  ---------------------------------------------------------------------------
+/*
+    filter holds format->channels filters. size is the partition size, a
+    power of 2 between CONV_PARTITION_MIN and CONV_PARTITION_MAX.
+    Returns 0 on success, -1 for invalid arguments or a filter with a
+    different sample rate, -2 if out of memory.
+*/
+int8_t conv_init( struct conv_t *conv, struct stream_format_t *format,
+                  uint16_t size, struct conv_filter_t *filter );
+
+//  ---------------------------------------------------------------------------
+//  Returns latency in frames.
+//  ---------------------------------------------------------------------------
+uint16_t conv_latency( struct conv_t *conv );
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void conv_process( void *data, sample_t *samples, uint16_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Frees buffers.
+//  ---------------------------------------------------------------------------
+void conv_free( void *data );
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for convolution.
+//  ---------------------------------------------------------------------------
+void conv_stage( struct conv_t *conv, struct stream_stage_t *stage );
+
+#endif // #ifndef CONVPI_H
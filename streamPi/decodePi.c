@@ -0,0 +1,355 @@
+//  ===========================================================================
+/*
+    decodePi:
+
+    Memory mapped audio file decoders for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic decodePi.c
+        gcc -shared -o libdecodePi.so decodePi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "decodePi.h"
+
+//  W64 GUIDs after the four character code.
+static const uint8_t w64_guid[12] =
+    { 0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1, 0x00, 0xc0,
+      0x4f, 0x8e, 0xdb, 0x8a };
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Reads little endian fields.
+//  ---------------------------------------------------------------------------
+static uint16_t decode_get16( const uint8_t *p )
+{
+    return p[0] | ( p[1] << 8 );
+}
+
+static uint32_t decode_get32( const uint8_t *p )
+{
+    return p[0] | ( p[1] << 8 ) | ( p[2] << 16 ) | (( uint32_t )p[3] << 24 );
+}
+
+static uint64_t decode_get64( const uint8_t *p )
+{
+    return decode_get32( p ) | (( uint64_t )decode_get32( p + 4 ) << 32 );
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads a WAVE format chunk, shared by WAV and W64.
+//  ---------------------------------------------------------------------------
+/*
+    Takes PCM, IEEE float and WAVE_FORMAT_EXTENSIBLE of either.
+*/
+static int8_t decode_fmt( struct decode_t *decode, const uint8_t *p,
+                          uint64_t size )
+{
+    uint16_t tag, bits;
+
+    if ( size < 16 ) return -1;
+    tag  = decode_get16( p );
+    bits = decode_get16( p + 14 );
+    if (( tag == 0xfffe ) && ( size >= 26 )) tag = decode_get16( p + 24 );
+
+    decode->channels = decode_get16( p + 2 );
+    decode->rate     = decode_get32( p + 4 );
+    decode->bytes    = ( bits + 7 ) / 8;
+    decode->fp       = ( tag == 3 );
+
+    if ((( tag != 1 ) && ( tag != 3 )) || ( decode->channels == 0 ) ||
+        ( decode->channels > STREAM_CHANNELS_MAX ) || ( decode->rate == 0 ) ||
+        ( decode->bytes == 0 ) || ( decode->bytes > 4 ) ||
+        ( decode->fp && ( decode->bytes != 4 ))) return -1;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads a WAV header.
+//  ---------------------------------------------------------------------------
+static int8_t decode_open_wav( struct decode_t *decode )
+{
+    const uint8_t *p   = decode->map + 12;
+    const uint8_t *end = decode->map + decode->size;
+    uint32_t size;
+    bool     fmt = false;
+
+    if (( decode->size < 12 ) || memcmp( decode->map, "RIFF", 4 ) ||
+        memcmp( decode->map + 8, "WAVE", 4 )) return -1;
+
+    // Chunks are padded to an even size.
+    while ( end - p >= 8 )
+    {
+        size = decode_get32( p + 4 );
+        if ( memcmp( p, "fmt ", 4 ) == 0 )
+        {
+            if (( size > end - p - 8 ) ||
+                ( decode_fmt( decode, p + 8, size ) < 0 )) return -1;
+            fmt = true;
+        }
+        else if ( memcmp( p, "data", 4 ) == 0 )
+        {
+            if ( !fmt ) return -1;
+            decode->pos = p + 8;
+            decode->end = ( size > end - p - 8 ) ? end : p + 8 + size;
+            return 0;
+        }
+        if ( size > end - p - 8 ) break;
+        p += 8 + size + ( size & 1 );
+    }
+
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads a W64 header.
+//  ---------------------------------------------------------------------------
+/*
+    As WAV, but chunk ids are GUIDs and sizes are 64 bit, include the 24
+    byte chunk header and are padded to 8 bytes.
+*/
+static int8_t decode_open_w64( struct decode_t *decode )
+{
+    const uint8_t *p   = decode->map + 40;
+    const uint8_t *end = decode->map + decode->size;
+    uint64_t size;
+    bool     fmt = false;
+
+    if (( decode->size < 40 ) || memcmp( decode->map, "riff", 4 ) ||
+        memcmp( decode->map + 24, "wave", 4 ) ||
+        memcmp( decode->map + 28, w64_guid, 12 )) return -1;
+
+    while ( end - p >= 24 )
+    {
+        size = decode_get64( p + 16 );
+        if (( size < 24 ) || ( memcmp( p + 4, w64_guid, 12 ) != 0 ))
+            return -1;
+        if ( memcmp( p, "fmt ", 4 ) == 0 )
+        {
+            if (( size > ( uint64_t )( end - p )) ||
+                ( decode_fmt( decode, p + 24, size - 24 ) < 0 )) return -1;
+            fmt = true;
+        }
+        else if ( memcmp( p, "data", 4 ) == 0 )
+        {
+            if ( !fmt ) return -1;
+            decode->pos = p + 24;
+            decode->end = ( size > ( uint64_t )( end - p ) ) ? end : p + size;
+            return 0;
+        }
+        if ( size > ( uint64_t )( end - p )) break;
+        p += ( size + 7 ) & ~7ull;
+    }
+
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets up raw S16 PCM, the rate and channels having been given.
+//  ---------------------------------------------------------------------------
+static int8_t decode_open_raw( struct decode_t *decode )
+{
+    decode->bytes = 2;
+    decode->fp    = false;
+    decode->pos   = decode->map;
+    decode->end   = decode->map + decode->size;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Decodes little endian PCM to float.
+//  ---------------------------------------------------------------------------
+/*
+    Integer samples are shifted to the top of 32 bits and scaled, so every
+    width shares one conversion.
+*/
+static uint32_t decode_read_pcm( struct decode_t *decode, float *out,
+                                 uint32_t frames )
+{
+    const uint8_t  bytes = decode->bytes;
+    const uint32_t frame = bytes * decode->channels;
+    const uint8_t *p     = decode->pos;
+    uint32_t count, i;
+    uint32_t v;
+    float    f;
+
+    count = ( decode->end - p ) / frame;
+    if ( count > frames ) count = frames;
+
+    if ( decode->fp )
+        for ( i = 0; i < count * decode->channels; i++, p += 4 )
+        {
+            v = decode_get32( p );
+            memcpy( &f, &v, 4 );
+            out[i] = f;
+        }
+    else if ( bytes == 2 )
+        for ( i = 0; i < count * decode->channels; i++, p += 2 )
+            out[i] = ( int16_t )decode_get16( p ) * ( 1.0f / 32768 );
+    else
+        for ( i = 0; i < count * decode->channels; i++, p += bytes )
+        {
+            // 8 bit WAV is unsigned.
+            if ( bytes == 1 ) v = ( uint32_t )( p[0] ^ 0x80 ) << 24;
+            else if ( bytes == 3 ) v = ( uint32_t )( p[0] << 8 |
+                                       p[1] << 16 | p[2] << 24 );
+            else v = decode_get32( p );
+            out[i] = ( int32_t )v * ( 1.0f / 2147483648.0f );
+        }
+
+    decode->pos = p;
+
+    return count;
+}
+
+static const struct decode_format_t formats[] =
+{
+    { "WAV", ".wav", decode_open_wav, decode_read_pcm },
+    { "W64", ".w64", decode_open_w64, decode_read_pcm },
+    { "raw", ".raw", decode_open_raw, decode_read_pcm },
+    { "raw", ".pcm", decode_open_raw, decode_read_pcm }
+};
+#define FORMATS ( sizeof( formats ) / sizeof( formats[0] ))
+
+//  ---------------------------------------------------------------------------
+//  Returns format for an extension, NULL if none.
+//  ---------------------------------------------------------------------------
+static const struct decode_format_t *decode_format( const char *name )
+{
+    const char *ext = strrchr( name, '.' );
+    uint8_t i;
+
+    if ( ext == NULL ) return NULL;
+    for ( i = 0; i < FORMATS; i++ )
+        if ( strcasecmp( ext, formats[i].ext ) == 0 ) return &formats[i];
+
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns true if a file has an extension a decoder knows.
+//  ---------------------------------------------------------------------------
+bool decode_known( const char *name )
+{
+    return ( decode_format( name ) != NULL );
+}
+
+//  ---------------------------------------------------------------------------
+//  Opens a file for decoding.
+//  ---------------------------------------------------------------------------
+int8_t decode_open( struct decode_t *decode, const char *name,
+                    uint32_t rate, uint8_t channels )
+{
+    struct stat st;
+    uint8_t i;
+
+    memset( decode, 0, sizeof( struct decode_t ));
+    decode->rate     = rate;
+    decode->channels = channels;
+    if (( rate == 0 ) || ( channels == 0 ) ||
+        ( channels > STREAM_CHANNELS_MAX )) return -1;
+
+    decode->fd = open( name, O_RDONLY );
+    if ( decode->fd < 0 ) return -1;
+    if (( fstat( decode->fd, &st ) < 0 ) || ( st.st_size == 0 ) ||
+        (( uint64_t )st.st_size > SIZE_MAX ))
+    {
+        close( decode->fd );
+        return -1;
+    }
+    decode->size = st.st_size;
+    decode->map  = mmap( NULL, decode->size, PROT_READ, MAP_PRIVATE,
+                         decode->fd, 0 );
+    if ( decode->map == MAP_FAILED )
+    {
+        close( decode->fd );
+        return -1;
+    }
+    madvise(( void * )decode->map, decode->size, MADV_SEQUENTIAL );
+
+    // Extension first, then any format with a header that fits.
+    decode->format = decode_format( name );
+    if (( decode->format != NULL ) && ( decode->format->open( decode ) == 0 ))
+        return 0;
+    for ( i = 0; i < FORMATS; i++ )
+    {
+        if (( formats[i].open == decode_open_raw ) ||
+            ( &formats[i] == decode->format )) continue;
+        decode->format = &formats[i];
+        if ( formats[i].open( decode ) == 0 ) return 0;
+    }
+
+    decode_close( decode );
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Decodes up to frames of interleaved float, returns frames decoded.
+//  ---------------------------------------------------------------------------
+uint32_t decode_read( struct decode_t *decode, float *out, uint32_t frames )
+{
+    return decode->format->read( decode, out, frames );
+}
+
+//  ---------------------------------------------------------------------------
+//  Unmaps file and drops it from the page cache.
+//  ---------------------------------------------------------------------------
+void decode_close( struct decode_t *decode )
+{
+    munmap(( void * )decode->map, decode->size );
+    posix_fadvise( decode->fd, 0, 0, POSIX_FADV_DONTNEED );
+    close( decode->fd );
+}
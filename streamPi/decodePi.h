@@ -0,0 +1,117 @@
+//  ===========================================================================
+/*
+    decodePi:
+
+    Memory mapped audio file decoders for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef DECODEPI_H
+#define DECODEPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    Files are mapped into memory whole, read by the kernel ahead of the
+    decoder and dropped from the page cache when closed, so a library scan
+    doesn't push everything else out of RAM. On 32 bit systems this limits
+    files to about 1GB each while several threads are scanning.
+
+    Each format is a decode_format_t with an extension, a function to read
+    the header and a function to decode frames to float. Formats are tried
+    by extension first, then by asking each to read the header. WAV, W64
+    and raw PCM share one PCM decoder, taking 8 to 32 bit integer or 32
+    bit float samples. Compressed formats would add their own decoder and
+    keep state in decode_t.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define DECODE_RAW_RATE     44100   // Default for raw files.
+#define DECODE_RAW_CHANNELS 2
+
+//  Types. --------------------------------------------------------------------
+
+struct decode_t;
+
+struct decode_format_t
+{
+    const char *name;
+    const char *ext;                // Extension with '.', NULL for none.
+
+    // Reads header, returns 0 if the file is this format.
+    int8_t ( *open )( struct decode_t *decode );
+
+    // Decodes up to frames of interleaved float, returns frames decoded.
+    uint32_t ( *read )( struct decode_t *decode, float *out,
+                        uint32_t frames );
+};
+
+struct decode_t
+{
+    const struct decode_format_t *format;
+    int      fd;
+    const uint8_t *map;             // Whole file.
+    size_t   size;
+
+    const uint8_t *pos;             // Next frame.
+    const uint8_t *end;             // End of audio.
+    uint32_t rate;
+    uint8_t  channels;
+    uint8_t  bytes;                 // Bytes per sample.
+    bool     fp;                    // Float samples.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Opens a file for decoding.
+//  ---------------------------------------------------------------------------
+/*
+    rate and channels are used for raw files, which have no header.
+    Returns 0 on success, -1 for a file that can't be read or an unknown
+    format.
+*/
+int8_t decode_open( struct decode_t *decode, const char *name,
+                    uint32_t rate, uint8_t channels );
+
+//  ---------------------------------------------------------------------------
+//  Returns true if a file has an extension a decoder knows.
+//  ---------------------------------------------------------------------------
+bool decode_known( const char *name );
+
+//  ---------------------------------------------------------------------------
+//  Decodes up to frames of interleaved float, returns frames decoded.
+//  ---------------------------------------------------------------------------
+uint32_t decode_read( struct decode_t *decode, float *out, uint32_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Unmaps file and drops it from the page cache.
+//  ---------------------------------------------------------------------------
+void decode_close( struct decode_t *decode );
+
+#endif // #ifndef DECODEPI_H
@@ -0,0 +1,236 @@
+//  ===========================================================================
+/*
+    ditherPi:
+
+    Dither and noise shaping requantiser stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Psychoacoustically optimal noise shaping, R.A.Wannamaker, JAES 1992.
+        Minimally audible noise shaping, S.P.Lipshitz et al, JAES 1991.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic ditherPi.c streamPi.c -lm
+        gcc -shared -o libditherPi.so ditherPi.o streamPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "ditherPi.h"
+
+#define DITHER_MASK ( DITHER_TAPS_MAX - 1 )
+
+//  Noise shaping filters. ----------------------------------------------------
+
+static const struct
+{
+    const char *name;
+    uint8_t     taps;
+    float       h[DITHER_TAPS_MAX];
+} shapes[] =
+{
+    [DITHER_FLAT]        = { "flat", 0, { 0 }},
+    [DITHER_SIMPLE]      = { "simple", 1, { 1.0 }},
+    [DITHER_WANNAMAKER3] = { "wannamaker3", 3, { 1.623, -0.982, 0.109 }},
+    [DITHER_LIPSHITZ5]   = { "lipshitz5", 5,
+                             { 2.033, -2.165, 1.959, -1.590, 0.6149 }},
+    [DITHER_WANNAMAKER9] = { "wannamaker9", 9,
+                             { 2.412, -3.370, 3.937, -4.174, 3.353,
+                               -2.205, 1.281, -0.569, 0.0847 }}
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises requantiser.
+//  ---------------------------------------------------------------------------
+int8_t dither_init( struct dither_t *dither, struct stream_format_t *format,
+                    uint8_t bits, enum dither_shape_t shape, uint32_t seed )
+{
+    uint8_t ch;
+
+    if ((( bits != 16 ) && ( bits != 24 )) ||
+        ( shape > DITHER_WANNAMAKER9 )) return -1;
+
+    memset( dither, 0, sizeof( struct dither_t ));
+    dither->format = *format;
+    dither->bits   = bits;
+    dither->scale  = 1 << ( bits - 1 );
+    dither->min    = -dither->scale;
+    dither->max    = dither->scale - 1;
+    dither->taps   = shapes[shape].taps;
+    memcpy( dither->h, shapes[shape].h, sizeof( dither->h ));
+
+    // xorshift32 states must not be 0.
+    if ( seed == 0 ) seed = time( NULL ) ^ ( uintptr_t )dither;
+    for ( ch = 0; ch < STREAM_CHANNELS_MAX; ch++ )
+    {
+        dither->rng[ch] = seed * 2654435761u + ch * 40503u;
+        if ( dither->rng[ch] == 0 ) dither->rng[ch] = 1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns name of a noise shaping filter.
+//  ---------------------------------------------------------------------------
+const char *dither_name( enum dither_shape_t shape )
+{
+    return ( shape > DITHER_WANNAMAKER9 ) ? "?" : shapes[shape].name;
+}
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+/*
+    For each sample:
+
+        y = x - h[0] e[n-1] - h[1] e[n-2] ...
+        q = round( y + tpdf )
+        e[n] = q - y
+
+    so the output is x plus rounding noise shaped by 1 - H(z).
+
+    x is first split exactly into a whole number of LSBs and a fraction,
+    and y, q and e are worked out on the fraction only. Floats then keep
+    the dither and error to well below an LSB at any level, where at 24
+    bits x itself has no bits to spare below the LSB on loud material.
+*/
+void dither_process( void *data, sample_t *samples, uint16_t frames )
+{
+    struct dither_t *dither = data;
+    const uint8_t    channels = dither->format.channels;
+#ifdef STREAM_FIXED
+    const uint8_t    shift = STREAM_Q + 1 - dither->bits;
+    const float      lsb = 1.0f / ( 1 << shift );
+#else
+    const float      scale = dither->scale;
+    const float      inv = 1 / scale;
+    float            x;
+#endif
+    float            n[STREAM_CHANNELS_MAX];
+    float            y[STREAM_CHANNELS_MAX];
+    float            q[STREAM_CHANNELS_MAX];
+    float           *e;
+    uint32_t         r;
+    uint16_t         f;
+    uint8_t          k, ch;
+
+    for ( f = 0; f < frames; f++, samples += channels )
+    {
+        // Whole LSBs and fraction, both exact.
+        for ( ch = 0; ch < channels; ch++ )
+        {
+#ifdef STREAM_FIXED
+            n[ch] = samples[ch] >> shift;
+            y[ch] = ( samples[ch] & (( 1 << shift ) - 1 )) * lsb;
+#else
+            x     = samples[ch] * scale;
+            n[ch] = floorf( x );
+            y[ch] = x - n[ch];
+#endif
+        }
+
+        // Noise shaping from past errors.
+        for ( k = 0; k < dither->taps; k++ )
+        {
+            e = dither->error[( dither->pos - k ) & DITHER_MASK];
+            for ( ch = 0; ch < channels; ch++ )
+                y[ch] -= dither->h[k] * e[ch];
+        }
+
+        // TPDF from two 16 bit uniform values, then round.
+        dither->pos = ( dither->pos + 1 ) & DITHER_MASK;
+        e = dither->error[dither->pos];
+        for ( ch = 0; ch < channels; ch++ )
+        {
+            r = dither->rng[ch];
+            r ^= r << 13;
+            r ^= r >> 17;
+            r ^= r << 5;
+            dither->rng[ch] = r;
+
+            q[ch] = floorf( y[ch] + 0.5f +
+                            (( float )( r >> 16 ) + ( r & 0xffff ) - 65535 ) *
+                            ( 1.0f / 65536 ));
+            e[ch] = q[ch] - y[ch];
+            q[ch] += n[ch];
+        }
+
+        for ( ch = 0; ch < channels; ch++ )
+        {
+            if ( q[ch] > dither->max )
+            {
+                q[ch] = dither->max;
+                dither->clipped++;
+            }
+            else if ( q[ch] < dither->min )
+            {
+                q[ch] = dither->min;
+                dither->clipped++;
+            }
+#ifdef STREAM_FIXED
+            samples[ch] = ( int32_t )q[ch] * ( 1 << shift );
+#else
+            samples[ch] = q[ch] * inv;
+#endif
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for the requantiser.
+//  ---------------------------------------------------------------------------
+void dither_stage( struct dither_t *dither, struct stream_stage_t *stage )
+{
+    stage->name    = "dither";
+    stage->data    = dither;
+    stage->process = dither_process;
+    stage->free    = NULL;
+}
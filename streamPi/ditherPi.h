@@ -0,0 +1,137 @@
+//  ===========================================================================
+/*
+    ditherPi:
+
+    Dither and noise shaping requantiser stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Psychoacoustically optimal noise shaping, R.A.Wannamaker, JAES 1992.
+        Minimally audible noise shaping, S.P.Lipshitz et al, JAES 1991.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef DITHERPI_H
+#define DITHERPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    After gain, EQ or limiting, samples have more resolution than the DAC.
+    Rounding them to 16 or 24 bits leaves an error that follows the signal,
+    which is heard as distortion on quiet passages, i.e. at the low volumes
+    that alsaPi profiles refine.
+
+    This stage is the last in a stream. It rounds every sample to the
+    output word length in place, so stream_to_s16 or stream_to_s24 then
+    convert exactly. Before rounding it adds TPDF dither, the sum of two
+    uniform random values of +/- 0.5 LSB, which makes the error a constant
+    noise floor unrelated to the signal.
+
+    Noise shaping feeds the filtered rounding error back into the next
+    samples, moving noise from the midrange, where hearing is most
+    sensitive, to high frequencies:
+
+        DITHER_FLAT         TPDF only.
+        DITHER_SIMPLE       First order high pass, any sample rate.
+        DITHER_WANNAMAKER3  3 tap F-weighted, for 44.1kHz.
+        DITHER_LIPSHITZ5    5 tap E-weighted, for 44.1kHz.
+        DITHER_WANNAMAKER9  9 tap F-weighted, for 44.1kHz.
+
+    The weighted filters are designed for 44.1kHz. At 48kHz they are close
+    enough. At higher rates use DITHER_SIMPLE, or DITHER_FLAT for 24 bits,
+    where the noise is well below the DAC's own.
+
+    Random numbers come from a xorshift32 generator for each channel, held
+    in dither_t, so each stream thread has its own generators with no
+    locking. Each call gives two 16 bit uniform values. Channels are
+    processed side by side in each frame, with generator, filter and error
+    state held as [tap][channel], so the compiler can vectorise the
+    channel loops.
+
+    Processing is in float, on the fraction of an LSB left after taking
+    out the whole LSBs of each sample, so 24 bit output is as clean as 16
+    bit. Q28 samples are split with shifts and masks.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define DITHER_TAPS_MAX 16 // Max noise shaping taps, power of 2.
+
+//  Types. --------------------------------------------------------------------
+
+enum dither_shape_t
+{
+    DITHER_FLAT,
+    DITHER_SIMPLE,
+    DITHER_WANNAMAKER3,
+    DITHER_LIPSHITZ5,
+    DITHER_WANNAMAKER9
+};
+
+struct dither_t
+{
+    struct stream_format_t format;
+    uint8_t  bits;                      // Output word length, 16 or 24.
+    float    scale;                     // Full scale in LSBs.
+    float    min, max;                  // Output limits in LSBs.
+    uint8_t  taps;                      // Noise shaping taps.
+    float    h[DITHER_TAPS_MAX];        // Noise shaping filter.
+    float    error[DITHER_TAPS_MAX][STREAM_CHANNELS_MAX];  // Past errors.
+    uint8_t  pos;                       // Newest error.
+    uint32_t rng[STREAM_CHANNELS_MAX];  // xorshift32 states.
+    uint32_t clipped;                   // Samples clipped.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises requantiser.
+//  ---------------------------------------------------------------------------
+/*
+    bits is the output word length, 16 or 24. seed starts the random number
+    generators, 0 for a seed from the clock.
+    Returns 0 on success, -1 for invalid arguments.
+*/
+int8_t dither_init( struct dither_t *dither, struct stream_format_t *format,
+                    uint8_t bits, enum dither_shape_t shape, uint32_t seed );
+
+//  ---------------------------------------------------------------------------
+//  Returns name of a noise shaping filter.
+//  ---------------------------------------------------------------------------
+const char *dither_name( enum dither_shape_t shape );
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void dither_process( void *data, sample_t *samples, uint16_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for the requantiser.
+//  ---------------------------------------------------------------------------
+void dither_stage( struct dither_t *dither, struct stream_stage_t *stage );
+
+#endif // #ifndef DITHERPI_H
@@ -0,0 +1,532 @@
+//  ===========================================================================
+/*
+    eqPi:
+
+    Parametric EQ and room correction stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Audio EQ cookbook by Robert Bristow-Johnson.
+        - see http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic eqPi.c streamPi.c -lm
+        gcc -shared -o libeqPi.so eqPi.o streamPi.o
+
+    Add -DSTREAM_FIXED for Q28 fixed point samples.
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "eqPi.h"
+
+//  Configuration. ------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns filter type for a REW / Equalizer APO name, or -1.
+//  ---------------------------------------------------------------------------
+static int8_t eq_type( const char *name )
+{
+    static const struct { const char *name; enum eq_type_t type; } types[] =
+    {
+        { "PK",  EQ_PEAK },       { "PEQ", EQ_PEAK },
+        { "LS",  EQ_LOW_SHELF },  { "LSC", EQ_LOW_SHELF },
+        { "HS",  EQ_HIGH_SHELF }, { "HSC", EQ_HIGH_SHELF },
+        { "LP",  EQ_LOW_PASS },   { "LPQ", EQ_LOW_PASS },
+        { "HP",  EQ_HIGH_PASS },  { "HPQ", EQ_HIGH_PASS }
+    };
+    uint8_t i;
+
+    for ( i = 0; i < sizeof( types ) / sizeof( types[0] ); i++ )
+        if ( strcasecmp( name, types[i].name ) == 0 ) return types[i].type;
+
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Parses one line of a configuration.
+//  ---------------------------------------------------------------------------
+int8_t eq_parse( struct eq_config_t *config, const char *line,
+                 uint8_t *channels )
+{
+    char   buffer[256];
+    char  *token;
+    char  *save;
+    char  *end;
+    struct eq_filter_t filter;
+    int8_t type;
+    long   channel;
+
+    strncpy( buffer, line, sizeof( buffer ) - 1 );
+    buffer[sizeof( buffer ) - 1] = '\0';
+    if (( end = strchr( buffer, '#' )) != NULL ) *end = '\0';
+
+    token = strtok_r( buffer, " \t\r\n", &save );
+    if ( token == NULL ) return 0;  // Blank line.
+
+    // Preamp: <gain> dB
+    if ( strcasecmp( token, "Preamp:" ) == 0 )
+    {
+        token = strtok_r( NULL, " \t\r\n", &save );
+        if ( token == NULL ) return -1;
+        config->preamp = strtof( token, &end );
+        return ( end == token ) ? -1 : 0;
+    }
+
+    // Channel: L | R | all | <n> ...
+    if ( strcasecmp( token, "Channel:" ) == 0 )
+    {
+        *channels = 0;
+        while (( token = strtok_r( NULL, " \t\r\n", &save )) != NULL )
+        {
+            if ( strcasecmp( token, "all" ) == 0 ) *channels = 0xff;
+            else if ( strcasecmp( token, "L" ) == 0 ) *channels |= 0x01;
+            else if ( strcasecmp( token, "R" ) == 0 ) *channels |= 0x02;
+            else
+            {
+                channel = strtol( token, &end, 10 );
+                if (( end == token ) || ( channel < 1 ) ||
+                    ( channel > STREAM_CHANNELS_MAX )) return -1;
+                *channels |= 1 << ( channel - 1 );
+            }
+        }
+        return ( *channels == 0 ) ? -1 : 0;
+    }
+
+    // Filter [n]: ON|OFF <type> Fc <f> Hz [Gain <g> dB] [Q <q>]
+    if ( strncasecmp( token, "Filter", 6 ) != 0 ) return -1;
+    if ( token[strlen( token ) - 1] != ':' )
+    {
+        token = strtok_r( NULL, " \t\r\n", &save );  // Filter number.
+        if (( token == NULL ) || ( token[strlen( token ) - 1] != ':' ))
+            return -1;
+    }
+
+    token = strtok_r( NULL, " \t\r\n", &save );
+    if ( token == NULL ) return -1;
+    if ( strcasecmp( token, "OFF" ) == 0 ) return 0;
+    if ( strcasecmp( token, "ON" ) != 0 ) return -1;
+
+    token = strtok_r( NULL, " \t\r\n", &save );
+    if (( token == NULL ) || (( type = eq_type( token )) < 0 )) return -1;
+
+    filter.type     = type;
+    filter.freq     = 0;
+    filter.gain     = 0;
+    filter.q        = EQ_Q_DEFAULT;
+    filter.channels = *channels;
+
+    while (( token = strtok_r( NULL, " \t\r\n", &save )) != NULL )
+    {
+        float *value = NULL;
+
+        if ( strcasecmp( token, "Fc" ) == 0 ) value = &filter.freq;
+        else if ( strcasecmp( token, "Gain" ) == 0 ) value = &filter.gain;
+        else if ( strcasecmp( token, "Q" ) == 0 ) value = &filter.q;
+        else continue;  // Units.
+
+        token = strtok_r( NULL, " \t\r\n", &save );
+        if ( token == NULL ) return -1;
+        *value = strtof( token, &end );
+        if ( end == token ) return -1;
+    }
+
+    if (( filter.freq <= 0 ) || ( filter.q <= 0 )) return -1;
+    if ( config->filters >= EQ_FILTERS_MAX ) return -1;
+    config->filter[config->filters++] = filter;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Reads filters from a configuration file.
+//  ---------------------------------------------------------------------------
+int8_t eq_read( struct eq_config_t *config, const char *file )
+{
+    FILE    *fp;
+    char     line[256];
+    uint8_t  channels = 0xff;
+    uint16_t number = 0;
+
+    memset( config, 0, sizeof( struct eq_config_t ));
+
+    fp = fopen( file, "r" );
+    if ( fp == NULL )
+    {
+        printf( "Couldn't open %s.\n", file );
+        return -1;
+    }
+
+    while ( fgets( line, sizeof( line ), fp ) != NULL )
+    {
+        number++;
+        if ( eq_parse( config, line, &channels ) < 0 )
+        {
+            printf( "%s: invalid line %u.\n", file, number );
+            fclose( fp );
+            return -1;
+        }
+    }
+
+    fclose( fp );
+    return 0;
+}
+
+//  Coefficients. -------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Calculates normalised biquad coefficients b0, b1, b2, a1, a2.
+//  ---------------------------------------------------------------------------
+void eq_design( struct eq_filter_t *filter, uint32_t rate,
+                double gain, double *c )
+{
+    double A     = pow( 10.0, filter->gain / 40.0 );
+    double w0    = 2.0 * M_PI * filter->freq / rate;
+    double cosw  = cos( w0 );
+    double alpha = sin( w0 ) / ( 2.0 * filter->q );
+    double root  = 2.0 * sqrt( A ) * alpha;
+    double b0, b1, b2, a0, a1, a2;
+
+    switch ( filter->type )
+    {
+        case EQ_PEAK:
+            b0 = 1 + alpha * A;
+            b1 = -2 * cosw;
+            b2 = 1 - alpha * A;
+            a0 = 1 + alpha / A;
+            a1 = -2 * cosw;
+            a2 = 1 - alpha / A;
+            break;
+        case EQ_LOW_SHELF:
+            b0 = A * (( A + 1 ) - ( A - 1 ) * cosw + root );
+            b1 = 2 * A * (( A - 1 ) - ( A + 1 ) * cosw );
+            b2 = A * (( A + 1 ) - ( A - 1 ) * cosw - root );
+            a0 = ( A + 1 ) + ( A - 1 ) * cosw + root;
+            a1 = -2 * (( A - 1 ) + ( A + 1 ) * cosw );
+            a2 = ( A + 1 ) + ( A - 1 ) * cosw - root;
+            break;
+        case EQ_HIGH_SHELF:
+            b0 = A * (( A + 1 ) + ( A - 1 ) * cosw + root );
+            b1 = -2 * A * (( A - 1 ) + ( A + 1 ) * cosw );
+            b2 = A * (( A + 1 ) + ( A - 1 ) * cosw - root );
+            a0 = ( A + 1 ) - ( A - 1 ) * cosw + root;
+            a1 = 2 * (( A - 1 ) - ( A + 1 ) * cosw );
+            a2 = ( A + 1 ) - ( A - 1 ) * cosw - root;
+            break;
+        case EQ_LOW_PASS:
+            b0 = ( 1 - cosw ) / 2;
+            b1 = 1 - cosw;
+            b2 = ( 1 - cosw ) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cosw;
+            a2 = 1 - alpha;
+            break;
+        default:
+            b0 = ( 1 + cosw ) / 2;
+            b1 = -( 1 + cosw );
+            b2 = ( 1 + cosw ) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cosw;
+            a2 = 1 - alpha;
+            break;
+    }
+
+    c[0] = gain * b0 / a0;
+    c[1] = gain * b1 / a0;
+    c[2] = gain * b2 / a0;
+    c[3] = a1 / a0;
+    c[4] = a2 / a0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets biquad of coefficient set to pass through.
+//  ---------------------------------------------------------------------------
+static void eq_unity( struct eq_coefs_t *coefs, uint8_t biquad )
+{
+    uint8_t k, ch;
+
+    for ( k = 0; k < 5; k++ )
+        for ( ch = 0; ch < STREAM_CHANNELS_MAX; ch++ )
+            coefs->c[biquad][k][ch] = ( k == 0 ) ? STREAM_ONE : 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Calculates coefficient set for configuration.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 for invalid filters or too many biquads.
+*/
+static int8_t eq_coefs( struct eq_coefs_t *coefs,
+                        struct stream_format_t *format,
+                        struct eq_config_t *config )
+{
+    uint8_t count[STREAM_CHANNELS_MAX] = { 0 };
+    double  gain = pow( 10.0, config->preamp / 20.0 );
+    double  c[5];
+    uint8_t i, k, ch, biquad;
+
+    // Check filters and count biquads for each channel.
+    coefs->biquads = 0;
+    for ( i = 0; i < config->filters; i++ )
+    {
+        struct eq_filter_t *filter = &config->filter[i];
+
+        if (( filter->freq <= 0 ) || ( filter->freq >= format->rate / 2 ) ||
+            ( filter->q <= 0 )) return -1;
+
+        for ( ch = 0; ch < format->channels; ch++ )
+            if ( filter->channels & ( 1 << ch ))
+                if ( ++count[ch] > coefs->biquads ) coefs->biquads = count[ch];
+    }
+    if ( coefs->biquads > EQ_BIQUADS_MAX ) return -1;
+
+    // Preamp only needs a biquad to carry the gain.
+    if (( coefs->biquads == 0 ) && ( config->preamp != 0 ))
+        coefs->biquads = 1;
+
+    for ( biquad = 0; biquad < EQ_BIQUADS_MAX; biquad++ )
+        eq_unity( coefs, biquad );
+
+    // Fill biquads in order for each channel.
+    memset( count, 0, sizeof( count ));
+    for ( i = 0; i < config->filters; i++ )
+    {
+        for ( ch = 0; ch < format->channels; ch++ )
+        {
+            if ( !( config->filter[i].channels & ( 1 << ch ))) continue;
+
+            biquad = count[ch]++;
+            eq_design( &config->filter[i], format->rate,
+                       ( biquad == 0 ) ? gain : 1.0, c );
+            for ( k = 0; k < 5; k++ )
+                coefs->c[biquad][k][ch] = STREAM_FROM_FLOAT( c[k] );
+        }
+    }
+
+    // Channels without filters still need the preamp.
+    for ( ch = 0; ch < format->channels; ch++ )
+        if (( count[ch] == 0 ) && ( coefs->biquads > 0 ))
+            coefs->c[0][0][ch] = STREAM_FROM_FLOAT( gain );
+
+    return 0;
+}
+
+//  EQ stage. -----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises EQ with filters.
+//  ---------------------------------------------------------------------------
+int8_t eq_init( struct eq_t *eq, struct stream_format_t *format,
+                struct eq_config_t *config )
+{
+    memset( eq, 0, sizeof( struct eq_t ));
+    eq->format = *format;
+
+    if ( eq_coefs( &eq->current, format, config ) < 0 ) return -1;
+    eq->target = eq->current;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets new filters while the stream is running.
+//  ---------------------------------------------------------------------------
+int8_t eq_set( struct eq_t *eq, struct eq_config_t *config )
+{
+    struct eq_coefs_t *update = &eq->update[eq->next];
+    uint16_t wait;
+
+    // Wait for audio thread to pick up previous update.
+    for ( wait = 0; __atomic_load_n( &eq->pending, __ATOMIC_ACQUIRE ); wait++ )
+    {
+        if ( wait >= EQ_SET_TIMEOUT ) return -1;
+        usleep( 1000 );
+    }
+
+    if ( eq_coefs( update, &eq->format, config ) < 0 ) return -1;
+
+    __atomic_store_n( &eq->pending, update, __ATOMIC_RELEASE );
+    eq->next ^= 1;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Starts ramp to pending coefficients.
+//  ---------------------------------------------------------------------------
+static void eq_start_ramp( struct eq_t *eq, struct eq_coefs_t *pending )
+{
+    uint16_t period = eq->format.period;
+    uint8_t  biquads, i, k, ch;
+
+    eq->target = *pending;
+
+    // Biquads being added start from pass through, with clear state.
+    biquads = eq->target.biquads;
+    if ( eq->current.biquads > biquads ) biquads = eq->current.biquads;
+    for ( i = eq->current.biquads; i < biquads; i++ )
+    {
+        eq_unity( &eq->current, i );
+        memset( eq->z[i], 0, sizeof( eq->z[i] ));
+    }
+    eq->current.biquads = biquads;
+
+    for ( i = 0; i < biquads; i++ )
+        for ( k = 0; k < 5; k++ )
+            for ( ch = 0; ch < eq->format.channels; ch++ )
+                eq->step[i][k][ch] = ( eq->target.c[i][k][ch] -
+                                       eq->current.c[i][k][ch] ) / period;
+
+    eq->ramp = period;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs one biquad over frames, optionally ramping coefficients.
+//  ---------------------------------------------------------------------------
+static inline void eq_run( struct eq_t *eq, uint8_t i, sample_t *samples,
+                           uint16_t frames, bool ramp )
+{
+    const uint8_t channels = eq->format.channels;
+    sample_t (*c)[STREAM_CHANNELS_MAX] = eq->current.c[i];
+    sample_t (*d)[STREAM_CHANNELS_MAX] = eq->step[i];
+    uint16_t f;
+    uint8_t  k, ch;
+
+#ifdef STREAM_FIXED
+    int32_t *x1 = eq->z[i][0], *x2 = eq->z[i][1];
+    int32_t *y1 = eq->z[i][2], *y2 = eq->z[i][3];
+
+    for ( f = 0; f < frames; f++, samples += channels )
+    {
+        if ( ramp )
+            for ( k = 0; k < 5; k++ )
+                for ( ch = 0; ch < channels; ch++ )
+                    c[k][ch] += d[k][ch];
+
+        for ( ch = 0; ch < channels; ch++ )
+        {
+            int64_t acc = ( int64_t )c[0][ch] * samples[ch] +
+                          ( int64_t )c[1][ch] * x1[ch] +
+                          ( int64_t )c[2][ch] * x2[ch] -
+                          ( int64_t )c[3][ch] * y1[ch] -
+                          ( int64_t )c[4][ch] * y2[ch];
+            int32_t out = acc >> STREAM_Q;
+
+            x2[ch] = x1[ch];
+            x1[ch] = samples[ch];
+            y2[ch] = y1[ch];
+            y1[ch] = out;
+            samples[ch] = out;
+        }
+    }
+#else
+    float *z1 = eq->z[i][0], *z2 = eq->z[i][1];
+
+    for ( f = 0; f < frames; f++, samples += channels )
+    {
+        if ( ramp )
+            for ( k = 0; k < 5; k++ )
+                for ( ch = 0; ch < channels; ch++ )
+                    c[k][ch] += d[k][ch];
+
+        for ( ch = 0; ch < channels; ch++ )
+        {
+            float in  = samples[ch];
+            float out = c[0][ch] * in + z1[ch];
+
+            z1[ch] = c[1][ch] * in - c[3][ch] * out + z2[ch];
+            z2[ch] = c[2][ch] * in - c[4][ch] * out;
+            samples[ch] = out;
+        }
+    }
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void eq_process( void *data, sample_t *samples, uint16_t frames )
+{
+    struct eq_t       *eq = data;
+    struct eq_coefs_t *pending;
+    uint16_t           count;
+    uint8_t            i;
+
+    pending = __atomic_exchange_n( &eq->pending, NULL, __ATOMIC_ACQ_REL );
+    if ( pending != NULL ) eq_start_ramp( eq, pending );
+
+    // Ramp over first frames of period.
+    if ( eq->ramp > 0 )
+    {
+        count = ( frames < eq->ramp ) ? frames : eq->ramp;
+        for ( i = 0; i < eq->current.biquads; i++ )
+            eq_run( eq, i, samples, count, true );
+
+        samples += count * eq->format.channels;
+        frames  -= count;
+        eq->ramp -= count;
+
+        // Finish exactly on target and drop unused biquads.
+        if ( eq->ramp == 0 ) eq->current = eq->target;
+    }
+
+    for ( i = 0; i < eq->current.biquads; i++ )
+        eq_run( eq, i, samples, frames, false );
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for EQ.
+//  ---------------------------------------------------------------------------
+void eq_stage( struct eq_t *eq, struct stream_stage_t *stage )
+{
+    stage->name    = "eq";
+    stage->data    = eq;
+    stage->process = eq_process;
+    stage->free    = NULL;
+}
@@ -0,0 +1,204 @@
+//  ===========================================================================
+/*
+    eqPi:
+
+    Parametric EQ and room correction stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Audio EQ cookbook by Robert Bristow-Johnson.
+        - see http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef EQPI_H
+#define EQPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    A cascade of biquad filters for each channel, replacing a separate ALSA
+    plugin chain for room correction.
+
+    Filters are read from a text file in the format exported by REW and
+    used by Equalizer APO, so room correction filters can be used directly:
+
+        # Comment.
+        Preamp: -6.5 dB
+        Channel: L
+        Filter 1: ON PK Fc 63.5 Hz Gain -7.0 dB Q 4.32
+        Filter 2: ON LSC Fc 105 Hz Gain 3.0 dB Q 0.71
+        Channel: all
+        Filter: ON HP Fc 20 Hz
+        Filter: OFF HS Fc 8000 Hz Gain 2.0 dB
+
+    Filter types:
+
+        PK, PEQ         Peaking.            Fc, Gain, Q.
+        LS, LSC         Low shelf.          Fc, Gain, Q (default 0.707).
+        HS, HSC         High shelf.         Fc, Gain, Q (default 0.707).
+        LP, LPQ         Low pass.           Fc, Q (default 0.707).
+        HP, HPQ         High pass.          Fc, Q (default 0.707).
+
+    Channel: takes L, R, numbers 1 to STREAM_CHANNELS_MAX or all, and
+    applies to the following filters. Preamp: is applied to all channels.
+
+    Every channel runs the same number of biquads so that the inner loop
+    runs across channels, with unused biquads set to pass through. State is
+    held as [biquad][channel]. Float processing uses transposed direct
+    form II. Q28 processing (STREAM_FIXED) uses direct form I with a 64 bit
+    accumulator. Preamp gain is folded into the first biquad.
+
+    New filters can be set while the stream is running. Coefficients are
+    calculated in the calling thread and handed to the audio thread, which
+    moves linearly from the old to the new coefficients over one period so
+    there are no clicks.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define EQ_BIQUADS_MAX   32 // Max biquads per channel.
+#define EQ_FILTERS_MAX  128 // Max filters in a configuration.
+#define EQ_Q_DEFAULT   0.707f
+#define EQ_SET_TIMEOUT  100 // Max wait for previous update (ms).
+
+//  Types. --------------------------------------------------------------------
+
+enum eq_type_t
+{
+    EQ_PEAK,
+    EQ_LOW_SHELF,
+    EQ_HIGH_SHELF,
+    EQ_LOW_PASS,
+    EQ_HIGH_PASS
+};
+
+struct eq_filter_t
+{
+    enum eq_type_t type;
+    float          freq;        // Centre or corner frequency (Hz).
+    float          gain;        // Gain (dB).
+    float          q;           // Q.
+    uint8_t        channels;    // Bit mask of channels.
+};
+
+struct eq_config_t
+{
+    float              preamp;  // Gain (dB).
+    struct eq_filter_t filter[EQ_FILTERS_MAX];
+    uint8_t            filters;
+};
+
+// Coefficients b0, b1, b2, a1, a2 for each biquad and channel.
+struct eq_coefs_t
+{
+    uint8_t  biquads;
+    sample_t c[EQ_BIQUADS_MAX][5][STREAM_CHANNELS_MAX];
+};
+
+struct eq_t
+{
+    struct stream_format_t format;
+
+    // Coefficients used by audio thread.
+    struct eq_coefs_t      current;
+    struct eq_coefs_t      target;
+    sample_t               step[EQ_BIQUADS_MAX][5][STREAM_CHANNELS_MAX];
+    uint16_t               ramp;        // Frames left in ramp.
+
+    // Coefficients handed over by eq_set.
+    struct eq_coefs_t      update[2];
+    uint8_t                next;        // Next update buffer to write.
+    struct eq_coefs_t     *pending;     // Waiting for audio thread.
+
+#ifdef STREAM_FIXED
+    int32_t                z[EQ_BIQUADS_MAX][4][STREAM_CHANNELS_MAX];
+#else
+    float                  z[EQ_BIQUADS_MAX][2][STREAM_CHANNELS_MAX];
+#endif
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Reads filters from a configuration file.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 if the file can't be read or has an invalid
+    line, which is reported with its line number.
+*/
+int8_t eq_read( struct eq_config_t *config, const char *file );
+
+//  ---------------------------------------------------------------------------
+//  Parses one line of a configuration.
+//  ---------------------------------------------------------------------------
+/*
+    channels holds the channel mask set by the last Channel: line.
+    Returns 0 on success, -1 for an invalid line.
+*/
+int8_t eq_parse( struct eq_config_t *config, const char *line,
+                 uint8_t *channels );
+
+//  ---------------------------------------------------------------------------
+//  Calculates normalised biquad coefficients b0, b1, b2, a1, a2.
+//  ---------------------------------------------------------------------------
+/*
+    gain is a linear gain folded into b0, b1 and b2. For other stages that
+    need to design filters.
+*/
+void eq_design( struct eq_filter_t *filter, uint32_t rate,
+                double gain, double *c );
+
+//  ---------------------------------------------------------------------------
+//  Initialises EQ with filters.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 for invalid filters or too many biquads.
+*/
+int8_t eq_init( struct eq_t *eq, struct stream_format_t *format,
+                struct eq_config_t *config );
+
+//  ---------------------------------------------------------------------------
+//  Sets new filters while the stream is running.
+//  ---------------------------------------------------------------------------
+/*
+    The change takes effect over the next period. Call from one thread
+    only. Returns 0 on success, -1 for invalid filters or if a previous
+    update hasn't been picked up within EQ_SET_TIMEOUT.
+*/
+int8_t eq_set( struct eq_t *eq, struct eq_config_t *config );
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void eq_process( void *data, sample_t *samples, uint16_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for EQ.
+//  ---------------------------------------------------------------------------
+void eq_stage( struct eq_t *eq, struct stream_stage_t *stage );
+
+#endif // #ifndef EQPI_H
@@ -0,0 +1,260 @@
+//  ===========================================================================
+/*
+    gainPi:
+
+    Compact index of ReplayGain 2.0 / EBU R128 values for playback.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic gainPi.c -lm
+        gcc -shared -o libgainPi.so gainPi.o
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "gainPi.h"
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Packs and unpacks little endian fields.
+//  ---------------------------------------------------------------------------
+static void gain_put16( uint8_t *p, uint16_t v )
+{
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void gain_put32( uint8_t *p, uint32_t v )
+{
+    gain_put16( p, v );
+    gain_put16( p + 2, v >> 16 );
+}
+
+static void gain_put64( uint8_t *p, uint64_t v )
+{
+    uint8_t i;
+
+    for ( i = 0; i < 8; i++, v >>= 8 ) p[i] = v;
+}
+
+static uint16_t gain_get16( const uint8_t *p )
+{
+    return p[0] | ( p[1] << 8 );
+}
+
+static uint32_t gain_get32( const uint8_t *p )
+{
+    return gain_get16( p ) | ( uint32_t )gain_get16( p + 2 ) << 16;
+}
+
+static uint64_t gain_get64( const uint8_t *p )
+{
+    uint64_t v = 0;
+    uint8_t  i;
+
+    for ( i = 8; i > 0; i-- ) v = ( v << 8 ) | p[i - 1];
+
+    return v;
+}
+
+//  ---------------------------------------------------------------------------
+//  Packs hundredths, clamped to 16 bits.
+//  ---------------------------------------------------------------------------
+static void gain_put( uint8_t *p, double v )
+{
+    v = round( v * 100 );
+    if ( !( v > -32768 )) v = -32768;
+    if ( v > 32767 ) v = 32767;
+    gain_put16( p, ( int16_t )v );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns key for a path.
+//  ---------------------------------------------------------------------------
+uint64_t gain_key( const char *path )
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    while ( *path ) hash = ( hash ^ ( uint8_t )*path++ ) * 0x100000001b3ull;
+
+    return hash;
+}
+
+//  ---------------------------------------------------------------------------
+//  Compares gains by key, for qsort.
+//  ---------------------------------------------------------------------------
+static int gain_compare( const void *a, const void *b )
+{
+    const uint64_t ka = (( const struct gain_t * )a )->key;
+    const uint64_t kb = (( const struct gain_t * )b )->key;
+
+    return ( ka > kb ) - ( ka < kb );
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes an index, replacing any old one.
+//  ---------------------------------------------------------------------------
+int8_t gain_write( const char *name, struct gain_t *gains,
+                   uint32_t count )
+{
+    uint8_t  entry[GAIN_ENTRY];
+    uint8_t  header[GAIN_HEADER] = GAIN_MAGIC;
+    char     temp[4096];
+    FILE    *fp;
+    uint32_t i;
+
+    if ( snprintf( temp, sizeof( temp ), "%s.new", name ) >=
+         ( int )sizeof( temp )) return -1;
+
+    qsort( gains, count, sizeof( struct gain_t ), gain_compare );
+
+    fp = fopen( temp, "wb" );
+    if ( fp == NULL ) return -1;
+
+    gain_put16( header + 4, GAIN_VERSION );
+    gain_put16( header + 6, GAIN_ENTRY );
+    gain_put32( header + 8, count );
+    fwrite( header, 1, GAIN_HEADER, fp );
+
+    for ( i = 0; i < count; i++ )
+    {
+        gain_put64( entry, gains[i].key );
+        gain_put( entry + 8, gains[i].track_gain );
+        gain_put( entry + 10, gains[i].track_peak );
+        gain_put( entry + 12, gains[i].album_gain );
+        gain_put( entry + 14, gains[i].album_peak );
+        gain_put( entry + 16, gains[i].loudness );
+        gain_put( entry + 18, gains[i].range );
+        fwrite( entry, 1, GAIN_ENTRY, fp );
+    }
+
+    if (( fflush( fp ) != 0 ) || ( fsync( fileno( fp )) < 0 ) ||
+        ferror( fp ))
+    {
+        fclose( fp );
+        unlink( temp );
+        return -1;
+    }
+    fclose( fp );
+
+    return ( rename( temp, name ) == 0 ) ? 0 : -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Maps an index for lookups.
+//  ---------------------------------------------------------------------------
+int8_t gain_open( struct gain_index_t *index, const char *name )
+{
+    struct stat st;
+    int fd;
+
+    memset( index, 0, sizeof( struct gain_index_t ));
+    fd = open( name, O_RDONLY );
+    if ( fd < 0 ) return -1;
+    if (( fstat( fd, &st ) < 0 ) || ( st.st_size < GAIN_HEADER ))
+    {
+        close( fd );
+        return -1;
+    }
+
+    index->size = st.st_size;
+    index->map  = mmap( NULL, index->size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( index->map == MAP_FAILED ) return -1;
+
+    index->entries = gain_get32( index->map + 8 );
+    if ( memcmp( index->map, GAIN_MAGIC, 4 ) ||
+         ( gain_get16( index->map + 4 ) != GAIN_VERSION ) ||
+         ( gain_get16( index->map + 6 ) != GAIN_ENTRY ) ||
+         ( GAIN_HEADER + ( uint64_t )index->entries * GAIN_ENTRY >
+           index->size ))
+    {
+        gain_close( index );
+        return -1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Looks up a path.
+//  ---------------------------------------------------------------------------
+int8_t gain_lookup( struct gain_index_t *index, const char *path,
+                    struct gain_t *gain )
+{
+    const uint64_t key = gain_key( path );
+    const uint8_t *entry;
+    uint64_t found;
+    uint32_t lo = 0, hi = index->entries, mid;
+
+    while ( lo < hi )
+    {
+        mid   = lo + ( hi - lo ) / 2;
+        entry = index->map + GAIN_HEADER + ( size_t )mid * GAIN_ENTRY;
+        found = gain_get64( entry );
+
+        if ( found < key ) lo = mid + 1;
+        else if ( found > key ) hi = mid;
+        else
+        {
+            gain->key        = key;
+            gain->track_gain = ( int16_t )gain_get16( entry + 8 ) / 100.0;
+            gain->track_peak = ( int16_t )gain_get16( entry + 10 ) / 100.0;
+            gain->album_gain = ( int16_t )gain_get16( entry + 12 ) / 100.0;
+            gain->album_peak = ( int16_t )gain_get16( entry + 14 ) / 100.0;
+            gain->loudness   = ( int16_t )gain_get16( entry + 16 ) / 100.0;
+            gain->range      = ( int16_t )gain_get16( entry + 18 ) / 100.0;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Unmaps an index.
+//  ---------------------------------------------------------------------------
+void gain_close( struct gain_index_t *index )
+{
+    if (( index->map != NULL ) && ( index->map != MAP_FAILED ))
+        munmap(( void * )index->map, index->size );
+    index->map = NULL;
+    index->entries = 0;
+}
@@ -0,0 +1,130 @@
+//  ===========================================================================
+/*
+    gainPi:
+
+    Compact index of ReplayGain 2.0 / EBU R128 values for playback.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef GAINPI_H
+#define GAINPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    The index is written by scanPi and read by players, e.g. to offset the
+    alsaPi volume by the track or album gain when a track starts.
+
+    File:
+
+        Header      "GPiX", version (16), entry size (16), entries (32),
+                    0 (32).
+
+        Entries     key (64), track gain (16), track peak (16), album
+                    gain (16), album peak (16), loudness (16), loudness
+                    range (16), sorted by key.
+
+    All fields are little endian. Gains, peaks and loudness are signed
+    hundredths of a dB, i.e. dB, dBFS and LUFS, and range is hundredths of
+    a LU. The key is a 64 bit FNV-1a hash of the full path, so entries are
+    20 bytes however long the path, and 10,000 tracks take 200kB.
+
+    gain_open maps the index and gain_lookup finds a path by binary search
+    in the mapped file, so nothing is read or parsed at start up and a
+    lookup touches a few pages at most.
+
+    gain_write writes a new index beside the old and renames it over, so a
+    player never sees half an index.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define GAIN_MAGIC      "GPiX"
+#define GAIN_VERSION    1
+#define GAIN_HEADER     16
+#define GAIN_ENTRY      20
+#define GAIN_INDEX      "/var/lib/gainPi.idx"   // Default index.
+
+//  Types. --------------------------------------------------------------------
+
+struct gain_t
+{
+    uint64_t key;
+    double   track_gain;            // dB.
+    double   track_peak;            // dBFS.
+    double   album_gain;
+    double   album_peak;
+    double   loudness;              // LUFS.
+    double   range;                 // LU.
+};
+
+struct gain_index_t
+{
+    const uint8_t *map;
+    size_t   size;
+    uint32_t entries;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns key for a path.
+//  ---------------------------------------------------------------------------
+uint64_t gain_key( const char *path );
+
+//  ---------------------------------------------------------------------------
+//  Writes an index, replacing any old one.
+//  ---------------------------------------------------------------------------
+/*
+    Sorts gains by key. Returns 0 on success, -1 for a file error.
+*/
+int8_t gain_write( const char *name, struct gain_t *gains,
+                   uint32_t count );
+
+//  ---------------------------------------------------------------------------
+//  Maps an index for lookups.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 if missing or not an index.
+*/
+int8_t gain_open( struct gain_index_t *index, const char *name );
+
+//  ---------------------------------------------------------------------------
+//  Looks up a path.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 and fills gain if found, -1 if not.
+*/
+int8_t gain_lookup( struct gain_index_t *index, const char *path,
+                    struct gain_t *gain );
+
+//  ---------------------------------------------------------------------------
+//  Unmaps an index.
+//  ---------------------------------------------------------------------------
+void gain_close( struct gain_index_t *index );
+
+#endif // #ifndef GAINPI_H
@@ -0,0 +1,239 @@
+//  ===========================================================================
+/*
+    latencyPi:
+
+    Round trip latency measurement with maximum length sequences.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Borish, J. and Angell, J. B., An Efficient Algorithm for Measuring
+        the Impulse Response Using Pseudorandom Noise, JAES 31(7), 1983.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic latencyPi.c -lm
+        gcc -shared -o liblatencyPi.so latencyPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "latencyPi.h"
+
+//  Feedback taps for maximum length, counted from 1 at the output.
+static const uint8_t taps[LATENCY_ORDER_MAX - LATENCY_ORDER_MIN + 1][4] =
+{
+    { 10, 7 },
+    { 11, 9 },
+    { 12, 6, 4, 1 },
+    { 13, 4, 3, 1 },
+    { 14, 5, 3, 1 },
+    { 15, 14 },
+    { 16, 15, 13, 4 },
+    { 17, 14 },
+    { 18, 11 }
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns the smallest order with a period longer than frames.
+//  ---------------------------------------------------------------------------
+uint8_t latency_order( uint32_t frames )
+{
+    uint8_t order;
+
+    for ( order = LATENCY_ORDER_MIN; order <= LATENCY_ORDER_MAX; order++ )
+        if ((( 1ul << order ) - 1 ) > frames ) return order;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Generates a sequence and correlation tables.
+//  ---------------------------------------------------------------------------
+/*
+    The register shifts towards bit 0, which is the output, and feeds back
+    into the top bit, so the output n + j is bit j of state n for j below
+    the order, and later outputs follow the same recurrence as the
+    register. Running that recurrence on bit masks instead of bits gives,
+    for every j, the mask of state bits whose parity is output n + j.
+*/
+int8_t latency_init( struct latency_t *latency, uint8_t order )
+{
+    const uint8_t *tap;
+    uint32_t mask = 0, state = 1, length, n;
+    uint32_t *ahead;
+    uint8_t  i;
+
+    memset( latency, 0, sizeof( struct latency_t ));
+    if (( order < LATENCY_ORDER_MIN ) || ( order > LATENCY_ORDER_MAX ))
+        return -1;
+
+    tap = taps[order - LATENCY_ORDER_MIN];
+    for ( i = 0; ( i < 4 ) && tap[i]; i++ ) mask |= 1ul << ( order - tap[i] );
+
+    length = ( 1ul << order ) - 1;
+    latency->order  = order;
+    latency->length = length;
+    latency->mls    = malloc( length );
+    latency->state  = malloc( length * sizeof( uint32_t ));
+    latency->lag    = malloc( length * sizeof( uint32_t ));
+    latency->work   = malloc(( length + 1 ) * sizeof( float ));
+    ahead           = malloc( length * sizeof( uint32_t ));
+    if (( latency->mls == NULL ) || ( latency->state == NULL ) ||
+        ( latency->lag == NULL ) || ( latency->work == NULL ) ||
+        ( ahead == NULL ))
+    {
+        free( ahead );
+        latency_free( latency );
+        return -2;
+    }
+
+    for ( n = 0; n < length; n++ )
+    {
+        latency->state[n] = state;
+        latency->mls[n]   = ( state & 1 ) ? -1 : 1;
+        state = ( state >> 1 ) |
+                (( uint32_t )__builtin_parity( state & mask ) << ( order - 1 ));
+    }
+
+    for ( n = 0; n < length; n++ )
+    {
+        if ( n < order ) ahead[n] = 1ul << n;
+        else
+            for ( ahead[n] = 0, i = 0; i < order; i++ )
+                if ( mask & ( 1ul << i )) ahead[n] ^= ahead[n - order + i];
+    }
+
+    // The sequence lag samples earlier is length - lag ahead.
+    for ( n = 0; n < length; n++ )
+        latency->lag[n] = ahead[( length - n ) % length];
+    free( ahead );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns the delay of a sequence in one period of capture.
+//  ---------------------------------------------------------------------------
+uint32_t latency_find( struct latency_t *latency, const float *in,
+                       float *snr, float *gain )
+{
+    float   *x = latency->work;
+    const uint32_t size = latency->length + 1;
+    uint32_t n, i, j, half, peak = 0;
+    double   sum = 0, energy = 0, best = 0, r;
+    float    a, b;
+
+    // Samples by register state, state 0 never occurs.
+    x[0] = 0;
+    for ( n = 0; n < latency->length; n++ ) x[latency->state[n]] = in[n];
+
+    // Fast Walsh Hadamard transform.
+    for ( half = 1; half < size; half <<= 1 )
+        for ( i = 0; i < size; i += half << 1 )
+            for ( j = i; j < i + half; j++ )
+            {
+                a = x[j];
+                b = x[j + half];
+                x[j]        = a + b;
+                x[j + half] = a - b;
+            }
+
+    for ( n = 0; n < latency->length; n++ )
+    {
+        r = x[latency->lag[n]];
+        sum    += r;
+        energy += r * r;
+        if ( fabs( r ) > fabs( best ))
+        {
+            best = r;
+            peak = n;
+        }
+    }
+
+    // Rms of the other lags about their mean, which is -gain.
+    n = latency->length - 1;
+    sum    -= best;
+    energy -= best * best;
+    r = energy / n - ( sum / n ) * ( sum / n );
+    *gain = best / latency->length;
+    *snr  = ( r > 0 ) ? 10 * log10( best * best / r ) : 200;
+
+    return peak;
+}
+
+//  ---------------------------------------------------------------------------
+//  Frees sequence and tables.
+//  ---------------------------------------------------------------------------
+void latency_free( struct latency_t *latency )
+{
+    free( latency->mls );
+    free( latency->state );
+    free( latency->lag );
+    free( latency->work );
+    memset( latency, 0, sizeof( struct latency_t ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns the configuration with least delay and no xruns.
+//  ---------------------------------------------------------------------------
+int16_t latency_choose( const struct latency_result_t *results,
+                        uint16_t count )
+{
+    int16_t  best = -1;
+    uint16_t i;
+
+    for ( i = 0; i < count; i++ )
+    {
+        if (( results[i].delay < 0 ) || ( results[i].xruns > 0 ) ||
+            ( results[i].snr < LATENCY_SNR )) continue;
+        if (( best < 0 ) || ( results[i].delay < results[best].delay ) ||
+            (( results[i].delay == results[best].delay ) &&
+             ( results[i].period > results[best].period )))
+            best = i;
+    }
+
+    return best;
+}
@@ -0,0 +1,140 @@
+//  ===========================================================================
+/*
+    latencyPi:
+
+    Round trip latency measurement with maximum length sequences.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Borish, J. and Angell, J. B., An Efficient Algorithm for Measuring
+        the Impulse Response Using Pseudorandom Noise, JAES 31(7), 1983.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef LATENCYPI_H
+#define LATENCYPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    An MLS of order m is 2^m - 1 samples of +1 and -1 from a linear
+    feedback shift register. Played repeatedly, its circular cross
+    correlation with itself is L at zero lag and -1 at every other lag, so
+    correlating one period of what comes back against the sequence gives
+    the impulse response of the path, and the lag of its peak is the delay.
+    Noise and distortion are spread evenly over all lags, so the peak
+    stands well clear of them even at low levels.
+
+    Correlating directly would take L^2 multiplies, too many on a Pi Zero
+    for an order that covers a large buffer. Instead, each sample is placed
+    at the register state that produced it and a fast Hadamard transform
+    gives the correlation at every lag in m * 2^m additions, after which
+    each lag is read from the point of the linear function of the state
+    that gives the sequence that many samples earlier.
+
+    To measure, play at least three periods and pass latency_find one
+    period of capture starting a whole period after the first sample was
+    played. The delay is then the lag of the peak, provided it is less
+    than a period, so choose the order with latency_order.
+
+    latency_choose picks the fastest of a set of measured configurations
+    that ran without xruns, for autotuning buffer sizes.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define LATENCY_ORDER_MIN   10
+#define LATENCY_ORDER_MAX   18
+#define LATENCY_PERIODS     3       // Periods of sequence to play.
+#define LATENCY_SNR         20.0    // dB for a trustworthy peak.
+
+//  Types. --------------------------------------------------------------------
+
+struct latency_t
+{
+    uint8_t   order;
+    uint32_t  length;               // 2^order - 1.
+    int8_t   *mls;                  // Sequence, +1 or -1.
+    uint32_t *state;                // Register state for each sample.
+    uint32_t *lag;                  // Hadamard index for each lag.
+    float    *work;                 // 2^order.
+};
+
+struct latency_result_t
+{
+    uint32_t period;                // Frames.
+    uint32_t buffer;                // Frames.
+    int32_t  delay;                 // Frames, -1 if not measured.
+    float    snr;                   // dB.
+    uint32_t xruns;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns the smallest order with a period longer than frames.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 if no order is long enough.
+*/
+uint8_t latency_order( uint32_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Generates a sequence and correlation tables.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 for an invalid order, -2 if out of memory.
+*/
+int8_t latency_init( struct latency_t *latency, uint8_t order );
+
+//  ---------------------------------------------------------------------------
+//  Returns the delay of a sequence in one period of capture.
+//  ---------------------------------------------------------------------------
+/*
+    in holds length samples. Sets snr to the peak over the rms of all
+    other lags in dB and gain to the height of the peak, negative if the
+    path inverts. Returns the lag of the peak.
+*/
+uint32_t latency_find( struct latency_t *latency, const float *in,
+                       float *snr, float *gain );
+
+//  ---------------------------------------------------------------------------
+//  Frees sequence and tables.
+//  ---------------------------------------------------------------------------
+void latency_free( struct latency_t *latency );
+
+//  ---------------------------------------------------------------------------
+//  Returns the configuration with least delay and no xruns.
+//  ---------------------------------------------------------------------------
+/*
+    Ignores results without a delay or with an snr under LATENCY_SNR. Of
+    equal delays, takes the larger period, for fewer wake ups.
+    Returns the index of the result, or -1 if none qualify.
+*/
+int16_t latency_choose( const struct latency_result_t *results,
+                        uint16_t count );
+
+#endif // #ifndef LATENCYPI_H
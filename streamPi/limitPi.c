@@ -0,0 +1,313 @@
+//  ===========================================================================
+/*
+    limitPi:
+
+    Look-ahead peak limiter and compressor stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic limitPi.c streamPi.c -lm -lrt
+        gcc -shared -o liblimitPi.so limitPi.o streamPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "limitPi.h"
+
+#define LIMIT_MASK ( LIMIT_LOOKAHEAD_MAX - 1 )
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns smoothing coefficient for a time constant.
+//  ---------------------------------------------------------------------------
+static float limit_coef( float ms, uint32_t rate )
+{
+    return ( ms <= 0 ) ? 0 : expf( -1000.0f / ( ms * rate ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets config to defaults.
+//  ---------------------------------------------------------------------------
+void limit_config( struct limit_config_t *config )
+{
+    config->ceiling      = -0.3;
+    config->lookahead    = 2;
+    config->release      = 100;
+    config->threshold    = -20;
+    config->ratio        = 1;
+    config->attack       = 10;
+    config->comp_release = 200;
+    config->makeup       = 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises limiter and compressor.
+//  ---------------------------------------------------------------------------
+int8_t limit_init( struct limit_t *limit, struct stream_format_t *format,
+                   struct limit_config_t *config )
+{
+    uint32_t length = lroundf( config->lookahead * format->rate / 1000 );
+    uint16_t i;
+
+    if ( length < 1 ) length = 1;
+    if (( length > LIMIT_LOOKAHEAD_MAX ) || ( config->ceiling > 0 ) ||
+        ( config->ratio < 1 )) return -1;
+
+    memset( limit, 0, sizeof( struct limit_t ));
+    limit->format  = *format;
+    limit->length  = length;
+    limit->ceiling = powf( 10, config->ceiling / 20 );
+    limit->release = limit_coef( config->release, format->rate );
+    limit->gain    = 1;
+
+    for ( i = 0; i < length; i++ ) limit->target[i] = 1;
+    limit->sum = length;
+
+    limit->compress     = ( config->ratio > 1 );
+    limit->threshold    = config->threshold;
+    limit->slope        = 1 - 1 / config->ratio;
+    limit->attack       = limit_coef( config->attack, format->rate );
+    limit->comp_release = limit_coef( config->comp_release, format->rate );
+    limit->makeup       = powf( 10, config->makeup / 20 );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Publishes gain reduction in shared memory.
+//  ---------------------------------------------------------------------------
+int8_t limit_share( struct limit_t *limit, const char *name )
+{
+    struct limit_shm_t *shm;
+    int fd;
+
+    fd = shm_open( name, O_CREAT | O_RDWR, 0644 );
+    if ( fd < 0 ) return -1;
+
+    if ( ftruncate( fd, sizeof( struct limit_shm_t )) < 0 )
+    {
+        close( fd );
+        return -1;
+    }
+
+    shm = mmap( NULL, sizeof( struct limit_shm_t ), PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0 );
+    close( fd );
+    if ( shm == MAP_FAILED ) return -1;
+
+    memset( shm, 0, sizeof( struct limit_shm_t ));
+    shm->running     = 1;
+    limit->shm      = shm;
+    limit->shm_name = name;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns latency in frames.
+//  ---------------------------------------------------------------------------
+uint16_t limit_latency( struct limit_t *limit )
+{
+    return limit->length - 1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns compressor gain for a peak level.
+//  ---------------------------------------------------------------------------
+static inline float limit_compress( struct limit_t *limit, float peak )
+{
+    float coef = ( peak > limit->envelope ) ? limit->attack
+                                            : limit->comp_release;
+    float over;
+
+    limit->envelope = peak + coef * ( limit->envelope - peak );
+    if ( limit->envelope < 1e-6f ) return limit->makeup;
+
+    over = 20 * log10f( limit->envelope ) - limit->threshold;
+    if ( over <= 0 ) return limit->makeup;
+
+    return limit->makeup * powf( 10, -over * limit->slope / 20 );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns limiter gain for the frame leaving the delay line.
+//  ---------------------------------------------------------------------------
+static inline float limit_gain( struct limit_t *limit, float peak )
+{
+    uint32_t frame = limit->frame;
+    float    target;
+    float    average;
+
+    // Window peak from monotonic deque, expiring the front before pushing
+    // so it never holds more than L entries.
+    if (( limit->tail != limit->head ) &&
+        ( frame - limit->deque_frame[limit->head & LIMIT_MASK] >=
+          limit->length )) limit->head++;
+    while (( limit->tail != limit->head ) &&
+           ( limit->deque_level[( limit->tail - 1 ) & LIMIT_MASK] <= peak ))
+        limit->tail--;
+    limit->deque_frame[limit->tail & LIMIT_MASK] = frame;
+    limit->deque_level[limit->tail & LIMIT_MASK] = peak;
+    limit->tail++;
+    peak = limit->deque_level[limit->head & LIMIT_MASK];
+
+    // Average target gain over look-ahead.
+    target = ( peak > limit->ceiling ) ? limit->ceiling / peak : 1;
+    limit->sum += target - limit->target[limit->pos];
+    limit->target[limit->pos] = target;
+    if ( ++limit->pos == limit->length ) limit->pos = 0;
+    average = limit->sum / limit->length;
+
+    // Release, never above average.
+    if ( average < limit->gain ) limit->gain = average;
+    else limit->gain = average + limit->release * ( limit->gain - average );
+
+    return limit->gain;
+}
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void limit_process( void *data, sample_t *samples, uint16_t frames )
+{
+    struct limit_t *limit = data;
+    const uint8_t   channels = limit->format.channels;
+    const uint32_t  delay = limit->length - 1;
+    float           min_limit = 1;
+    float           min_comp = limit->makeup;
+    float           peak, x;
+    uint32_t        in, out;
+    uint16_t        f;
+    uint8_t         ch;
+
+    // Gains for each frame.
+    for ( f = 0; f < frames; f++, limit->frame++ )
+    {
+        for ( peak = 0, ch = 0; ch < channels; ch++ )
+        {
+            x = fabsf( STREAM_TO_FLOAT( samples[f * channels + ch] ));
+            if ( x > peak ) peak = x;
+        }
+
+        limit->comp_gain[f] = limit->compress ?
+                              limit_compress( limit, peak ) : 1;
+        limit->limit_gain[f] = limit_gain( limit,
+                                           peak * limit->comp_gain[f] );
+
+        if ( limit->comp_gain[f] < min_comp ) min_comp = limit->comp_gain[f];
+        if ( limit->limit_gain[f] < min_limit )
+            min_limit = limit->limit_gain[f];
+    }
+
+    // Delay and apply gains.
+    for ( ch = 0; ch < channels; ch++ )
+    {
+        float *line = limit->delay[ch];
+
+        in  = limit->frame - frames;
+        out = in - delay;
+        for ( f = 0; f < frames; f++, in++, out++ )
+        {
+            line[in & LIMIT_MASK] = STREAM_TO_FLOAT( samples[f * channels +
+                                                             ch] ) *
+                                    limit->comp_gain[f];
+            samples[f * channels + ch] =
+                STREAM_FROM_FLOAT( line[out & LIMIT_MASK] *
+                                   limit->limit_gain[f] );
+        }
+    }
+
+    limit->limit_reduction = -20 * log10f( min_limit );
+    limit->comp_reduction  = -20 * log10f( min_comp / limit->makeup );
+
+    if ( limit->shm != NULL )
+    {
+        struct limit_shm_t *shm = limit->shm;
+
+        __atomic_store_n( &shm->seq, shm->seq + 1, __ATOMIC_RELAXED );
+        __atomic_thread_fence( __ATOMIC_RELEASE );
+        shm->periods++;
+        shm->limit = limit->limit_reduction;
+        shm->comp  = limit->comp_reduction;
+        __atomic_store_n( &shm->seq, shm->seq + 1, __ATOMIC_RELEASE );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Marks shared memory stopped, unmaps and unlinks it.
+//  ---------------------------------------------------------------------------
+/*
+    Readers that still have the object mapped see running cleared and drop
+    their mapping, so they pick up a new object if the limiter restarts.
+*/
+void limit_free( void *data )
+{
+    struct limit_t *limit = data;
+
+    if ( limit->shm != NULL )
+    {
+        __atomic_store_n( &limit->shm->running, 0, __ATOMIC_RELEASE );
+        munmap( limit->shm, sizeof( struct limit_shm_t ));
+        shm_unlink( limit->shm_name );
+    }
+    limit->shm = NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for the limiter.
+//  ---------------------------------------------------------------------------
+void limit_stage( struct limit_t *limit, struct stream_stage_t *stage )
+{
+    stage->name    = "limit";
+    stage->data    = limit;
+    stage->process = limit_process;
+    stage->free    = limit_free;
+}
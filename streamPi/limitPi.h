@@ -0,0 +1,199 @@
+//  ===========================================================================
+/*
+    limitPi:
+
+    Look-ahead peak limiter and compressor stage for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef LIMITPI_H
+#define LIMITPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    A feed-forward compressor followed by a brickwall limiter, for quiet
+    listening and to stop overs after EQ gain. Gain is linked across
+    channels so the stereo image doesn't move.
+
+    Compressor:
+
+        Peak level is smoothed with separate attack and release times and
+        gain is reduced above threshold by ratio, with makeup gain added
+        after. A ratio of 1 turns the compressor off.
+
+    Limiter:
+
+        The signal is delayed by the look-ahead time L so that gain can be
+        brought down before a peak arrives:
+
+        1.  The peak over the last L frames is held using a monotonic deque
+            of ( frame, level ) pairs with falling levels. Each new level
+            removes all smaller levels from the back and old frames drop
+            off the front, so the front is always the window peak and the
+            cost is O(1) per frame on average.
+
+        2.  The target gain ceiling / peak is averaged over L frames, which
+            gives a smooth attack that still reaches the target before the
+            peak leaves the delay line L - 1 frames later.
+
+        3.  Gain recovers with a first order release, and never rises above
+            the averaged gain, so the output can't exceed ceiling.
+
+    Gains for a period are worked out first, then applied to the delayed
+    samples in a separate loop across channels that the compiler can
+    vectorise. All buffers are part of limit_t, so nothing is allocated
+    after limit_init.
+
+    Gain reduction is kept in limit_t and, after limit_share, published in
+    a POSIX shared memory object (LIMIT_SHM) for meterPi to display. The
+    audio thread only writes to the mapped memory, using a sequence count
+    so readers can detect a torn read. limit_free clears running and
+    unlinks the object, so meterPi can tell the limiter has stopped.
+
+    Processing is in float. Q28 samples are converted at the edges of the
+    stage.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define LIMIT_LOOKAHEAD_MAX  4096 // Max look-ahead (frames), power of 2.
+#define LIMIT_SHM "/streamPi-limit" // Shared memory for gain reduction.
+
+//  Types. --------------------------------------------------------------------
+
+struct limit_config_t
+{
+    float ceiling;      // Limiter ceiling (dBFS).
+    float lookahead;    // Look-ahead (ms).
+    float release;      // Limiter release (ms).
+    float threshold;    // Compressor threshold (dBFS).
+    float ratio;        // Compressor ratio, 1 = off.
+    float attack;       // Compressor attack (ms).
+    float comp_release; // Compressor release (ms).
+    float makeup;       // Compressor makeup gain (dB).
+};
+
+// Shared with meterPi, must match struct gain_shm_t in meterPi.h.
+struct limit_shm_t
+{
+    uint32_t seq;       // Odd while being written.
+    uint32_t periods;   // Periods processed.
+    uint32_t running;   // Cleared by limit_free.
+    float    limit;     // Limiter gain reduction over last period (dB).
+    float    comp;      // Compressor gain reduction over last period (dB).
+};
+
+struct limit_t
+{
+    struct stream_format_t format;
+    uint16_t  length;           // Look-ahead L (frames).
+    uint32_t  frame;            // Frames processed.
+
+    // Limiter.
+    float     ceiling;          // Linear.
+    float     release;          // Release coefficient.
+    uint32_t  deque_frame[LIMIT_LOOKAHEAD_MAX];
+    float     deque_level[LIMIT_LOOKAHEAD_MAX];
+    uint16_t  head;             // Front of deque.
+    uint16_t  tail;             // One past back of deque.
+    float     target[LIMIT_LOOKAHEAD_MAX];  // Last L target gains.
+    uint16_t  pos;              // Oldest target gain.
+    double    sum;              // Sum of last L target gains.
+    float     gain;             // Released gain.
+
+    // Compressor.
+    bool      compress;
+    float     threshold;        // dBFS.
+    float     slope;            // 1 - 1 / ratio.
+    float     attack;           // Attack coefficient.
+    float     comp_release;     // Release coefficient.
+    float     makeup;           // Linear.
+    float     envelope;         // Smoothed peak level.
+
+    // Buffers for one period.
+    float     comp_gain[STREAM_PERIOD_MAX];
+    float     limit_gain[STREAM_PERIOD_MAX];
+    float     delay[STREAM_CHANNELS_MAX][LIMIT_LOOKAHEAD_MAX];
+
+    // Gain reduction over last period (dB, positive).
+    float     limit_reduction;
+    float     comp_reduction;
+    struct limit_shm_t *shm;
+    const char         *shm_name;  // As passed to limit_share.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Sets config to defaults.
+//  ---------------------------------------------------------------------------
+/*
+    -0.3dBFS ceiling, 2ms look-ahead, 100ms release, compressor off.
+*/
+void limit_config( struct limit_config_t *config );
+
+//  ---------------------------------------------------------------------------
+//  Initialises limiter and compressor.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 for invalid settings or a look-ahead longer
+    than LIMIT_LOOKAHEAD_MAX frames.
+*/
+int8_t limit_init( struct limit_t *limit, struct stream_format_t *format,
+                   struct limit_config_t *config );
+
+//  ---------------------------------------------------------------------------
+//  Publishes gain reduction in shared memory.
+//  ---------------------------------------------------------------------------
+/*
+    name is a shared memory object name, e.g. LIMIT_SHM, and must stay
+    valid until limit_free. Returns 0 on success, -1 if the object can't be created.
+*/
+int8_t limit_share( struct limit_t *limit, const char *name );
+
+//  ---------------------------------------------------------------------------
+//  Returns latency in frames.
+//  ---------------------------------------------------------------------------
+uint16_t limit_latency( struct limit_t *limit );
+
+//  ---------------------------------------------------------------------------
+//  Processes frames of interleaved samples in place.
+//  ---------------------------------------------------------------------------
+void limit_process( void *data, sample_t *samples, uint16_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Marks shared memory stopped, unmaps and unlinks it.
+//  ---------------------------------------------------------------------------
+void limit_free( void *data );
+
+//  ---------------------------------------------------------------------------
+//  Fills in a stream stage for the limiter.
+//  ---------------------------------------------------------------------------
+void limit_stage( struct limit_t *limit, struct stream_stage_t *stage );
+
+#endif // #ifndef LIMITPI_H
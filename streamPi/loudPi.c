@@ -0,0 +1,306 @@
+//  ===========================================================================
+/*
+    loudPi:
+
+    Incremental loudness measurement to ITU-R BS.1770 and EBU R128, for
+    streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        ITU-R BS.1770-4, Algorithms to measure audio programme loudness
+        and true-peak audio level.
+        EBU Tech 3341 and 3342, Loudness metering and Loudness range.
+        ReplayGain 2.0 specification.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic loudPi.c -lm
+        gcc -shared -o libloudPi.so loudPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "loudPi.h"
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises a measurement.
+//  ---------------------------------------------------------------------------
+/*
+    K-weighting filters are the BS.1770 48kHz filters, refitted to the
+    rate from their analogue prototypes so other rates match as closely.
+*/
+int8_t loud_init( struct loud_t *loud, uint32_t rate, uint8_t channels )
+{
+    double  k, vh, vb, a0;
+    const double f1 = 1681.974450955533, g1 = 3.999843853973347,
+                 q1 = 0.7071752369554196;
+    const double f2 = 38.13547087602444, q2 = 0.5003270373238773;
+    uint8_t ch;
+
+    if (( rate < 8000 ) || ( channels == 0 ) ||
+        ( channels > STREAM_CHANNELS_MAX )) return -1;
+
+    memset( loud, 0, sizeof( struct loud_t ));
+    loud->rate     = rate;
+    loud->channels = channels;
+    loud->length   = lround( rate / 10.0 );
+
+    // High shelf, +4dB above about 1.5kHz.
+    k  = tan( M_PI * f1 / rate );
+    vh = pow( 10, g1 / 20 );
+    vb = pow( vh, 0.4996667741545416 );
+    a0 = 1 + k / q1 + k * k;
+    loud->b[0][0] = ( vh + vb * k / q1 + k * k ) / a0;
+    loud->b[0][1] = 2 * ( k * k - vh ) / a0;
+    loud->b[0][2] = ( vh - vb * k / q1 + k * k ) / a0;
+    loud->a[0][1] = 2 * ( k * k - 1 ) / a0;
+    loud->a[0][2] = ( 1 - k / q1 + k * k ) / a0;
+
+    // High pass at about 38Hz.
+    k  = tan( M_PI * f2 / rate );
+    a0 = 1 + k / q2 + k * k;
+    loud->b[1][0] = 1;
+    loud->b[1][1] = -2;
+    loud->b[1][2] = 1;
+    loud->a[1][1] = 2 * ( k * k - 1 ) / a0;
+    loud->a[1][2] = ( 1 - k / q2 + k * k ) / a0;
+
+    // Mono and stereo weight every channel 1, more channels are 5.1.
+    for ( ch = 0; ch < channels; ch++ )
+        loud->weight[ch] = ( channels <= 2 ) ? 1 :
+                           ( ch == 3 ) ? 0 : ( ch >= 4 ) ? 1.41 : 1;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds a block of energy to a histogram.
+//  ---------------------------------------------------------------------------
+static void loud_hist_add( struct loud_hist_t *hist, double energy )
+{
+    double  lufs;
+    int32_t bin;
+
+    if ( energy <= 0 ) return;
+    lufs = -0.691 + 10 * log10( energy );
+    if ( lufs < LOUD_FLOOR ) return;
+
+    bin = ( lufs - LOUD_FLOOR ) / LOUD_STEP;
+    if ( bin >= LOUD_BINS ) bin = LOUD_BINS - 1;
+    hist->count[bin]++;
+    hist->energy[bin] += energy;
+}
+
+//  ---------------------------------------------------------------------------
+//  Ends a sub-block, adding any blocks it completes.
+//  ---------------------------------------------------------------------------
+static void loud_subblock( struct loud_t *loud )
+{
+    double  sum;
+    uint8_t i;
+
+    loud->sub[loud->subs % LOUD_SUBBLOCKS] = loud->sum / loud->length;
+    loud->subs++;
+    loud->sum    = 0;
+    loud->frames = 0;
+
+    if ( loud->subs >= 4 )
+    {
+        for ( sum = 0, i = 1; i <= 4; i++ )
+            sum += loud->sub[( loud->subs - i ) % LOUD_SUBBLOCKS];
+        loud_hist_add( &loud->block, sum / 4 );
+    }
+    if ( loud->subs >= LOUD_SUBBLOCKS )
+    {
+        for ( sum = 0, i = 0; i < LOUD_SUBBLOCKS; i++ )
+            sum += loud->sub[i];
+        loud_hist_add( &loud->shortterm, sum / LOUD_SUBBLOCKS );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds frames of interleaved float samples.
+//  ---------------------------------------------------------------------------
+/*
+    Filters are direct form II transposed, in double as the high pass is
+    at under 0.1% of the sample rate.
+*/
+void loud_add( struct loud_t *loud, const float *samples, uint32_t frames )
+{
+    const uint8_t channels = loud->channels;
+    double   x, y, sum;
+    float    peak = loud->peak, s;
+    uint32_t count, f;
+    uint8_t  ch, k;
+
+    while ( frames > 0 )
+    {
+        count = loud->length - loud->frames;
+        if ( count > frames ) count = frames;
+
+        for ( sum = 0, f = 0; f < count; f++, samples += channels )
+            for ( ch = 0; ch < channels; ch++ )
+            {
+                s = fabsf( samples[ch] );
+                if ( s > peak ) peak = s;
+
+                for ( y = samples[ch], k = 0; k < 2; k++ )
+                {
+                    x = y;
+                    y = loud->b[k][0] * x + loud->z[k][0][ch];
+                    loud->z[k][0][ch] = loud->b[k][1] * x -
+                                        loud->a[k][1] * y + loud->z[k][1][ch];
+                    loud->z[k][1][ch] = loud->b[k][2] * x - loud->a[k][2] * y;
+                }
+
+                sum += loud->weight[ch] * y * y;
+            }
+
+        loud->sum    += sum;
+        loud->frames += count;
+        frames       -= count;
+        if ( loud->frames == loud->length ) loud_subblock( loud );
+    }
+    loud->peak = peak;
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds the blocks and peak of one measurement to another, for albums.
+//  ---------------------------------------------------------------------------
+void loud_merge( struct loud_t *loud, const struct loud_t *from )
+{
+    uint16_t i;
+
+    for ( i = 0; i < LOUD_BINS; i++ )
+    {
+        loud->block.count[i]      += from->block.count[i];
+        loud->block.energy[i]     += from->block.energy[i];
+        loud->shortterm.count[i]  += from->shortterm.count[i];
+        loud->shortterm.energy[i] += from->shortterm.energy[i];
+    }
+    if ( from->peak > loud->peak ) loud->peak = from->peak;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns first bin at or above a gate relative to the gated mean.
+//  ---------------------------------------------------------------------------
+/*
+    A bin is in if its centre is at or above the gate. Returns LOUD_BINS
+    if no blocks passed the absolute gate.
+*/
+static uint16_t loud_gate( const struct loud_hist_t *hist, double relative )
+{
+    double   energy = 0, gate, bin;
+    uint32_t count = 0;
+    uint16_t i;
+
+    for ( i = 0; i < LOUD_BINS; i++ )
+    {
+        count  += hist->count[i];
+        energy += hist->energy[i];
+    }
+    if ( count == 0 ) return LOUD_BINS;
+
+    gate = -0.691 + 10 * log10( energy / count ) + relative;
+    bin  = ceil(( gate - LOUD_FLOOR ) / LOUD_STEP - 0.5 );
+
+    return ( bin < 0 ) ? 0 : ( bin > LOUD_BINS ) ? LOUD_BINS : bin;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns integrated loudness in LUFS, -HUGE_VAL if all below the gate.
+//  ---------------------------------------------------------------------------
+double loud_integrated( const struct loud_t *loud )
+{
+    double   energy = 0;
+    uint32_t count = 0;
+    uint16_t i;
+
+    for ( i = loud_gate( &loud->block, -10 ); i < LOUD_BINS; i++ )
+    {
+        count  += loud->block.count[i];
+        energy += loud->block.energy[i];
+    }
+
+    return ( count == 0 ) ? -HUGE_VAL
+                          : -0.691 + 10 * log10( energy / count );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns loudness range in LU.
+//  ---------------------------------------------------------------------------
+double loud_range( const struct loud_t *loud )
+{
+    const struct loud_hist_t *hist = &loud->shortterm;
+    const uint16_t gate = loud_gate( hist, -20 );
+    uint32_t count = 0, low, high, sum;
+    uint16_t i, lo = 0, hi = 0;
+
+    for ( i = gate; i < LOUD_BINS; i++ ) count += hist->count[i];
+    if ( count == 0 ) return 0;
+
+    // Bins holding the 10th and 95th percentiles.
+    low  = count / 10;
+    high = count * 95 / 100;
+    for ( sum = 0, i = gate; i < LOUD_BINS; i++ )
+    {
+        if (( sum <= low ) && ( sum + hist->count[i] > low )) lo = i;
+        if (( sum <= high ) && ( sum + hist->count[i] > high )) hi = i;
+        sum += hist->count[i];
+    }
+    if ( hi == 0 ) hi = lo;
+
+    return ( hi - lo ) * LOUD_STEP;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns sample peak, 1.0 for full scale.
+//  ---------------------------------------------------------------------------
+double loud_peak( const struct loud_t *loud )
+{
+    return loud->peak;
+}
@@ -0,0 +1,151 @@
+//  ===========================================================================
+/*
+    loudPi:
+
+    Incremental loudness measurement to ITU-R BS.1770 and EBU R128, for
+    streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        ITU-R BS.1770-4, Algorithms to measure audio programme loudness
+        and true-peak audio level.
+        EBU Tech 3341 and 3342, Loudness metering and Loudness range.
+        ReplayGain 2.0 specification.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef LOUDPI_H
+#define LOUDPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    Audio is fed in with loud_add as it is decoded, in blocks of any size,
+    and integrated loudness, loudness range and peak can be read at any
+    time. Memory use is fixed, however long the programme.
+
+    Measurement:
+
+        1.  Each channel is K-weighted by a high shelf and a high pass
+            biquad, worked out for the sample rate.
+
+        2.  Mean squares are summed over 100ms sub-blocks, weighted 1 for
+            front channels, 1.41 for surrounds and 0 for LFE, in the 5.1
+            order L, R, C, LFE, Ls, Rs.
+
+        3.  Each 400ms block (4 sub-blocks, 75% overlap) has loudness
+
+                L = -0.691 + 10 log10( sum of weighted mean squares ) LUFS
+
+            and goes into a histogram for integrated loudness. Each 3s
+            block (30 sub-blocks) goes into another for loudness range.
+
+    Histograms have LOUD_BINS bins of 0.1 LU from LOUD_FLOOR, holding a
+    count and the sum of block energies, so integrated loudness is the
+    exact gated mean, only blocks in the bin at the relative gate being in
+    doubt. Gates are -70 LUFS, then -10 LU below the mean for integrated
+    loudness and -20 LU for loudness range, which is from the 10th to 95th
+    percentile.
+
+    Histograms add, so album loudness is found by merging track
+    measurements with loud_merge, with the same result as measuring the
+    album end to end.
+
+    Peak is the sample peak.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define LOUD_BINS       800     // Histogram bins.
+#define LOUD_FLOOR      -70.0   // Absolute gate and first bin (LUFS).
+#define LOUD_STEP       0.1     // Bin width (LU).
+#define LOUD_SUBBLOCKS  30      // Sub-blocks in a short term block.
+#define LOUD_REFERENCE  -18.0   // ReplayGain 2.0 reference (LUFS).
+
+//  Types. --------------------------------------------------------------------
+
+struct loud_hist_t
+{
+    uint32_t count[LOUD_BINS];
+    double   energy[LOUD_BINS];
+};
+
+struct loud_t
+{
+    uint32_t rate;
+    uint8_t  channels;
+
+    double   b[2][3], a[2][3];                      // K-weighting.
+    double   z[2][2][STREAM_CHANNELS_MAX];          // Filter state.
+    double   weight[STREAM_CHANNELS_MAX];
+
+    uint32_t frames;                    // Frames in current sub-block.
+    uint32_t length;                    // Frames per sub-block.
+    double   sum;                       // Weighted squares so far.
+    double   sub[LOUD_SUBBLOCKS];       // Last sub-blocks, mean squares.
+    uint64_t subs;                      // Sub-blocks ever.
+
+    struct loud_hist_t block;           // 400ms blocks.
+    struct loud_hist_t shortterm;       // 3s blocks.
+    float    peak;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises a measurement.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 for an invalid rate or channels.
+*/
+int8_t loud_init( struct loud_t *loud, uint32_t rate, uint8_t channels );
+
+//  ---------------------------------------------------------------------------
+//  Adds frames of interleaved float samples.
+//  ---------------------------------------------------------------------------
+void loud_add( struct loud_t *loud, const float *samples, uint32_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Adds the blocks and peak of one measurement to another, for albums.
+//  ---------------------------------------------------------------------------
+void loud_merge( struct loud_t *loud, const struct loud_t *from );
+
+//  ---------------------------------------------------------------------------
+//  Returns integrated loudness in LUFS, -HUGE_VAL if all below the gate.
+//  ---------------------------------------------------------------------------
+double loud_integrated( const struct loud_t *loud );
+
+//  ---------------------------------------------------------------------------
+//  Returns loudness range in LU.
+//  ---------------------------------------------------------------------------
+double loud_range( const struct loud_t *loud );
+
+//  ---------------------------------------------------------------------------
+//  Returns sample peak, 1.0 for full scale.
+//  ---------------------------------------------------------------------------
+double loud_peak( const struct loud_t *loud );
+
+#endif // #ifndef LOUDPI_H
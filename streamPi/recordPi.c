@@ -0,0 +1,626 @@
+//  ===========================================================================
+/*
+    recordPi:
+
+    Records captured PCM to WAV or W64 files without blocking the audio
+    thread, for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Efficient IO with io_uring, J.Axboe.
+        - see https://kernel.dk/io_uring.pdf
+        Sony Wave64 file format specification.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic recordPi.c -lpthread
+        gcc -shared -o librecordPi.so recordPi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+
+    Needs the kernel headers for io_uring (linux/io_uring.h) but not
+    liburing, which Tiny Core doesn't have.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <endian.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "recordPi.h"
+
+#define RECORD_MASK     ( RECORD_RING - 1 )
+#define RECORD_IDLE     10000000    // Writer sleep with nothing to do (ns).
+
+//  W64 chunk GUIDs, as stored.
+static const uint8_t w64_riff[16] =
+    { 'r', 'i', 'f', 'f', 0x2e, 0x91, 0xcf, 0x11,
+      0xa5, 0xd6, 0x28, 0xdb, 0x04, 0xc1, 0x00, 0x00 };
+static const uint8_t w64_wave[16] =
+    { 'w', 'a', 'v', 'e', 0xf3, 0xac, 0xd3, 0x11,
+      0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+static const uint8_t w64_fmt[16] =
+    { 'f', 'm', 't', ' ', 0xf3, 0xac, 0xd3, 0x11,
+      0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+static const uint8_t w64_junk[16] =
+    { 'j', 'u', 'n', 'k', 0xf3, 0xac, 0xd3, 0x11,
+      0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+static const uint8_t w64_data[16] =
+    { 'd', 'a', 't', 'a', 0xf3, 0xac, 0xd3, 0x11,
+      0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+
+//  KSDATAFORMAT_SUBTYPE_PCM, for WAVE_FORMAT_EXTENSIBLE.
+static const uint8_t wav_pcm[16] =
+    { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+      0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 };
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Packs little endian fields.
+//  ---------------------------------------------------------------------------
+static void record_put16( uint8_t *p, uint16_t v )
+{
+    v = htole16( v );
+    memcpy( p, &v, 2 );
+}
+
+static void record_put32( uint8_t *p, uint32_t v )
+{
+    v = htole32( v );
+    memcpy( p, &v, 4 );
+}
+
+static void record_put64( uint8_t *p, uint64_t v )
+{
+    v = htole64( v );
+    memcpy( p, &v, 8 );
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills format chunk body, returns its size.
+//  ---------------------------------------------------------------------------
+/*
+    Plain PCM for 16 bit stereo or mono, WAVE_FORMAT_EXTENSIBLE otherwise,
+    as players expect for more bits or channels.
+*/
+static uint16_t record_fmt( struct record_t *record, uint8_t *p )
+{
+    const uint16_t align = record->channels * record->bits / 8;
+    const bool     extensible = ( record->bits > 16 ) ||
+                                ( record->channels > 2 );
+
+    record_put16( p, extensible ? 0xfffe : 1 );
+    record_put16( p + 2, record->channels );
+    record_put32( p + 4, record->rate );
+    record_put32( p + 8, record->rate * align );
+    record_put16( p + 12, align );
+    record_put16( p + 14, record->bits );
+    if ( !extensible ) return 16;
+
+    record_put16( p + 16, 22 );
+    record_put16( p + 18, record->bits );
+    record_put32( p + 20, ( record->channels <= 2 ) ?
+                          ( 1 << record->channels ) - 1 : 0 );
+    memcpy( p + 24, wav_pcm, 16 );
+
+    return 40;
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills header block for bytes of audio.
+//  ---------------------------------------------------------------------------
+/*
+    Audio always starts at RECORD_ALIGN, with a junk chunk taking up the
+    space between the format and data chunks.
+*/
+static void record_header( struct record_t *record, uint64_t bytes )
+{
+    uint8_t *p = record->header;
+    uint16_t size;
+    uint32_t pos;
+
+    memset( p, 0, RECORD_ALIGN );
+
+    if ( record->format == RECORD_W64 )
+    {
+        // W64 sizes include the 24 byte chunk header, chunks align to 8.
+        memcpy( p, w64_riff, 16 );
+        record_put64( p + 16, RECORD_ALIGN + bytes );
+        memcpy( p + 24, w64_wave, 16 );
+        memcpy( p + 40, w64_fmt, 16 );
+        size = record_fmt( record, p + 64 );
+        record_put64( p + 56, 24 + size );
+        pos = ( 64 + size + 7 ) & ~7;
+        memcpy( p + pos, w64_junk, 16 );
+        record_put64( p + pos + 16, RECORD_ALIGN - 24 - pos );
+        memcpy( p + RECORD_ALIGN - 24, w64_data, 16 );
+        record_put64( p + RECORD_ALIGN - 8, 24 + bytes );
+        return;
+    }
+
+    // WAV sizes stop at 4GB.
+    if ( bytes > 0xffffffffull - RECORD_ALIGN ) bytes = 0xffffffff -
+                                                        RECORD_ALIGN;
+    memcpy( p, "RIFF", 4 );
+    record_put32( p + 4, RECORD_ALIGN - 8 + bytes + ( bytes & 1 ));
+    memcpy( p + 8, "WAVEfmt ", 8 );
+    size = record_fmt( record, p + 20 );
+    record_put32( p + 16, size );
+    pos = 20 + size;
+    memcpy( p + pos, "JUNK", 4 );
+    record_put32( p + pos + 4, RECORD_ALIGN - 16 - pos );
+    memcpy( p + RECORD_ALIGN - 8, "data", 4 );
+    record_put32( p + RECORD_ALIGN - 4, bytes );
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes header block, dropping O_DIRECT if the filesystem refuses it.
+//  ---------------------------------------------------------------------------
+static int8_t record_write_header( struct record_t *record )
+{
+    if ( pwrite( record->fd, record->header, RECORD_ALIGN, 0 ) ==
+         RECORD_ALIGN ) return 0;
+    if (( errno != EINVAL ) || !record->direct ) return -1;
+
+    fcntl( record->fd, F_SETFL,
+           fcntl( record->fd, F_GETFL ) & ~O_DIRECT );
+    record->direct = false;
+
+    return ( pwrite( record->fd, record->header, RECORD_ALIGN, 0 ) ==
+             RECORD_ALIGN ) ? 0 : -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets up io_uring with the ring as fixed buffers.
+//  ---------------------------------------------------------------------------
+/*
+    Fixed buffers are pinned once, instead of for every write, but count
+    against RLIMIT_MEMLOCK. If they can't be registered, plain writes from
+    the same ring are used. Returns false if io_uring isn't available.
+*/
+static bool record_uring( struct record_t *record )
+{
+    struct io_uring_params params;
+    struct iovec iov[RECORD_CHUNKS];
+    uint8_t *sq, *cq;
+    uint8_t  i;
+    int      fd;
+
+    memset( &params, 0, sizeof( params ));
+    fd = syscall( __NR_io_uring_setup, RECORD_DEPTH, &params );
+    if ( fd < 0 ) return false;
+
+    record->io.fd        = fd;
+    record->io.sq_size   = params.sq_off.array +
+                           params.sq_entries * sizeof( uint32_t );
+    record->io.cq_size   = params.cq_off.cqes +
+                           params.cq_entries * sizeof( struct io_uring_cqe );
+    record->io.sqes_size = params.sq_entries * sizeof( struct io_uring_sqe );
+
+    sq = mmap( NULL, record->io.sq_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING );
+    cq = mmap( NULL, record->io.cq_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING );
+    record->io.sqes = mmap( NULL, record->io.sqes_size,
+                            PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES );
+    if (( sq == MAP_FAILED ) || ( cq == MAP_FAILED ) ||
+        ( record->io.sqes == MAP_FAILED ))
+    {
+        if ( sq != MAP_FAILED ) munmap( sq, record->io.sq_size );
+        if ( cq != MAP_FAILED ) munmap( cq, record->io.cq_size );
+        if ( record->io.sqes != MAP_FAILED )
+            munmap( record->io.sqes, record->io.sqes_size );
+        close( fd );
+        return false;
+    }
+
+    record->io.sq_ring  = sq;
+    record->io.sq_head  = ( uint32_t * )( sq + params.sq_off.head );
+    record->io.sq_tail  = ( uint32_t * )( sq + params.sq_off.tail );
+    record->io.sq_mask  = ( uint32_t * )( sq + params.sq_off.ring_mask );
+    record->io.sq_array = ( uint32_t * )( sq + params.sq_off.array );
+    record->io.cq_ring  = cq;
+    record->io.cq_head  = ( uint32_t * )( cq + params.cq_off.head );
+    record->io.cq_tail  = ( uint32_t * )( cq + params.cq_off.tail );
+    record->io.cq_mask  = ( uint32_t * )( cq + params.cq_off.ring_mask );
+    record->io.cqes     = cq + params.cq_off.cqes;
+
+    for ( i = 0; i < RECORD_CHUNKS; i++ )
+    {
+        iov[i].iov_base = record->ring + i * RECORD_CHUNK;
+        iov[i].iov_len  = RECORD_CHUNK;
+    }
+    record->io.fixed = ( syscall( __NR_io_uring_register, fd,
+                                  IORING_REGISTER_BUFFERS, iov,
+                                  RECORD_CHUNKS ) == 0 );
+
+    return true;
+}
+
+//  ---------------------------------------------------------------------------
+//  Tears down io_uring.
+//  ---------------------------------------------------------------------------
+static void record_uring_close( struct record_t *record )
+{
+    munmap( record->io.sqes, record->io.sqes_size );
+    munmap( record->io.sq_ring, record->io.sq_size );
+    munmap( record->io.cq_ring, record->io.cq_size );
+    close( record->io.fd );
+}
+
+//  ---------------------------------------------------------------------------
+//  Sleeps for s seconds.
+//  ---------------------------------------------------------------------------
+static void record_sleep( double s )
+{
+    struct timespec ts;
+
+    ts.tv_sec  = s;
+    ts.tv_nsec = ( s - ts.tv_sec ) * 1e9;
+    nanosleep( &ts, NULL );
+}
+
+//  ---------------------------------------------------------------------------
+//  Handles a finished write, handing chunks back to the audio thread.
+//  ---------------------------------------------------------------------------
+/*
+    Chunks can finish out of order, so tail only moves over chunks that
+    have all finished. A page cache that isn't bypassed is flushed as it
+    goes and the chunk before dropped from it, by which time its pages
+    are clean.
+*/
+static void record_complete( struct record_t *record, uint64_t chunk,
+                             int32_t result )
+{
+    const uint8_t slot   = chunk & ( RECORD_CHUNKS - 1 );
+    const off_t   offset = RECORD_ALIGN + chunk * RECORD_CHUNK;
+    uint64_t tail;
+
+    if (( result != ( int32_t )record->length[slot] ) &&
+        ( record->error == 0 ))
+        record->error = ( result < 0 ) ? -result : ENOSPC;
+
+    if ( !record->direct )
+    {
+        sync_file_range( record->fd, offset, record->length[slot],
+                         SYNC_FILE_RANGE_WRITE );
+        if ( chunk > 0 )
+        {
+            sync_file_range( record->fd, offset - RECORD_CHUNK,
+                             RECORD_CHUNK, SYNC_FILE_RANGE_WAIT_BEFORE |
+                             SYNC_FILE_RANGE_WRITE |
+                             SYNC_FILE_RANGE_WAIT_AFTER );
+            posix_fadvise( record->fd, offset - RECORD_CHUNK, RECORD_CHUNK,
+                           POSIX_FADV_DONTNEED );
+        }
+    }
+
+    record->done[slot] = true;
+    record->flight--;
+
+    tail = record->tail;
+    while ( record->done[( tail / RECORD_CHUNK ) & ( RECORD_CHUNKS - 1 )] &&
+            ( tail / RECORD_CHUNK < record->submitted ))
+    {
+        record->done[( tail / RECORD_CHUNK ) & ( RECORD_CHUNKS - 1 )] = false;
+        tail += RECORD_CHUNK;
+    }
+    __atomic_store_n( &record->tail, tail, __ATOMIC_RELEASE );
+}
+
+//  ---------------------------------------------------------------------------
+//  Starts writing a chunk of the ring to the file.
+//  ---------------------------------------------------------------------------
+/*
+    O_DIRECT writes must be whole blocks, so length is rounded up. Only
+    the last chunk is ever short, and anything past the audio is cut off
+    by record_close.
+*/
+static void record_submit( struct record_t *record, uint32_t length )
+{
+    const uint64_t chunk = record->submitted;
+    const uint8_t  slot  = chunk & ( RECORD_CHUNKS - 1 );
+    const off_t    offset = RECORD_ALIGN + chunk * RECORD_CHUNK;
+    uint8_t       *buffer = record->ring + slot * RECORD_CHUNK;
+    struct io_uring_sqe *sqe;
+    uint32_t tail, index;
+
+    length = ( length + RECORD_ALIGN - 1 ) & ~( RECORD_ALIGN - 1 );
+    record->length[slot] = length;
+    record->submitted++;
+    record->flight++;
+
+    // Simulated slow disk.
+    if ( record->slow > 0 ) record_sleep( length / record->slow );
+    if (( record->stall > 0 ) && ( drand48() < 0.1 ))
+        record_sleep( drand48() * record->stall );
+
+    if ( !record->uring )
+    {
+        record_complete( record, chunk,
+                         pwrite( record->fd, buffer, length, offset ));
+        return;
+    }
+
+    tail  = *record->io.sq_tail;
+    index = tail & *record->io.sq_mask;
+    sqe   = ( struct io_uring_sqe * )record->io.sqes + index;
+    memset( sqe, 0, sizeof( *sqe ));
+    sqe->opcode    = record->io.fixed ? IORING_OP_WRITE_FIXED
+                                      : IORING_OP_WRITE;
+    sqe->fd        = record->fd;
+    sqe->addr      = ( uintptr_t )buffer;
+    sqe->len       = length;
+    sqe->off       = offset;
+    sqe->buf_index = slot;
+    sqe->user_data = chunk;
+    record->io.sq_array[index] = index;
+    __atomic_store_n( record->io.sq_tail, tail + 1, __ATOMIC_RELEASE );
+
+    while (( syscall( __NR_io_uring_enter, record->io.fd, 1, 0, 0, NULL,
+                      0 ) < 0 ) && ( errno == EINTR ));
+}
+
+//  ---------------------------------------------------------------------------
+//  Handles finished writes, waiting for one if wait is set.
+//  ---------------------------------------------------------------------------
+static void record_reap( struct record_t *record, bool wait )
+{
+    struct io_uring_cqe *cqe;
+    uint32_t head;
+
+    if ( wait )
+        while (( syscall( __NR_io_uring_enter, record->io.fd, 0, 1,
+                          IORING_ENTER_GETEVENTS, NULL, 0 ) < 0 ) &&
+               ( errno == EINTR ));
+
+    head = *record->io.cq_head;
+    while ( head != __atomic_load_n( record->io.cq_tail, __ATOMIC_ACQUIRE ))
+    {
+        cqe = ( struct io_uring_cqe * )record->io.cqes +
+              ( head & *record->io.cq_mask );
+        record_complete( record, cqe->user_data, cqe->res );
+        head++;
+        __atomic_store_n( record->io.cq_head, head, __ATOMIC_RELEASE );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Writer thread.
+//  ---------------------------------------------------------------------------
+/*
+    Submits chunks as they fill, up to RECORD_DEPTH at a time, and sleeps
+    when there is nothing to do. Once record_close stops it, the last part
+    chunk is written too.
+*/
+static void *record_writer( void *data )
+{
+    struct record_t *record = data;
+    struct timespec  idle = { 0, RECORD_IDLE };
+    uint64_t head, sent;
+    bool     running;
+
+    while ( true )
+    {
+        running = __atomic_load_n( &record->running, __ATOMIC_ACQUIRE );
+        head    = __atomic_load_n( &record->head, __ATOMIC_ACQUIRE );
+        sent    = record->submitted * RECORD_CHUNK;
+
+        // Submitted count passes head once the last part chunk is sent.
+        if (( record->flight < RECORD_DEPTH ) && ( head > sent ) &&
+            (( head - sent >= RECORD_CHUNK ) || !running ))
+        {
+            record_submit( record, ( head - sent >= RECORD_CHUNK ) ?
+                                   RECORD_CHUNK : head - sent );
+            continue;
+        }
+
+        if ( record->flight > 0 )
+            record_reap( record, true );
+        else if ( running )
+            nanosleep( &idle, NULL );
+        else
+            break;
+    }
+
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Opens a file and starts the writer thread.
+//  ---------------------------------------------------------------------------
+int8_t record_open( struct record_t *record, const char *name,
+                    uint32_t rate, uint8_t channels, uint8_t bits,
+                    enum record_format_t format )
+{
+    if (( name == NULL ) || ( rate == 0 ) || ( channels == 0 ) ||
+        ( channels > STREAM_CHANNELS_MAX ) ||
+        (( bits != 16 ) && ( bits != 24 ) && ( bits != 32 )) ||
+        ( format > RECORD_W64 )) return -1;
+
+    memset( record, 0, sizeof( struct record_t ));
+    record->rate     = rate;
+    record->channels = channels;
+    record->bits     = bits;
+    record->format   = format;
+
+    if ( posix_memalign(( void ** )&record->ring, RECORD_ALIGN,
+                        RECORD_RING ) != 0 ) return -2;
+    if ( posix_memalign(( void ** )&record->header, RECORD_ALIGN,
+                        RECORD_ALIGN ) != 0 )
+    {
+        free( record->ring );
+        return -2;
+    }
+
+    // Touch and lock the ring so the audio thread never page faults.
+    memset( record->ring, 0, RECORD_RING );
+    mlock( record->ring, RECORD_RING );
+
+    record->fd = open( name, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644 );
+    record->direct = ( record->fd >= 0 );
+    if ( !record->direct )
+        record->fd = open( name, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if ( record->fd < 0 ) goto fail;
+
+    record_header( record, 0 );
+    if ( record_write_header( record ) < 0 )
+    {
+        close( record->fd );
+        goto fail;
+    }
+
+    record->uring   = record_uring( record );
+    record->running = true;
+    if ( pthread_create( &record->thread, NULL, record_writer, record ) != 0 )
+    {
+        if ( record->uring ) record_uring_close( record );
+        close( record->fd );
+        goto fail;
+    }
+
+    return 0;
+
+fail:
+    munlock( record->ring, RECORD_RING );
+    free( record->ring );
+    free( record->header );
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Copies frames into the ring, from the audio thread.
+//  ---------------------------------------------------------------------------
+int8_t record_write( struct record_t *record, const void *samples,
+                     uint32_t frames )
+{
+    const uint32_t count = frames * record->channels;
+    const uint32_t bytes = count * record->bits / 8;
+    const int32_t *s32   = samples;
+    uint64_t head = record->head;
+    uint64_t tail = __atomic_load_n( &record->tail, __ATOMIC_ACQUIRE );
+    uint32_t pos, first, i;
+
+    if ( head + bytes - tail > RECORD_RING )
+    {
+        record->dropped++;
+        return -1;
+    }
+
+    pos = head & RECORD_MASK;
+    if ( record->bits == 24 )
+    {
+        // Pack low 3 bytes of each little endian sample.
+        for ( i = 0; i < count; i++ )
+        {
+            record->ring[pos] = s32[i];
+            record->ring[( pos + 1 ) & RECORD_MASK] = s32[i] >> 8;
+            record->ring[( pos + 2 ) & RECORD_MASK] = s32[i] >> 16;
+            pos = ( pos + 3 ) & RECORD_MASK;
+        }
+    }
+    else
+    {
+        first = RECORD_RING - pos;
+        if ( first > bytes ) first = bytes;
+        memcpy( record->ring + pos, samples, first );
+        memcpy( record->ring, ( const uint8_t * )samples + first,
+                bytes - first );
+    }
+
+    head += bytes;
+    __atomic_store_n( &record->head, head, __ATOMIC_RELEASE );
+    record->periods++;
+    if ( head - tail > record->worst ) record->worst = head - tail;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns bytes recorded so far.
+//  ---------------------------------------------------------------------------
+uint64_t record_bytes( struct record_t *record )
+{
+    return __atomic_load_n( &record->head, __ATOMIC_ACQUIRE );
+}
+
+//  ---------------------------------------------------------------------------
+//  Writes what is left, finishes the header and closes the file.
+//  ---------------------------------------------------------------------------
+/*
+    The last write was padded to a block, so the file is cut back to the
+    audio, plus a pad byte that RIFF needs if that is odd.
+*/
+int8_t record_close( struct record_t *record )
+{
+    uint64_t bytes = record->head;
+
+    __atomic_store_n( &record->running, false, __ATOMIC_RELEASE );
+    pthread_join( record->thread, NULL );
+    if ( record->uring ) record_uring_close( record );
+
+    record_header( record, bytes );
+    if ((( ftruncate( record->fd, RECORD_ALIGN + bytes +
+                      (( record->format == RECORD_WAV ) ? ( bytes & 1 ) : 0 ))
+           < 0 ) ||
+         ( record_write_header( record ) < 0 ) ||
+         ( fdatasync( record->fd ) < 0 )) && ( record->error == 0 ))
+        record->error = errno;
+    close( record->fd );
+
+    munlock( record->ring, RECORD_RING );
+    free( record->ring );
+    free( record->header );
+
+    return ( record->error == 0 ) ? 0 : -1;
+}
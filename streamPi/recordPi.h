@@ -0,0 +1,176 @@
+//  ===========================================================================
+/*
+    recordPi:
+
+    Records captured PCM to WAV or W64 files without blocking the audio
+    thread, for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Efficient IO with io_uring, J.Axboe.
+        - see https://kernel.dk/io_uring.pdf
+        Sony Wave64 file format specification.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef RECORDPI_H
+#define RECORDPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    The audio thread copies each capture period into a ring with
+    record_write, which never blocks or allocates. If the ring is full the
+    period is dropped and counted, but with the default ring that needs
+    the disk to stall for over 2s at 192kHz, 32 bit stereo.
+
+    Ring:
+
+    The ring is RECORD_CHUNKS chunks of RECORD_CHUNK bytes, allocated once,
+    locked in memory and registered with io_uring as fixed buffers. A
+    writer thread submits each chunk as it fills, straight from the ring,
+    with up to RECORD_DEPTH writes in flight. A chunk is only handed back
+    to the audio thread once its write completes, so nothing is copied
+    twice and a slow write holds up no more than its own chunk. If the
+    memory lock limit is too low to register the ring, chunks are written
+    with plain io_uring writes instead.
+
+    Files:
+
+    Files are opened with O_DIRECT where the filesystem allows it, so
+    recordings bypass the page cache instead of pushing everything else
+    out of RAM. O_DIRECT needs writes aligned to the block size, so the
+    header is padded with a JUNK chunk to fill the first RECORD_ALIGN
+    bytes and audio starts on a block boundary. The last chunk is written
+    padded to a block, then the file is cut to length and the header
+    rewritten with the final sizes.
+
+    WAV sizes are 32 bits, which limits a file to 4GB, about 3 hours at
+    192kHz, 32 bit stereo. W64 has 64 bit sizes and no limit.
+
+    Where io_uring isn't available, e.g. older kernels, the writer thread
+    uses pwrite instead. Where O_DIRECT isn't, e.g. tmpfs, each chunk is
+    flushed and dropped from the page cache once written.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define RECORD_CHUNK    262144  // Bytes per write.
+#define RECORD_CHUNKS   16      // Chunks in ring, power of 2.
+#define RECORD_RING     ( RECORD_CHUNK * RECORD_CHUNKS )
+#define RECORD_DEPTH    4       // Writes in flight.
+#define RECORD_ALIGN    4096    // O_DIRECT alignment, header size.
+
+enum record_format_t
+{
+    RECORD_WAV = 0,
+    RECORD_W64
+};
+
+//  Types. --------------------------------------------------------------------
+
+struct record_t
+{
+    int      fd;
+    uint32_t rate;
+    uint8_t  channels;
+    uint8_t  bits;                  // 16, 24 or 32.
+    uint8_t  format;                // record_format_t.
+    bool     direct;                // File opened with O_DIRECT.
+    bool     uring;                 // Writes use io_uring.
+
+    uint8_t *ring;                  // RECORD_RING bytes, aligned.
+    uint8_t *header;                // RECORD_ALIGN bytes, aligned.
+    uint64_t head;                  // Bytes written by audio thread.
+    uint64_t tail;                  // Bytes free to overwrite.
+    uint64_t submitted;             // Chunks submitted.
+    bool     done[RECORD_CHUNKS];   // Chunk written, out of order.
+    uint32_t length[RECORD_CHUNKS]; // Bytes being written from chunk.
+    uint8_t  flight;                // Writes in flight.
+
+    struct                          // io_uring, if uring is set.
+    {
+        int       fd;
+        bool      fixed;            // Ring registered as fixed buffers.
+        uint32_t *sq_head, *sq_tail, *sq_mask, *sq_array;
+        uint32_t *cq_head, *cq_tail, *cq_mask;
+        void     *sqes, *cqes;
+        void     *sq_ring, *cq_ring;
+        size_t    sq_size, cq_size, sqes_size;
+    } io;
+
+    pthread_t thread;
+    bool     running;
+    int      error;                 // First write error (errno), 0 if none.
+
+    double   slow;                  // Disk speed for testing (bytes/s).
+    double   stall;                 // Longest random stall for testing (s).
+
+    // Counters.
+    uint32_t periods;
+    uint32_t dropped;               // Periods lost to a full ring.
+    uint32_t worst;                 // Most bytes held in ring.
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Opens a file and starts the writer thread.
+//  ---------------------------------------------------------------------------
+/*
+    bits is the sample size in the file. Samples passed to record_write
+    are S16 for 16 bits and S32 or S24 in 32 bits, low aligned as ALSA
+    gives them, for 24 and 32 bits. 24 bits are packed to 3 bytes.
+    Returns 0 on success, -1 for invalid arguments or a file error, -2 if
+    out of memory.
+*/
+int8_t record_open( struct record_t *record, const char *name,
+                    uint32_t rate, uint8_t channels, uint8_t bits,
+                    enum record_format_t format );
+
+//  ---------------------------------------------------------------------------
+//  Copies frames into the ring, from the audio thread.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 if the ring is full and frames were dropped.
+*/
+int8_t record_write( struct record_t *record, const void *samples,
+                     uint32_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Returns bytes recorded so far.
+//  ---------------------------------------------------------------------------
+uint64_t record_bytes( struct record_t *record );
+
+//  ---------------------------------------------------------------------------
+//  Writes what is left, finishes the header and closes the file.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 if any write failed.
+*/
+int8_t record_close( struct record_t *record );
+
+#endif // #ifndef RECORDPI_H
@@ -0,0 +1,218 @@
+//  ===========================================================================
+/*
+    resamplePi:
+
+    Variable ratio resampler for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Digital Audio Resampling Home Page by Julius O. Smith III.
+        - see https://ccrma.stanford.edu/~jos/resample/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic resamplePi.c -lm
+        gcc -shared -o libresamplePi.so resamplePi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "resamplePi.h"
+
+#define HALF ( RESAMPLE_TAPS / 2 )
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns zeroth order modified Bessel function, for Kaiser window.
+//  ---------------------------------------------------------------------------
+static double resample_bessel( double x )
+{
+    double sum = 1;
+    double term = 1;
+    uint8_t k;
+
+    for ( k = 1; k < 32; k++ )
+    {
+        term *= ( x / ( 2 * k )) * ( x / ( 2 * k ));
+        sum  += term;
+    }
+
+    return sum;
+}
+
+//  ---------------------------------------------------------------------------
+//  Initialises resampler with a ratio of 1.
+//  ---------------------------------------------------------------------------
+/*
+    Row p holds the filter for an output p / RESAMPLE_PHASES of the way
+    from input frame HALF - 1 to HALF. Tap k is at distance
+    p / RESAMPLE_PHASES + HALF - 1 - k from the output. Rows are normalised
+    for unity gain at DC.
+*/
+int8_t resample_init( struct resample_t *resample, uint8_t channels )
+{
+    double   x, d, sinc, window, sum;
+    uint16_t p;
+    uint8_t  k;
+
+    if (( channels == 0 ) || ( channels > STREAM_CHANNELS_MAX )) return -1;
+
+    memset( resample, 0, sizeof( struct resample_t ));
+    resample->channels = channels;
+    resample->ratio    = 1;
+    resample->position = HALF - 1;
+
+    for ( p = 0; p <= RESAMPLE_PHASES; p++ )
+    {
+        for ( sum = 0, k = 0; k < RESAMPLE_TAPS; k++ )
+        {
+            d = ( double )p / RESAMPLE_PHASES + HALF - 1 - k;
+            x = 2 * RESAMPLE_CUTOFF * d;
+            sinc = ( x == 0 ) ? 1 : sin( M_PI * x ) / ( M_PI * x );
+            x = d / HALF;
+            window = ( fabs( x ) >= 1 ) ? 0 :
+                     resample_bessel( RESAMPLE_BETA * sqrt( 1 - x * x )) /
+                     resample_bessel( RESAMPLE_BETA );
+            resample->filter[p][k] = sinc * window;
+            sum += sinc * window;
+        }
+        for ( k = 0; k < RESAMPLE_TAPS; k++ )
+            resample->filter[p][k] /= sum;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Clears history and restarts at the first input frame, keeping the ratio.
+//  ---------------------------------------------------------------------------
+void resample_reset( struct resample_t *resample )
+{
+    memset( resample->history, 0, sizeof( resample->history ));
+    resample->position = HALF - 1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sets ratio of input to output frames.
+//  ---------------------------------------------------------------------------
+void resample_set_ratio( struct resample_t *resample, double ratio )
+{
+    if ( ratio < RESAMPLE_RATIO_MIN ) ratio = RESAMPLE_RATIO_MIN;
+    if ( ratio > RESAMPLE_RATIO_MAX ) ratio = RESAMPLE_RATIO_MAX;
+    resample->ratio = ratio;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns input frames needed for the next frames of output.
+//  ---------------------------------------------------------------------------
+/*
+    The last output at position t uses input up to floor( t ) + HALF, and
+    history already holds RESAMPLE_TAPS frames.
+*/
+uint32_t resample_needed( struct resample_t *resample, uint32_t frames )
+{
+    double last;
+
+    if ( frames == 0 ) return 0;
+    last = resample->position + ( frames - 1 ) * resample->ratio;
+
+    return ( uint32_t )floor( last ) + HALF + 1 - RESAMPLE_TAPS;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns fraction of an input frame held, for latency calculations.
+//  ---------------------------------------------------------------------------
+double resample_delay( struct resample_t *resample )
+{
+    return RESAMPLE_TAPS - resample->position;
+}
+
+//  ---------------------------------------------------------------------------
+//  Resamples input into frames of output.
+//  ---------------------------------------------------------------------------
+void resample_process( struct resample_t *resample, const float *in,
+                       uint32_t in_frames, float *out, uint32_t frames )
+{
+    const uint8_t channels = resample->channels;
+    float        *history = resample->history;
+    float         coef[RESAMPLE_TAPS];
+    float         acc[STREAM_CHANNELS_MAX];
+    const float  *base, *f0, *f1;
+    double        t;
+    float         phase, w;
+    uint32_t      i, j;
+    uint8_t       k, ch;
+
+    memcpy( history + RESAMPLE_TAPS * channels, in,
+            in_frames * channels * sizeof( float ));
+
+    for ( j = 0; j < frames; j++, out += channels )
+    {
+        t     = resample->position;
+        i     = ( uint32_t )t;
+        phase = ( t - i ) * RESAMPLE_PHASES;
+        f0    = resample->filter[( uint16_t )phase];
+        f1    = resample->filter[( uint16_t )phase + 1];
+        w     = phase - ( uint16_t )phase;
+        base  = history + ( i + 1 - HALF ) * channels;
+
+        for ( k = 0; k < RESAMPLE_TAPS; k++ )
+            coef[k] = f0[k] + w * ( f1[k] - f0[k] );
+
+        for ( ch = 0; ch < channels; ch++ ) acc[ch] = 0;
+        for ( k = 0; k < RESAMPLE_TAPS; k++, base += channels )
+            for ( ch = 0; ch < channels; ch++ )
+                acc[ch] += coef[k] * base[ch];
+        for ( ch = 0; ch < channels; ch++ ) out[ch] = acc[ch];
+
+        resample->position += resample->ratio;
+    }
+
+    // Keep last RESAMPLE_TAPS frames as history for next call.
+    memmove( history, history + in_frames * channels,
+             RESAMPLE_TAPS * channels * sizeof( float ));
+    resample->position -= in_frames;
+}
@@ -0,0 +1,136 @@
+//  ===========================================================================
+/*
+    resamplePi:
+
+    Variable ratio resampler for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        Digital Audio Resampling Home Page by Julius O. Smith III.
+        - see https://ccrma.stanford.edu/~jos/resample/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef RESAMPLEPI_H
+#define RESAMPLEPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    Bandlimited interpolation for small, continuously changing rate
+    differences, such as the drift between two sound card clocks.
+
+    Each output sample is the dot product of RESAMPLE_TAPS input samples
+    with a Kaiser windowed sinc, centred on the fractional input position.
+    The filter is tabulated at RESAMPLE_PHASES positions between input
+    samples and coefficients for positions in between are linearly
+    interpolated, so the ratio can change on every call without any
+    recalculation.
+
+    ratio is input frames per output frame. Input is consumed as needed, so
+    the caller asks resample_needed how many input frames the next block
+    of output will use, and passes exactly that many to resample_process.
+    The fractional position is kept in double so there is no drift over
+    hours of running.
+
+    Samples are interleaved floats and the history is held as
+    [frame][channel], so the inner loop runs across channels.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define RESAMPLE_TAPS         32 // Filter length (input frames).
+#define RESAMPLE_PHASES      256 // Filter positions per input frame.
+#define RESAMPLE_CUTOFF     0.45 // Pass band edge (fraction of rate).
+#define RESAMPLE_BETA        8.0 // Kaiser window shape.
+#define RESAMPLE_FRAMES_MAX 8192 // Max input frames per call.
+#define RESAMPLE_RATIO_MIN  0.99 // Ratio limits.
+#define RESAMPLE_RATIO_MAX  1.01
+
+//  Types. --------------------------------------------------------------------
+
+struct resample_t
+{
+    uint8_t channels;
+    double  ratio;      // Input frames per output frame.
+    double  position;   // Position of next output within history.
+
+    // Filter table, RESAMPLE_PHASES + 1 rows of RESAMPLE_TAPS.
+    float   filter[RESAMPLE_PHASES + 1][RESAMPLE_TAPS];
+
+    // Last RESAMPLE_TAPS input frames followed by new input.
+    float   history[( RESAMPLE_TAPS + RESAMPLE_FRAMES_MAX ) *
+                    STREAM_CHANNELS_MAX];
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises resampler with a ratio of 1.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 for invalid channels.
+*/
+int8_t resample_init( struct resample_t *resample, uint8_t channels );
+
+//  ---------------------------------------------------------------------------
+//  Clears history and restarts at the first input frame, keeping the ratio.
+//  ---------------------------------------------------------------------------
+/*
+    position is then the position of the first output within history, and
+    the caller may add a fraction of a frame to it.
+*/
+void resample_reset( struct resample_t *resample );
+
+//  ---------------------------------------------------------------------------
+//  Sets ratio of input to output frames.
+//  ---------------------------------------------------------------------------
+/*
+    ratio is clamped to RESAMPLE_RATIO_MIN and RESAMPLE_RATIO_MAX.
+*/
+void resample_set_ratio( struct resample_t *resample, double ratio );
+
+//  ---------------------------------------------------------------------------
+//  Returns input frames needed for the next frames of output.
+//  ---------------------------------------------------------------------------
+uint32_t resample_needed( struct resample_t *resample, uint32_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Returns fraction of an input frame held, for latency calculations.
+//  ---------------------------------------------------------------------------
+double resample_delay( struct resample_t *resample );
+
+//  ---------------------------------------------------------------------------
+//  Resamples input into frames of output.
+//  ---------------------------------------------------------------------------
+/*
+    in holds resample_needed( frames ) interleaved frames, at most
+    RESAMPLE_FRAMES_MAX.
+*/
+void resample_process( struct resample_t *resample, const float *in,
+                       uint32_t in_frames, float *out, uint32_t frames );
+
+#endif // #ifndef RESAMPLEPI_H
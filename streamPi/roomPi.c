@@ -0,0 +1,346 @@
+/*
+//  ===========================================================================
+
+    roomPi:
+
+    Plays one stream in phase in several rooms, using syncPi to send it
+    over UDP multicast.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc roomPi.c syncPi.c resamplePi.c -Wall -O3 -o roomPi
+            -lasound -lpthread -lm
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        roomPi -s [-c capture] [-g group] [-p port] [-i interface]
+                  [-r rate] [-n channels] [-l latency]
+
+        roomPi [-d playback] [-a server] [-g group] [-p port]
+               [-i interface] [-r rate] [-n channels] [-f period]
+
+    With -s, sends audio read from a capture device, e.g. a loopback cable
+    that squeezelite or mpd plays into, to every room. -c - reads raw S16
+    at the given rate from stdin instead, paced by the system clock, e.g.
+
+        sox music.flac -t raw -r 48000 -b 16 -c 2 - | roomPi -s -c -
+
+    Without -s, plays the stream in this room on a playback device. -a is
+    the address of the sender, which answers clock requests, and must be
+    given. -l is the lowest latency from sender to speakers (ms), which
+    rises by itself if any room needs more.
+
+    Network runs in its own thread on both sides. Receivers print how far
+    ahead the DAC is fed, the playout error and packets lost and late once
+    a second.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <alsa/asoundlib.h>
+
+#include "streamPi.h"
+#include "resamplePi.h"
+#include "syncPi.h"
+
+#define ROOM_RATE       48000
+#define ROOM_CHANNELS   2
+#define ROOM_PERIOD     256
+#define ROOM_PERIODS    4       // Periods per device buffer.
+#define ROOM_LATENCY    50      // Default latency (ms).
+
+static struct sync_sender_t   sender;
+static struct sync_receiver_t receiver;
+static snd_pcm_t *pcm;
+static int16_t s16[STREAM_PERIOD_MAX * SYNC_CHANNELS_MAX];
+static float   out[STREAM_PERIOD_MAX * SYNC_CHANNELS_MAX];
+static volatile bool running = true;
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Opens a PCM device.
+//  ---------------------------------------------------------------------------
+static int8_t roomOpen( const char *name, snd_pcm_stream_t direction,
+                        uint32_t rate, uint8_t channels, uint16_t period )
+{
+    int err;
+
+    err = snd_pcm_open( &pcm, name, direction, 0 );
+    if ( err < 0 )
+    {
+        fprintf( stderr, "Can't open %s: %s\n", name, snd_strerror( err ));
+        return -1;
+    }
+
+    // Receivers resample to the stream themselves.
+    err = snd_pcm_set_params( pcm, SND_PCM_FORMAT_S16_LE,
+                              SND_PCM_ACCESS_RW_INTERLEAVED, channels,
+                              rate, 0, 1000000ull * period *
+                              ROOM_PERIODS / rate );
+    if ( err < 0 )
+    {
+        fprintf( stderr, "Can't set %s: %s\n", name, snd_strerror( err ));
+        snd_pcm_close( pcm );
+        return -1;
+    }
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sender network thread, answers clock requests.
+//  ---------------------------------------------------------------------------
+static void *roomServe( void *data )
+{
+    while ( running ) sync_serve( &sender, 100 );
+
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Receiver network thread, collects packets and clock replies.
+//  ---------------------------------------------------------------------------
+static void *roomReceive( void *data )
+{
+    while ( running ) sync_receive( &receiver, 100 );
+
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sends from a capture device or stdin until interrupted.
+//  ---------------------------------------------------------------------------
+static int roomSend( const char *name, uint32_t rate, uint8_t channels )
+{
+    struct timespec ts;
+    pthread_t thread;
+    snd_pcm_sframes_t frames;
+    double   start = 0, next;
+    uint64_t total = 0;
+    bool     file = ( strcmp( name, "-" ) == 0 );
+
+    if ( !file && ( roomOpen( name, SND_PCM_STREAM_CAPTURE, rate, channels,
+                              ROOM_PERIOD ) < 0 )) return 1;
+    if ( pthread_create( &thread, NULL, roomServe, NULL ) != 0 ) return 1;
+
+    while ( running )
+    {
+        if ( file )
+        {
+            frames = fread( s16, channels * sizeof( int16_t ), ROOM_PERIOD,
+                            stdin );
+            if ( frames <= 0 ) break;
+
+            // Keep to the rate, as a capture device would.
+            if ( total == 0 ) start = sync_time();
+            total += frames;
+            next = start + ( double )total / rate;
+            ts.tv_sec  = next;
+            ts.tv_nsec = ( next - ts.tv_sec ) * 1e9;
+            clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL );
+        }
+        else
+        {
+            frames = snd_pcm_readi( pcm, s16, ROOM_PERIOD );
+            if ( frames < 0 )
+            {
+                if ( snd_pcm_recover( pcm, frames, 1 ) < 0 ) break;
+                continue;
+            }
+        }
+        sync_send( &sender, s16, frames, sync_time());
+    }
+
+    running = false;
+    pthread_join( thread, NULL );
+    if ( !file ) snd_pcm_close( pcm );
+    printf( "Sent %u packets, latency %.0fms.\n", sender.packets,
+            sync_latency( &sender ) * 1000 );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Plays stream on a playback device until interrupted.
+//  ---------------------------------------------------------------------------
+static int roomPlay( const char *name, uint32_t rate, uint8_t channels,
+                     uint16_t period )
+{
+    struct sched_param param = { .sched_priority = 50 };
+    pthread_t thread;
+    snd_pcm_sframes_t delay, frames;
+    double   now, next, present;
+    uint32_t count = period * channels;
+    uint32_t i;
+    float    s;
+
+    if ( roomOpen( name, SND_PCM_STREAM_PLAYBACK, rate, channels,
+                   period ) < 0 ) return 1;
+    if ( pthread_create( &thread, NULL, roomReceive, NULL ) != 0 ) return 1;
+    pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+
+    next = sync_local( &receiver );
+    while ( running )
+    {
+        // First frame of this period leaves after all those queued.
+        now = sync_local( &receiver );
+        if ( snd_pcm_delay( pcm, &delay ) < 0 ) delay = 0;
+        present = now + ( double )delay / rate;
+
+        sync_play( &receiver, out, period, present );
+        for ( i = 0; i < count; i++ )
+        {
+            s = out[i] * 32768;
+            s16[i] = ( s > 32767 ) ? 32767 : ( s < -32768 ) ? -32768 : s;
+        }
+
+        frames = snd_pcm_writei( pcm, s16, period );
+        if (( frames < 0 ) && ( snd_pcm_recover( pcm, frames, 1 ) < 0 ))
+            break;
+
+        if ( now >= next )
+        {
+            printf( "Lead %5.1fms   error %+6.3fms   packets %u   "
+                    "lost %u   late %u\n", receiver.lead * 1e-3,
+                    receiver.error * 1000, receiver.packets, receiver.lost,
+                    receiver.late );
+            fflush( stdout );
+            next += 1;
+        }
+    }
+
+    running = false;
+    pthread_join( thread, NULL );
+    snd_pcm_close( pcm );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Stops on interrupt.
+//  ---------------------------------------------------------------------------
+static void roomStop( int signal )
+{
+    running = false;
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    char    *captureName = "hw:1,0";
+    char    *playbackName = "hw:0,0";
+    char    *group = SYNC_GROUP;
+    char    *iface = NULL;
+    char    *server = NULL;
+    uint16_t port = SYNC_PORT;
+    uint32_t rate = ROOM_RATE;
+    uint8_t  channels = ROOM_CHANNELS;
+    uint16_t period = ROOM_PERIOD;
+    float    latency = ROOM_LATENCY;
+    bool     send = false;
+    int      result;
+    int      opt;
+
+    while (( opt = getopt( argc, argv, "sc:d:a:g:p:i:r:n:f:l:" )) != -1 )
+    {
+        switch ( opt )
+        {
+            case 's': send = true; break;
+            case 'c': captureName = optarg; break;
+            case 'd': playbackName = optarg; break;
+            case 'a': server = optarg; break;
+            case 'g': group = optarg; break;
+            case 'p': port = atoi( optarg ); break;
+            case 'i': iface = optarg; break;
+            case 'r': rate = atoi( optarg ); break;
+            case 'n': channels = atoi( optarg ); break;
+            case 'f': period = atoi( optarg ); break;
+            case 'l': latency = atof( optarg ); break;
+            default:
+                printf( "Usage: %s -s [-c capture] [-g group] [-p port] "
+                        "[-i interface]\n          [-r rate] [-n channels] "
+                        "[-l latency]\n       %s [-d playback] [-a server] "
+                        "[-g group] [-p port]\n          [-i interface] "
+                        "[-r rate] [-n channels] [-f period]\n",
+                        argv[0], argv[0] );
+                return 1;
+        }
+    }
+
+    signal( SIGINT, roomStop );
+    signal( SIGTERM, roomStop );
+
+    if ( send )
+    {
+        if ( sync_sender_open( &sender, group, port, iface, rate, channels,
+                               latency / 1000 ) < 0 )
+        {
+            fprintf( stderr, "Can't send to %s:%u.\n", group, port );
+            return 1;
+        }
+        printf( "%s -> %s:%u, %uHz, %u channels, latency %.0fms.\n",
+                captureName, group, port, rate, channels, latency );
+        result = roomSend( captureName, rate, channels );
+        sync_sender_close( &sender );
+        return result;
+    }
+
+    if (( server == NULL ) || ( period == 0 ) ||
+        ( period > STREAM_PERIOD_MAX ))
+    {
+        fprintf( stderr, "Sender address and a valid period are needed.\n" );
+        return 1;
+    }
+    if ( sync_receiver_open( &receiver, group, port, iface, server, rate,
+                             channels ) < 0 )
+    {
+        fprintf( stderr, "Can't receive from %s:%u.\n", group, port );
+        return 1;
+    }
+    printf( "%s:%u -> %s, %uHz, %u channels, period %u.\n", group, port,
+            playbackName, rate, channels, period );
+    result = roomPlay( playbackName, rate, channels, period );
+    sync_receiver_close( &receiver );
+
+    return result;
+}
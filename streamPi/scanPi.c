@@ -0,0 +1,554 @@
+/*
+//  ===========================================================================
+
+    scanPi:
+
+    Scans a music library for ReplayGain 2.0 / EBU R128 loudness and
+    writes a gainPi index.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc scanPi.c loudPi.c decodePi.c gainPi.c -Wall -O3 -o scanPi
+            -lpthread -lm
+
+    Also use the following flags for Raspberry Pi optimisation:
+
+        -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        scanPi [-o index] [-j threads] [-r rate] [-n channels] [-v] [-b]
+               directory...
+
+        scanPi [-o index] -q file
+
+    Finds every file a decodePi decoder knows under the directories,
+    measures each with loudPi and writes track and album gain for a
+    reference of -18 LUFS, sample peak, loudness and loudness range to a
+    gainPi index (default /var/lib/gainPi.idx). Files in the same
+    directory are taken to be an album. -r and -n give the format of raw
+    files. -v prints every file.
+
+    Files are shared out between -j threads (default one per core) in
+    runs of neighbouring files. A thread that runs out steals half of
+    what is left of the longest run, so threads stay busy to the end
+    however long the files. Threads share nothing else but a lock taken
+    once per file to add it to its album, so a scan should speed up
+    close to linearly with cores while the disk keeps up.
+
+    -b scans the files with 1 thread up to -j and prints the speed up,
+    without writing an index. Files are dropped from the page cache as
+    they are closed, so each pass reads from disk too.
+
+    -q looks a file up in the index and prints its values.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
+#include <ftw.h>
+#include <time.h>
+#include <math.h>
+
+#include "streamPi.h"
+#include "loudPi.h"
+#include "decodePi.h"
+#include "gainPi.h"
+
+#define SCAN_THREADS    64
+#define SCAN_FRAMES     4096    // Frames decoded at a time.
+
+//  Types. --------------------------------------------------------------------
+
+struct scan_file_t
+{
+    char    *path;
+    uint32_t album;
+    uint64_t frames;
+    uint32_t rate;
+    bool     ok;
+    struct gain_t gain;
+};
+
+struct scan_worker_t
+{
+    pthread_t thread;
+    uint64_t  range;            // First (low 32) and end (high 32) file.
+    uint32_t  files;
+    uint32_t  steals;
+    struct loud_t loud;
+    float     buffer[SCAN_FRAMES * STREAM_CHANNELS_MAX];
+};
+
+static struct scan_file_t   *files;
+static uint32_t              count, size;
+static struct loud_t       **albums;
+static uint32_t              album_count;
+static struct scan_worker_t *workers;
+static uint8_t               threads;
+static pthread_mutex_t       album_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t              raw_rate = DECODE_RAW_RATE;
+static uint8_t               raw_channels = DECODE_RAW_CHANNELS;
+static bool                  verbose = false;
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns wall clock time in seconds.
+//  ---------------------------------------------------------------------------
+static double scanTime( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//  ---------------------------------------------------------------------------
+//  Adds a file found by nftw to the list.
+//  ---------------------------------------------------------------------------
+static int scanFound( const char *path, const struct stat *st, int flag,
+                      struct FTW *ftw )
+{
+    struct scan_file_t *grown;
+
+    if (( flag != FTW_F ) || !decode_known( path )) return 0;
+    if ( count == size )
+    {
+        size  = size ? size * 2 : 1024;
+        grown = realloc( files, size * sizeof( struct scan_file_t ));
+        if ( grown == NULL ) return -1;
+        files = grown;
+    }
+    memset( &files[count], 0, sizeof( struct scan_file_t ));
+    files[count].path = strdup( path );
+    if ( files[count].path == NULL ) return -1;
+    count++;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Compares files by path, for qsort.
+//  ---------------------------------------------------------------------------
+static int scanCompare( const void *a, const void *b )
+{
+    return strcmp((( const struct scan_file_t * )a )->path,
+                  (( const struct scan_file_t * )b )->path );
+}
+
+//  ---------------------------------------------------------------------------
+//  Numbers albums, files being sorted so albums are together.
+//  ---------------------------------------------------------------------------
+static void scanAlbums( void )
+{
+    const char *slash, *last = NULL;
+    size_t   length, last_length = 0;
+    uint32_t i;
+
+    album_count = 0;
+    for ( i = 0; i < count; i++ )
+    {
+        slash  = strrchr( files[i].path, '/' );
+        length = slash ? slash - files[i].path : 0;
+        if (( last == NULL ) || ( length != last_length ) ||
+            strncmp( files[i].path, last, length ))
+            album_count++;
+        files[i].album = album_count - 1;
+        last        = files[i].path;
+        last_length = length;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Packs a range of files.
+//  ---------------------------------------------------------------------------
+static uint64_t scanRange( uint32_t first, uint32_t end )
+{
+    return first | (( uint64_t )end << 32 );
+}
+
+//  ---------------------------------------------------------------------------
+//  Takes next file from a worker's own range, -1 if none.
+//  ---------------------------------------------------------------------------
+static int64_t scanPop( struct scan_worker_t *worker )
+{
+    uint64_t range = __atomic_load_n( &worker->range, __ATOMIC_ACQUIRE );
+    uint32_t first, end;
+
+    do
+    {
+        first = range;
+        end   = range >> 32;
+        if ( first >= end ) return -1;
+    } while ( !__atomic_compare_exchange_n( &worker->range, &range,
+                                            scanRange( first + 1, end ),
+                                            true, __ATOMIC_ACQ_REL,
+                                            __ATOMIC_ACQUIRE ));
+
+    return first;
+}
+
+//  ---------------------------------------------------------------------------
+//  Steals the back half of the longest range left, returns false if none.
+//  ---------------------------------------------------------------------------
+/*
+    Owners take from the front and thieves from the back of a range, both
+    with one compare and swap on the packed range, so nothing is ever
+    taken twice and no locks are needed. Only a worker with an empty range
+    steals, and nobody steals from an empty range, so the thief can then
+    simply store its new range.
+*/
+static bool scanSteal( struct scan_worker_t *thief )
+{
+    struct scan_worker_t *victim;
+    uint64_t range;
+    uint32_t first, end, left, most, take;
+    uint8_t  i;
+
+    while ( true )
+    {
+        for ( victim = NULL, most = 0, i = 0; i < threads; i++ )
+        {
+            range = __atomic_load_n( &workers[i].range, __ATOMIC_ACQUIRE );
+            left  = ( uint32_t )( range >> 32 ) - ( uint32_t )range;
+            if (( uint32_t )range < ( uint32_t )( range >> 32 ) &&
+                ( left > most ))
+            {
+                most   = left;
+                victim = &workers[i];
+            }
+        }
+        if ( victim == NULL ) return false;
+
+        range = __atomic_load_n( &victim->range, __ATOMIC_ACQUIRE );
+        first = range;
+        end   = range >> 32;
+        if ( first >= end ) continue;
+        take = ( end - first + 1 ) / 2;
+        if ( __atomic_compare_exchange_n( &victim->range, &range,
+                                          scanRange( first, end - take ),
+                                          false, __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE ))
+        {
+            __atomic_store_n( &thief->range, scanRange( end - take, end ),
+                              __ATOMIC_RELEASE );
+            thief->steals++;
+            return true;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Measures one file and adds it to its album.
+//  ---------------------------------------------------------------------------
+static void scanFile( struct scan_worker_t *worker, struct scan_file_t *file )
+{
+    struct decode_t decode;
+    struct loud_t  *loud = &worker->loud;
+    struct loud_t  *album;
+    uint32_t frames;
+    double   lufs;
+
+    if ( decode_open( &decode, file->path, raw_rate, raw_channels ) < 0 )
+        return;
+    if ( loud_init( loud, decode.rate, decode.channels ) < 0 )
+    {
+        decode_close( &decode );
+        return;
+    }
+
+    while (( frames = decode_read( &decode, worker->buffer,
+                                   SCAN_FRAMES )) > 0 )
+    {
+        loud_add( loud, worker->buffer, frames );
+        file->frames += frames;
+    }
+    decode_close( &decode );
+
+    lufs = loud_integrated( loud );
+    file->rate             = decode.rate;
+    file->gain.key         = gain_key( file->path );
+    file->gain.loudness    = lufs;
+    file->gain.range       = loud_range( loud );
+    file->gain.track_gain  = isinf( lufs ) ? 0 : LOUD_REFERENCE - lufs;
+    file->gain.track_peak  = 20 * log10( loud_peak( loud ));
+    file->ok               = true;
+
+    pthread_mutex_lock( &album_lock );
+    album = albums[file->album];
+    if ( album == NULL )
+    {
+        album = malloc( sizeof( struct loud_t ));
+        if ( album != NULL )
+        {
+            memcpy( album, loud, sizeof( struct loud_t ));
+            albums[file->album] = album;
+        }
+    }
+    else
+        loud_merge( album, loud );
+    pthread_mutex_unlock( &album_lock );
+}
+
+//  ---------------------------------------------------------------------------
+//  Worker thread.
+//  ---------------------------------------------------------------------------
+static void *scanWorker( void *data )
+{
+    struct scan_worker_t *worker = data;
+    int64_t next;
+
+    while ( true )
+    {
+        next = scanPop( worker );
+        if ( next < 0 )
+        {
+            if ( !scanSteal( worker )) break;
+            continue;
+        }
+        scanFile( worker, &files[next] );
+        worker->files++;
+    }
+
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Scans all files with n threads, returns wall clock time.
+//  ---------------------------------------------------------------------------
+static double scanAll( uint8_t n )
+{
+    double   start;
+    uint32_t i;
+    uint8_t  t;
+
+    for ( i = 0; i < album_count; i++ )
+    {
+        free( albums[i] );
+        albums[i] = NULL;
+    }
+
+    // Runs of neighbouring files, so albums mostly stay on one thread.
+    threads = n;
+    for ( t = 0; t < n; t++ )
+    {
+        workers[t].files  = 0;
+        workers[t].steals = 0;
+        workers[t].range  = scanRange(( uint64_t )count * t / n,
+                                      ( uint64_t )count * ( t + 1 ) / n );
+    }
+
+    start = scanTime();
+    for ( t = 0; t < n; t++ )
+        if ( pthread_create( &workers[t].thread, NULL, scanWorker,
+                             &workers[t] ) != 0 )
+        {
+            // Others will steal its files.
+            workers[t].thread = 0;
+        }
+    for ( t = 0; t < n; t++ )
+        if ( workers[t].thread ) pthread_join( workers[t].thread, NULL );
+
+    return scanTime() - start;
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills in album gain and peak.
+//  ---------------------------------------------------------------------------
+static void scanAlbumGains( void )
+{
+    struct loud_t *album;
+    double   lufs;
+    uint32_t i;
+
+    for ( i = 0; i < count; i++ )
+    {
+        album = albums[files[i].album];
+        if ( !files[i].ok || ( album == NULL )) continue;
+        lufs = loud_integrated( album );
+        files[i].gain.album_gain = isinf( lufs ) ? 0 : LOUD_REFERENCE - lufs;
+        files[i].gain.album_peak = 20 * log10( loud_peak( album ));
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Prints values from an index.
+//  ---------------------------------------------------------------------------
+static int scanQuery( const char *index, const char *name )
+{
+    struct gain_index_t gi;
+    struct gain_t gain;
+    char     path[PATH_MAX];
+
+    if ( realpath( name, path ) == NULL ) snprintf( path, sizeof( path ),
+                                                    "%s", name );
+    if ( gain_open( &gi, index ) < 0 )
+    {
+        fprintf( stderr, "Can't read index %s.\n", index );
+        return 1;
+    }
+    if ( gain_lookup( &gi, path, &gain ) < 0 )
+    {
+        printf( "%s not in index.\n", path );
+        gain_close( &gi );
+        return 1;
+    }
+    printf( "%s\n  track gain %+.2fdB, peak %.2fdBFS\n"
+            "  album gain %+.2fdB, peak %.2fdBFS\n"
+            "  loudness %.2fLUFS, range %.2fLU\n", path, gain.track_gain,
+            gain.track_peak, gain.album_gain, gain.album_peak,
+            gain.loudness, gain.range );
+    gain_close( &gi );
+
+    return 0;
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    struct gain_t *gains;
+    char    *index = GAIN_INDEX;
+    char    *query = NULL;
+    char     root[PATH_MAX];
+    long     cores = sysconf( _SC_NPROCESSORS_ONLN );
+    uint8_t  n = ( cores < 1 ) ? 1 : ( cores > SCAN_THREADS ) ? SCAN_THREADS
+                                                              : cores;
+    bool     bench = false;
+    double   audio, time, single = 0;
+    uint32_t i, ok;
+    uint8_t  t;
+    int      opt;
+
+    while (( opt = getopt( argc, argv, "o:j:r:n:vbq:" )) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'o': index = optarg; break;
+            case 'j': n = atoi( optarg ); break;
+            case 'r': raw_rate = atoi( optarg ); break;
+            case 'n': raw_channels = atoi( optarg ); break;
+            case 'v': verbose = true; break;
+            case 'b': bench = true; break;
+            case 'q': query = optarg; break;
+            default:
+                printf( "Usage: %s [-o index] [-j threads] [-r rate] "
+                        "[-n channels] [-v] [-b]\n       directory...\n"
+                        "       %s [-o index] -q file\n", argv[0],
+                        argv[0] );
+                return 1;
+        }
+    }
+    if ( query != NULL ) return scanQuery( index, query );
+    if (( optind >= argc ) || ( n < 1 ) || ( n > SCAN_THREADS ))
+    {
+        fprintf( stderr, "Give directories to scan and 1 to %u threads.\n",
+                 SCAN_THREADS );
+        return 1;
+    }
+
+    // Full paths, as players will look them up.
+    for ( ; optind < argc; optind++ )
+    {
+        if (( realpath( argv[optind], root ) == NULL ) ||
+            ( nftw( root, scanFound, 16, FTW_PHYS ) < 0 ))
+        {
+            fprintf( stderr, "Can't scan %s.\n", argv[optind] );
+            return 1;
+        }
+    }
+    if ( count == 0 )
+    {
+        fprintf( stderr, "No files found.\n" );
+        return 1;
+    }
+    qsort( files, count, sizeof( struct scan_file_t ), scanCompare );
+    scanAlbums();
+
+    albums  = calloc( album_count, sizeof( struct loud_t * ));
+    workers = calloc( n, sizeof( struct scan_worker_t ));
+    gains   = malloc( count * sizeof( struct gain_t ));
+    if (( albums == NULL ) || ( workers == NULL ) || ( gains == NULL ))
+    {
+        fprintf( stderr, "Out of memory.\n" );
+        return 1;
+    }
+    printf( "%u files in %u albums.\n", count, album_count );
+
+    if ( bench )
+    {
+        printf( "Threads   Time (s)   Files/s   Speed up   Steals\n" );
+        for ( t = 1; t <= n; t++ )
+        {
+            for ( i = 0; i < count; i++ ) files[i].frames = 0;
+            time = scanAll( t );
+            if ( t == 1 ) single = time;
+            for ( ok = 0, i = 0; i < t; i++ ) ok += workers[i].steals;
+            printf( "%7u   %8.2f   %7.1f   %8.2f   %6u\n", t, time,
+                    count / time, single / time, ok );
+        }
+        return 0;
+    }
+
+    time = scanAll( n );
+    scanAlbumGains();
+
+    for ( audio = 0, ok = 0, i = 0; i < count; i++ )
+    {
+        if ( !files[i].ok )
+        {
+            fprintf( stderr, "Can't decode %s.\n", files[i].path );
+            continue;
+        }
+        audio += ( double )files[i].frames / files[i].rate;
+        gains[ok++] = files[i].gain;
+        if ( verbose )
+            printf( "%+6.2f %+6.2f %6.2f %6.2f %5.1f  %s\n",
+                    files[i].gain.track_gain, files[i].gain.album_gain,
+                    files[i].gain.track_peak, files[i].gain.loudness,
+                    files[i].gain.range, files[i].path );
+    }
+
+    printf( "%u files, %.1f hours of audio in %.1fs on %u threads, "
+            "%.0fx real time.\n", ok, audio / 3600, time, n, audio / time );
+    if ( gain_write( index, gains, ok ) < 0 )
+    {
+        fprintf( stderr, "Can't write index %s.\n", index );
+        return 1;
+    }
+    printf( "Index %s, %u bytes.\n", index, GAIN_HEADER + ok * GAIN_ENTRY );
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+//  ===========================================================================
+/*
+    streamPi:
+
+    Processing pipeline for PCM streams.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic streamPi.c
+        gcc -shared -o libstreamPi.so streamPi.o
+
+    Add -DSTREAM_FIXED for Q28 fixed point samples.
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises an empty stream.
+//  ---------------------------------------------------------------------------
+int8_t stream_init( struct stream_t *stream, uint32_t rate,
+                    uint8_t channels, uint16_t period )
+{
+    if (( rate == 0 ) || ( channels == 0 ) ||
+        ( channels > STREAM_CHANNELS_MAX ) ||
+        ( period == 0 ) || ( period > STREAM_PERIOD_MAX )) return -1;
+
+    memset( stream, 0, sizeof( struct stream_t ));
+    stream->format.rate     = rate;
+    stream->format.channels = channels;
+    stream->format.period   = period;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Appends a stage to the stream.
+//  ---------------------------------------------------------------------------
+int8_t stream_add( struct stream_t *stream, struct stream_stage_t *stage )
+{
+    if (( stream->stages >= STREAM_STAGES_MAX ) ||
+        ( stage->process == NULL )) return -1;
+
+    stream->stage[stream->stages++] = *stage;
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs all stages on frames of interleaved samples.
+//  ---------------------------------------------------------------------------
+void stream_process( struct stream_t *stream, sample_t *samples,
+                     uint32_t frames )
+{
+    uint16_t count;
+    uint8_t  i;
+
+    while ( frames > 0 )
+    {
+        count = ( frames > stream->format.period ) ?
+                  stream->format.period : frames;
+
+        for ( i = 0; i < stream->stages; i++ )
+            stream->stage[i].process( stream->stage[i].data,
+                                      samples, count );
+
+        samples += count * stream->format.channels;
+        frames  -= count;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Converts S16 samples to sample_t.
+//  ---------------------------------------------------------------------------
+void stream_from_s16( sample_t *out, const int16_t *in, uint32_t count )
+{
+    uint32_t i;
+
+    for ( i = 0; i < count; i++ )
+#ifdef STREAM_FIXED
+        out[i] = (int32_t)in[i] << ( STREAM_Q - 15 );
+#else
+        out[i] = in[i] * ( 1.0f / 32768.0f );
+#endif
+}
+
+//  ---------------------------------------------------------------------------
+//  Converts sample_t to S16 samples with rounding and clipping.
+//  ---------------------------------------------------------------------------
+void stream_to_s16( int16_t *out, const sample_t *in, uint32_t count )
+{
+    uint32_t i;
+    int32_t  s;
+
+    for ( i = 0; i < count; i++ )
+    {
+#ifdef STREAM_FIXED
+        s = ( in[i] + ( 1 << ( STREAM_Q - 16 ))) >> ( STREAM_Q - 15 );
+#else
+        float f = in[i] * 32768.0f;
+        s = (int32_t)( f + ( f < 0 ? -0.5f : 0.5f ));
+#endif
+        if ( s > 32767 ) s = 32767;
+        else if ( s < -32768 ) s = -32768;
+        out[i] = s;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Converts sample_t to S24 samples with rounding and clipping.
+//  ---------------------------------------------------------------------------
+void stream_to_s24( int32_t *out, const sample_t *in, uint32_t count )
+{
+    uint32_t i;
+    int32_t  s;
+
+    for ( i = 0; i < count; i++ )
+    {
+#ifdef STREAM_FIXED
+        s = ( in[i] + ( 1 << ( STREAM_Q - 24 ))) >> ( STREAM_Q - 23 );
+#else
+        float f = in[i] * 8388608.0f;
+        s = (int32_t)( f + ( f < 0 ? -0.5f : 0.5f ));
+#endif
+        if ( s > 8388607 ) s = 8388607;
+        else if ( s < -8388608 ) s = -8388608;
+        out[i] = s;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Frees all stages.
+//  ---------------------------------------------------------------------------
+void stream_free( struct stream_t *stream )
+{
+    uint8_t i;
+
+    for ( i = 0; i < stream->stages; i++ )
+        if ( stream->stage[i].free != NULL )
+            stream->stage[i].free( stream->stage[i].data );
+
+    stream->stages = 0;
+}
@@ -0,0 +1,163 @@
+//  ===========================================================================
+/*
+    streamPi:
+
+    Processing pipeline for PCM streams.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef STREAMPI_H
+#define STREAMPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    A stream is a list of stages that each process one period of audio in
+    place, so there are no copies between stages and no extra latency.
+
+    Samples are interleaved, in the same order as ALSA delivers them, and
+    are held as sample_t:
+
+        float       Default. 1.0 = full scale.
+        int32_t     Q28 fixed point if compiled with -DSTREAM_FIXED, for
+                    targets without an FPU. 1 << 28 = full scale, leaving
+                    18dB of headroom for gain between stages.
+
+    Stages keep per channel state in arrays indexed by channel, so the
+    inner loop of a stage runs across the channels of one frame and can be
+    vectorised by the compiler.
+
+    Stages must not allocate memory, take locks or make system calls in
+    their process function. All set up is done before the stage is added.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define STREAM_CHANNELS_MAX    8 // Max channels.
+#define STREAM_STAGES_MAX     16 // Max stages in a stream.
+#define STREAM_PERIOD_MAX   8192 // Max frames per period.
+
+#ifdef STREAM_FIXED
+    #define STREAM_Q          28
+    #define STREAM_ONE        ( 1 << STREAM_Q )
+    #define STREAM_MUL( a, b ) ((int32_t)((( int64_t )( a ) * ( b )) \
+                                           >> STREAM_Q ))
+    #define STREAM_FROM_FLOAT( f ) ((int32_t)(( f ) * STREAM_ONE ))
+    #define STREAM_TO_FLOAT( s ) (( float )( s ) / STREAM_ONE )
+#else
+    #define STREAM_ONE        1.0f
+    #define STREAM_MUL( a, b ) (( a ) * ( b ))
+    #define STREAM_FROM_FLOAT( f ) ( f )
+    #define STREAM_TO_FLOAT( s ) ( s )
+#endif
+
+//  Types. --------------------------------------------------------------------
+
+#ifdef STREAM_FIXED
+typedef int32_t sample_t;
+#else
+typedef float   sample_t;
+#endif
+
+struct stream_format_t
+{
+    uint32_t rate;          // Sample rate (Hz).
+    uint8_t  channels;      // Channels per frame.
+    uint16_t period;        // Max frames per call to process.
+};
+
+struct stream_stage_t
+{
+    const char *name;       // Name for reports.
+    void       *data;       // Stage data.
+
+    // Processes frames of interleaved samples in place.
+    void ( *process )( void *data, sample_t *samples, uint16_t frames );
+
+    // Frees stage data. May be NULL.
+    void ( *free )( void *data );
+};
+
+struct stream_t
+{
+    struct stream_format_t format;
+    struct stream_stage_t  stage[STREAM_STAGES_MAX];
+    uint8_t                stages;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Initialises an empty stream.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 for an invalid format.
+*/
+int8_t stream_init( struct stream_t *stream, uint32_t rate,
+                    uint8_t channels, uint16_t period );
+
+//  ---------------------------------------------------------------------------
+//  Appends a stage to the stream.
+//  ---------------------------------------------------------------------------
+/*
+    Returns 0 on success, -1 if the stream is full.
+*/
+int8_t stream_add( struct stream_t *stream, struct stream_stage_t *stage );
+
+//  ---------------------------------------------------------------------------
+//  Runs all stages on frames of interleaved samples.
+//  ---------------------------------------------------------------------------
+/*
+    frames above format.period are processed in several calls.
+*/
+void stream_process( struct stream_t *stream, sample_t *samples,
+                     uint32_t frames );
+
+//  ---------------------------------------------------------------------------
+//  Converts S16 samples to sample_t.
+//  ---------------------------------------------------------------------------
+void stream_from_s16( sample_t *out, const int16_t *in, uint32_t count );
+
+//  ---------------------------------------------------------------------------
+//  Converts sample_t to S16 samples with rounding and clipping.
+//  ---------------------------------------------------------------------------
+void stream_to_s16( int16_t *out, const sample_t *in, uint32_t count );
+
+//  ---------------------------------------------------------------------------
+//  Converts sample_t to S24 samples with rounding and clipping.
+//  ---------------------------------------------------------------------------
+/*
+    Output is S24_LE, i.e. 24 bits in the low bytes of 32 bit words.
+*/
+void stream_to_s24( int32_t *out, const sample_t *in, uint32_t count );
+
+//  ---------------------------------------------------------------------------
+//  Frees all stages.
+//  ---------------------------------------------------------------------------
+void stream_free( struct stream_t *stream );
+
+#endif // #ifndef STREAMPI_H
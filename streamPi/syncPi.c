@@ -0,0 +1,861 @@
+//  ===========================================================================
+/*
+    syncPi:
+
+    Synchronised multi-room streaming over UDP multicast for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        RFC 5905, Network Time Protocol Version 4.
+        RFC 3550, RTP: A Transport Protocol for Real-Time Applications.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    For a shared library, compile with:
+
+        gcc -c -Wall -fpic syncPi.c resamplePi.c -lm
+        gcc -shared -o libsyncPi.so syncPi.o resamplePi.o
+
+    For Raspberry Pi v1 optimisation use the following flags:
+
+        -march=armv6zk -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
+        -ffast-math -pipe -O3
+
+    For Raspberry Pi v2 optimisation use the following flags:
+
+        -march=armv7-a -mtune=cortex-a7 -mfloat-abi=hard -mfpu=neon-vfpv4
+        -ffast-math -pipe -O3
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+*/
+//  ===========================================================================
+
+//  Installed libraries -------------------------------------------------------
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <math.h>
+#include <poll.h>
+#include <unistd.h>
+#include <endian.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//  Local libraries -----------------------------------------------------------
+
+#include "streamPi.h"
+#include "resamplePi.h"
+#include "syncPi.h"
+
+//  Packets. ------------------------------------------------------------------
+/*
+    All fields are big endian. Times are ns on the sender's clock.
+
+    Audio:      "SPiA", channels (8), 0 (8), frames (16), rate (32),
+                first frame (64), presentation time (64), latency us (32),
+                then frames of S16 samples.
+
+    Request:    "SPiQ", id (32), latency needed us (32), t1 (64).
+
+    Reply:      "SPiR", id (32), t1 (64), t2 (64), t3 (64).
+*/
+
+#define SYNC_AUDIO      0x53506941
+#define SYNC_REQUEST    0x53506951
+#define SYNC_REPLY      0x53506952
+#define SYNC_HEADER     32
+#define SYNC_PACKET     ( SYNC_HEADER + \
+                          SYNC_FRAMES * SYNC_CHANNELS_MAX * 2 )
+#define SYNC_MASK       ( SYNC_SLOTS - 1 )
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Packs and unpacks big endian fields.
+//  ---------------------------------------------------------------------------
+static void sync_put32( uint8_t *p, uint32_t v )
+{
+    v = htobe32( v );
+    memcpy( p, &v, 4 );
+}
+
+static void sync_put64( uint8_t *p, uint64_t v )
+{
+    v = htobe64( v );
+    memcpy( p, &v, 8 );
+}
+
+static uint32_t sync_get32( const uint8_t *p )
+{
+    uint32_t v;
+
+    memcpy( &v, p, 4 );
+    return be32toh( v );
+}
+
+static uint64_t sync_get64( const uint8_t *p )
+{
+    uint64_t v;
+
+    memcpy( &v, p, 8 );
+    return be64toh( v );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns time on the monotonic clock in seconds.
+//  ---------------------------------------------------------------------------
+double sync_time( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//  ---------------------------------------------------------------------------
+//  Opens a sender.
+//  ---------------------------------------------------------------------------
+int8_t sync_sender_open( struct sync_sender_t *sender, const char *group,
+                         uint16_t port, const char *iface, uint32_t rate,
+                         uint8_t channels, double latency )
+{
+    struct sockaddr_in addr;
+    struct in_addr     local;
+    uint8_t ttl = 1;
+    uint8_t loop = 1;
+
+    if (( channels == 0 ) || ( channels > SYNC_CHANNELS_MAX ) ||
+        ( rate == 0 ) || ( latency <= 0 ) ||
+        ( latency > SYNC_LATENCY_MAX )) return -1;
+
+    memset( sender, 0, sizeof( struct sync_sender_t ));
+    sender->rate     = rate;
+    sender->channels = channels;
+    sender->latency  = sender->floor = lround( latency * 1e6 );
+    sender->group.sin_family = AF_INET;
+    sender->group.sin_port   = htons( port );
+    if ( inet_aton( group, &sender->group.sin_addr ) == 0 ) return -1;
+
+    sender->audio = socket( AF_INET, SOCK_DGRAM, 0 );
+    sender->clock = socket( AF_INET, SOCK_DGRAM, 0 );
+    if (( sender->audio < 0 ) || ( sender->clock < 0 )) goto fail;
+
+    setsockopt( sender->audio, IPPROTO_IP, IP_MULTICAST_TTL,
+                &ttl, sizeof( ttl ));
+    setsockopt( sender->audio, IPPROTO_IP, IP_MULTICAST_LOOP,
+                &loop, sizeof( loop ));
+    if ( iface != NULL )
+    {
+        if (( inet_aton( iface, &local ) == 0 ) ||
+            ( setsockopt( sender->audio, IPPROTO_IP, IP_MULTICAST_IF,
+                          &local, sizeof( local )) < 0 )) goto fail;
+    }
+
+    memset( &addr, 0, sizeof( addr ));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons( port + 1 );
+    addr.sin_addr.s_addr = htonl( INADDR_ANY );
+    if ( bind( sender->clock, ( struct sockaddr * )&addr,
+               sizeof( addr )) < 0 ) goto fail;
+
+    return 0;
+
+fail:
+    if ( sender->audio >= 0 ) close( sender->audio );
+    if ( sender->clock >= 0 ) close( sender->clock );
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Multicasts the packet held by the sender.
+//  ---------------------------------------------------------------------------
+static void sync_packet( struct sync_sender_t *sender )
+{
+    uint8_t  buffer[SYNC_PACKET];
+    uint64_t first = sender->frame - SYNC_FRAMES;
+    uint32_t latency = __atomic_load_n( &sender->latency, __ATOMIC_RELAXED );
+    uint32_t count = SYNC_FRAMES * sender->channels;
+    uint32_t i;
+    double   pts;
+
+    pts = sender->start + ( double )first / sender->rate + latency / 1e6;
+
+    sync_put32( buffer, SYNC_AUDIO );
+    buffer[4] = sender->channels;
+    buffer[5] = 0;
+    buffer[6] = SYNC_FRAMES >> 8;
+    buffer[7] = SYNC_FRAMES & 0xff;
+    sync_put32( buffer + 8, sender->rate );
+    sync_put64( buffer + 12, first );
+    sync_put64( buffer + 20, ( uint64_t )llround( pts * 1e9 ));
+    sync_put32( buffer + 28, latency );
+    for ( i = 0; i < count; i++ )
+    {
+        buffer[SYNC_HEADER + 2 * i]     = ( uint16_t )sender->packet[i] >> 8;
+        buffer[SYNC_HEADER + 2 * i + 1] = sender->packet[i] & 0xff;
+    }
+
+    sendto( sender->audio, buffer, SYNC_HEADER + count * 2, 0,
+            ( struct sockaddr * )&sender->group, sizeof( sender->group ));
+    sender->packets++;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sends interleaved frames, captured up to time now.
+//  ---------------------------------------------------------------------------
+void sync_send( struct sync_sender_t *sender, const int16_t *samples,
+                uint32_t frames, double now )
+{
+    const uint8_t channels = sender->channels;
+    double   error;
+    uint32_t count;
+
+    // Capture time of frame 0, following the capture clock.
+    error = now - ( sender->start +
+                    ( double )( sender->frame + frames ) / sender->rate );
+    if (( sender->frame == 0 ) || ( fabs( error ) > 0.1 ))
+        sender->start += error;
+    else
+        sender->start += error * 0.001;
+
+    while ( frames > 0 )
+    {
+        count = SYNC_FRAMES - sender->fill;
+        if ( count > frames ) count = frames;
+        memcpy( sender->packet + sender->fill * channels, samples,
+                count * channels * sizeof( int16_t ));
+        sender->fill  += count;
+        sender->frame += count;
+        samples       += count * channels;
+        frames        -= count;
+
+        if ( sender->fill == SYNC_FRAMES )
+        {
+            sync_packet( sender );
+            sender->fill = 0;
+        }
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Adapts shared latency to the needs of receivers.
+//  ---------------------------------------------------------------------------
+/*
+    Latency rises at once, in steps of SYNC_LATENCY_STEP, but only falls a
+    step at a time after 30s with every receiver SYNC_LATENCY_BAND steps
+    below, so need must move by more than a step to turn it round.
+*/
+static void sync_adapt( struct sync_sender_t *sender, double now )
+{
+    double  latency = sender->latency / 1e6;
+    double  need = 0;
+    uint8_t i;
+
+    for ( i = 0; i < SYNC_RECEIVERS_MAX; i++ )
+        if (( sender->receiver[i].id != 0 ) &&
+            ( now - sender->receiver[i].seen < 5 ) &&
+            ( sender->receiver[i].need > need ))
+            need = sender->receiver[i].need;
+
+    if ( need > latency )
+    {
+        latency = ceil( need / SYNC_LATENCY_STEP ) * SYNC_LATENCY_STEP;
+        if ( latency > SYNC_LATENCY_MAX ) latency = SYNC_LATENCY_MAX;
+        sender->lower = 0;
+    }
+    else if ( need < latency - SYNC_LATENCY_BAND * SYNC_LATENCY_STEP )
+    {
+        if ( sender->lower == 0 ) sender->lower = now;
+        else if ( now - sender->lower > 30 )
+        {
+            latency -= SYNC_LATENCY_STEP;
+            sender->lower = now;
+        }
+    }
+    else sender->lower = 0;
+
+    if ( latency * 1e6 < sender->floor ) latency = sender->floor / 1e6;
+    __atomic_store_n( &sender->latency, ( uint32_t )lround( latency * 1e6 ),
+                      __ATOMIC_RELAXED );
+}
+
+//  ---------------------------------------------------------------------------
+//  Answers clock requests for up to timeout ms.
+//  ---------------------------------------------------------------------------
+void sync_serve( struct sync_sender_t *sender, int timeout )
+{
+    struct pollfd      fd = { sender->clock, POLLIN, 0 };
+    struct sockaddr_in from;
+    socklen_t          length = sizeof( from );
+    uint8_t  buffer[64];
+    uint32_t id;
+    double   t2;
+    ssize_t  size;
+    uint8_t  i, slot;
+
+    if ( poll( &fd, 1, timeout ) <= 0 ) return;
+
+    size = recvfrom( sender->clock, buffer, sizeof( buffer ), 0,
+                     ( struct sockaddr * )&from, &length );
+    t2 = sync_time();
+    if (( size != 20 ) || ( sync_get32( buffer ) != SYNC_REQUEST )) return;
+    sender->requests++;
+
+    // Remember receiver's need, replacing the longest silent receiver.
+    id = sync_get32( buffer + 4 );
+    for ( slot = 0, i = 0; i < SYNC_RECEIVERS_MAX; i++ )
+    {
+        if ( sender->receiver[i].id == id )
+        {
+            slot = i;
+            break;
+        }
+        if ( sender->receiver[i].seen < sender->receiver[slot].seen )
+            slot = i;
+    }
+    sender->receiver[slot].id   = id;
+    sender->receiver[slot].need = sync_get32( buffer + 8 ) / 1e6;
+    sender->receiver[slot].seen = t2;
+    sync_adapt( sender, t2 );
+
+    memmove( buffer + 8, buffer + 12, 8 );
+    sync_put32( buffer, SYNC_REPLY );
+    sync_put64( buffer + 16, ( uint64_t )llround( t2 * 1e9 ));
+    sync_put64( buffer + 24, ( uint64_t )llround( sync_time() * 1e9 ));
+    sendto( sender->clock, buffer, 32, 0, ( struct sockaddr * )&from,
+            length );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns shared latency in seconds.
+//  ---------------------------------------------------------------------------
+double sync_latency( struct sync_sender_t *sender )
+{
+    return __atomic_load_n( &sender->latency, __ATOMIC_RELAXED ) / 1e6;
+}
+
+//  ---------------------------------------------------------------------------
+//  Closes a sender.
+//  ---------------------------------------------------------------------------
+void sync_sender_close( struct sync_sender_t *sender )
+{
+    close( sender->audio );
+    close( sender->clock );
+}
+
+//  ---------------------------------------------------------------------------
+//  Opens a receiver.
+//  ---------------------------------------------------------------------------
+int8_t sync_receiver_open( struct sync_receiver_t *receiver,
+                           const char *group, uint16_t port,
+                           const char *iface, const char *server,
+                           uint32_t rate, uint8_t channels )
+{
+    struct sockaddr_in addr;
+    struct ip_mreq     mreq;
+    double w = 2 * M_PI * SYNC_BANDWIDTH;
+    int    reuse = 1;
+
+    if (( channels == 0 ) || ( channels > SYNC_CHANNELS_MAX ) ||
+        ( rate == 0 )) return -1;
+
+    memset( receiver, 0, sizeof( struct sync_receiver_t ));
+    if ( resample_init( &receiver->resample, channels ) < 0 ) return -1;
+    receiver->rate     = rate;
+    receiver->channels = channels;
+    receiver->kp       = sqrt( 2 ) * w;
+    receiver->ki       = w * w;
+    receiver->ratio    = 1;
+    receiver->id       = ( getpid() << 16 ) ^ ( uint32_t )time( NULL ) ^
+                         ( uintptr_t )receiver;
+    if ( receiver->id == 0 ) receiver->id = 1;
+
+    receiver->server.sin_family = AF_INET;
+    receiver->server.sin_port   = htons( port + 1 );
+    memset( &addr, 0, sizeof( addr ));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons( port );
+    if (( inet_aton( server, &receiver->server.sin_addr ) == 0 ) ||
+        ( inet_aton( group, &addr.sin_addr ) == 0 )) return -1;
+    mreq.imr_multiaddr = addr.sin_addr;
+    mreq.imr_interface.s_addr = htonl( INADDR_ANY );
+    if (( iface != NULL ) &&
+        ( inet_aton( iface, &mreq.imr_interface ) == 0 )) return -1;
+
+    receiver->audio = socket( AF_INET, SOCK_DGRAM, 0 );
+    receiver->clock = socket( AF_INET, SOCK_DGRAM, 0 );
+    if (( receiver->audio < 0 ) || ( receiver->clock < 0 )) goto fail;
+
+    // Bound to the group, so other groups on the same port are not heard.
+    setsockopt( receiver->audio, SOL_SOCKET, SO_REUSEADDR,
+                &reuse, sizeof( reuse ));
+    if (( bind( receiver->audio, ( struct sockaddr * )&addr,
+                sizeof( addr )) < 0 ) ||
+        ( setsockopt( receiver->audio, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+                      &mreq, sizeof( mreq )) < 0 )) goto fail;
+
+    return 0;
+
+fail:
+    if ( receiver->audio >= 0 ) close( receiver->audio );
+    if ( receiver->clock >= 0 ) close( receiver->clock );
+    return -1;
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns time on the receiver's local clock in seconds.
+//  ---------------------------------------------------------------------------
+double sync_local( struct sync_receiver_t *receiver )
+{
+    return sync_time() * ( 1 + receiver->clock_ppm * 1e-6 ) +
+           receiver->clock_offset;
+}
+
+//  ---------------------------------------------------------------------------
+//  Starts and ends writes of values published to playout.
+//  ---------------------------------------------------------------------------
+static void sync_publish( struct sync_receiver_t *receiver, bool start )
+{
+    if ( start )
+    {
+        __atomic_store_n( &receiver->seq, receiver->seq + 1,
+                          __ATOMIC_RELAXED );
+        __atomic_thread_fence( __ATOMIC_RELEASE );
+    }
+    else
+        __atomic_store_n( &receiver->seq, receiver->seq + 1,
+                          __ATOMIC_RELEASE );
+}
+
+//  ---------------------------------------------------------------------------
+//  Estimates clock offset and drift from points.
+//  ---------------------------------------------------------------------------
+static void sync_fit( struct sync_receiver_t *receiver )
+{
+    struct sync_clock_t *est = &receiver->est;
+    double  tm = 0, om = 0, stt = 0, sto = 0;
+    double  slope = 0, ref, intercept = 0;
+    uint8_t i, k, recent;
+
+    if ( est->count == 0 )
+    {
+        sync_publish( receiver, true );
+        receiver->intercept = est->best_offset;
+        receiver->slope     = 0;
+        receiver->ref       = est->best_t;
+        receiver->synced    = ( est->total >= 4 );
+        sync_publish( receiver, false );
+        return;
+    }
+
+    // Drift from all points.
+    for ( i = 0; i < est->count; i++ )
+    {
+        tm += est->t[i];
+        om += est->offset[i];
+    }
+    tm /= est->count;
+    om /= est->count;
+    for ( i = 0; i < est->count; i++ )
+    {
+        stt += ( est->t[i] - tm ) * ( est->t[i] - tm );
+        sto += ( est->t[i] - tm ) * ( est->offset[i] - om );
+    }
+    if ( stt > 1 ) slope = sto / stt;
+    if ( slope > 1e-3 ) slope = 1e-3;
+    if ( slope < -1e-3 ) slope = -1e-3;
+
+    // Offset from recent points, moved forward to the newest.
+    recent = ( est->count < SYNC_CLOCK_RECENT ) ? est->count
+                                                : SYNC_CLOCK_RECENT;
+    ref = est->t[( est->pos + SYNC_CLOCK_POINTS - 1 ) % SYNC_CLOCK_POINTS];
+    for ( i = 1; i <= recent; i++ )
+    {
+        k = ( est->pos + SYNC_CLOCK_POINTS - i ) % SYNC_CLOCK_POINTS;
+        intercept += est->offset[k] + slope * ( ref - est->t[k] );
+    }
+    intercept /= recent;
+
+    sync_publish( receiver, true );
+    receiver->intercept = intercept;
+    receiver->slope     = slope;
+    receiver->ref       = ref;
+    receiver->synced    = ( est->total >= 4 );
+    sync_publish( receiver, false );
+}
+
+//  ---------------------------------------------------------------------------
+//  Returns sender time for a local time, from published values.
+//  ---------------------------------------------------------------------------
+static double sync_sender_time( struct sync_receiver_t *receiver, double t )
+{
+    return t + receiver->intercept + receiver->slope * ( t - receiver->ref );
+}
+
+//  ---------------------------------------------------------------------------
+//  Sends a clock request, with the latency this receiver needs.
+//  ---------------------------------------------------------------------------
+/*
+    Need is the worst transit of the last SYNC_TRANSIT seconds, leaving out
+    the worst eighth of them, plus a quarter for margin and the DAC lead.
+*/
+static void sync_request( struct sync_receiver_t *receiver, double now )
+{
+    uint8_t buffer[20];
+    double  worst[SYNC_TRANSIT];
+    double  need = 0, t;
+    uint8_t i, j, count = 0;
+
+    if ( receiver->synced )
+    {
+        // Seconds with packets, worst first.
+        for ( i = 0; i < SYNC_TRANSIT; i++ )
+        {
+            t = receiver->transit[i];
+            if ( t <= 0 ) continue;
+            for ( j = count++; ( j > 0 ) && ( worst[j - 1] < t ); j-- )
+                worst[j] = worst[j - 1];
+            worst[j] = t;
+        }
+        if ( count > 0 ) need = worst[count / 8];
+        need = 1.25 * need +
+               __atomic_load_n( &receiver->lead, __ATOMIC_RELAXED ) / 1e6 +
+               0.002;
+        if ( count > 0 )
+            __atomic_store_n( &receiver->need, lround( need * 1e6 ),
+                              __ATOMIC_RELAXED );
+    }
+
+    sync_put32( buffer, SYNC_REQUEST );
+    sync_put32( buffer + 4, receiver->id );
+    sync_put32( buffer + 8, lround( need * 1e6 ));
+    sync_put64( buffer + 12, ( uint64_t )llround( now * 1e9 ));
+    sendto( receiver->clock, buffer, sizeof( buffer ), 0,
+            ( struct sockaddr * )&receiver->server,
+            sizeof( receiver->server ));
+    receiver->requested = now;
+}
+
+//  ---------------------------------------------------------------------------
+//  Handles a clock reply.
+//  ---------------------------------------------------------------------------
+static void sync_reply( struct sync_receiver_t *receiver,
+                        const uint8_t *buffer, double t4 )
+{
+    struct sync_clock_t *est = &receiver->est;
+    double t1 = sync_get64( buffer + 8 ) / 1e9;
+    double t2 = sync_get64( buffer + 16 ) / 1e9;
+    double t3 = sync_get64( buffer + 24 ) / 1e9;
+    double offset, delay;
+
+    if ( sync_get32( buffer + 4 ) != receiver->id ) return;
+
+    offset = (( t2 - t1 ) + ( t3 - t4 )) / 2;
+    delay  = ( t4 - t1 ) - ( t3 - t2 );
+    receiver->replies++;
+    est->total++;
+
+    // Keep sample with least delay in group.
+    if (( est->samples == 0 ) || ( delay < est->best_delay ))
+    {
+        est->best_t      = t4;
+        est->best_offset = offset;
+        est->best_delay  = delay;
+    }
+    est->samples++;
+
+    // Group becomes a point. Until there is one, use the best so far.
+    if ( est->samples == SYNC_CLOCK_GROUP )
+    {
+        est->t[est->pos]      = est->best_t;
+        est->offset[est->pos] = est->best_offset;
+        est->pos = ( est->pos + 1 ) % SYNC_CLOCK_POINTS;
+        if ( est->count < SYNC_CLOCK_POINTS ) est->count++;
+        est->samples = 0;
+    }
+    else if ( est->count > 0 ) return;
+
+    sync_fit( receiver );
+}
+
+//  ---------------------------------------------------------------------------
+//  Stores an audio packet in the jitter buffer.
+//  ---------------------------------------------------------------------------
+static void sync_store( struct sync_receiver_t *receiver,
+                        const uint8_t *buffer, ssize_t size, double now )
+{
+    const uint32_t count = SYNC_FRAMES * receiver->channels;
+    struct sync_slot_t *slot;
+    uint64_t first;
+    uint32_t block, playing;
+    double   pts, latency, transit;
+    int64_t  second;
+    uint32_t i;
+
+    if (( size != SYNC_HEADER + count * 2 ) ||
+        ( buffer[4] != receiver->channels ) ||
+        ((( buffer[6] << 8 ) | buffer[7] ) != SYNC_FRAMES ) ||
+        ( sync_get32( buffer + 8 ) != receiver->rate )) return;
+
+    first   = sync_get64( buffer + 12 );
+    pts     = sync_get64( buffer + 20 ) / 1e9;
+    latency = sync_get32( buffer + 28 ) / 1e6;
+    block   = first / SYNC_FRAMES;
+    receiver->packets++;
+
+    playing = __atomic_load_n( &receiver->read_block, __ATOMIC_ACQUIRE );
+    if (( playing != 0 ) && (( int32_t )( block - playing ) < 0 ))
+    {
+        receiver->late++;
+        return;
+    }
+
+    // Slot is marked empty while it is written.
+    slot = &receiver->slot[block & SYNC_MASK];
+    __atomic_store_n( &slot->block, 0, __ATOMIC_RELEASE );
+    for ( i = 0; i < count; i++ )
+        slot->data[i] = ( int16_t )(( buffer[SYNC_HEADER + 2 * i] << 8 ) |
+                                    buffer[SYNC_HEADER + 2 * i + 1] );
+    __atomic_store_n( &slot->block, block + 1, __ATOMIC_RELEASE );
+
+    // Newest packet anchors the stream to the sender's clock.
+    if (( receiver->anchor_pts == 0 ) ||
+        (( int32_t )( block - receiver->newest ) > 0 ))
+    {
+        receiver->newest = block;
+        sync_publish( receiver, true );
+        receiver->anchor_frame   = first;
+        receiver->anchor_pts     = pts;
+        receiver->anchor_latency = latency;
+        sync_publish( receiver, false );
+    }
+
+    // Worst transit from capture each second, for the last SYNC_TRANSIT.
+    if ( !receiver->synced ) return;
+    transit = sync_sender_time( receiver, now ) - ( pts - latency );
+    second  = floor( now );
+    i       = second & ( SYNC_TRANSIT - 1 );
+    if ( second != receiver->second )
+    {
+        receiver->second     = second;
+        receiver->transit[i] = 0;
+    }
+    if ( transit > receiver->transit[i] ) receiver->transit[i] = transit;
+}
+
+//  ---------------------------------------------------------------------------
+//  Receives packets and makes clock requests for up to timeout ms.
+//  ---------------------------------------------------------------------------
+/*
+    Requests are made five times as often until there is one point, so the
+    clock is known quickly.
+*/
+void sync_receive( struct sync_receiver_t *receiver, int timeout )
+{
+    struct pollfd fd[2] =
+        {{ receiver->audio, POLLIN, 0 }, { receiver->clock, POLLIN, 0 }};
+    uint8_t buffer[SYNC_PACKET];
+    double  interval = SYNC_CLOCK_INTERVAL;
+    double  now = sync_local( receiver );
+    double  wait;
+    ssize_t size;
+
+    if ( receiver->est.total < SYNC_CLOCK_GROUP ) interval /= 5;
+    if ( now - receiver->requested >= interval )
+        sync_request( receiver, now );
+
+    wait = ( receiver->requested + interval - now ) * 1000;
+    if ( wait < timeout ) timeout = ( wait < 0 ) ? 0 : ceil( wait );
+    if ( poll( fd, 2, timeout ) <= 0 ) return;
+
+    if ( fd[0].revents & POLLIN )
+    {
+        size = recv( receiver->audio, buffer, sizeof( buffer ), 0 );
+        if (( size >= SYNC_HEADER ) && ( sync_get32( buffer ) == SYNC_AUDIO ))
+            sync_store( receiver, buffer, size, sync_local( receiver ));
+    }
+    if ( fd[1].revents & POLLIN )
+    {
+        size = recv( receiver->clock, buffer, sizeof( buffer ), 0 );
+        now  = sync_local( receiver );
+        if (( size == 32 ) && ( sync_get32( buffer ) == SYNC_REPLY ))
+            sync_reply( receiver, buffer, now );
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Copies frames from the jitter buffer, with silence for missing packets.
+//  ---------------------------------------------------------------------------
+static void sync_fetch( struct sync_receiver_t *receiver, float *out,
+                        uint64_t frame, uint32_t frames )
+{
+    const uint8_t channels = receiver->channels;
+    struct sync_slot_t *slot;
+    uint32_t block, offset, count, i;
+
+    while ( frames > 0 )
+    {
+        block  = frame / SYNC_FRAMES;
+        offset = frame % SYNC_FRAMES;
+        count  = SYNC_FRAMES - offset;
+        if ( count > frames ) count = frames;
+        slot = &receiver->slot[block & SYNC_MASK];
+
+        if ( __atomic_load_n( &slot->block, __ATOMIC_ACQUIRE ) == block + 1 )
+        {
+            for ( i = 0; i < count * channels; i++ )
+                out[i] = slot->data[offset * channels + i] *
+                         ( 1.0f / 32768 );
+        }
+        else
+        {
+            memset( out, 0, count * channels * sizeof( float ));
+            if ( block != receiver->missing )
+            {
+                receiver->missing = block;
+                receiver->lost++;
+            }
+        }
+
+        out    += count * channels;
+        frame  += count;
+        frames -= count;
+    }
+}
+
+//  ---------------------------------------------------------------------------
+//  Fills a period of output for the DAC.
+//  ---------------------------------------------------------------------------
+int8_t sync_play( struct sync_receiver_t *receiver, float *out,
+                  uint16_t frames, double present )
+{
+    struct resample_t *resample = &receiver->resample;
+    const double dt = ( double )frames / receiver->rate;
+    const double limit = SYNC_PPM_MAX * 1e-6;
+    uint64_t anchor_frame;
+    double   anchor_pts, anchor_latency, sender, desired, actual, base;
+    double   slew, correction, slope;
+    uint32_t seq, needed, lead, need;
+    bool     synced;
+
+    // DAC lead, for the latency this receiver needs.
+    lead = fmax( present - sync_local( receiver ), 0 ) * 1e6;
+    if ( lead > __atomic_load_n( &receiver->lead, __ATOMIC_RELAXED ))
+        __atomic_store_n( &receiver->lead, lead, __ATOMIC_RELAXED );
+
+    do
+    {
+        seq            = __atomic_load_n( &receiver->seq,
+                                          __ATOMIC_ACQUIRE );
+        synced         = receiver->synced;
+        sender         = sync_sender_time( receiver, present );
+        slope          = receiver->slope;
+        anchor_frame   = receiver->anchor_frame;
+        anchor_pts     = receiver->anchor_pts;
+        anchor_latency = receiver->anchor_latency;
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    } while (( seq & 1 ) ||
+             ( seq != __atomic_load_n( &receiver->seq, __ATOMIC_RELAXED )));
+
+    // Move latency played towards the sender's at SYNC_SLEW.
+    if ( !receiver->playing ) receiver->latency = anchor_latency;
+    slew = anchor_latency - receiver->latency;
+    if ( slew > SYNC_SLEW * 1e-6 * dt ) slew = SYNC_SLEW * 1e-6 * dt;
+    if ( slew < -SYNC_SLEW * 1e-6 * dt ) slew = -SYNC_SLEW * 1e-6 * dt;
+    receiver->latency += slew;
+
+    // Frame that should leave the DAC at present. Wait for a latency that
+    // covers this receiver's need before starting.
+    desired = anchor_frame + ( sender - anchor_pts + anchor_latency -
+                               receiver->latency ) * receiver->rate;
+    need    = __atomic_load_n( &receiver->need, __ATOMIC_RELAXED );
+    if ( !synced || ( anchor_pts == 0 ) || ( desired < RESAMPLE_TAPS ) ||
+         ( !receiver->playing && (( need == 0 ) ||
+           (( anchor_latency * 1e6 < need ) &&
+            ( anchor_latency < SYNC_LATENCY_MAX )))))
+    {
+        memset( out, 0, frames * receiver->channels * sizeof( float ));
+        return 1;
+    }
+
+    actual = ( double )receiver->read_frame - RESAMPLE_TAPS +
+             resample->position;
+    if ( !receiver->playing ||
+         ( fabs( actual - desired ) > SYNC_RESYNC * receiver->rate ))
+    {
+        // Jump to desired frame, with history from the jitter buffer.
+        resample_reset( resample );
+        base = floor( desired );
+        receiver->read_frame = base + RESAMPLE_TAPS - resample->position;
+        resample->position  += desired - base;
+        sync_fetch( receiver, resample->history,
+                    receiver->read_frame - RESAMPLE_TAPS, RESAMPLE_TAPS );
+        receiver->playing = true;
+        receiver->resyncs++;
+        actual = desired;
+        receiver->dac_start  = present;
+        receiver->dac_frames = 0;
+    }
+
+    // Ahead of the sender, so read input more slowly. A rising latency
+    // also reads more slowly, outside the controller.
+    receiver->error = ( actual - desired ) / receiver->rate;
+    receiver->integral += receiver->ki * receiver->error * dt;
+    if ( receiver->integral > limit ) receiver->integral = limit;
+    if ( receiver->integral < -limit ) receiver->integral = -limit;
+    correction = receiver->integral + receiver->kp * receiver->error +
+                 slew / dt;
+    if ( correction > limit ) correction = limit;
+    if ( correction < -limit ) correction = -limit;
+    receiver->ratio = 1 - correction;
+    resample_set_ratio( resample, receiver->ratio );
+    receiver->position = actual;
+
+    // Drift from sender and DAC clocks, both over the longest time known.
+    if ( present > receiver->dac_start )
+        receiver->drift = ( 1 + slope ) * ( present - receiver->dac_start ) *
+                          receiver->rate / receiver->dac_frames - 1;
+    receiver->dac_frames += frames;
+
+    needed = resample_needed( resample, frames );
+    sync_fetch( receiver, receiver->in, receiver->read_frame, needed );
+    resample_process( resample, receiver->in, needed, out, frames );
+    receiver->read_frame += needed;
+    __atomic_store_n( &receiver->read_block,
+                      ( uint32_t )( receiver->read_frame / SYNC_FRAMES ),
+                      __ATOMIC_RELEASE );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Closes a receiver.
+//  ---------------------------------------------------------------------------
+void sync_receiver_close( struct sync_receiver_t *receiver )
+{
+    close( receiver->audio );
+    close( receiver->clock );
+}
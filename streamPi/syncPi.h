@@ -0,0 +1,325 @@
+//  ===========================================================================
+/*
+    syncPi:
+
+    Synchronised multi-room streaming over UDP multicast for streamPi.
+
+    Copyright 2026 agent <agent@local>
+
+    Based on the following guides and codes:
+        RFC 5905, Network Time Protocol Version 4.
+        RFC 3550, RTP: A Transport Protocol for Real-Time Applications.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+//  ===========================================================================
+/*
+    Authors:        agent               18/10/2026
+
+    Contributors:
+
+    Changelog:
+
+        v01.00      Original version.
+*/
+//  ===========================================================================
+
+#ifndef SYNCPI_H
+#define SYNCPI_H
+
+//  Info. ---------------------------------------------------------------------
+/*
+    One sender multicasts S16 PCM to any number of receivers, one per room.
+    Every packet carries the index of its first frame and the time, on the
+    sender's clock, at which that frame should leave every DAC. That time
+    is the capture time plus a latency that is the same for all rooms, so
+    rooms play in phase however far each one is from the sender.
+
+    Clocks:
+
+    Each receiver sends a clock request to the sender every
+    SYNC_CLOCK_INTERVAL and times the reply, as NTP does:
+
+        offset = (( t2 - t1 ) + ( t3 - t4 )) / 2
+        delay  = ( t4 - t1 ) - ( t3 - t2 )
+
+    Requests delayed by queues give a large delay and an offset in error by
+    up to half of it, so only the sample with least delay from each group
+    of SYNC_CLOCK_GROUP is kept. Drift between the clocks is the slope of a
+    straight line fitted through the last SYNC_CLOCK_POINTS of these, i.e.
+    over about a minute, where noise hardly affects it. Offset is taken
+    from the last SYNC_CLOCK_RECENT only, moved forward by the drift.
+
+    Playout:
+
+    For each DAC period, the receiver is told when its first frame will
+    leave the DAC, converts that to the sender's clock and works out which
+    frame should be playing. The difference from the frame that is playing
+    drives a PI controller that sets the ratio of a resamplePi resampler,
+    which takes up the drift between the DAC clock and the sender. An error
+    over SYNC_RESYNC jumps straight to the right frame.
+
+    The controller's integral follows the drift but also every small step
+    in the clock offset, so it is a poor measure of it. Instead, drift is
+    found from the slope of the clock fit and the rate the DAC is seen to
+    play at, from the frames it has played since it started and its
+    present time now.
+
+    Changes to the shared latency are not jumped. Each receiver moves the
+    latency it plays towards the new one at SYNC_SLEW, by adding the rate
+    of change to the resampler ratio, so playback speeds up or slows down
+    by a fraction of a cent until it gets there. Every room slews at the
+    same rate from almost the same moment, so rooms stay in phase.
+
+    Jitter buffer:
+
+    Packets are held in SYNC_SLOTS slots by frame index, so they can arrive
+    late or out of order. Missing packets play as silence. The receiver
+    measures how long packets take to arrive, on top of how far ahead its
+    DAC is fed, and reports the latency it needs with each clock request.
+    Need comes from the worst transit in each of the last SYNC_TRANSIT
+    seconds, leaving out the worst eighth of them, so a short stall does
+    not raise the latency for every room. The sender raises the shared
+    latency at once to the largest need of any receiver, and lowers it a
+    step at a time once every need has been SYNC_LATENCY_BAND steps below
+    it for a while. A receiver only starts playing once the shared latency
+    covers its own need, so it doesn't start with a latency that is about
+    to be raised.
+
+    Threads:
+
+    sync_send and sync_serve may be called from different threads, as may
+    sync_receive and sync_play. Shared values are handed over with atomics
+    and seqlocks, so neither side waits for the other.
+
+    Receivers have their own local clock, which is the monotonic clock
+    unless clock_offset or clock_ppm are set for testing several rooms on
+    one machine.
+*/
+
+//  Macros. -------------------------------------------------------------------
+
+#define SYNC_GROUP          "239.255.58.1" // Default multicast group.
+#define SYNC_PORT           5858    // Audio port, clock port is +1.
+#define SYNC_CHANNELS_MAX   2       // Max channels.
+#define SYNC_FRAMES         256     // Frames per packet.
+#define SYNC_SLOTS          512     // Jitter buffer packets, power of 2.
+#define SYNC_LATENCY        0.05    // Default latency (s).
+#define SYNC_LATENCY_MAX    0.5     // Max latency (s).
+#define SYNC_LATENCY_STEP   0.005   // Latency changes (s).
+#define SYNC_LATENCY_BAND   3       // Steps of need below latency to lower.
+#define SYNC_SLEW           500     // Rate latency changes are played (ppm).
+#define SYNC_TRANSIT        32      // Seconds of transit, power of 2.
+#define SYNC_CLOCK_GROUP    16      // Clock samples for each point.
+#define SYNC_CLOCK_POINTS   32      // Points for drift.
+#define SYNC_CLOCK_RECENT   4       // Points for offset.
+#define SYNC_CLOCK_INTERVAL 0.125   // Time between clock requests (s).
+#define SYNC_RESYNC         0.005   // Error to jump to the right frame (s).
+#define SYNC_BANDWIDTH      0.1     // Playout control bandwidth (Hz).
+#define SYNC_PPM_MAX        1000    // Playout correction limit (ppm).
+#define SYNC_RECEIVERS_MAX  16      // Receivers the sender adapts to.
+
+//  Types. --------------------------------------------------------------------
+
+struct sync_clock_t
+{
+    double   best_t;                    // Sample with least delay so far.
+    double   best_offset;
+    double   best_delay;
+    uint8_t  samples;                   // Samples in group so far.
+    uint32_t total;                     // Samples ever.
+
+    double   t[SYNC_CLOCK_POINTS];      // Local time of reply.
+    double   offset[SYNC_CLOCK_POINTS]; // Sender - local.
+    uint8_t  count;
+    uint8_t  pos;
+};
+
+struct sync_slot_t
+{
+    uint32_t block;                 // Frame / SYNC_FRAMES + 1, 0 if empty.
+    int16_t  data[SYNC_FRAMES * SYNC_CHANNELS_MAX];
+};
+
+struct sync_sender_t
+{
+    int      audio;                 // Multicast socket.
+    int      clock;                 // Clock request socket.
+    struct sockaddr_in group;
+    uint32_t rate;
+    uint8_t  channels;
+
+    uint64_t frame;                 // Next frame to send.
+    double   start;                 // Capture time of frame 0.
+    uint32_t latency;               // Shared latency (us).
+    uint32_t floor;                 // Lowest latency (us).
+    double   lower;                 // Time latency could first be lower.
+
+    int16_t  packet[SYNC_FRAMES * SYNC_CHANNELS_MAX];
+    uint16_t fill;                  // Frames in packet.
+
+    struct
+    {
+        uint32_t id;
+        double   need;              // Latency needed (s).
+        double   seen;              // Time of last request.
+    } receiver[SYNC_RECEIVERS_MAX];
+
+    uint32_t packets;
+    uint32_t requests;
+};
+
+struct sync_receiver_t
+{
+    int      audio;                 // Multicast socket.
+    int      clock;                 // Clock request socket.
+    struct sockaddr_in server;      // Sender clock address.
+    uint32_t id;
+    uint32_t rate;
+    uint8_t  channels;
+
+    double   clock_offset;          // Local clock, for testing.
+    double   clock_ppm;
+
+    // Network thread.
+    struct sync_clock_t est;
+    double   requested;             // Time of last request.
+    double   transit[SYNC_TRANSIT]; // Worst packet transit each second.
+    int64_t  second;
+    uint32_t newest;                // Newest block received.
+
+    // Published to playout by seqlock.
+    uint32_t seq;
+    double   intercept, slope, ref; // Offset = intercept + slope ( t - ref ).
+    bool     synced;
+    uint64_t anchor_frame;          // Newest packet.
+    double   anchor_pts;
+    double   anchor_latency;
+
+    // Published to network thread by atomics.
+    uint32_t lead;                  // Worst DAC lead (us).
+    uint32_t read_block;            // Block being played.
+    uint32_t need;                  // Latency needed (us), to playout.
+
+    struct sync_slot_t slot[SYNC_SLOTS];
+
+    // Playout thread.
+    bool     playing;
+    uint64_t read_frame;            // Next frame into resampler.
+    double   kp, ki, integral, ratio;
+    double   latency;               // Latency played, slewing to sender's.
+    double   drift;                 // Sender frames per DAC frame, less 1.
+    double   dac_start;             // Local time DAC started (s).
+    uint64_t dac_frames;            // Frames played since.
+    double   position;              // Frame of last output.
+    double   error;                 // Last playout error (s).
+    uint32_t missing;               // Last block found missing.
+    struct resample_t resample;
+    float    in[RESAMPLE_FRAMES_MAX * SYNC_CHANNELS_MAX];
+
+    // Counters.
+    uint32_t packets;
+    uint32_t late;                  // Packets after their time.
+    uint32_t lost;                  // Packets played as silence.
+    uint32_t resyncs;
+    uint32_t replies;
+};
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns time on the monotonic clock in seconds.
+//  ---------------------------------------------------------------------------
+double sync_time( void );
+
+//  ---------------------------------------------------------------------------
+//  Opens a sender.
+//  ---------------------------------------------------------------------------
+/*
+    group and port are the multicast address, and clock requests are
+    answered on port + 1. iface is the address of the interface to send
+    from, NULL for the default. latency is the lowest shared latency (s).
+    Returns 0 on success, -1 for invalid arguments or a socket error.
+*/
+int8_t sync_sender_open( struct sync_sender_t *sender, const char *group,
+                         uint16_t port, const char *iface, uint32_t rate,
+                         uint8_t channels, double latency );
+
+//  ---------------------------------------------------------------------------
+//  Sends interleaved frames, captured up to time now.
+//  ---------------------------------------------------------------------------
+/*
+    Frames are sent in packets of SYNC_FRAMES. The capture time of each
+    frame follows from its index and the rate, and is pulled slowly
+    towards now so the stream keeps time with a capture clock that drifts.
+    A gap of over 0.1s, e.g. after a pause, restarts the timing.
+*/
+void sync_send( struct sync_sender_t *sender, const int16_t *samples,
+                uint32_t frames, double now );
+
+//  ---------------------------------------------------------------------------
+//  Answers clock requests for up to timeout ms.
+//  ---------------------------------------------------------------------------
+void sync_serve( struct sync_sender_t *sender, int timeout );
+
+//  ---------------------------------------------------------------------------
+//  Returns shared latency in seconds.
+//  ---------------------------------------------------------------------------
+double sync_latency( struct sync_sender_t *sender );
+
+//  ---------------------------------------------------------------------------
+//  Closes a sender.
+//  ---------------------------------------------------------------------------
+void sync_sender_close( struct sync_sender_t *sender );
+
+//  ---------------------------------------------------------------------------
+//  Opens a receiver.
+//  ---------------------------------------------------------------------------
+/*
+    group and port are the multicast address and server is the address of
+    the sender, which answers clock requests on port + 1. iface is the
+    address of the interface to join the group on, NULL for the default.
+    Returns 0 on success, -1 for invalid arguments or a socket error.
+*/
+int8_t sync_receiver_open( struct sync_receiver_t *receiver,
+                           const char *group, uint16_t port,
+                           const char *iface, const char *server,
+                           uint32_t rate, uint8_t channels );
+
+//  ---------------------------------------------------------------------------
+//  Returns time on the receiver's local clock in seconds.
+//  ---------------------------------------------------------------------------
+double sync_local( struct sync_receiver_t *receiver );
+
+//  ---------------------------------------------------------------------------
+//  Receives packets and makes clock requests for up to timeout ms.
+//  ---------------------------------------------------------------------------
+void sync_receive( struct sync_receiver_t *receiver, int timeout );
+
+//  ---------------------------------------------------------------------------
+//  Fills a period of output for the DAC.
+//  ---------------------------------------------------------------------------
+/*
+    present is the local time at which the first frame will leave the DAC.
+    Returns 0 when playing, 1 for silence while waiting for the stream.
+*/
+int8_t sync_play( struct sync_receiver_t *receiver, float *out,
+                  uint16_t frames, double present );
+
+//  ---------------------------------------------------------------------------
+//  Closes a receiver.
+//  ---------------------------------------------------------------------------
+void sync_receiver_close( struct sync_receiver_t *receiver );
+
+#endif // #ifndef SYNCPI_H
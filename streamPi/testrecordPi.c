@@ -0,0 +1,291 @@
+/*
+//  ===========================================================================
+
+    testrecordPi:
+
+    Stress test for recordPi, recording at a high rate to a slow disk.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc testrecordPi.c recordPi.c -Wall -O3 -o testrecordPi -lpthread
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        testrecordPi [-o file] [-w] [-r rate] [-n channels] [-b bits]
+                     [-t seconds] [-m MB/s] [-s stall]
+
+    Records -t seconds (default 30) of a counting pattern at 192kHz, 32 bit
+    stereo by default, from a thread paced like a capture device. The
+    writer thread is slowed to -m MB/s (default 2, against 1.5 needed) and
+    stalls at random for up to -s ms (default 500), like an SD card or USB
+    stick that is busy with garbage collection.
+
+    Prints whether io_uring, fixed buffers and O_DIRECT were used, the most
+    audio held in the ring, the longest record_write took and periods
+    dropped. Then reads the file back and checks the header and every
+    sample. Fails if any period was dropped or any sample is wrong.
+
+    -w records W64 instead of WAV. The default file is in /tmp.
+
+    To test on a really slow disk instead, make a loop device, limit its
+    writes with the cgroup v2 io controller and record to it at full speed:
+
+        dd if=/dev/zero of=/tmp/slow.img bs=1M count=512
+        sudo losetup /dev/loop7 /tmp/slow.img
+        sudo mkfs.ext4 /dev/loop7 && sudo mount /dev/loop7 /mnt
+        sudo mkdir /sys/fs/cgroup/slow
+        echo "7:7 wbps=2097152" | sudo tee /sys/fs/cgroup/slow/io.max
+        echo $$ | sudo tee /sys/fs/cgroup/slow/cgroup.procs
+        sudo testrecordPi -o /mnt/test.wav -m 0 -s 0
+
+//  ---------------------------------------------------------------------------
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <endian.h>
+
+#include "streamPi.h"
+#include "recordPi.h"
+
+#define TEST_RATE       192000
+#define TEST_CHANNELS   2
+#define TEST_BITS       32
+#define TEST_PERIOD     512
+#define TEST_FILE       "/tmp/testrecordPi"
+
+static int32_t s32[TEST_PERIOD * STREAM_CHANNELS_MAX];
+static int16_t s16[TEST_PERIOD * STREAM_CHANNELS_MAX];
+static uint8_t block[RECORD_ALIGN];
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Returns time on the monotonic clock in seconds.
+//  ---------------------------------------------------------------------------
+static double testTime( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//  ---------------------------------------------------------------------------
+//  Records counting pattern in real time, returns longest write (s).
+//  ---------------------------------------------------------------------------
+static double testCapture( struct record_t *record, uint32_t rate,
+                           uint8_t channels, uint8_t bits, double seconds )
+{
+    struct sched_param param = { .sched_priority = 50 };
+    struct timespec ts;
+    const uint32_t periods = seconds * rate / TEST_PERIOD;
+    uint32_t period, i, value = 0;
+    double   start, next, now, worst = 0;
+
+    // Real time priority if allowed, as a capture thread would have.
+    pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+
+    start = testTime();
+    for ( period = 0; period < periods; period++ )
+    {
+        // Wait for the period to be "captured".
+        next = start + ( double )( period + 1 ) * TEST_PERIOD / rate;
+        ts.tv_sec  = next;
+        ts.tv_nsec = ( next - ts.tv_sec ) * 1e9;
+        clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL );
+
+        for ( i = 0; i < TEST_PERIOD * channels; i++, value++ )
+        {
+            s32[i] = ( bits == 24 ) ? ( value & 0xffffff ) : value;
+            s16[i] = value;
+        }
+
+        now = testTime();
+        record_write( record, ( bits == 16 ) ? ( void * )s16
+                                             : ( void * )s32, TEST_PERIOD );
+        now = testTime() - now;
+        if ( now > worst ) worst = now;
+    }
+
+    return worst;
+}
+
+//  ---------------------------------------------------------------------------
+//  Checks header and pattern in file, returns true if all correct.
+//  ---------------------------------------------------------------------------
+static bool testCheck( const char *name, uint8_t channels, uint8_t bits,
+                       bool w64, uint64_t bytes )
+{
+    const uint8_t size = bits / 8;
+    static uint8_t buffer[65536];
+    FILE    *file;
+    uint64_t data, total = 0;
+    uint32_t value = 0, mask, sample;
+    size_t   count, i;
+    uint8_t  b;
+
+    file = fopen( name, "rb" );
+    if ( file == NULL ) return false;
+    if ( fread( block, 1, RECORD_ALIGN, file ) != RECORD_ALIGN )
+    {
+        fclose( file );
+        return false;
+    }
+
+    // Data chunk header sits just before the audio.
+    if ( w64 )
+    {
+        memcpy( &data, block + RECORD_ALIGN - 8, 8 );
+        data = le64toh( data ) - 24;
+        if ( memcmp( block, "riff", 4 ) || memcmp( block + 24, "wave", 4 ) ||
+             memcmp( block + RECORD_ALIGN - 24, "data", 4 )) data = ~0ull;
+    }
+    else
+    {
+        memcpy( &sample, block + RECORD_ALIGN - 4, 4 );
+        data = le32toh( sample );
+        if ( memcmp( block, "RIFF", 4 ) || memcmp( block + 8, "WAVE", 4 ) ||
+             memcmp( block + RECORD_ALIGN - 8, "data", 4 )) data = ~0ull;
+    }
+    if ( data != bytes )
+    {
+        printf( "Header gives %llu bytes, %llu recorded.\n",
+                ( unsigned long long )data, ( unsigned long long )bytes );
+        fclose( file );
+        return false;
+    }
+
+    mask = ( bits == 32 ) ? 0xffffffff : ( 1u << bits ) - 1;
+    while (( count = fread( buffer, size, sizeof( buffer ) / size, file )) > 0 )
+    {
+        for ( i = 0; i < count; i++, value++ )
+        {
+            for ( sample = 0, b = 0; b < size; b++ )
+                sample |= ( uint32_t )buffer[i * size + b] << ( 8 * b );
+            if ( sample != ( value & mask ))
+            {
+                printf( "Sample %u is %08x, not %08x.\n", value, sample,
+                        value & mask );
+                fclose( file );
+                return false;
+            }
+        }
+        total += count * size;
+    }
+    fclose( file );
+    if ( total != bytes ) printf( "File has %llu bytes of audio.\n",
+                                  ( unsigned long long )total );
+
+    return ( total == bytes );
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    struct record_t record;
+    char     name[256] = "";
+    uint32_t rate = TEST_RATE;
+    uint8_t  channels = TEST_CHANNELS;
+    uint8_t  bits = TEST_BITS;
+    double   seconds = 30;
+    double   speed = 2;
+    double   stall = 500;
+    double   worst;
+    uint64_t bytes;
+    bool     w64 = false;
+    bool     good;
+    int      opt;
+
+    while (( opt = getopt( argc, argv, "o:wr:n:b:t:m:s:" )) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'o': snprintf( name, sizeof( name ), "%s", optarg ); break;
+            case 'w': w64 = true; break;
+            case 'r': rate = atoi( optarg ); break;
+            case 'n': channels = atoi( optarg ); break;
+            case 'b': bits = atoi( optarg ); break;
+            case 't': seconds = atof( optarg ); break;
+            case 'm': speed = atof( optarg ); break;
+            case 's': stall = atof( optarg ); break;
+            default:
+                printf( "Usage: %s [-o file] [-w] [-r rate] [-n channels] "
+                        "[-b bits]\n       [-t seconds] [-m MB/s] "
+                        "[-s stall]\n", argv[0] );
+                return 1;
+        }
+    }
+    if ( name[0] == '\0' )
+        snprintf( name, sizeof( name ), "%s.%s", TEST_FILE,
+                  w64 ? "w64" : "wav" );
+
+    if ( record_open( &record, name, rate, channels, bits,
+                      w64 ? RECORD_W64 : RECORD_WAV ) < 0 )
+    {
+        fprintf( stderr, "Can't record %uHz, %u channels, %u bits to %s.\n",
+                 rate, channels, bits, name );
+        return 1;
+    }
+    record.slow  = speed * 1e6;
+    record.stall = stall / 1000;
+
+    printf( "%s, %uHz, %u channels, %u bits, %.0fs, disk %.1fMB/s, "
+            "stalls to %.0fms.\n", name, rate, channels, bits, seconds,
+            speed, stall );
+    printf( "io_uring %s, fixed buffers %s, O_DIRECT %s.\n",
+            record.uring ? "yes" : "no", record.io.fixed ? "yes" : "no",
+            record.direct ? "yes" : "no" );
+    fflush( stdout );
+
+    worst = testCapture( &record, rate, channels, bits, seconds );
+    bytes = record_bytes( &record );
+
+    printf( "Periods %u, dropped %u, ring held %.0fms, longest write "
+            "%.0fus.\n", record.periods, record.dropped,
+            record.worst * 1000.0 / ( rate * channels * bits / 8 ),
+            worst * 1e6 );
+    if ( record_close( &record ) < 0 )
+        printf( "Write error: %s.\n", strerror( record.error ));
+
+    good = testCheck( name, channels, bits, w64, bytes );
+    printf( "File %s.\n", good ? "matches" : "doesn't match" );
+    if (( record.dropped > 0 ) || ( record.error != 0 ) || !good )
+    {
+        printf( "Failed.\n" );
+        return 1;
+    }
+    printf( "Passed.\n" );
+
+    return 0;
+}
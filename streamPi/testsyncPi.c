@@ -0,0 +1,565 @@
+/*
+//  ===========================================================================
+
+    testsyncPi:
+
+    Tests syncPi multi-room playback with several processes on loopback.
+
+    Copyright 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+//  ===========================================================================
+
+    Compilation:
+
+        gcc testsyncPi.c syncPi.c resamplePi.c -Wall -O3 -o testsyncPi
+            -lpthread -lm
+
+//  ---------------------------------------------------------------------------
+
+    Authors:        agent       18/10/2026
+
+    Usage:
+
+        testsyncPi [-n receivers] [-t seconds] [-x loss] [-d delay]
+                   [-j jitter] [-l latency]
+
+    Forks a sender and several receivers, each a separate process using
+    the loopback interface. This process sits between them as a network
+    with loss % (-x, default 5), delay ms (-d, default 5) and random
+    jitter ms (-j, default 2), drawn separately for every packet to every
+    receiver and for every clock request and reply.
+
+    Each receiver has its own local clock, with an offset of thousands of
+    seconds and a drift of tens of ppm, and a simulated DAC that runs off
+    that clock with a drift of its own. For every DAC period it compares
+    the frame it plays with the frame the sender meant for that moment,
+    using the true clocks, which only the test knows. While the receiver
+    slews to a new latency, it is compared with the latency it is playing.
+
+    After -t seconds (default 60), prints each receiver's worst error,
+    drift found and true drift, packets lost and late, resyncs after the
+    first 20 seconds, and the latency the sender settled on, then the
+    worst skew between any two rooms over each second after the first 20.
+    Fails if rooms were out by 1ms or more over any second, if any
+    receiver was ever out by 1ms or more on its own or had to resync after
+    the first 20 seconds, or if the drift found is out by TEST_DRIFT.
+
+    Starting latency (-l, default 20ms) is below what the default network
+    needs, so the sender has to raise it.
+
+//  ---------------------------------------------------------------------------
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <poll.h>
+#include <time.h>
+#include <math.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "streamPi.h"
+#include "resamplePi.h"
+#include "syncPi.h"
+
+#define TEST_RATE       48000
+#define TEST_CHANNELS   2
+#define TEST_PERIOD     256
+#define TEST_LEAD       2       // DAC periods written ahead.
+#define TEST_GROUP      "239.255.58.1"
+#define TEST_PORT       5858    // Receivers use TEST_PORT + 10.
+#define TEST_RECEIVERS  8
+#define TEST_SECONDS    3600
+#define TEST_SETTLE     20      // Seconds before errors count.
+#define TEST_QUEUE      4096    // Packets held by network.
+#define TEST_LIMIT      0.001   // Worst skew and error allowed (s).
+#define TEST_DRIFT      10      // Worst drift error allowed (ppm).
+
+//  Types. --------------------------------------------------------------------
+
+struct result_t
+{
+    double   start;                         // Test start, true time.
+    double   latency;                       // Sender's final latency.
+    double   error[TEST_RECEIVERS][TEST_SECONDS];  // Mean each second.
+    uint32_t count[TEST_RECEIVERS][TEST_SECONDS];
+    double   worst[TEST_RECEIVERS];
+    double   drift[TEST_RECEIVERS];         // Drift found (ppm).
+    double   clock[TEST_RECEIVERS];         // True drift to sender (ppm).
+    uint32_t packets[TEST_RECEIVERS];
+    uint32_t lost[TEST_RECEIVERS];
+    uint32_t late[TEST_RECEIVERS];
+    uint32_t resyncs[TEST_RECEIVERS];
+};
+
+struct packet_t
+{
+    double   release;                       // 0 if free.
+    int      sock;
+    struct sockaddr_in to;
+    uint16_t size;
+    uint8_t  data[1500];
+};
+
+static struct result_t *result;
+static struct sync_sender_t sender;
+static struct sync_receiver_t receiver;
+static struct packet_t queue[TEST_QUEUE];
+static volatile bool running = true;
+
+//  Functions. ----------------------------------------------------------------
+
+//  ---------------------------------------------------------------------------
+//  Sleeps until a time on the monotonic clock.
+//  ---------------------------------------------------------------------------
+static void testSleep( double t )
+{
+    struct timespec ts;
+
+    ts.tv_sec  = floor( t );
+    ts.tv_nsec = ( t - ts.tv_sec ) * 1e9;
+    clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL );
+}
+
+//  ---------------------------------------------------------------------------
+//  Threads answering clock requests and receiving packets.
+//  ---------------------------------------------------------------------------
+static void *testServe( void *data )
+{
+    while ( running ) sync_serve( &sender, 10 );
+    return NULL;
+}
+
+static void *testReceive( void *data )
+{
+    while ( running ) sync_receive( &receiver, 10 );
+    return NULL;
+}
+
+//  ---------------------------------------------------------------------------
+//  Sender process, a 441Hz sine paced by the monotonic clock.
+//  ---------------------------------------------------------------------------
+static int testSender( double seconds, double latency )
+{
+    int16_t   samples[SYNC_FRAMES * TEST_CHANNELS];
+    pthread_t thread;
+    uint64_t  frame = 0;
+    double    start;
+    uint16_t  f;
+    uint8_t   ch;
+
+    if ( sync_sender_open( &sender, TEST_GROUP, TEST_PORT, "127.0.0.1",
+                           TEST_RATE, TEST_CHANNELS, latency ) < 0 )
+    {
+        fprintf( stderr, "Can't open sender.\n" );
+        return 1;
+    }
+    pthread_create( &thread, NULL, testServe, NULL );
+
+    start = sync_time();
+    while ( sync_time() - start < seconds )
+    {
+        for ( f = 0; f < SYNC_FRAMES; f++, frame++ )
+            for ( ch = 0; ch < TEST_CHANNELS; ch++ )
+                samples[f * TEST_CHANNELS + ch] =
+                    8192 * sin( 2 * M_PI * 441 * frame / TEST_RATE );
+        testSleep( start + ( double )frame / TEST_RATE );
+        sync_send( &sender, samples, SYNC_FRAMES, sync_time());
+    }
+
+    result->latency = sync_latency( &sender );
+    running = false;
+    pthread_join( thread, NULL );
+    sync_sender_close( &sender );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Receiver process, with a simulated DAC.
+//  ---------------------------------------------------------------------------
+/*
+    Local time is true * ( 1 + clock_ppm ) + clock_offset. The sender uses
+    true time, so the frame it means for a local time is known exactly.
+*/
+static int testReceiver( uint8_t n, double seconds )
+{
+    static float out[TEST_PERIOD * TEST_CHANNELS];
+    const double lead = TEST_LEAD * ( double )TEST_PERIOD / TEST_RATE;
+    const double dac = ( n & 1 ) ? 70 * ( n + 1 ) : -50 * ( n + 1 );
+    char      group[16];
+    pthread_t thread;
+    uint64_t  k, anchor_frame;
+    double    start, present, truth, anchor_pts, anchor_latency, desired;
+    double    error;
+    uint32_t  seq, second, resyncs = 0;
+
+    snprintf( group, sizeof( group ), "239.255.58.%u", 10 + n );
+    if ( sync_receiver_open( &receiver, group, TEST_PORT + 10, "127.0.0.1",
+                             "127.0.0.1", TEST_RATE, TEST_CHANNELS ) < 0 )
+    {
+        fprintf( stderr, "Can't open receiver %u.\n", n );
+        return 1;
+    }
+    receiver.clock_offset = 1000.0 * ( n + 1 ) + 0.123 * n;
+    receiver.clock_ppm    = ( n & 1 ) ? -40 * ( n + 1 ) : 30 * ( n + 1 );
+    result->clock[n] = -receiver.clock_ppm - dac;
+    pthread_create( &thread, NULL, testReceive, NULL );
+
+    start = sync_local( &receiver ) + lead;
+    for ( k = 0; ; k++ )
+    {
+        present = start + k * TEST_PERIOD / ( TEST_RATE * ( 1 + dac * 1e-6 ));
+        truth   = ( present - receiver.clock_offset ) /
+                  ( 1 + receiver.clock_ppm * 1e-6 );
+        if ( truth - result->start > seconds ) break;
+
+        // Write a period ahead of the DAC.
+        testSleep( truth - lead );
+        if ( sync_play( &receiver, out, TEST_PERIOD, present ) != 0 )
+            continue;
+
+        do
+        {
+            seq = __atomic_load_n( &receiver.seq, __ATOMIC_ACQUIRE );
+            anchor_frame   = receiver.anchor_frame;
+            anchor_pts     = receiver.anchor_pts;
+            anchor_latency = receiver.anchor_latency;
+            __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        } while (( seq & 1 ) ||
+                 ( seq != __atomic_load_n( &receiver.seq,
+                                           __ATOMIC_RELAXED )));
+        desired = anchor_frame + ( truth - anchor_pts ) * TEST_RATE;
+        error   = ( receiver.position - desired ) / TEST_RATE;
+
+        // Rooms are compared at the sender's latency.
+        second = truth - result->start;
+        result->error[n][second] += error;
+        result->count[n][second]++;
+        if ( second < TEST_SETTLE )
+        {
+            resyncs = receiver.resyncs;
+            continue;
+        }
+
+        // Room on its own is compared at the latency it is playing.
+        error -= anchor_latency - receiver.latency;
+        if ( fabs( error ) > result->worst[n] )
+            result->worst[n] = fabs( error );
+    }
+
+    result->drift[n]   = receiver.drift * 1e6;
+    result->packets[n] = receiver.packets;
+    result->lost[n]    = receiver.lost;
+    result->late[n]    = receiver.late;
+    result->resyncs[n] = receiver.resyncs - resyncs;
+
+    running = false;
+    pthread_join( thread, NULL );
+    sync_receiver_close( &receiver );
+
+    return 0;
+}
+
+//  ---------------------------------------------------------------------------
+//  Queues a packet for the network to deliver, or loses it.
+//  ---------------------------------------------------------------------------
+static void testQueue( int sock, struct sockaddr_in *to, uint8_t *data,
+                       ssize_t size, double loss, double delay,
+                       double jitter )
+{
+    uint16_t i;
+
+    if (( size <= 0 ) || ( size > 1500 ) || ( drand48() < loss )) return;
+
+    for ( i = 0; i < TEST_QUEUE; i++ )
+        if ( queue[i].release == 0 ) break;
+    if ( i == TEST_QUEUE ) return;
+
+    queue[i].release = sync_time() + delay + drand48() * jitter;
+    queue[i].sock    = sock;
+    queue[i].to      = *to;
+    queue[i].size    = size;
+    memcpy( queue[i].data, data, size );
+}
+
+//  ---------------------------------------------------------------------------
+//  Opens a socket, bound to an address if given.
+//  ---------------------------------------------------------------------------
+static int testSocket( const char *address, uint16_t port )
+{
+    struct sockaddr_in addr;
+    int    sock = socket( AF_INET, SOCK_DGRAM, 0 );
+    int    reuse = 1;
+
+    if (( sock < 0 ) || ( address == NULL )) return sock;
+
+    memset( &addr, 0, sizeof( addr ));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons( port );
+    inet_aton( address, &addr.sin_addr );
+    setsockopt( sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ));
+    if ( bind( sock, ( struct sockaddr * )&addr, sizeof( addr )) < 0 )
+    {
+        close( sock );
+        return -1;
+    }
+
+    return sock;
+}
+
+//  ---------------------------------------------------------------------------
+//  Runs the network between sender and receivers until they exit.
+//  ---------------------------------------------------------------------------
+/*
+    Audio from the sender's group is sent on to a group for each receiver,
+    and clock requests are sent on to the sender and replies back to the
+    receiver, identified by the id in the request.
+*/
+static void testNetwork( uint8_t receivers, double loss, double delay,
+                         double jitter )
+{
+    struct sockaddr_in group[TEST_RECEIVERS], to, from;
+    struct sockaddr_in client[TEST_RECEIVERS];
+    uint32_t           id[TEST_RECEIVERS] = { 0 };
+    struct ip_mreq     mreq;
+    struct in_addr     local;
+    struct pollfd      fd[3];
+    struct timespec    ts;
+    socklen_t length;
+    uint8_t   buffer[1500];
+    ssize_t   size;
+    double    next, now;
+    uint16_t  i;
+    uint8_t   n, children = receivers + 1;
+    char      address[16];
+
+    // Audio in from sender, out to receivers, clock down and up.
+    fd[0].fd = testSocket( TEST_GROUP, TEST_PORT );
+    fd[1].fd = testSocket( "127.0.0.1", TEST_PORT + 11 );
+    fd[2].fd = testSocket( NULL, 0 );
+    inet_aton( TEST_GROUP, &mreq.imr_multiaddr );
+    inet_aton( "127.0.0.1", &mreq.imr_interface );
+    inet_aton( "127.0.0.1", &local );
+    setsockopt( fd[0].fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq,
+                sizeof( mreq ));
+    setsockopt( fd[2].fd, IPPROTO_IP, IP_MULTICAST_IF, &local,
+                sizeof( local ));
+    for ( i = 0; i < 3; i++ ) fd[i].events = POLLIN;
+
+    for ( n = 0; n < receivers; n++ )
+    {
+        snprintf( address, sizeof( address ), "239.255.58.%u", 10 + n );
+        memset( &group[n], 0, sizeof( group[n] ));
+        group[n].sin_family = AF_INET;
+        group[n].sin_port   = htons( TEST_PORT + 10 );
+        inet_aton( address, &group[n].sin_addr );
+    }
+    memset( &to, 0, sizeof( to ));
+    to.sin_family = AF_INET;
+    to.sin_port   = htons( TEST_PORT + 1 );
+    inet_aton( "127.0.0.1", &to.sin_addr );
+
+    while ( children > 0 )
+    {
+        // Deliver packets that are due.
+        now  = sync_time();
+        next = now + 0.01;
+        for ( i = 0; i < TEST_QUEUE; i++ )
+        {
+            if ( queue[i].release == 0 ) continue;
+            if ( queue[i].release <= now )
+            {
+                sendto( queue[i].sock, queue[i].data, queue[i].size, 0,
+                        ( struct sockaddr * )&queue[i].to,
+                        sizeof( queue[i].to ));
+                queue[i].release = 0;
+            }
+            else if ( queue[i].release < next ) next = queue[i].release;
+        }
+
+        ts.tv_sec  = 0;
+        ts.tv_nsec = ( next - now ) * 1e9;
+        if ( ppoll( fd, 3, &ts, NULL ) > 0 )
+        {
+            // Audio, with separate losses for each receiver.
+            if ( fd[0].revents & POLLIN )
+            {
+                size = recv( fd[0].fd, buffer, sizeof( buffer ), 0 );
+                for ( n = 0; n < receivers; n++ )
+                    testQueue( fd[2].fd, &group[n], buffer, size, loss,
+                               delay, jitter );
+            }
+
+            // Clock request from a receiver.
+            if ( fd[1].revents & POLLIN )
+            {
+                length = sizeof( from );
+                size = recvfrom( fd[1].fd, buffer, sizeof( buffer ), 0,
+                                 ( struct sockaddr * )&from, &length );
+                for ( n = 0; n < receivers; n++ )
+                    if (( id[n] == 0 ) ||
+                        ( memcmp( &id[n], buffer + 4, 4 ) == 0 )) break;
+                if (( size >= 8 ) && ( n < receivers ))
+                {
+                    memcpy( &id[n], buffer + 4, 4 );
+                    client[n] = from;
+                    testQueue( fd[2].fd, &to, buffer, size, loss, delay,
+                               jitter );
+                }
+            }
+
+            // Clock reply from the sender.
+            if ( fd[2].revents & POLLIN )
+            {
+                size = recv( fd[2].fd, buffer, sizeof( buffer ), 0 );
+                for ( n = 0; n < receivers; n++ )
+                    if (( size >= 8 ) && ( id[n] != 0 ) &&
+                        ( memcmp( &id[n], buffer + 4, 4 ) == 0 ))
+                        testQueue( fd[1].fd, &client[n], buffer, size,
+                                   loss, delay, jitter );
+            }
+        }
+
+        while ( waitpid( -1, NULL, WNOHANG ) > 0 ) children--;
+    }
+
+    for ( i = 0; i < 3; i++ ) close( fd[i].fd );
+}
+
+//  Main section. -------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+    uint8_t  receivers = 3;
+    double   seconds = 60;
+    double   loss = 5;
+    double   delay = 5;
+    double   jitter = 2;
+    double   latency = 20;
+    double   skew, worst_skew = 0, worst = 0, drift = 0;
+    uint32_t resyncs = 0;
+    double   lo, hi, mean;
+    uint32_t second;
+    uint8_t  n;
+    int      opt;
+
+    while (( opt = getopt( argc, argv, "n:t:x:d:j:l:" )) != -1 )
+    {
+        switch ( opt )
+        {
+            case 'n': receivers = atoi( optarg ); break;
+            case 't': seconds = atof( optarg ); break;
+            case 'x': loss = atof( optarg ); break;
+            case 'd': delay = atof( optarg ); break;
+            case 'j': jitter = atof( optarg ); break;
+            case 'l': latency = atof( optarg ); break;
+            default:
+                printf( "Usage: %s [-n receivers] [-t seconds] [-x loss] "
+                        "[-d delay]\n       [-j jitter] [-l latency]\n",
+                        argv[0] );
+                return 1;
+        }
+    }
+    if (( receivers < 2 ) || ( receivers > TEST_RECEIVERS ) ||
+        ( seconds <= TEST_SETTLE ) || ( seconds > TEST_SECONDS - 1 ))
+    {
+        fprintf( stderr, "2 to %u receivers, %u to %us.\n", TEST_RECEIVERS,
+                 TEST_SETTLE + 1, TEST_SECONDS - 1 );
+        return 1;
+    }
+
+    result = mmap( NULL, sizeof( struct result_t ), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+    if ( result == MAP_FAILED ) return 1;
+    result->start = sync_time();
+
+    printf( "%u receivers for %.0fs, loss %.1f%%, delay %.1fms, "
+            "jitter %.1fms, latency %.0fms.\n", receivers, seconds, loss,
+            delay, jitter, latency );
+    fflush( stdout );
+
+    // Network must be listening before the others start.
+    if ( fork() == 0 )
+    {
+        usleep( 100000 );
+        return testSender( seconds + 1, latency / 1000 );
+    }
+    for ( n = 0; n < receivers; n++ )
+        if ( fork() == 0 )
+        {
+            usleep( 100000 );
+            srand48( getpid());
+            return testReceiver( n, seconds );
+        }
+    srand48( 1 );
+    testNetwork( receivers, loss / 100, delay / 1000, jitter / 1000 );
+
+    printf( "\nRoom   Worst (ms)   Drift (ppm)   True (ppm)   Packets   "
+            "Lost   Late   Resyncs\n" );
+    for ( n = 0; n < receivers; n++ )
+    {
+        printf( "%4u   %10.3f   %11.1f   %10.1f   %7u   %4u   %4u   %7u\n",
+                n, result->worst[n] * 1000, result->drift[n],
+                result->clock[n], result->packets[n], result->lost[n],
+                result->late[n], result->resyncs[n] );
+        if ( result->worst[n] > worst ) worst = result->worst[n];
+        if ( fabs( result->drift[n] - result->clock[n] ) > drift )
+            drift = fabs( result->drift[n] - result->clock[n] );
+        resyncs += result->resyncs[n];
+    }
+
+    // Skew between rooms from mean error over each second.
+    for ( second = TEST_SETTLE; second < seconds; second++ )
+    {
+        lo = 1;
+        hi = -1;
+        for ( n = 0; n < receivers; n++ )
+        {
+            if ( result->count[n][second] == 0 ) continue;
+            mean = result->error[n][second] / result->count[n][second];
+            if ( mean < lo ) lo = mean;
+            if ( mean > hi ) hi = mean;
+        }
+        skew = hi - lo;
+        if ( skew > worst_skew ) worst_skew = skew;
+    }
+
+    printf( "\nSender latency %.0fms.\n", result->latency * 1000 );
+    printf( "Worst skew between rooms %.3fms, worst error %.3fms.\n",
+            worst_skew * 1000, worst * 1000 );
+    printf( "Worst drift error %.1fppm, %u resyncs.\n", drift, resyncs );
+    if (( worst == 0 ) || ( worst >= TEST_LIMIT ) ||
+        ( worst_skew >= TEST_LIMIT ) || ( drift > TEST_DRIFT ) ||
+        ( resyncs > 0 ))
+    {
+        printf( "Failed.\n" );
+        return 1;
+    }
+    printf( "Passed.\n" );
+
+    return 0;
+}
@@ -24,11 +24,12 @@
 // ****************************************************************************
 // ****************************************************************************
 
-#define Version "Version 0.1"
+#define Version "Version 0.3"
 
 //  Compilation:
 //
-//  Compile with gcc thx1138.c -o thx1138 -lasound
+//  Compile with gcc thx1138.c recordPi.c latencyPi.c -o thx1138 -lasound
+//      -lpthread -lm
 //  Also use the following flags for Raspberry Pi optimisation:
 //         -march=armv6 -mtune=arm1176jzf-s -mfloat-abi=hard -mfpu=vfp
 //         -ffast-math -pipe -O3
@@ -39,12 +40,22 @@
 //    Changelog:
 //
 //    v0.1 Initial version.
+//    v0.2 Added record mode using recordPi.
+//    v0.3 Added round trip latency mode using latencyPi.
 
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
+#include <signal.h>
+#include <pthread.h>
 #include <alsa/asoundlib.h>
 #include <argp.h>
 
+#include "streamPi.h"
+#include "recordPi.h"
+#include "latencyPi.h"
+
 // ****************************************************************************
 //  Data definitions.
 // ****************************************************************************
@@ -76,8 +87,19 @@ struct structArgs
     int card;
     int control;
     char deviceID[8];
+    char *record;       // File to record to, NULL for information only.
+    int rate;
+    int channels;
+    int bits;
+    int seconds;        // 0 to record until interrupted.
+    bool latency;       // Measure round trip latency.
+    char *playback;     // PCMs for latency.
+    char *capture;
 };
 
+// Stops recording on interrupt.
+static volatile bool recording = true;
+
 // ****************************************************************************
 //  Command line argument definitions.
 // ****************************************************************************
@@ -87,6 +109,16 @@ static struct argp_option options[] =
     { 0, 0, 0, 0, "Card information:" },
     { "card", 'c', "<n>", 0, "Card ID number." },
     { "control", 'd', "<n>", 0, "Control ID number." },
+    { 0, 0, 0, 0, "Recording:" },
+    { "record", 'r', "<file>", 0, "Record to WAV, or W64 if .w64." },
+    { "rate", 's', "<n>", 0, "Sample rate (default 48000)." },
+    { "channels", 'n', "<n>", 0, "Channels (default 2)." },
+    { "bits", 'b', "<n>", 0, "Bits, 16, 24 or 32 (default 16)." },
+    { "time", 't', "<s>", 0, "Seconds to record, 0 until interrupted." },
+    { 0, 0, 0, 0, "Latency:" },
+    { "latency", 'l', 0, 0, "Measure round trip latency and xruns." },
+    { "playback", 'p', "<pcm>", 0, "Playback PCM (default hw:Loopback,0)." },
+    { "capture", 'i', "<pcm>", 0, "Capture PCM (default hw:Loopback,1)." },
     { 0 }
 };
 
@@ -109,6 +141,30 @@ static int parse_opt( int param, char *arg, struct argp_state *state )
         case 'd' :
             cmdArgs->control = atoi( arg );
             break;
+        case 'r' :
+            cmdArgs->record = arg;
+            break;
+        case 's' :
+            cmdArgs->rate = atoi( arg );
+            break;
+        case 'n' :
+            cmdArgs->channels = atoi( arg );
+            break;
+        case 'b' :
+            cmdArgs->bits = atoi( arg );
+            break;
+        case 't' :
+            cmdArgs->seconds = atoi( arg );
+            break;
+        case 'l' :
+            cmdArgs->latency = true;
+            break;
+        case 'p' :
+            cmdArgs->playback = arg;
+            break;
+        case 'i' :
+            cmdArgs->capture = arg;
+            break;
     }
     return 0;
 };
@@ -120,6 +176,387 @@ static int parse_opt( int param, char *arg, struct argp_state *state )
 static struct argp argp = { options, parse_opt, args_doc, doc };
 
 
+// ****************************************************************************
+//  Stops recording on interrupt.
+// ****************************************************************************
+
+static void stopRecording( int signal )
+{
+    recording = false;
+}
+
+
+// ****************************************************************************
+//  Records from capture device to a file.
+// ****************************************************************************
+/*
+    Periods are read here and handed to recordPi, whose writer thread does
+    all the file IO, so a slow SD card can't cause a capture overrun.
+*/
+static int recordCapture( struct structArgs *cmdArgs )
+{
+    struct record_t record;
+    static int32_t buffer[1024 * STREAM_CHANNELS_MAX];
+    snd_pcm_t *pcmp;
+    snd_pcm_sframes_t frames;
+    const char *ext = strrchr( cmdArgs->record, '.' );
+    unsigned long periods;
+    unsigned int overruns = 0;
+    int errNum;
+
+    if (( cmdArgs->channels < 1 ) ||
+        ( cmdArgs->channels > STREAM_CHANNELS_MAX ))
+    {
+        fprintf( stderr, "Channels must be 1 to %i.\n", STREAM_CHANNELS_MAX );
+        return -1;
+    }
+
+    errNum = snd_pcm_open( &pcmp, cmdArgs->deviceID,
+                           SND_PCM_STREAM_CAPTURE, 0 );
+    if ( errNum < 0 )
+    {
+        fprintf( stderr, "Unable to open pcm device: %s\n",
+            snd_strerror( errNum ));
+        return -1;
+    }
+
+    // 24 bits come low aligned in 32, which is what recordPi expects.
+    errNum = snd_pcm_set_params( pcmp,
+        ( cmdArgs->bits == 16 ) ? SND_PCM_FORMAT_S16_LE :
+        ( cmdArgs->bits == 24 ) ? SND_PCM_FORMAT_S24_LE :
+                                  SND_PCM_FORMAT_S32_LE,
+        SND_PCM_ACCESS_RW_INTERLEAVED, cmdArgs->channels, cmdArgs->rate,
+        0, 100000 );
+    if ( errNum < 0 )
+    {
+        fprintf( stderr, "Unable to set hw parameters: %s\n",
+            snd_strerror( errNum ));
+        snd_pcm_close( pcmp );
+        return -1;
+    }
+
+    if ( record_open( &record, cmdArgs->record, cmdArgs->rate,
+            cmdArgs->channels, cmdArgs->bits,
+            (( ext != NULL ) && ( strcasecmp( ext, ".w64" ) == 0 )) ?
+            RECORD_W64 : RECORD_WAV ) < 0 )
+    {
+        fprintf( stderr, "Unable to record to %s.\n", cmdArgs->record );
+        snd_pcm_close( pcmp );
+        return -1;
+    }
+
+    printf( "Recording %s to %s, %i Hz, %i channels, %i bits.\n",
+        cmdArgs->deviceID, cmdArgs->record, cmdArgs->rate,
+        cmdArgs->channels, cmdArgs->bits );
+    printf( "io_uring %s, O_DIRECT %s. Ctrl-C to stop.\n",
+        record.uring ? "yes" : "no", record.direct ? "yes" : "no" );
+
+    signal( SIGINT, stopRecording );
+    signal( SIGTERM, stopRecording );
+    periods = ( unsigned long )cmdArgs->seconds * cmdArgs->rate / 1024;
+
+    while ( recording &&
+            (( cmdArgs->seconds == 0 ) || ( record.periods < periods )))
+    {
+        frames = snd_pcm_readi( pcmp, buffer, 1024 );
+        if ( frames < 0 )
+        {
+            overruns++;
+            if ( snd_pcm_recover( pcmp, frames, 1 ) < 0 ) break;
+            continue;
+        }
+        record_write( &record, buffer, frames );
+    }
+
+    snd_pcm_close( pcmp );
+    printf( "Recorded %.1f s, %u periods dropped, %u overruns.\n",
+        ( double )record_bytes( &record ) /
+        ( cmdArgs->rate * cmdArgs->channels * ( cmdArgs->bits / 8 )),
+        record.dropped, overruns );
+    if ( record_close( &record ) < 0 )
+    {
+        fprintf( stderr, "Write error: %s\n", strerror( record.error ));
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// ****************************************************************************
+//  Opens a PCM for latency measurement with a period and buffer size.
+// ****************************************************************************
+/*
+    Playback only starts when started explicitly, so it can be filled with
+    silence first and started together with capture.
+*/
+static int latencyOpen( snd_pcm_t **pcmp, const char *name,
+                        snd_pcm_stream_t stream, struct structArgs *cmdArgs,
+                        snd_pcm_uframes_t *period, snd_pcm_uframes_t *buffer )
+{
+    snd_pcm_hw_params_t *params;
+    snd_pcm_sw_params_t *swParams;
+    snd_pcm_uframes_t boundary;
+    unsigned int rate = cmdArgs->rate;
+    int errNum;
+
+    errNum = snd_pcm_open( pcmp, name, stream, 0 );
+    if ( errNum < 0 ) return errNum;
+
+    snd_pcm_hw_params_alloca( &params );
+    snd_pcm_hw_params_any( *pcmp, params );
+    snd_pcm_hw_params_set_access( *pcmp, params,
+        SND_PCM_ACCESS_RW_INTERLEAVED );
+    snd_pcm_hw_params_set_format( *pcmp, params, SND_PCM_FORMAT_S16_LE );
+    snd_pcm_hw_params_set_channels( *pcmp, params, cmdArgs->channels );
+    snd_pcm_hw_params_set_rate( *pcmp, params, rate, 0 );
+    snd_pcm_hw_params_set_period_size_near( *pcmp, params, period, 0 );
+    snd_pcm_hw_params_set_buffer_size_near( *pcmp, params, buffer );
+    errNum = snd_pcm_hw_params( *pcmp, params );
+    if ( errNum < 0 )
+    {
+        snd_pcm_close( *pcmp );
+        return errNum;
+    }
+    snd_pcm_hw_params_get_period_size( params, period, 0 );
+    snd_pcm_hw_params_get_buffer_size( params, buffer );
+
+    snd_pcm_sw_params_alloca( &swParams );
+    snd_pcm_sw_params_current( *pcmp, swParams );
+    snd_pcm_sw_params_get_boundary( swParams, &boundary );
+    snd_pcm_sw_params_set_start_threshold( *pcmp, swParams,
+        ( stream == SND_PCM_STREAM_PLAYBACK ) ? boundary : 1 );
+    snd_pcm_sw_params_set_avail_min( *pcmp, swParams, *period );
+    errNum = snd_pcm_sw_params( *pcmp, swParams );
+    if ( errNum < 0 ) snd_pcm_close( *pcmp );
+
+    return errNum;
+}
+
+
+// ****************************************************************************
+//  Fills playback with silence and starts both streams.
+// ****************************************************************************
+static int latencyStart( snd_pcm_t *playback, snd_pcm_t *capture,
+                         bool linked, int16_t *silence,
+                         snd_pcm_uframes_t period, snd_pcm_uframes_t buffer )
+{
+    snd_pcm_uframes_t filled;
+
+    snd_pcm_drop( capture );
+    if ( !linked ) snd_pcm_drop( playback );
+    snd_pcm_prepare( capture );
+    if ( !linked ) snd_pcm_prepare( playback );
+
+    for ( filled = 0; filled < buffer; filled += period )
+        if ( snd_pcm_writei( playback, silence,
+                ( buffer - filled < period ) ? buffer - filled : period ) < 0 )
+            return -1;
+
+    if ( linked ) return snd_pcm_start( capture );
+    if ( snd_pcm_start( playback ) < 0 ) return -1;
+    return snd_pcm_start( capture );
+}
+
+
+// ****************************************************************************
+//  Measures round trip latency and counts xruns for one period size.
+// ****************************************************************************
+/*
+    Runs as a full duplex application would, reading a period of capture
+    and then writing a period of playback, with playback kept a buffer
+    ahead. The playback carries LATENCY_PERIODS periods of an MLS from the
+    start, and the second period of capture is correlated against it, so
+    the delay found is from a frame being captured to the same frame
+    coming back, i.e. the input to output latency of the application plus
+    the path between the PCMs. Keeps going for seconds to count xruns.
+*/
+static int latencyMeasure( struct structArgs *cmdArgs,
+                           struct latency_result_t *result )
+{
+    struct latency_t latency;
+    snd_pcm_t *playback, *capture;
+    snd_pcm_uframes_t period = result->period;
+    snd_pcm_uframes_t buffer = result->buffer;
+    snd_pcm_uframes_t capturePeriod, captureBuffer;
+    snd_pcm_sframes_t frames;
+    unsigned long read = 0, written = 0, end, f;
+    int16_t *samples;
+    float *window;
+    float gain;
+    bool linked, valid = true;
+    int channels = cmdArgs->channels;
+    int c, errNum;
+
+    result->delay = -1;
+    result->snr = 0;
+    result->xruns = 0;
+
+    errNum = latencyOpen( &playback, cmdArgs->playback,
+        SND_PCM_STREAM_PLAYBACK, cmdArgs, &period, &buffer );
+    if ( errNum < 0 ) return errNum;
+    capturePeriod = period;
+    captureBuffer = buffer;
+    errNum = latencyOpen( &capture, cmdArgs->capture,
+        SND_PCM_STREAM_CAPTURE, cmdArgs, &capturePeriod, &captureBuffer );
+    if ( errNum < 0 )
+    {
+        snd_pcm_close( playback );
+        return errNum;
+    }
+    result->period = period;
+    result->buffer = buffer;
+
+    // Long enough for the buffer and 100ms more in the path.
+    if ( latency_init( &latency,
+            latency_order( buffer + cmdArgs->rate / 10 )) < 0 )
+    {
+        snd_pcm_close( capture );
+        snd_pcm_close( playback );
+        return -ENOMEM;
+    }
+    samples = calloc( period * channels, sizeof( int16_t ));
+    window = malloc( latency.length * sizeof( float ));
+    if (( samples == NULL ) || ( window == NULL ))
+    {
+        free( samples );
+        free( window );
+        latency_free( &latency );
+        snd_pcm_close( capture );
+        snd_pcm_close( playback );
+        return -ENOMEM;
+    }
+
+    linked = ( snd_pcm_link( capture, playback ) == 0 );
+    end = 2 * latency.length;
+    if ( end < ( unsigned long )cmdArgs->seconds * cmdArgs->rate )
+        end = ( unsigned long )cmdArgs->seconds * cmdArgs->rate;
+
+    if ( latencyStart( playback, capture, linked, samples, period,
+                       buffer ) < 0 )
+        valid = false;
+
+    while ( recording && ( read < end ))
+    {
+        frames = snd_pcm_readi( capture, samples, period );
+        if ( frames < 0 )
+        {
+            result->xruns++;
+            valid = false;
+            latencyStart( playback, capture, linked, samples, period,
+                          buffer );
+            continue;
+        }
+
+        // Second period of the sequence, by capture frame.
+        for ( f = 0; f < ( unsigned long )frames; f++ )
+            if (( read + f >= latency.length ) &&
+                ( read + f < 2 * latency.length ))
+                window[read + f - latency.length] =
+                    samples[f * channels] / 32768.0f;
+        read += frames;
+
+        for ( f = 0; f < ( unsigned long )frames; f++, written++ )
+            for ( c = 0; c < channels; c++ )
+                samples[f * channels + c] =
+                    ( written < LATENCY_PERIODS * latency.length ) ?
+                    latency.mls[written % latency.length] * 16384 : 0;
+
+        if ( snd_pcm_writei( playback, samples, frames ) < 0 )
+        {
+            result->xruns++;
+            valid = false;
+            latencyStart( playback, capture, linked, samples, period,
+                          buffer );
+        }
+    }
+
+    if ( valid && ( read >= 2 * latency.length ))
+        result->delay = latency_find( &latency, window, &result->snr,
+                                      &gain );
+
+    if ( linked ) snd_pcm_unlink( capture );
+    snd_pcm_close( capture );
+    snd_pcm_close( playback );
+    free( samples );
+    free( window );
+    latency_free( &latency );
+
+    return 0;
+}
+
+
+// ****************************************************************************
+//  Prints latency and xruns for a range of period sizes.
+// ****************************************************************************
+/*
+    Works with snd-aloop, where whatever is played on one device of the
+    Loopback card is captured on the other, so no audio hardware or cables
+    are needed to find the least buffer that runs without xruns.
+*/
+static int latencyMatrix( struct structArgs *cmdArgs )
+{
+    static const int periodSizes[] = { 32, 64, 128, 256, 512, 1024, 2048 };
+    static const int periodCounts[] = { 2, 3, 4 };
+    struct latency_result_t results[21];
+    int count = 0;
+    int best;
+    int i, j;
+
+    if (( cmdArgs->channels < 1 ) ||
+        ( cmdArgs->channels > STREAM_CHANNELS_MAX ))
+    {
+        fprintf( stderr, "Channels must be 1 to %i.\n", STREAM_CHANNELS_MAX );
+        return -1;
+    }
+
+    signal( SIGINT, stopRecording );
+    signal( SIGTERM, stopRecording );
+
+    printf( "Round trip latency, %s to %s, %i Hz, %i channels.\n",
+        cmdArgs->playback, cmdArgs->capture, cmdArgs->rate,
+        cmdArgs->channels );
+    printf( "Period  Periods  Buffer  Latency (frames)  Latency (ms)"
+            "  SNR (dB)  Xruns\n" );
+
+    for ( i = 0; i < 7 && recording; i++ )
+        for ( j = 0; j < 3 && recording; j++ )
+        {
+            results[count].period = periodSizes[i];
+            results[count].buffer = periodSizes[i] * periodCounts[j];
+            if ( latencyMeasure( cmdArgs, &results[count] ) < 0 )
+            {
+                printf( "%6i  %7i  not supported\n", periodSizes[i],
+                    periodCounts[j] );
+                continue;
+            }
+            printf( "%6u  %7u  %6u  ", results[count].period,
+                results[count].buffer / results[count].period,
+                results[count].buffer );
+            if ( results[count].delay < 0 )
+                printf( "%16s  %12s  %8s", "-", "-", "-" );
+            else
+                printf( "%16i  %12.2f  %8.1f", results[count].delay,
+                    1000.0 * results[count].delay / cmdArgs->rate,
+                    results[count].snr );
+            printf( "  %5u\n", results[count].xruns );
+            count++;
+        }
+
+    best = latency_choose( results, count );
+    if ( best < 0 )
+    {
+        printf( "No period size ran without xruns.\n" );
+        return -1;
+    }
+    printf( "Least latency without xruns: period %u, buffer %u, %.2f ms.\n",
+        results[best].period, results[best].buffer,
+        1000.0 * results[best].delay / cmdArgs->rate );
+
+    return 0;
+}
+
+
 // ****************************************************************************
 //  Main section.
 // ****************************************************************************
@@ -132,6 +569,14 @@ int main( int argc, char *argv[] )
     int errNum;
 	cmdArgs.card = 0;		// Default card.
 	cmdArgs.control = 1;	// Default control.
+    cmdArgs.record = NULL;
+    cmdArgs.rate = 48000;
+    cmdArgs.channels = 2;
+    cmdArgs.bits = 16;
+    cmdArgs.seconds = 0;
+    cmdArgs.latency = false;
+    cmdArgs.playback = "hw:Loopback,0";
+    cmdArgs.capture = "hw:Loopback,1";
 
 
     // ************************************************************************
@@ -149,11 +594,20 @@ int main( int argc, char *argv[] )
     // ************************************************************************
     argp_parse( &argp, argc, argv, 0, 0, &cmdArgs );
 
+    if ( cmdArgs.latency )
+        return ( latencyMatrix( &cmdArgs ) < 0 ) ? 1 : 0;
+
     printf( "Card = %i\n", cmdArgs.card );
     printf( "Control = %i\n", cmdArgs.control );
     sprintf( cmdArgs.deviceID, "hw:%i,%i", cmdArgs.card, cmdArgs.control );
 	printf( "Using device %s :", cmdArgs.deviceID );
 
+    if ( cmdArgs.record != NULL )
+    {
+        printf( "\n" );
+        return ( recordCapture( &cmdArgs ) < 0 ) ? 1 : 0;
+    }
+
     /* Allocate a hardware parameters object. */
     if ( snd_pcm_hw_params_alloca( &params ) < 0 )
     {